@@ -0,0 +1,318 @@
+
+#include "ArtifactWatch.h"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+#ifdef __linux__
+    auto const watchedEvents = IN_CLOSE_WRITE | IN_MODIFY | IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO;
+#endif
+
+    auto const hashBlockSizeInBytes = std::size_t{ 1 } << 20;
+
+    std::optional<std::uint64_t>
+    hashFileContents( std::string const& pathOfFile )
+    {
+        auto file = std::ifstream{ pathOfFile, std::ios::binary };
+
+        if ( not file.is_open() )
+        {
+            return std::nullopt;
+        }
+
+        auto hashBlock = std::vector<char>( hashBlockSizeInBytes );
+        auto hash = std::uint64_t{ 0x9E3779B97F4A7C15 };
+
+        while ( file )
+        {
+            file.read( hashBlock.data(), static_cast<std::streamsize>( hashBlock.size() ) );
+            auto const blockSizeInBytes = static_cast<std::size_t>( file.gcount() );
+
+            // Zero padding the last word is harmless: the file size is part of
+            // the fingerprint.
+            std::memset( hashBlock.data() + blockSizeInBytes, 0, ( 8 - blockSizeInBytes % 8 ) % 8 );
+
+            for ( auto i = std::size_t{ 0 }; i < blockSizeInBytes; i += 8 )
+            {
+                auto word = std::uint64_t{ 0 };
+                std::memcpy( &word, hashBlock.data() + i, 8 );
+                hash = ( hash ^ word ) * 0xFF51AFD7ED558CCD;
+                hash ^= hash >> 29;
+            }
+        }
+
+        if ( file.bad() )
+        {
+            return std::nullopt;
+        }
+
+        return hash;
+    }
+}
+
+ArtifactChange
+ArtifactChangeTracker::updateArtifact( std::string const& pathOfArtifact )
+{
+    auto const knownFingerprint = m_pathToFingerprint.find( pathOfArtifact );
+    auto fileError = std::error_code{};
+
+    if ( not std::filesystem::exists( pathOfArtifact, fileError ) )
+    {
+        if ( fileError or knownFingerprint == m_pathToFingerprint.end() )
+        {
+            return ArtifactChange::None;
+        }
+
+        m_pathToFingerprint.erase( knownFingerprint );
+        return ArtifactChange::Removed;
+    }
+
+    auto const sizeInBytes = std::filesystem::file_size( pathOfArtifact, fileError );
+    auto const lastWriteTime = std::filesystem::last_write_time( pathOfArtifact, fileError );
+
+    if ( fileError )
+    {
+        return ArtifactChange::None;
+    }
+
+    auto const lastWriteTimeInNanoseconds =
+        std::chrono::duration_cast<std::chrono::nanoseconds>( lastWriteTime.time_since_epoch() ).count();
+
+    if (    knownFingerprint != m_pathToFingerprint.end()
+         and knownFingerprint->second.sizeInBytes == sizeInBytes
+         and knownFingerprint->second.lastWriteTimeInNanoseconds == lastWriteTimeInNanoseconds )
+    {
+        return ArtifactChange::None;
+    }
+
+    auto const contentHash = hashFileContents( pathOfArtifact );
+
+    if ( not contentHash )
+    {
+        return ArtifactChange::None;
+    }
+
+    auto const fingerprint = ArtifactFingerprint
+    {
+        .sizeInBytes = sizeInBytes,
+        .lastWriteTimeInNanoseconds = lastWriteTimeInNanoseconds,
+        .contentHash = *contentHash
+    };
+
+    if ( knownFingerprint == m_pathToFingerprint.end() )
+    {
+        m_pathToFingerprint.emplace( pathOfArtifact, fingerprint );
+        return ArtifactChange::Added;
+    }
+
+    auto const isModified =
+           knownFingerprint->second.sizeInBytes != sizeInBytes
+        or knownFingerprint->second.contentHash != *contentHash;
+
+    knownFingerprint->second = fingerprint;
+
+    return isModified ? ArtifactChange::Modified : ArtifactChange::None;
+}
+
+void
+ArtifactChangeTracker::forgetArtifact( std::string const& pathOfArtifact )
+{
+    m_pathToFingerprint.erase( pathOfArtifact );
+}
+
+DirectoryWatcher::DirectoryWatcher( std::vector<std::string> const& watchedPaths )
+{
+#ifdef __linux__
+    m_inotifyDescriptor = inotify_init1( IN_CLOEXEC );
+#endif
+
+    for ( auto const& watchedPath : watchedPaths )
+    {
+        auto fileError = std::error_code{};
+
+        if ( std::filesystem::is_directory( watchedPath, fileError ) )
+        {
+            watchDirectoryTree( watchedPath );
+        }
+        else
+        {
+            watchFile( watchedPath );
+        }
+    }
+}
+
+DirectoryWatcher::~DirectoryWatcher()
+{
+#ifdef __linux__
+    if ( m_inotifyDescriptor >= 0 )
+    {
+        close( m_inotifyDescriptor );
+    }
+#endif
+}
+
+void
+DirectoryWatcher::watchDirectoryTree( std::string const& pathOfDirectory )
+{
+#ifdef __linux__
+    if ( m_inotifyDescriptor < 0 )
+    {
+        return;
+    }
+
+    auto const watchDirectory =
+        [&]( std::string const& pathOfWatchedDirectory )
+        {
+            auto const watchDescriptor = inotify_add_watch( m_inotifyDescriptor, pathOfWatchedDirectory.c_str(), watchedEvents );
+
+            if ( watchDescriptor >= 0 )
+            {
+                auto& watchedDirectory = m_watchDescriptorToDirectory[watchDescriptor];
+                watchedDirectory.path = pathOfWatchedDirectory;
+                watchedDirectory.isWatchedWhole = true;
+            }
+        };
+
+    watchDirectory( pathOfDirectory );
+
+    auto const directoryOptions = std::filesystem::directory_options::skip_permission_denied;
+    auto directoryError = std::error_code{};
+
+    for ( auto it = std::filesystem::recursive_directory_iterator{ pathOfDirectory, directoryOptions, directoryError };
+          it != std::filesystem::recursive_directory_iterator{};
+          it.increment( directoryError ) )
+    {
+        if ( it->is_directory( directoryError ) )
+        {
+            watchDirectory( it->path().string() );
+        }
+    }
+#else
+    static_cast<void>( pathOfDirectory );
+#endif
+}
+
+void
+DirectoryWatcher::watchFile( std::string const& pathOfFile )
+{
+#ifdef __linux__
+    if ( m_inotifyDescriptor < 0 )
+    {
+        return;
+    }
+
+    auto const filePath = std::filesystem::path( pathOfFile );
+    auto const pathOfParentDirectory = filePath.parent_path().empty() ? std::string{ "." } : filePath.parent_path().string();
+    auto const watchDescriptor = inotify_add_watch( m_inotifyDescriptor, pathOfParentDirectory.c_str(), watchedEvents );
+
+    if ( watchDescriptor >= 0 )
+    {
+        // A directory already watched whole stays so.
+        auto& watchedDirectory = m_watchDescriptorToDirectory[watchDescriptor];
+        if ( watchedDirectory.path.empty() )
+        {
+            watchedDirectory.path = pathOfParentDirectory;
+        }
+        watchedDirectory.watchedFileNames.insert( filePath.filename().string() );
+    }
+#else
+    static_cast<void>( pathOfFile );
+#endif
+}
+
+bool
+DirectoryWatcher::isWatchedEvent( void const* inotifyEvent )
+{
+#ifdef __linux__
+    auto const event = static_cast<inotify_event const*>( inotifyEvent );
+
+    auto const watchedDirectory = m_watchDescriptorToDirectory.find( event->wd );
+    if ( watchedDirectory == m_watchDescriptorToDirectory.end() )
+    {
+        return false;
+    }
+
+    if ( not watchedDirectory->second.isWatchedWhole )
+    {
+        return event->len > 0 and watchedDirectory->second.watchedFileNames.contains( event->name );
+    }
+
+    // Builds often create their output directories as they go.
+    if (     ( event->mask & IN_ISDIR ) != 0
+         and ( event->mask & ( IN_CREATE | IN_MOVED_TO ) ) != 0 )
+    {
+        watchDirectoryTree( ( std::filesystem::path( watchedDirectory->second.path ) / event->name ).string() );
+    }
+
+    return true;
+#else
+    static_cast<void>( inotifyEvent );
+    return false;
+#endif
+}
+
+void
+DirectoryWatcher::waitForChanges( std::chrono::milliseconds const quietPeriod )
+{
+#ifdef __linux__
+    if ( m_inotifyDescriptor >= 0 )
+    {
+        alignas( inotify_event ) char eventsBuffer[64 * 1024];
+        auto pollDescriptor = pollfd{ .fd = m_inotifyDescriptor, .events = POLLIN, .revents = 0 };
+
+        // The first watched event can be a long time coming; every later
+        // one restarts the quiet period. Events for files next to a watched
+        // file are read and dropped without touching either.
+        auto quietPeriodEnd = std::optional<std::chrono::steady_clock::time_point>{};
+
+        while ( true )
+        {
+            auto pollTimeoutInMilliseconds = -1;
+            if ( quietPeriodEnd )
+            {
+                auto const remainingQuietPeriod =
+                    std::chrono::duration_cast<std::chrono::milliseconds>( *quietPeriodEnd - std::chrono::steady_clock::now() );
+                pollTimeoutInMilliseconds = static_cast<int>( std::max<std::int64_t>( remainingQuietPeriod.count(), 0 ) );
+            }
+
+            if ( poll( &pollDescriptor, 1, pollTimeoutInMilliseconds ) <= 0 )
+            {
+                break;
+            }
+
+            auto const eventsSizeInBytes = read( m_inotifyDescriptor, eventsBuffer, sizeof( eventsBuffer ) );
+            auto isAnyEventWatched = false;
+
+            for ( auto eventOffset = ssize_t{ 0 }; eventOffset < eventsSizeInBytes; )
+            {
+                auto const event = reinterpret_cast<inotify_event const*>( eventsBuffer + eventOffset );
+                eventOffset += sizeof( inotify_event ) + event->len;
+
+                isAnyEventWatched = isWatchedEvent( event ) or isAnyEventWatched;
+            }
+
+            if ( isAnyEventWatched )
+            {
+                quietPeriodEnd = std::chrono::steady_clock::now() + quietPeriod;
+            }
+        }
+
+        return;
+    }
+#endif
+
+    std::this_thread::sleep_for( quietPeriod );
+}
\ No newline at end of file
@@ -0,0 +1,91 @@
+
+#ifndef ARTIFACTWATCH_H
+#define ARTIFACTWATCH_H
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+struct ArtifactFingerprint
+{
+    std::uint64_t    sizeInBytes = 0;
+    std::int64_t     lastWriteTimeInNanoseconds = 0;
+    std::uint64_t    contentHash = 0;
+};
+
+enum class ArtifactChange : std::uint8_t
+{
+    None,
+    Added,
+    Modified,
+    Removed
+};
+
+// Remembers a fingerprint per artifact so that only real changes are
+// reported. The contents are hashed only when the size or the last write
+// time moved, so a relink that writes the same bytes, or a touch, is not a
+// change. A file that cannot be read right now, e.g. because the linker
+// still holds it, keeps its previous fingerprint and is checked again on the
+// next call.
+class ArtifactChangeTracker
+{
+public:
+    ArtifactChange
+    updateArtifact( std::string const& pathOfArtifact );
+
+    void
+    forgetArtifact( std::string const& pathOfArtifact );
+
+private:
+    std::map<std::string, ArtifactFingerprint>    m_pathToFingerprint;
+};
+
+// Blocks until something changes below the watched paths, then keeps reading
+// until nothing has changed for the quiet period, so a link storm rewriting
+// dozens of files is reported once. Files are watched through their parent
+// directory, which also catches a file being replaced by a rename; only that
+// directory is watched, and only events naming the file count. Uses inotify
+// on Linux and falls back to returning after every quiet period elsewhere,
+// leaving ArtifactChangeTracker to find what changed.
+class DirectoryWatcher
+{
+public:
+    explicit DirectoryWatcher( std::vector<std::string> const& watchedPaths );
+    ~DirectoryWatcher();
+
+    DirectoryWatcher( DirectoryWatcher const& ) = delete;
+    DirectoryWatcher& operator=( DirectoryWatcher const& ) = delete;
+
+    void
+    waitForChanges( std::chrono::milliseconds const quietPeriod );
+
+private:
+    // A directory watched whole, with its subdirectories, or only for the
+    // given file names in it.
+    struct WatchedDirectory
+    {
+        std::string              path;
+        bool                     isWatchedWhole = false;
+        std::set<std::string>    watchedFileNames;
+    };
+
+    void
+    watchDirectoryTree( std::string const& pathOfDirectory );
+
+    void
+    watchFile( std::string const& pathOfFile );
+
+    // Whether the event names something watched, watching directories
+    // created inside a tree as it goes.
+    bool
+    isWatchedEvent( void const* inotifyEvent );
+
+private:
+    int                                m_inotifyDescriptor = -1;
+    std::map<int, WatchedDirectory>    m_watchDescriptorToDirectory;
+};
+
+#endif // ARTIFACTWATCH_H
\ No newline at end of file
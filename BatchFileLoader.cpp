@@ -0,0 +1,720 @@
+
+#include "BatchFileLoader.h"
+
+#include "ParallelFor.h"
+#include "PEFiles.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#if defined( __linux__ ) && __has_include( <linux/io_uring.h> )
+#define EWEA_HAS_IO_URING
+#include <atomic>
+#include <cerrno>
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+#ifdef EWEA_HAS_IO_URING
+
+namespace
+{
+    auto const numberOfRingEntries = 256u;
+
+    // Every file in flight owns a registered buffer, so this also bounds
+    // the files read ahead of processing.
+    auto const numberOfFileSlots = std::uint32_t{ 32 };
+    auto const registeredBufferSizeInBytes = std::size_t{ 1024 * 1024 };
+
+    enum class RingOperation : std::uint8_t
+    {
+        Open,
+        Stat,
+        Read,
+        Close
+    };
+
+    std::uint64_t
+    makeUserData( std::uint32_t const fileSlotIdx,
+                  RingOperation const ringOperation )
+    {
+        return std::uint64_t{ fileSlotIdx } << 8 | static_cast<std::uint8_t>( ringOperation );
+    }
+
+    // The state of one file between its open and the release of its buffer
+    // by the processing thread.
+    struct FileSlot
+    {
+        std::size_t                   fileIdx = 0;
+        int                           fileDescriptor = -1;
+        struct statx                  fileStatus = {};
+        int                           numberOfPendingOpenSteps = 0;
+        std::uint64_t                 fileSizeInBytes = 0;
+        std::uint64_t                 numberOfReadBytes = 0;
+        unsigned char*                buffer = nullptr;
+        std::vector<unsigned char>    heapBuffer;
+        std::string                   errorMessage;
+    };
+}
+
+// The kernel interface without liburing: the submission and completion
+// rings are shared with the kernel, which reads the submission tail and
+// writes the completion tail, so those are accessed with acquire and
+// release ordering.
+class BatchFileLoader::IOURing
+{
+public:
+    // Throws std::runtime_error when the kernel has no io_uring, refuses
+    // one, or lacks an operation the loader needs.
+    IOURing()
+    {
+        auto ringParameters = io_uring_params{};
+        m_ringDescriptor = static_cast<int>( syscall( __NR_io_uring_setup, numberOfRingEntries, &ringParameters ) );
+
+        if ( m_ringDescriptor < 0 )
+        {
+            throw std::runtime_error{ "io_uring is unavailable." };
+        }
+
+        try
+        {
+            mapRings( ringParameters );
+            checkOperations();
+        }
+        catch ( ... )
+        {
+            unmapRings();
+            close( m_ringDescriptor );
+            throw;
+        }
+
+        registerBuffers();
+    }
+
+    ~IOURing()
+    {
+        unmapRings();
+        close( m_ringDescriptor );
+    }
+
+    IOURing( IOURing const& ) = delete;
+    IOURing& operator=( IOURing const& ) = delete;
+
+    // Null when registering the buffers failed, e.g. for lack of lockable
+    // memory; reads then go to heap buffers.
+    unsigned char*
+    getRegisteredBuffer( std::uint32_t const fileSlotIdx )
+    {
+        return m_registeredBuffers ? m_registeredBuffers.get() + fileSlotIdx * registeredBufferSizeInBytes : nullptr;
+    }
+
+    // Zeroed and ready to fill. Submits the entries prepared so far when
+    // the submission ring is full.
+    io_uring_sqe&
+    prepareSubmission()
+    {
+        if ( m_submissionTail - std::atomic_ref( *m_submissionHead ).load( std::memory_order_acquire ) == m_numberOfSubmissionEntries )
+        {
+            submitAndWait( 0 );
+        }
+
+        auto const entryIdx = m_submissionTail & m_submissionMask;
+        m_submissionIndices[entryIdx] = entryIdx;
+        m_submissionEntries[entryIdx] = io_uring_sqe{};
+        m_submissionTail++;
+
+        return m_submissionEntries[entryIdx];
+    }
+
+    // Submits the prepared entries and waits until at least
+    // minimumNumberOfCompletions have completed.
+    void
+    submitAndWait( unsigned const minimumNumberOfCompletions )
+    {
+        std::atomic_ref( *m_submissionTailInRing ).store( m_submissionTail, std::memory_order_release );
+
+        while ( true )
+        {
+            auto const numberOfUnsubmittedEntries =
+                m_submissionTail - std::atomic_ref( *m_submissionHead ).load( std::memory_order_acquire );
+            auto const flags = minimumNumberOfCompletions > 0 ? IORING_ENTER_GETEVENTS : 0u;
+
+            if ( syscall( __NR_io_uring_enter, m_ringDescriptor, numberOfUnsubmittedEntries, minimumNumberOfCompletions, flags, nullptr, 0 ) >= 0 )
+            {
+                return;
+            }
+
+            if ( errno != EINTR )
+            {
+                throw std::runtime_error{ "Submitting to the io_uring failed." };
+            }
+        }
+    }
+
+    // Each completion is consumed before onCompletion sees it, so none is
+    // seen twice should onCompletion throw.
+    template <typename CompletionFunction>
+    void
+    forEachCompletion( CompletionFunction const& onCompletion )
+    {
+        auto completionHead = *m_completionHead;
+        auto const completionTail = std::atomic_ref( *m_completionTail ).load( std::memory_order_acquire );
+
+        while ( completionHead != completionTail )
+        {
+            auto const completionEntry = m_completionEntries[completionHead & m_completionMask];
+            std::atomic_ref( *m_completionHead ).store( ++completionHead, std::memory_order_release );
+
+            onCompletion( completionEntry.user_data, completionEntry.res );
+        }
+    }
+
+private:
+    void
+    mapRings( io_uring_params const& ringParameters )
+    {
+        // Older kernels map the two rings separately; they also lack the
+        // operations below.
+        if ( ( ringParameters.features & IORING_FEAT_SINGLE_MMAP ) == 0 )
+        {
+            throw std::runtime_error{ "The io_uring is too old." };
+        }
+
+        m_ringsSizeInBytes = std::max( ringParameters.sq_off.array + ringParameters.sq_entries * sizeof( std::uint32_t ),
+                                       ringParameters.cq_off.cqes + ringParameters.cq_entries * sizeof( io_uring_cqe ) );
+        m_entriesSizeInBytes = ringParameters.sq_entries * sizeof( io_uring_sqe );
+
+        auto* const rings = mmap( nullptr, m_ringsSizeInBytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_ringDescriptor, IORING_OFF_SQ_RING );
+        auto* const entries = mmap( nullptr, m_entriesSizeInBytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_ringDescriptor, IORING_OFF_SQES );
+
+        m_rings = rings == MAP_FAILED ? nullptr : static_cast<unsigned char*>( rings );
+        m_submissionEntries = entries == MAP_FAILED ? nullptr : static_cast<io_uring_sqe*>( entries );
+
+        if ( m_rings == nullptr or m_submissionEntries == nullptr )
+        {
+            throw std::runtime_error{ "Mapping the io_uring failed." };
+        }
+
+        m_submissionHead = reinterpret_cast<unsigned*>( m_rings + ringParameters.sq_off.head );
+        m_submissionTailInRing = reinterpret_cast<unsigned*>( m_rings + ringParameters.sq_off.tail );
+        m_submissionMask = *reinterpret_cast<unsigned*>( m_rings + ringParameters.sq_off.ring_mask );
+        m_submissionIndices = reinterpret_cast<unsigned*>( m_rings + ringParameters.sq_off.array );
+        m_numberOfSubmissionEntries = ringParameters.sq_entries;
+        m_submissionTail = *m_submissionTailInRing;
+
+        m_completionHead = reinterpret_cast<unsigned*>( m_rings + ringParameters.cq_off.head );
+        m_completionTail = reinterpret_cast<unsigned*>( m_rings + ringParameters.cq_off.tail );
+        m_completionMask = *reinterpret_cast<unsigned*>( m_rings + ringParameters.cq_off.ring_mask );
+        m_completionEntries = reinterpret_cast<io_uring_cqe*>( m_rings + ringParameters.cq_off.cqes );
+    }
+
+    void
+    unmapRings()
+    {
+        if ( m_rings != nullptr )
+        {
+            munmap( m_rings, m_ringsSizeInBytes );
+        }
+
+        if ( m_submissionEntries != nullptr )
+        {
+            munmap( m_submissionEntries, m_entriesSizeInBytes );
+        }
+    }
+
+    void
+    checkOperations()
+    {
+        auto const numberOfProbedOperations = 256u;
+        auto probeStorage = std::vector<unsigned char>( sizeof( io_uring_probe ) + numberOfProbedOperations * sizeof( io_uring_probe_op ) );
+        auto* const probe = reinterpret_cast<io_uring_probe*>( probeStorage.data() );
+
+        if ( syscall( __NR_io_uring_register, m_ringDescriptor, IORING_REGISTER_PROBE, probe, numberOfProbedOperations ) < 0 )
+        {
+            throw std::runtime_error{ "The io_uring cannot be probed." };
+        }
+
+        for ( auto const operation : { IORING_OP_OPENAT, IORING_OP_STATX, IORING_OP_READ, IORING_OP_READ_FIXED, IORING_OP_CLOSE } )
+        {
+            if ( operation > probe->last_op or ( probe->ops[operation].flags & IO_URING_OP_SUPPORTED ) == 0 )
+            {
+                throw std::runtime_error{ "The io_uring lacks an operation." };
+            }
+        }
+    }
+
+    void
+    registerBuffers()
+    {
+        m_registeredBuffers = std::make_unique_for_overwrite<unsigned char[]>( numberOfFileSlots * registeredBufferSizeInBytes );
+
+        auto bufferVectors = std::vector<iovec>( numberOfFileSlots );
+        for ( auto fileSlotIdx = std::uint32_t{ 0 }; fileSlotIdx < numberOfFileSlots; fileSlotIdx++ )
+        {
+            bufferVectors[fileSlotIdx] = iovec{ .iov_base = getRegisteredBuffer( fileSlotIdx ), .iov_len = registeredBufferSizeInBytes };
+        }
+
+        if ( syscall( __NR_io_uring_register, m_ringDescriptor, IORING_REGISTER_BUFFERS, bufferVectors.data(), numberOfFileSlots ) < 0 )
+        {
+            m_registeredBuffers.reset();
+        }
+    }
+
+private:
+    int                                 m_ringDescriptor = -1;
+    unsigned char*                      m_rings = nullptr;
+    std::size_t                         m_ringsSizeInBytes = 0;
+    std::size_t                         m_entriesSizeInBytes = 0;
+
+    io_uring_sqe*                       m_submissionEntries = nullptr;
+    unsigned*                           m_submissionHead = nullptr;
+    unsigned*                           m_submissionTailInRing = nullptr;
+    unsigned*                           m_submissionIndices = nullptr;
+    unsigned                            m_submissionMask = 0;
+    unsigned                            m_numberOfSubmissionEntries = 0;
+    unsigned                            m_submissionTail = 0;
+
+    io_uring_cqe*                       m_completionEntries = nullptr;
+    unsigned*                           m_completionHead = nullptr;
+    unsigned*                           m_completionTail = nullptr;
+    unsigned                            m_completionMask = 0;
+
+    std::unique_ptr<unsigned char[]>    m_registeredBuffers;
+};
+
+#else
+
+class BatchFileLoader::IOURing
+{
+};
+
+#endif
+
+BatchFileLoader::BatchFileLoader( FileLoaderBackend const requestedBackend )
+{
+#ifdef EWEA_HAS_IO_URING
+    if ( requestedBackend == FileLoaderBackend::IOUring )
+    {
+        try
+        {
+            m_ioURing = std::make_unique<IOURing>();
+        }
+        catch ( std::runtime_error const& )
+        {
+        }
+    }
+#else
+    static_cast<void>( requestedBackend );
+#endif
+}
+
+BatchFileLoader::~BatchFileLoader() = default;
+
+void
+BatchFileLoader::loadFiles( std::span<std::string const> const filePaths,
+                            FileCallback const& onFileLoaded )
+{
+    if ( m_ioURing )
+    {
+        loadFilesWithIOURing( filePaths, onFileLoaded );
+        return;
+    }
+
+    parallelFor( filePaths.size(),
+                 [&]( std::size_t const fileIdx )
+                 {
+                     auto rawBytes = std::vector<unsigned char>{};
+                     auto loadedFile = LoadedFile{};
+
+                     try
+                     {
+                         rawBytes = loadPEFileAsRawBytes( filePaths[fileIdx] );
+                         loadedFile.rawBytes = rawBytes;
+                     }
+                     catch ( std::runtime_error const& readError )
+                     {
+                         loadedFile.errorMessage = readError.what();
+                     }
+
+                     onFileLoaded( fileIdx, loadedFile );
+                 } );
+}
+
+void
+BatchFileLoader::loadFilesWithIOURing( std::span<std::string const> const filePaths,
+                                       FileCallback const& onFileLoaded )
+{
+#ifdef EWEA_HAS_IO_URING
+    auto& ioURing = *m_ioURing;
+    auto fileSlots = std::vector<FileSlot>( numberOfFileSlots );
+
+    // Shared with the processing threads.
+    auto slotsMutex = std::mutex{};
+    auto slotsCondition = std::condition_variable{};
+    auto freeSlotIndices = std::vector<std::uint32_t>( numberOfFileSlots );
+    auto readSlotIndices = std::deque<std::uint32_t>{};
+    auto isReadingDone = false;
+    auto firstException = std::exception_ptr{};
+
+    for ( auto fileSlotIdx = std::uint32_t{ 0 }; fileSlotIdx < numberOfFileSlots; fileSlotIdx++ )
+    {
+        freeSlotIndices[fileSlotIdx] = numberOfFileSlots - 1 - fileSlotIdx;
+    }
+
+    auto const runProcessingThread =
+        [&]()
+        {
+            Detail::isInsideParallelFor = true;
+
+            while ( true )
+            {
+                auto lock = std::unique_lock{ slotsMutex };
+                slotsCondition.wait( lock, [&]() { return not readSlotIndices.empty() or isReadingDone; } );
+
+                if ( readSlotIndices.empty() )
+                {
+                    break;
+                }
+
+                auto const fileSlotIdx = readSlotIndices.front();
+                readSlotIndices.pop_front();
+                auto const shouldHandOut = not firstException;
+                lock.unlock();
+
+                auto& fileSlot = fileSlots[fileSlotIdx];
+
+                try
+                {
+                    if ( shouldHandOut )
+                    {
+                        auto const rawBytes = std::span<unsigned char const>( fileSlot.buffer, fileSlot.errorMessage.empty() ? fileSlot.fileSizeInBytes : 0 );
+                        onFileLoaded( fileSlot.fileIdx, LoadedFile{ .rawBytes = rawBytes, .errorMessage = fileSlot.errorMessage } );
+                    }
+                }
+                catch ( ... )
+                {
+                    auto const exceptionLock = std::scoped_lock{ slotsMutex };
+                    if ( not firstException )
+                    {
+                        firstException = std::current_exception();
+                    }
+                }
+
+                fileSlot.heapBuffer = {};
+
+                lock.lock();
+                freeSlotIndices.push_back( fileSlotIdx );
+                slotsCondition.notify_all();
+            }
+
+            Detail::isInsideParallelFor = false;
+        };
+
+    auto const numberOfProcessingThreads = std::max( 1u, std::thread::hardware_concurrency() );
+    auto processingThreads = std::vector<std::thread>{};
+    processingThreads.reserve( numberOfProcessingThreads );
+
+    for ( auto i = 0u; i < numberOfProcessingThreads; i++ )
+    {
+        processingThreads.emplace_back( runProcessingThread );
+    }
+
+    auto const handOut =
+        [&]( std::uint32_t const fileSlotIdx )
+        {
+            auto const lock = std::scoped_lock{ slotsMutex };
+            readSlotIndices.push_back( fileSlotIdx );
+            slotsCondition.notify_one();
+        };
+
+    auto numberOfOperationsInFlight = std::size_t{ 0 };
+
+    auto const prepareOperation =
+        [&]( std::uint32_t const fileSlotIdx,
+             RingOperation const ringOperation ) -> io_uring_sqe&
+        {
+            auto& submissionEntry = ioURing.prepareSubmission();
+            submissionEntry.user_data = makeUserData( fileSlotIdx, ringOperation );
+            numberOfOperationsInFlight++;
+
+            return submissionEntry;
+        };
+
+    auto const prepareRead =
+        [&]( std::uint32_t const fileSlotIdx )
+        {
+            auto& fileSlot = fileSlots[fileSlotIdx];
+            auto& submissionEntry = prepareOperation( fileSlotIdx, RingOperation::Read );
+
+            submissionEntry.opcode = fileSlot.heapBuffer.empty() ? IORING_OP_READ_FIXED : IORING_OP_READ;
+            submissionEntry.buf_index = static_cast<std::uint16_t>( fileSlotIdx );
+            submissionEntry.fd = fileSlot.fileDescriptor;
+            submissionEntry.addr = reinterpret_cast<std::uint64_t>( fileSlot.buffer + fileSlot.numberOfReadBytes );
+            submissionEntry.len = static_cast<std::uint32_t>( std::min<std::uint64_t>( fileSlot.fileSizeInBytes - fileSlot.numberOfReadBytes, 1u << 30 ) );
+            submissionEntry.off = fileSlot.numberOfReadBytes;
+        };
+
+    // The descriptor is closed without waiting, and the file handed out.
+    auto const finishFile =
+        [&]( std::uint32_t const fileSlotIdx )
+        {
+            auto& fileSlot = fileSlots[fileSlotIdx];
+
+            if ( fileSlot.fileDescriptor >= 0 )
+            {
+                auto& submissionEntry = prepareOperation( fileSlotIdx, RingOperation::Close );
+                submissionEntry.opcode = IORING_OP_CLOSE;
+                submissionEntry.fd = fileSlot.fileDescriptor;
+                fileSlot.fileDescriptor = -1;
+            }
+
+            handOut( fileSlotIdx );
+        };
+
+    // Once opened and sized, the file is read into the slot's registered
+    // buffer when it fits and there is one, and into a heap buffer
+    // otherwise.
+    auto const onOpened =
+        [&]( std::uint32_t const fileSlotIdx )
+        {
+            auto& fileSlot = fileSlots[fileSlotIdx];
+
+            if ( not fileSlot.errorMessage.empty() or fileSlot.fileStatus.stx_size == 0 )
+            {
+                finishFile( fileSlotIdx );
+                return;
+            }
+
+            fileSlot.fileSizeInBytes = fileSlot.fileStatus.stx_size;
+            fileSlot.buffer = ioURing.getRegisteredBuffer( fileSlotIdx );
+
+            if ( fileSlot.buffer == nullptr or fileSlot.fileSizeInBytes > registeredBufferSizeInBytes )
+            {
+                fileSlot.heapBuffer.resize( fileSlot.fileSizeInBytes );
+                fileSlot.buffer = fileSlot.heapBuffer.data();
+            }
+
+            prepareRead( fileSlotIdx );
+        };
+
+    auto const onCompletion =
+        [&]( std::uint64_t const userData,
+             std::int32_t const result )
+        {
+            numberOfOperationsInFlight--;
+
+            // The slot of a close may already be processing, or even hold
+            // the next file.
+            auto const ringOperation = static_cast<RingOperation>( userData & 0xFF );
+            if ( ringOperation == RingOperation::Close )
+            {
+                return;
+            }
+
+            auto const fileSlotIdx = static_cast<std::uint32_t>( userData >> 8 );
+            auto& fileSlot = fileSlots[fileSlotIdx];
+            auto const& pathOfFile = filePaths[fileSlot.fileIdx];
+
+            switch ( ringOperation )
+            {
+                case RingOperation::Open:
+                case RingOperation::Stat:
+                    if ( ringOperation == RingOperation::Open )
+                    {
+                        fileSlot.fileDescriptor = result >= 0 ? result : -1;
+                    }
+
+                    if ( result < 0 and fileSlot.errorMessage.empty() )
+                    {
+                        fileSlot.errorMessage = "Failed to open '" + pathOfFile + "'.";
+                    }
+
+                    if ( --fileSlot.numberOfPendingOpenSteps == 0 )
+                    {
+                        onOpened( fileSlotIdx );
+                    }
+                    break;
+                case RingOperation::Read:
+                    if ( result == -EINTR or result == -EAGAIN )
+                    {
+                        prepareRead( fileSlotIdx );
+                        break;
+                    }
+
+                    // A file that shrank since it was sized ends early.
+                    if ( result <= 0 )
+                    {
+                        fileSlot.errorMessage = "Failed to read '" + pathOfFile + "'.";
+                        finishFile( fileSlotIdx );
+                        break;
+                    }
+
+                    fileSlot.numberOfReadBytes += static_cast<std::uint64_t>( result );
+
+                    if ( fileSlot.numberOfReadBytes < fileSlot.fileSizeInBytes )
+                    {
+                        prepareRead( fileSlotIdx );
+                    }
+                    else
+                    {
+                        finishFile( fileSlotIdx );
+                    }
+                    break;
+                default:
+                    break;
+            }
+        };
+
+    auto ringException = std::exception_ptr{};
+
+    try
+    {
+        auto nextFileIdx = std::size_t{ 0 };
+        auto startedSlotIndices = std::vector<std::uint32_t>{};
+
+        while ( true )
+        {
+            {
+                auto lock = std::unique_lock{ slotsMutex };
+
+                // With nothing in flight, only the processing threads can
+                // make progress, by freeing a slot.
+                if ( numberOfOperationsInFlight == 0 and nextFileIdx < filePaths.size() )
+                {
+                    slotsCondition.wait( lock, [&]() { return not freeSlotIndices.empty(); } );
+                }
+
+                while ( nextFileIdx + startedSlotIndices.size() < filePaths.size() and not freeSlotIndices.empty() )
+                {
+                    startedSlotIndices.push_back( freeSlotIndices.back() );
+                    freeSlotIndices.pop_back();
+                }
+            }
+
+            // The open and the size are requested together, both by path.
+            for ( auto const fileSlotIdx : startedSlotIndices )
+            {
+                auto& fileSlot = fileSlots[fileSlotIdx];
+                fileSlot = FileSlot{ .fileIdx = nextFileIdx++, .numberOfPendingOpenSteps = 2 };
+
+                auto& openEntry = prepareOperation( fileSlotIdx, RingOperation::Open );
+                openEntry.opcode = IORING_OP_OPENAT;
+                openEntry.fd = AT_FDCWD;
+                openEntry.addr = reinterpret_cast<std::uint64_t>( filePaths[fileSlot.fileIdx].c_str() );
+                openEntry.open_flags = O_RDONLY | O_CLOEXEC;
+
+                auto& statEntry = prepareOperation( fileSlotIdx, RingOperation::Stat );
+                statEntry.opcode = IORING_OP_STATX;
+                statEntry.fd = AT_FDCWD;
+                statEntry.addr = reinterpret_cast<std::uint64_t>( filePaths[fileSlot.fileIdx].c_str() );
+                statEntry.len = STATX_SIZE;
+                statEntry.off = reinterpret_cast<std::uint64_t>( &fileSlot.fileStatus );
+            }
+
+            startedSlotIndices.clear();
+
+            if ( numberOfOperationsInFlight == 0 )
+            {
+                break;
+            }
+
+            ioURing.submitAndWait( 1 );
+            ioURing.forEachCompletion( onCompletion );
+        }
+    }
+    catch ( ... )
+    {
+        ringException = std::current_exception();
+    }
+
+    {
+        auto const lock = std::scoped_lock{ slotsMutex };
+        isReadingDone = true;
+        slotsCondition.notify_all();
+    }
+
+    for ( auto& processingThread : processingThreads )
+    {
+        processingThread.join();
+    }
+
+    if ( ringException )
+    {
+        // The kernel still writes into the slots and their buffers for every
+        // operation in flight, so all of them are waited for before the slots
+        // go away. Files opened meanwhile are closed here, not on the ring.
+        auto* drainedFileSlots = &fileSlots;
+
+        try
+        {
+            while ( numberOfOperationsInFlight > 0 )
+            {
+                ioURing.submitAndWait( 1 );
+                ioURing.forEachCompletion(
+                    [&]( std::uint64_t const userData,
+                         std::int32_t const result )
+                    {
+                        numberOfOperationsInFlight--;
+
+                        if ( static_cast<RingOperation>( userData & 0xFF ) == RingOperation::Open and result >= 0 )
+                        {
+                            fileSlots[userData >> 8].fileDescriptor = result;
+                        }
+                    } );
+            }
+        }
+        catch ( std::runtime_error const& )
+        {
+            // A ring that cannot be waited on may still finish its operations
+            // at any time, so the slots and the ring with its registered
+            // buffers are left to it for good, and later loads use threads.
+            drainedFileSlots = new std::vector<FileSlot>( std::move( fileSlots ) );
+            static_cast<void>( m_ioURing.release() );
+        }
+
+        for ( auto const& fileSlot : *drainedFileSlots )
+        {
+            if ( fileSlot.fileDescriptor >= 0 )
+            {
+                close( fileSlot.fileDescriptor );
+            }
+        }
+
+        std::rethrow_exception( ringException );
+    }
+
+    if ( firstException )
+    {
+        std::rethrow_exception( firstException );
+    }
+#else
+    static_cast<void>( filePaths );
+    static_cast<void>( onFileLoaded );
+#endif
+}
+
+FileLoaderBackend
+getFileLoaderBackendFromName( std::string const& backendName )
+{
+    if ( backendName == "threads" )
+    {
+        return FileLoaderBackend::Threads;
+    }
+    if ( backendName == "io_uring" )
+    {
+        return FileLoaderBackend::IOUring;
+    }
+
+    throw std::invalid_argument{ "Unknown I/O backend '" + backendName + "'." };
+}
\ No newline at end of file
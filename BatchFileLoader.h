@@ -0,0 +1,82 @@
+
+#ifndef BATCHFILELOADER_H
+#define BATCHFILELOADER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <span>
+#include <string>
+
+enum class FileLoaderBackend : std::uint8_t
+{
+    Threads,
+    IOUring
+};
+
+// A file as read by a BatchFileLoader. The bytes are only valid during the
+// callback they are handed to; they are empty when the file could not be
+// read, and the error message says why.
+struct LoadedFile
+{
+    std::span<unsigned char const>    rawBytes;
+    std::string                       errorMessage;
+};
+
+// Reads whole files for a batch scan and hands each to a pool of processing
+// threads as soon as it is read.
+//
+// With the Threads backend, every processing thread reads its next file with
+// loadPEFileAsRawBytes, one blocking read at a time. With the IOUring
+// backend, one thread keeps the opens, sizes, reads and closes of up to 32
+// files in flight on an io_uring at once, reading into buffers registered
+// with the kernel up front, and the processing threads only process. This
+// keeps a fast disk busy where the blocking reads would leave it idle
+// between system calls. io_uring is only on Linux, and may be unavailable
+// there too, e.g. blocked by a container's seccomp profile; the loader then
+// falls back to Threads.
+class BatchFileLoader
+{
+public:
+    using FileCallback = std::function<void( std::size_t const fileIdx, LoadedFile const& loadedFile )>;
+
+    explicit BatchFileLoader( FileLoaderBackend const requestedBackend );
+    ~BatchFileLoader();
+
+    BatchFileLoader( BatchFileLoader const& ) = delete;
+    BatchFileLoader& operator=( BatchFileLoader const& ) = delete;
+
+    FileLoaderBackend
+    getBackend() const
+    {
+        return m_ioURing ? FileLoaderBackend::IOUring : FileLoaderBackend::Threads;
+    }
+
+    // Calls onFileLoaded( fileIdx, loadedFile ) for every path, from the
+    // processing threads and in no particular order. The first exception
+    // thrown by a callback is rethrown once every file has been handed out;
+    // the files after it are read but not handed out. A failure of the
+    // io_uring itself is thrown once nothing is left in flight on it. Calls
+    // may not overlap.
+    void
+    loadFiles( std::span<std::string const> const filePaths,
+               FileCallback const& onFileLoaded );
+
+private:
+    class IOURing;
+
+    void
+    loadFilesWithIOURing( std::span<std::string const> const filePaths,
+                          FileCallback const& onFileLoaded );
+
+private:
+    std::unique_ptr<IOURing>    m_ioURing;
+};
+
+// Throws std::invalid_argument for names other than "threads" and
+// "io_uring".
+FileLoaderBackend
+getFileLoaderBackendFromName( std::string const& backendName );
+
+#endif // BATCHFILELOADER_H
\ No newline at end of file
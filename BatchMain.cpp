@@ -0,0 +1,1031 @@
+
+#include "ArtifactWatch.h"
+#include "BatchFileLoader.h"
+#include "BatchScanner.h"
+#include "CorpusDatabase.h"
+#include "Instrumentation.h"
+#include "ResultWriter.h"
+#include "RichHeader.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#endif
+
+namespace
+{
+    struct StageTotals
+    {
+        std::int64_t     durationInNanoseconds = 0;
+        std::uint64_t    numberOfCalls = 0;
+    };
+
+    struct SignatureScanTotals
+    {
+        std::uint64_t    numberOfScannedBytes = 0;
+        std::int64_t     durationInNanoseconds = 0;
+        std::uint64_t    numberOfMatches = 0;
+    };
+
+    // Long enough to span the gaps between a linker's writes to one output
+    // and between the outputs of one build step.
+    auto const watchQuietPeriod = std::chrono::milliseconds{ 300 };
+
+    void
+    printExtractedStrings( ExtractedStrings const& extractedStrings )
+    {
+        for ( auto const& extractedString : extractedStrings.strings )
+        {
+            auto const rva = getStringRVA( extractedStrings, extractedString );
+
+            std::printf( "    0x%08llx\t", static_cast<unsigned long long>( extractedString.fileOffset ) );
+            if ( rva )
+            {
+                std::printf( "0x%08x\t", *rva );
+            }
+            else
+            {
+                std::printf( "-\t" );
+            }
+
+            // Tabs inside a string are escaped to keep one string per
+            // tab-separated line.
+            auto escapedText = std::string{};
+            for ( auto const character : getStringText( extractedStrings, extractedString ) )
+            {
+                escapedText += character == '\t' ? "\\t" : character == '\\' ? "\\\\" : std::string( 1, character );
+            }
+
+            std::printf( "%s\t%s\t%s\n",
+                         extractedStrings.regions[extractedString.regionIdx].name.c_str(),
+                         getStringEncodingName( extractedString.encoding ).c_str(),
+                         escapedText.c_str() );
+        }
+    }
+
+    void
+    printSignatureMatches( SignatureScanResult const& signatureScanResult,
+                           CompiledSignatures const& compiledSignatures )
+    {
+        for ( auto const& signatureMatch : signatureScanResult.matches )
+        {
+            std::printf( "    %s\t%s\t0x%08llx\t",
+                         compiledSignatures.signatures[signatureMatch.signatureIdx].name.c_str(),
+                         signatureScanResult.sectionNames[signatureMatch.sectionIdx].c_str(),
+                         static_cast<unsigned long long>( signatureMatch.fileOffset ) );
+            if ( signatureMatch.rva )
+            {
+                std::printf( "0x%08x\n", *signatureMatch.rva );
+            }
+            else
+            {
+                std::printf( "-\n" );
+            }
+        }
+    }
+
+    void
+    printRichHeader( RichHeader const& richHeader )
+    {
+        std::printf( "    rich\tkey=0x%08x\tchecksum=%s\n",
+                     richHeader.xorKey, richHeader.isChecksumValid() ? "valid" : "invalid" );
+
+        for ( auto const& richHeaderEntry : richHeader.entries )
+        {
+            std::printf( "    rich\tprodid=0x%04x\tbuild=%u\tcount=%u\n",
+                         richHeaderEntry.productId, richHeaderEntry.buildNumber, richHeaderEntry.count );
+        }
+    }
+
+    void
+    printScanSummary( Batch::ScanSummary const& scanSummary,
+                      Batch::ScanOptions const& scanOptions,
+                      bool const shouldPrintRichHeader )
+    {
+        std::cout << scanSummary.path << '\t' << Batch::getArtifactKindName( scanSummary.kind );
+
+        if ( not scanSummary.errorMessage.empty() )
+        {
+            std::cout << "\terror: " << scanSummary.errorMessage << '\n';
+            return;
+        }
+
+        char machine[8];
+        std::snprintf( machine, sizeof( machine ), "0x%04x", scanSummary.targetMachineArchitecture );
+
+        std::cout << "\tbytes=" << scanSummary.fileSizeInBytes
+                  << "\tmachine=" << machine
+                  << "\tsections=" << scanSummary.numberOfSections;
+
+        if ( scanSummary.kind == Batch::ArtifactKind::EXE and scanOptions.parseDepth != ParseDepth::Headers )
+        {
+            std::cout << "\tdlls=" << scanSummary.numberOfImportedDLLs
+                      << "\timports=" << scanSummary.numberOfImportedFunctions
+                      << "\texports=" << scanSummary.numberOfExportedFunctions;
+        }
+
+        std::cout << '\n';
+
+        if ( shouldPrintRichHeader and scanSummary.richHeader )
+        {
+            std::cout << std::flush;
+            printRichHeader( *scanSummary.richHeader );
+        }
+
+        for ( auto const& headerFieldGroup : scanSummary.headerFieldGroups )
+        {
+            for ( auto const& fieldRow : headerFieldGroup.fieldRows )
+            {
+                std::cout << "    header\t" << headerFieldGroup.name << '\t' << fieldRow.name << '\t' << fieldRow.value << '\n';
+            }
+        }
+
+        if ( scanOptions.shouldComputeSimilarityDigests )
+        {
+            std::cout << "    similarity\tfile\t"
+                      << ( scanSummary.similarityDigest ? formatSimilarityDigest( *scanSummary.similarityDigest ) : "-" ) << '\n';
+
+            for ( auto const& [sectionName, sectionSimilarityDigest] : scanSummary.sectionSimilarityDigests )
+            {
+                std::cout << "    similarity\t" << sectionName << '\t' << formatSimilarityDigest( sectionSimilarityDigest ) << '\n';
+            }
+        }
+
+        for ( auto const& referencesOfFunction : scanSummary.importedFunctionReferences )
+        {
+            std::cout << "    " << referencesOfFunction.importedDLLName << '!' << referencesOfFunction.importedFunctionName
+                      << "\tcalls=" << referencesOfFunction.numberOfCalls
+                      << "\tjumps=" << referencesOfFunction.numberOfJumps
+                      << "\tloads=" << referencesOfFunction.numberOfLoads << '\n';
+        }
+
+        printExtractedStrings( scanSummary.extractedStrings );
+
+        if ( scanOptions.compiledSignatures != nullptr )
+        {
+            printSignatureMatches( scanSummary.signatureScanResult, *scanOptions.compiledSignatures );
+        }
+
+        // Interleaving stdout and stdio output would reorder the lines.
+        std::fflush( stdout );
+    }
+
+    void
+    writeOptionalRVA( ResultWriter& resultWriter,
+                      std::optional<std::uint32_t> const rva )
+    {
+        if ( rva )
+        {
+            resultWriter.writeUnsigned( *rva );
+        }
+        else
+        {
+            resultWriter.writeNull();
+        }
+    }
+
+    // One record per summary, holding what printScanSummary prints. The
+    // headers are written from the raw values, named as in the field tables.
+    void
+    writeScanRecord( ResultWriter& resultWriter,
+                     Batch::ScanSummary const& scanSummary,
+                     Batch::ScanOptions const& scanOptions,
+                     bool const shouldWriteRichHeader )
+    {
+        resultWriter.beginObject();
+        resultWriter.writeKey( "schema" );
+        resultWriter.writeUnsigned( resultSchemaVersion );
+        resultWriter.writeKey( "path" );
+        resultWriter.writeString( scanSummary.path );
+        resultWriter.writeKey( "kind" );
+        resultWriter.writeString( scanSummary.kind == Batch::ArtifactKind::OBJ ? "OBJ" : "EXE" );
+
+        if ( not scanSummary.errorMessage.empty() )
+        {
+            resultWriter.writeKey( "error" );
+            resultWriter.writeString( scanSummary.errorMessage );
+            resultWriter.endObject();
+            resultWriter.endRecord();
+            return;
+        }
+
+        resultWriter.writeKey( "bytes" );
+        resultWriter.writeUnsigned( scanSummary.fileSizeInBytes );
+        resultWriter.writeKey( "machine" );
+        resultWriter.writeUnsigned( scanSummary.targetMachineArchitecture );
+        resultWriter.writeKey( "sections" );
+        resultWriter.writeUnsigned( scanSummary.numberOfSections );
+
+        if ( scanSummary.kind == Batch::ArtifactKind::EXE and scanOptions.parseDepth != ParseDepth::Headers )
+        {
+            resultWriter.writeKey( "dlls" );
+            resultWriter.writeUnsigned( scanSummary.numberOfImportedDLLs );
+            resultWriter.writeKey( "imports" );
+            resultWriter.writeUnsigned( scanSummary.numberOfImportedFunctions );
+            resultWriter.writeKey( "exports" );
+            resultWriter.writeUnsigned( scanSummary.numberOfExportedFunctions );
+        }
+
+        if ( shouldWriteRichHeader and scanSummary.richHeader )
+        {
+            auto const& richHeader = *scanSummary.richHeader;
+
+            resultWriter.writeKey( "rich" );
+            resultWriter.beginObject();
+            resultWriter.writeKey( "key" );
+            resultWriter.writeUnsigned( richHeader.xorKey );
+            resultWriter.writeKey( "checksumValid" );
+            resultWriter.writeBoolean( richHeader.isChecksumValid() );
+            resultWriter.writeKey( "entries" );
+            resultWriter.beginArray();
+
+            for ( auto const& richHeaderEntry : richHeader.entries )
+            {
+                resultWriter.beginObject();
+                resultWriter.writeKey( "prodid" );
+                resultWriter.writeUnsigned( richHeaderEntry.productId );
+                resultWriter.writeKey( "build" );
+                resultWriter.writeUnsigned( richHeaderEntry.buildNumber );
+                resultWriter.writeKey( "count" );
+                resultWriter.writeUnsigned( richHeaderEntry.count );
+                resultWriter.endObject();
+            }
+
+            resultWriter.endArray();
+            resultWriter.endObject();
+        }
+
+        if ( scanSummary.ntFileHeader )
+        {
+            resultWriter.writeKey( "headers" );
+            resultWriter.beginObject();
+            resultWriter.writeKey( "file" );
+            writeHeaderFields( resultWriter, *scanSummary.ntFileHeader, PE::ntFileHeaderFields );
+
+            if ( scanSummary.ntOptionalHeader )
+            {
+                resultWriter.writeKey( "optional" );
+                writeHeaderFields( resultWriter, *scanSummary.ntOptionalHeader, PE::ntOptionalHeader64Fields );
+            }
+
+            resultWriter.writeKey( "sections" );
+            resultWriter.beginArray();
+
+            for ( auto const& [sectionName, sectionHeader] : scanSummary.sectionHeaders )
+            {
+                resultWriter.beginObject();
+                resultWriter.writeKey( "name" );
+                resultWriter.writeString( sectionName );
+                resultWriter.writeKey( "fields" );
+                writeHeaderFields( resultWriter, sectionHeader, PE::sectionHeaderFields );
+                resultWriter.endObject();
+            }
+
+            resultWriter.endArray();
+            resultWriter.endObject();
+        }
+
+        if ( scanOptions.shouldComputeSimilarityDigests )
+        {
+            resultWriter.writeKey( "similarity" );
+            resultWriter.beginObject();
+            resultWriter.writeKey( "file" );
+
+            if ( scanSummary.similarityDigest )
+            {
+                resultWriter.writeString( formatSimilarityDigest( *scanSummary.similarityDigest ) );
+            }
+            else
+            {
+                resultWriter.writeNull();
+            }
+
+            resultWriter.writeKey( "sections" );
+            resultWriter.beginArray();
+
+            for ( auto const& [sectionName, sectionSimilarityDigest] : scanSummary.sectionSimilarityDigests )
+            {
+                resultWriter.beginObject();
+                resultWriter.writeKey( "name" );
+                resultWriter.writeString( sectionName );
+                resultWriter.writeKey( "digest" );
+                resultWriter.writeString( formatSimilarityDigest( sectionSimilarityDigest ) );
+                resultWriter.endObject();
+            }
+
+            resultWriter.endArray();
+            resultWriter.endObject();
+        }
+
+        if ( scanOptions.shouldFindImportReferences )
+        {
+            resultWriter.writeKey( "xrefs" );
+            resultWriter.beginArray();
+
+            for ( auto const& referencesOfFunction : scanSummary.importedFunctionReferences )
+            {
+                resultWriter.beginObject();
+                resultWriter.writeKey( "dll" );
+                resultWriter.writeString( referencesOfFunction.importedDLLName );
+                resultWriter.writeKey( "function" );
+                resultWriter.writeString( referencesOfFunction.importedFunctionName );
+                resultWriter.writeKey( "calls" );
+                resultWriter.writeUnsigned( referencesOfFunction.numberOfCalls );
+                resultWriter.writeKey( "jumps" );
+                resultWriter.writeUnsigned( referencesOfFunction.numberOfJumps );
+                resultWriter.writeKey( "loads" );
+                resultWriter.writeUnsigned( referencesOfFunction.numberOfLoads );
+                resultWriter.endObject();
+            }
+
+            resultWriter.endArray();
+        }
+
+        if ( scanOptions.shouldExtractStrings )
+        {
+            auto const& extractedStrings = scanSummary.extractedStrings;
+
+            resultWriter.writeKey( "strings" );
+            resultWriter.beginArray();
+
+            for ( auto const& extractedString : extractedStrings.strings )
+            {
+                resultWriter.beginObject();
+                resultWriter.writeKey( "offset" );
+                resultWriter.writeUnsigned( extractedString.fileOffset );
+                resultWriter.writeKey( "rva" );
+                writeOptionalRVA( resultWriter, getStringRVA( extractedStrings, extractedString ) );
+                resultWriter.writeKey( "region" );
+                resultWriter.writeString( extractedStrings.regions[extractedString.regionIdx].name );
+                resultWriter.writeKey( "encoding" );
+                resultWriter.writeString( getStringEncodingName( extractedString.encoding ) );
+                resultWriter.writeKey( "text" );
+                resultWriter.writeString( getStringText( extractedStrings, extractedString ) );
+                resultWriter.endObject();
+            }
+
+            resultWriter.endArray();
+        }
+
+        if ( scanOptions.compiledSignatures != nullptr )
+        {
+            auto const& signatureScanResult = scanSummary.signatureScanResult;
+
+            resultWriter.writeKey( "signatures" );
+            resultWriter.beginArray();
+
+            for ( auto const& signatureMatch : signatureScanResult.matches )
+            {
+                resultWriter.beginObject();
+                resultWriter.writeKey( "name" );
+                resultWriter.writeString( scanOptions.compiledSignatures->signatures[signatureMatch.signatureIdx].name );
+                resultWriter.writeKey( "section" );
+                resultWriter.writeString( signatureScanResult.sectionNames[signatureMatch.sectionIdx] );
+                resultWriter.writeKey( "offset" );
+                resultWriter.writeUnsigned( signatureMatch.fileOffset );
+                resultWriter.writeKey( "rva" );
+                writeOptionalRVA( resultWriter, signatureMatch.rva );
+                resultWriter.endObject();
+            }
+
+            resultWriter.endArray();
+        }
+
+        resultWriter.endObject();
+        resultWriter.endRecord();
+    }
+
+    void
+    writeRemovedRecord( ResultWriter& resultWriter,
+                        std::string const& pathOfArtifact )
+    {
+        resultWriter.beginObject();
+        resultWriter.writeKey( "schema" );
+        resultWriter.writeUnsigned( resultSchemaVersion );
+        resultWriter.writeKey( "path" );
+        resultWriter.writeString( pathOfArtifact );
+        resultWriter.writeKey( "removed" );
+        resultWriter.writeBoolean( true );
+        resultWriter.endObject();
+        resultWriter.endRecord();
+    }
+
+    // What is done with each summary besides printing it. Summaries are
+    // added in path order, and nothing is collected into a null collector.
+    // With a result writer, summaries are written as records instead of
+    // printed.
+    struct SummaryOutputs
+    {
+        bool                      shouldPrintRichHeader = false;
+        ResultWriter*             resultWriter = nullptr;
+        ToolchainIndex*           toolchainIndex = nullptr;
+        CorpusDatabaseBuilder*    corpusDatabaseBuilder = nullptr;
+    };
+
+    int
+    scanAndPrintArtifacts( std::vector<std::string> const& artifactPaths,
+                           Batch::ScanOptions const& scanOptions,
+                           BatchFileLoader& fileLoader,
+                           SummaryOutputs const& summaryOutputs,
+                           SignatureScanTotals& signatureScanTotals )
+    {
+        // Files are scanned in parallel one window at a time, so that summaries
+        // print in path order without holding every summary in memory. The
+        // window is at least as deep as the reads an io_uring keeps in flight.
+        auto const numberOfFilesPerWindow =
+            std::max<std::size_t>( std::size_t{ 4 } * std::max( 1u, std::thread::hardware_concurrency() ), 64 );
+
+        auto numberOfFailedScans = 0;
+
+        for ( auto windowStart = std::size_t{ 0 }; windowStart < artifactPaths.size(); windowStart += numberOfFilesPerWindow )
+        {
+            auto const windowPaths =
+                std::span( artifactPaths ).subspan( windowStart, std::min( numberOfFilesPerWindow, artifactPaths.size() - windowStart ) );
+            auto scanSummaries = std::vector<Batch::ScanSummary>( windowPaths.size() );
+
+            Batch::scanArtifacts( windowPaths, scanOptions, fileLoader,
+                                  [&scanSummaries]( std::size_t const i, Batch::ScanSummary&& scanSummary )
+                                  {
+                                      scanSummaries[i] = std::move( scanSummary );
+                                  } );
+
+            for ( auto const& scanSummary : scanSummaries )
+            {
+                if ( summaryOutputs.resultWriter != nullptr )
+                {
+                    writeScanRecord( *summaryOutputs.resultWriter, scanSummary, scanOptions, summaryOutputs.shouldPrintRichHeader );
+                }
+                else
+                {
+                    printScanSummary( scanSummary, scanOptions, summaryOutputs.shouldPrintRichHeader );
+                }
+
+                if ( summaryOutputs.toolchainIndex != nullptr and scanSummary.richHeader )
+                {
+                    summaryOutputs.toolchainIndex->addFile( scanSummary.path, *scanSummary.richHeader );
+                }
+
+                if ( summaryOutputs.corpusDatabaseBuilder != nullptr and scanSummary.errorMessage.empty() )
+                {
+                    summaryOutputs.corpusDatabaseBuilder->addFile( CorpusFileRecord
+                                                                   {
+                                                                       .path = scanSummary.path,
+                                                                       .isObjectFile = scanSummary.kind == Batch::ArtifactKind::OBJ,
+                                                                       .fileSizeInBytes = scanSummary.fileSizeInBytes,
+                                                                       .targetMachineArchitecture = scanSummary.targetMachineArchitecture,
+                                                                       .names = scanSummary.names
+                                                                   } );
+                }
+
+                if ( not scanSummary.errorMessage.empty() )
+                {
+                    numberOfFailedScans++;
+                }
+
+                signatureScanTotals.numberOfScannedBytes += scanSummary.signatureScanResult.numberOfScannedBytes;
+                signatureScanTotals.durationInNanoseconds += scanSummary.signatureScanDurationInNanoseconds;
+                signatureScanTotals.numberOfMatches += scanSummary.signatureScanResult.matches.size();
+            }
+        }
+
+        return numberOfFailedScans;
+    }
+
+    // Rescans the artifacts whose contents changed, as they change, until
+    // interrupted. The watcher and the fingerprints are set up before the
+    // initial scan, so a file rewritten during it is rescanned.
+    [[noreturn]] void
+    watchArtifacts( std::vector<std::string> const& inputPaths,
+                    std::vector<std::string> const& initialArtifactPaths,
+                    ArtifactChangeTracker& artifactChangeTracker,
+                    DirectoryWatcher& directoryWatcher,
+                    Batch::ScanOptions const& scanOptions,
+                    BatchFileLoader& fileLoader,
+                    SummaryOutputs const& summaryOutputs,
+                    SignatureScanTotals& signatureScanTotals )
+    {
+        auto knownArtifactPaths = initialArtifactPaths;
+
+        while ( true )
+        {
+            std::cerr << "ewea-batch: watching for changes...\n";
+            directoryWatcher.waitForChanges( watchQuietPeriod );
+
+            auto artifactPaths = Batch::collectArtifactPaths( inputPaths );
+
+            // Deleted files are no longer collected but still need reporting.
+            auto candidateArtifactPaths = std::vector<std::string>{};
+            std::set_union( artifactPaths.begin(), artifactPaths.end(),
+                            knownArtifactPaths.begin(), knownArtifactPaths.end(),
+                            std::back_inserter( candidateArtifactPaths ) );
+
+            auto changedArtifactPaths = std::vector<std::string>{};
+
+            for ( auto const& pathOfArtifact : candidateArtifactPaths )
+            {
+                switch ( artifactChangeTracker.updateArtifact( pathOfArtifact ) )
+                {
+                    case ArtifactChange::Added:
+                    case ArtifactChange::Modified:
+                        changedArtifactPaths.push_back( pathOfArtifact );
+                        break;
+                    case ArtifactChange::Removed:
+                        if ( summaryOutputs.resultWriter != nullptr )
+                        {
+                            writeRemovedRecord( *summaryOutputs.resultWriter, pathOfArtifact );
+                        }
+                        else
+                        {
+                            std::cout << pathOfArtifact << "\tremoved\n";
+                        }
+                        break;
+                    default:
+                        break;
+                }
+            }
+
+            std::cout << std::flush;
+            scanAndPrintArtifacts( changedArtifactPaths, scanOptions, fileLoader, summaryOutputs, signatureScanTotals );
+
+            // Each batch of changes is seen as soon as it is scanned.
+            if ( summaryOutputs.resultWriter != nullptr )
+            {
+                summaryOutputs.resultWriter->flush();
+            }
+
+            knownArtifactPaths = std::move( artifactPaths );
+        }
+    }
+
+    // Lists every tool in the index matching the filters, with the files it
+    // was used to build.
+    void
+    printToolchainQuery( ToolchainIndex const& toolchainIndex,
+                         std::optional<std::uint16_t> const productId,
+                         std::optional<std::uint16_t> const belowBuildNumber )
+    {
+        auto const& paths = toolchainIndex.getPaths();
+
+        for ( auto const& toolchainGroup : toolchainIndex.getGroups() )
+        {
+            if (    ( productId and toolchainGroup.tool.productId != *productId )
+                 or ( belowBuildNumber and toolchainGroup.tool.buildNumber >= *belowBuildNumber ) )
+            {
+                continue;
+            }
+
+            std::printf( "prodid=0x%04x\tbuild=%u\tobjects=%llu\tfiles=%zu\n",
+                         toolchainGroup.tool.productId, toolchainGroup.tool.buildNumber,
+                         static_cast<unsigned long long>( toolchainGroup.numberOfObjects ),
+                         toolchainGroup.fileIndices.size() );
+
+            for ( auto const fileIdx : toolchainGroup.fileIndices )
+            {
+                std::printf( "    %s\n", paths[fileIdx].c_str() );
+            }
+        }
+    }
+
+    void
+    printFileProfile( std::FILE* const output,
+                      Instrumentation::FileProfile const& fileProfile )
+    {
+        // Scopes are recorded as they end, so print them sorted by start time to
+        // show each stage above the stages nested inside it.
+        auto timedScopes = fileProfile.timedScopes;
+        std::stable_sort( timedScopes.begin(), timedScopes.end(),
+                          []( auto const& lhs, auto const& rhs )
+                          {
+                              return lhs.startInNanoseconds < rhs.startInNanoseconds;
+                          } );
+
+        for ( auto const& timedScope : timedScopes )
+        {
+            std::fprintf( output, "    %*s%-*s %10.3f ms\n",
+                                  2 * timedScope.nestingDepth, "",
+                                  24 - 2 * timedScope.nestingDepth, timedScope.name,
+                                  timedScope.durationInNanoseconds / 1'000'000.0 );
+        }
+
+        for ( auto i = 0; i < Instrumentation::numberOfCounters; i++ )
+        {
+            std::fprintf( output, "    %-24s %10llu\n",
+                                  Instrumentation::getCounterName( static_cast<Instrumentation::Counter>( i ) ).c_str(),
+                                  static_cast<unsigned long long>( fileProfile.counters[i] ) );
+        }
+    }
+
+    void
+    printProfileTotals( std::FILE* const output,
+                        std::vector<Instrumentation::FileProfile> const& fileProfiles )
+    {
+        auto stageNameToTotals = std::map<std::string, StageTotals>{};
+        auto counterTotals = std::array<std::uint64_t, Instrumentation::numberOfCounters>{};
+        auto totalDurationInNanoseconds = std::int64_t{ 0 };
+
+        for ( auto const& fileProfile : fileProfiles )
+        {
+            totalDurationInNanoseconds += fileProfile.durationInNanoseconds;
+
+            for ( auto const& timedScope : fileProfile.timedScopes )
+            {
+                auto& stageTotals = stageNameToTotals[timedScope.name];
+                stageTotals.durationInNanoseconds += timedScope.durationInNanoseconds;
+                stageTotals.numberOfCalls++;
+            }
+
+            for ( auto i = 0; i < Instrumentation::numberOfCounters; i++ )
+            {
+                counterTotals[i] += fileProfile.counters[i];
+            }
+        }
+
+        std::fprintf( output, "\nTotals over %zu files (%.3f ms):\n",
+                              fileProfiles.size(), totalDurationInNanoseconds / 1'000'000.0 );
+
+        for ( auto const& [stageName, stageTotals] : stageNameToTotals )
+        {
+            std::fprintf( output, "    %-24s %10.3f ms  %8llu calls\n",
+                                  stageName.c_str(),
+                                  stageTotals.durationInNanoseconds / 1'000'000.0,
+                                  static_cast<unsigned long long>( stageTotals.numberOfCalls ) );
+        }
+
+        for ( auto i = 0; i < Instrumentation::numberOfCounters; i++ )
+        {
+            std::fprintf( output, "    %-24s %10llu\n",
+                                  Instrumentation::getCounterName( static_cast<Instrumentation::Counter>( i ) ).c_str(),
+                                  static_cast<unsigned long long>( counterTotals[i] ) );
+        }
+    }
+}
+
+int
+main( int argCount, char** args )
+{
+    auto inputPaths = std::vector<std::string>{};
+    auto shouldPrintProfile = false;
+    auto pathOfTraceFile = std::string{};
+    auto scanOptions = Batch::ScanOptions{};
+    auto pathOfSignaturesFile = std::string{};
+    auto shouldWatch = false;
+    auto summaryOutputs = SummaryOutputs{};
+    auto pathOfToolchainIndexToWrite = std::string{};
+    auto pathOfCorpusDatabaseToWrite = std::string{};
+    auto pathOfToolchainIndexToQuery = std::string{};
+    auto queriedProductId = std::optional<std::uint16_t>{};
+    auto queriedBelowBuildNumber = std::optional<std::uint16_t>{};
+    auto resultFormat = std::optional<ResultFormat>{};
+    auto pathOfResultsFile = std::string{};
+    auto requestedFileLoaderBackend = std::optional<FileLoaderBackend>{};
+
+    try
+    {
+        for ( auto i = 1; i < argCount; i++ )
+        {
+            auto const argument = std::string( args[i] );
+
+            if ( argument == "--profile" )
+            {
+                shouldPrintProfile = true;
+            }
+            else if ( argument == "--xrefs" )
+            {
+                scanOptions.shouldFindImportReferences = true;
+            }
+            else if ( argument == "--strings" )
+            {
+                scanOptions.shouldExtractStrings = true;
+            }
+            else if ( argument == "--min-string-length" and i + 1 < argCount )
+            {
+                scanOptions.stringExtractionOptions.minimumLengthInCharacters =
+                    static_cast<std::uint32_t>( std::max( std::stoi( args[++i] ), 1 ) );
+            }
+            else if ( argument == "--signatures" and i + 1 < argCount )
+            {
+                pathOfSignaturesFile = args[++i];
+            }
+            else if ( argument == "--depth" and i + 1 < argCount )
+            {
+                scanOptions.parseDepth = Batch::getParseDepthFromName( args[++i] );
+            }
+            else if ( argument == "--watch" )
+            {
+                shouldWatch = true;
+            }
+            else if ( argument == "--rich" )
+            {
+                summaryOutputs.shouldPrintRichHeader = true;
+            }
+            else if ( argument == "--headers" )
+            {
+                scanOptions.shouldCollectHeaderFields = true;
+            }
+            else if ( argument == "--similarity" )
+            {
+                scanOptions.shouldComputeSimilarityDigests = true;
+            }
+            else if ( argument == "--toolchain-index" and i + 1 < argCount )
+            {
+                pathOfToolchainIndexToWrite = args[++i];
+            }
+            else if ( argument == "--database" and i + 1 < argCount )
+            {
+                pathOfCorpusDatabaseToWrite = args[++i];
+                scanOptions.shouldCollectNames = true;
+            }
+            else if ( argument == "--query-toolchains" and i + 1 < argCount )
+            {
+                pathOfToolchainIndexToQuery = args[++i];
+            }
+            else if ( argument == "--product" and i + 1 < argCount )
+            {
+                queriedProductId = static_cast<std::uint16_t>( std::stoul( args[++i], nullptr, 0 ) );
+            }
+            else if ( argument == "--below-build" and i + 1 < argCount )
+            {
+                queriedBelowBuildNumber = static_cast<std::uint16_t>( std::stoul( args[++i], nullptr, 0 ) );
+            }
+            else if ( argument == "--format" and i + 1 < argCount )
+            {
+                auto const formatName = std::string( args[++i] );
+
+                if ( formatName == "jsonl" )
+                {
+                    resultFormat = ResultFormat::JSONLines;
+                }
+                else if ( formatName == "cbor" )
+                {
+                    resultFormat = ResultFormat::CBOR;
+                }
+                else if ( formatName == "text" )
+                {
+                    resultFormat.reset();
+                }
+                else
+                {
+                    throw std::invalid_argument{ "Unknown format '" + formatName + "'." };
+                }
+            }
+            else if ( argument == "--output" and i + 1 < argCount )
+            {
+                pathOfResultsFile = args[++i];
+            }
+            else if ( argument == "--trace" and i + 1 < argCount )
+            {
+                pathOfTraceFile = args[++i];
+            }
+            else if ( argument == "--io" and i + 1 < argCount )
+            {
+                requestedFileLoaderBackend = getFileLoaderBackendFromName( args[++i] );
+            }
+            else if ( argument.starts_with( "--" ) )
+            {
+                throw std::invalid_argument{ "Unknown option '" + argument + "'." };
+            }
+            else
+            {
+                inputPaths.push_back( argument );
+            }
+        }
+
+        if ( pathOfToolchainIndexToQuery.empty() and ( queriedProductId or queriedBelowBuildNumber ) )
+        {
+            throw std::invalid_argument{ "--product and --below-build need --query-toolchains." };
+        }
+
+        if ( not pathOfResultsFile.empty() and not resultFormat )
+        {
+            throw std::invalid_argument{ "--output needs --format jsonl or cbor." };
+        }
+
+        if ( inputPaths.empty() and pathOfToolchainIndexToQuery.empty() )
+        {
+            throw std::invalid_argument{ "At least one file or directory is required." };
+        }
+
+        if (     scanOptions.parseDepth != ParseDepth::Full
+             and (    scanOptions.shouldFindImportReferences or scanOptions.shouldExtractStrings
+                   or not pathOfSignaturesFile.empty() or scanOptions.shouldComputeSimilarityDigests ) )
+        {
+            throw std::invalid_argument{ "--xrefs, --strings, --signatures and --similarity need --depth full." };
+        }
+    }
+    catch ( std::exception const& argumentError )
+    {
+        std::cerr << "ewea-batch: " << argumentError.what() << '\n'
+                  << "Usage: ewea-batch [--profile] [--depth headers|directories|full]\n"
+                  << "                  [--xrefs] [--strings [--min-string-length N]]\n"
+                  << "                  [--signatures SIGNATURES.txt] [--trace TRACE.json] [--watch]\n"
+                  << "                  [--rich] [--headers] [--similarity] [--toolchain-index INDEX]\n"
+                  << "                  [--database CORPUS.db]\n"
+                  << "                  [--format text|jsonl|cbor [--output RESULTS]] [--io threads|io_uring]\n"
+                  << "                  FILE_OR_DIR...\n"
+                  << "       ewea-batch --query-toolchains INDEX [--product ID] [--below-build N]\n";
+        return 1;
+    }
+
+    // Queries answer from the index alone, without reading any artifact.
+    if ( not pathOfToolchainIndexToQuery.empty() )
+    {
+        try
+        {
+            auto indexFile = std::ifstream{ pathOfToolchainIndexToQuery, std::ios::binary };
+            if ( not indexFile.is_open() )
+            {
+                throw std::runtime_error{ "Failed to open '" + pathOfToolchainIndexToQuery + "'." };
+            }
+
+            printToolchainQuery( ToolchainIndex::read( indexFile ), queriedProductId, queriedBelowBuildNumber );
+            return 0;
+        }
+        catch ( std::runtime_error const& indexError )
+        {
+            std::cerr << "ewea-batch: " << indexError.what() << '\n';
+            return 1;
+        }
+    }
+
+    auto compiledSignatures = CompiledSignatures{};
+
+    if ( not pathOfSignaturesFile.empty() )
+    {
+        try
+        {
+            compiledSignatures = compileSignatures( loadSignatures( pathOfSignaturesFile ) );
+            scanOptions.compiledSignatures = &compiledSignatures;
+        }
+        catch ( std::runtime_error const& signaturesError )
+        {
+            std::cerr << "ewea-batch: " << signaturesError.what() << '\n';
+            return 1;
+        }
+    }
+
+    // Structured results never mix with text, so the reports printed after
+    // the scan go to stderr when the results go to stdout.
+    auto* resultsFile = stdout;
+    auto* reportFile = stdout;
+    auto resultWriter = std::optional<ResultWriter>{};
+
+    if ( resultFormat )
+    {
+        if ( not pathOfResultsFile.empty() )
+        {
+            resultsFile = std::fopen( pathOfResultsFile.c_str(), "wb" );
+            if ( resultsFile == nullptr )
+            {
+                std::cerr << "ewea-batch: failed to write '" << pathOfResultsFile << "'.\n";
+                return 1;
+            }
+        }
+        else
+        {
+            reportFile = stderr;
+#ifdef _WIN32
+            _setmode( _fileno( stdout ), _O_BINARY );
+#endif
+        }
+
+        resultWriter.emplace( resultsFile, *resultFormat );
+        summaryOutputs.resultWriter = &*resultWriter;
+
+        // The headers are written from their raw values rather than from
+        // formatted rows.
+        scanOptions.shouldCollectRawHeaders = scanOptions.shouldCollectHeaderFields;
+        scanOptions.shouldCollectHeaderFields = false;
+    }
+
+    Instrumentation::setEnabled( shouldPrintProfile or not pathOfTraceFile.empty() );
+
+    // io_uring unless threads are asked for; a request for io_uring that
+    // cannot be met is reported.
+    auto fileLoader = BatchFileLoader{ requestedFileLoaderBackend.value_or( FileLoaderBackend::IOUring ) };
+    if ( requestedFileLoaderBackend == FileLoaderBackend::IOUring and fileLoader.getBackend() != FileLoaderBackend::IOUring )
+    {
+        std::cerr << "ewea-batch: io_uring is unavailable; reading with threads.\n";
+    }
+
+    auto const artifactPaths = Batch::collectArtifactPaths( inputPaths );
+    auto signatureScanTotals = SignatureScanTotals{};
+
+    auto artifactChangeTracker = ArtifactChangeTracker{};
+    auto directoryWatcher = std::optional<DirectoryWatcher>{};
+
+    if ( shouldWatch )
+    {
+        directoryWatcher.emplace( inputPaths );
+
+        for ( auto const& pathOfArtifact : artifactPaths )
+        {
+            artifactChangeTracker.updateArtifact( pathOfArtifact );
+        }
+    }
+
+    auto toolchainIndex = ToolchainIndex{};
+    if ( not pathOfToolchainIndexToWrite.empty() )
+    {
+        summaryOutputs.toolchainIndex = &toolchainIndex;
+    }
+
+    auto corpusDatabaseBuilder = CorpusDatabaseBuilder{};
+    if ( not pathOfCorpusDatabaseToWrite.empty() )
+    {
+        summaryOutputs.corpusDatabaseBuilder = &corpusDatabaseBuilder;
+    }
+
+    auto const numberOfFailedScans =
+        scanAndPrintArtifacts( artifactPaths, scanOptions, fileLoader, summaryOutputs, signatureScanTotals );
+
+    try
+    {
+        if ( resultWriter )
+        {
+            resultWriter->flush();
+        }
+
+        if ( not pathOfToolchainIndexToWrite.empty() )
+        {
+            auto indexFile = std::ofstream{ pathOfToolchainIndexToWrite, std::ios::binary };
+            toolchainIndex.write( indexFile );
+        }
+
+        if ( not pathOfCorpusDatabaseToWrite.empty() )
+        {
+            auto databaseFile = std::ofstream{ pathOfCorpusDatabaseToWrite, std::ios::binary };
+            corpusDatabaseBuilder.write( databaseFile );
+        }
+    }
+    catch ( std::runtime_error const& writeError )
+    {
+        std::cerr << "ewea-batch: " << writeError.what() << '\n';
+        return 1;
+    }
+
+    // Watching only collects from the initial scan.
+    summaryOutputs.toolchainIndex = nullptr;
+    summaryOutputs.corpusDatabaseBuilder = nullptr;
+
+    if ( shouldWatch )
+    {
+        watchArtifacts( inputPaths, artifactPaths, artifactChangeTracker, *directoryWatcher,
+                        scanOptions, fileLoader, summaryOutputs, signatureScanTotals );
+    }
+
+    if ( scanOptions.compiledSignatures != nullptr )
+    {
+        // The duration is summed over the scans, so the throughput is per
+        // scanning thread rather than for the whole batch.
+        auto const scannedGigabytes = signatureScanTotals.numberOfScannedBytes / 1e9;
+        auto const scanSeconds = signatureScanTotals.durationInNanoseconds / 1e9;
+
+        std::fprintf( reportFile, "\nSignatures: %zu patterns, %llu matches, %.1f MB scanned in %.3f s, %.3f GB/s per thread\n",
+                      compiledSignatures.signatures.size(),
+                      static_cast<unsigned long long>( signatureScanTotals.numberOfMatches ),
+                      scannedGigabytes * 1000, scanSeconds,
+                      scanSeconds > 0 ? scannedGigabytes / scanSeconds : 0.0 );
+    }
+
+    auto const fileProfiles = Instrumentation::getFileProfiles();
+
+    if ( shouldPrintProfile )
+    {
+        for ( auto const& fileProfile : fileProfiles )
+        {
+            std::fprintf( reportFile, "\n%s\n", fileProfile.path.c_str() );
+            printFileProfile( reportFile, fileProfile );
+        }
+
+        printProfileTotals( reportFile, fileProfiles );
+    }
+
+    if ( not pathOfTraceFile.empty() )
+    {
+        auto traceFile = std::ofstream{ pathOfTraceFile };
+
+        if ( not traceFile.is_open() )
+        {
+            std::cerr << "ewea-batch: failed to write '" << pathOfTraceFile << "'.\n";
+            return 1;
+        }
+
+        Instrumentation::writeChromeTrace( traceFile, fileProfiles );
+    }
+
+    return numberOfFailedScans == 0 ? 0 : 2;
+}
\ No newline at end of file
@@ -0,0 +1,462 @@
+
+#include "BatchScanner.h"
+
+#include "ImportReferences.h"
+#include "Instrumentation.h"
+#include "ParallelFor.h"
+#include "PEFiles.h"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <filesystem>
+#include <stdexcept>
+#include <system_error>
+
+namespace
+{
+    std::string
+    getLowercaseExtension( std::string const& pathOfArtifact )
+    {
+        auto extension = std::filesystem::path{ pathOfArtifact }.extension().string();
+        std::transform( extension.begin(), extension.end(), extension.begin(),
+                        []( unsigned char const character )
+                        {
+                            return static_cast<char>( std::tolower( character ) );
+                        } );
+
+        return extension;
+    }
+
+    template <typename ScanFunction>
+    void
+    scanForSignaturesTimed( Batch::ScanSummary& scanSummary,
+                            ScanFunction const& scanForSignatures )
+    {
+        auto const scanStart = std::chrono::steady_clock::now();
+        scanSummary.signatureScanResult = scanForSignatures();
+        scanSummary.signatureScanDurationInNanoseconds =
+            std::chrono::duration_cast<std::chrono::nanoseconds>( std::chrono::steady_clock::now() - scanStart ).count();
+    }
+
+    std::vector<Batch::ImportedFunctionReferences>
+    countImportedFunctionReferences( EXEFile const& loadedEXEFile )
+    {
+        auto const importReferences = findImportReferences( loadedEXEFile );
+        auto importedFunctionReferences = std::vector<Batch::ImportedFunctionReferences>{};
+
+        for ( auto const& [importedDLLName, importedFunctions] : loadedEXEFile.importedDLLToImportedFunctions )
+        {
+            for ( auto const& importedFunction : importedFunctions )
+            {
+                auto referencesOfFunction = Batch::ImportedFunctionReferences
+                {
+                    .importedDLLName = importedDLLName,
+                    .importedFunctionName = importedFunction.name
+                };
+
+                for ( auto const& importReference : getReferencesToIATSlot( importReferences, importedFunction.iatSlotRVA ) )
+                {
+                    switch ( importReference.kind )
+                    {
+                        case ImportReferenceKind::Call:
+                            referencesOfFunction.numberOfCalls++;
+                            break;
+                        case ImportReferenceKind::Jump:
+                            referencesOfFunction.numberOfJumps++;
+                            break;
+                        case ImportReferenceKind::Load:
+                            referencesOfFunction.numberOfLoads++;
+                            break;
+                    }
+                }
+
+                importedFunctionReferences.push_back( std::move( referencesOfFunction ) );
+            }
+        }
+
+        return importedFunctionReferences;
+    }
+
+    void
+    summarizeEXEFile( EXEFile const& loadedEXEFile,
+                      Batch::ScanOptions const& scanOptions,
+                      Batch::ScanSummary& scanSummary )
+    {
+        scanSummary.targetMachineArchitecture = loadedEXEFile.ntFileHeader.targetMachineArchitecture;
+        scanSummary.numberOfSections = loadedEXEFile.sectionHeadersNameToInfo.size();
+        scanSummary.numberOfImportedDLLs = loadedEXEFile.importedDLLToImportedFunctions.size();
+        scanSummary.numberOfExportedFunctions = loadedEXEFile.exportedFunctions.size();
+        scanSummary.richHeader = loadedEXEFile.richHeader;
+
+        for ( auto const& [importedDLLName, importedFunctions] : loadedEXEFile.importedDLLToImportedFunctions )
+        {
+            scanSummary.numberOfImportedFunctions += importedFunctions.size();
+        }
+
+        if ( scanOptions.shouldCollectHeaderFields )
+        {
+            scanSummary.headerFieldGroups.push_back( Batch::HeaderFieldGroup
+                                                     {
+                                                         .name = "file",
+                                                         .fieldRows = PE::getFieldRows( loadedEXEFile.ntFileHeader,
+                                                                                        PE::ntFileHeaderFields )
+                                                     } );
+            scanSummary.headerFieldGroups.push_back( Batch::HeaderFieldGroup
+                                                     {
+                                                         .name = "optional",
+                                                         .fieldRows = PE::getFieldRows( loadedEXEFile.ntOptionalHeader,
+                                                                                        PE::ntOptionalHeader64Fields )
+                                                     } );
+
+            for ( auto const& [sectionName, sectionHeader] : loadedEXEFile.sectionHeadersNameToInfo )
+            {
+                scanSummary.headerFieldGroups.push_back( Batch::HeaderFieldGroup
+                                                         {
+                                                             .name = sectionName,
+                                                             .fieldRows = PE::getFieldRows( sectionHeader,
+                                                                                            PE::sectionHeaderFields )
+                                                         } );
+            }
+        }
+
+        if ( scanOptions.shouldCollectRawHeaders )
+        {
+            scanSummary.ntFileHeader = loadedEXEFile.ntFileHeader;
+            scanSummary.ntOptionalHeader = loadedEXEFile.ntOptionalHeader;
+            scanSummary.sectionHeaders.assign( loadedEXEFile.sectionHeadersNameToInfo.begin(),
+                                               loadedEXEFile.sectionHeadersNameToInfo.end() );
+        }
+
+        if ( not scanOptions.shouldCollectNames )
+        {
+            return;
+        }
+
+        auto& [importedDLLNames, importedFunctionNames, exportedFunctionNames, sectionNames] = scanSummary.names;
+
+        for ( auto const& [importedDLLName, importedFunctions] : loadedEXEFile.importedDLLToImportedFunctions )
+        {
+            importedDLLNames.push_back( importedDLLName );
+
+            for ( auto const& importedFunction : importedFunctions )
+            {
+                importedFunctionNames.push_back( importedFunction.name );
+            }
+        }
+
+        for ( auto const& exportedFunction : loadedEXEFile.exportedFunctions )
+        {
+            exportedFunctionNames.push_back( exportedFunction.name );
+        }
+
+        for ( auto const& [sectionName, sectionHeader] : loadedEXEFile.sectionHeadersNameToInfo )
+        {
+            sectionNames.push_back( sectionName );
+        }
+    }
+
+    void
+    summarizeOBJFile( OBJFile const& loadedOBJFile,
+                      Batch::ScanOptions const& scanOptions,
+                      Batch::ScanSummary& scanSummary )
+    {
+        scanSummary.targetMachineArchitecture = loadedOBJFile.ntFileHeader.targetMachineArchitecture;
+
+        if ( scanOptions.shouldCollectHeaderFields )
+        {
+            scanSummary.headerFieldGroups.push_back( Batch::HeaderFieldGroup
+                                                     {
+                                                         .name = "file",
+                                                         .fieldRows = PE::getFieldRows( loadedOBJFile.ntFileHeader,
+                                                                                        PE::ntFileHeaderFields )
+                                                     } );
+        }
+
+        if ( scanOptions.shouldCollectRawHeaders )
+        {
+            scanSummary.ntFileHeader = loadedOBJFile.ntFileHeader;
+        }
+
+        for ( auto const& [sectionName, sectionHeaders] : loadedOBJFile.sectionHeaders )
+        {
+            scanSummary.numberOfSections += sectionHeaders.size();
+
+            if ( scanOptions.shouldCollectNames )
+            {
+                scanSummary.names[static_cast<std::size_t>( CorpusNameKind::Section )].push_back( sectionName );
+            }
+
+            if ( scanOptions.shouldCollectHeaderFields )
+            {
+                for ( auto const& sectionHeader : sectionHeaders )
+                {
+                    scanSummary.headerFieldGroups.push_back( Batch::HeaderFieldGroup
+                                                             {
+                                                                 .name = sectionName,
+                                                                 .fieldRows = PE::getFieldRows( sectionHeader,
+                                                                                                PE::sectionHeaderFields )
+                                                             } );
+                }
+            }
+
+            if ( scanOptions.shouldCollectRawHeaders )
+            {
+                for ( auto const& sectionHeader : sectionHeaders )
+                {
+                    scanSummary.sectionHeaders.emplace_back( sectionName, sectionHeader );
+                }
+            }
+        }
+    }
+
+    // Reads no more of the file than the parse depth needs.
+    void
+    triageArtifact( std::string const& pathOfArtifact,
+                    Batch::ScanOptions const& scanOptions,
+                    Batch::ScanSummary& scanSummary )
+    {
+        if ( scanSummary.kind == Batch::ArtifactKind::OBJ )
+        {
+            summarizeOBJFile( loadOBJFile( pathOfArtifact ), scanOptions, scanSummary );
+        }
+        else
+        {
+            summarizeEXEFile( loadEXEFile( pathOfArtifact, scanOptions.parseDepth ), scanOptions, scanSummary );
+        }
+    }
+
+    // The part of a scan at ParseDepth::Full, once the file is read.
+    void
+    scanRawBytes( std::span<unsigned char const> const rawBytes,
+                  Batch::ScanOptions const& scanOptions,
+                  Batch::ScanSummary& scanSummary )
+    {
+        scanSummary.fileSizeInBytes = rawBytes.size();
+        auto const rawBytesReader = PE::ByteReader{ rawBytes.data(), rawBytes.size() };
+
+        if ( scanOptions.shouldComputeSimilarityDigests )
+        {
+            scanSummary.similarityDigest = computeSimilarityDigest( rawBytes );
+        }
+
+        if ( scanSummary.kind == Batch::ArtifactKind::OBJ )
+        {
+            auto const loadedOBJFile = parseOBJFile( rawBytesReader );
+            summarizeOBJFile( loadedOBJFile, scanOptions, scanSummary );
+
+            if ( scanOptions.shouldExtractStrings )
+            {
+                scanSummary.extractedStrings = extractStrings( rawBytesReader,
+                                                               getStringScanRegions( loadedOBJFile ),
+                                                               scanOptions.stringExtractionOptions );
+            }
+
+            if ( scanOptions.compiledSignatures != nullptr )
+            {
+                scanForSignaturesTimed( scanSummary,
+                                        [&]()
+                                        {
+                                            return scanForSignatures( *scanOptions.compiledSignatures,
+                                                                      rawBytesReader, loadedOBJFile );
+                                        } );
+            }
+        }
+        else
+        {
+            auto const loadedEXEFile = parseEXEFile( rawBytesReader );
+            summarizeEXEFile( loadedEXEFile, scanOptions, scanSummary );
+
+            if ( scanOptions.shouldFindImportReferences )
+            {
+                scanSummary.importedFunctionReferences = countImportedFunctionReferences( loadedEXEFile );
+            }
+
+            if ( scanOptions.shouldComputeSimilarityDigests )
+            {
+                for ( auto const& [sectionName, sectionRawData] : loadedEXEFile.sectionNameToRawData )
+                {
+                    if ( auto const sectionSimilarityDigest = computeSimilarityDigest( sectionRawData ) )
+                    {
+                        scanSummary.sectionSimilarityDigests.emplace_back( sectionName, *sectionSimilarityDigest );
+                    }
+                }
+            }
+
+            if ( scanOptions.shouldExtractStrings )
+            {
+                scanSummary.extractedStrings = extractStrings( rawBytesReader,
+                                                               getStringScanRegions( loadedEXEFile ),
+                                                               scanOptions.stringExtractionOptions );
+            }
+
+            if ( scanOptions.compiledSignatures != nullptr )
+            {
+                scanForSignaturesTimed( scanSummary,
+                                        [&]()
+                                        {
+                                            return scanForSignatures( *scanOptions.compiledSignatures, loadedEXEFile );
+                                        } );
+            }
+        }
+    }
+
+    Batch::ScanSummary
+    makeScanSummary( std::string const& pathOfArtifact )
+    {
+        return Batch::ScanSummary
+        {
+            .path = pathOfArtifact,
+            .kind = getLowercaseExtension( pathOfArtifact ) == ".obj" ? Batch::ArtifactKind::OBJ : Batch::ArtifactKind::EXE
+        };
+    }
+}
+
+namespace Batch
+{
+    bool
+    isSupportedArtifactPath( std::string const& pathOfArtifact )
+    {
+        auto const extension = getLowercaseExtension( pathOfArtifact );
+
+        return extension == ".exe" or extension == ".dll" or extension == ".obj";
+    }
+
+    std::vector<std::string>
+    collectArtifactPaths( std::vector<std::string> const& inputPaths )
+    {
+        auto artifactPaths = std::vector<std::string>{};
+
+        for ( auto const& inputPath : inputPaths )
+        {
+            if ( not std::filesystem::is_directory( inputPath ) )
+            {
+                artifactPaths.push_back( inputPath );
+                continue;
+            }
+
+            auto const directoryOptions = std::filesystem::directory_options::skip_permission_denied;
+            auto directoryError = std::error_code{};
+
+            for ( auto it = std::filesystem::recursive_directory_iterator{ inputPath, directoryOptions, directoryError };
+                  it != std::filesystem::recursive_directory_iterator{};
+                  it.increment( directoryError ) )
+            {
+                if ( it->is_regular_file( directoryError ) and isSupportedArtifactPath( it->path().string() ) )
+                {
+                    artifactPaths.push_back( it->path().string() );
+                }
+            }
+        }
+
+        std::sort( artifactPaths.begin(), artifactPaths.end() );
+
+        return artifactPaths;
+    }
+
+    ScanSummary
+    scanArtifact( std::string const& pathOfArtifact,
+                  ScanOptions const& scanOptions )
+    {
+        auto scanSummary = makeScanSummary( pathOfArtifact );
+
+        auto const fileProfile = Instrumentation::ScopedFileProfile{ pathOfArtifact };
+
+        try
+        {
+            if ( scanOptions.parseDepth != ParseDepth::Full )
+            {
+                scanSummary.fileSizeInBytes = std::filesystem::file_size( pathOfArtifact );
+                triageArtifact( pathOfArtifact, scanOptions, scanSummary );
+
+                return scanSummary;
+            }
+
+            auto const rawBytes = loadPEFileAsRawBytes( pathOfArtifact );
+            scanRawBytes( rawBytes, scanOptions, scanSummary );
+        }
+        catch ( std::runtime_error const& scanningError )
+        {
+            scanSummary.errorMessage = scanningError.what();
+        }
+
+        return scanSummary;
+    }
+
+    void
+    scanArtifacts( std::span<std::string const> const artifactPaths,
+                   ScanOptions const& scanOptions,
+                   BatchFileLoader& fileLoader,
+                   ScannedArtifactCallback const& onArtifactScanned )
+    {
+        if ( scanOptions.parseDepth != ParseDepth::Full )
+        {
+            parallelFor( artifactPaths.size(),
+                         [&]( std::size_t const artifactIdx )
+                         {
+                             onArtifactScanned( artifactIdx, scanArtifact( artifactPaths[artifactIdx], scanOptions ) );
+                         } );
+            return;
+        }
+
+        fileLoader.loadFiles( artifactPaths,
+                              [&]( std::size_t const artifactIdx, LoadedFile const& loadedFile )
+                              {
+                                  auto const& pathOfArtifact = artifactPaths[artifactIdx];
+                                  auto scanSummary = makeScanSummary( pathOfArtifact );
+                                  scanSummary.errorMessage = loadedFile.errorMessage;
+
+                                  {
+                                      auto const fileProfile = Instrumentation::ScopedFileProfile{ pathOfArtifact };
+
+                                      try
+                                      {
+                                          if ( scanSummary.errorMessage.empty() )
+                                          {
+                                              Instrumentation::addToCounter( Instrumentation::Counter::BytesRead, loadedFile.rawBytes.size() );
+                                              scanRawBytes( loadedFile.rawBytes, scanOptions, scanSummary );
+                                          }
+                                      }
+                                      catch ( std::runtime_error const& scanningError )
+                                      {
+                                          scanSummary.errorMessage = scanningError.what();
+                                      }
+                                  }
+
+                                  onArtifactScanned( artifactIdx, std::move( scanSummary ) );
+                              } );
+    }
+
+    std::string
+    getArtifactKindName( ArtifactKind const artifactKind )
+    {
+        switch ( artifactKind )
+        {
+            case ArtifactKind::EXE:
+                return "EXE";
+            case ArtifactKind::OBJ:
+                return "OBJ";
+            default:
+                return "<Unknown kind>";
+        }
+    }
+
+    ParseDepth
+    getParseDepthFromName( std::string const& parseDepthName )
+    {
+        if ( parseDepthName == "headers" )
+        {
+            return ParseDepth::Headers;
+        }
+        if ( parseDepthName == "directories" )
+        {
+            return ParseDepth::Directories;
+        }
+        if ( parseDepthName == "full" )
+        {
+            return ParseDepth::Full;
+        }
+
+        throw std::invalid_argument{ "Unknown parse depth '" + parseDepthName + "'." };
+    }
+}
\ No newline at end of file
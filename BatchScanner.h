@@ -0,0 +1,130 @@
+
+#ifndef BATCHSCANNER_H
+#define BATCHSCANNER_H
+
+#include "BatchFileLoader.h"
+#include "CorpusDatabase.h"
+#include "PEFieldDescriptors.h"
+#include "PEFiles.h"
+#include "SignatureScanner.h"
+#include "SimilarityDigest.h"
+#include "StringExtraction.h"
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace Batch
+{
+    enum class ArtifactKind
+    {
+        EXE,
+        OBJ
+    };
+
+    struct ScanOptions
+    {
+        // Below Full, files are triaged from their headers alone and the
+        // options needing section contents must be off.
+        ParseDepth                   parseDepth = ParseDepth::Full;
+        bool                         shouldFindImportReferences = false;
+        bool                         shouldExtractStrings = false;
+        bool                         shouldCollectNames = false;
+        bool                         shouldCollectHeaderFields = false;
+        bool                         shouldCollectRawHeaders = false;
+        bool                         shouldComputeSimilarityDigests = false;
+        StringExtractionOptions      stringExtractionOptions;
+
+        // Compiled once for the whole batch and shared by all scans; no
+        // signature scan when null.
+        CompiledSignatures const*    compiledSignatures = nullptr;
+    };
+
+    struct ImportedFunctionReferences
+    {
+        std::string      importedDLLName;
+        std::string      importedFunctionName;
+        std::size_t      numberOfCalls = 0;
+        std::size_t      numberOfJumps = 0;
+        std::size_t      numberOfLoads = 0;
+    };
+
+    // The formatted fields of one header, named "file", "optional" or after
+    // its section.
+    struct HeaderFieldGroup
+    {
+        std::string                  name;
+        std::vector<PE::FieldRow>    fieldRows;
+    };
+
+    struct ScanSummary
+    {
+        std::string      path;
+        ArtifactKind     kind = ArtifactKind::EXE;
+        std::string      errorMessage;
+        std::uint64_t    fileSizeInBytes = 0;
+        std::uint16_t    targetMachineArchitecture = 0;
+        std::size_t      numberOfSections = 0;
+        std::size_t      numberOfImportedDLLs = 0;
+        std::size_t      numberOfImportedFunctions = 0;
+        std::size_t      numberOfExportedFunctions = 0;
+        std::optional<RichHeader>                  richHeader;
+
+        // The names a corpus database records, by CorpusNameKind; empty
+        // unless collected. Imports and exports need at least Directories.
+        std::array<std::vector<std::string>, numberOfCorpusNameKinds>    names;
+        std::vector<HeaderFieldGroup>              headerFieldGroups;
+
+        // The headers as decoded, for writers that format the fields
+        // themselves; empty unless collected. OBJ files have no optional
+        // header.
+        std::optional<PE::NTFileHeader>                             ntFileHeader;
+        std::optional<PE::NTOptionalHeader64>                       ntOptionalHeader;
+        std::vector<std::pair<std::string, PE::SectionHeader>>      sectionHeaders;
+        // The digest of the whole file and, for executables, of each
+        // section that has one; empty unless computed.
+        std::optional<SimilarityDigest>                             similarityDigest;
+        std::vector<std::pair<std::string, SimilarityDigest>>      sectionSimilarityDigests;
+        std::vector<ImportedFunctionReferences>    importedFunctionReferences;
+        ExtractedStrings                           extractedStrings;
+        SignatureScanResult                        signatureScanResult;
+        std::int64_t                               signatureScanDurationInNanoseconds = 0;
+    };
+
+    bool
+    isSupportedArtifactPath( std::string const& pathOfArtifact );
+
+    std::vector<std::string>
+    collectArtifactPaths( std::vector<std::string> const& inputPaths );
+
+    ScanSummary
+    scanArtifact( std::string const& pathOfArtifact,
+                  ScanOptions const& scanOptions = {} );
+
+    using ScannedArtifactCallback = std::function<void( std::size_t const artifactIdx, ScanSummary&& scanSummary )>;
+
+    // Scans the artifacts in parallel, handing each summary to
+    // onArtifactScanned on the thread that scanned it, in no particular
+    // order. At ParseDepth::Full the files are read through the loader;
+    // below it, every scan reads the few ranges it needs itself.
+    void
+    scanArtifacts( std::span<std::string const> const artifactPaths,
+                   ScanOptions const& scanOptions,
+                   BatchFileLoader& fileLoader,
+                   ScannedArtifactCallback const& onArtifactScanned );
+
+    std::string
+    getArtifactKindName( ArtifactKind const artifactKind );
+
+    // Throws std::invalid_argument for names other than "headers",
+    // "directories" and "full".
+    ParseDepth
+    getParseDepthFromName( std::string const& parseDepthName );
+}
+
+#endif // BATCHSCANNER_H
\ No newline at end of file
@@ -0,0 +1,608 @@
+
+#include "BinaryDiff.h"
+
+#include "Instrumentation.h"
+#include "PEFieldDescriptors.h"
+#include "ParallelFor.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdio>
+#include <cstring>
+#include <iterator>
+#include <set>
+#include <tuple>
+#include <utility>
+
+namespace
+{
+    // Chunks average about a kibibyte past the minimum: fine enough to place
+    // a change within a function or two, coarse enough that a 300 MB section
+    // stays at a few hundred thousand chunks.
+    auto const minimumChunkSizeInBytes = std::size_t{ 256 };
+    auto const maximumChunkSizeInBytes = std::size_t{ 8192 };
+    auto const gearHashWindowSizeInBytes = std::size_t{ 64 };
+    auto const chunkBoundaryThreshold = std::uint64_t{ 1 } << 54;
+
+    constexpr std::array<std::uint64_t, 256>
+    makeGearTable()
+    {
+        auto gearTable = std::array<std::uint64_t, 256>{};
+        auto state = std::uint64_t{ 0 };
+
+        // splitmix64, so the table is fixed without being typed out.
+        for ( auto& gearValue : gearTable )
+        {
+            state += 0x9E3779B97F4A7C15;
+            auto mixed = state;
+            mixed = ( mixed ^ ( mixed >> 30 ) ) * 0xBF58476D1CE4E5B9;
+            mixed = ( mixed ^ ( mixed >> 27 ) ) * 0x94D049BB133111EB;
+            gearValue = mixed ^ ( mixed >> 31 );
+        }
+
+        return gearTable;
+    }
+
+    constexpr auto gearTable = makeGearTable();
+
+    std::uint64_t
+    hashChunk( unsigned char const* bytes,
+               std::size_t const sizeInBytes )
+    {
+        auto hash = 0x9E3779B97F4A7C15 ^ sizeInBytes;
+        auto i = std::size_t{ 0 };
+
+        for ( ; i + 8 <= sizeInBytes; i += 8 )
+        {
+            auto word = std::uint64_t{ 0 };
+            std::memcpy( &word, bytes + i, 8 );
+            hash = std::rotl( hash ^ ( word * 0xFF51AFD7ED558CCD ), 29 ) * 0x9E3779B97F4A7C15;
+        }
+
+        if ( i < sizeInBytes )
+        {
+            auto word = std::uint64_t{ 0 };
+            std::memcpy( &word, bytes + i, sizeInBytes - i );
+            hash = std::rotl( hash ^ ( word * 0xFF51AFD7ED558CCD ), 29 ) * 0x9E3779B97F4A7C15;
+        }
+
+        hash ^= hash >> 33;
+        hash *= 0xC4CEB9FE1A85EC53;
+        hash ^= hash >> 33;
+
+        return hash;
+    }
+
+    std::uint64_t
+    getChunkStartOffset( std::vector<ContentChunk> const& chunks,
+                         std::size_t const chunkIdx,
+                         std::uint64_t const sizeInBytes )
+    {
+        return chunkIdx < chunks.size() ? chunks[chunkIdx].offset : sizeInBytes;
+    }
+
+    struct ChunkMatch
+    {
+        std::uint32_t    leftChunkIdx;
+        std::uint32_t    rightChunkIdx;
+    };
+
+    std::vector<std::uint32_t>
+    getChunkIndicesSortedByHash( std::vector<ContentChunk> const& chunks )
+    {
+        auto chunkIndices = std::vector<std::uint32_t>( chunks.size() );
+        for ( auto i = std::uint32_t{ 0 }; i < chunkIndices.size(); i++ )
+        {
+            chunkIndices[i] = i;
+        }
+
+        std::sort( chunkIndices.begin(), chunkIndices.end(),
+                   [&chunks]( std::uint32_t const lhs, std::uint32_t const rhs )
+                   {
+                       return std::tie( chunks[lhs].hash, lhs ) < std::tie( chunks[rhs].hash, rhs );
+                   } );
+
+        return chunkIndices;
+    }
+
+    // Pairs chunks with equal contents. Repeated contents, such as padding,
+    // are paired in order of appearance. The matches are returned ordered by
+    // right chunk.
+    std::vector<ChunkMatch>
+    matchChunks( PE::ByteReader const& leftBytes,
+                 std::vector<ContentChunk> const& leftChunks,
+                 PE::ByteReader const& rightBytes,
+                 std::vector<ContentChunk> const& rightChunks )
+    {
+        auto const leftChunkIndices = getChunkIndicesSortedByHash( leftChunks );
+        auto const rightChunkIndices = getChunkIndicesSortedByHash( rightChunks );
+
+        auto chunkMatches = std::vector<ChunkMatch>{};
+        auto leftIt = leftChunkIndices.begin();
+        auto rightIt = rightChunkIndices.begin();
+
+        while ( leftIt != leftChunkIndices.end() and rightIt != rightChunkIndices.end() )
+        {
+            auto const& leftChunk = leftChunks[*leftIt];
+            auto const& rightChunk = rightChunks[*rightIt];
+
+            if ( leftChunk.hash < rightChunk.hash )
+            {
+                ++leftIt;
+            }
+            else if ( rightChunk.hash < leftChunk.hash )
+            {
+                ++rightIt;
+            }
+            else
+            {
+                if (    leftChunk.sizeInBytes == rightChunk.sizeInBytes
+                     and std::memcmp( leftBytes.data() + leftChunk.offset,
+                                      rightBytes.data() + rightChunk.offset,
+                                      leftChunk.sizeInBytes ) == 0 )
+                {
+                    chunkMatches.push_back( ChunkMatch{ .leftChunkIdx = *leftIt, .rightChunkIdx = *rightIt } );
+                }
+
+                ++leftIt;
+                ++rightIt;
+            }
+        }
+
+        std::sort( chunkMatches.begin(), chunkMatches.end(),
+                   []( ChunkMatch const& lhs, ChunkMatch const& rhs )
+                   {
+                       return lhs.rightChunkIdx < rhs.rightChunkIdx;
+                   } );
+
+        return chunkMatches;
+    }
+
+    // The longest run of matches, ordered by right chunk, whose left chunks
+    // are also in order: these are the chunks that stayed in place.
+    std::vector<ChunkMatch>
+    findInPlaceMatches( std::vector<ChunkMatch> const& chunkMatches )
+    {
+        auto runTailMatchIndices = std::vector<std::size_t>{};
+        auto previousMatchIndices = std::vector<std::size_t>( chunkMatches.size() );
+
+        for ( auto i = std::size_t{ 0 }; i < chunkMatches.size(); i++ )
+        {
+            auto const runLength =
+                std::partition_point( runTailMatchIndices.begin(), runTailMatchIndices.end(),
+                                      [&]( std::size_t const tailMatchIdx )
+                                      {
+                                          return chunkMatches[tailMatchIdx].leftChunkIdx < chunkMatches[i].leftChunkIdx;
+                                      } )
+                - runTailMatchIndices.begin();
+
+            previousMatchIndices[i] = runLength > 0 ? runTailMatchIndices[runLength - 1] : chunkMatches.size();
+
+            if ( static_cast<std::size_t>( runLength ) == runTailMatchIndices.size() )
+            {
+                runTailMatchIndices.push_back( i );
+            }
+            else
+            {
+                runTailMatchIndices[runLength] = i;
+            }
+        }
+
+        auto inPlaceMatches = std::vector<ChunkMatch>( runTailMatchIndices.size() );
+        auto matchIdx = runTailMatchIndices.empty() ? chunkMatches.size() : runTailMatchIndices.back();
+
+        for ( auto it = inPlaceMatches.rbegin(); it != inPlaceMatches.rend(); ++it )
+        {
+            *it = chunkMatches[matchIdx];
+            matchIdx = previousMatchIndices[matchIdx];
+        }
+
+        return inPlaceMatches;
+    }
+
+    std::vector<bool>
+    getMatchedChunks( std::vector<ChunkMatch> const& chunkMatches,
+                      std::size_t const numberOfChunks,
+                      std::uint32_t ChunkMatch::* chunkIdxMember )
+    {
+        auto isMatched = std::vector<bool>( numberOfChunks, false );
+
+        for ( auto const& chunkMatch : chunkMatches )
+        {
+            isMatched[chunkMatch.*chunkIdxMember] = true;
+        }
+
+        return isMatched;
+    }
+
+    // Narrows the region to the bytes that differ by dropping the common
+    // prefix and suffix; chunk boundaries only place a change to within a
+    // chunk or so.
+    ChangedRegion
+    trimChangedRegion( PE::ByteReader const& leftBytes,
+                       PE::ByteReader const& rightBytes,
+                       ChangedRegion changedRegion )
+    {
+        auto const leftData = leftBytes.data() + changedRegion.leftOffset;
+        auto const rightData = rightBytes.data() + changedRegion.rightOffset;
+        auto const commonSizeInBytes = std::min( changedRegion.leftSizeInBytes, changedRegion.rightSizeInBytes );
+
+        auto prefixSizeInBytes = std::uint64_t{ 0 };
+        while ( prefixSizeInBytes < commonSizeInBytes and leftData[prefixSizeInBytes] == rightData[prefixSizeInBytes] )
+        {
+            prefixSizeInBytes++;
+        }
+
+        auto suffixSizeInBytes = std::uint64_t{ 0 };
+        while (     suffixSizeInBytes < commonSizeInBytes - prefixSizeInBytes
+                and leftData[changedRegion.leftSizeInBytes - 1 - suffixSizeInBytes]
+                    == rightData[changedRegion.rightSizeInBytes - 1 - suffixSizeInBytes] )
+        {
+            suffixSizeInBytes++;
+        }
+
+        changedRegion.leftOffset += prefixSizeInBytes;
+        changedRegion.rightOffset += prefixSizeInBytes;
+        changedRegion.leftSizeInBytes -= prefixSizeInBytes + suffixSizeInBytes;
+        changedRegion.rightSizeInBytes -= prefixSizeInBytes + suffixSizeInBytes;
+
+        return changedRegion;
+    }
+
+    void
+    diffSectionContents( PE::ByteReader const& leftBytes,
+                         PE::ByteReader const& rightBytes,
+                         SectionDiff& sectionDiff )
+    {
+        sectionDiff.leftSizeInBytes = leftBytes.size();
+        sectionDiff.rightSizeInBytes = rightBytes.size();
+
+        if (    leftBytes.size() == rightBytes.size()
+             and ( leftBytes.size() == 0 or std::memcmp( leftBytes.data(), rightBytes.data(), leftBytes.size() ) == 0 ) )
+        {
+            sectionDiff.status = SectionDiffStatus::Unchanged;
+            sectionDiff.unchangedSizeInBytes = leftBytes.size();
+            return;
+        }
+
+        sectionDiff.status = SectionDiffStatus::Changed;
+
+        auto const leftChunks = chunkContent( leftBytes );
+        auto const rightChunks = chunkContent( rightBytes );
+        auto const chunkMatches = matchChunks( leftBytes, leftChunks, rightBytes, rightChunks );
+        auto const inPlaceMatches = findInPlaceMatches( chunkMatches );
+
+        for ( auto const& chunkMatch : chunkMatches )
+        {
+            sectionDiff.movedSizeInBytes += rightChunks[chunkMatch.rightChunkIdx].sizeInBytes;
+        }
+        for ( auto const& inPlaceMatch : inPlaceMatches )
+        {
+            auto const inPlaceSizeInBytes = rightChunks[inPlaceMatch.rightChunkIdx].sizeInBytes;
+            sectionDiff.unchangedSizeInBytes += inPlaceSizeInBytes;
+            sectionDiff.movedSizeInBytes -= inPlaceSizeInBytes;
+        }
+
+        auto const isLeftChunkMatched = getMatchedChunks( chunkMatches, leftChunks.size(), &ChunkMatch::leftChunkIdx );
+        auto const isRightChunkMatched = getMatchedChunks( chunkMatches, rightChunks.size(), &ChunkMatch::rightChunkIdx );
+
+        // Every gap between consecutive in-place chunks that holds a chunk
+        // found nowhere in the other section is a changed region; a gap made
+        // only of moved chunks is not.
+        auto gapStart = ChunkMatch{ .leftChunkIdx = 0, .rightChunkIdx = 0 };
+
+        for ( auto i = std::size_t{ 0 }; i <= inPlaceMatches.size(); i++ )
+        {
+            auto const gapEnd = i < inPlaceMatches.size()
+                              ? inPlaceMatches[i]
+                              : ChunkMatch
+                                {
+                                    .leftChunkIdx = static_cast<std::uint32_t>( leftChunks.size() ),
+                                    .rightChunkIdx = static_cast<std::uint32_t>( rightChunks.size() )
+                                };
+
+            auto const hasUnmatchedChunk =
+                   std::find( isLeftChunkMatched.begin() + gapStart.leftChunkIdx,
+                              isLeftChunkMatched.begin() + gapEnd.leftChunkIdx, false )
+                   != isLeftChunkMatched.begin() + gapEnd.leftChunkIdx
+                or std::find( isRightChunkMatched.begin() + gapStart.rightChunkIdx,
+                              isRightChunkMatched.begin() + gapEnd.rightChunkIdx, false )
+                   != isRightChunkMatched.begin() + gapEnd.rightChunkIdx;
+
+            if ( hasUnmatchedChunk )
+            {
+                auto const leftOffset = getChunkStartOffset( leftChunks, gapStart.leftChunkIdx, leftBytes.size() );
+                auto const rightOffset = getChunkStartOffset( rightChunks, gapStart.rightChunkIdx, rightBytes.size() );
+
+                auto const changedRegion = trimChangedRegion(
+                    leftBytes, rightBytes,
+                    ChangedRegion
+                    {
+                        .leftOffset = leftOffset,
+                        .leftSizeInBytes = getChunkStartOffset( leftChunks, gapEnd.leftChunkIdx, leftBytes.size() ) - leftOffset,
+                        .rightOffset = rightOffset,
+                        .rightSizeInBytes = getChunkStartOffset( rightChunks, gapEnd.rightChunkIdx, rightBytes.size() ) - rightOffset
+                    } );
+
+                if ( changedRegion.leftSizeInBytes != 0 or changedRegion.rightSizeInBytes != 0 )
+                {
+                    sectionDiff.changedRegions.push_back( changedRegion );
+                }
+            }
+
+            gapStart = ChunkMatch{ .leftChunkIdx = gapEnd.leftChunkIdx + 1, .rightChunkIdx = gapEnd.rightChunkIdx + 1 };
+        }
+    }
+
+    std::string
+    formatHex( std::uint64_t const value,
+               int const numberOfDigits = 8 )
+    {
+        char formattedValue[24];
+        std::snprintf( formattedValue, sizeof( formattedValue ), "0x%0*llX",
+                       numberOfDigits, static_cast<unsigned long long>( value ) );
+
+        return formattedValue;
+    }
+
+    void
+    addFieldDifference( std::vector<FieldDifference>& fieldDifferences,
+                        std::string const& fieldName,
+                        std::string leftValue,
+                        std::string rightValue )
+    {
+        if ( leftValue != rightValue )
+        {
+            fieldDifferences.push_back( FieldDifference
+                                        {
+                                            .fieldName = fieldName,
+                                            .leftValue = std::move( leftValue ),
+                                            .rightValue = std::move( rightValue )
+                                        } );
+        }
+    }
+
+    // Both rows come from the same field table, so they line up one to one.
+    void
+    addFieldRowDifferences( std::vector<FieldDifference>& fieldDifferences,
+                            std::string const& fieldNamePrefix,
+                            std::vector<PE::FieldRow> const& leftFieldRows,
+                            std::vector<PE::FieldRow> const& rightFieldRows )
+    {
+        for ( auto i = std::size_t{ 0 }; i < leftFieldRows.size(); i++ )
+        {
+            addFieldDifference( fieldDifferences,
+                                fieldNamePrefix + leftFieldRows[i].name,
+                                leftFieldRows[i].value,
+                                rightFieldRows[i].value );
+        }
+    }
+
+    std::vector<FieldDifference>
+    diffHeaders( EXEFile const& leftEXEFile,
+                 EXEFile const& rightEXEFile )
+    {
+        auto headerDifferences = std::vector<FieldDifference>{};
+
+        addFieldRowDifferences( headerDifferences, "",
+                                PE::getFieldRows( leftEXEFile.ntFileHeader, PE::ntFileHeaderFields ),
+                                PE::getFieldRows( rightEXEFile.ntFileHeader, PE::ntFileHeaderFields ) );
+        addFieldRowDifferences( headerDifferences, "",
+                                PE::getFieldRows( leftEXEFile.ntOptionalHeader, PE::ntOptionalHeader64Fields ),
+                                PE::getFieldRows( rightEXEFile.ntOptionalHeader, PE::ntOptionalHeader64Fields ) );
+
+        auto const describeDataDirectory =
+            []( EXEFile const& loadedEXEFile, std::size_t const dataDirectoryIdx )
+            {
+                if ( dataDirectoryIdx >= loadedEXEFile.dataDirectoryEntries.size() )
+                {
+                    return std::string( "-" );
+                }
+
+                auto const& dataDirectoryEntry = loadedEXEFile.dataDirectoryEntries[dataDirectoryIdx];
+                return std::to_string( dataDirectoryEntry.sizeInBytes ) + " bytes @ "
+                       + formatHex( dataDirectoryEntry.dataDirectoryRVA );
+            };
+
+        auto const numberOfDataDirectories =
+            std::max( leftEXEFile.dataDirectoryEntries.size(), rightEXEFile.dataDirectoryEntries.size() );
+
+        for ( auto i = std::size_t{ 0 }; i < numberOfDataDirectories; i++ )
+        {
+            addFieldDifference( headerDifferences,
+                                PE::getImageDataDirectoryDescription( static_cast<std::uint32_t>( i ) ),
+                                describeDataDirectory( leftEXEFile, i ),
+                                describeDataDirectory( rightEXEFile, i ) );
+        }
+
+        for ( auto const& [sectionName, leftSectionHeader] : leftEXEFile.sectionHeadersNameToInfo )
+        {
+            auto const rightSectionHeader = rightEXEFile.sectionHeadersNameToInfo.find( sectionName );
+            if ( rightSectionHeader == rightEXEFile.sectionHeadersNameToInfo.end() )
+            {
+                continue;
+            }
+
+            addFieldRowDifferences( headerDifferences, sectionName + ": ",
+                                    PE::getFieldRows( leftSectionHeader, PE::sectionHeaderFields ),
+                                    PE::getFieldRows( rightSectionHeader->second, PE::sectionHeaderFields ) );
+        }
+
+        return headerDifferences;
+    }
+
+    std::set<std::string>
+    getQualifiedImportNames( EXEFile const& loadedEXEFile )
+    {
+        auto qualifiedImportNames = std::set<std::string>{};
+
+        for ( auto const& [importedDLLName, importedFunctions] : loadedEXEFile.importedDLLToImportedFunctions )
+        {
+            for ( auto const& importedFunction : importedFunctions )
+            {
+                qualifiedImportNames.insert( importedDLLName + "!" + importedFunction.name );
+            }
+        }
+
+        return qualifiedImportNames;
+    }
+
+    std::set<std::string>
+    getExportNames( EXEFile const& loadedEXEFile )
+    {
+        auto exportNames = std::set<std::string>{};
+
+        for ( auto const& exportedFunction : loadedEXEFile.exportedFunctions )
+        {
+            exportNames.insert( exportedFunction.name );
+        }
+
+        return exportNames;
+    }
+
+    std::vector<std::string>
+    getNamesOnlyInFirst( std::set<std::string> const& firstNames,
+                         std::set<std::string> const& secondNames )
+    {
+        auto namesOnlyInFirst = std::vector<std::string>{};
+        std::set_difference( firstNames.begin(), firstNames.end(),
+                             secondNames.begin(), secondNames.end(),
+                             std::back_inserter( namesOnlyInFirst ) );
+
+        return namesOnlyInFirst;
+    }
+
+    PE::ByteReader
+    getSectionRawData( EXEFile const& loadedEXEFile,
+                       std::string const& sectionName )
+    {
+        auto const sectionRawData = loadedEXEFile.sectionNameToRawData.find( sectionName );
+
+        return sectionRawData != loadedEXEFile.sectionNameToRawData.end() ? PE::ByteReader{ sectionRawData->second }
+                                                                          : PE::ByteReader{};
+    }
+}
+
+std::vector<ContentChunk>
+chunkContent( PE::ByteReader const& bytes )
+{
+    auto chunks = std::vector<ContentChunk>{};
+    chunks.reserve( bytes.size() / ( minimumChunkSizeInBytes + 1024 ) + 1 );
+
+    auto const data = bytes.data();
+
+    for ( auto chunkOffset = std::size_t{ 0 }; chunkOffset < bytes.size(); )
+    {
+        auto const remainingSizeInBytes = bytes.size() - chunkOffset;
+        auto chunkSizeInBytes = std::min( remainingSizeInBytes, maximumChunkSizeInBytes );
+
+        if ( remainingSizeInBytes > minimumChunkSizeInBytes )
+        {
+            // Hashing starts one window before the minimum size, so whether a
+            // boundary falls at a position depends on the bytes before it and
+            // not on where the chunk started.
+            auto gearHash = std::uint64_t{ 0 };
+
+            for ( auto i = minimumChunkSizeInBytes - gearHashWindowSizeInBytes; i < chunkSizeInBytes; i++ )
+            {
+                gearHash = ( gearHash << 1 ) + gearTable[data[chunkOffset + i]];
+
+                if ( i + 1 >= minimumChunkSizeInBytes and gearHash < chunkBoundaryThreshold )
+                {
+                    chunkSizeInBytes = i + 1;
+                    break;
+                }
+            }
+        }
+
+        chunks.push_back( ContentChunk
+                          {
+                              .offset = chunkOffset,
+                              .sizeInBytes = static_cast<std::uint32_t>( chunkSizeInBytes ),
+                              .hash = hashChunk( data + chunkOffset, chunkSizeInBytes )
+                          } );
+        chunkOffset += chunkSizeInBytes;
+    }
+
+    return chunks;
+}
+
+BinaryDiff
+diffEXEFiles( EXEFile const& leftEXEFile,
+              EXEFile const& rightEXEFile )
+{
+    auto const diffTimer = Instrumentation::ScopedTimer{ "Diff" };
+
+    auto binaryDiff = BinaryDiff{ .headerDifferences = diffHeaders( leftEXEFile, rightEXEFile ) };
+
+    auto sectionNames = std::set<std::string>{};
+    for ( auto const& [sectionName, sectionHeader] : leftEXEFile.sectionHeadersNameToInfo )
+    {
+        sectionNames.insert( sectionName );
+    }
+    for ( auto const& [sectionName, sectionHeader] : rightEXEFile.sectionHeadersNameToInfo )
+    {
+        sectionNames.insert( sectionName );
+    }
+
+    for ( auto const& sectionName : sectionNames )
+    {
+        auto const isInLeft = leftEXEFile.sectionHeadersNameToInfo.contains( sectionName );
+        auto const isInRight = rightEXEFile.sectionHeadersNameToInfo.contains( sectionName );
+
+        binaryDiff.sectionDiffs.push_back( SectionDiff
+                                           {
+                                               .sectionName = sectionName,
+                                               .status = not isInLeft ? SectionDiffStatus::Added
+                                                       : not isInRight ? SectionDiffStatus::Removed
+                                                       : SectionDiffStatus::Unchanged,
+                                               .leftSizeInBytes = getSectionRawData( leftEXEFile, sectionName ).size(),
+                                               .rightSizeInBytes = getSectionRawData( rightEXEFile, sectionName ).size()
+                                           } );
+    }
+
+    parallelFor( binaryDiff.sectionDiffs.size(),
+                 [&]( std::size_t const sectionDiffIdx )
+                 {
+                     auto& sectionDiff = binaryDiff.sectionDiffs[sectionDiffIdx];
+
+                     if (    sectionDiff.status != SectionDiffStatus::Added
+                          and sectionDiff.status != SectionDiffStatus::Removed )
+                     {
+                         diffSectionContents( getSectionRawData( leftEXEFile, sectionDiff.sectionName ),
+                                              getSectionRawData( rightEXEFile, sectionDiff.sectionName ),
+                                              sectionDiff );
+                     }
+                 } );
+
+    auto const leftImportNames = getQualifiedImportNames( leftEXEFile );
+    auto const rightImportNames = getQualifiedImportNames( rightEXEFile );
+    binaryDiff.addedImports = getNamesOnlyInFirst( rightImportNames, leftImportNames );
+    binaryDiff.removedImports = getNamesOnlyInFirst( leftImportNames, rightImportNames );
+
+    auto const leftExportNames = getExportNames( leftEXEFile );
+    auto const rightExportNames = getExportNames( rightEXEFile );
+    binaryDiff.addedExports = getNamesOnlyInFirst( rightExportNames, leftExportNames );
+    binaryDiff.removedExports = getNamesOnlyInFirst( leftExportNames, rightExportNames );
+
+    return binaryDiff;
+}
+
+std::string
+getSectionDiffStatusName( SectionDiffStatus const sectionDiffStatus )
+{
+    switch ( sectionDiffStatus )
+    {
+        case SectionDiffStatus::Unchanged:
+            return "unchanged";
+        case SectionDiffStatus::Changed:
+            return "changed";
+        case SectionDiffStatus::Added:
+            return "added";
+        case SectionDiffStatus::Removed:
+            return "removed";
+        default:
+            return "<Unknown status>";
+    }
+}
\ No newline at end of file
@@ -0,0 +1,83 @@
+
+#ifndef BINARYDIFF_H
+#define BINARYDIFF_H
+
+#include "PEFiles.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct ContentChunk
+{
+    std::uint64_t    offset;
+    std::uint32_t    sizeInBytes;
+    std::uint64_t    hash;
+};
+
+// Splits the bytes into chunks whose boundaries depend only on the 64 bytes
+// before them (a gear rolling hash), so an insertion or deletion moves the
+// boundaries around it but leaves every other chunk intact.
+std::vector<ContentChunk>
+chunkContent( PE::ByteReader const& bytes );
+
+struct FieldDifference
+{
+    std::string    fieldName;
+    std::string    leftValue;
+    std::string    rightValue;
+};
+
+enum class SectionDiffStatus : std::uint8_t
+{
+    Unchanged,
+    Changed,
+    Added,
+    Removed
+};
+
+// Offsets are relative to the start of the section's raw data.
+struct ChangedRegion
+{
+    std::uint64_t    leftOffset;
+    std::uint64_t    leftSizeInBytes;
+    std::uint64_t    rightOffset;
+    std::uint64_t    rightSizeInBytes;
+};
+
+// Bytes of the right section are unchanged when they are in a chunk also in
+// the left section and in the same order relative to the other unchanged
+// chunks, moved when the chunk is in the left section elsewhere, and changed
+// otherwise.
+struct SectionDiff
+{
+    std::string                   sectionName;
+    SectionDiffStatus             status;
+    std::uint64_t                 leftSizeInBytes = 0;
+    std::uint64_t                 rightSizeInBytes = 0;
+    std::uint64_t                 unchangedSizeInBytes = 0;
+    std::uint64_t                 movedSizeInBytes = 0;
+    std::vector<ChangedRegion>    changedRegions;
+};
+
+struct BinaryDiff
+{
+    std::vector<FieldDifference>    headerDifferences;
+    std::vector<SectionDiff>        sectionDiffs;
+    std::vector<std::string>        addedImports;
+    std::vector<std::string>        removedImports;
+    std::vector<std::string>        addedExports;
+    std::vector<std::string>        removedExports;
+};
+
+// Compares the headers, section headers, imports and exports field by field
+// and the contents of same-named sections chunk by chunk. Sections are
+// compared in parallel.
+BinaryDiff
+diffEXEFiles( EXEFile const& leftEXEFile,
+              EXEFile const& rightEXEFile );
+
+std::string
+getSectionDiffStatusName( SectionDiffStatus const sectionDiffStatus );
+
+#endif // BINARYDIFF_H
\ No newline at end of file
@@ -0,0 +1,169 @@
+
+#include "BinaryDiffViewer.h"
+
+#include "Instrumentation.h"
+
+#include <QFileInfo>
+#include <QHeaderView>
+#include <QListWidget>
+#include <QTableWidget>
+#include <QTreeWidget>
+#include <QVBoxLayout>
+
+#include <utility>
+
+namespace
+{
+    QString
+    formatRegion( std::uint64_t const offset,
+                  std::uint64_t const sizeInBytes )
+    {
+        return QString( "0x%1 (%2 bytes)" ).arg( offset, 8, 16, QChar( '0' ) ).arg( sizeInBytes );
+    }
+
+    void
+    setUpNameChangesList( std::vector<std::string> const& addedNames,
+                          std::vector<std::string> const& removedNames,
+                          QWidget* tabRootWidget )
+    {
+        auto tabMainLayout = new QVBoxLayout( tabRootWidget );
+
+        auto nameChangesList = new QListWidget;
+        tabMainLayout->addWidget( nameChangesList );
+
+        for ( auto const& addedName : addedNames )
+        {
+            nameChangesList->addItem( QString( "+ %1" ).arg( QString::fromStdString( addedName ) ) );
+        }
+        for ( auto const& removedName : removedNames )
+        {
+            nameChangesList->addItem( QString( "- %1" ).arg( QString::fromStdString( removedName ) ) );
+        }
+
+        if ( nameChangesList->count() == 0 )
+        {
+            nameChangesList->addItem( "No differences" );
+        }
+    }
+}
+
+BinaryDiffViewer::BinaryDiffViewer( QString const& pathOfLeftFile,
+                                    QString const& pathOfRightFile,
+                                    BinaryDiff&& binaryDiff,
+                                    QWidget* parentWidget )
+: LazyTabWidget( parentWidget )
+, m_binaryDiff( std::move( binaryDiff ) )
+{
+    setWindowTitle( QString( "%1 vs %2" )
+                        .arg( QFileInfo( pathOfLeftFile ).fileName() )
+                        .arg( QFileInfo( pathOfRightFile ).fileName() ) );
+    setToolTip( QString( "%1\n%2" ).arg( pathOfLeftFile ).arg( pathOfRightFile ) );
+
+    addLazyTab( QString( "Headers (%1)" ).arg( m_binaryDiff.headerDifferences.size() ),
+                [this]( QWidget* tabRootWidget )
+                {
+                    setUpHeadersTab( tabRootWidget );
+                } );
+    addLazyTab( "Sections",
+                [this]( QWidget* tabRootWidget )
+                {
+                    setUpSectionsTab( tabRootWidget );
+                } );
+    addLazyTab( QString( "Imports (+%1 -%2)" )
+                    .arg( m_binaryDiff.addedImports.size() )
+                    .arg( m_binaryDiff.removedImports.size() ),
+                [this]( QWidget* tabRootWidget )
+                {
+                    setUpImportsTab( tabRootWidget );
+                } );
+    addLazyTab( QString( "Exports (+%1 -%2)" )
+                    .arg( m_binaryDiff.addedExports.size() )
+                    .arg( m_binaryDiff.removedExports.size() ),
+                [this]( QWidget* tabRootWidget )
+                {
+                    setUpExportsTab( tabRootWidget );
+                } );
+}
+
+void
+BinaryDiffViewer::setUpHeadersTab( QWidget* headersTabRootWidget )
+{
+    auto const tabTimer = Instrumentation::ScopedTimer{ "Diff Headers tab" };
+
+    auto headersTabMainLayout = new QVBoxLayout( headersTabRootWidget );
+
+    auto const& headerDifferences = m_binaryDiff.headerDifferences;
+
+    auto headerDifferencesTable = new QTableWidget( static_cast<int>( headerDifferences.size() ), 3 );
+    headerDifferencesTable->setHorizontalHeaderLabels( { "Field", "Left", "Right" } );
+    headerDifferencesTable->setEditTriggers( QAbstractItemView::NoEditTriggers );
+    headerDifferencesTable->verticalHeader()->hide();
+    headerDifferencesTable->horizontalHeader()->setStretchLastSection( true );
+    headersTabMainLayout->addWidget( headerDifferencesTable );
+
+    for ( auto row = 0; row < headerDifferencesTable->rowCount(); row++ )
+    {
+        auto const& headerDifference = headerDifferences[row];
+
+        headerDifferencesTable->setItem( row, 0, new QTableWidgetItem( QString::fromStdString( headerDifference.fieldName ) ) );
+        headerDifferencesTable->setItem( row, 1, new QTableWidgetItem( QString::fromStdString( headerDifference.leftValue ) ) );
+        headerDifferencesTable->setItem( row, 2, new QTableWidgetItem( QString::fromStdString( headerDifference.rightValue ) ) );
+    }
+
+    headerDifferencesTable->resizeColumnsToContents();
+}
+
+void
+BinaryDiffViewer::setUpSectionsTab( QWidget* sectionsTabRootWidget )
+{
+    auto const tabTimer = Instrumentation::ScopedTimer{ "Diff Sections tab" };
+
+    auto sectionsTabMainLayout = new QVBoxLayout( sectionsTabRootWidget );
+
+    // Each section is a top-level row; its changed regions are child rows,
+    // so a section with thousands of regions costs nothing until expanded.
+    auto sectionDiffsTree = new QTreeWidget;
+    sectionDiffsTree->setHeaderLabels( { "Section", "Status", "Left", "Right", "Unchanged bytes", "Moved bytes" } );
+    sectionDiffsTree->setUniformRowHeights( true );
+    sectionsTabMainLayout->addWidget( sectionDiffsTree );
+
+    for ( auto const& sectionDiff : m_binaryDiff.sectionDiffs )
+    {
+        auto sectionItem = new QTreeWidgetItem( sectionDiffsTree );
+        sectionItem->setText( 0, QString::fromStdString( sectionDiff.sectionName ) );
+        sectionItem->setText( 1, QString::fromStdString( getSectionDiffStatusName( sectionDiff.status ) ) );
+        sectionItem->setText( 2, QString( "%1 bytes" ).arg( sectionDiff.leftSizeInBytes ) );
+        sectionItem->setText( 3, QString( "%1 bytes" ).arg( sectionDiff.rightSizeInBytes ) );
+        sectionItem->setText( 4, QString::number( sectionDiff.unchangedSizeInBytes ) );
+        sectionItem->setText( 5, QString::number( sectionDiff.movedSizeInBytes ) );
+
+        for ( auto const& changedRegion : sectionDiff.changedRegions )
+        {
+            auto changedRegionItem = new QTreeWidgetItem( sectionItem );
+            changedRegionItem->setText( 1, "changed region" );
+            changedRegionItem->setText( 2, formatRegion( changedRegion.leftOffset, changedRegion.leftSizeInBytes ) );
+            changedRegionItem->setText( 3, formatRegion( changedRegion.rightOffset, changedRegion.rightSizeInBytes ) );
+        }
+    }
+
+    for ( auto column = 0; column < sectionDiffsTree->columnCount(); column++ )
+    {
+        sectionDiffsTree->resizeColumnToContents( column );
+    }
+}
+
+void
+BinaryDiffViewer::setUpImportsTab( QWidget* importsTabRootWidget )
+{
+    auto const tabTimer = Instrumentation::ScopedTimer{ "Diff Imports tab" };
+
+    setUpNameChangesList( m_binaryDiff.addedImports, m_binaryDiff.removedImports, importsTabRootWidget );
+}
+
+void
+BinaryDiffViewer::setUpExportsTab( QWidget* exportsTabRootWidget )
+{
+    auto const tabTimer = Instrumentation::ScopedTimer{ "Diff Exports tab" };
+
+    setUpNameChangesList( m_binaryDiff.addedExports, m_binaryDiff.removedExports, exportsTabRootWidget );
+}
\ No newline at end of file
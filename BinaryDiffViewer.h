@@ -0,0 +1,35 @@
+
+#ifndef BINARYDIFFVIEWER_H
+#define BINARYDIFFVIEWER_H
+
+#include "BinaryDiff.h"
+#include "LazyTabWidget.h"
+
+class BinaryDiffViewer : public LazyTabWidget
+{
+    Q_OBJECT
+
+public:
+    BinaryDiffViewer( QString const& pathOfLeftFile,
+                      QString const& pathOfRightFile,
+                      BinaryDiff&& binaryDiff,
+                      QWidget* parentWidget = nullptr );
+
+private:
+    void
+    setUpHeadersTab( QWidget* tabRootWidget );
+
+    void
+    setUpSectionsTab( QWidget* tabRootWidget );
+
+    void
+    setUpImportsTab( QWidget* tabRootWidget );
+
+    void
+    setUpExportsTab( QWidget* tabRootWidget );
+
+private:
+    BinaryDiff    m_binaryDiff;
+};
+
+#endif // BINARYDIFFVIEWER_H
\ No newline at end of file
@@ -0,0 +1,326 @@
+
+#include "BuildBloat.h"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace
+{
+    bool
+    isObjectFilePath( std::filesystem::path const& path )
+    {
+        auto extension = path.extension().string();
+        std::transform( extension.begin(), extension.end(), extension.begin(),
+                        []( unsigned char const character )
+                        {
+                            return static_cast<char>( std::tolower( character ) );
+                        } );
+
+        return extension == ".obj";
+    }
+
+    std::vector<std::string>
+    collectObjectFilePaths( std::vector<std::string> const& inputPaths )
+    {
+        auto pathsOfObjectFiles = std::vector<std::string>{};
+
+        for ( auto const& inputPath : inputPaths )
+        {
+            if ( not std::filesystem::is_directory( inputPath ) )
+            {
+                pathsOfObjectFiles.push_back( inputPath );
+                continue;
+            }
+
+            for ( auto const& directoryEntry :
+                  std::filesystem::recursive_directory_iterator( inputPath,
+                                                                 std::filesystem::directory_options::skip_permission_denied ) )
+            {
+                if ( directoryEntry.is_regular_file() and isObjectFilePath( directoryEntry.path() ) )
+                {
+                    pathsOfObjectFiles.push_back( directoryEntry.path().string() );
+                }
+            }
+        }
+
+        std::sort( pathsOfObjectFiles.begin(), pathsOfObjectFiles.end() );
+        pathsOfObjectFiles.erase( std::unique( pathsOfObjectFiles.begin(), pathsOfObjectFiles.end() ),
+                                  pathsOfObjectFiles.end() );
+
+        return pathsOfObjectFiles;
+    }
+
+    struct RankedContributor
+    {
+        std::string      name;
+        SectionTotals    totals;
+        std::int64_t     sizeChangeInBytes = 0;
+    };
+
+    // Contributors sorted by raw size, or by how much their raw size changed
+    // when there is a baseline to compare against.
+    void
+    printTopContributors( char const* const title,
+                          std::vector<RankedContributor> rankedContributors,
+                          std::size_t const numberOfContributorsToPrint,
+                          bool const hasBaseline )
+    {
+        std::sort( rankedContributors.begin(), rankedContributors.end(),
+                   [hasBaseline]( RankedContributor const& lhs, RankedContributor const& rhs )
+                   {
+                       if ( hasBaseline and std::llabs( lhs.sizeChangeInBytes ) != std::llabs( rhs.sizeChangeInBytes ) )
+                       {
+                           return std::llabs( lhs.sizeChangeInBytes ) > std::llabs( rhs.sizeChangeInBytes );
+                       }
+
+                       return lhs.totals.sizeOfRawDataInBytes > rhs.totals.sizeOfRawDataInBytes;
+                   } );
+
+        std::printf( "\n%s:\n    %14s %10s %8s %8s%s  %s\n",
+                     title, "raw bytes", "relocs", "comdats", "sections", hasBaseline ? "     change" : "", "name" );
+
+        for ( auto i = std::size_t{ 0 }; i < std::min( numberOfContributorsToPrint, rankedContributors.size() ); i++ )
+        {
+            auto const& rankedContributor = rankedContributors[i];
+
+            std::printf( "    %14llu %10llu %8llu %8llu",
+                         static_cast<unsigned long long>( rankedContributor.totals.sizeOfRawDataInBytes ),
+                         static_cast<unsigned long long>( rankedContributor.totals.numberOfRelocations ),
+                         static_cast<unsigned long long>( rankedContributor.totals.numberOfCOMDATSections ),
+                         static_cast<unsigned long long>( rankedContributor.totals.numberOfSections ) );
+            if ( hasBaseline )
+            {
+                std::printf( " %+11lld", static_cast<long long>( rankedContributor.sizeChangeInBytes ) );
+            }
+
+            std::printf( "  %s\n", rankedContributor.name.c_str() );
+        }
+    }
+
+    std::int64_t
+    getSizeChangeInBytes( SectionTotals const& currentTotals,
+                          SectionTotals const& previousTotals )
+    {
+        return static_cast<std::int64_t>( currentTotals.sizeOfRawDataInBytes ) -
+               static_cast<std::int64_t>( previousTotals.sizeOfRawDataInBytes );
+    }
+
+    // Objects and section names gone since the baseline are listed with
+    // zero totals, so that what shrank the build ranks next to what grew it.
+    void
+    printBloatReport( BloatReport const& bloatReport,
+                      std::optional<BloatReport> const& baselineBloatReport,
+                      std::size_t const numberOfContributorsToPrint )
+    {
+        auto const hasBaseline = baselineBloatReport.has_value();
+
+        auto buildTotals = SectionTotals{};
+        auto sectionContributors = std::vector<RankedContributor>{};
+        auto objectContributors = std::vector<RankedContributor>{};
+
+        auto const sectionNameToTotals = getTotalsBySectionName( bloatReport );
+        auto const baselineSectionNameToTotals =
+            hasBaseline ? getTotalsBySectionName( *baselineBloatReport ) : std::map<std::string, SectionTotals>{};
+
+        for ( auto const& [sectionName, sectionTotals] : sectionNameToTotals )
+        {
+            buildTotals += sectionTotals;
+
+            auto const baselineTotals = baselineSectionNameToTotals.find( sectionName );
+            sectionContributors.push_back( RankedContributor
+                                           {
+                                               .name = sectionName,
+                                               .totals = sectionTotals,
+                                               .sizeChangeInBytes =
+                                                   getSizeChangeInBytes( sectionTotals,
+                                                                         baselineTotals != baselineSectionNameToTotals.end()
+                                                                             ? baselineTotals->second
+                                                                             : SectionTotals{} )
+                                           } );
+        }
+
+        auto baselinePathToTotals = std::map<std::string, SectionTotals>{};
+        if ( hasBaseline )
+        {
+            for ( auto const& [sectionName, baselineTotals] : baselineSectionNameToTotals )
+            {
+                if ( not sectionNameToTotals.contains( sectionName ) )
+                {
+                    sectionContributors.push_back( RankedContributor
+                                                   {
+                                                       .name = sectionName,
+                                                       .sizeChangeInBytes = getSizeChangeInBytes( SectionTotals{}, baselineTotals )
+                                                   } );
+                }
+            }
+
+            for ( auto const& objectContribution : baselineBloatReport->objects )
+            {
+                baselinePathToTotals[objectContribution.path] = getObjectTotals( objectContribution );
+            }
+        }
+
+        auto numberOfFailedObjects = std::size_t{ 0 };
+        for ( auto const& objectContribution : bloatReport.objects )
+        {
+            if ( not objectContribution.errorMessage.empty() )
+            {
+                std::fprintf( stderr, "ewea-bloat: %s: %s\n",
+                              objectContribution.path.c_str(), objectContribution.errorMessage.c_str() );
+                numberOfFailedObjects++;
+                continue;
+            }
+
+            auto const objectTotals = getObjectTotals( objectContribution );
+            auto const baselineTotals = baselinePathToTotals.find( objectContribution.path );
+
+            objectContributors.push_back( RankedContributor
+                                          {
+                                              .name = objectContribution.path,
+                                              .totals = objectTotals,
+                                              .sizeChangeInBytes =
+                                                  getSizeChangeInBytes( objectTotals,
+                                                                        baselineTotals != baselinePathToTotals.end()
+                                                                            ? baselineTotals->second
+                                                                            : SectionTotals{} )
+                                          } );
+
+            if ( baselineTotals != baselinePathToTotals.end() )
+            {
+                baselinePathToTotals.erase( baselineTotals );
+            }
+        }
+
+        for ( auto const& [path, baselineTotals] : baselinePathToTotals )
+        {
+            objectContributors.push_back( RankedContributor
+                                          {
+                                              .name = path + " (removed)",
+                                              .sizeChangeInBytes = getSizeChangeInBytes( SectionTotals{}, baselineTotals )
+                                          } );
+        }
+
+        std::printf( "Objects: %zu, %zu reused from the baseline, %zu failed\n",
+                     bloatReport.objects.size(), bloatReport.numberOfReusedObjects, numberOfFailedObjects );
+        std::printf( "Totals: %llu raw bytes, %llu relocations, %llu COMDAT sections, %llu sections\n",
+                     static_cast<unsigned long long>( buildTotals.sizeOfRawDataInBytes ),
+                     static_cast<unsigned long long>( buildTotals.numberOfRelocations ),
+                     static_cast<unsigned long long>( buildTotals.numberOfCOMDATSections ),
+                     static_cast<unsigned long long>( buildTotals.numberOfSections ) );
+
+        if ( hasBaseline )
+        {
+            auto baselineRawSizeInBytes = std::uint64_t{ 0 };
+            for ( auto const& [sectionName, baselineTotals] : baselineSectionNameToTotals )
+            {
+                baselineRawSizeInBytes += baselineTotals.sizeOfRawDataInBytes;
+            }
+
+            std::printf( "Change since the baseline: %+lld raw bytes\n",
+                         static_cast<long long>( buildTotals.sizeOfRawDataInBytes ) -
+                         static_cast<long long>( baselineRawSizeInBytes ) );
+        }
+
+        printTopContributors( "By section name", std::move( sectionContributors ), numberOfContributorsToPrint, hasBaseline );
+        printTopContributors( "By object", std::move( objectContributors ), numberOfContributorsToPrint, hasBaseline );
+    }
+}
+
+int
+main( int argCount, char** args )
+{
+    auto inputPaths = std::vector<std::string>{};
+    auto numberOfContributorsToPrint = std::size_t{ 20 };
+    auto pathOfBaselineReport = std::string{};
+    auto pathOfReportToSave = std::string{};
+
+    try
+    {
+        for ( auto i = 1; i < argCount; i++ )
+        {
+            auto const argument = std::string( args[i] );
+
+            if ( argument == "--top" and i + 1 < argCount )
+            {
+                numberOfContributorsToPrint = std::stoul( args[++i] );
+            }
+            else if ( argument == "--baseline" and i + 1 < argCount )
+            {
+                pathOfBaselineReport = args[++i];
+            }
+            else if ( argument == "--save" and i + 1 < argCount )
+            {
+                pathOfReportToSave = args[++i];
+            }
+            else if ( argument.starts_with( "--" ) )
+            {
+                throw std::invalid_argument{ "Unknown option '" + argument + "'." };
+            }
+            else
+            {
+                inputPaths.push_back( argument );
+            }
+        }
+
+        if ( inputPaths.empty() )
+        {
+            throw std::invalid_argument{ "At least one object file or directory is required." };
+        }
+    }
+    catch ( std::exception const& argumentError )
+    {
+        std::cerr << "ewea-bloat: " << argumentError.what() << '\n'
+                  << "Usage: ewea-bloat [--top N] [--baseline REPORT.tsv] [--save REPORT.tsv] OBJ_OR_DIR...\n"
+                  << "With a baseline, unchanged objects are taken from it and contributors are ranked by change.\n";
+        return 1;
+    }
+
+    try
+    {
+        auto const reportStart = std::chrono::steady_clock::now();
+
+        auto baselineBloatReport = std::optional<BloatReport>{};
+        if ( not pathOfBaselineReport.empty() )
+        {
+            auto baselineFile = std::ifstream{ pathOfBaselineReport };
+            if ( not baselineFile.is_open() )
+            {
+                throw std::runtime_error{ "Failed to open '" + pathOfBaselineReport + "'." };
+            }
+
+            baselineBloatReport = readBloatReport( baselineFile );
+        }
+
+        auto const bloatReport =
+            buildBloatReport( collectObjectFilePaths( inputPaths ), baselineBloatReport ? &*baselineBloatReport : nullptr );
+
+        if ( not pathOfReportToSave.empty() )
+        {
+            auto reportFile = std::ofstream{ pathOfReportToSave };
+            writeBloatReport( reportFile, bloatReport );
+        }
+
+        auto const reportDuration = std::chrono::duration<double>( std::chrono::steady_clock::now() - reportStart );
+
+        printBloatReport( bloatReport, baselineBloatReport, numberOfContributorsToPrint );
+        std::printf( "\nReported in %.3f s\n", reportDuration.count() );
+    }
+    catch ( std::exception const& reportError )
+    {
+        std::cerr << "ewea-bloat: " << reportError.what() << '\n';
+        return 1;
+    }
+
+    return 0;
+}
\ No newline at end of file
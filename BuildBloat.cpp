@@ -0,0 +1,282 @@
+
+#include "BuildBloat.h"
+
+#include "Instrumentation.h"
+#include "ParallelFor.h"
+#include "PEFiles.h"
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <istream>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+
+namespace
+{
+    auto const sectionIsCOMDAT = std::uint32_t{ 0x00001000 };
+
+    auto const reportHeader = std::string{ "# ewea-bloat report 1" };
+
+    ObjectContribution const*
+    findObjectContribution( BloatReport const& bloatReport,
+                            std::string const& pathOfObjectFile )
+    {
+        auto const objectContribution =
+            std::lower_bound( bloatReport.objects.begin(), bloatReport.objects.end(), pathOfObjectFile,
+                              []( ObjectContribution const& candidate, std::string const& path )
+                              {
+                                  return candidate.path < path;
+                              } );
+
+        if ( objectContribution == bloatReport.objects.end() or objectContribution->path != pathOfObjectFile )
+        {
+            return nullptr;
+        }
+
+        return &*objectContribution;
+    }
+
+    // Takes the previous contribution instead when the object's size and
+    // last write time are unchanged.
+    ObjectContribution
+    loadObjectContribution( std::string const& pathOfObjectFile,
+                            ObjectContribution const* previousObjectContribution,
+                            bool& isReused )
+    {
+        auto objectContribution = ObjectContribution{ .path = pathOfObjectFile };
+
+        try
+        {
+            // Taken before reading, so an object rewritten meanwhile is read
+            // again next time.
+            auto const lastWriteTime = std::filesystem::last_write_time( pathOfObjectFile );
+            objectContribution.lastWriteTimeInNanoseconds =
+                std::chrono::duration_cast<std::chrono::nanoseconds>( lastWriteTime.time_since_epoch() ).count();
+            objectContribution.fileSizeInBytes = std::filesystem::file_size( pathOfObjectFile );
+
+            if (     previousObjectContribution != nullptr
+                 and previousObjectContribution->fileSizeInBytes == objectContribution.fileSizeInBytes
+                 and previousObjectContribution->lastWriteTimeInNanoseconds == objectContribution.lastWriteTimeInNanoseconds )
+            {
+                isReused = true;
+                return *previousObjectContribution;
+            }
+
+            auto const loadedOBJFile = loadOBJFile( pathOfObjectFile );
+
+            for ( auto const& [sectionName, sectionHeaders] : loadedOBJFile.sectionHeaders )
+            {
+                auto& sectionTotals = objectContribution.sectionNameToTotals[sectionName];
+
+                for ( auto const& sectionHeader : sectionHeaders )
+                {
+                    sectionTotals.sizeOfRawDataInBytes += sectionHeader.sizeOfRawDataInBytes;
+                    sectionTotals.numberOfRelocations += sectionHeader.numberOfRelocations;
+                    sectionTotals.numberOfCOMDATSections += ( sectionHeader.sectionCharacteristics & sectionIsCOMDAT ) != 0 ? 1 : 0;
+                    sectionTotals.numberOfSections++;
+                }
+            }
+        }
+        catch ( std::exception const& loadingError )
+        {
+            objectContribution.sectionNameToTotals.clear();
+            objectContribution.errorMessage = loadingError.what();
+        }
+
+        return objectContribution;
+    }
+
+    std::uint64_t
+    parseNumber( std::string const& field )
+    {
+        auto numberEnd = std::size_t{ 0 };
+        auto const number = std::stoull( field, &numberEnd );
+        if ( numberEnd != field.size() )
+        {
+            throw std::invalid_argument{ field };
+        }
+
+        return number;
+    }
+
+    std::vector<std::string>
+    splitFields( std::string const& line )
+    {
+        auto fields = std::vector<std::string>{};
+        auto fieldStream = std::istringstream{ line };
+
+        for ( auto field = std::string{}; std::getline( fieldStream, field, '\t' ); )
+        {
+            fields.push_back( field );
+        }
+
+        return fields;
+    }
+}
+
+SectionTotals&
+SectionTotals::operator+=( SectionTotals const& other )
+{
+    sizeOfRawDataInBytes += other.sizeOfRawDataInBytes;
+    numberOfRelocations += other.numberOfRelocations;
+    numberOfCOMDATSections += other.numberOfCOMDATSections;
+    numberOfSections += other.numberOfSections;
+
+    return *this;
+}
+
+BloatReport
+buildBloatReport( std::vector<std::string> const& pathsOfObjectFiles,
+                  BloatReport const* previousBloatReport )
+{
+    auto const reportTimer = Instrumentation::ScopedTimer{ "Bloat report" };
+
+    auto bloatReport = BloatReport{};
+
+    bloatReport.objects.resize( pathsOfObjectFiles.size() );
+    auto isReused = std::vector<char>( pathsOfObjectFiles.size() );
+
+    parallelFor( pathsOfObjectFiles.size(),
+                 [&]( std::size_t const i )
+                 {
+                     auto isObjectReused = false;
+
+                     bloatReport.objects[i] =
+                         loadObjectContribution( pathsOfObjectFiles[i],
+                                                 previousBloatReport != nullptr
+                                                     ? findObjectContribution( *previousBloatReport, pathsOfObjectFiles[i] )
+                                                     : nullptr,
+                                                 isObjectReused );
+                     isReused[i] = isObjectReused ? 1 : 0;
+                 } );
+
+    bloatReport.numberOfReusedObjects = static_cast<std::size_t>( std::count( isReused.begin(), isReused.end(), 1 ) );
+
+    std::sort( bloatReport.objects.begin(), bloatReport.objects.end(),
+               []( ObjectContribution const& lhs, ObjectContribution const& rhs )
+               {
+                   return lhs.path < rhs.path;
+               } );
+
+    return bloatReport;
+}
+
+SectionTotals
+getObjectTotals( ObjectContribution const& objectContribution )
+{
+    auto objectTotals = SectionTotals{};
+
+    for ( auto const& [sectionName, sectionTotals] : objectContribution.sectionNameToTotals )
+    {
+        objectTotals += sectionTotals;
+    }
+
+    return objectTotals;
+}
+
+std::map<std::string, SectionTotals>
+getTotalsBySectionName( BloatReport const& bloatReport )
+{
+    auto sectionNameToTotals = std::map<std::string, SectionTotals>{};
+
+    for ( auto const& objectContribution : bloatReport.objects )
+    {
+        for ( auto const& [sectionName, sectionTotals] : objectContribution.sectionNameToTotals )
+        {
+            sectionNameToTotals[sectionName] += sectionTotals;
+        }
+    }
+
+    return sectionNameToTotals;
+}
+
+void
+writeBloatReport( std::ostream& reportOutput,
+                  BloatReport const& bloatReport )
+{
+    reportOutput << reportHeader << '\n';
+
+    for ( auto const& objectContribution : bloatReport.objects )
+    {
+        if ( not objectContribution.errorMessage.empty() )
+        {
+            continue;
+        }
+
+        reportOutput << "object\t" << objectContribution.path
+                     << '\t' << objectContribution.fileSizeInBytes
+                     << '\t' << objectContribution.lastWriteTimeInNanoseconds << '\n';
+
+        for ( auto const& [sectionName, sectionTotals] : objectContribution.sectionNameToTotals )
+        {
+            reportOutput << "section\t" << sectionName
+                         << '\t' << sectionTotals.sizeOfRawDataInBytes
+                         << '\t' << sectionTotals.numberOfRelocations
+                         << '\t' << sectionTotals.numberOfCOMDATSections
+                         << '\t' << sectionTotals.numberOfSections << '\n';
+        }
+    }
+
+    if ( not reportOutput )
+    {
+        throw std::runtime_error{ "Failed to write the bloat report." };
+    }
+}
+
+BloatReport
+readBloatReport( std::istream& reportInput )
+{
+    auto line = std::string{};
+    if ( not std::getline( reportInput, line ) or line != reportHeader )
+    {
+        throw std::runtime_error{ "Not a bloat report." };
+    }
+
+    auto bloatReport = BloatReport{};
+
+    for ( auto lineNumber = 2; std::getline( reportInput, line ); lineNumber++ )
+    {
+        auto const fields = splitFields( line );
+
+        try
+        {
+            if ( fields.size() == 4 and fields[0] == "object" )
+            {
+                bloatReport.objects.push_back( ObjectContribution
+                                               {
+                                                   .path = fields[1],
+                                                   .fileSizeInBytes = parseNumber( fields[2] ),
+                                                   .lastWriteTimeInNanoseconds = std::stoll( fields[3] )
+                                               } );
+            }
+            else if ( fields.size() == 6 and fields[0] == "section" and not bloatReport.objects.empty() )
+            {
+                bloatReport.objects.back().sectionNameToTotals[fields[1]] = SectionTotals
+                {
+                    .sizeOfRawDataInBytes = parseNumber( fields[2] ),
+                    .numberOfRelocations = parseNumber( fields[3] ),
+                    .numberOfCOMDATSections = parseNumber( fields[4] ),
+                    .numberOfSections = parseNumber( fields[5] )
+                };
+            }
+            else
+            {
+                throw std::invalid_argument{ line };
+            }
+        }
+        catch ( std::logic_error const& )
+        {
+            throw std::runtime_error{ "Malformed bloat report line " + std::to_string( lineNumber ) + "." };
+        }
+    }
+
+    std::sort( bloatReport.objects.begin(), bloatReport.objects.end(),
+               []( ObjectContribution const& lhs, ObjectContribution const& rhs )
+               {
+                   return lhs.path < rhs.path;
+               } );
+
+    return bloatReport;
+}
\ No newline at end of file
@@ -0,0 +1,66 @@
+
+#ifndef BUILDBLOAT_H
+#define BUILDBLOAT_H
+
+#include <cstdint>
+#include <iosfwd>
+#include <map>
+#include <string>
+#include <vector>
+
+// What a group of sections puts into the link. A section header holding
+// 0xFFFF relocations has more, which only its first relocation records; it
+// is counted as 0xFFFF.
+struct SectionTotals
+{
+    std::uint64_t    sizeOfRawDataInBytes = 0;
+    std::uint64_t    numberOfRelocations = 0;
+    std::uint64_t    numberOfCOMDATSections = 0;
+    std::uint64_t    numberOfSections = 0;
+
+    SectionTotals&
+    operator+=( SectionTotals const& other );
+};
+
+struct ObjectContribution
+{
+    std::string                             path;
+    std::uint64_t                           fileSizeInBytes = 0;
+    std::int64_t                            lastWriteTimeInNanoseconds = 0;
+    std::map<std::string, SectionTotals>    sectionNameToTotals;
+    std::string                             errorMessage;
+};
+
+struct BloatReport
+{
+    // Sorted by path.
+    std::vector<ObjectContribution>    objects;
+    std::size_t                        numberOfReusedObjects = 0;
+};
+
+// Reads the section headers of every object in parallel. Objects whose size
+// and last write time match their entry in the previous report are taken
+// from it without being opened, so a report over a build that recompiled a
+// handful of objects reads only those.
+BloatReport
+buildBloatReport( std::vector<std::string> const& pathsOfObjectFiles,
+                  BloatReport const* previousBloatReport = nullptr );
+
+SectionTotals
+getObjectTotals( ObjectContribution const& objectContribution );
+
+std::map<std::string, SectionTotals>
+getTotalsBySectionName( BloatReport const& bloatReport );
+
+// Reports are tab-separated text, one line per object followed by one line
+// per section name, so they can be kept next to a build and diffed. Objects
+// that failed to load are not written. Throws std::runtime_error when the
+// stream fails or does not hold a report.
+void
+writeBloatReport( std::ostream& reportOutput,
+                  BloatReport const& bloatReport );
+
+BloatReport
+readBloatReport( std::istream& reportInput );
+
+#endif // BUILDBLOAT_H
\ No newline at end of file
@@ -0,0 +1,137 @@
+
+#ifndef BYTEREADER_H
+#define BYTEREADER_H
+
+#include <cstddef>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace PE
+{
+    class ByteReader
+    {
+    public:
+        ByteReader() = default;
+
+        ByteReader( unsigned char const* bytes,
+                    std::size_t const sizeInBytes )
+        : m_bytes( bytes )
+        , m_sizeInBytes( sizeInBytes )
+        {
+        }
+
+        explicit ByteReader( std::vector<unsigned char> const& bytes )
+        : ByteReader( bytes.data(), bytes.size() )
+        {
+        }
+
+        unsigned char const*
+        data() const
+        {
+            return m_bytes;
+        }
+
+        std::size_t
+        size() const
+        {
+            return m_sizeInBytes;
+        }
+
+        bool
+        contains( std::size_t const offset,
+                  std::size_t const sizeInBytes ) const
+        {
+            return offset <= m_sizeInBytes and sizeInBytes <= m_sizeInBytes - offset;
+        }
+
+        template <typename T>
+        std::optional<T>
+        read( std::size_t const offset ) const
+        {
+            static_assert( std::is_trivially_copyable_v<T> );
+
+            if ( not contains( offset, sizeof( T ) ) )
+            {
+                return std::nullopt;
+            }
+
+            auto value = T{};
+            std::memcpy( &value, m_bytes + offset, sizeof( T ) );
+
+            return value;
+        }
+
+        template <typename T>
+        std::optional<std::vector<T>>
+        readArray( std::size_t const offset,
+                   std::size_t const numberOfElements ) const
+        {
+            static_assert( std::is_trivially_copyable_v<T> );
+
+            if (    numberOfElements > m_sizeInBytes / sizeof( T )
+                 or not contains( offset, numberOfElements * sizeof( T ) ) )
+            {
+                return std::nullopt;
+            }
+
+            auto values = std::vector<T>( numberOfElements );
+            if ( numberOfElements != 0 )
+            {
+                std::memcpy( values.data(), m_bytes + offset, numberOfElements * sizeof( T ) );
+            }
+
+            return values;
+        }
+
+        std::optional<std::string>
+        readNullTerminatedString( std::size_t const offset ) const
+        {
+            if ( offset >= m_sizeInBytes )
+            {
+                return std::nullopt;
+            }
+
+            auto const stringStart = reinterpret_cast<char const*>( m_bytes + offset );
+            auto const stringLength = strnlen( stringStart, m_sizeInBytes - offset );
+
+            if ( stringLength == m_sizeInBytes - offset )
+            {
+                return std::nullopt;
+            }
+
+            return std::string( stringStart, stringLength );
+        }
+
+        std::optional<ByteReader>
+        subReader( std::size_t const offset,
+                   std::size_t const sizeInBytes ) const
+        {
+            if ( not contains( offset, sizeInBytes ) )
+            {
+                return std::nullopt;
+            }
+
+            return ByteReader{ m_bytes + offset, sizeInBytes };
+        }
+
+        std::optional<ByteReader>
+        subReader( std::size_t const offset ) const
+        {
+            if ( offset > m_sizeInBytes )
+            {
+                return std::nullopt;
+            }
+
+            return ByteReader{ m_bytes + offset, m_sizeInBytes - offset };
+        }
+
+    private:
+        unsigned char const*    m_bytes = nullptr;
+        std::size_t             m_sizeInBytes = 0;
+    };
+}
+
+#endif // BYTEREADER_H
\ No newline at end of file
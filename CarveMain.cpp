@@ -0,0 +1,152 @@
+
+#include "ImageCarving.h"
+#include "PEFiles.h"
+
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    // Maps the blob read-only where possible, so a dump larger than memory
+    // can be scanned and the page cache is shared with other readers.
+    class MappedBlob
+    {
+    public:
+        explicit MappedBlob( std::string const& pathOfBlob )
+        {
+#ifdef _WIN32
+            m_rawBytes = loadPEFileAsRawBytes( pathOfBlob );
+            m_bytes = PE::ByteReader{ m_rawBytes };
+#else
+            auto const fileDescriptor = open( pathOfBlob.c_str(), O_RDONLY | O_CLOEXEC );
+            struct stat fileStatus = {};
+
+            if ( fileDescriptor < 0 or fstat( fileDescriptor, &fileStatus ) != 0 )
+            {
+                if ( fileDescriptor >= 0 )
+                {
+                    close( fileDescriptor );
+                }
+                throw std::runtime_error{ "Failed to open '" + pathOfBlob + "'." };
+            }
+
+            m_mappingSizeInBytes = static_cast<std::size_t>( fileStatus.st_size );
+            auto const mapping =
+                m_mappingSizeInBytes != 0 ? mmap( nullptr, m_mappingSizeInBytes, PROT_READ, MAP_PRIVATE, fileDescriptor, 0 )
+                                          : nullptr;
+            close( fileDescriptor );
+
+            if ( mapping == MAP_FAILED )
+            {
+                throw std::runtime_error{ "Failed to map '" + pathOfBlob + "'." };
+            }
+
+            if ( mapping != nullptr )
+            {
+                madvise( mapping, m_mappingSizeInBytes, MADV_SEQUENTIAL );
+            }
+
+            m_mapping = mapping;
+            m_bytes = PE::ByteReader{ static_cast<unsigned char const*>( mapping ), m_mappingSizeInBytes };
+#endif
+        }
+
+        ~MappedBlob()
+        {
+#ifndef _WIN32
+            if ( m_mapping != nullptr )
+            {
+                munmap( m_mapping, m_mappingSizeInBytes );
+            }
+#endif
+        }
+
+        MappedBlob( MappedBlob const& ) = delete;
+        MappedBlob& operator=( MappedBlob const& ) = delete;
+
+        PE::ByteReader const&
+        getBytes() const
+        {
+            return m_bytes;
+        }
+
+    private:
+        PE::ByteReader                m_bytes;
+#ifdef _WIN32
+        std::vector<unsigned char>    m_rawBytes;
+#else
+        void*                         m_mapping = nullptr;
+        std::size_t                   m_mappingSizeInBytes = 0;
+#endif
+    };
+
+    char const*
+    getImageFormatName( CarvedImage const& carvedImage )
+    {
+        return carvedImage.optionalHeaderSignature == 0x20B ? "PE32+" : "PE32";
+    }
+}
+
+int
+main( int argCount, char** args )
+{
+    if ( argCount < 2 )
+    {
+        std::cerr << "Usage: ewea-carve BLOB...\n";
+        return 1;
+    }
+
+    auto numberOfFailedBlobs = 0;
+    auto numberOfScannedBytes = std::uint64_t{ 0 };
+    auto numberOfCarvedImages = std::size_t{ 0 };
+    auto const carveStart = std::chrono::steady_clock::now();
+
+    for ( auto i = 1; i < argCount; i++ )
+    {
+        try
+        {
+            auto const mappedBlob = MappedBlob{ args[i] };
+            auto const carvedImages = carveEmbeddedImages( mappedBlob.getBytes() );
+
+            std::printf( "%s\t%zu images\n", args[i], carvedImages.size() );
+
+            for ( auto const& carvedImage : carvedImages )
+            {
+                std::printf( "    0x%010llx\t%llu bytes\tmachine=0x%04x\t%s\tsections=%u%s\n",
+                             static_cast<unsigned long long>( carvedImage.offset ),
+                             static_cast<unsigned long long>( carvedImage.sizeInBytes ),
+                             carvedImage.targetMachineArchitecture,
+                             getImageFormatName( carvedImage ),
+                             carvedImage.numberOfSections,
+                             carvedImage.isTruncated ? "\ttruncated" : "" );
+            }
+
+            numberOfScannedBytes += mappedBlob.getBytes().size();
+            numberOfCarvedImages += carvedImages.size();
+        }
+        catch ( std::runtime_error const& carvingError )
+        {
+            std::cerr << "ewea-carve: " << carvingError.what() << '\n';
+            numberOfFailedBlobs++;
+        }
+    }
+
+    auto const carveSeconds = std::chrono::duration<double>( std::chrono::steady_clock::now() - carveStart ).count();
+
+    std::printf( "\n%zu images in %.1f MB, %.3f s, %.3f GB/s\n",
+                 numberOfCarvedImages, numberOfScannedBytes / 1e6, carveSeconds,
+                 carveSeconds > 0 ? numberOfScannedBytes / 1e9 / carveSeconds : 0.0 );
+
+    return numberOfFailedBlobs == 0 ? 0 : 2;
+}
\ No newline at end of file
@@ -0,0 +1,205 @@
+
+#include "BatchFileLoader.h"
+#include "BatchScanner.h"
+#include "SimilarityIndex.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace
+{
+    // The digest a file is compared by: of the whole file, or of one of its
+    // sections when a section name is given. Files that failed to parse have
+    // none.
+    std::optional<SimilarityDigest>
+    selectSimilarityDigest( Batch::ScanSummary const& scanSummary,
+                            std::string const& sectionName )
+    {
+        if ( not scanSummary.errorMessage.empty() )
+        {
+            return std::nullopt;
+        }
+
+        if ( sectionName.empty() )
+        {
+            return scanSummary.similarityDigest;
+        }
+
+        for ( auto const& [digestedSectionName, sectionSimilarityDigest] : scanSummary.sectionSimilarityDigests )
+        {
+            if ( digestedSectionName == sectionName )
+            {
+                return sectionSimilarityDigest;
+            }
+        }
+
+        return std::nullopt;
+    }
+
+    double
+    getSecondsSince( std::chrono::steady_clock::time_point const start )
+    {
+        return std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count();
+    }
+}
+
+int
+main( int argCount, char** args )
+{
+    auto inputPaths = std::vector<std::string>{};
+    auto maximumDistance = std::uint32_t{ 30 };
+    auto minimumClusterSize = std::size_t{ 2 };
+    auto sectionName = std::string{};
+    auto pathOfQueryFile = std::string{};
+
+    try
+    {
+        for ( auto i = 1; i < argCount; i++ )
+        {
+            auto const argument = std::string( args[i] );
+
+            if ( argument == "--distance" and i + 1 < argCount )
+            {
+                maximumDistance = static_cast<std::uint32_t>( std::stoul( args[++i] ) );
+            }
+            else if ( argument == "--min-size" and i + 1 < argCount )
+            {
+                minimumClusterSize = std::max<std::size_t>( std::stoul( args[++i] ), 1 );
+            }
+            else if ( argument == "--section" and i + 1 < argCount )
+            {
+                sectionName = args[++i];
+            }
+            else if ( argument == "--near" and i + 1 < argCount )
+            {
+                pathOfQueryFile = args[++i];
+            }
+            else if ( argument.starts_with( "--" ) )
+            {
+                throw std::invalid_argument{ "Unknown option '" + argument + "'." };
+            }
+            else
+            {
+                inputPaths.push_back( argument );
+            }
+        }
+
+        if ( inputPaths.empty() )
+        {
+            throw std::invalid_argument{ "At least one file or directory is required." };
+        }
+    }
+    catch ( std::exception const& argumentError )
+    {
+        std::cerr << "ewea-cluster: " << argumentError.what() << '\n'
+                  << "Usage: ewea-cluster [--distance N] [--section NAME] [--min-size N] FILE_OR_DIR...\n"
+                  << "       ewea-cluster [--distance N] [--section NAME] --near FILE FILE_OR_DIR...\n"
+                  << "Groups near duplicate files by the distance between their similarity digests (30 by\n"
+                  << "default), or lists the files near one file, nearest first.\n";
+        return 1;
+    }
+
+    auto const scanOptions = Batch::ScanOptions{ .shouldComputeSimilarityDigests = true };
+
+    auto const scanStart = std::chrono::steady_clock::now();
+    auto const artifactPaths = Batch::collectArtifactPaths( inputPaths );
+
+    // Only the digests are kept, so the scan needs little more memory than
+    // its largest files.
+    auto fileLoader = BatchFileLoader{ FileLoaderBackend::IOUring };
+    auto similarityDigestsOfArtifacts = std::vector<std::optional<SimilarityDigest>>( artifactPaths.size() );
+    Batch::scanArtifacts( artifactPaths, scanOptions, fileLoader,
+                          [&]( std::size_t const artifactIdx, Batch::ScanSummary&& scanSummary )
+                          {
+                              similarityDigestsOfArtifacts[artifactIdx] = selectSimilarityDigest( scanSummary, sectionName );
+                          } );
+
+    auto pathsOfItems = std::vector<std::string const*>{};
+    auto similarityDigests = std::vector<SimilarityDigest>{};
+
+    for ( auto artifactIdx = std::size_t{ 0 }; artifactIdx < artifactPaths.size(); artifactIdx++ )
+    {
+        if ( similarityDigestsOfArtifacts[artifactIdx] )
+        {
+            pathsOfItems.push_back( &artifactPaths[artifactIdx] );
+            similarityDigests.push_back( *similarityDigestsOfArtifacts[artifactIdx] );
+        }
+    }
+
+    auto const scanDuration = getSecondsSince( scanStart );
+
+    auto const indexStart = std::chrono::steady_clock::now();
+    auto const similarityIndex = SimilarityIndex{ similarityDigests };
+    auto const indexDuration = getSecondsSince( indexStart );
+
+    std::fprintf( stderr, "%zu files, %zu digested in %.3f s; indexed in %.3f s\n",
+                  artifactPaths.size(), similarityDigests.size(), scanDuration, indexDuration );
+
+    if ( not pathOfQueryFile.empty() )
+    {
+        auto const queryDigest = selectSimilarityDigest( Batch::scanArtifact( pathOfQueryFile, scanOptions ), sectionName );
+        if ( not queryDigest )
+        {
+            std::cerr << "ewea-cluster: '" << pathOfQueryFile << "' has no similarity digest.\n";
+            return 1;
+        }
+
+        auto const queryStart = std::chrono::steady_clock::now();
+        auto const similarNeighbours = similarityIndex.findNeighbours( *queryDigest, maximumDistance );
+        auto const queryDuration = getSecondsSince( queryStart );
+
+        for ( auto const& similarNeighbour : similarNeighbours )
+        {
+            std::printf( "%u\t%s\n", similarNeighbour.distance, pathsOfItems[similarNeighbour.itemIdx]->c_str() );
+        }
+
+        std::fflush( stdout );
+        std::fprintf( stderr, "%zu neighbours within %u in %.6f s\n", similarNeighbours.size(), maximumDistance, queryDuration );
+        return 0;
+    }
+
+    auto const clusterStart = std::chrono::steady_clock::now();
+    auto const similarityClusters = similarityIndex.clusterItems( maximumDistance );
+    auto const clusterDuration = getSecondsSince( clusterStart );
+
+    auto itemsOfClusters = std::vector<std::vector<std::uint32_t>>( similarityClusters.numberOfClusters );
+    for ( auto itemIdx = std::uint32_t{ 0 }; itemIdx < similarityIndex.getNumberOfItems(); itemIdx++ )
+    {
+        itemsOfClusters[similarityClusters.clusterIndicesOfItems[itemIdx]].push_back( itemIdx );
+    }
+
+    // Largest clusters first; clusters of equal size keep their order.
+    std::stable_sort( itemsOfClusters.begin(), itemsOfClusters.end(),
+                      []( std::vector<std::uint32_t> const& firstCluster, std::vector<std::uint32_t> const& secondCluster )
+                      {
+                          return firstCluster.size() > secondCluster.size();
+                      } );
+
+    auto numberOfPrintedClusters = std::size_t{ 0 };
+    for ( auto const& itemsOfCluster : itemsOfClusters )
+    {
+        if ( itemsOfCluster.size() < minimumClusterSize )
+        {
+            break;
+        }
+
+        std::printf( "cluster %zu\t%zu files\n", numberOfPrintedClusters++, itemsOfCluster.size() );
+        for ( auto const itemIdx : itemsOfCluster )
+        {
+            std::printf( "    %s\n", pathsOfItems[itemIdx]->c_str() );
+        }
+    }
+
+    auto const numberOfItems = static_cast<double>( similarityIndex.getNumberOfItems() );
+    std::fflush( stdout );
+    std::fprintf( stderr, "%u clusters (%zu printed) within %u in %.3f s; %llu comparisons, %.4f%% of all pairs\n",
+                  similarityClusters.numberOfClusters, numberOfPrintedClusters, maximumDistance, clusterDuration,
+                  static_cast<unsigned long long>( similarityClusters.numberOfComparisons ),
+                  numberOfItems < 2 ? 0.0 : 100.0 * static_cast<double>( similarityClusters.numberOfComparisons ) / ( numberOfItems * ( numberOfItems - 1 ) / 2 ) );
+}
\ No newline at end of file
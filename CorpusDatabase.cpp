@@ -0,0 +1,509 @@
+
+#include "CorpusDatabase.h"
+
+#include "PEFiles.h"
+
+#include <algorithm>
+#include <cctype>
+#include <numeric>
+#include <ostream>
+#include <ranges>
+#include <stdexcept>
+
+namespace
+{
+    auto const databaseMagic = std::uint64_t{ 0x3142444341455745 };    // "EWEACDB1"
+
+    std::string
+    toLowercase( std::string_view const text )
+    {
+        auto lowercaseText = std::string( text );
+        std::transform( lowercaseText.begin(), lowercaseText.end(), lowercaseText.begin(),
+                        []( unsigned char const character )
+                        {
+                            return static_cast<char>( std::tolower( character ) );
+                        } );
+
+        return lowercaseText;
+    }
+
+    template <typename T>
+    void
+    writeValue( std::ostream& databaseOutput,
+                T const value )
+    {
+        databaseOutput.write( reinterpret_cast<char const*>( &value ), sizeof( value ) );
+    }
+
+    template <typename T>
+    void
+    writeArray( std::ostream& databaseOutput,
+                std::vector<T> const& values )
+    {
+        writeValue( databaseOutput, static_cast<std::uint64_t>( values.size() ) );
+        databaseOutput.write( reinterpret_cast<char const*>( values.data() ),
+                              static_cast<std::streamsize>( values.size() * sizeof( T ) ) );
+    }
+
+    // Strings are written as one block of characters and the offsets of
+    // the strings in it, plus the end offset.
+    template <typename Strings>
+    void
+    writeStrings( std::ostream& databaseOutput,
+                  Strings const& strings )
+    {
+        auto characters = std::vector<char>{};
+        auto offsets = std::vector<std::uint32_t>{ 0 };
+
+        for ( auto const& string : strings )
+        {
+            characters.insert( characters.end(), string.begin(), string.end() );
+            offsets.push_back( static_cast<std::uint32_t>( characters.size() ) );
+        }
+
+        if ( characters.size() > UINT32_MAX )
+        {
+            throw std::runtime_error{ "Corpus database strings exceed 4 GiB." };
+        }
+
+        writeArray( databaseOutput, characters );
+        writeArray( databaseOutput, offsets );
+    }
+
+    class DatabaseReader
+    {
+    public:
+        explicit DatabaseReader( PE::ByteReader const& databaseBytes )
+        : m_databaseBytes( databaseBytes )
+        {
+        }
+
+        template <typename T>
+        T
+        readValue()
+        {
+            auto const value = m_databaseBytes.read<T>( m_offset );
+            if ( not value )
+            {
+                throw std::runtime_error{ "Corpus database is truncated." };
+            }
+
+            m_offset += sizeof( T );
+
+            return *value;
+        }
+
+        template <typename T>
+        std::vector<T>
+        readArray()
+        {
+            auto const numberOfElements = readValue<std::uint64_t>();
+
+            auto values = m_databaseBytes.readArray<T>( m_offset, numberOfElements );
+            if ( not values )
+            {
+                throw std::runtime_error{ "Corpus database is truncated." };
+            }
+
+            m_offset += numberOfElements * sizeof( T );
+
+            return std::move( *values );
+        }
+
+    private:
+        PE::ByteReader    m_databaseBytes;
+        std::size_t       m_offset = 0;
+    };
+
+    void
+    checkOrThrow( bool const isConsistent )
+    {
+        if ( not isConsistent )
+        {
+            throw std::runtime_error{ "Corpus database is inconsistent." };
+        }
+    }
+
+    // Offsets must start at 0, never decrease and end at the size of what
+    // they index.
+    void
+    checkOffsets( std::vector<std::uint32_t> const& offsets,
+                  std::size_t const numberOfEntries,
+                  std::size_t const sizeOfIndexed )
+    {
+        checkOrThrow(     offsets.size() == numberOfEntries + 1
+                      and offsets.front() == 0
+                      and offsets.back() == sizeOfIndexed
+                      and std::is_sorted( offsets.begin(), offsets.end() ) );
+    }
+
+    void
+    checkIndices( std::vector<std::uint32_t> const& indices,
+                  std::size_t const numberOfIndexed )
+    {
+        checkOrThrow( std::all_of( indices.begin(), indices.end(),
+                                   [numberOfIndexed]( std::uint32_t const idx )
+                                   {
+                                       return idx < numberOfIndexed;
+                                   } ) );
+    }
+}
+
+void
+CorpusDatabaseBuilder::addFile( CorpusFileRecord const& fileRecord )
+{
+    m_paths.push_back( fileRecord.path );
+    m_isObjectFile.push_back( fileRecord.isObjectFile ? 1 : 0 );
+    m_fileSizesInBytes.push_back( fileRecord.fileSizeInBytes );
+    m_targetMachineArchitectures.push_back( fileRecord.targetMachineArchitecture );
+
+    for ( auto kindIdx = std::size_t{ 0 }; kindIdx < numberOfCorpusNameKinds; kindIdx++ )
+    {
+        auto& nameColumnBuilder = m_nameColumnBuilders[kindIdx];
+        auto const firstNameIdOfFile = nameColumnBuilder.fileNameIds.size();
+
+        for ( auto const& name : fileRecord.names[kindIdx] )
+        {
+            auto const [nameAndId, isNewName] =
+                nameColumnBuilder.nameToId.try_emplace( static_cast<CorpusNameKind>( kindIdx ) == CorpusNameKind::ImportedDLL
+                                                            ? toLowercase( name )
+                                                            : name,
+                                                        static_cast<std::uint32_t>( nameColumnBuilder.idToName.size() ) );
+            if ( isNewName )
+            {
+                nameColumnBuilder.idToName.push_back( &nameAndId->first );
+            }
+
+            nameColumnBuilder.fileNameIds.push_back( nameAndId->second );
+        }
+
+        // A name listed twice for one file, such as a function imported
+        // from two DLLs, is kept once.
+        auto const fileNameIds = nameColumnBuilder.fileNameIds.begin() + firstNameIdOfFile;
+        std::sort( fileNameIds, nameColumnBuilder.fileNameIds.end() );
+        nameColumnBuilder.fileNameIds.erase( std::unique( fileNameIds, nameColumnBuilder.fileNameIds.end() ),
+                                             nameColumnBuilder.fileNameIds.end() );
+
+        nameColumnBuilder.fileOffsets.push_back( static_cast<std::uint32_t>( nameColumnBuilder.fileNameIds.size() ) );
+    }
+}
+
+std::size_t
+CorpusDatabaseBuilder::getNumberOfFiles() const
+{
+    return m_paths.size();
+}
+
+void
+CorpusDatabaseBuilder::write( std::ostream& databaseOutput ) const
+{
+    auto const numberOfFiles = static_cast<std::uint32_t>( m_paths.size() );
+
+    writeValue( databaseOutput, databaseMagic );
+    writeValue( databaseOutput, numberOfFiles );
+
+    writeStrings( databaseOutput, m_paths );
+    writeArray( databaseOutput, m_isObjectFile );
+    writeArray( databaseOutput, m_fileSizesInBytes );
+    writeArray( databaseOutput, m_targetMachineArchitectures );
+
+    for ( auto const& nameColumnBuilder : m_nameColumnBuilders )
+    {
+        auto const numberOfNames = nameColumnBuilder.idToName.size();
+
+        // Names are numbered in the order they were first seen; the
+        // dictionary sorts them so that lookups can binary search.
+        auto sortedIdToId = std::vector<std::uint32_t>( numberOfNames );
+        std::iota( sortedIdToId.begin(), sortedIdToId.end(), 0 );
+        std::sort( sortedIdToId.begin(), sortedIdToId.end(),
+                   [&]( std::uint32_t const lhs, std::uint32_t const rhs )
+                   {
+                       return *nameColumnBuilder.idToName[lhs] < *nameColumnBuilder.idToName[rhs];
+                   } );
+
+        auto idToSortedId = std::vector<std::uint32_t>( numberOfNames );
+        auto sortedNames = std::vector<std::string_view>( numberOfNames );
+        for ( auto sortedId = std::uint32_t{ 0 }; sortedId < numberOfNames; sortedId++ )
+        {
+            idToSortedId[sortedIdToId[sortedId]] = sortedId;
+            sortedNames[sortedId] = *nameColumnBuilder.idToName[sortedIdToId[sortedId]];
+        }
+
+        auto fileNameIds = std::vector<std::uint32_t>( nameColumnBuilder.fileNameIds.size() );
+        auto postingOffsets = std::vector<std::uint32_t>( numberOfNames + 1 );
+
+        for ( auto fileIdx = std::uint32_t{ 0 }; fileIdx < numberOfFiles; fileIdx++ )
+        {
+            auto const first = fileNameIds.begin() + nameColumnBuilder.fileOffsets[fileIdx];
+            auto const last = fileNameIds.begin() + nameColumnBuilder.fileOffsets[fileIdx + 1];
+
+            std::transform( nameColumnBuilder.fileNameIds.begin() + nameColumnBuilder.fileOffsets[fileIdx],
+                            nameColumnBuilder.fileNameIds.begin() + nameColumnBuilder.fileOffsets[fileIdx + 1],
+                            first,
+                            [&]( std::uint32_t const id )
+                            {
+                                return idToSortedId[id];
+                            } );
+            std::sort( first, last );
+
+            for ( auto nameId = first; nameId != last; ++nameId )
+            {
+                postingOffsets[*nameId + 1]++;
+            }
+        }
+
+        // The postings are laid out by counting sort: files are visited in
+        // order, so every list comes out ascending.
+        std::partial_sum( postingOffsets.begin(), postingOffsets.end(), postingOffsets.begin() );
+
+        auto postingFileIndices = std::vector<std::uint32_t>( fileNameIds.size() );
+        auto nextPostingIdx = std::vector<std::uint32_t>( postingOffsets.begin(), postingOffsets.end() - 1 );
+
+        for ( auto fileIdx = std::uint32_t{ 0 }; fileIdx < numberOfFiles; fileIdx++ )
+        {
+            for ( auto i = nameColumnBuilder.fileOffsets[fileIdx]; i < nameColumnBuilder.fileOffsets[fileIdx + 1]; i++ )
+            {
+                postingFileIndices[nextPostingIdx[fileNameIds[i]]++] = fileIdx;
+            }
+        }
+
+        writeStrings( databaseOutput, sortedNames );
+        writeArray( databaseOutput, postingOffsets );
+        writeArray( databaseOutput, postingFileIndices );
+        writeArray( databaseOutput, nameColumnBuilder.fileOffsets );
+        writeArray( databaseOutput, fileNameIds );
+    }
+
+    if ( not databaseOutput )
+    {
+        throw std::runtime_error{ "Failed to write the corpus database." };
+    }
+}
+
+CorpusDatabase
+CorpusDatabase::parse( PE::ByteReader const& databaseBytes )
+{
+    auto databaseReader = DatabaseReader{ databaseBytes };
+
+    if ( databaseReader.readValue<std::uint64_t>() != databaseMagic )
+    {
+        throw std::runtime_error{ "Not a corpus database." };
+    }
+
+    auto const readStringColumn = [&databaseReader]()
+    {
+        auto const characters = databaseReader.readArray<char>();
+
+        auto stringColumn = StringColumn
+        {
+            .characters = std::string( characters.begin(), characters.end() ),
+            .offsets = databaseReader.readArray<std::uint32_t>()
+        };
+
+        checkOrThrow( not stringColumn.offsets.empty() );
+        checkOffsets( stringColumn.offsets, stringColumn.offsets.size() - 1, stringColumn.characters.size() );
+
+        return stringColumn;
+    };
+
+    auto corpusDatabase = CorpusDatabase{};
+
+    auto const numberOfFiles = databaseReader.readValue<std::uint32_t>();
+
+    corpusDatabase.m_paths = readStringColumn();
+    corpusDatabase.m_isObjectFile = databaseReader.readArray<std::uint8_t>();
+    corpusDatabase.m_fileSizesInBytes = databaseReader.readArray<std::uint64_t>();
+    corpusDatabase.m_targetMachineArchitectures = databaseReader.readArray<std::uint16_t>();
+
+    checkOrThrow(     corpusDatabase.m_paths.offsets.size() == numberOfFiles + std::size_t{ 1 }
+                  and corpusDatabase.m_isObjectFile.size() == numberOfFiles
+                  and corpusDatabase.m_fileSizesInBytes.size() == numberOfFiles
+                  and corpusDatabase.m_targetMachineArchitectures.size() == numberOfFiles );
+
+    for ( auto& nameColumn : corpusDatabase.m_nameColumns )
+    {
+        nameColumn.dictionary = readStringColumn();
+        nameColumn.postingOffsets = databaseReader.readArray<std::uint32_t>();
+        nameColumn.postingFileIndices = databaseReader.readArray<std::uint32_t>();
+        nameColumn.fileOffsets = databaseReader.readArray<std::uint32_t>();
+        nameColumn.fileNameIds = databaseReader.readArray<std::uint32_t>();
+
+        auto const numberOfNames = nameColumn.dictionary.offsets.size() - 1;
+
+        checkOffsets( nameColumn.postingOffsets, numberOfNames, nameColumn.postingFileIndices.size() );
+        checkOffsets( nameColumn.fileOffsets, numberOfFiles, nameColumn.fileNameIds.size() );
+        checkIndices( nameColumn.postingFileIndices, numberOfFiles );
+        checkIndices( nameColumn.fileNameIds, numberOfNames );
+    }
+
+    // Paths are looked up through a sorted permutation, leaving the files
+    // in the order they were added.
+    corpusDatabase.m_fileIndicesByPath.resize( numberOfFiles );
+    std::iota( corpusDatabase.m_fileIndicesByPath.begin(), corpusDatabase.m_fileIndicesByPath.end(), 0 );
+    std::sort( corpusDatabase.m_fileIndicesByPath.begin(), corpusDatabase.m_fileIndicesByPath.end(),
+               [&corpusDatabase]( std::uint32_t const lhs, std::uint32_t const rhs )
+               {
+                   return corpusDatabase.m_paths.get( lhs ) < corpusDatabase.m_paths.get( rhs );
+               } );
+
+    return corpusDatabase;
+}
+
+CorpusDatabase
+CorpusDatabase::load( std::string const& pathOfDatabase )
+{
+    return parse( PE::ByteReader{ loadPEFileAsRawBytes( pathOfDatabase ) } );
+}
+
+std::uint32_t
+CorpusDatabase::getNumberOfFiles() const
+{
+    return static_cast<std::uint32_t>( m_isObjectFile.size() );
+}
+
+std::string_view
+CorpusDatabase::getPath( std::uint32_t const fileIdx ) const
+{
+    return m_paths.get( fileIdx );
+}
+
+std::optional<std::uint32_t>
+CorpusDatabase::findFile( std::string_view const path ) const
+{
+    auto const fileIdx =
+        std::lower_bound( m_fileIndicesByPath.begin(), m_fileIndicesByPath.end(), path,
+                          [this]( std::uint32_t const candidateFileIdx, std::string_view const pathToFind )
+                          {
+                              return m_paths.get( candidateFileIdx ) < pathToFind;
+                          } );
+
+    if ( fileIdx == m_fileIndicesByPath.end() or m_paths.get( *fileIdx ) != path )
+    {
+        return std::nullopt;
+    }
+
+    return *fileIdx;
+}
+
+bool
+CorpusDatabase::isObjectFile( std::uint32_t const fileIdx ) const
+{
+    return m_isObjectFile[fileIdx] != 0;
+}
+
+std::uint64_t
+CorpusDatabase::getFileSizeInBytes( std::uint32_t const fileIdx ) const
+{
+    return m_fileSizesInBytes[fileIdx];
+}
+
+std::uint16_t
+CorpusDatabase::getTargetMachineArchitecture( std::uint32_t const fileIdx ) const
+{
+    return m_targetMachineArchitectures[fileIdx];
+}
+
+std::uint32_t
+CorpusDatabase::getNumberOfNames( CorpusNameKind const nameKind ) const
+{
+    return static_cast<std::uint32_t>( m_nameColumns[static_cast<std::size_t>( nameKind )].dictionary.offsets.size() - 1 );
+}
+
+std::string_view
+CorpusDatabase::getName( CorpusNameKind const nameKind,
+                         std::uint32_t const nameId ) const
+{
+    return m_nameColumns[static_cast<std::size_t>( nameKind )].dictionary.get( nameId );
+}
+
+std::optional<std::uint32_t>
+CorpusDatabase::findName( CorpusNameKind const nameKind,
+                          std::string_view const name ) const
+{
+    auto const lowercaseName = nameKind == CorpusNameKind::ImportedDLL ? toLowercase( name ) : std::string( name );
+
+    auto const [firstNameId, lastNameId] = findNamesWithPrefix( nameKind, lowercaseName );
+    if ( firstNameId == lastNameId or getName( nameKind, firstNameId ) != lowercaseName )
+    {
+        return std::nullopt;
+    }
+
+    return firstNameId;
+}
+
+std::pair<std::uint32_t, std::uint32_t>
+CorpusDatabase::findNamesWithPrefix( CorpusNameKind const nameKind,
+                                     std::string_view const prefix ) const
+{
+    auto const lowercasePrefix = nameKind == CorpusNameKind::ImportedDLL ? toLowercase( prefix ) : std::string( prefix );
+
+    // The IDs order the dictionary, so both ends of the range are binary
+    // searches over them.
+    auto const isBeforePrefix = [&]( std::uint32_t const nameId )
+    {
+        return getName( nameKind, nameId ) < lowercasePrefix;
+    };
+    auto const hasPrefix = [&]( std::uint32_t const nameId )
+    {
+        return getName( nameKind, nameId ).starts_with( lowercasePrefix );
+    };
+
+    auto const nameIds = std::views::iota( std::uint32_t{ 0 }, getNumberOfNames( nameKind ) );
+
+    auto const firstNameId = std::ranges::partition_point( nameIds, isBeforePrefix );
+    auto const lastNameId = std::ranges::partition_point( std::ranges::subrange( firstNameId, nameIds.end() ), hasPrefix );
+
+    return { *firstNameId, *lastNameId };
+}
+
+std::span<std::uint32_t const>
+CorpusDatabase::getFilesWithName( CorpusNameKind const nameKind,
+                                  std::uint32_t const nameId ) const
+{
+    auto const& nameColumn = m_nameColumns[static_cast<std::size_t>( nameKind )];
+
+    return std::span( nameColumn.postingFileIndices ).subspan( nameColumn.postingOffsets[nameId],
+                                                               nameColumn.postingOffsets[nameId + 1] - nameColumn.postingOffsets[nameId] );
+}
+
+std::span<std::uint32_t const>
+CorpusDatabase::getNamesOfFile( CorpusNameKind const nameKind,
+                                std::uint32_t const fileIdx ) const
+{
+    auto const& nameColumn = m_nameColumns[static_cast<std::size_t>( nameKind )];
+
+    return std::span( nameColumn.fileNameIds ).subspan( nameColumn.fileOffsets[fileIdx],
+                                                        nameColumn.fileOffsets[fileIdx + 1] - nameColumn.fileOffsets[fileIdx] );
+}
+
+CorpusNameKind
+getCorpusNameKindFromName( std::string const& nameKindName )
+{
+    for ( auto kindIdx = std::size_t{ 0 }; kindIdx < numberOfCorpusNameKinds; kindIdx++ )
+    {
+        if ( getCorpusNameKindName( static_cast<CorpusNameKind>( kindIdx ) ) == nameKindName )
+        {
+            return static_cast<CorpusNameKind>( kindIdx );
+        }
+    }
+
+    throw std::invalid_argument{ "Unknown name kind '" + nameKindName + "'." };
+}
+
+std::string
+getCorpusNameKindName( CorpusNameKind const nameKind )
+{
+    switch ( nameKind )
+    {
+        case CorpusNameKind::ImportedDLL:
+            return "dll";
+        case CorpusNameKind::ImportedFunction:
+            return "import";
+        case CorpusNameKind::ExportedFunction:
+            return "export";
+        case CorpusNameKind::Section:
+            return "section";
+        default:
+            return "<Unknown name kind>";
+    }
+}
\ No newline at end of file
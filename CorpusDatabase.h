@@ -0,0 +1,169 @@
+
+#ifndef CORPUSDATABASE_H
+#define CORPUSDATABASE_H
+
+#include "ByteReader.h"
+
+#include <array>
+#include <cstdint>
+#include <iosfwd>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// The names recorded for every file of a corpus, each kind in a column of
+// its own.
+enum class CorpusNameKind : std::uint8_t
+{
+    ImportedDLL,
+    ImportedFunction,
+    ExportedFunction,
+    Section
+};
+
+inline constexpr auto numberOfCorpusNameKinds = std::size_t{ 4 };
+
+struct CorpusFileRecord
+{
+    std::string                                                       path;
+    bool                                                              isObjectFile = false;
+    std::uint64_t                                                     fileSizeInBytes = 0;
+    std::uint16_t                                                     targetMachineArchitecture = 0;
+    std::array<std::vector<std::string>, numberOfCorpusNameKinds>    names;
+};
+
+// Collects file records one at a time and writes them as a corpus database.
+// Only the per-file name IDs and one copy of every distinct name are held in
+// memory, so a corpus of any size costs little more than its dictionaries.
+class CorpusDatabaseBuilder
+{
+public:
+    void
+    addFile( CorpusFileRecord const& fileRecord );
+
+    std::size_t
+    getNumberOfFiles() const;
+
+    // Throws std::runtime_error when the stream fails.
+    void
+    write( std::ostream& databaseOutput ) const;
+
+private:
+    struct NameColumnBuilder
+    {
+        std::unordered_map<std::string, std::uint32_t>    nameToId;
+        std::vector<std::string const*>                   idToName;
+        std::vector<std::uint32_t>                        fileOffsets{ 0 };
+        std::vector<std::uint32_t>                        fileNameIds;
+    };
+
+private:
+    std::vector<std::string>                                 m_paths;
+    std::vector<std::uint8_t>                                m_isObjectFile;
+    std::vector<std::uint64_t>                               m_fileSizesInBytes;
+    std::vector<std::uint16_t>                               m_targetMachineArchitectures;
+    std::array<NameColumnBuilder, numberOfCorpusNameKinds>   m_nameColumnBuilders;
+};
+
+// A corpus database read back into memory. Every name kind is a dictionary
+// of the distinct names sorted bytewise, the name IDs of each file, and for
+// each name the ascending indices of the files having it, so lookups either
+// way are a binary search and a slice. DLL names are stored lowercase.
+class CorpusDatabase
+{
+public:
+    // Throws std::runtime_error when the bytes are not a corpus database or
+    // are inconsistent.
+    static CorpusDatabase
+    parse( PE::ByteReader const& databaseBytes );
+
+    static CorpusDatabase
+    load( std::string const& pathOfDatabase );
+
+    std::uint32_t
+    getNumberOfFiles() const;
+
+    // Files are indexed in the order they were added.
+    std::string_view
+    getPath( std::uint32_t const fileIdx ) const;
+
+    std::optional<std::uint32_t>
+    findFile( std::string_view const path ) const;
+
+    bool
+    isObjectFile( std::uint32_t const fileIdx ) const;
+
+    std::uint64_t
+    getFileSizeInBytes( std::uint32_t const fileIdx ) const;
+
+    std::uint16_t
+    getTargetMachineArchitecture( std::uint32_t const fileIdx ) const;
+
+    std::uint32_t
+    getNumberOfNames( CorpusNameKind const nameKind ) const;
+
+    std::string_view
+    getName( CorpusNameKind const nameKind,
+             std::uint32_t const nameId ) const;
+
+    std::optional<std::uint32_t>
+    findName( CorpusNameKind const nameKind,
+              std::string_view const name ) const;
+
+    // The half-open range of IDs of the names starting with the prefix.
+    std::pair<std::uint32_t, std::uint32_t>
+    findNamesWithPrefix( CorpusNameKind const nameKind,
+                         std::string_view const prefix ) const;
+
+    std::span<std::uint32_t const>
+    getFilesWithName( CorpusNameKind const nameKind,
+                      std::uint32_t const nameId ) const;
+
+    std::span<std::uint32_t const>
+    getNamesOfFile( CorpusNameKind const nameKind,
+                    std::uint32_t const fileIdx ) const;
+
+private:
+    struct StringColumn
+    {
+        std::string                   characters;
+        std::vector<std::uint32_t>    offsets;
+
+        std::string_view
+        get( std::uint32_t const idx ) const
+        {
+            return std::string_view( characters ).substr( offsets[idx], offsets[idx + 1] - offsets[idx] );
+        }
+    };
+
+    struct NameColumn
+    {
+        StringColumn                  dictionary;
+        std::vector<std::uint32_t>    postingOffsets;
+        std::vector<std::uint32_t>    postingFileIndices;
+        std::vector<std::uint32_t>    fileOffsets;
+        std::vector<std::uint32_t>    fileNameIds;
+    };
+
+private:
+    StringColumn                                  m_paths;
+    std::vector<std::uint32_t>                    m_fileIndicesByPath;
+    std::vector<std::uint8_t>                     m_isObjectFile;
+    std::vector<std::uint64_t>                    m_fileSizesInBytes;
+    std::vector<std::uint16_t>                    m_targetMachineArchitectures;
+    std::array<NameColumn, numberOfCorpusNameKinds>    m_nameColumns;
+};
+
+// Throws std::invalid_argument for names other than "dll", "import",
+// "export" and "section".
+CorpusNameKind
+getCorpusNameKindFromName( std::string const& nameKindName );
+
+std::string
+getCorpusNameKindName( CorpusNameKind const nameKind );
+
+#endif // CORPUSDATABASE_H
\ No newline at end of file
@@ -0,0 +1,142 @@
+
+#include "DiagnosticsPanel.h"
+
+#include "Instrumentation.h"
+
+#include <QCheckBox>
+#include <QFileDialog>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QMessageBox>
+#include <QPushButton>
+#include <QTreeWidget>
+#include <QVBoxLayout>
+
+#include <algorithm>
+#include <fstream>
+#include <vector>
+
+namespace
+{
+    QString
+    getMillisecondsAsString( std::int64_t const durationInNanoseconds )
+    {
+        return QString::number( durationInNanoseconds / 1'000'000.0, 'f', 3 );
+    }
+}
+
+DiagnosticsPanel::DiagnosticsPanel( QWidget* parentWidget )
+: QWidget( parentWidget )
+{
+    auto diagnosticsMainLayout = new QVBoxLayout( this );
+
+    auto collectTimingsCheckBox = new QCheckBox( "Collect timings" );
+    collectTimingsCheckBox->setChecked( Instrumentation::isEnabled() );
+    diagnosticsMainLayout->addWidget( collectTimingsCheckBox );
+
+    connect( collectTimingsCheckBox, &QCheckBox::toggled,
+             []( bool const isChecked )
+             {
+                Instrumentation::setEnabled( isChecked );
+             } );
+
+    m_fileProfilesViewer = new QTreeWidget;
+    m_fileProfilesViewer->setColumnCount( 2 );
+    m_fileProfilesViewer->setHeaderLabels( { "Stage", "Value" } );
+    m_fileProfilesViewer->header()->setSectionResizeMode( 0, QHeaderView::Stretch );
+    diagnosticsMainLayout->addWidget( m_fileProfilesViewer );
+
+    auto buttonsLayout = new QHBoxLayout;
+    diagnosticsMainLayout->addLayout( buttonsLayout );
+
+    auto refreshButton = new QPushButton( "Refresh" );
+    buttonsLayout->addWidget( refreshButton );
+    connect( refreshButton, &QPushButton::clicked,
+             [this]()
+             {
+                refreshFileProfiles();
+             } );
+
+    auto clearButton = new QPushButton( "Clear" );
+    buttonsLayout->addWidget( clearButton );
+    connect( clearButton, &QPushButton::clicked,
+             [this]()
+             {
+                Instrumentation::clearFileProfiles();
+                refreshFileProfiles();
+             } );
+
+    auto exportButton = new QPushButton( "Export Chrome trace..." );
+    buttonsLayout->addWidget( exportButton );
+    connect( exportButton, &QPushButton::clicked,
+             [this]()
+             {
+                exportChromeTrace();
+             } );
+}
+
+void
+DiagnosticsPanel::refreshFileProfiles()
+{
+    m_fileProfilesViewer->clear();
+
+    for ( auto const& fileProfile : Instrumentation::getFileProfiles() )
+    {
+        auto fileItem = new QTreeWidgetItem( m_fileProfilesViewer );
+        fileItem->setText( 0, QString::fromStdString( fileProfile.path ) );
+        fileItem->setText( 1, getMillisecondsAsString( fileProfile.durationInNanoseconds ) + " ms" );
+        fileItem->setToolTip( 0, QString::fromStdString( fileProfile.path ) );
+
+        // Scopes are recorded when they end, so a parent always follows its
+        // children; walking backwards lets every scope find its parent on the stack.
+        auto parentItems = std::vector<QTreeWidgetItem*>{ fileItem };
+
+        for ( auto it = fileProfile.timedScopes.rbegin(); it != fileProfile.timedScopes.rend(); ++it )
+        {
+            parentItems.resize( std::min<std::size_t>( parentItems.size(), it->nestingDepth + 1 ) );
+
+            auto scopeItem = new QTreeWidgetItem;
+            scopeItem->setText( 0, QString::fromUtf8( it->name ) );
+            scopeItem->setText( 1, getMillisecondsAsString( it->durationInNanoseconds ) + " ms" );
+
+            parentItems.back()->insertChild( 0, scopeItem );
+            parentItems.push_back( scopeItem );
+        }
+
+        for ( auto i = 0; i < Instrumentation::numberOfCounters; i++ )
+        {
+            auto counterItem = new QTreeWidgetItem( fileItem );
+            counterItem->setText( 0, QString::fromStdString( Instrumentation::getCounterName( static_cast<Instrumentation::Counter>( i ) ) ) );
+            counterItem->setText( 1, QString::number( fileProfile.counters[i] ) );
+        }
+    }
+
+    m_fileProfilesViewer->expandToDepth( 0 );
+}
+
+void
+DiagnosticsPanel::exportChromeTrace()
+{
+    auto const pathOfTraceFile =
+        QFileDialog::getSaveFileName( this,
+                                      "Export Chrome trace",
+                                      "ewea-trace.json",
+                                      "Chrome trace (*.json)" );
+
+    if ( pathOfTraceFile.isEmpty() )
+    {
+        return;
+    }
+
+    auto traceFile = std::ofstream{ pathOfTraceFile.toStdString() };
+
+    if ( not traceFile.is_open() )
+    {
+        QMessageBox::warning( this,
+                              "Failed to export trace",
+                              QString( "'%1' could not be written." ).arg( pathOfTraceFile ) );
+        return;
+    }
+
+    Instrumentation::writeChromeTrace( traceFile, Instrumentation::getFileProfiles() );
+}
\ No newline at end of file
@@ -0,0 +1,28 @@
+
+#ifndef DIAGNOSTICSPANEL_H
+#define DIAGNOSTICSPANEL_H
+
+#include <QPointer>
+#include <QWidget>
+
+class QTreeWidget;
+
+class DiagnosticsPanel : public QWidget
+{
+    Q_OBJECT
+
+public:
+    DiagnosticsPanel( QWidget* parentWidget = nullptr );
+
+    void
+    refreshFileProfiles();
+
+private:
+    void
+    exportChromeTrace();
+
+private:
+    QPointer<QTreeWidget>    m_fileProfilesViewer;
+};
+
+#endif // DIAGNOSTICSPANEL_H
\ No newline at end of file
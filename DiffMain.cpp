@@ -0,0 +1,108 @@
+
+#include "BinaryDiff.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace
+{
+    void
+    printNames( char const* const marker,
+                std::vector<std::string> const& names )
+    {
+        for ( auto const& name : names )
+        {
+            std::printf( "    %s %s\n", marker, name.c_str() );
+        }
+    }
+
+    void
+    printBinaryDiff( BinaryDiff const& binaryDiff )
+    {
+        std::printf( "Headers: %zu differences\n", binaryDiff.headerDifferences.size() );
+        for ( auto const& headerDifference : binaryDiff.headerDifferences )
+        {
+            std::printf( "    %s\t%s\t%s\n",
+                         headerDifference.fieldName.c_str(),
+                         headerDifference.leftValue.c_str(),
+                         headerDifference.rightValue.c_str() );
+        }
+
+        std::printf( "Sections:\n" );
+        for ( auto const& sectionDiff : binaryDiff.sectionDiffs )
+        {
+            std::printf( "    %-8s %-9s %llu -> %llu bytes, %llu unchanged, %llu moved, %zu changed regions\n",
+                         sectionDiff.sectionName.c_str(),
+                         getSectionDiffStatusName( sectionDiff.status ).c_str(),
+                         static_cast<unsigned long long>( sectionDiff.leftSizeInBytes ),
+                         static_cast<unsigned long long>( sectionDiff.rightSizeInBytes ),
+                         static_cast<unsigned long long>( sectionDiff.unchangedSizeInBytes ),
+                         static_cast<unsigned long long>( sectionDiff.movedSizeInBytes ),
+                         sectionDiff.changedRegions.size() );
+
+            for ( auto const& changedRegion : sectionDiff.changedRegions )
+            {
+                std::printf( "        0x%08llx+%llu -> 0x%08llx+%llu\n",
+                             static_cast<unsigned long long>( changedRegion.leftOffset ),
+                             static_cast<unsigned long long>( changedRegion.leftSizeInBytes ),
+                             static_cast<unsigned long long>( changedRegion.rightOffset ),
+                             static_cast<unsigned long long>( changedRegion.rightSizeInBytes ) );
+            }
+        }
+
+        std::printf( "Imports: %zu added, %zu removed\n",
+                     binaryDiff.addedImports.size(), binaryDiff.removedImports.size() );
+        printNames( "+", binaryDiff.addedImports );
+        printNames( "-", binaryDiff.removedImports );
+
+        std::printf( "Exports: %zu added, %zu removed\n",
+                     binaryDiff.addedExports.size(), binaryDiff.removedExports.size() );
+        printNames( "+", binaryDiff.addedExports );
+        printNames( "-", binaryDiff.removedExports );
+    }
+}
+
+int
+main( int argCount, char** args )
+{
+    if ( argCount != 3 )
+    {
+        std::cerr << "Usage: ewea-diff LEFT.exe RIGHT.exe\n";
+        return 1;
+    }
+
+    try
+    {
+        auto const leftEXEFile = loadEXEFile( args[1] );
+        auto const rightEXEFile = loadEXEFile( args[2] );
+
+        auto const diffStart = std::chrono::steady_clock::now();
+        auto const binaryDiff = diffEXEFiles( leftEXEFile, rightEXEFile );
+        auto const diffDuration = std::chrono::duration<double>( std::chrono::steady_clock::now() - diffStart );
+
+        printBinaryDiff( binaryDiff );
+        std::printf( "\nDiffed in %.3f s\n", diffDuration.count() );
+
+        auto const isIdentical =
+               binaryDiff.headerDifferences.empty()
+            and binaryDiff.addedImports.empty() and binaryDiff.removedImports.empty()
+            and binaryDiff.addedExports.empty() and binaryDiff.removedExports.empty()
+            and std::all_of( binaryDiff.sectionDiffs.begin(), binaryDiff.sectionDiffs.end(),
+                             []( SectionDiff const& sectionDiff )
+                             {
+                                 return sectionDiff.status == SectionDiffStatus::Unchanged;
+                             } );
+
+        return isIdentical ? 0 : 2;
+    }
+    catch ( std::runtime_error const& loadError )
+    {
+        std::cerr << "ewea-diff: " << loadError.what() << '\n';
+        return 1;
+    }
+}
\ No newline at end of file
@@ -1,20 +1,91 @@
 
 #include "EWEAMainWindow.h"
+#include "BinaryDiffViewer.h"
+#include "DiagnosticsPanel.h"
 #include "EXEViewer.h"
+#include "ImageAnalysis.h"
 #include "OBJViewer.h"
+#include "Instrumentation.h"
 #include "PEFiles.h"
 
+#include <QApplication>
+#include <QDir>
+#include <QDirIterator>
+#include <QDockWidget>
 #include <QDragEnterEvent>
+#include <QFileDialog>
+#include <QFileInfo>
+#include <QFileSystemWatcher>
 #include <QHBoxLayout>
+#include <QInputDialog>
+#include <QLabel>
 #include <QListWidget>
 #include <QMenu>
+#include <QMenuBar>
 #include <QMessageBox>
 #include <QMimeData>
 #include <QSplitter>
 #include <QStackedWidget>
+#include <QStatusBar>
+#include <QTableWidget>
+#include <QTime>
+#include <QTimer>
 
+#include <memory>
+#include <stdexcept>
 #include <utility>
 
+namespace
+{
+    // Qt does not report heap usage, so viewers are charged a flat cost per
+    // widget and per item view entry on top of the parsed file they own.
+    auto const estimatedBytesPerWidget = std::uint64_t{ 2048 };
+    auto const estimatedBytesPerItem = std::uint64_t{ 256 };
+
+    // A link rewrites its outputs in several steps and a build links many
+    // outputs in a row; changes are handled once this long has passed
+    // without another.
+    auto const watchCoalescingDelayInMilliseconds = 300;
+
+    // A viewer's analysis stops as soon as the viewer is discarded, rather
+    // than once Qt gets around to deleting it.
+    void
+    discardArtifactViewer( QTabWidget* artifactViewer )
+    {
+        if ( auto const exeViewer = qobject_cast<EXEViewer*>( artifactViewer ) )
+        {
+            exeViewer->cancelRemainingAnalysisStages();
+        }
+
+        artifactViewer->deleteLater();
+    }
+
+    bool
+    isArtifactPath( QString const& pathOfFile )
+    {
+        return pathOfFile.endsWith( ".exe" ) or pathOfFile.endsWith( ".dll" ) or pathOfFile.endsWith( ".obj" );
+    }
+
+    std::uint64_t
+    getEstimatedViewerMemoryUsageInBytes( QTabWidget const* artifactViewer )
+    {
+        auto memoryUsageInBytes =
+            artifactViewer->findChildren<QWidget*>().size() * estimatedBytesPerWidget;
+
+        for ( auto const listViewer : artifactViewer->findChildren<QListWidget*>() )
+        {
+            memoryUsageInBytes += listViewer->count() * estimatedBytesPerItem;
+        }
+
+        for ( auto const tableViewer : artifactViewer->findChildren<QTableWidget*>() )
+        {
+            memoryUsageInBytes += std::uint64_t( tableViewer->rowCount() ) * tableViewer->columnCount() * estimatedBytesPerItem;
+        }
+
+        return memoryUsageInBytes;
+    }
+}
+
 EWEAMainWindow::EWEAMainWindow( QWidget* parentWidget )
 : QMainWindow( parentWidget )
 {
@@ -33,6 +104,10 @@ EWEAMainWindow::EWEAMainWindow( QWidget* parentWidget )
 
     topLevelSplitter->setStretchFactor( 1, 1 );
 
+    setUpDiagnosticsPanel();
+    setUpMemoryBudgetWidgets();
+    setUpWatchMode();
+
     setAcceptDrops( true );
 
     setWindowTitle( "EWEA" );
@@ -54,41 +129,255 @@ EWEAMainWindow::dropEvent( QDropEvent* dropEvent )
 {
     if ( dropEvent->mimeData()->hasUrls() )
     {
+        auto pathsOfArtifacts = QStringList{};
+
         for ( const auto& fileURL : dropEvent->mimeData()->urls() )
         {
-            auto pathOfExecutableFile = fileURL.toLocalFile();
+            pathsOfArtifacts.append( fileURL.toLocalFile() );
+        }
+
+        loadArtifacts( pathsOfArtifacts );
+    }
+}
+
+void
+EWEAMainWindow::loadArtifacts( QStringList const& pathsOfArtifacts )
+{
+    for ( auto const& pathOfExecutableFile : pathsOfArtifacts )
+    {
+        if ( not isArtifactPath( pathOfExecutableFile ) )
+        {
+            continue;
+        }
+
+        if ( m_artifactPathToLoadedArtifact.contains( pathOfExecutableFile.toStdString() ) )
+        {
+            continue;
+        }
+
+        auto loadedArtifact = LoadedArtifact{};
+
+        try
+        {
+            loadArtifactViewer( pathOfExecutableFile, loadedArtifact );
+        }
+        catch ( std::runtime_error const& loadingError )
+        {
+            QMessageBox::warning( this,
+                                  "Failed to load file",
+                                  QString( "'%1' could not be loaded: %2" )
+                                      .arg( pathOfExecutableFile )
+                                      .arg( QString::fromUtf8( loadingError.what() ) ) );
+            continue;
+        }
+
+        auto newListItem = new QListWidgetItem( pathOfExecutableFile );
+        newListItem->setToolTip( QString( "%1\n%2" ).arg( pathOfExecutableFile ).arg( getHeadersSummary( loadedArtifact ) ) );
+
+        m_artifactPathToLoadedArtifact[pathOfExecutableFile.toStdString()] = std::move( loadedArtifact );
+        m_loadedFilesList->addItem( newListItem );
+
+        watchArtifact( pathOfExecutableFile.toStdString() );
+
+        // Evicting as the files come in keeps a large drop within the budget
+        // the whole time, not just once all of it is loaded.
+        evictLeastRecentlyViewedArtifacts();
+    }
+
+    if ( Instrumentation::isEnabled() )
+    {
+        m_diagnosticsPanel->refreshFileProfiles();
+    }
+}
+
+void
+EWEAMainWindow::loadArtifactViewer( QString const& pathOfArtifact,
+                                    LoadedArtifact& loadedArtifact )
+{
+    auto const fileProfile = Instrumentation::ScopedFileProfile{ pathOfArtifact.toStdString() };
 
-            if ( not pathOfExecutableFile.endsWith( ".exe" ) and
-                 not pathOfExecutableFile.endsWith( ".dll" ) and
-                 not pathOfExecutableFile.endsWith( ".obj" ) )
+    auto artifactViewer = static_cast<QTabWidget*>( nullptr );
+    auto estimatedMemoryUsageInBytes = std::uint64_t{ 0 };
+
+    if ( pathOfArtifact.endsWith( ".obj" ) )
+    {
+        auto loadedOBJFile = loadOBJFile( pathOfArtifact.toStdString() );
+        estimatedMemoryUsageInBytes = getEstimatedMemoryUsageInBytes( loadedOBJFile );
+        loadedArtifact.objHeaders = loadedOBJFile;
+        artifactViewer = new OBJViewer( pathOfArtifact, std::move( loadedOBJFile ) );
+    }
+    else
+    {
+        // Only the headers are parsed here; the viewer runs the other stages
+        // in the background, so the section data is counted ahead of time.
+        auto imageAnalysis = std::make_shared<ImageAnalysis>( pathOfArtifact.toStdString() );
+        estimatedMemoryUsageInBytes = getEstimatedMemoryUsageInBytes( imageAnalysis->getEXEFile() );
+        for ( auto const& [sectionName, sectionHeader] : imageAnalysis->getEXEFile().sectionHeadersNameToInfo )
+        {
+            estimatedMemoryUsageInBytes += sectionHeader.sizeOfRawDataInBytes;
+        }
+
+        loadedArtifact.exeHeaders = imageAnalysis->getEXEFile();
+
+        artifactViewer = new EXEViewer( pathOfArtifact, std::move( imageAnalysis ) );
+    }
+
+    m_artifactViewersStack->addWidget( artifactViewer );
+
+    loadedArtifact.viewer = artifactViewer;
+    loadedArtifact.fileSizeInBytes = QFileInfo( pathOfArtifact ).size();
+    loadedArtifact.estimatedFileMemoryUsageInBytes = estimatedMemoryUsageInBytes;
+    loadedArtifact.lastViewedTick = ++m_lastViewedTick;
+}
+
+void
+EWEAMainWindow::showArtifact( std::string const& pathOfArtifact )
+{
+    if ( not m_artifactPathToLoadedArtifact.contains( pathOfArtifact ) )
+    {
+        return;
+    }
+
+    auto& loadedArtifact = m_artifactPathToLoadedArtifact.at( pathOfArtifact );
+
+    if ( loadedArtifact.viewer.isNull() )
+    {
+        try
+        {
+            loadArtifactViewer( QString::fromStdString( pathOfArtifact ), loadedArtifact );
+        }
+        catch ( std::runtime_error const& loadingError )
+        {
+            QMessageBox::warning( this,
+                                  "Failed to reload file",
+                                  QString( "'%1' could not be reloaded: %2" )
+                                      .arg( QString::fromStdString( pathOfArtifact ) )
+                                      .arg( QString::fromUtf8( loadingError.what() ) ) );
+            return;
+        }
+
+        for ( auto listItem : m_loadedFilesList->findItems( QString::fromStdString( pathOfArtifact ), Qt::MatchExactly ) )
+        {
+            listItem->setForeground( QBrush{} );
+            listItem->setToolTip( QString( "%1\n%2" ).arg( listItem->text() ).arg( getHeadersSummary( loadedArtifact ) ) );
+        }
+    }
+
+    loadedArtifact.lastViewedTick = ++m_lastViewedTick;
+    m_artifactViewersStack->setCurrentWidget( loadedArtifact.viewer );
+
+    evictLeastRecentlyViewedArtifacts();
+}
+
+QString
+EWEAMainWindow::getHeadersSummary( LoadedArtifact const& loadedArtifact )
+{
+    auto const ntFileHeader = loadedArtifact.exeHeaders ? loadedArtifact.exeHeaders->ntFileHeader
+                                                        : loadedArtifact.objHeaders->ntFileHeader;
+
+    auto sectionNames = QStringList{};
+    if ( loadedArtifact.exeHeaders )
+    {
+        for ( auto const& [sectionName, sectionHeader] : loadedArtifact.exeHeaders->sectionHeadersNameToInfo )
+        {
+            sectionNames.append( QString::fromStdString( sectionName ) );
+        }
+    }
+    else
+    {
+        for ( auto const& [sectionName, sectionHeaders] : loadedArtifact.objHeaders->sectionHeaders )
+        {
+            sectionNames.append( QString::fromStdString( sectionName ) );
+        }
+    }
+
+    auto headersSummary = QString( "Machine 0x%1, timestamp 0x%2" )
+                              .arg( ntFileHeader.targetMachineArchitecture, 4, 16, QChar( '0' ) )
+                              .arg( ntFileHeader.timestamp, 8, 16, QChar( '0' ) );
+
+    if ( loadedArtifact.exeHeaders )
+    {
+        headersSummary += QString( ", image size 0x%1" ).arg( loadedArtifact.exeHeaders->ntOptionalHeader.sizeOfImageInBytes, 0, 16 );
+    }
+
+    return headersSummary + QString( "\n%1 sections: %2" ).arg( ntFileHeader.numberOfSections ).arg( sectionNames.join( ' ' ) );
+}
+
+void
+EWEAMainWindow::evictLeastRecentlyViewedArtifacts()
+{
+    auto residentMemoryUsageInBytes = std::uint64_t{ 0 };
+
+    // Viewers build their tabs on first use, so their share is re-measured here
+    // rather than fixed when the file was loaded.
+    for ( auto& [pathOfArtifact, loadedArtifact] : m_artifactPathToLoadedArtifact )
+    {
+        if ( not loadedArtifact.viewer.isNull() )
+        {
+            loadedArtifact.estimatedViewerMemoryUsageInBytes =
+                getEstimatedViewerMemoryUsageInBytes( loadedArtifact.viewer );
+            residentMemoryUsageInBytes += loadedArtifact.estimatedFileMemoryUsageInBytes +
+                                          loadedArtifact.estimatedViewerMemoryUsageInBytes;
+        }
+    }
+
+    while ( residentMemoryUsageInBytes > m_memoryBudgetInBytes )
+    {
+        auto leastRecentlyViewedArtifact = m_artifactPathToLoadedArtifact.end();
+
+        for ( auto it = m_artifactPathToLoadedArtifact.begin(); it != m_artifactPathToLoadedArtifact.end(); ++it )
+        {
+            auto const& loadedArtifact = it->second;
+
+            // The visible viewer is never evicted, even if it alone exceeds the budget.
+            if (    loadedArtifact.viewer.isNull()
+                 or loadedArtifact.viewer.data() == m_artifactViewersStack->currentWidget() )
             {
                 continue;
             }
 
-            auto newListItem = new QListWidgetItem( pathOfExecutableFile );
-            newListItem->setToolTip( pathOfExecutableFile );
-
-            if ( pathOfExecutableFile.endsWith( ".exe" ) or
-                 pathOfExecutableFile.endsWith( ".dll" ) )
+            if (    leastRecentlyViewedArtifact == m_artifactPathToLoadedArtifact.end()
+                 or loadedArtifact.lastViewedTick < leastRecentlyViewedArtifact->second.lastViewedTick )
             {
-                auto loadedEXEFile = loadEXEFile( pathOfExecutableFile.toStdString() );
-                auto artifactViewer = new EXEViewer( std::move( loadedEXEFile ) );
-
-                m_artifactViewersStack->addWidget( artifactViewer );
-                m_artifactPathToViewerMap[pathOfExecutableFile.toStdString()] = artifactViewer;
+                leastRecentlyViewedArtifact = it;
             }
-            else if ( pathOfExecutableFile.endsWith( ".obj" ) )
-            {
-                auto loadedOBJFile = loadOBJFile( pathOfExecutableFile.toStdString() );
-                auto artifactViewer = new OBJViewer( std::move( loadedOBJFile ) );
+        }
 
-                m_artifactViewersStack->addWidget( artifactViewer );
-                m_artifactPathToViewerMap[pathOfExecutableFile.toStdString()] = artifactViewer;
-            }
+        if ( leastRecentlyViewedArtifact == m_artifactPathToLoadedArtifact.end() )
+        {
+            break;
+        }
 
-            m_loadedFilesList->addItem( newListItem );
+        auto& [pathOfArtifact, loadedArtifact] = *leastRecentlyViewedArtifact;
+
+        residentMemoryUsageInBytes -= loadedArtifact.estimatedFileMemoryUsageInBytes +
+                                      loadedArtifact.estimatedViewerMemoryUsageInBytes;
+
+        m_artifactViewersStack->removeWidget( loadedArtifact.viewer );
+        discardArtifactViewer( loadedArtifact.viewer );
+        loadedArtifact.viewer = nullptr;
+
+        for ( auto listItem : m_loadedFilesList->findItems( QString::fromStdString( pathOfArtifact ), Qt::MatchExactly ) )
+        {
+            listItem->setForeground( palette().brush( QPalette::Disabled, QPalette::Text ) );
+            listItem->setToolTip( QString( "%1\n%2\nUnloaded to stay within the memory budget (%3 KiB on disk); activate to reload." )
+                                      .arg( listItem->text() )
+                                      .arg( getHeadersSummary( loadedArtifact ) )
+                                      .arg( loadedArtifact.fileSizeInBytes / 1024 ) );
         }
     }
+
+    updateMemoryUsageLabel( residentMemoryUsageInBytes );
+}
+
+void
+EWEAMainWindow::updateMemoryUsageLabel( std::uint64_t const residentMemoryUsageInBytes )
+{
+    auto const bytesPerMebibyte = 1024.0 * 1024.0;
+
+    m_memoryUsageLabel->setText( QString( "Viewers: %1 MiB of %2 MiB" )
+                                     .arg( residentMemoryUsageInBytes / bytesPerMebibyte, 0, 'f', 1 )
+                                     .arg( m_memoryBudgetInBytes / bytesPerMebibyte, 0, 'f', 0 ) );
 }
 
 void
@@ -101,12 +390,7 @@ EWEAMainWindow::setUpLoadedFilesList()
     connect( m_loadedFilesList, &QListWidget::itemActivated,
              [this]( QListWidgetItem* activatedItem )
              {
-                auto pathOfExecutableFile = activatedItem->text().toStdString();
-
-                if ( m_artifactPathToViewerMap.contains( pathOfExecutableFile ) )
-                {
-                    m_artifactViewersStack->setCurrentWidget( m_artifactPathToViewerMap.at( pathOfExecutableFile ) );
-                }
+                showArtifact( activatedItem->text().toStdString() );
              } );
 
     m_loadedFilesList->setContextMenuPolicy( Qt::CustomContextMenu );
@@ -136,10 +420,77 @@ EWEAMainWindow::setUpLoadedFilesList()
                     unloadFilesAction->setEnabled( false );
                 }
 
+                auto compareFilesAction = contextMenu.addAction( "Compare selection" );
+
+                connect( compareFilesAction, &QAction::triggered,
+                         [this]()
+                         {
+                            compareSelectedArtifacts();
+                         } );
+
+                auto const selectedItems = m_loadedFilesList->selectedItems();
+
+                if (    selectedItems.size() != 2
+                     or selectedItems[0]->text().endsWith( ".obj" )
+                     or selectedItems[1]->text().endsWith( ".obj" ) )
+                {
+                    compareFilesAction->setEnabled( false );
+                }
+
                 contextMenu.exec( m_loadedFilesList->mapToGlobal( mousePosition ) );
              } );
 }
 
+void
+EWEAMainWindow::setUpDiagnosticsPanel()
+{
+    m_diagnosticsPanel = new DiagnosticsPanel;
+
+    auto diagnosticsDock = new QDockWidget( "Diagnostics", this );
+    diagnosticsDock->setWidget( m_diagnosticsPanel );
+    diagnosticsDock->hide();
+    addDockWidget( Qt::BottomDockWidgetArea, diagnosticsDock );
+
+    auto viewMenu = menuBar()->addMenu( "View" );
+    viewMenu->addAction( diagnosticsDock->toggleViewAction() );
+}
+
+void
+EWEAMainWindow::setUpMemoryBudgetWidgets()
+{
+    m_memoryUsageLabel = new QLabel;
+    statusBar()->addPermanentWidget( m_memoryUsageLabel );
+
+    auto memoryMenu = menuBar()->addMenu( "Memory" );
+    auto setMemoryBudgetAction = memoryMenu->addAction( "Set memory budget..." );
+
+    connect( setMemoryBudgetAction, &QAction::triggered,
+             [this]()
+             {
+                auto const bytesPerMebibyte = std::uint64_t{ 1024 } * 1024;
+
+                auto isAccepted = false;
+                auto const memoryBudgetInMebibytes =
+                    QInputDialog::getInt( this,
+                                          "Memory budget",
+                                          "Memory kept for loaded files, in MiB.\n"
+                                          "Least recently viewed files are unloaded beyond this and reloaded on demand.",
+                                          static_cast<int>( m_memoryBudgetInBytes / bytesPerMebibyte ),
+                                          16,
+                                          1024 * 1024,
+                                          64,
+                                          &isAccepted );
+
+                if ( isAccepted )
+                {
+                    m_memoryBudgetInBytes = memoryBudgetInMebibytes * bytesPerMebibyte;
+                    evictLeastRecentlyViewedArtifacts();
+                }
+             } );
+
+    updateMemoryUsageLabel( 0 );
+}
+
 void
 EWEAMainWindow::unloadSelectedArtifacts()
 {
@@ -147,15 +498,338 @@ EWEAMainWindow::unloadSelectedArtifacts()
     {
         auto pathOfExecutableFile = selectedItem->text().toStdString();
 
-        if ( m_artifactPathToViewerMap.contains( pathOfExecutableFile ) )
+        if ( m_artifactPathToLoadedArtifact.contains( pathOfExecutableFile ) )
         {
-            auto artifactViewer =
-                m_artifactPathToViewerMap.at( pathOfExecutableFile );
+            auto const& artifactViewer =
+                m_artifactPathToLoadedArtifact.at( pathOfExecutableFile ).viewer;
 
-            artifactViewer->deleteLater();
-            m_artifactPathToViewerMap.erase( pathOfExecutableFile );
+            if ( not artifactViewer.isNull() )
+            {
+                discardArtifactViewer( artifactViewer );
+            }
+
+            m_artifactPathToLoadedArtifact.erase( pathOfExecutableFile );
+            m_artifactChangeTracker.forgetArtifact( pathOfExecutableFile );
+            m_fileSystemWatcher->removePath( selectedItem->text() );
         }
 
         delete selectedItem;
     }
+
+    evictLeastRecentlyViewedArtifacts();
+}
+
+void
+EWEAMainWindow::compareSelectedArtifacts()
+{
+    auto selectedItems = m_loadedFilesList->selectedItems();
+
+    if ( selectedItems.size() != 2 )
+    {
+        return;
+    }
+
+    // The file higher up the list, usually the one loaded first, is the left
+    // side of the comparison.
+    if ( m_loadedFilesList->row( selectedItems[1] ) < m_loadedFilesList->row( selectedItems[0] ) )
+    {
+        std::swap( selectedItems[0], selectedItems[1] );
+    }
+
+    auto const pathOfLeftFile = selectedItems[0]->text();
+    auto const pathOfRightFile = selectedItems[1]->text();
+
+    // The viewers may have been evicted, so both files are loaded afresh
+    // rather than borrowed from them.
+    auto binaryDiff = BinaryDiff{};
+
+    QApplication::setOverrideCursor( Qt::WaitCursor );
+
+    try
+    {
+        auto const leftEXEFile = loadEXEFile( pathOfLeftFile.toStdString() );
+        auto const rightEXEFile = loadEXEFile( pathOfRightFile.toStdString() );
+
+        binaryDiff = diffEXEFiles( leftEXEFile, rightEXEFile );
+    }
+    catch ( std::runtime_error const& loadingError )
+    {
+        QApplication::restoreOverrideCursor();
+        QMessageBox::warning( this,
+                              "Failed to compare files",
+                              QString( "'%1' and '%2' could not be compared: %3" )
+                                  .arg( pathOfLeftFile )
+                                  .arg( pathOfRightFile )
+                                  .arg( QString::fromUtf8( loadingError.what() ) ) );
+        return;
+    }
+
+    QApplication::restoreOverrideCursor();
+
+    auto binaryDiffViewer = new BinaryDiffViewer( pathOfLeftFile, pathOfRightFile, std::move( binaryDiff ), this );
+    binaryDiffViewer->setWindowFlag( Qt::Window );
+    binaryDiffViewer->setAttribute( Qt::WA_DeleteOnClose );
+    binaryDiffViewer->resize( 900, 600 );
+    binaryDiffViewer->show();
+}
+
+void
+EWEAMainWindow::setUpWatchMode()
+{
+    m_fileSystemWatcher = new QFileSystemWatcher( this );
+
+    m_watchCoalescingTimer = new QTimer( this );
+    m_watchCoalescingTimer->setSingleShot( true );
+    m_watchCoalescingTimer->setInterval( watchCoalescingDelayInMilliseconds );
+
+    auto const handleChangedPath =
+        [this]( QString const& changedPath )
+        {
+            m_pendingChangedPaths.insert( changedPath.toStdString() );
+            m_watchCoalescingTimer->start();
+        };
+
+    connect( m_fileSystemWatcher, &QFileSystemWatcher::fileChanged, handleChangedPath );
+    connect( m_fileSystemWatcher, &QFileSystemWatcher::directoryChanged, handleChangedPath );
+
+    connect( m_watchCoalescingTimer, &QTimer::timeout,
+             [this]()
+             {
+                refreshChangedArtifacts();
+             } );
+
+    auto watchMenu = menuBar()->addMenu( "Watch" );
+
+    m_watchModeAction = watchMenu->addAction( "Refresh loaded files when they change" );
+    m_watchModeAction->setCheckable( true );
+
+    connect( m_watchModeAction, &QAction::toggled,
+             [this]( bool const isChecked )
+             {
+                setWatchModeEnabled( isChecked );
+             } );
+
+    auto watchDirectoryAction = watchMenu->addAction( "Watch directory..." );
+
+    connect( watchDirectoryAction, &QAction::triggered,
+             [this]()
+             {
+                auto const pathOfDirectory = QFileDialog::getExistingDirectory( this, "Watch directory" );
+
+                if ( pathOfDirectory.isEmpty() )
+                {
+                    return;
+                }
+
+                m_watchModeAction->setChecked( true );
+
+                loadArtifacts( watchDirectoryTree( pathOfDirectory ) );
+             } );
+}
+
+void
+EWEAMainWindow::setWatchModeEnabled( bool const enabled )
+{
+    m_watchCoalescingTimer->stop();
+    m_pendingChangedPaths.clear();
+
+    if ( not enabled )
+    {
+        m_watchedDirectories.clear();
+
+        for ( auto const& watchedPaths : { m_fileSystemWatcher->files(), m_fileSystemWatcher->directories() } )
+        {
+            if ( not watchedPaths.isEmpty() )
+            {
+                m_fileSystemWatcher->removePaths( watchedPaths );
+            }
+        }
+
+        return;
+    }
+
+    for ( auto const& [pathOfArtifact, loadedArtifact] : m_artifactPathToLoadedArtifact )
+    {
+        watchArtifact( pathOfArtifact );
+    }
+}
+
+void
+EWEAMainWindow::watchArtifact( std::string const& pathOfArtifact )
+{
+    if ( not m_watchModeAction->isChecked() )
+    {
+        return;
+    }
+
+    m_artifactChangeTracker.updateArtifact( pathOfArtifact );
+
+    // Linkers often write a new file and rename it over the old one, which
+    // the file watch alone misses; the directory watch catches it.
+    auto const pathOfFile = QString::fromStdString( pathOfArtifact );
+    m_fileSystemWatcher->addPath( pathOfFile );
+    m_fileSystemWatcher->addPath( QFileInfo( pathOfFile ).absolutePath() );
+}
+
+QStringList
+EWEAMainWindow::watchDirectoryTree( QString const& pathOfDirectory )
+{
+    auto pathsOfDirectories = QStringList{ pathOfDirectory };
+    auto directoryIterator = QDirIterator( pathOfDirectory, QDir::Dirs | QDir::NoDotAndDotDot, QDirIterator::Subdirectories );
+    while ( directoryIterator.hasNext() )
+    {
+        pathsOfDirectories.append( directoryIterator.next() );
+    }
+
+    // Subdirectories created later show up as a change of their parent, so
+    // walking the tree again on every change also picks those up.
+    auto pathsOfArtifacts = QStringList{};
+    for ( auto const& pathOfSubdirectory : pathsOfDirectories )
+    {
+        if ( m_watchedDirectories.insert( pathOfSubdirectory.toStdString() ).second )
+        {
+            m_fileSystemWatcher->addPath( pathOfSubdirectory );
+        }
+
+        for ( auto const& fileInfo : QDir( pathOfSubdirectory ).entryInfoList( QDir::Files, QDir::Name ) )
+        {
+            if ( isArtifactPath( fileInfo.filePath() ) and not m_artifactPathToLoadedArtifact.contains( fileInfo.filePath().toStdString() ) )
+            {
+                pathsOfArtifacts.append( fileInfo.filePath() );
+            }
+        }
+    }
+
+    return pathsOfArtifacts;
+}
+
+void
+EWEAMainWindow::refreshChangedArtifacts()
+{
+    auto const refreshTimer = Instrumentation::ScopedTimer{ "Refresh changed files" };
+
+    auto candidateArtifactPaths = std::set<std::string>{};
+    auto pathsOfNewArtifacts = QStringList{};
+
+    for ( auto const& changedPath : m_pendingChangedPaths )
+    {
+        auto const changedFileInfo = QFileInfo( QString::fromStdString( changedPath ) );
+
+        if ( not changedFileInfo.isDir() )
+        {
+            candidateArtifactPaths.insert( changedPath );
+            continue;
+        }
+
+        // A directory change only says that something in it was created,
+        // removed or renamed, so every loaded file in it is checked.
+        for ( auto const& [pathOfArtifact, loadedArtifact] : m_artifactPathToLoadedArtifact )
+        {
+            if ( QFileInfo( QString::fromStdString( pathOfArtifact ) ).absolutePath() == changedFileInfo.absoluteFilePath() )
+            {
+                candidateArtifactPaths.insert( pathOfArtifact );
+            }
+        }
+
+        if ( m_watchedDirectories.contains( changedPath ) )
+        {
+            pathsOfNewArtifacts.append( watchDirectoryTree( changedFileInfo.filePath() ) );
+        }
+    }
+
+    m_pendingChangedPaths.clear();
+
+    for ( auto const& pathOfArtifact : candidateArtifactPaths )
+    {
+        if ( not m_artifactPathToLoadedArtifact.contains( pathOfArtifact ) )
+        {
+            continue;
+        }
+
+        auto const listItems = m_loadedFilesList->findItems( QString::fromStdString( pathOfArtifact ), Qt::MatchExactly );
+
+        switch ( m_artifactChangeTracker.updateArtifact( pathOfArtifact ) )
+        {
+            case ArtifactChange::Added:
+            case ArtifactChange::Modified:
+                reloadArtifactViewer( pathOfArtifact );
+                break;
+            case ArtifactChange::Removed:
+                for ( auto listItem : listItems )
+                {
+                    listItem->setForeground( palette().brush( QPalette::Disabled, QPalette::Text ) );
+                    listItem->setToolTip( QString( "%1\nDeleted on disk; showing the last loaded contents." )
+                                              .arg( listItem->text() ) );
+                }
+                break;
+            default:
+                break;
+        }
+
+        // The file watch is dropped when a file is deleted or replaced.
+        auto const pathOfFile = QString::fromStdString( pathOfArtifact );
+        if ( QFileInfo::exists( pathOfFile ) and not m_fileSystemWatcher->files().contains( pathOfFile ) )
+        {
+            m_fileSystemWatcher->addPath( pathOfFile );
+        }
+    }
+
+    loadArtifacts( pathsOfNewArtifacts );
+}
+
+void
+EWEAMainWindow::reloadArtifactViewer( std::string const& pathOfArtifact )
+{
+    auto& loadedArtifact = m_artifactPathToLoadedArtifact.at( pathOfArtifact );
+    auto const pathOfFile = QString::fromStdString( pathOfArtifact );
+    auto const listItems = m_loadedFilesList->findItems( pathOfFile, Qt::MatchExactly );
+
+    // An evicted viewer is rebuilt from the file when next shown anyway.
+    if ( loadedArtifact.viewer.isNull() )
+    {
+        return;
+    }
+
+    QTabWidget* previousViewer = loadedArtifact.viewer;
+    auto const wasShown = m_artifactViewersStack->currentWidget() == previousViewer;
+    auto const previousTabIdx = previousViewer->currentIndex();
+    auto const lastViewedTick = loadedArtifact.lastViewedTick;
+
+    try
+    {
+        loadArtifactViewer( pathOfFile, loadedArtifact );
+    }
+    catch ( std::runtime_error const& loadingError )
+    {
+        // Keep showing the previous contents; the next write triggers
+        // another attempt.
+        for ( auto listItem : listItems )
+        {
+            listItem->setToolTip( QString( "%1\nCould not be reloaded: %2" )
+                                      .arg( listItem->text() )
+                                      .arg( QString::fromUtf8( loadingError.what() ) ) );
+        }
+        return;
+    }
+
+    // The refreshed viewer takes the place of the previous one, on the same
+    // tab, without counting as a view.
+    loadedArtifact.lastViewedTick = lastViewedTick;
+    loadedArtifact.viewer->setCurrentIndex( previousTabIdx );
+
+    if ( wasShown )
+    {
+        m_artifactViewersStack->setCurrentWidget( loadedArtifact.viewer );
+    }
+
+    m_artifactViewersStack->removeWidget( previousViewer );
+    discardArtifactViewer( previousViewer );
+
+    for ( auto listItem : listItems )
+    {
+        listItem->setForeground( QBrush{} );
+        listItem->setToolTip( QString( "%1\nReloaded at %2" )
+                                  .arg( listItem->text() )
+                                  .arg( QTime::currentTime().toString() ) );
+    }
 }
\ No newline at end of file
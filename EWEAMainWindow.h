@@ -2,16 +2,28 @@
 #ifndef EWEAMAINWINDOW_H
 #define EWEAMAINWINDOW_H
 
+#include "ArtifactWatch.h"
+#include "PEFiles.h"
+
 #include <QMainWindow>
 #include <QPointer>
 
+#include <cstdint>
 #include <map>
+#include <optional>
+#include <set>
+#include <string>
 #include <vector>
 
+class DiagnosticsPanel;
+class QAction;
 class QDragEnterEvent;
+class QFileSystemWatcher;
+class QLabel;
 class QListWidget;
 class QStackedWidget;
 class QTabWidget;
+class QTimer;
 
 class EWEAMainWindow : public QMainWindow
 {
@@ -30,13 +42,82 @@ private:
     void
     setUpLoadedFilesList();
 
+    void
+    setUpDiagnosticsPanel();
+
+    void
+    setUpMemoryBudgetWidgets();
+
+    void
+    setUpWatchMode();
+
+    void
+    loadArtifacts( QStringList const& pathsOfArtifacts );
+
     void
     unloadSelectedArtifacts();
 
+    void
+    compareSelectedArtifacts();
+
+    // The headers and section table outlive an evicted viewer, so the list
+    // can still describe the file without reading it again.
+    struct LoadedArtifact
+    {
+        QPointer<QTabWidget>      viewer;
+        std::optional<EXEFile>    exeHeaders;
+        std::optional<OBJFile>    objHeaders;
+        std::uint64_t             fileSizeInBytes = 0;
+        std::uint64_t             estimatedFileMemoryUsageInBytes = 0;
+        std::uint64_t             estimatedViewerMemoryUsageInBytes = 0;
+        std::uint64_t             lastViewedTick = 0;
+    };
+
+    void
+    loadArtifactViewer( QString const& pathOfArtifact,
+                        LoadedArtifact& loadedArtifact );
+
+    void
+    showArtifact( std::string const& pathOfArtifact );
+
+    static QString
+    getHeadersSummary( LoadedArtifact const& loadedArtifact );
+
+    void
+    evictLeastRecentlyViewedArtifacts();
+
+    void
+    updateMemoryUsageLabel( std::uint64_t const residentMemoryUsageInBytes );
+
+    void
+    setWatchModeEnabled( bool const enabled );
+
+    void
+    watchArtifact( std::string const& pathOfArtifact );
+
+    QStringList
+    watchDirectoryTree( QString const& pathOfDirectory );
+
+    void
+    refreshChangedArtifacts();
+
+    void
+    reloadArtifactViewer( std::string const& pathOfArtifact );
+
 private:
-    QPointer<QListWidget>                m_loadedFilesList;
-    QPointer<QStackedWidget>             m_artifactViewersStack;
-    std::map<std::string, QTabWidget*>   m_artifactPathToViewerMap;
+    QPointer<QListWidget>                    m_loadedFilesList;
+    QPointer<QStackedWidget>                 m_artifactViewersStack;
+    QPointer<DiagnosticsPanel>               m_diagnosticsPanel;
+    QPointer<QLabel>                         m_memoryUsageLabel;
+    std::map<std::string, LoadedArtifact>    m_artifactPathToLoadedArtifact;
+    std::uint64_t                            m_memoryBudgetInBytes = std::uint64_t{ 1024 } * 1024 * 1024;
+    std::uint64_t                            m_lastViewedTick = 0;
+    QPointer<QAction>                        m_watchModeAction;
+    QPointer<QFileSystemWatcher>             m_fileSystemWatcher;
+    QPointer<QTimer>                         m_watchCoalescingTimer;
+    std::set<std::string>                    m_watchedDirectories;
+    std::set<std::string>                    m_pendingChangedPaths;
+    ArtifactChangeTracker                    m_artifactChangeTracker;
 };
 
 #endif // EWEAMAINWINDOW_H
\ No newline at end of file
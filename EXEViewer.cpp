@@ -1,21 +1,38 @@
 
 #include "EXEViewer.h"
 
+#include "HeaderFieldsModel.h"
+#include "HexViewerTab.h"
+#include "Instrumentation.h"
+#include "ManagedMetadataTab.h"
+#include "StringsTab.h"
+#include "WorkerPool.h"
+
 #include <QApplication>
-#include <QGridLayout>
 #include <QGroupBox>
 #include <QLabel>
 #include <QListWidget>
+#include <QMessageBox>
 #include <QPlainTextEdit>
 #include <QTableWidget>
 #include <QVBoxLayout>
 
+#include <chrono>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <stop_token>
+
 namespace
 {
     void
     setUpDOSHeaderWidgets( EXEFile const& loadedEXEFile,
                            QGroupBox* dosHeaderWidgetsContainer );
 
+    void
+    setUpRichHeaderWidgets( RichHeader const& richHeader,
+                            QGroupBox* richHeaderWidgetsContainer );
+
     void
     setUpNTFileHeaderWidgets( EXEFile const& loadedEXEFile,
                               QGroupBox* ntFileHeaderWidgetsContainer );
@@ -29,28 +46,217 @@ namespace
                                QGroupBox* dataDirectoryWidgetsContainer );
 }
 
-EXEViewer::EXEViewer( EXEFile&& loadedEXEFile,
+// Lets the analysis thread reach the viewer for as long as the viewer
+// exists; the viewer clears the pointer when it is destroyed.
+struct EXEViewer::AnalysisRelay
+{
+    std::mutex          mutex;
+    EXEViewer*          viewer = nullptr;
+    std::stop_source    stopSource;
+};
+
+namespace
+{
+    // The analyses of every viewer, including ones already closed, which
+    // may still be finishing the task they were on.
+    std::mutex                        analysesInFlightMutex;
+    std::vector<std::future<void>>    analysesInFlight;
+}
+
+EXEViewer::EXEViewer( QString const& pathOfEXEFile,
+                      std::shared_ptr<ImageAnalysis> imageAnalysis,
                       QWidget* parentWidget )
-: QTabWidget( parentWidget )
-, m_loadedEXEFile( std::move( loadedEXEFile ) )
+: LazyTabWidget( parentWidget )
+, m_pathOfEXEFile( pathOfEXEFile )
+, m_imageAnalysis( std::move( imageAnalysis ) )
+, m_loadedEXEFile( m_imageAnalysis->getEXEFile() )
+, m_analysisRelay( std::make_shared<AnalysisRelay>() )
+{
+    m_analysisRelay->viewer = this;
+
+    addAnalysisTab( "File Headers", AnalysisStage::Headers,
+                    [this]( QWidget* tabRootWidget )
+                    {
+                        setUpFileHeadersTab( tabRootWidget );
+                    } );
+    addAnalysisTab( "Section Headers", AnalysisStage::SectionDigests,
+                    [this]( QWidget* tabRootWidget )
+                    {
+                        setUpSectionHeadersTab( tabRootWidget );
+                    } );
+    addAnalysisTab( "Imports", AnalysisStage::Imports,
+                    [this]( QWidget* tabRootWidget )
+                    {
+                        setUpImportsTab( tabRootWidget );
+                    } );
+    addAnalysisTab( "Exports", AnalysisStage::Exports,
+                    [this]( QWidget* tabRootWidget )
+                    {
+                        setUpExportsTab( tabRootWidget );
+                    } );
+
+    if ( hasManagedMetadata( m_loadedEXEFile ) )
+    {
+        addAnalysisTab( "CLR Metadata", AnalysisStage::SectionData,
+                        [this]( QWidget* tabRootWidget )
+                        {
+                            setUpManagedMetadataTab( tabRootWidget );
+                        } );
+    }
+
+    addAnalysisTab( "Strings", AnalysisStage::Headers,
+                    [this]( QWidget* tabRootWidget )
+                    {
+                        setUpStringsTab( tabRootWidget );
+                    } );
+    addAnalysisTab( "Hex", AnalysisStage::Headers,
+                    [this]( QWidget* tabRootWidget )
+                    {
+                        setUpHexTab( tabRootWidget );
+                    } );
+
+    Instrumentation::addToCounter( Instrumentation::Counter::WidgetsCreated,
+                                   findChildren<QWidget*>().size() );
+
+    startRemainingAnalysisStages();
+}
+
+EXEViewer::~EXEViewer()
+{
+    cancelRemainingAnalysisStages();
+
+    auto const lock = std::lock_guard{ m_analysisRelay->mutex };
+    m_analysisRelay->viewer = nullptr;
+}
+
+void
+EXEViewer::cancelRemainingAnalysisStages()
 {
-    setUpFileHeadersTab();
-    setUpSectionHeadersTab();
-    setUpImportsTab();
-    setUpExportsTab();
+    m_analysisRelay->stopSource.request_stop();
 }
 
 void
-EXEViewer::setUpFileHeadersTab()
+EXEViewer::waitForAnalysesInFlight()
 {
-    auto headersTabRootWidget = new QWidget;
-    addTab( headersTabRootWidget, "File Headers" );
+    auto const lock = std::lock_guard{ analysesInFlightMutex };
+
+    for ( auto& analysisInFlight : analysesInFlight )
+    {
+        analysisInFlight.wait();
+    }
+
+    analysesInFlight.clear();
+}
+
+void
+EXEViewer::addAnalysisTab( QString const& tabTitle,
+                           AnalysisStage const requiredStage,
+                           TabBuilder&& tabBuilder )
+{
+    auto const isReady = m_imageAnalysis->isStageFinished( requiredStage );
+    if ( not isReady )
+    {
+        m_tabsAwaitingStage.emplace_back( count(), requiredStage );
+    }
+
+    addLazyTab( tabTitle, std::move( tabBuilder ), isReady );
+}
+
+void
+EXEViewer::startRemainingAnalysisStages()
+{
+    // The job shares the analysis, so an evicted viewer does not have to wait
+    // for it; what it posts to a destroyed viewer is dropped.
+    auto analysisInFlight =
+        WorkerPool::getShared().submit(
+            [imageAnalysis = m_imageAnalysis, analysisRelay = m_analysisRelay]()
+            {
+                auto const postToViewer =
+                    [&analysisRelay]( std::function<void( EXEViewer* )>&& viewerUpdate )
+                    {
+                        auto const lock = std::lock_guard{ analysisRelay->mutex };
+
+                        if ( auto const viewer = analysisRelay->viewer )
+                        {
+                            QMetaObject::invokeMethod( viewer,
+                                                       [viewer, viewerUpdate = std::move( viewerUpdate )]()
+                                                       {
+                                                           viewerUpdate( viewer );
+                                                       },
+                                                       Qt::QueuedConnection );
+                        }
+                    };
+
+                try
+                {
+                    imageAnalysis->runRemainingStages(
+                        [&postToViewer]( AnalysisStage const finishedStage )
+                        {
+                            postToViewer( [finishedStage]( EXEViewer* viewer )
+                                          {
+                                              viewer->onAnalysisStageFinished( finishedStage );
+                                          } );
+                        },
+                        analysisRelay->stopSource.get_token() );
+                }
+                catch ( std::exception const& analysisError )
+                {
+                    postToViewer( [errorMessage = QString::fromUtf8( analysisError.what() )]( EXEViewer* viewer )
+                                  {
+                                      viewer->onAnalysisFailed( errorMessage );
+                                  } );
+                }
+            } );
+
+    auto const lock = std::lock_guard{ analysesInFlightMutex };
+
+    std::erase_if( analysesInFlight,
+                   []( std::future<void> const& analysis )
+                   {
+                       return analysis.wait_for( std::chrono::seconds{ 0 } ) == std::future_status::ready;
+                   } );
+    analysesInFlight.push_back( std::move( analysisInFlight ) );
+}
+
+void
+EXEViewer::onAnalysisStageFinished( AnalysisStage const finishedStage )
+{
+    for ( auto const& [tabIdx, requiredStage] : m_tabsAwaitingStage )
+    {
+        if ( requiredStage == finishedStage )
+        {
+            markTabReady( tabIdx );
+        }
+    }
+}
+
+void
+EXEViewer::onAnalysisFailed( QString const& errorMessage )
+{
+    QMessageBox::warning( this,
+                          "Failed to analyze file",
+                          QString( "'%1' could only be partly analyzed: %2" )
+                              .arg( m_pathOfEXEFile )
+                              .arg( errorMessage ) );
+}
+
+void
+EXEViewer::setUpFileHeadersTab( QWidget* headersTabRootWidget )
+{
+    auto const tabTimer = Instrumentation::ScopedTimer{ "File Headers tab" };
 
     auto headersTabMainLayout = new QVBoxLayout( headersTabRootWidget );
 
     auto dosHeaderWidgetsContainer = new QGroupBox( "DOS Header" );
     headersTabMainLayout->addWidget( dosHeaderWidgetsContainer );
 
+    auto richHeaderWidgetsContainer =
+        m_loadedEXEFile.richHeader ? new QGroupBox( "Rich Header" ) : nullptr;
+    if ( richHeaderWidgetsContainer != nullptr )
+    {
+        headersTabMainLayout->addWidget( richHeaderWidgetsContainer );
+    }
+
     auto ntFileHeaderWidgetsContainer = new QGroupBox( "NT File Header" );
     headersTabMainLayout->addWidget( ntFileHeaderWidgetsContainer );
 
@@ -63,98 +269,59 @@ EXEViewer::setUpFileHeadersTab()
     headersTabMainLayout->addStretch();
 
     setUpDOSHeaderWidgets( m_loadedEXEFile, dosHeaderWidgetsContainer );
+    if ( richHeaderWidgetsContainer != nullptr )
+    {
+        setUpRichHeaderWidgets( *m_loadedEXEFile.richHeader, richHeaderWidgetsContainer );
+    }
     setUpNTFileHeaderWidgets( m_loadedEXEFile, ntFileHeaderWidgetsContainer );
     setUpNTOptionalHeaderWidgets( m_loadedEXEFile, ntOptionalHeaderWidgetsContainer );
     setUpDataDirectoryWidgets( m_loadedEXEFile, dataDirectoryWidgetsContainer );
 }
 
 void
-EXEViewer::setUpSectionHeadersTab()
+EXEViewer::setUpSectionHeadersTab( QWidget* sectionHeadersTabRootWidget )
 {
-    auto sectionHeadersTabRootWidget = new QWidget;
-    addTab( sectionHeadersTabRootWidget, "Section Headers" );
-
-    auto sectionHeadersTabMainLayout = new QGridLayout( sectionHeadersTabRootWidget );
+    auto const tabTimer = Instrumentation::ScopedTimer{ "Section Headers tab" };
 
-    auto const& sectionHeadersNameToInfo = m_loadedEXEFile.sectionHeadersNameToInfo;
-    auto currentRow = 0;
-    auto currentColumn = 0;
+    auto sectionHeadersTabMainLayout = new QVBoxLayout( sectionHeadersTabRootWidget );
 
-    for ( auto const& [sectionName, sectionHeader] : sectionHeadersNameToInfo )
+    auto sectionColumns = std::vector<HeaderFieldsModel::Column>{};
+    for ( auto const& [sectionName, sectionHeader] : m_loadedEXEFile.sectionHeadersNameToInfo )
     {
-        auto sectionHeaderWidgetsContainer =
-            new QGroupBox( QString::fromStdString( sectionName ) );
-        sectionHeadersTabMainLayout->addWidget( sectionHeaderWidgetsContainer,
-                                                currentRow,
-                                                currentColumn );
-        currentColumn++;
-        if ( currentColumn >= 2 )
-        {
-            currentColumn = 0;
-            currentRow++;
-        }
-
-        auto sectionHeaderWidgetsLayout = new QVBoxLayout( sectionHeaderWidgetsContainer );
-
-        auto sectionSizeLabel =
-            new QLabel( QString( "Size in memory: %1" )
-                            .arg( sectionHeader.sectionSizeInBytesInMemory ) );
-        sectionHeaderWidgetsLayout->addWidget( sectionSizeLabel );
-
-        auto const sectionBaseAddressAsHexString =
-            QString( "%1" ).arg( sectionHeader.sectionBaseAddressInMemory,
-                                 8, 16, QChar( '0' ) ).toUpper();
-        auto sectionBaseAddressLabel =
-            new QLabel( QString( "Base address in memory: 0x%1" )
-                            .arg( sectionBaseAddressAsHexString ) );
-        sectionHeaderWidgetsLayout->addWidget( sectionBaseAddressLabel );
-
-        auto sizeOfRawDataLabel =
-            new QLabel( QString( "Size of raw data: %1" )
-                            .arg( sectionHeader.sizeOfRawDataInBytes ) );
-        sectionHeaderWidgetsLayout->addWidget( sizeOfRawDataLabel );
-
-        auto const pointerToRawDataAsHexString =
-            QString( "%1" ).arg( sectionHeader.pointerToRawData,
-                                 8, 16, QChar( '0' ) ).toUpper();
-        auto pointerToRawDataLabel =
-            new QLabel( QString( "Pointer to raw data: 0x%1" )
-                            .arg( pointerToRawDataAsHexString ) );
-        sectionHeaderWidgetsLayout->addWidget( pointerToRawDataLabel );
-
-        auto const pointerToRelocationsAsHexString =
-            QString( "%1" ).arg( sectionHeader.pointerToRelocations,
-                                 8, 16, QChar( '0' ) ).toUpper();
-        auto pointerToRelocationsLabel =
-            new QLabel( QString( "Pointer to relocations: 0x%1" )
-                            .arg( pointerToRelocationsAsHexString ) );
-        sectionHeaderWidgetsLayout->addWidget( pointerToRelocationsLabel );
-
-        auto const pointerToLineNumbersAsHexString =
-            QString( "%1" ).arg( sectionHeader.pointerToLineNumbers,
-                                 8, 16, QChar( '0' ) ).toUpper();
-        auto pointerToLineNumbersLabel =
-            new QLabel( QString( "Pointer to line numbers: 0x%1" )
-                            .arg( pointerToLineNumbersAsHexString ) );
-        sectionHeaderWidgetsLayout->addWidget( pointerToLineNumbersLabel );
-
-        auto numberOfRelocationsLabel =
-            new QLabel( QString( "Number of relocations: %1" )
-                            .arg( sectionHeader.numberOfRelocations ) );
-        sectionHeaderWidgetsLayout->addWidget( numberOfRelocationsLabel );
-
-        auto numberOfLineNumberEntriesLabel =
-            new QLabel( QString( "Number of line number entries: %1" )
-                            .arg( sectionHeader.numberOfLineNumberEntries ) );
-        sectionHeaderWidgetsLayout->addWidget( numberOfLineNumberEntriesLabel );
+        auto fieldRows = PE::getFieldRows( sectionHeader, PE::sectionHeaderFields );
+
+        auto const& sectionDigest = m_imageAnalysis->getSectionDigests().at( sectionName );
+        fieldRows.push_back( PE::FieldRow
+                             {
+                                 .name = "Content hash",
+                                 .value = QString( "%1" ).arg( sectionDigest.contentHash, 16, 16, QChar( '0' ) ).toStdString()
+                             } );
+        fieldRows.push_back( PE::FieldRow
+                             {
+                                 .name = "Entropy",
+                                 .value = QString( "%1 bits/byte" ).arg( sectionDigest.entropyInBitsPerByte, 0, 'f', 3 ).toStdString()
+                             } );
+        fieldRows.push_back( PE::FieldRow
+                             {
+                                 .name = "Similarity digest",
+                                 .value = sectionDigest.similarityDigest ? formatSimilarityDigest( *sectionDigest.similarityDigest ) : "-"
+                             } );
+
+        sectionColumns.push_back( HeaderFieldsModel::Column
+                                  {
+                                      .name = QString::fromStdString( sectionName ),
+                                      .fieldRows = std::move( fieldRows )
+                                  } );
     }
+
+    sectionHeadersTabMainLayout->addWidget(
+        createHeaderFieldsView( new HeaderFieldsModel( std::move( sectionColumns ) ) ) );
 }
 
 void
-EXEViewer::setUpImportsTab()
+EXEViewer::setUpImportsTab( QWidget* importsTabRootWidget )
 {
-    auto importsTabRootWidget = new QWidget;
-    addTab( importsTabRootWidget, "Imports" );
+    auto const tabTimer = Instrumentation::ScopedTimer{ "Imports tab" };
 
     auto importsTabMainLayout = new QVBoxLayout( importsTabRootWidget );
 
@@ -164,8 +331,12 @@ EXEViewer::setUpImportsTab()
     auto importedFunctionsViewerContainer = new QGroupBox( "Imported Functions" );
     importsTabMainLayout->addWidget( importedFunctionsViewerContainer );
 
+    auto callSitesViewerContainer = new QGroupBox( "Call Sites" );
+    importsTabMainLayout->addWidget( callSitesViewerContainer );
+
     auto importedDLLsViewerLayout = new QVBoxLayout( importedDLLsViewerContainer );
     auto importedFunctionsViewerLayout = new QVBoxLayout( importedFunctionsViewerContainer );
+    auto callSitesViewerLayout = new QVBoxLayout( callSitesViewerContainer );
 
     auto importedDLLsViewer = new QListWidget;
     importedDLLsViewerLayout->addWidget( importedDLLsViewer );
@@ -173,22 +344,76 @@ EXEViewer::setUpImportsTab()
     auto importedFunctionsViewer = new QListWidget;
     importedFunctionsViewerLayout->addWidget( importedFunctionsViewer );
 
+    auto callSitesViewer = new QListWidget;
+    callSitesViewerLayout->addWidget( callSitesViewer );
+
     for ( auto const& [importedDLLName, importedFunctions] : m_loadedEXEFile.importedDLLToImportedFunctions )
     {
         importedDLLsViewer->addItem( QString::fromStdString( importedDLLName ) );
 
         for ( auto const& importedFunction : importedFunctions )
         {
-            importedFunctionsViewer->addItem( QString::fromStdString( importedFunction ) );
+            auto importedFunctionText = QString::fromStdString( importedFunction.name );
+            if ( importedFunction.ordinal and not importedFunction.name.starts_with( '#' ) )
+            {
+                importedFunctionText += QString( " (ordinal %1)" ).arg( *importedFunction.ordinal );
+            }
+
+            auto importedFunctionItem = new QListWidgetItem( importedFunctionText );
+            importedFunctionItem->setData( Qt::UserRole, QVariant( importedFunction.iatSlotRVA ) );
+            importedFunctionsViewer->addItem( importedFunctionItem );
         }
     }
+
+    // The code sections are only swept once a function is selected, and then
+    // only once for all functions.
+    connect( importedFunctionsViewer, &QListWidget::currentItemChanged,
+             [this, callSitesViewer]( QListWidgetItem* currentItem )
+             {
+                 callSitesViewer->clear();
+
+                 if ( currentItem == nullptr )
+                 {
+                     return;
+                 }
+
+                 auto const iatSlotRVA = currentItem->data( Qt::UserRole ).toUInt();
+
+                 for ( auto const& importReference : getReferencesToIATSlot( getImportReferences(), iatSlotRVA ) )
+                 {
+                     callSitesViewer->addItem( QString( "0x%1  %2" )
+                                                   .arg( importReference.instructionRVA, 8, 16, QChar( '0' ) )
+                                                   .arg( QString::fromStdString( getImportReferenceKindName( importReference.kind ) ) ) );
+                 }
+
+                 if ( callSitesViewer->count() == 0 )
+                 {
+                     callSitesViewer->addItem( "No references found in the executable sections." );
+                 }
+             } );
+}
+
+std::vector<ImportReference> const&
+EXEViewer::getImportReferences()
+{
+    if ( not m_importReferences )
+    {
+        m_importReferences = findImportReferences( m_loadedEXEFile );
+    }
+
+    return *m_importReferences;
 }
 
 void
-EXEViewer::setUpExportsTab()
+EXEViewer::setUpExportsTab( QWidget* exportsTabRootWidget )
 {
+    auto const tabTimer = Instrumentation::ScopedTimer{ "Exports tab" };
+
+    auto exportsTabMainLayout = new QVBoxLayout( exportsTabRootWidget );
+    exportsTabMainLayout->setContentsMargins( 0, 0, 0, 0 );
+
     auto exportedFunctionsViewerContainer = new QGroupBox( "Exported Functions" );
-    addTab( exportedFunctionsViewerContainer, "Exports" );
+    exportsTabMainLayout->addWidget( exportedFunctionsViewerContainer );
 
     auto exportedFunctionsViewerLayout = new QVBoxLayout( exportedFunctionsViewerContainer );
 
@@ -211,6 +436,59 @@ EXEViewer::setUpExportsTab()
     exportedFunctionsViewer->resizeColumnsToContents();
 }
 
+void
+EXEViewer::setUpManagedMetadataTab( QWidget* managedMetadataTabRootWidget )
+{
+    auto const tabTimer = Instrumentation::ScopedTimer{ "CLR Metadata tab" };
+
+    auto managedMetadataTabMainLayout = new QVBoxLayout( managedMetadataTabRootWidget );
+    managedMetadataTabMainLayout->setContentsMargins( 0, 0, 0, 0 );
+
+    managedMetadataTabMainLayout->addWidget( new ManagedMetadataTab( m_loadedEXEFile ) );
+}
+
+void
+EXEViewer::setUpStringsTab( QWidget* stringsTabRootWidget )
+{
+    auto const tabTimer = Instrumentation::ScopedTimer{ "Strings tab" };
+
+    auto stringsTabMainLayout = new QVBoxLayout( stringsTabRootWidget );
+    stringsTabMainLayout->setContentsMargins( 0, 0, 0, 0 );
+
+    stringsTabMainLayout->addWidget( new StringsTab( m_pathOfEXEFile, getStringScanRegions( m_loadedEXEFile ) ) );
+}
+
+void
+EXEViewer::setUpHexTab( QWidget* hexTabRootWidget )
+{
+    auto const tabTimer = Instrumentation::ScopedTimer{ "Hex tab" };
+
+    auto jumpTargets = std::vector<HexViewerTab::JumpTarget>{};
+
+    for ( auto const& [sectionName, sectionHeader] : m_loadedEXEFile.sectionHeadersNameToInfo )
+    {
+        jumpTargets.push_back( HexViewerTab::JumpTarget
+                               {
+                                  .name = QString::fromStdString( sectionName ),
+                                  .fileOffset = sectionHeader.pointerToRawData
+                               } );
+    }
+
+    auto hexTabMainLayout = new QVBoxLayout( hexTabRootWidget );
+    hexTabMainLayout->setContentsMargins( 0, 0, 0, 0 );
+
+    hexTabMainLayout->addWidget( new HexViewerTab( m_pathOfEXEFile,
+                                                   jumpTargets,
+                                                   [this]( PE::ByteReader const& mappedBytes )
+                                                   {
+                                                       return getKnownFileRegions( mappedBytes, m_loadedEXEFile );
+                                                   },
+                                                   [this]( std::uint64_t const rva )
+                                                   {
+                                                       return PE::convertRVAToFileOffset( m_loadedEXEFile.sectionHeadersNameToInfo, rva );
+                                                   } ) );
+}
+
 namespace
 {
     void
@@ -225,34 +503,66 @@ namespace
         dosHeaderWidgetsLayout->addWidget( offsetOfNTSignatureLabel );
     }
 
+    void
+    setUpRichHeaderWidgets( RichHeader const& richHeader,
+                            QGroupBox* richHeaderWidgetsContainer )
+    {
+        auto richHeaderWidgetsLayout = new QVBoxLayout( richHeaderWidgetsContainer );
+
+        auto const xorKeyHexString =
+            QString( "%1" ).arg( richHeader.xorKey, 8, 16, QChar( '0' ) ).toUpper();
+        auto xorKeyLabel =
+            new QLabel( QString( "XOR key: 0x%1 (checksum %2)" )
+                            .arg( xorKeyHexString )
+                            .arg( richHeader.isChecksumValid() ? "valid" : "invalid, header was edited" ) );
+        richHeaderWidgetsLayout->addWidget( xorKeyLabel );
+
+        auto richHeaderEntriesViewer = new QTableWidget;
+        richHeaderWidgetsLayout->addWidget( richHeaderEntriesViewer );
+
+        richHeaderEntriesViewer->setColumnCount( 3 );
+        richHeaderEntriesViewer->setHorizontalHeaderLabels( { "Product ID", "Build", "Count" } );
+
+        richHeaderEntriesViewer->setRowCount( richHeader.entries.size() );
+
+        for ( auto row = 0; auto const& richHeaderEntry : richHeader.entries )
+        {
+            auto const cellTexts =
+            {
+                "0x" + QString( "%1" ).arg( richHeaderEntry.productId, 4, 16, QChar( '0' ) ).toUpper(),
+                QString::number( richHeaderEntry.buildNumber ),
+                QString::number( richHeaderEntry.count )
+            };
+
+            for ( auto column = 0; auto const& cellText : cellTexts )
+            {
+                auto tableEntry = new QTableWidgetItem( cellText );
+                tableEntry->setFlags( tableEntry->flags() & ~Qt::ItemIsEditable );
+
+                richHeaderEntriesViewer->setItem( row, column++, tableEntry );
+            }
+
+            row++;
+        }
+
+        richHeaderEntriesViewer->resizeColumnsToContents();
+    }
+
     void
     setUpNTFileHeaderWidgets( EXEFile const& loadedEXEFile,
                               QGroupBox* ntFileHeaderWidgetsContainer )
     {
         auto ntFileHeaderWidgetsLayout = new QVBoxLayout( ntFileHeaderWidgetsContainer );
 
-        auto const& ntFileHeader = loadedEXEFile.ntFileHeader;
-
-        auto optionalHeaderSizeLabel =
-            new QLabel( QString( "Size of optional header: %1" )
-                            .arg( ntFileHeader.sizeOfOptionalHeader ) );
-        ntFileHeaderWidgetsLayout->addWidget( optionalHeaderSizeLabel );
-
-        auto const targetMachineArchitectureHexString =
-            QString( "%1" ).arg( ntFileHeader.targetMachineArchitecture,
-                                 4, 16, QChar( '0' ) ).toUpper();
-        auto const targetMachineArchitectureName =
-            QString::fromStdString( PE::getMachineArchitectureName( ntFileHeader.targetMachineArchitecture ) );
-        auto targetMachineArchitectureLabel =
-            new QLabel( QString( "Target machine architecture: 0x%1 (%2)" )
-                            .arg( targetMachineArchitectureHexString )
-                            .arg( targetMachineArchitectureName ) );
-        ntFileHeaderWidgetsLayout->addWidget( targetMachineArchitectureLabel );
-
-        auto numberOfSectionsLabel =
-            new QLabel( QString( "Number of sections: %1" )
-                            .arg( ntFileHeader.numberOfSections ) );
-        ntFileHeaderWidgetsLayout->addWidget( numberOfSectionsLabel );
+        auto ntFileHeaderColumns = std::vector<HeaderFieldsModel::Column>{};
+        ntFileHeaderColumns.push_back( HeaderFieldsModel::Column
+                                       {
+                                           .name = "Value",
+                                           .fieldRows = PE::getFieldRows( loadedEXEFile.ntFileHeader, PE::ntFileHeaderFields )
+                                       } );
+
+        ntFileHeaderWidgetsLayout->addWidget(
+            createHeaderFieldsView( new HeaderFieldsModel( std::move( ntFileHeaderColumns ) ) ) );
     }
 
     void
@@ -262,68 +572,15 @@ namespace
         auto ntOptionalHeaderWidgetsLayout =
             new QVBoxLayout( ntOptionalHeaderWidgetsContainer );
 
-        auto const& optionalHeader = loadedEXEFile.ntOptionalHeader;
-
-        auto const peSignatureHexString =
-            QString( "%1" ).arg( optionalHeader.peSignature,
-                                 0, 16, QChar( '0' ) ).toUpper();
-        auto const peSignatureName =
-            QString::fromStdString( PE::getPESignatureName( optionalHeader.peSignature ) );
-        auto peSignatureLabel =
-            new QLabel( QString( "PE signature: 0x%1 (%2)" )
-                            .arg( peSignatureHexString )
-                            .arg( peSignatureName ) );
-        ntOptionalHeaderWidgetsLayout->addWidget( peSignatureLabel );
-
-        auto linkerVersionLabel =
-            new QLabel( QString( "Linker version: %1.%2" )
-                            .arg( optionalHeader.linkerMajorVersion )
-                            .arg( optionalHeader.linkerMinorVersion ) );
-        ntOptionalHeaderWidgetsLayout->addWidget( linkerVersionLabel );
-
-        auto sizeOfCodeLabel =
-            new QLabel( QString( "Size of code: %1" )
-                            .arg( optionalHeader.sizeOfCodeInBytes ) );
-        ntOptionalHeaderWidgetsLayout->addWidget( sizeOfCodeLabel );
-
-        auto sizeOfInitializedDataLabel =
-            new QLabel( QString( "Size of initialized data: %1" )
-                            .arg( optionalHeader.sizeOfInitializedDataInBytes ) );
-        ntOptionalHeaderWidgetsLayout->addWidget( sizeOfInitializedDataLabel );
-
-        auto sizeOfUninitializedDataLabel =
-            new QLabel( QString( "Size of uninitialized data: %1" )
-                            .arg( optionalHeader.sizeOfUninitializedDataInBytes ) );
-        ntOptionalHeaderWidgetsLayout->addWidget( sizeOfUninitializedDataLabel );
-
-        auto const entryPointAddressHexString =
-            QString( "%1" ).arg( optionalHeader.addressOfEntryPoint,
-                                 8, 16, QChar( '0' ) ).toUpper();
-        auto addressOfEntryPointLabel =
-            new QLabel( QString( "Address of entry point: 0x%1" )
-                            .arg( entryPointAddressHexString ) );
-        ntOptionalHeaderWidgetsLayout->addWidget( addressOfEntryPointLabel );
-
-        auto const baseOfCodeAddressHexString =
-            QString( "%1" ).arg( optionalHeader.addressOfBaseOfCode,
-                                 8, 16, QChar( '0' ) ).toUpper();
-        auto addressOfBaseOfCodeLabel =
-            new QLabel( QString( "Address of base of code: 0x%1" )
-                            .arg( baseOfCodeAddressHexString ) );
-        ntOptionalHeaderWidgetsLayout->addWidget( addressOfBaseOfCodeLabel );
-
-        auto const imageBaseAddressHexString =
-            QString( "%1" ).arg( optionalHeader.preferredBaseAddressOfImage,
-                                 16, 16, QChar( '0' ) ).toUpper();
-        auto preferredBaseAddressOfImageLabel =
-            new QLabel( QString( "Preferred base address of image: 0x%1" )
-                            .arg( imageBaseAddressHexString ) );
-        ntOptionalHeaderWidgetsLayout->addWidget( preferredBaseAddressOfImageLabel );
-
-        auto numberOfDataDirectoriesLabel =
-            new QLabel( QString( "Number of data directories: %1" )
-                            .arg( optionalHeader.numberOfDataDirectories ) );
-        ntOptionalHeaderWidgetsLayout->addWidget( numberOfDataDirectoriesLabel );
+        auto ntOptionalHeaderColumns = std::vector<HeaderFieldsModel::Column>{};
+        ntOptionalHeaderColumns.push_back( HeaderFieldsModel::Column
+                                           {
+                                               .name = "Value",
+                                               .fieldRows = PE::getFieldRows( loadedEXEFile.ntOptionalHeader, PE::ntOptionalHeader64Fields )
+                                           } );
+
+        ntOptionalHeaderWidgetsLayout->addWidget(
+            createHeaderFieldsView( new HeaderFieldsModel( std::move( ntOptionalHeaderColumns ) ) ) );
     }
 
     void
@@ -2,33 +2,87 @@
 #ifndef EXEVIEWER_H
 #define EXEVIEWER_H
 
+#include "ImageAnalysis.h"
+#include "ImportReferences.h"
+#include "LazyTabWidget.h"
 #include "PEFiles.h"
 
-#include <QTabWidget>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
 
-class EXEViewer : public QTabWidget
+class EXEViewer : public LazyTabWidget
 {
     Q_OBJECT
 
 public:
-    EXEViewer( EXEFile&& loadedEXEFile,
+    // Takes the analysis with its headers parsed and runs the remaining
+    // stages in the background. Each tab is enabled once the stages it shows
+    // have finished.
+    EXEViewer( QString const& pathOfEXEFile,
+               std::shared_ptr<ImageAnalysis> imageAnalysis,
                QWidget* parentWidget = nullptr );
+    ~EXEViewer() override;
+
+    // Stops the analysis once the tasks it is running have finished, so that
+    // a viewer about to be deleted stops taking pool threads right away.
+    void
+    cancelRemainingAnalysisStages();
+
+    // Waits for the analyses of all viewers, closed ones included, to stop;
+    // called once on shutdown after the viewers have been deleted.
+    static void
+    waitForAnalysesInFlight();
 
 private:
+    struct AnalysisRelay;
+
+    void
+    addAnalysisTab( QString const& tabTitle,
+                    AnalysisStage const requiredStage,
+                    TabBuilder&& tabBuilder );
+
+    void
+    startRemainingAnalysisStages();
+
+    void
+    onAnalysisStageFinished( AnalysisStage const finishedStage );
+
     void
-    setUpFileHeadersTab();
+    onAnalysisFailed( QString const& errorMessage );
 
     void
-    setUpSectionHeadersTab();
+    setUpFileHeadersTab( QWidget* tabRootWidget );
 
     void
-    setUpImportsTab();
+    setUpSectionHeadersTab( QWidget* tabRootWidget );
 
     void
-    setUpExportsTab();
+    setUpImportsTab( QWidget* tabRootWidget );
+
+    void
+    setUpExportsTab( QWidget* tabRootWidget );
+
+    void
+    setUpManagedMetadataTab( QWidget* tabRootWidget );
+
+    void
+    setUpStringsTab( QWidget* tabRootWidget );
+
+    void
+    setUpHexTab( QWidget* tabRootWidget );
+
+    std::vector<ImportReference> const&
+    getImportReferences();
 
 private:
-    EXEFile    m_loadedEXEFile;
+    QString                                          m_pathOfEXEFile;
+    std::shared_ptr<ImageAnalysis>                   m_imageAnalysis;
+    EXEFile const&                                   m_loadedEXEFile;
+    std::shared_ptr<AnalysisRelay>                   m_analysisRelay;
+    std::vector<std::pair<int, AnalysisStage>>       m_tabsAwaitingStage;
+    std::optional<std::vector<ImportReference>>      m_importReferences;
 };
 
 #endif // EXEVIEWER_H
\ No newline at end of file
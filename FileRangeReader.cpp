@@ -0,0 +1,103 @@
+
+#include "FileRangeReader.h"
+
+#include "Instrumentation.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+FileRangeReader::FileRangeReader( std::string const& pathOfFile )
+: m_pathOfFile( pathOfFile )
+{
+#ifdef _WIN32
+    m_file.open( pathOfFile, std::ios::binary );
+    auto const isOpen = m_file.is_open();
+    m_fileSizeInBytes = isOpen ? static_cast<std::uint64_t>( m_file.seekg( 0, std::ios::end ).tellg() ) : 0;
+#else
+    m_fileDescriptor = open( pathOfFile.c_str(), O_RDONLY | O_CLOEXEC );
+    struct stat fileStatus = {};
+    auto const isOpen = m_fileDescriptor >= 0 and fstat( m_fileDescriptor, &fileStatus ) == 0;
+    m_fileSizeInBytes = isOpen ? static_cast<std::uint64_t>( fileStatus.st_size ) : 0;
+#endif
+
+    if ( not isOpen )
+    {
+#ifndef _WIN32
+        if ( m_fileDescriptor >= 0 )
+        {
+            close( m_fileDescriptor );
+        }
+#endif
+        throw std::runtime_error{ "Failed to open '" + pathOfFile + "'." };
+    }
+}
+
+FileRangeReader::~FileRangeReader()
+{
+#ifndef _WIN32
+    close( m_fileDescriptor );
+#endif
+}
+
+std::vector<unsigned char>
+FileRangeReader::read( std::uint64_t const offset,
+                       std::size_t const sizeInBytes )
+{
+    auto const readSizeInBytes =
+        offset < m_fileSizeInBytes ? static_cast<std::size_t>( std::min<std::uint64_t>( sizeInBytes, m_fileSizeInBytes - offset ) )
+                                   : std::size_t{ 0 };
+    auto bytes = std::vector<unsigned char>( readSizeInBytes );
+
+    readInto( offset, bytes );
+
+    Instrumentation::addToCounter( Instrumentation::Counter::Allocations );
+
+    return bytes;
+}
+
+std::size_t
+FileRangeReader::readInto( std::uint64_t const offset,
+                           std::span<unsigned char> const destination )
+{
+    auto const readSizeInBytes =
+        offset < m_fileSizeInBytes ? static_cast<std::size_t>( std::min<std::uint64_t>( destination.size(), m_fileSizeInBytes - offset ) )
+                                   : std::size_t{ 0 };
+
+#ifdef _WIN32
+    auto const lock = std::lock_guard{ m_fileMutex };
+
+    auto const isRead =
+        readSizeInBytes == 0
+        or m_file.seekg( static_cast<std::streamoff>( offset ) )
+                 .read( reinterpret_cast<char*>( destination.data() ), static_cast<std::streamsize>( readSizeInBytes ) );
+#else
+    auto numberOfReadBytes = std::size_t{ 0 };
+    while ( numberOfReadBytes < readSizeInBytes )
+    {
+        auto const result = pread( m_fileDescriptor, destination.data() + numberOfReadBytes, readSizeInBytes - numberOfReadBytes,
+                                   static_cast<off_t>( offset + numberOfReadBytes ) );
+        if ( result <= 0 )
+        {
+            break;
+        }
+
+        numberOfReadBytes += static_cast<std::size_t>( result );
+    }
+    auto const isRead = numberOfReadBytes == readSizeInBytes;
+#endif
+
+    if ( not isRead )
+    {
+        throw std::runtime_error{ "Failed to read '" + m_pathOfFile + "'." };
+    }
+
+    Instrumentation::addToCounter( Instrumentation::Counter::BytesRead, readSizeInBytes );
+
+    return readSizeInBytes;
+}
\ No newline at end of file
@@ -0,0 +1,54 @@
+
+#ifndef FILERANGEREADER_H
+#define FILERANGEREADER_H
+
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <span>
+#include <string>
+#include <vector>
+
+// Reads byte ranges of a file without reading anything around them, so
+// triage of a file on network storage costs a few kilobytes rather than
+// the whole file. Reads may be issued from several threads at once.
+class FileRangeReader
+{
+public:
+    // Throws std::runtime_error when the file cannot be opened.
+    explicit FileRangeReader( std::string const& pathOfFile );
+    ~FileRangeReader();
+
+    FileRangeReader( FileRangeReader const& ) = delete;
+    FileRangeReader& operator=( FileRangeReader const& ) = delete;
+
+    std::uint64_t
+    getFileSizeInBytes() const
+    {
+        return m_fileSizeInBytes;
+    }
+
+    // Reads up to sizeInBytes bytes; fewer when the range runs past the
+    // end of the file. Throws std::runtime_error when the read fails.
+    std::vector<unsigned char>
+    read( std::uint64_t const offset,
+          std::size_t const sizeInBytes );
+
+    // Fills the front of the destination like read() and returns how many
+    // bytes it read.
+    std::size_t
+    readInto( std::uint64_t const offset,
+              std::span<unsigned char> const destination );
+
+private:
+    std::string      m_pathOfFile;
+    std::uint64_t    m_fileSizeInBytes = 0;
+#ifdef _WIN32
+    std::mutex       m_fileMutex;
+    std::ifstream    m_file;
+#else
+    int              m_fileDescriptor = -1;
+#endif
+};
+
+#endif // FILERANGEREADER_H
\ No newline at end of file
@@ -0,0 +1,306 @@
+
+#include "FileRegions.h"
+
+#include <algorithm>
+#include <optional>
+
+namespace
+{
+    auto const exportTableIdx = 0;
+    auto const importTableIdx = 1;
+    auto const ordinalFlag64 = std::uint64_t{ 1 } << 63;
+    auto const sizeOfCOFFRelocationInBytes = std::uint64_t{ 10 };
+
+    class FileRegionCollector
+    {
+    public:
+        explicit FileRegionCollector( PE::ByteReader const& rawBytes )
+        : m_rawBytes( rawBytes )
+        {
+        }
+
+        void
+        add( std::uint64_t const fileOffset,
+             std::uint64_t const sizeInBytes,
+             FileRegionKind const kind,
+             std::string description )
+        {
+            if ( sizeInBytes == 0 or not m_rawBytes.contains( fileOffset, sizeInBytes ) )
+            {
+                return;
+            }
+
+            m_fileRegions.push_back( FileRegion
+                                     {
+                                        .fileOffset = fileOffset,
+                                        .sizeInBytes = sizeInBytes,
+                                        .kind = kind,
+                                        .description = std::move( description )
+                                     } );
+        }
+
+        std::vector<FileRegion>
+        takeSortedRegions()
+        {
+            std::stable_sort( m_fileRegions.begin(), m_fileRegions.end(),
+                              []( FileRegion const& lhs, FileRegion const& rhs )
+                              {
+                                  return lhs.fileOffset < rhs.fileOffset;
+                              } );
+
+            return std::move( m_fileRegions );
+        }
+
+    private:
+        PE::ByteReader             m_rawBytes;
+        std::vector<FileRegion>    m_fileRegions;
+    };
+
+    std::uint64_t
+    countThunks( PE::ByteReader const& rawBytes,
+                 std::uint64_t const thunkTableOffset )
+    {
+        auto numberOfThunks = std::uint64_t{ 0 };
+
+        while ( true )
+        {
+            auto const thunk = rawBytes.read<std::uint64_t>( thunkTableOffset + numberOfThunks * sizeof( std::uint64_t ) );
+
+            if ( not thunk or *thunk == 0 )
+            {
+                return numberOfThunks;
+            }
+
+            numberOfThunks++;
+        }
+    }
+
+    void
+    addImportRegions( FileRegionCollector& fileRegionCollector,
+                      PE::ByteReader const& rawBytes,
+                      EXEFile const& loadedEXEFile )
+    {
+        auto const& dataDirectoryEntries = loadedEXEFile.dataDirectoryEntries;
+        auto const& sectionHeaders = loadedEXEFile.sectionHeadersNameToInfo;
+
+        if (    dataDirectoryEntries.size() <= importTableIdx
+             or dataDirectoryEntries[importTableIdx].dataDirectoryRVA == 0 )
+        {
+            return;
+        }
+
+        auto const importDescriptorsOffset =
+            PE::convertRVAToFileOffset( sectionHeaders, dataDirectoryEntries[importTableIdx].dataDirectoryRVA );
+
+        if ( not importDescriptorsOffset )
+        {
+            return;
+        }
+
+        auto numberOfImportDescriptors = std::uint64_t{ 0 };
+
+        while ( true )
+        {
+            auto const importDescriptor =
+                rawBytes.read<PE::ImportDirectoryTableEntry>( *importDescriptorsOffset +
+                                                              numberOfImportDescriptors * sizeof( PE::ImportDirectoryTableEntry ) );
+
+            // Only an all-zero descriptor ends the table, as in the parser; a
+            // descriptor may lack its lookup table and still have an IAT.
+            if (    not importDescriptor
+                 or (     importDescriptor->importLookupTableRVA == 0
+                      and importDescriptor->timestamp == 0
+                      and importDescriptor->forwarderChainIdx == 0
+                      and importDescriptor->namestringRVA == 0
+                      and importDescriptor->importAddressTableRVA == 0 ) )
+            {
+                break;
+            }
+
+            numberOfImportDescriptors++;
+
+            auto const dllNameOffset = PE::convertRVAToFileOffset( sectionHeaders, importDescriptor->namestringRVA );
+            auto const dllName =
+                dllNameOffset ? rawBytes.readNullTerminatedString( *dllNameOffset ) : std::nullopt;
+            auto const displayedDLLName = dllName.value_or( "<unnamed DLL>" );
+
+            if ( dllName )
+            {
+                fileRegionCollector.add( *dllNameOffset, dllName->size() + 1,
+                                         FileRegionKind::ImportNames,
+                                         "Imported DLL name '" + *dllName + "'" );
+            }
+
+            auto const importLookupTableOffset =
+                importDescriptor->importLookupTableRVA != 0
+                    ? PE::convertRVAToFileOffset( sectionHeaders, importDescriptor->importLookupTableRVA )
+                    : std::nullopt;
+            auto const importAddressTableOffset =
+                PE::convertRVAToFileOffset( sectionHeaders, importDescriptor->importAddressTableRVA );
+
+            if ( importLookupTableOffset )
+            {
+                fileRegionCollector.add( *importLookupTableOffset, ( countThunks( rawBytes, *importLookupTableOffset ) + 1 ) * sizeof( std::uint64_t ),
+                                         FileRegionKind::ImportThunks,
+                                         "Import lookup table of " + displayedDLLName );
+            }
+
+            // On disk the IAT holds the same thunks as the lookup table, so
+            // the names are found through it when there is no lookup table.
+            auto const thunksOffset = importLookupTableOffset ? importLookupTableOffset : importAddressTableOffset;
+
+            if ( thunksOffset )
+            {
+                auto const numberOfThunks = countThunks( rawBytes, *thunksOffset );
+
+                for ( auto i = std::uint64_t{ 0 }; i < numberOfThunks; i++ )
+                {
+                    auto const thunk = *rawBytes.read<std::uint64_t>( *thunksOffset + i * sizeof( std::uint64_t ) );
+
+                    if ( thunk & ordinalFlag64 )
+                    {
+                        continue;
+                    }
+
+                    auto const hintNameOffset =
+                        PE::convertRVAToFileOffset( sectionHeaders, thunk & 0x7FFFFFFF );
+                    auto const importedFunctionName =
+                        hintNameOffset ? rawBytes.readNullTerminatedString( *hintNameOffset + sizeof( std::uint16_t ) )
+                                       : std::nullopt;
+
+                    if ( importedFunctionName )
+                    {
+                        fileRegionCollector.add( *hintNameOffset, sizeof( std::uint16_t ) + importedFunctionName->size() + 1,
+                                                 FileRegionKind::ImportNames,
+                                                 "Hint/name of " + displayedDLLName + "!" + *importedFunctionName );
+                    }
+                }
+            }
+
+            if ( importAddressTableOffset )
+            {
+                fileRegionCollector.add( *importAddressTableOffset,
+                                         ( countThunks( rawBytes, *importAddressTableOffset ) + 1 ) * sizeof( std::uint64_t ),
+                                         FileRegionKind::ImportThunks,
+                                         "Import address table of " + displayedDLLName );
+            }
+        }
+
+        fileRegionCollector.add( *importDescriptorsOffset,
+                                 ( numberOfImportDescriptors + 1 ) * sizeof( PE::ImportDirectoryTableEntry ),
+                                 FileRegionKind::ImportDescriptors,
+                                 "Import descriptors (" + std::to_string( numberOfImportDescriptors ) + " DLLs)" );
+    }
+
+    void
+    addExportRegions( FileRegionCollector& fileRegionCollector,
+                      PE::ByteReader const& rawBytes,
+                      EXEFile const& loadedEXEFile )
+    {
+        auto const& dataDirectoryEntries = loadedEXEFile.dataDirectoryEntries;
+        auto const& sectionHeaders = loadedEXEFile.sectionHeadersNameToInfo;
+
+        if (    dataDirectoryEntries.size() <= exportTableIdx
+             or dataDirectoryEntries[exportTableIdx].dataDirectoryRVA == 0 )
+        {
+            return;
+        }
+
+        auto const exportDirectoryOffset =
+            PE::convertRVAToFileOffset( sectionHeaders, dataDirectoryEntries[exportTableIdx].dataDirectoryRVA );
+        auto const exportDirectory =
+            exportDirectoryOffset ? rawBytes.read<PE::ExportDirectoryTableEntry>( *exportDirectoryOffset ) : std::nullopt;
+
+        if ( not exportDirectory )
+        {
+            return;
+        }
+
+        fileRegionCollector.add( *exportDirectoryOffset, sizeof( PE::ExportDirectoryTableEntry ),
+                                 FileRegionKind::ExportDirectory, "Export directory" );
+
+        auto const addExportTable =
+            [&]( std::uint32_t const tableRVA,
+                 std::uint64_t const tableSizeInBytes,
+                 char const* tableDescription )
+            {
+                auto const tableOffset = PE::convertRVAToFileOffset( sectionHeaders, tableRVA );
+
+                if ( tableOffset )
+                {
+                    fileRegionCollector.add( *tableOffset, tableSizeInBytes,
+                                             FileRegionKind::ExportDirectory, tableDescription );
+                }
+            };
+
+        addExportTable( exportDirectory->exportAddressTableRVA,
+                        std::uint64_t{ exportDirectory->numberOfExportAddressTableEntries } * sizeof( std::uint32_t ),
+                        "Export address table" );
+        addExportTable( exportDirectory->namePointerTableRVA,
+                        std::uint64_t{ exportDirectory->numberOfNamePointerTableEntries } * sizeof( std::uint32_t ),
+                        "Export name pointer table" );
+        addExportTable( exportDirectory->ordinalTableRVA,
+                        std::uint64_t{ exportDirectory->numberOfNamePointerTableEntries } * sizeof( std::uint16_t ),
+                        "Export ordinal table" );
+    }
+}
+
+std::vector<FileRegion>
+getKnownFileRegions( PE::ByteReader const& rawBytes,
+                     EXEFile const& loadedEXEFile )
+{
+    auto fileRegionCollector = FileRegionCollector{ rawBytes };
+
+    auto const ntSignatureOffset = std::uint64_t{ loadedEXEFile.dosHeader.offsetOfNTSignature };
+    auto const ntFileHeaderOffset = ntSignatureOffset + sizeof( loadedEXEFile.ntSignature );
+    auto const ntOptionalHeaderOffset = ntFileHeaderOffset + sizeof( PE::NTFileHeader );
+    auto const dataDirectoryEntriesOffset = ntOptionalHeaderOffset + sizeof( PE::NTOptionalHeader64 );
+    auto const dataDirectoryEntriesSizeInBytes =
+        loadedEXEFile.dataDirectoryEntries.size() * sizeof( PE::DataDirectoryEntry );
+    auto const sectionHeaderTableOffset = dataDirectoryEntriesOffset + dataDirectoryEntriesSizeInBytes;
+
+    fileRegionCollector.add( 0, sizeof( PE::DOSHeader ),
+                             FileRegionKind::Header, "DOS header" );
+    fileRegionCollector.add( ntSignatureOffset, sizeof( loadedEXEFile.ntSignature ),
+                             FileRegionKind::Header, "NT signature" );
+    fileRegionCollector.add( ntFileHeaderOffset, sizeof( PE::NTFileHeader ),
+                             FileRegionKind::Header, "NT file header" );
+    fileRegionCollector.add( ntOptionalHeaderOffset, sizeof( PE::NTOptionalHeader64 ),
+                             FileRegionKind::Header, "NT optional header" );
+    fileRegionCollector.add( dataDirectoryEntriesOffset, dataDirectoryEntriesSizeInBytes,
+                             FileRegionKind::DataDirectories, "Data directories" );
+    fileRegionCollector.add( sectionHeaderTableOffset,
+                             std::uint64_t{ loadedEXEFile.ntFileHeader.numberOfSections } * sizeof( PE::SectionHeader ),
+                             FileRegionKind::SectionTable, "Section headers" );
+
+    addImportRegions( fileRegionCollector, rawBytes, loadedEXEFile );
+    addExportRegions( fileRegionCollector, rawBytes, loadedEXEFile );
+
+    return fileRegionCollector.takeSortedRegions();
+}
+
+std::vector<FileRegion>
+getKnownFileRegions( PE::ByteReader const& rawBytes,
+                     OBJFile const& loadedOBJFile )
+{
+    auto fileRegionCollector = FileRegionCollector{ rawBytes };
+
+    fileRegionCollector.add( 0, sizeof( PE::NTFileHeader ),
+                             FileRegionKind::Header, "NT file header" );
+    fileRegionCollector.add( sizeof( PE::NTFileHeader ),
+                             std::uint64_t{ loadedOBJFile.ntFileHeader.numberOfSections } * sizeof( PE::SectionHeader ),
+                             FileRegionKind::SectionTable, "Section headers" );
+
+    for ( auto const& [sectionName, sectionHeaders] : loadedOBJFile.sectionHeaders )
+    {
+        for ( auto const& sectionHeader : sectionHeaders )
+        {
+            fileRegionCollector.add( sectionHeader.pointerToRelocations,
+                                     sectionHeader.numberOfRelocations * sizeOfCOFFRelocationInBytes,
+                                     FileRegionKind::Relocations,
+                                     "Relocations of " + sectionName );
+        }
+    }
+
+    return fileRegionCollector.takeSortedRegions();
+}
\ No newline at end of file
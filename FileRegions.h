@@ -0,0 +1,41 @@
+
+#ifndef FILEREGIONS_H
+#define FILEREGIONS_H
+
+#include "PEFiles.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+enum class FileRegionKind
+{
+    Header,
+    DataDirectories,
+    SectionTable,
+    ImportDescriptors,
+    ImportThunks,
+    ImportNames,
+    ExportDirectory,
+    Relocations
+};
+
+struct FileRegion
+{
+    std::uint64_t     fileOffset;
+    std::uint64_t     sizeInBytes;
+    FileRegionKind    kind;
+    std::string       description;
+};
+
+// Returns the well-known structures of a file sorted by file offset, so a
+// viewer can look up the region under a byte with a binary search.
+std::vector<FileRegion>
+getKnownFileRegions( PE::ByteReader const& rawBytes,
+                     EXEFile const& loadedEXEFile );
+
+std::vector<FileRegion>
+getKnownFileRegions( PE::ByteReader const& rawBytes,
+                     OBJFile const& loadedOBJFile );
+
+#endif // FILEREGIONS_H
\ No newline at end of file
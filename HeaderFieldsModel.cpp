@@ -0,0 +1,77 @@
+
+#include "HeaderFieldsModel.h"
+
+#include <QHeaderView>
+#include <QTableView>
+
+#include <utility>
+
+HeaderFieldsModel::HeaderFieldsModel( std::vector<Column>&& columns,
+                                      QObject* parentObject )
+: QAbstractTableModel( parentObject )
+, m_columns( std::move( columns ) )
+{
+}
+
+int
+HeaderFieldsModel::rowCount( QModelIndex const& parentIndex ) const
+{
+    if ( parentIndex.isValid() or m_columns.empty() )
+    {
+        return 0;
+    }
+
+    return static_cast<int>( m_columns.front().fieldRows.size() );
+}
+
+int
+HeaderFieldsModel::columnCount( QModelIndex const& parentIndex ) const
+{
+    return parentIndex.isValid() ? 0 : static_cast<int>( m_columns.size() );
+}
+
+QVariant
+HeaderFieldsModel::data( QModelIndex const& index,
+                         int const role ) const
+{
+    if ( not index.isValid() or role != Qt::DisplayRole )
+    {
+        return QVariant();
+    }
+
+    auto const& fieldRow = m_columns[index.column()].fieldRows[index.row()];
+    return QString::fromStdString( fieldRow.value );
+}
+
+QVariant
+HeaderFieldsModel::headerData( int const section,
+                               Qt::Orientation const orientation,
+                               int const role ) const
+{
+    if ( role != Qt::DisplayRole or m_columns.empty() )
+    {
+        return QVariant();
+    }
+
+    if ( orientation == Qt::Horizontal )
+    {
+        return m_columns[section].name;
+    }
+
+    return QString::fromStdString( m_columns.front().fieldRows[section].name );
+}
+
+QTableView*
+createHeaderFieldsView( HeaderFieldsModel* headerFieldsModel )
+{
+    auto headerFieldsView = new QTableView;
+    headerFieldsModel->setParent( headerFieldsView );
+    headerFieldsView->setModel( headerFieldsModel );
+    headerFieldsView->setEditTriggers( QAbstractItemView::NoEditTriggers );
+    headerFieldsView->setWordWrap( false );
+    headerFieldsView->verticalHeader()->setSectionResizeMode( QHeaderView::ResizeToContents );
+    headerFieldsView->horizontalHeader()->setSectionResizeMode( QHeaderView::ResizeToContents );
+    headerFieldsView->setSizeAdjustPolicy( QAbstractScrollArea::AdjustToContents );
+
+    return headerFieldsView;
+}
\ No newline at end of file
@@ -0,0 +1,52 @@
+
+#ifndef HEADERFIELDSMODEL_H
+#define HEADERFIELDSMODEL_H
+
+#include "PEFieldDescriptors.h"
+
+#include <QAbstractTableModel>
+
+#include <vector>
+
+class QTableView;
+
+// Shows one or more decoded headers of the same kind side by side: a row per
+// field of the descriptor table and a column per header, e.g. per section.
+class HeaderFieldsModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    struct Column
+    {
+        QString                      name;
+        std::vector<PE::FieldRow>    fieldRows;
+    };
+
+    explicit HeaderFieldsModel( std::vector<Column>&& columns,
+                                QObject* parentObject = nullptr );
+
+    int
+    rowCount( QModelIndex const& parentIndex = QModelIndex() ) const override;
+
+    int
+    columnCount( QModelIndex const& parentIndex = QModelIndex() ) const override;
+
+    QVariant
+    data( QModelIndex const& index,
+          int const role = Qt::DisplayRole ) const override;
+
+    QVariant
+    headerData( int const section,
+                Qt::Orientation const orientation,
+                int const role = Qt::DisplayRole ) const override;
+
+private:
+    std::vector<Column>    m_columns;
+};
+
+// A read-only view sized to its contents, taking ownership of the model.
+QTableView*
+createHeaderFieldsView( HeaderFieldsModel* headerFieldsModel );
+
+#endif // HEADERFIELDSMODEL_H
\ No newline at end of file
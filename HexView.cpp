@@ -0,0 +1,320 @@
+
+#include "HexView.h"
+
+#include <QFontDatabase>
+#include <QHelpEvent>
+#include <QMouseEvent>
+#include <QPainter>
+#include <QScrollBar>
+#include <QToolTip>
+
+#include <algorithm>
+#include <climits>
+
+namespace
+{
+    auto const bytesPerRow = 16;
+    auto const separatorWidthInCharacters = 2;
+    auto const hexColumnsWidthInCharacters = bytesPerRow * 3 + 1;
+    auto const leftMarginInPixels = 4;
+
+    // A malformed file can describe overlapping structures; only this many
+    // earlier regions are examined when looking for one that covers a byte.
+    auto const maximumNumberOfOverlappingRegions = 8;
+
+    char const hexDigits[] = "0123456789ABCDEF";
+
+    int
+    getHexColumn( int const numberOfOffsetDigits,
+                  int const byteIdxInRow )
+    {
+        return numberOfOffsetDigits + separatorWidthInCharacters +
+               byteIdxInRow * 3 + ( byteIdxInRow >= bytesPerRow / 2 ? 1 : 0 );
+    }
+
+    int
+    getASCIIColumn( int const numberOfOffsetDigits,
+                    int const byteIdxInRow )
+    {
+        return numberOfOffsetDigits + separatorWidthInCharacters +
+               hexColumnsWidthInCharacters + 1 + byteIdxInRow;
+    }
+}
+
+HexView::HexView( QWidget* parentWidget )
+: QAbstractScrollArea( parentWidget )
+{
+    setFont( QFontDatabase::systemFont( QFontDatabase::FixedFont ) );
+
+    m_characterWidth = std::max( 1, fontMetrics().horizontalAdvance( QLatin1Char( '0' ) ) );
+    m_rowHeight = std::max( 1, fontMetrics().height() );
+
+    viewport()->setMouseTracking( true );
+}
+
+void
+HexView::setBytes( unsigned char const* bytes,
+                   std::uint64_t const sizeInBytes )
+{
+    m_bytes = bytes;
+    m_sizeInBytes = sizeInBytes;
+    m_numberOfOffsetDigits = sizeInBytes > 0xFFFFFFFF ? 16 : 8;
+    m_markedOffset.reset();
+
+    updateScrollBars();
+    viewport()->update();
+}
+
+void
+HexView::setFileRegions( std::vector<FileRegion>&& fileRegions )
+{
+    m_fileRegions = std::move( fileRegions );
+
+    viewport()->update();
+}
+
+void
+HexView::jumpToOffset( std::uint64_t const fileOffset )
+{
+    if ( fileOffset >= m_sizeInBytes )
+    {
+        return;
+    }
+
+    m_markedOffset = fileOffset;
+
+    auto const rowOfOffset = static_cast<int>( std::min<std::uint64_t>( fileOffset / bytesPerRow, INT_MAX ) );
+    auto const numberOfVisibleRows = viewport()->height() / m_rowHeight;
+    verticalScrollBar()->setValue( rowOfOffset - numberOfVisibleRows / 3 );
+
+    viewport()->update();
+}
+
+QColor
+HexView::getFileRegionColor( FileRegionKind const fileRegionKind )
+{
+    switch ( fileRegionKind )
+    {
+        case FileRegionKind::Header:
+            return QColor( 0xB3, 0xD4, 0xFC );
+        case FileRegionKind::DataDirectories:
+            return QColor( 0xC9, 0xE4, 0xCA );
+        case FileRegionKind::SectionTable:
+            return QColor( 0xF9, 0xE0, 0xA8 );
+        case FileRegionKind::ImportDescriptors:
+            return QColor( 0xF4, 0xB6, 0xB6 );
+        case FileRegionKind::ImportThunks:
+            return QColor( 0xE6, 0xC9, 0xF2 );
+        case FileRegionKind::ImportNames:
+            return QColor( 0xF2, 0xE6, 0xD9 );
+        case FileRegionKind::ExportDirectory:
+            return QColor( 0xB8, 0xE8, 0xE0 );
+        case FileRegionKind::Relocations:
+            return QColor( 0xE0, 0xE0, 0xE0 );
+        default:
+            return QColor();
+    }
+}
+
+void
+HexView::paintEvent( QPaintEvent* )
+{
+    auto painter = QPainter( viewport() );
+    painter.fillRect( viewport()->rect(), palette().base() );
+
+    if ( m_bytes == nullptr )
+    {
+        return;
+    }
+
+    auto const firstVisibleRow = std::uint64_t( verticalScrollBar()->value() );
+    auto const numberOfVisibleRows = viewport()->height() / m_rowHeight + 1;
+    auto const xOffset = leftMarginInPixels - horizontalScrollBar()->value();
+    auto const ascent = fontMetrics().ascent();
+
+    char rowText[16 + separatorWidthInCharacters + hexColumnsWidthInCharacters + 1 + bytesPerRow];
+
+    for ( auto visibleRowIdx = 0; visibleRowIdx < numberOfVisibleRows; visibleRowIdx++ )
+    {
+        auto const rowOffset = ( firstVisibleRow + visibleRowIdx ) * bytesPerRow;
+
+        if ( rowOffset >= m_sizeInBytes )
+        {
+            break;
+        }
+
+        auto const numberOfBytesInRow =
+            static_cast<int>( std::min<std::uint64_t>( bytesPerRow, m_sizeInBytes - rowOffset ) );
+        auto const rowTop = visibleRowIdx * m_rowHeight;
+
+        // Backgrounds first: one rectangle per run of bytes sharing a region.
+        for ( auto runStart = 0; runStart < numberOfBytesInRow; )
+        {
+            auto const fileRegion = getFileRegionAtOffset( rowOffset + runStart );
+            auto runEnd = runStart + 1;
+
+            while ( runEnd < numberOfBytesInRow and getFileRegionAtOffset( rowOffset + runEnd ) == fileRegion )
+            {
+                runEnd++;
+            }
+
+            if ( fileRegion != nullptr )
+            {
+                auto const regionColor = getFileRegionColor( fileRegion->kind );
+                auto const hexLeft = getHexColumn( m_numberOfOffsetDigits, runStart );
+                auto const hexRight = getHexColumn( m_numberOfOffsetDigits, runEnd - 1 ) + 2;
+                auto const asciiLeft = getASCIIColumn( m_numberOfOffsetDigits, runStart );
+
+                painter.fillRect( xOffset + hexLeft * m_characterWidth, rowTop,
+                                  ( hexRight - hexLeft ) * m_characterWidth, m_rowHeight,
+                                  regionColor );
+                painter.fillRect( xOffset + asciiLeft * m_characterWidth, rowTop,
+                                  ( runEnd - runStart ) * m_characterWidth, m_rowHeight,
+                                  regionColor );
+            }
+
+            runStart = runEnd;
+        }
+
+        if ( m_markedOffset and *m_markedOffset / bytesPerRow == rowOffset / bytesPerRow )
+        {
+            auto const markedByteIdx = static_cast<int>( *m_markedOffset % bytesPerRow );
+
+            painter.setPen( palette().highlight().color() );
+            painter.drawRect( xOffset + getHexColumn( m_numberOfOffsetDigits, markedByteIdx ) * m_characterWidth, rowTop,
+                              2 * m_characterWidth - 1, m_rowHeight - 1 );
+            painter.drawRect( xOffset + getASCIIColumn( m_numberOfOffsetDigits, markedByteIdx ) * m_characterWidth, rowTop,
+                              m_characterWidth - 1, m_rowHeight - 1 );
+        }
+
+        auto const rowLength = getASCIIColumn( m_numberOfOffsetDigits, bytesPerRow );
+        std::fill( rowText, rowText + rowLength, ' ' );
+
+        for ( auto digitIdx = 0; digitIdx < m_numberOfOffsetDigits; digitIdx++ )
+        {
+            rowText[m_numberOfOffsetDigits - 1 - digitIdx] = hexDigits[( rowOffset >> ( 4 * digitIdx ) ) & 0xF];
+        }
+
+        for ( auto byteIdx = 0; byteIdx < numberOfBytesInRow; byteIdx++ )
+        {
+            auto const byteValue = m_bytes[rowOffset + byteIdx];
+            auto const hexColumn = getHexColumn( m_numberOfOffsetDigits, byteIdx );
+
+            rowText[hexColumn] = hexDigits[byteValue >> 4];
+            rowText[hexColumn + 1] = hexDigits[byteValue & 0xF];
+            rowText[getASCIIColumn( m_numberOfOffsetDigits, byteIdx )] =
+                byteValue >= 0x20 and byteValue < 0x7F ? static_cast<char>( byteValue ) : '.';
+        }
+
+        painter.setPen( palette().text().color() );
+        painter.drawText( xOffset, rowTop + ascent, QString::fromLatin1( rowText, rowLength ) );
+    }
+}
+
+void
+HexView::resizeEvent( QResizeEvent* resizeEvent )
+{
+    QAbstractScrollArea::resizeEvent( resizeEvent );
+
+    updateScrollBars();
+}
+
+bool
+HexView::viewportEvent( QEvent* viewportEvent )
+{
+    if ( viewportEvent->type() == QEvent::ToolTip )
+    {
+        auto const helpEvent = static_cast<QHelpEvent*>( viewportEvent );
+        auto const fileOffset = getOffsetAtPosition( helpEvent->pos() );
+        auto const fileRegion = fileOffset ? getFileRegionAtOffset( *fileOffset ) : nullptr;
+
+        if ( fileRegion != nullptr )
+        {
+            QToolTip::showText( helpEvent->globalPos(),
+                                QString( "%1\n0x%2 - 0x%3" )
+                                    .arg( QString::fromStdString( fileRegion->description ) )
+                                    .arg( fileRegion->fileOffset, 8, 16, QChar( '0' ) )
+                                    .arg( fileRegion->fileOffset + fileRegion->sizeInBytes - 1, 8, 16, QChar( '0' ) ),
+                                viewport() );
+        }
+        else
+        {
+            QToolTip::hideText();
+            viewportEvent->ignore();
+        }
+
+        return true;
+    }
+
+    return QAbstractScrollArea::viewportEvent( viewportEvent );
+}
+
+void
+HexView::mousePressEvent( QMouseEvent* mouseEvent )
+{
+    m_markedOffset = getOffsetAtPosition( mouseEvent->position().toPoint() );
+
+    viewport()->update();
+}
+
+void
+HexView::updateScrollBars()
+{
+    auto const numberOfRows =
+        static_cast<int>( std::min<std::uint64_t>( ( m_sizeInBytes + bytesPerRow - 1 ) / bytesPerRow, INT_MAX ) );
+    auto const numberOfVisibleRows = viewport()->height() / m_rowHeight;
+
+    verticalScrollBar()->setRange( 0, std::max( 0, numberOfRows - numberOfVisibleRows ) );
+    verticalScrollBar()->setPageStep( std::max( 1, numberOfVisibleRows ) );
+
+    auto const rowWidthInPixels =
+        leftMarginInPixels + getASCIIColumn( m_numberOfOffsetDigits, bytesPerRow ) * m_characterWidth;
+
+    horizontalScrollBar()->setRange( 0, std::max( 0, rowWidthInPixels - viewport()->width() ) );
+    horizontalScrollBar()->setPageStep( viewport()->width() );
+}
+
+std::optional<std::uint64_t>
+HexView::getOffsetAtPosition( QPoint const& viewportPosition ) const
+{
+    auto const row = std::uint64_t( verticalScrollBar()->value() ) + viewportPosition.y() / m_rowHeight;
+    auto const column =
+        ( viewportPosition.x() - leftMarginInPixels + horizontalScrollBar()->value() ) / m_characterWidth;
+
+    for ( auto byteIdx = 0; byteIdx < bytesPerRow; byteIdx++ )
+    {
+        auto const hexColumn = getHexColumn( m_numberOfOffsetDigits, byteIdx );
+
+        if (    ( column >= hexColumn and column < hexColumn + 2 )
+             or column == getASCIIColumn( m_numberOfOffsetDigits, byteIdx ) )
+        {
+            auto const fileOffset = row * bytesPerRow + byteIdx;
+
+            return fileOffset < m_sizeInBytes ? std::optional{ fileOffset } : std::nullopt;
+        }
+    }
+
+    return std::nullopt;
+}
+
+FileRegion const*
+HexView::getFileRegionAtOffset( std::uint64_t const fileOffset ) const
+{
+    auto it = std::upper_bound( m_fileRegions.begin(), m_fileRegions.end(), fileOffset,
+                                []( std::uint64_t const offset, FileRegion const& fileRegion )
+                                {
+                                    return offset < fileRegion.fileOffset;
+                                } );
+
+    for ( auto i = 0; i < maximumNumberOfOverlappingRegions and it != m_fileRegions.begin(); i++ )
+    {
+        --it;
+
+        if ( fileOffset - it->fileOffset < it->sizeInBytes )
+        {
+            return &*it;
+        }
+    }
+
+    return nullptr;
+}
\ No newline at end of file
@@ -0,0 +1,69 @@
+
+#ifndef HEXVIEW_H
+#define HEXVIEW_H
+
+#include "FileRegions.h"
+
+#include <QAbstractScrollArea>
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+// Draws rows of offset/hex/ASCII straight from a byte buffer that it does not
+// own, painting only the rows inside the viewport. Memory use is independent
+// of the buffer size, so it can sit on top of a mapped multi-GB file.
+class HexView : public QAbstractScrollArea
+{
+    Q_OBJECT
+
+public:
+    HexView( QWidget* parentWidget = nullptr );
+
+    void
+    setBytes( unsigned char const* bytes,
+              std::uint64_t const sizeInBytes );
+
+    void
+    setFileRegions( std::vector<FileRegion>&& fileRegions );
+
+    void
+    jumpToOffset( std::uint64_t const fileOffset );
+
+    static QColor
+    getFileRegionColor( FileRegionKind const fileRegionKind );
+
+protected:
+    void
+    paintEvent( QPaintEvent* paintEvent ) override;
+
+    void
+    resizeEvent( QResizeEvent* resizeEvent ) override;
+
+    bool
+    viewportEvent( QEvent* viewportEvent ) override;
+
+    void
+    mousePressEvent( QMouseEvent* mouseEvent ) override;
+
+private:
+    void
+    updateScrollBars();
+
+    std::optional<std::uint64_t>
+    getOffsetAtPosition( QPoint const& viewportPosition ) const;
+
+    FileRegion const*
+    getFileRegionAtOffset( std::uint64_t const fileOffset ) const;
+
+private:
+    unsigned char const*            m_bytes = nullptr;
+    std::uint64_t                   m_sizeInBytes = 0;
+    std::vector<FileRegion>         m_fileRegions;
+    std::optional<std::uint64_t>    m_markedOffset;
+    int                             m_numberOfOffsetDigits = 8;
+    int                             m_characterWidth = 1;
+    int                             m_rowHeight = 1;
+};
+
+#endif // HEXVIEW_H
\ No newline at end of file
@@ -0,0 +1,130 @@
+
+#include "HexViewerTab.h"
+#include "HexView.h"
+
+#include <QComboBox>
+#include <QHBoxLayout>
+#include <QLabel>
+#include <QLineEdit>
+#include <QPushButton>
+#include <QVBoxLayout>
+
+#include <utility>
+
+namespace
+{
+    auto const addressKindFileOffset = 0;
+    auto const addressKindRVA = 1;
+}
+
+HexViewerTab::HexViewerTab( QString const& pathOfFile,
+                            std::vector<JumpTarget> const& jumpTargets,
+                            FileRegionsBuilder const& fileRegionsBuilder,
+                            RVAToFileOffsetConverter&& rvaToFileOffsetConverter,
+                            QWidget* parentWidget )
+: QWidget( parentWidget )
+, m_mappedFile( pathOfFile )
+, m_rvaToFileOffsetConverter( std::move( rvaToFileOffsetConverter ) )
+{
+    auto hexViewerTabMainLayout = new QVBoxLayout( this );
+
+    auto navigationLayout = new QHBoxLayout;
+    hexViewerTabMainLayout->addLayout( navigationLayout );
+
+    auto jumpTargetSelector = new QComboBox;
+    jumpTargetSelector->addItem( "Go to section..." );
+    for ( auto const& jumpTarget : jumpTargets )
+    {
+        jumpTargetSelector->addItem( jumpTarget.name, QVariant( qulonglong{ jumpTarget.fileOffset } ) );
+    }
+    navigationLayout->addWidget( jumpTargetSelector );
+
+    m_addressKindSelector = new QComboBox;
+    m_addressKindSelector->insertItem( addressKindFileOffset, "File offset" );
+    if ( m_rvaToFileOffsetConverter )
+    {
+        m_addressKindSelector->insertItem( addressKindRVA, "RVA" );
+    }
+    navigationLayout->addWidget( m_addressKindSelector );
+
+    m_addressInput = new QLineEdit;
+    m_addressInput->setPlaceholderText( "Hex address, e.g. 0x1000" );
+    navigationLayout->addWidget( m_addressInput );
+
+    auto goButton = new QPushButton( "Go" );
+    navigationLayout->addWidget( goButton );
+
+    navigationLayout->addStretch();
+
+    m_hexView = new HexView;
+    hexViewerTabMainLayout->addWidget( m_hexView );
+
+    // The file is mapped rather than read so that scrolling a large file only
+    // touches the pages being painted.
+    auto const mappedBytes =
+        m_mappedFile.open( QIODevice::ReadOnly ) ? m_mappedFile.map( 0, m_mappedFile.size() ) : nullptr;
+
+    if ( mappedBytes == nullptr )
+    {
+        hexViewerTabMainLayout->insertWidget( 0, new QLabel( QString( "'%1' could not be mapped: %2" )
+                                                                 .arg( pathOfFile )
+                                                                 .arg( m_mappedFile.errorString() ) ) );
+        return;
+    }
+
+    auto const mappedFileSizeInBytes = static_cast<std::uint64_t>( m_mappedFile.size() );
+
+    m_hexView->setBytes( mappedBytes, mappedFileSizeInBytes );
+    m_hexView->setFileRegions( fileRegionsBuilder( PE::ByteReader{ mappedBytes, mappedFileSizeInBytes } ) );
+
+    connect( jumpTargetSelector, &QComboBox::activated,
+             [this, jumpTargetSelector]( int const jumpTargetIdx )
+             {
+                if ( jumpTargetIdx > 0 )
+                {
+                    m_hexView->jumpToOffset( jumpTargetSelector->itemData( jumpTargetIdx ).toULongLong() );
+                    m_hexView->setFocus();
+                }
+             } );
+
+    connect( m_addressInput, &QLineEdit::returnPressed,
+             [this]()
+             {
+                jumpToEnteredAddress();
+             } );
+
+    connect( goButton, &QPushButton::clicked,
+             [this]()
+             {
+                jumpToEnteredAddress();
+             } );
+}
+
+void
+HexViewerTab::jumpToEnteredAddress()
+{
+    auto enteredAddress = m_addressInput->text().trimmed();
+    if ( enteredAddress.startsWith( "0x", Qt::CaseInsensitive ) )
+    {
+        enteredAddress.remove( 0, 2 );
+    }
+
+    auto isValidAddress = false;
+    auto const address = enteredAddress.toULongLong( &isValidAddress, 16 );
+
+    auto const fileOffset =
+        not isValidAddress
+            ? std::nullopt
+            : m_addressKindSelector->currentIndex() == addressKindRVA
+                ? m_rvaToFileOffsetConverter( address )
+                : std::optional<std::uint64_t>{ address };
+
+    if ( not fileOffset )
+    {
+        m_addressInput->setStyleSheet( "color: red" );
+        return;
+    }
+
+    m_addressInput->setStyleSheet( QString() );
+    m_hexView->jumpToOffset( *fileOffset );
+}
\ No newline at end of file
@@ -0,0 +1,52 @@
+
+#ifndef HEXVIEWERTAB_H
+#define HEXVIEWERTAB_H
+
+#include "FileRegions.h"
+
+#include <QFile>
+#include <QPointer>
+#include <QWidget>
+
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <vector>
+
+class HexView;
+class QComboBox;
+class QLineEdit;
+
+class HexViewerTab : public QWidget
+{
+    Q_OBJECT
+
+public:
+    struct JumpTarget
+    {
+        QString          name;
+        std::uint64_t    fileOffset;
+    };
+
+    using FileRegionsBuilder = std::function<std::vector<FileRegion>( PE::ByteReader const& mappedBytes )>;
+    using RVAToFileOffsetConverter = std::function<std::optional<std::uint64_t>( std::uint64_t const rva )>;
+
+    HexViewerTab( QString const& pathOfFile,
+                  std::vector<JumpTarget> const& jumpTargets,
+                  FileRegionsBuilder const& fileRegionsBuilder,
+                  RVAToFileOffsetConverter&& rvaToFileOffsetConverter,
+                  QWidget* parentWidget = nullptr );
+
+private:
+    void
+    jumpToEnteredAddress();
+
+private:
+    QFile                       m_mappedFile;
+    QPointer<HexView>           m_hexView;
+    QPointer<QComboBox>         m_addressKindSelector;
+    QPointer<QLineEdit>         m_addressInput;
+    RVAToFileOffsetConverter    m_rvaToFileOffsetConverter;
+};
+
+#endif // HEXVIEWERTAB_H
\ No newline at end of file
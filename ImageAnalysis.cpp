@@ -0,0 +1,321 @@
+
+#include "ImageAnalysis.h"
+
+#include "FileRangeReader.h"
+#include "Instrumentation.h"
+#include "TaskGraph.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <span>
+#include <stdexcept>
+
+namespace
+{
+    // Large enough that scheduling a chunk costs nothing next to reading and
+    // hashing it, small enough that a 2 GB section keeps every worker busy.
+    auto const sectionChunkSizeInBytes = std::size_t{ 4 } << 20;
+
+    using ByteHistogram = std::array<std::uint32_t, 256>;
+
+    struct ChunkDigest
+    {
+        std::uint64_t       contentHash = 0;
+        ByteHistogram       byteHistogram = {};
+        SimilarityCounts    similarityCounts;
+    };
+
+    struct SectionChunks
+    {
+        std::string                 sectionName;
+        std::size_t                 numberOfChunks = 0;
+        std::vector<ChunkDigest>    chunkDigests;
+    };
+
+    ChunkDigest
+    digestChunk( unsigned char const* const chunkBytes,
+                 std::size_t const chunkSizeInBytes )
+    {
+        // Four histograms, merged at the end, so that runs of one byte value
+        // do not serialise on a single counter.
+        ByteHistogram byteHistograms[4] = {};
+        auto hash = std::uint64_t{ 0x9E3779B97F4A7C15 };
+
+        auto i = std::size_t{ 0 };
+        for ( ; i + 8 <= chunkSizeInBytes; i += 8 )
+        {
+            auto word = std::uint64_t{ 0 };
+            std::memcpy( &word, chunkBytes + i, 8 );
+            hash = ( hash ^ word ) * 0xFF51AFD7ED558CCD;
+            hash ^= hash >> 29;
+
+            byteHistograms[0][word & 0xFF]++;
+            byteHistograms[1][( word >> 8 ) & 0xFF]++;
+            byteHistograms[2][( word >> 16 ) & 0xFF]++;
+            byteHistograms[3][( word >> 24 ) & 0xFF]++;
+            byteHistograms[0][( word >> 32 ) & 0xFF]++;
+            byteHistograms[1][( word >> 40 ) & 0xFF]++;
+            byteHistograms[2][( word >> 48 ) & 0xFF]++;
+            byteHistograms[3][word >> 56]++;
+        }
+
+        // The tail is hashed zero padded; the section size is part of the
+        // section hash.
+        if ( i < chunkSizeInBytes )
+        {
+            auto word = std::uint64_t{ 0 };
+            std::memcpy( &word, chunkBytes + i, chunkSizeInBytes - i );
+            hash = ( hash ^ word ) * 0xFF51AFD7ED558CCD;
+            hash ^= hash >> 29;
+
+            for ( ; i < chunkSizeInBytes; i++ )
+            {
+                byteHistograms[0][chunkBytes[i]]++;
+            }
+        }
+
+        auto chunkDigest = ChunkDigest
+        {
+            .contentHash = hash,
+            .similarityCounts = countSimilarityWindows( std::span( chunkBytes, chunkSizeInBytes ) )
+        };
+        for ( auto byteValue = 0; byteValue < 256; byteValue++ )
+        {
+            chunkDigest.byteHistogram[byteValue] = byteHistograms[0][byteValue] + byteHistograms[1][byteValue]
+                                                   + byteHistograms[2][byteValue] + byteHistograms[3][byteValue];
+        }
+
+        return chunkDigest;
+    }
+
+    // The chunk hashes are combined in order, so the digest does not depend
+    // on which worker finished first. The similarity counts of the windows
+    // straddling two chunks are added from the section data.
+    SectionDigest
+    combineChunkDigests( std::vector<ChunkDigest> const& chunkDigests,
+                         std::vector<unsigned char> const& sectionRawData )
+    {
+        auto const sectionSizeInBytes = std::uint64_t{ sectionRawData.size() };
+        auto hash = std::uint64_t{ 0x9E3779B97F4A7C15 } ^ sectionSizeInBytes;
+        auto byteCounts = std::array<std::uint64_t, 256>{};
+        auto similarityCounts = SimilarityCounts{};
+
+        for ( auto chunkIdx = std::size_t{ 0 }; auto const& chunkDigest : chunkDigests )
+        {
+            hash = ( hash ^ chunkDigest.contentHash ) * 0xFF51AFD7ED558CCD;
+            hash ^= hash >> 29;
+
+            for ( auto byteValue = 0; byteValue < 256; byteValue++ )
+            {
+                byteCounts[byteValue] += chunkDigest.byteHistogram[byteValue];
+            }
+
+            auto const chunkOffset = chunkIdx++ * sectionChunkSizeInBytes;
+            appendSimilarityCounts( similarityCounts, chunkDigest.similarityCounts,
+                                    std::span( sectionRawData.data(), chunkOffset ),
+                                    std::span( sectionRawData.data() + chunkOffset, sectionRawData.size() - chunkOffset ) );
+        }
+
+        auto entropyInBitsPerByte = 0.0;
+        for ( auto const byteCount : byteCounts )
+        {
+            if ( byteCount != 0 )
+            {
+                auto const probability = static_cast<double>( byteCount ) / static_cast<double>( sectionSizeInBytes );
+                entropyInBitsPerByte -= probability * std::log2( probability );
+            }
+        }
+
+        return SectionDigest
+        {
+            .contentHash = hash,
+            .entropyInBitsPerByte = entropyInBitsPerByte,
+            .similarityDigest = makeSimilarityDigest( similarityCounts )
+        };
+    }
+}
+
+char const*
+getAnalysisStageName( AnalysisStage const analysisStage )
+{
+    switch ( analysisStage )
+    {
+        case AnalysisStage::Headers:            return "headers";
+        case AnalysisStage::SectionData:        return "section data";
+        case AnalysisStage::SectionDigests:     return "section digests";
+        case AnalysisStage::Imports:            return "imports";
+        case AnalysisStage::Exports:            return "exports";
+        case AnalysisStage::RuntimeFunctions:   return "runtime functions";
+    }
+
+    return "?";
+}
+
+ImageAnalysis::ImageAnalysis( std::string const& pathOfExecutableFile )
+: m_pathOfExecutableFile( pathOfExecutableFile )
+, m_exeFile( loadEXEFile( pathOfExecutableFile, ParseDepth::Headers ) )
+{
+    finishStage( AnalysisStage::Headers, {} );
+}
+
+void
+ImageAnalysis::finishStage( AnalysisStage const analysisStage,
+                            StageCallback const& onStageFinished )
+{
+    m_isStageFinished[static_cast<std::size_t>( analysisStage )].store( true, std::memory_order_release );
+
+    if ( onStageFinished )
+    {
+        onStageFinished( analysisStage );
+    }
+}
+
+void
+ImageAnalysis::runRemainingStages( StageCallback const& onStageFinished,
+                                   std::stop_token const& stopToken )
+{
+    // Viewers run the stages on a pool thread, which has no profile yet;
+    // callers that have one keep recording into it.
+    auto const fileProfile = Instrumentation::ScopedFileProfile{ m_pathOfExecutableFile };
+
+    auto fileRangeReader = FileRangeReader{ m_pathOfExecutableFile };
+
+    // Every key is in place before the graph runs, so the tasks only ever
+    // write to values of their own.
+    auto& sectionNameToRawData = m_exeFile.sectionNameToRawData;
+    auto sectionsChunks = std::vector<SectionChunks>{};
+
+    for ( auto const& [sectionName, sectionHeader] : m_exeFile.sectionHeadersNameToInfo )
+    {
+        sectionNameToRawData[sectionName];
+        m_sectionNameToDigest[sectionName];
+
+        auto const numberOfChunks = ( std::size_t{ sectionHeader.sizeOfRawDataInBytes } + sectionChunkSizeInBytes - 1 ) / sectionChunkSizeInBytes;
+        sectionsChunks.push_back( SectionChunks
+                                  {
+                                      .sectionName = sectionName,
+                                      .numberOfChunks = numberOfChunks,
+                                      .chunkDigests = std::vector<ChunkDigest>( numberOfChunks )
+                                  } );
+    }
+
+    auto taskGraph = TaskGraph{};
+    auto readTaskIndices = std::vector<TaskGraph::TaskIdx>{};
+    auto sectionDigestTaskIndices = std::vector<TaskGraph::TaskIdx>{};
+
+    for ( auto& sectionChunks : sectionsChunks )
+    {
+        auto const& sectionHeader = m_exeFile.sectionHeadersNameToInfo.at( sectionChunks.sectionName );
+        auto& sectionRawData = sectionNameToRawData.at( sectionChunks.sectionName );
+        auto& sectionDigest = m_sectionNameToDigest.at( sectionChunks.sectionName );
+
+        // Sized in a task of its own, so that filling a large section with
+        // zeros overlaps with reading the others.
+        auto const allocateTaskIdx =
+            taskGraph.addTask( [&sectionRawData, &sectionHeader]()
+                               {
+                                   sectionRawData.resize( sectionHeader.sizeOfRawDataInBytes );
+
+                                   Instrumentation::addToCounter( Instrumentation::Counter::Allocations );
+                               } );
+
+        auto hashTaskIndices = std::vector<TaskGraph::TaskIdx>{};
+
+        for ( auto chunkIdx = std::size_t{ 0 }; chunkIdx < sectionChunks.numberOfChunks; chunkIdx++ )
+        {
+            auto const chunkOffset = chunkIdx * sectionChunkSizeInBytes;
+            auto const chunkSizeInBytes = std::min<std::size_t>( sectionChunkSizeInBytes, sectionHeader.sizeOfRawDataInBytes - chunkOffset );
+
+            auto const readTaskIdx =
+                taskGraph.addTask( [&fileRangeReader, &sectionRawData, &sectionHeader, chunkOffset, chunkSizeInBytes]()
+                                   {
+                                       auto const sectionContentsTimer = Instrumentation::ScopedTimer{ "Section contents" };
+
+                                       auto const chunk = std::span<unsigned char>( sectionRawData.data() + chunkOffset, chunkSizeInBytes );
+
+                                       if ( fileRangeReader.readInto( sectionHeader.pointerToRawData + std::uint64_t{ chunkOffset }, chunk ) != chunkSizeInBytes )
+                                       {
+                                           throw std::runtime_error{ "Section contents lie outside of the file." };
+                                       }
+                                   },
+                                   { allocateTaskIdx } );
+            readTaskIndices.push_back( readTaskIdx );
+
+            hashTaskIndices.push_back(
+                taskGraph.addTask( [&sectionRawData, &sectionChunks, chunkIdx, chunkOffset, chunkSizeInBytes]()
+                                   {
+                                       sectionChunks.chunkDigests[chunkIdx] = digestChunk( sectionRawData.data() + chunkOffset, chunkSizeInBytes );
+                                   },
+                                   { readTaskIdx } ) );
+        }
+
+        if ( hashTaskIndices.empty() )
+        {
+            readTaskIndices.push_back( allocateTaskIdx );
+            hashTaskIndices.push_back( allocateTaskIdx );
+        }
+
+        sectionDigestTaskIndices.push_back(
+            taskGraph.addTask( [&sectionDigest, &sectionChunks, &sectionRawData]()
+                               {
+                                   sectionDigest = combineChunkDigests( sectionChunks.chunkDigests, sectionRawData );
+                               },
+                               hashTaskIndices ) );
+    }
+
+    taskGraph.addTask( [this, &onStageFinished]()
+                       {
+                           finishStage( AnalysisStage::SectionDigests, onStageFinished );
+                       },
+                       sectionDigestTaskIndices );
+
+    // The directories may point into any section, so they are decoded once
+    // all of the section data is in, while the hashing carries on.
+    auto const sectionDataTaskIdx =
+        taskGraph.addTask( [this, &onStageFinished]()
+                           {
+                               finishStage( AnalysisStage::SectionData, onStageFinished );
+                           },
+                           readTaskIndices );
+
+    taskGraph.addTask( [this, &onStageFinished]()
+                       {
+                           auto importedDLLToImportedFunctions =
+                               PE::extractImportedFunctionsInfo( m_exeFile.dataDirectoryEntries,
+                                                                 m_exeFile.sectionHeadersNameToInfo,
+                                                                 m_exeFile.sectionNameToRawData );
+                           if ( importedDLLToImportedFunctions )
+                           {
+                               m_exeFile.importedDLLToImportedFunctions = std::move( *importedDLLToImportedFunctions );
+                           }
+
+                           finishStage( AnalysisStage::Imports, onStageFinished );
+                       },
+                       { sectionDataTaskIdx } );
+
+    taskGraph.addTask( [this, &onStageFinished]()
+                       {
+                           auto exportedFunctions =
+                               PE::extractExportedFunctionsInfo( m_exeFile.dataDirectoryEntries,
+                                                                 m_exeFile.sectionHeadersNameToInfo,
+                                                                 m_exeFile.sectionNameToRawData );
+                           if ( exportedFunctions )
+                           {
+                               m_exeFile.exportedFunctions = std::move( *exportedFunctions );
+                           }
+
+                           finishStage( AnalysisStage::Exports, onStageFinished );
+                       },
+                       { sectionDataTaskIdx } );
+
+    taskGraph.addTask( [this, &onStageFinished]()
+                       {
+                           m_runtimeFunctions = ::getRuntimeFunctions( m_exeFile );
+
+                           finishStage( AnalysisStage::RuntimeFunctions, onStageFinished );
+                       },
+                       { sectionDataTaskIdx } );
+
+    taskGraph.run( stopToken );
+}
\ No newline at end of file
@@ -0,0 +1,118 @@
+
+#ifndef IMAGEANALYSIS_H
+#define IMAGEANALYSIS_H
+
+#include "PEFiles.h"
+#include "SimilarityDigest.h"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <optional>
+#include <stop_token>
+#include <string>
+#include <vector>
+
+enum class AnalysisStage : std::uint8_t
+{
+    Headers,
+    SectionData,
+    SectionDigests,
+    Imports,
+    Exports,
+    RuntimeFunctions
+};
+
+auto const numberOfAnalysisStages = std::size_t{ 6 };
+
+char const*
+getAnalysisStageName( AnalysisStage const analysisStage );
+
+struct SectionDigest
+{
+    std::uint64_t                      contentHash = 0;
+    double                             entropyInBitsPerByte = 0.0;
+
+    // None for sections too small or uniform to compare.
+    std::optional<SimilarityDigest>    similarityDigest;
+};
+
+// Everything a full load of an executable yields, produced by a pipeline of
+// stages instead of one pass. The headers are parsed up front; the sections
+// are then read in chunks and the chunks hashed while the directories are
+// decoded, all on one task graph, so a large image takes about as long as its
+// slowest stage rather than the sum of them.
+//
+// What a stage fills in is written by that stage alone and never again once
+// it has finished, so it may be read from any thread as soon as
+// isStageFinished() says so:
+//
+//   Headers           the headers of getEXEFile()
+//   SectionData       getEXEFile().sectionNameToRawData
+//   SectionDigests    getSectionDigests()
+//   Imports           getEXEFile().importedDLLToImportedFunctions
+//   Exports           getEXEFile().exportedFunctions
+//   RuntimeFunctions  getRuntimeFunctions()
+class ImageAnalysis
+{
+public:
+    // Reads and parses the headers, which finishes the Headers stage. Throws
+    // std::runtime_error like loadEXEFile.
+    explicit ImageAnalysis( std::string const& pathOfExecutableFile );
+
+    ImageAnalysis( ImageAnalysis const& ) = delete;
+    ImageAnalysis& operator=( ImageAnalysis const& ) = delete;
+
+    using StageCallback = std::function<void( AnalysisStage const finishedStage )>;
+
+    // Runs the other stages and returns once they have all finished, calling
+    // onStageFinished as each one does. The callback runs on the worker that
+    // finished the stage, possibly alongside the callbacks of other stages.
+    // Throws std::runtime_error when the section data cannot be read; the
+    // stages finished by then stay valid. A stop requested through the token
+    // returns early, with the stages not finished by then left unfinished.
+    // Called at most once.
+    void
+    runRemainingStages( StageCallback const& onStageFinished = {},
+                        std::stop_token const& stopToken = {} );
+
+    bool
+    isStageFinished( AnalysisStage const analysisStage ) const
+    {
+        return m_isStageFinished[static_cast<std::size_t>( analysisStage )].load( std::memory_order_acquire );
+    }
+
+    EXEFile const&
+    getEXEFile() const
+    {
+        return m_exeFile;
+    }
+
+    std::map<std::string, SectionDigest> const&
+    getSectionDigests() const
+    {
+        return m_sectionNameToDigest;
+    }
+
+    std::vector<PE::RuntimeFunction> const&
+    getRuntimeFunctions() const
+    {
+        return m_runtimeFunctions;
+    }
+
+private:
+    void
+    finishStage( AnalysisStage const analysisStage,
+                 StageCallback const& onStageFinished );
+
+private:
+    std::string                                               m_pathOfExecutableFile;
+    EXEFile                                                   m_exeFile;
+    std::map<std::string, SectionDigest>                      m_sectionNameToDigest;
+    std::vector<PE::RuntimeFunction>                          m_runtimeFunctions;
+    std::array<std::atomic<bool>, numberOfAnalysisStages>    m_isStageFinished = {};
+};
+
+#endif // IMAGEANALYSIS_H
\ No newline at end of file
@@ -0,0 +1,170 @@
+
+#include "ImageCache.h"
+
+#include <chrono>
+#include <filesystem>
+#include <iterator>
+#include <optional>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+
+namespace
+{
+    struct IdentifiedPath
+    {
+        std::string      canonicalPath;
+        ImageIdentity    identity;
+    };
+
+    IdentifiedPath
+    identifyImage( std::string const& pathOfImage )
+    {
+        auto errorCode = std::error_code{};
+
+        auto const canonicalPath = std::filesystem::canonical( pathOfImage, errorCode );
+        if ( errorCode )
+        {
+            throw std::runtime_error{ "Cannot find " + pathOfImage + ": " + errorCode.message() };
+        }
+
+        auto const sizeInBytes = std::filesystem::file_size( canonicalPath, errorCode );
+        auto const lastWriteTime = std::filesystem::last_write_time( canonicalPath, errorCode );
+        if ( errorCode )
+        {
+            throw std::runtime_error{ "Cannot read " + pathOfImage + ": " + errorCode.message() };
+        }
+
+        return IdentifiedPath
+        {
+            .canonicalPath = canonicalPath.string(),
+            .identity = ImageIdentity
+            {
+                .sizeInBytes = sizeInBytes,
+                .lastWriteTimeInNanoseconds =
+                    std::chrono::duration_cast<std::chrono::nanoseconds>( lastWriteTime.time_since_epoch() ).count()
+            }
+        };
+    }
+
+    std::shared_ptr<ResidentImage const>
+    parseResidentImage( IdentifiedPath&& identifiedPath )
+    {
+        auto exeFile = loadEXEFile( identifiedPath.canonicalPath );
+        auto rvaSymbolizer = RVASymbolizer{ exeFile };
+
+        exeFile.sectionNameToRawData.clear();
+
+        return std::make_shared<ResidentImage const>( ResidentImage
+                                                      {
+                                                          .canonicalPath = std::move( identifiedPath.canonicalPath ),
+                                                          .identity = identifiedPath.identity,
+                                                          .exeFile = std::move( exeFile ),
+                                                          .rvaSymbolizer = std::move( rvaSymbolizer )
+                                                      } );
+    }
+}
+
+ImageCache::ImageCache( std::uint64_t const memoryBudgetInBytes )
+: m_memoryBudgetInBytes( memoryBudgetInBytes )
+{
+}
+
+std::shared_ptr<ResidentImage const>
+ImageCache::getImage( std::string const& pathOfImage )
+{
+    auto identifiedPath = identifyImage( pathOfImage );
+    auto identityCachedAtMiss = std::optional<ImageIdentity>{};
+
+    {
+        auto const lock = std::lock_guard{ m_mutex };
+
+        auto const cachedImage = m_pathToCachedImage.find( identifiedPath.canonicalPath );
+        if ( cachedImage != m_pathToCachedImage.end() )
+        {
+            auto const& residentImage = cachedImage->second->residentImage;
+            if ( residentImage->identity == identifiedPath.identity )
+            {
+                m_cachedImagesByRecentUse.splice( m_cachedImagesByRecentUse.begin(), m_cachedImagesByRecentUse, cachedImage->second );
+                m_numberOfHits++;
+                return residentImage;
+            }
+
+            identityCachedAtMiss = residentImage->identity;
+        }
+
+        m_numberOfMisses++;
+    }
+
+    auto residentImage = parseResidentImage( std::move( identifiedPath ) );
+    auto const estimatedMemoryUsageInBytes = getEstimatedMemoryUsageInBytes( residentImage->exeFile );
+
+    auto const lock = std::lock_guard{ m_mutex };
+
+    auto const cachedImage = m_pathToCachedImage.find( residentImage->canonicalPath );
+    auto const identityCachedNow =
+        cachedImage == m_pathToCachedImage.end() ? std::optional<ImageIdentity>{}
+                                                 : std::optional<ImageIdentity>{ cachedImage->second->residentImage->identity };
+
+    if ( identityCachedNow != identityCachedAtMiss )
+    {
+        // Another request cached the path while this one was parsing. Its
+        // image is kept, and shared when it is the same as this one.
+        if ( identityCachedNow == residentImage->identity )
+        {
+            return cachedImage->second->residentImage;
+        }
+
+        return residentImage;
+    }
+
+    if ( cachedImage != m_pathToCachedImage.end() )
+    {
+        eraseCachedImage( cachedImage->second );
+    }
+
+    m_cachedImagesByRecentUse.push_front( CachedImage
+                                          {
+                                              .residentImage = residentImage,
+                                              .estimatedMemoryUsageInBytes = estimatedMemoryUsageInBytes
+                                          } );
+    m_pathToCachedImage[residentImage->canonicalPath] = m_cachedImagesByRecentUse.begin();
+    m_estimatedMemoryUsageInBytes += estimatedMemoryUsageInBytes;
+
+    evictLeastRecentlyUsedImages();
+
+    return residentImage;
+}
+
+ImageCacheStatistics
+ImageCache::getStatistics() const
+{
+    auto const lock = std::lock_guard{ m_mutex };
+
+    return ImageCacheStatistics
+    {
+        .numberOfImages = m_cachedImagesByRecentUse.size(),
+        .numberOfHits = m_numberOfHits,
+        .numberOfMisses = m_numberOfMisses,
+        .numberOfEvictions = m_numberOfEvictions,
+        .estimatedMemoryUsageInBytes = m_estimatedMemoryUsageInBytes
+    };
+}
+
+void
+ImageCache::eraseCachedImage( CachedImages::iterator const cachedImage )
+{
+    m_estimatedMemoryUsageInBytes -= cachedImage->estimatedMemoryUsageInBytes;
+    m_pathToCachedImage.erase( cachedImage->residentImage->canonicalPath );
+    m_cachedImagesByRecentUse.erase( cachedImage );
+}
+
+void
+ImageCache::evictLeastRecentlyUsedImages()
+{
+    while ( m_estimatedMemoryUsageInBytes > m_memoryBudgetInBytes and m_cachedImagesByRecentUse.size() > 1 )
+    {
+        eraseCachedImage( std::prev( m_cachedImagesByRecentUse.end() ) );
+        m_numberOfEvictions++;
+    }
+}
\ No newline at end of file
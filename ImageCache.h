@@ -0,0 +1,97 @@
+
+#ifndef IMAGECACHE_H
+#define IMAGECACHE_H
+
+#include "PEFiles.h"
+#include "RVASymbolizer.h"
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+// What a cached image was parsed from. A file whose size or last write time
+// changed is parsed again.
+struct ImageIdentity
+{
+    std::uint64_t    sizeInBytes = 0;
+    std::int64_t     lastWriteTimeInNanoseconds = 0;
+
+    bool
+    operator==( ImageIdentity const& ) const = default;
+};
+
+// An image parsed in full, with its symbolizer built, and the section raw
+// data dropped afterwards so that only the headers and directories stay
+// resident. Never modified once cached, so it is shared between requests
+// without locking.
+struct ResidentImage
+{
+    std::string      canonicalPath;
+    ImageIdentity    identity;
+    EXEFile          exeFile;
+    RVASymbolizer    rvaSymbolizer;
+};
+
+struct ImageCacheStatistics
+{
+    std::size_t      numberOfImages = 0;
+    std::uint64_t    numberOfHits = 0;
+    std::uint64_t    numberOfMisses = 0;
+    std::uint64_t    numberOfEvictions = 0;
+    std::uint64_t    estimatedMemoryUsageInBytes = 0;
+};
+
+// Parsed images keyed by canonical path, so that different spellings of one
+// path share an entry. The least recently used images are dropped once the
+// estimated memory usage of all of them exceeds the budget; the one most
+// recently used always stays, and requests still holding a dropped image
+// keep it alive until they finish.
+//
+// Safe to use from many threads. An image is parsed outside of the lock and
+// only cached if the entry for its path has not changed in the meantime, so
+// a slow parse never replaces the image a concurrent request cached first.
+class ImageCache
+{
+public:
+    static constexpr auto defaultMemoryBudgetInBytes = std::uint64_t{ 1024 } * 1024 * 1024;
+
+    explicit ImageCache( std::uint64_t const memoryBudgetInBytes = defaultMemoryBudgetInBytes );
+
+    // Throws std::runtime_error when the file cannot be read or parsed.
+    std::shared_ptr<ResidentImage const>
+    getImage( std::string const& pathOfImage );
+
+    ImageCacheStatistics
+    getStatistics() const;
+
+private:
+    struct CachedImage
+    {
+        std::shared_ptr<ResidentImage const>    residentImage;
+        std::uint64_t                           estimatedMemoryUsageInBytes;
+    };
+
+    using CachedImages = std::list<CachedImage>;
+
+    // Both expect the mutex to be held.
+    void
+    eraseCachedImage( CachedImages::iterator const cachedImage );
+
+    void
+    evictLeastRecentlyUsedImages();
+
+private:
+    mutable std::mutex                                         m_mutex;
+    std::uint64_t const                                        m_memoryBudgetInBytes;
+    CachedImages                                               m_cachedImagesByRecentUse;
+    std::unordered_map<std::string, CachedImages::iterator>    m_pathToCachedImage;
+    std::uint64_t                                              m_estimatedMemoryUsageInBytes = 0;
+    std::uint64_t                                              m_numberOfHits = 0;
+    std::uint64_t                                              m_numberOfMisses = 0;
+    std::uint64_t                                              m_numberOfEvictions = 0;
+};
+
+#endif // IMAGECACHE_H
\ No newline at end of file
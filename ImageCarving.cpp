@@ -0,0 +1,201 @@
+
+#include "ImageCarving.h"
+
+#include "Instrumentation.h"
+#include "PEFieldDescriptors.h"
+#include "PEFormat.h"
+#include "ParallelFor.h"
+
+#include <algorithm>
+#include <bit>
+#include <optional>
+
+#if defined( __SSE2__ ) or defined( _M_X64 )
+#include <emmintrin.h>
+#define EWEA_HAS_SSE2 1
+#endif
+
+namespace
+{
+    // Large enough to keep every thread streaming for a while, small enough
+    // that a multi-gigabyte dump splits into many more chunks than threads.
+    auto const chunkSizeInBytes = std::size_t{ 16 } << 20;
+
+    // Real images keep their NT headers within the first few kilobytes; the
+    // bound only rejects nonsense quickly.
+    auto const maximumOffsetOfNTSignature = std::uint32_t{ 1 } << 20;
+
+    auto const ntSignature_PE00 = std::uint32_t{ 0x00004550 };
+    auto const optionalHeaderSig_PE32 = std::uint16_t{ 0x10B };
+    auto const optionalHeaderSig_PE32Plus = std::uint16_t{ 0x20B };
+
+    // Offsets into the optional header of the number of data directories;
+    // the directories follow it, the certificate table being the fifth.
+    auto const numberOfDataDirectoriesOffset_PE32 = std::size_t{ 92 };
+    auto const numberOfDataDirectoriesOffset_PE32Plus = std::size_t{ 108 };
+    auto const certificateTableIdx = std::uint32_t{ 4 };
+
+    std::optional<CarvedImage>
+    validateImageCandidate( PE::ByteReader const& blob,
+                            std::uint64_t const candidateOffset )
+    {
+        auto const imageBytes = *blob.subReader( candidateOffset );
+
+        auto const dosHeader = PE::extractDOSHeader( imageBytes );
+        if ( not dosHeader or dosHeader->offsetOfNTSignature > maximumOffsetOfNTSignature )
+        {
+            return std::nullopt;
+        }
+
+        if ( imageBytes.read<std::uint32_t>( dosHeader->offsetOfNTSignature ) != ntSignature_PE00 )
+        {
+            return std::nullopt;
+        }
+
+        auto const ntFileHeaderOffset = std::size_t{ dosHeader->offsetOfNTSignature } + sizeof( std::uint32_t );
+        auto const ntOptionalHeaderOffset = ntFileHeaderOffset + sizeof( PE::NTFileHeader );
+
+        auto const ntFileHeaderBytes = imageBytes.subReader( ntFileHeaderOffset );
+        auto const ntFileHeader = ntFileHeaderBytes ? PE::extractNTFileHeader( *ntFileHeaderBytes ) : std::nullopt;
+        auto const optionalHeaderSignature = imageBytes.read<std::uint16_t>( ntOptionalHeaderOffset );
+
+        if (    not ntFileHeader
+             or ntFileHeader->targetMachineArchitecture == 0
+             or ntFileHeader->numberOfSections == 0
+             or ( optionalHeaderSignature != optionalHeaderSig_PE32 and optionalHeaderSignature != optionalHeaderSig_PE32Plus ) )
+        {
+            return std::nullopt;
+        }
+
+        auto const sectionTableOffset = ntOptionalHeaderOffset + ntFileHeader->sizeOfOptionalHeader;
+        auto imageEnd =
+            std::uint64_t{ sectionTableOffset } + std::uint64_t{ ntFileHeader->numberOfSections } * sizeof( PE::SectionHeader );
+
+        for ( auto i = std::size_t{ 0 }; i < ntFileHeader->numberOfSections; i++ )
+        {
+            auto const sectionHeaderBytes = imageBytes.subReader( sectionTableOffset + i * sizeof( PE::SectionHeader ) );
+            auto const sectionHeader =
+                sectionHeaderBytes ? PE::decodeFields<PE::SectionHeader, PE::sectionHeaderFields>( *sectionHeaderBytes ) : std::nullopt;
+            if ( not sectionHeader )
+            {
+                break;
+            }
+
+            if ( sectionHeader->sizeOfRawDataInBytes != 0 )
+            {
+                imageEnd = std::max( imageEnd,
+                                     std::uint64_t{ sectionHeader->pointerToRawData } + sectionHeader->sizeOfRawDataInBytes );
+            }
+        }
+
+        // Signed images carry their certificates after the last section,
+        // addressed by file offset rather than RVA.
+        auto const numberOfDataDirectoriesOffset =
+            ntOptionalHeaderOffset + ( optionalHeaderSignature == optionalHeaderSig_PE32Plus ? numberOfDataDirectoriesOffset_PE32Plus
+                                                                                              : numberOfDataDirectoriesOffset_PE32 );
+        auto const numberOfDataDirectories = imageBytes.read<std::uint32_t>( numberOfDataDirectoriesOffset );
+
+        if ( numberOfDataDirectories and *numberOfDataDirectories > certificateTableIdx )
+        {
+            auto const certificateTable =
+                imageBytes.read<PE::DataDirectoryEntry>( numberOfDataDirectoriesOffset + sizeof( std::uint32_t )
+                                                         + certificateTableIdx * sizeof( PE::DataDirectoryEntry ) );
+
+            if ( certificateTable and certificateTable->sizeInBytes != 0 )
+            {
+                imageEnd = std::max( imageEnd,
+                                     std::uint64_t{ certificateTable->dataDirectoryRVA } + certificateTable->sizeInBytes );
+            }
+        }
+
+        return CarvedImage
+        {
+            .offset = candidateOffset,
+            .sizeInBytes = std::min<std::uint64_t>( imageEnd, imageBytes.size() ),
+            .targetMachineArchitecture = ntFileHeader->targetMachineArchitecture,
+            .numberOfSections = ntFileHeader->numberOfSections,
+            .optionalHeaderSignature = *optionalHeaderSignature,
+            .isTruncated = imageEnd > imageBytes.size()
+        };
+    }
+
+    void
+    carveChunk( PE::ByteReader const& blob,
+                std::size_t const chunkStart,
+                std::size_t const chunkEnd,
+                std::vector<CarvedImage>& carvedImages )
+    {
+        auto const bytes = blob.data();
+        auto const onCandidate =
+            [&]( std::size_t const candidateOffset )
+            {
+                if ( auto const carvedImage = validateImageCandidate( blob, candidateOffset ) )
+                {
+                    carvedImages.push_back( *carvedImage );
+                }
+            };
+
+        auto i = chunkStart;
+
+#ifdef EWEA_HAS_SSE2
+        auto const letterM = _mm_set1_epi8( 'M' );
+        auto const letterZ = _mm_set1_epi8( 'Z' );
+
+        // The second load is one byte ahead, so a block needs seventeen bytes
+        // of the blob; candidates may spill past the chunk but not the blob.
+        for ( ; i < chunkEnd and i + 17 <= blob.size(); i += 16 )
+        {
+            auto const firstBytes = _mm_loadu_si128( reinterpret_cast<__m128i const*>( bytes + i ) );
+            auto const secondBytes = _mm_loadu_si128( reinterpret_cast<__m128i const*>( bytes + i + 1 ) );
+
+            auto candidateMask =
+                static_cast<std::uint32_t>( _mm_movemask_epi8( _mm_and_si128( _mm_cmpeq_epi8( firstBytes, letterM ),
+                                                                              _mm_cmpeq_epi8( secondBytes, letterZ ) ) ) );
+
+            while ( candidateMask != 0 )
+            {
+                auto const candidateOffset = i + std::countr_zero( candidateMask );
+                candidateMask &= candidateMask - 1;
+
+                if ( candidateOffset < chunkEnd )
+                {
+                    onCandidate( candidateOffset );
+                }
+            }
+        }
+#endif
+
+        for ( ; i < chunkEnd and i + 1 < blob.size(); i++ )
+        {
+            if ( bytes[i] == 'M' and bytes[i + 1] == 'Z' )
+            {
+                onCandidate( i );
+            }
+        }
+    }
+}
+
+std::vector<CarvedImage>
+carveEmbeddedImages( PE::ByteReader const& blob )
+{
+    auto const carveTimer = Instrumentation::ScopedTimer{ "Carve images" };
+
+    auto const numberOfChunks = ( blob.size() + chunkSizeInBytes - 1 ) / chunkSizeInBytes;
+    auto chunkCarvedImages = std::vector<std::vector<CarvedImage>>( numberOfChunks );
+
+    parallelFor( numberOfChunks,
+                 [&]( std::size_t const chunkIdx )
+                 {
+                     auto const chunkStart = chunkIdx * chunkSizeInBytes;
+                     carveChunk( blob, chunkStart, std::min( chunkStart + chunkSizeInBytes, blob.size() ),
+                                 chunkCarvedImages[chunkIdx] );
+                 } );
+
+    auto carvedImages = std::vector<CarvedImage>{};
+    for ( auto const& carvedImagesOfChunk : chunkCarvedImages )
+    {
+        carvedImages.insert( carvedImages.end(), carvedImagesOfChunk.begin(), carvedImagesOfChunk.end() );
+    }
+
+    return carvedImages;
+}
\ No newline at end of file
@@ -0,0 +1,32 @@
+
+#ifndef IMAGECARVING_H
+#define IMAGECARVING_H
+
+#include "ByteReader.h"
+
+#include <cstdint>
+#include <vector>
+
+// A PE image found inside a larger blob. The size runs to the end of the
+// furthest section or certificate table; the image is truncated when that
+// reaches past the end of the blob.
+struct CarvedImage
+{
+    std::uint64_t    offset;
+    std::uint64_t    sizeInBytes;
+    std::uint16_t    targetMachineArchitecture;
+    std::uint16_t    numberOfSections;
+    std::uint16_t    optionalHeaderSignature;
+    bool             isTruncated;
+};
+
+// Finds every "MZ" in the blob, sixteen positions at a time with SIMD, and
+// keeps those whose offsetOfNTSignature points at "PE\0\0" followed by a
+// plausible file header and a PE32 or PE32+ optional header. Candidates are
+// read in place, never copied. The blob is scanned in chunks in parallel;
+// images are returned ordered by offset and may nest, e.g. an installer and
+// the executables it carries.
+std::vector<CarvedImage>
+carveEmbeddedImages( PE::ByteReader const& blob );
+
+#endif // IMAGECARVING_H
\ No newline at end of file
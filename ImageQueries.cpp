@@ -0,0 +1,423 @@
+
+#include "ImageQueries.h"
+
+#include "PEFieldDescriptors.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <deque>
+#include <filesystem>
+#include <map>
+#include <optional>
+#include <stdexcept>
+#include <system_error>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace
+{
+    std::vector<std::string>
+    splitRequest( std::string_view request )
+    {
+        while ( not request.empty() and ( request.back() == '\r' or request.back() == '\n' ) )
+        {
+            request.remove_suffix( 1 );
+        }
+
+        auto const separator = request.find( '\t' ) != std::string_view::npos ? '\t' : ' ';
+
+        auto requestFields = std::vector<std::string>{};
+        while ( not request.empty() )
+        {
+            auto const fieldEnd = request.find( separator );
+            auto const field = request.substr( 0, fieldEnd );
+
+            if ( not field.empty() )
+            {
+                requestFields.emplace_back( field );
+            }
+
+            request.remove_prefix( fieldEnd == std::string_view::npos ? request.size() : fieldEnd + 1 );
+        }
+
+        return requestFields;
+    }
+
+    std::string
+    formatHex( std::uint64_t const value,
+               int const numberOfDigits )
+    {
+        char formattedValue[24];
+        std::snprintf( formattedValue, sizeof( formattedValue ), "0x%0*llX",
+                       numberOfDigits, static_cast<unsigned long long>( value ) );
+
+        return formattedValue;
+    }
+
+    // Names come from the image and may hold any byte; control characters
+    // and backslashes are written as \xNN so that they cannot split a field
+    // or a line of the response.
+    std::string
+    escapeField( std::string_view const field )
+    {
+        auto escapedField = std::string{};
+        escapedField.reserve( field.size() );
+
+        for ( auto const character : field )
+        {
+            auto const byte = static_cast<unsigned char>( character );
+
+            if ( byte < 0x20 or byte == 0x7F or byte == '\\' )
+            {
+                char escapedByte[8];
+                std::snprintf( escapedByte, sizeof( escapedByte ), "\\x%02X", byte );
+                escapedField += escapedByte;
+            }
+            else
+            {
+                escapedField += character;
+            }
+        }
+
+        return escapedField;
+    }
+
+    std::string
+    toLowercase( std::string text )
+    {
+        std::transform( text.begin(), text.end(), text.begin(),
+                        []( unsigned char const character )
+                        {
+                            return static_cast<char>( std::tolower( character ) );
+                        } );
+
+        return text;
+    }
+
+    void
+    requireNumberOfArguments( std::vector<std::string> const& requestFields,
+                              std::size_t const minimumNumberOfArguments,
+                              std::size_t const maximumNumberOfArguments )
+    {
+        auto const numberOfArguments = requestFields.size() - 1;
+
+        if ( numberOfArguments < minimumNumberOfArguments or numberOfArguments > maximumNumberOfArguments )
+        {
+            throw std::runtime_error{ "Wrong number of arguments to '" + requestFields.front() + "'." };
+        }
+    }
+
+    void
+    appendFieldLines( std::vector<std::string>& resultLines,
+                      std::string const& groupName,
+                      std::vector<PE::FieldRow> const& fieldRows )
+    {
+        for ( auto const& fieldRow : fieldRows )
+        {
+            resultLines.push_back( groupName + '\t' + fieldRow.name + '\t' + fieldRow.value );
+        }
+    }
+
+    std::vector<std::string>
+    answerHeaders( ResidentImage const& residentImage )
+    {
+        auto resultLines = std::vector<std::string>{};
+
+        appendFieldLines( resultLines, "file", PE::getFieldRows( residentImage.exeFile.ntFileHeader, PE::ntFileHeaderFields ) );
+        appendFieldLines( resultLines, "optional",
+                          PE::getFieldRows( residentImage.exeFile.ntOptionalHeader, PE::ntOptionalHeader64Fields ) );
+
+        for ( auto const& [sectionName, sectionHeader] : residentImage.exeFile.sectionHeadersNameToInfo )
+        {
+            appendFieldLines( resultLines, escapeField( sectionName ), PE::getFieldRows( sectionHeader, PE::sectionHeaderFields ) );
+        }
+
+        return resultLines;
+    }
+
+    std::vector<std::string>
+    answerImports( ResidentImage const& residentImage )
+    {
+        auto resultLines = std::vector<std::string>{};
+
+        for ( auto const& [importedDLLName, importedFunctions] : residentImage.exeFile.importedDLLToImportedFunctions )
+        {
+            for ( auto const& importedFunction : importedFunctions )
+            {
+                resultLines.push_back( escapeField( importedDLLName ) + '\t' + escapeField( importedFunction.name ) + '\t' +
+                                       formatHex( importedFunction.iatSlotRVA, 8 ) );
+            }
+        }
+
+        return resultLines;
+    }
+
+    std::vector<std::string>
+    answerExports( ResidentImage const& residentImage )
+    {
+        auto resultLines = std::vector<std::string>{};
+
+        for ( auto const& exportedFunction : residentImage.exeFile.exportedFunctions )
+        {
+            resultLines.push_back( escapeField( exportedFunction.name ) + '\t' + formatHex( exportedFunction.rva, 8 ) );
+        }
+
+        return resultLines;
+    }
+
+    std::vector<std::string>
+    answerSymbolize( ResidentImage const& residentImage,
+                     std::vector<std::string> const& rvaTexts )
+    {
+        auto rvas = std::vector<std::uint32_t>{};
+        rvas.reserve( rvaTexts.size() );
+
+        for ( auto const& rvaText : rvaTexts )
+        {
+            auto parsedLength = std::size_t{ 0 };
+            auto rva = 0ull;
+
+            try
+            {
+                rva = std::stoull( rvaText, &parsedLength, 16 );
+            }
+            catch ( std::logic_error const& )
+            {
+            }
+
+            if ( parsedLength != rvaText.size() or rva > 0xFFFFFFFF )
+            {
+                throw std::runtime_error{ "'" + rvaText + "' is not a hex RVA." };
+            }
+
+            rvas.push_back( static_cast<std::uint32_t>( rva ) );
+        }
+
+        auto const& rvaSymbolizer = residentImage.rvaSymbolizer;
+
+        auto symbolIndices = std::vector<std::uint32_t>( rvas.size() );
+        rvaSymbolizer.findSymbols( rvas, symbolIndices );
+
+        auto resultLines = std::vector<std::string>{};
+        resultLines.reserve( rvas.size() );
+
+        for ( auto i = std::size_t{ 0 }; i < rvas.size(); i++ )
+        {
+            auto resultLine = formatHex( rvas[i], 8 ) + '\t';
+
+            if ( symbolIndices[i] == RVASymbolizer::unresolvedSymbolIdx )
+            {
+                resultLine += '?';
+            }
+            else
+            {
+                auto const symbolRVA = rvaSymbolizer.getSymbolRVA( symbolIndices[i] );
+                auto const symbolName = rvaSymbolizer.getSymbolName( symbolIndices[i] );
+
+                resultLine += symbolName.empty() ? "sub_" + formatHex( symbolRVA, 8 ).substr( 2 ) : escapeField( symbolName );
+                resultLine += '+' + formatHex( rvas[i] - symbolRVA, 1 );
+            }
+
+            resultLines.push_back( std::move( resultLine ) );
+        }
+
+        return resultLines;
+    }
+
+    // Looks a DLL up the way it is usually named on disk first, then through
+    // a case-insensitive listing of the directory, as Windows file names are.
+    class DependencyResolver
+    {
+    public:
+        explicit DependencyResolver( std::vector<std::string> const& searchDirectories )
+        : m_searchDirectories( searchDirectories )
+        {
+        }
+
+        std::optional<std::string>
+        resolve( std::string const& dllName,
+                 std::filesystem::path const& directoryOfImporter )
+        {
+            if ( auto pathOfDLL = findInDirectory( dllName, directoryOfImporter ) )
+            {
+                return pathOfDLL;
+            }
+
+            for ( auto const& searchDirectory : m_searchDirectories )
+            {
+                if ( auto pathOfDLL = findInDirectory( dllName, searchDirectory ) )
+                {
+                    return pathOfDLL;
+                }
+            }
+
+            return std::nullopt;
+        }
+
+    private:
+        std::optional<std::string>
+        findInDirectory( std::string const& dllName,
+                         std::filesystem::path const& directory )
+        {
+            auto errorCode = std::error_code{};
+
+            for ( auto const& candidateName : { dllName, toLowercase( dllName ) } )
+            {
+                auto const candidatePath = directory / candidateName;
+                if ( std::filesystem::is_regular_file( candidatePath, errorCode ) )
+                {
+                    return candidatePath.string();
+                }
+            }
+
+            auto [directoryListing, isNewListing] = m_directoryToLowercaseNames.try_emplace( directory.string() );
+            if ( isNewListing )
+            {
+                for ( auto const& directoryEntry : std::filesystem::directory_iterator( directory, errorCode ) )
+                {
+                    directoryListing->second.emplace( toLowercase( directoryEntry.path().filename().string() ),
+                                                      directoryEntry.path().string() );
+                }
+            }
+
+            auto const listedPath = directoryListing->second.find( toLowercase( dllName ) );
+            if ( listedPath == directoryListing->second.end() )
+            {
+                return std::nullopt;
+            }
+
+            return listedPath->second;
+        }
+
+    private:
+        std::vector<std::string> const&                                                   m_searchDirectories;
+        std::unordered_map<std::string, std::unordered_map<std::string, std::string>>    m_directoryToLowercaseNames;
+    };
+
+    // Walks the imports breadth first, listing every DLL once at the depth it
+    // is first reached. A DLL that is found but cannot be parsed, e.g. a
+    // 32-bit one, is listed with the reason and not descended into.
+    std::vector<std::string>
+    answerClosure( ImageCache& imageCache,
+                   std::shared_ptr<ResidentImage const> rootImage,
+                   ImageQueryOptions const& imageQueryOptions )
+    {
+        auto dependencyResolver = DependencyResolver{ imageQueryOptions.searchDirectories };
+
+        auto pendingImages = std::deque<std::pair<std::shared_ptr<ResidentImage const>, int>>{};
+        pendingImages.emplace_back( std::move( rootImage ), 1 );
+
+        auto visitedDLLNames = std::unordered_set<std::string>{};
+        auto resultLines = std::vector<std::string>{};
+
+        while ( not pendingImages.empty() )
+        {
+            auto const [residentImage, depth] = std::move( pendingImages.front() );
+            pendingImages.pop_front();
+
+            auto const directoryOfImporter = std::filesystem::path( residentImage->canonicalPath ).parent_path();
+
+            for ( auto const& [importedDLLName, importedFunctions] : residentImage->exeFile.importedDLLToImportedFunctions )
+            {
+                if ( not visitedDLLNames.insert( toLowercase( importedDLLName ) ).second )
+                {
+                    continue;
+                }
+
+                auto resultLine = std::to_string( depth ) + '\t' + escapeField( importedDLLName ) + '\t';
+
+                auto const pathOfDLL = dependencyResolver.resolve( importedDLLName, directoryOfImporter );
+                if ( not pathOfDLL )
+                {
+                    resultLines.push_back( resultLine + '?' );
+                    continue;
+                }
+
+                resultLine += escapeField( *pathOfDLL );
+
+                try
+                {
+                    pendingImages.emplace_back( imageCache.getImage( *pathOfDLL ), depth + 1 );
+                }
+                catch ( std::runtime_error const& loadError )
+                {
+                    resultLine += "\terror: ";
+                    resultLine += escapeField( loadError.what() );
+                }
+
+                resultLines.push_back( std::move( resultLine ) );
+            }
+        }
+
+        return resultLines;
+    }
+
+    std::vector<std::string>
+    answerStats( ImageCache const& imageCache )
+    {
+        auto const imageCacheStatistics = imageCache.getStatistics();
+
+        return std::vector<std::string>
+        {
+            "images\t" + std::to_string( imageCacheStatistics.numberOfImages ),
+            "hits\t" + std::to_string( imageCacheStatistics.numberOfHits ),
+            "misses\t" + std::to_string( imageCacheStatistics.numberOfMisses ),
+            "evictions\t" + std::to_string( imageCacheStatistics.numberOfEvictions ),
+            "bytes\t" + std::to_string( imageCacheStatistics.estimatedMemoryUsageInBytes )
+        };
+    }
+}
+
+std::vector<std::string>
+answerImageQuery( ImageCache& imageCache,
+                  std::string_view const request,
+                  ImageQueryOptions const& imageQueryOptions )
+{
+    auto const requestFields = splitRequest( request );
+
+    if ( requestFields.empty() )
+    {
+        throw std::runtime_error{ "Empty request." };
+    }
+
+    auto const& command = requestFields.front();
+
+    if ( command == "stats" )
+    {
+        requireNumberOfArguments( requestFields, 0, 0 );
+        return answerStats( imageCache );
+    }
+
+    if ( command == "symbolize" )
+    {
+        requireNumberOfArguments( requestFields, 1, requestFields.size() );
+        return answerSymbolize( *imageCache.getImage( requestFields[1] ),
+                                std::vector<std::string>( requestFields.begin() + 2, requestFields.end() ) );
+    }
+
+    if ( command != "headers" and command != "imports" and command != "exports" and command != "closure" )
+    {
+        throw std::runtime_error{ "Unknown command '" + command + "'." };
+    }
+
+    requireNumberOfArguments( requestFields, 1, 1 );
+    auto residentImage = imageCache.getImage( requestFields[1] );
+
+    if ( command == "headers" )
+    {
+        return answerHeaders( *residentImage );
+    }
+
+    if ( command == "imports" )
+    {
+        return answerImports( *residentImage );
+    }
+
+    if ( command == "exports" )
+    {
+        return answerExports( *residentImage );
+    }
+
+    return answerClosure( imageCache, std::move( residentImage ), imageQueryOptions );
+}
\ No newline at end of file
@@ -0,0 +1,38 @@
+
+#ifndef IMAGEQUERIES_H
+#define IMAGEQUERIES_H
+
+#include "ImageCache.h"
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+struct ImageQueryOptions
+{
+    // Searched for the DLLs of a dependency closure after the directory of
+    // the image importing them.
+    std::vector<std::string>    searchDirectories;
+};
+
+// Answers one request of the ewea-server protocol with the lines of its
+// result. A request is a command and its arguments, separated by tabs, or by
+// spaces when the line has no tab:
+//
+//   headers PATH              GROUP<TAB>FIELD<TAB>VALUE per header field
+//   imports PATH              DLL<TAB>FUNCTION<TAB>IAT_SLOT_RVA
+//   exports PATH              NAME<TAB>RVA
+//   symbolize PATH RVA...     RVA<TAB>NAME+OFFSET, or RVA<TAB>? when unresolved
+//   closure PATH              DEPTH<TAB>DLL<TAB>PATH, or DEPTH<TAB>DLL<TAB>? when not found
+//   stats                     NAME<TAB>VALUE per cache statistic
+//
+// Names taken from an image, e.g. sections, DLLs and functions, have their
+// control characters and backslashes escaped as \xNN. Images are taken from
+// the cache. Throws std::runtime_error for a malformed
+// request or an image that cannot be read.
+std::vector<std::string>
+answerImageQuery( ImageCache& imageCache,
+                  std::string_view const request,
+                  ImageQueryOptions const& imageQueryOptions );
+
+#endif // IMAGEQUERIES_H
\ No newline at end of file
@@ -0,0 +1,301 @@
+
+#include "ImportReferences.h"
+
+#include "Instrumentation.h"
+#include "ParallelFor.h"
+#include "X86LengthDecoder.h"
+
+#include <algorithm>
+#include <tuple>
+
+namespace
+{
+    auto const sectionContainsCode = std::uint32_t{ 0x00000020 };
+    auto const sectionIsExecutable = std::uint32_t{ 0x20000000 };
+
+    // Sections without .pdata are swept in chunks of this size so that one
+    // large .text still spreads across all workers.
+    auto const linearSweepChunkSizeInBytes = std::uint32_t{ 1 } << 20;
+    auto const minimumWorkItemSizeInBytes = std::uint32_t{ 256 } << 10;
+
+    struct CodeSection
+    {
+        std::uint32_t           baseRVA;
+        PE::ByteReader          rawData;
+    };
+
+    struct CodeRange
+    {
+        CodeSection const*    codeSection;
+        std::uint32_t         beginRVA;
+        std::uint32_t         endRVA;
+    };
+
+    std::vector<CodeSection>
+    getExecutableSections( EXEFile const& loadedEXEFile )
+    {
+        auto codeSections = std::vector<CodeSection>{};
+
+        for ( auto const& [sectionName, sectionHeader] : loadedEXEFile.sectionHeadersNameToInfo )
+        {
+            auto const sectionRawData = loadedEXEFile.sectionNameToRawData.find( sectionName );
+
+            if (    not ( sectionHeader.sectionCharacteristics & ( sectionContainsCode | sectionIsExecutable ) )
+                 or sectionRawData == loadedEXEFile.sectionNameToRawData.end()
+                 or sectionRawData->second.empty() )
+            {
+                continue;
+            }
+
+            codeSections.push_back( CodeSection
+                                    {
+                                        .baseRVA = sectionHeader.sectionBaseAddressInMemory,
+                                        .rawData = PE::ByteReader{ sectionRawData->second }
+                                    } );
+        }
+
+        return codeSections;
+    }
+
+    CodeSection const*
+    findCodeSectionContaining( std::vector<CodeSection> const& codeSections,
+                               std::uint32_t const rva )
+    {
+        for ( auto const& codeSection : codeSections )
+        {
+            if ( rva >= codeSection.baseRVA and rva - codeSection.baseRVA < codeSection.rawData.size() )
+            {
+                return &codeSection;
+            }
+        }
+
+        return nullptr;
+    }
+
+    std::vector<CodeRange>
+    getCodeRanges( EXEFile const& loadedEXEFile,
+                   std::vector<CodeSection> const& codeSections )
+    {
+        auto codeRanges = std::vector<CodeRange>{};
+
+        for ( auto const& runtimeFunction : getRuntimeFunctions( loadedEXEFile ) )
+        {
+            auto const codeSection = findCodeSectionContaining( codeSections, runtimeFunction.beginRVA );
+
+            if ( codeSection == nullptr or runtimeFunction.endRVA <= runtimeFunction.beginRVA )
+            {
+                continue;
+            }
+
+            auto const sectionEndRVA = codeSection->baseRVA + static_cast<std::uint32_t>( codeSection->rawData.size() );
+
+            codeRanges.push_back( CodeRange
+                                  {
+                                      .codeSection = codeSection,
+                                      .beginRVA = runtimeFunction.beginRVA,
+                                      .endRVA = std::min( runtimeFunction.endRVA, sectionEndRVA )
+                                  } );
+        }
+
+        if ( not codeRanges.empty() )
+        {
+            return codeRanges;
+        }
+
+        for ( auto const& codeSection : codeSections )
+        {
+            auto const sectionEndRVA = codeSection.baseRVA + static_cast<std::uint32_t>( codeSection.rawData.size() );
+
+            for ( auto chunkRVA = codeSection.baseRVA; chunkRVA < sectionEndRVA; chunkRVA += linearSweepChunkSizeInBytes )
+            {
+                codeRanges.push_back( CodeRange
+                                      {
+                                          .codeSection = &codeSection,
+                                          .beginRVA = chunkRVA,
+                                          .endRVA = std::min( chunkRVA + linearSweepChunkSizeInBytes, sectionEndRVA )
+                                      } );
+            }
+        }
+
+        return codeRanges;
+    }
+
+    std::optional<ImportReferenceKind>
+    getImportReferenceKind( X86::InstructionKind const instructionKind )
+    {
+        switch ( instructionKind )
+        {
+            case X86::InstructionKind::IndirectCall:
+                return ImportReferenceKind::Call;
+            case X86::InstructionKind::IndirectJump:
+                return ImportReferenceKind::Jump;
+            case X86::InstructionKind::Load:
+                return ImportReferenceKind::Load;
+            default:
+                return std::nullopt;
+        }
+    }
+
+    void
+    sweepCodeRange( CodeRange const& codeRange,
+                    std::vector<std::uint32_t> const& sortedIATSlotRVAs,
+                    std::vector<ImportReference>& importReferences )
+    {
+        auto const& codeSection = *codeRange.codeSection;
+        auto const sectionBytes = codeSection.rawData.data();
+        auto const sectionSizeInBytes = codeSection.rawData.size();
+
+        // The last instruction of a range may run past its end, but never past
+        // the end of the section.
+        for ( auto offset = std::size_t{ codeRange.beginRVA - codeSection.baseRVA };
+              offset < codeRange.endRVA - codeSection.baseRVA; )
+        {
+            auto const decodedInstruction = X86::decodeInstruction( sectionBytes + offset, sectionSizeInBytes - offset );
+
+            if ( decodedInstruction.lengthInBytes == 0 )
+            {
+                return;
+            }
+
+            auto const instructionRVA = codeSection.baseRVA + static_cast<std::uint32_t>( offset );
+            offset += decodedInstruction.lengthInBytes;
+
+            if ( not decodedInstruction.hasRIPRelativeOperand )
+            {
+                continue;
+            }
+
+            auto const importReferenceKind = getImportReferenceKind( decodedInstruction.kind );
+            auto const targetRVA = std::int64_t{ instructionRVA } + decodedInstruction.lengthInBytes
+                                 + decodedInstruction.ripDisplacement;
+
+            if (    importReferenceKind
+                 and targetRVA >= 0
+                 and std::binary_search( sortedIATSlotRVAs.begin(), sortedIATSlotRVAs.end(), targetRVA ) )
+            {
+                importReferences.push_back( ImportReference
+                                            {
+                                                .iatSlotRVA = static_cast<std::uint32_t>( targetRVA ),
+                                                .instructionRVA = instructionRVA,
+                                                .kind = *importReferenceKind
+                                            } );
+            }
+        }
+    }
+}
+
+std::vector<ImportReference>
+findImportReferences( EXEFile const& loadedEXEFile )
+{
+    auto const importReferencesTimer = Instrumentation::ScopedTimer{ "Import references" };
+
+    auto sortedIATSlotRVAs = std::vector<std::uint32_t>{};
+    for ( auto const& [importedDLLName, importedFunctions] : loadedEXEFile.importedDLLToImportedFunctions )
+    {
+        for ( auto const& importedFunction : importedFunctions )
+        {
+            sortedIATSlotRVAs.push_back( importedFunction.iatSlotRVA );
+        }
+    }
+
+    std::sort( sortedIATSlotRVAs.begin(), sortedIATSlotRVAs.end() );
+
+    if ( sortedIATSlotRVAs.empty() )
+    {
+        return {};
+    }
+
+    auto const codeSections = getExecutableSections( loadedEXEFile );
+    auto const codeRanges = getCodeRanges( loadedEXEFile, codeSections );
+
+    // Group the ranges into work items of a few hundred KiB each; .pdata lists
+    // thousands of small functions, too fine grained to hand out one by one.
+    auto workItemBoundaries = std::vector<std::size_t>{ 0 };
+    auto workItemSizeInBytes = std::uint32_t{ 0 };
+
+    for ( auto i = std::size_t{ 0 }; i < codeRanges.size(); i++ )
+    {
+        workItemSizeInBytes += codeRanges[i].endRVA - codeRanges[i].beginRVA;
+
+        if ( workItemSizeInBytes >= minimumWorkItemSizeInBytes or i + 1 == codeRanges.size() )
+        {
+            workItemBoundaries.push_back( i + 1 );
+            workItemSizeInBytes = 0;
+        }
+    }
+
+    auto const numberOfWorkItems = workItemBoundaries.size() - 1;
+    auto workItemImportReferences = std::vector<std::vector<ImportReference>>( numberOfWorkItems );
+
+    parallelFor( numberOfWorkItems,
+                 [&]( std::size_t const workItemIdx )
+                 {
+                     for ( auto i = workItemBoundaries[workItemIdx]; i < workItemBoundaries[workItemIdx + 1]; i++ )
+                     {
+                         sweepCodeRange( codeRanges[i], sortedIATSlotRVAs, workItemImportReferences[workItemIdx] );
+                     }
+                 } );
+
+    auto importReferences = std::vector<ImportReference>{};
+    for ( auto const& importReferencesOfWorkItem : workItemImportReferences )
+    {
+        importReferences.insert( importReferences.end(),
+                                 importReferencesOfWorkItem.begin(), importReferencesOfWorkItem.end() );
+    }
+
+    auto const isOrderedBefore =
+        []( ImportReference const& lhs, ImportReference const& rhs )
+        {
+            return std::tie( lhs.iatSlotRVA, lhs.instructionRVA ) < std::tie( rhs.iatSlotRVA, rhs.instructionRVA );
+        };
+
+    auto const isSameReference =
+        []( ImportReference const& lhs, ImportReference const& rhs )
+        {
+            return lhs.iatSlotRVA == rhs.iatSlotRVA and lhs.instructionRVA == rhs.instructionRVA;
+        };
+
+    // Chained unwind entries and chunk boundaries can make two ranges decode
+    // the same instruction.
+    std::sort( importReferences.begin(), importReferences.end(), isOrderedBefore );
+    importReferences.erase( std::unique( importReferences.begin(), importReferences.end(), isSameReference ),
+                            importReferences.end() );
+
+    return importReferences;
+}
+
+std::span<ImportReference const>
+getReferencesToIATSlot( std::vector<ImportReference> const& importReferences,
+                        std::uint32_t const iatSlotRVA )
+{
+    auto const firstReference =
+        std::partition_point( importReferences.begin(), importReferences.end(),
+                              [iatSlotRVA]( ImportReference const& importReference )
+                              {
+                                  return importReference.iatSlotRVA < iatSlotRVA;
+                              } );
+    auto const lastReference =
+        std::partition_point( firstReference, importReferences.end(),
+                              [iatSlotRVA]( ImportReference const& importReference )
+                              {
+                                  return importReference.iatSlotRVA == iatSlotRVA;
+                              } );
+
+    return { firstReference, lastReference };
+}
+
+std::string
+getImportReferenceKindName( ImportReferenceKind const importReferenceKind )
+{
+    switch ( importReferenceKind )
+    {
+        case ImportReferenceKind::Call:
+            return "call";
+        case ImportReferenceKind::Jump:
+            return "jmp";
+        case ImportReferenceKind::Load:
+            return "mov";
+        default:
+            return "<Unknown kind>";
+    }
+}
\ No newline at end of file
@@ -0,0 +1,44 @@
+
+#ifndef IMPORTREFERENCES_H
+#define IMPORTREFERENCES_H
+
+#include "PEFiles.h"
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+enum class ImportReferenceKind : std::uint8_t
+{
+    Call,
+    Jump,
+    Load
+};
+
+struct ImportReference
+{
+    std::uint32_t          iatSlotRVA;
+    std::uint32_t          instructionRVA;
+    ImportReferenceKind    kind;
+};
+
+// Sweeps the executable sections of the image with a length decoder and
+// returns every call [rip+disp32], jmp [rip+disp32] and mov reg, [rip+disp32]
+// whose target is one of the import address table slots. When the image has
+// an exception directory the sweep starts at each function listed in .pdata,
+// otherwise the sections are swept linearly from their start. The references
+// are sorted by IAT slot, then by instruction RVA.
+std::vector<ImportReference>
+findImportReferences( EXEFile const& loadedEXEFile );
+
+// Returns the references to one IAT slot out of the sorted references
+// returned by findImportReferences.
+std::span<ImportReference const>
+getReferencesToIATSlot( std::vector<ImportReference> const& importReferences,
+                        std::uint32_t const iatSlotRVA );
+
+std::string
+getImportReferenceKindName( ImportReferenceKind const importReferenceKind );
+
+#endif // IMPORTREFERENCES_H
\ No newline at end of file
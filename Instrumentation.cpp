@@ -0,0 +1,276 @@
+
+#include "Instrumentation.h"
+
+#include <chrono>
+#include <deque>
+#include <iomanip>
+#include <mutex>
+#include <ostream>
+#include <utility>
+
+namespace
+{
+    auto const maximumNumberOfRetainedFileProfiles = std::size_t{ 4096 };
+
+    auto const processStartTime = std::chrono::steady_clock::now();
+
+    std::mutex                                     finishedFileProfilesMutex;
+    std::deque<Instrumentation::FileProfile>       finishedFileProfiles;
+    std::atomic<std::uint32_t>                     nextThreadIdx{ 0 };
+    std::mutex                                     workerFileProfilesMutex;
+
+    std::uint32_t
+    getCurrentThreadIdx()
+    {
+        thread_local auto const currentThreadIdx = nextThreadIdx++;
+
+        return currentThreadIdx;
+    }
+
+    void
+    writeJSONString( std::ostream& jsonOutput,
+                     std::string const& stringToWrite )
+    {
+        jsonOutput << '"';
+
+        for ( auto const character : stringToWrite )
+        {
+            switch ( character )
+            {
+                case '"':
+                    jsonOutput << "\\\"";
+                    break;
+                case '\\':
+                    jsonOutput << "\\\\";
+                    break;
+                case '\n':
+                    jsonOutput << "\\n";
+                    break;
+                case '\t':
+                    jsonOutput << "\\t";
+                    break;
+                default:
+                    if ( static_cast<unsigned char>( character ) < 0x20 )
+                    {
+                        jsonOutput << "\\u00" << "0123456789abcdef"[character >> 4] << "0123456789abcdef"[character & 0xF];
+                    }
+                    else
+                    {
+                        jsonOutput << character;
+                    }
+            }
+        }
+
+        jsonOutput << '"';
+    }
+
+    double
+    toMicroseconds( std::int64_t const nanoseconds )
+    {
+        return nanoseconds / 1000.0;
+    }
+}
+
+namespace Instrumentation
+{
+    namespace Detail
+    {
+        std::atomic<bool>                isEnabled{ false };
+        thread_local FileProfile*        currentFileProfile = nullptr;
+        thread_local int                 currentNestingDepth = 0;
+
+        std::int64_t
+        getNanosecondsSinceStart()
+        {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                       std::chrono::steady_clock::now() - processStartTime ).count();
+        }
+    }
+
+    void
+    setEnabled( bool const enabled )
+    {
+        Detail::isEnabled.store( enabled, std::memory_order_relaxed );
+    }
+
+    ScopedFileProfile::ScopedFileProfile( std::string const& pathOfProfiledFile )
+    {
+        if ( not isEnabled() or Detail::currentFileProfile != nullptr )
+        {
+            return;
+        }
+
+        m_fileProfile = new FileProfile
+        {
+            .path = pathOfProfiledFile,
+            .threadIdx = getCurrentThreadIdx(),
+            .startInNanoseconds = Detail::getNanosecondsSinceStart()
+        };
+
+        Detail::currentFileProfile = m_fileProfile;
+        Detail::currentNestingDepth = 0;
+    }
+
+    ScopedFileProfile::~ScopedFileProfile()
+    {
+        if ( m_fileProfile == nullptr )
+        {
+            return;
+        }
+
+        m_fileProfile->durationInNanoseconds =
+            Detail::getNanosecondsSinceStart() - m_fileProfile->startInNanoseconds;
+
+        Detail::currentFileProfile = nullptr;
+
+        auto const lock = std::lock_guard{ finishedFileProfilesMutex };
+
+        finishedFileProfiles.push_back( std::move( *m_fileProfile ) );
+        if ( finishedFileProfiles.size() > maximumNumberOfRetainedFileProfiles )
+        {
+            finishedFileProfiles.pop_front();
+        }
+
+        delete m_fileProfile;
+    }
+
+    ScopedWorkerProfile::ScopedWorkerProfile( ProfileContext const& profileContext )
+    {
+        if ( not isEnabled() or profileContext.fileProfile == nullptr )
+        {
+            return;
+        }
+
+        m_sharedFileProfile = profileContext.fileProfile;
+        m_workerFileProfile.threadIdx = getCurrentThreadIdx();
+
+        m_previousFileProfile = std::exchange( Detail::currentFileProfile, &m_workerFileProfile );
+        m_previousNestingDepth = std::exchange( Detail::currentNestingDepth, profileContext.nestingDepth );
+    }
+
+    ScopedWorkerProfile::~ScopedWorkerProfile()
+    {
+        if ( m_sharedFileProfile == nullptr )
+        {
+            return;
+        }
+
+        Detail::currentFileProfile = m_previousFileProfile;
+        Detail::currentNestingDepth = m_previousNestingDepth;
+
+        auto const lock = std::lock_guard{ workerFileProfilesMutex };
+
+        m_sharedFileProfile->timedScopes.insert( m_sharedFileProfile->timedScopes.end(),
+                                                 m_workerFileProfile.timedScopes.begin(),
+                                                 m_workerFileProfile.timedScopes.end() );
+        for ( auto i = 0; i < numberOfCounters; i++ )
+        {
+            m_sharedFileProfile->counters[i] += m_workerFileProfile.counters[i];
+        }
+    }
+
+    std::vector<FileProfile>
+    getFileProfiles()
+    {
+        auto const lock = std::lock_guard{ finishedFileProfilesMutex };
+
+        return std::vector<FileProfile>( finishedFileProfiles.begin(), finishedFileProfiles.end() );
+    }
+
+    void
+    clearFileProfiles()
+    {
+        auto const lock = std::lock_guard{ finishedFileProfilesMutex };
+
+        finishedFileProfiles.clear();
+    }
+
+    std::string
+    getCounterName( Counter const counter )
+    {
+        switch ( counter )
+        {
+            case Counter::BytesRead:
+                return "Bytes read";
+            case Counter::Allocations:
+                return "Allocations";
+            case Counter::NamesDecoded:
+                return "Names decoded";
+            case Counter::WidgetsCreated:
+                return "Widgets created";
+            default:
+                return "<Unknown counter>";
+        }
+    }
+
+    void
+    writeChromeTrace( std::ostream& traceOutput,
+                      std::vector<FileProfile> const& fileProfiles )
+    {
+        // Timestamps count from process start, so the default six significant
+        // digits would round them to tens of microseconds after a second.
+        auto const previousFlags = traceOutput.flags();
+        auto const previousPrecision = traceOutput.precision();
+        traceOutput << std::fixed << std::setprecision( 3 );
+
+        traceOutput << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+        auto isFirstEvent = true;
+        auto const beginEvent =
+            [&]()
+            {
+                traceOutput << ( isFirstEvent ? "\n" : ",\n" );
+                isFirstEvent = false;
+            };
+
+        for ( auto const& fileProfile : fileProfiles )
+        {
+            beginEvent();
+            traceOutput << "{\"name\":";
+            writeJSONString( traceOutput, fileProfile.path );
+            traceOutput << ",\"cat\":\"file\",\"ph\":\"X\",\"pid\":1,\"tid\":" << fileProfile.threadIdx
+                        << ",\"ts\":" << toMicroseconds( fileProfile.startInNanoseconds )
+                        << ",\"dur\":" << toMicroseconds( fileProfile.durationInNanoseconds )
+                        << ",\"args\":{";
+
+            for ( auto i = 0; i < numberOfCounters; i++ )
+            {
+                traceOutput << ( i == 0 ? "" : "," );
+                writeJSONString( traceOutput, getCounterName( static_cast<Counter>( i ) ) );
+                traceOutput << ':' << fileProfile.counters[i];
+            }
+
+            traceOutput << "}}";
+
+            for ( auto const& timedScope : fileProfile.timedScopes )
+            {
+                beginEvent();
+                traceOutput << "{\"name\":";
+                writeJSONString( traceOutput, timedScope.name );
+                traceOutput << ",\"cat\":\"stage\",\"ph\":\"X\",\"pid\":1,\"tid\":" << timedScope.threadIdx
+                            << ",\"ts\":" << toMicroseconds( timedScope.startInNanoseconds )
+                            << ",\"dur\":" << toMicroseconds( timedScope.durationInNanoseconds )
+                            << '}';
+            }
+
+            beginEvent();
+            traceOutput << "{\"name\":\"counters\",\"ph\":\"C\",\"pid\":1,\"tid\":" << fileProfile.threadIdx
+                        << ",\"ts\":" << toMicroseconds( fileProfile.startInNanoseconds + fileProfile.durationInNanoseconds )
+                        << ",\"args\":{";
+
+            for ( auto i = 0; i < numberOfCounters; i++ )
+            {
+                traceOutput << ( i == 0 ? "" : "," );
+                writeJSONString( traceOutput, getCounterName( static_cast<Counter>( i ) ) );
+                traceOutput << ':' << fileProfile.counters[i];
+            }
+
+            traceOutput << "}}";
+        }
+
+        traceOutput << "\n]}\n";
+
+        traceOutput.flags( previousFlags );
+        traceOutput.precision( previousPrecision );
+    }
+}
\ No newline at end of file
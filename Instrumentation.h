@@ -0,0 +1,173 @@
+
+#ifndef INSTRUMENTATION_H
+#define INSTRUMENTATION_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace Instrumentation
+{
+    enum class Counter
+    {
+        BytesRead,
+        Allocations,
+        NamesDecoded,
+        WidgetsCreated
+    };
+
+    inline constexpr auto numberOfCounters = 4;
+
+    struct TimedScope
+    {
+        char const*     name;
+        std::int64_t    startInNanoseconds;
+        std::int64_t    durationInNanoseconds;
+        int             nestingDepth;
+        std::uint32_t   threadIdx;
+    };
+
+    struct FileProfile
+    {
+        std::string                                      path;
+        std::uint32_t                                    threadIdx = 0;
+        std::int64_t                                     startInNanoseconds = 0;
+        std::int64_t                                     durationInNanoseconds = 0;
+        std::vector<TimedScope>                          timedScopes;
+        std::array<std::uint64_t, numberOfCounters>      counters{};
+    };
+
+    namespace Detail
+    {
+        extern std::atomic<bool>                isEnabled;
+        extern thread_local FileProfile*        currentFileProfile;
+        extern thread_local int                 currentNestingDepth;
+
+        std::int64_t
+        getNanosecondsSinceStart();
+    }
+
+    inline bool
+    isEnabled()
+    {
+        return Detail::isEnabled.load( std::memory_order_relaxed );
+    }
+
+    void
+    setEnabled( bool const enabled );
+
+    inline void
+    addToCounter( Counter const counter,
+                  std::uint64_t const amount = 1 )
+    {
+        if ( isEnabled() and Detail::currentFileProfile != nullptr )
+        {
+            Detail::currentFileProfile->counters[static_cast<int>( counter )] += amount;
+        }
+    }
+
+    class ScopedFileProfile
+    {
+    public:
+        explicit ScopedFileProfile( std::string const& pathOfProfiledFile );
+        ~ScopedFileProfile();
+
+        ScopedFileProfile( ScopedFileProfile const& ) = delete;
+        ScopedFileProfile& operator=( ScopedFileProfile const& ) = delete;
+
+    private:
+        FileProfile*    m_fileProfile = nullptr;
+    };
+
+    // The file profile a thread is recording into, and how deep it is
+    // nested, to be handed to the worker threads it starts.
+    struct ProfileContext
+    {
+        FileProfile*    fileProfile = nullptr;
+        int             nestingDepth = 0;
+    };
+
+    inline ProfileContext
+    getCurrentProfileContext()
+    {
+        return ProfileContext{ .fileProfile = Detail::currentFileProfile, .nestingDepth = Detail::currentNestingDepth };
+    }
+
+    // Lets a worker thread record into the file profile of the thread that
+    // started it. The worker collects into a profile of its own, nested below
+    // the scope open when the context was taken, and merges it in when the
+    // scope ends. Until every worker is done, the starting thread must not
+    // record into the profile itself.
+    class ScopedWorkerProfile
+    {
+    public:
+        explicit ScopedWorkerProfile( ProfileContext const& profileContext );
+        ~ScopedWorkerProfile();
+
+        ScopedWorkerProfile( ScopedWorkerProfile const& ) = delete;
+        ScopedWorkerProfile& operator=( ScopedWorkerProfile const& ) = delete;
+
+    private:
+        FileProfile*    m_sharedFileProfile = nullptr;
+        FileProfile     m_workerFileProfile;
+        FileProfile*    m_previousFileProfile = nullptr;
+        int             m_previousNestingDepth = 0;
+    };
+
+    class ScopedTimer
+    {
+    public:
+        explicit ScopedTimer( char const* scopeName )
+        {
+            if ( isEnabled() and Detail::currentFileProfile != nullptr )
+            {
+                m_scopeName = scopeName;
+                m_startInNanoseconds = Detail::getNanosecondsSinceStart();
+                m_nestingDepth = Detail::currentNestingDepth++;
+            }
+        }
+
+        ~ScopedTimer()
+        {
+            if ( m_scopeName != nullptr and Detail::currentFileProfile != nullptr )
+            {
+                Detail::currentNestingDepth--;
+                Detail::currentFileProfile->timedScopes.push_back(
+                    TimedScope
+                    {
+                        .name = m_scopeName,
+                        .startInNanoseconds = m_startInNanoseconds,
+                        .durationInNanoseconds = Detail::getNanosecondsSinceStart() - m_startInNanoseconds,
+                        .nestingDepth = m_nestingDepth,
+                        .threadIdx = Detail::currentFileProfile->threadIdx
+                    } );
+            }
+        }
+
+        ScopedTimer( ScopedTimer const& ) = delete;
+        ScopedTimer& operator=( ScopedTimer const& ) = delete;
+
+    private:
+        char const*     m_scopeName = nullptr;
+        std::int64_t    m_startInNanoseconds = 0;
+        int             m_nestingDepth = 0;
+    };
+
+    std::vector<FileProfile>
+    getFileProfiles();
+
+    void
+    clearFileProfiles();
+
+    std::string
+    getCounterName( Counter const counter );
+
+    void
+    writeChromeTrace( std::ostream& traceOutput,
+                      std::vector<FileProfile> const& fileProfiles );
+}
+
+#endif // INSTRUMENTATION_H
\ No newline at end of file
@@ -0,0 +1,213 @@
+
+#include "KnownOrdinals.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <stdexcept>
+
+namespace
+{
+    struct KnownOrdinal
+    {
+        std::string_view    dllName;
+        std::uint16_t       ordinal;
+        std::string_view    name;
+    };
+
+    // Lowercase DLL names without ".dll", as GenerateKnownOrdinals.cmake
+    // writes them.
+    constexpr KnownOrdinal knownOrdinals[] =
+    {
+        #include "KnownOrdinalsData.inc"
+    };
+
+    constexpr auto numberOfKnownOrdinals = std::size( knownOrdinals );
+
+    // Hash and displace: every key falls into a bucket of about four keys,
+    // and every bucket gets the seed that places its keys in free slots of
+    // the table. Looking a key up then takes one seed and one slot, with a
+    // single comparison to reject keys that are not in the table.
+    constexpr auto numberOfBuckets = std::max<std::size_t>( numberOfKnownOrdinals / 4, 1 );
+    constexpr auto numberOfSlots = std::bit_ceil( 2 * numberOfKnownOrdinals );
+    constexpr auto emptySlot = std::uint32_t{ 0xFFFFFFFF };
+
+    constexpr std::uint64_t
+    mixBits( std::uint64_t bits )
+    {
+        bits = ( bits ^ ( bits >> 30 ) ) * 0xBF58476D1CE4E5B9;
+        bits = ( bits ^ ( bits >> 27 ) ) * 0x94D049BB133111EB;
+        return bits ^ ( bits >> 31 );
+    }
+
+    // The name is expected in lowercase, without ".dll".
+    constexpr std::uint64_t
+    hashKey( std::string_view const dllName,
+             std::uint16_t const ordinal )
+    {
+        auto keyHash = std::uint64_t{ 0xCBF29CE484222325 };
+        for ( auto const character : dllName )
+        {
+            keyHash = ( keyHash ^ static_cast<unsigned char>( character ) ) * 0x100000001B3;
+        }
+
+        return mixBits( keyHash ^ ordinal );
+    }
+
+    constexpr std::size_t
+    getBucketIdx( std::uint64_t const keyHash )
+    {
+        return static_cast<std::size_t>( keyHash % numberOfBuckets );
+    }
+
+    constexpr std::size_t
+    getSlotIdx( std::uint64_t const keyHash,
+                std::uint32_t const seed )
+    {
+        return static_cast<std::size_t>( mixBits( keyHash + seed * 0x9E3779B97F4A7C15 ) & ( numberOfSlots - 1 ) );
+    }
+
+    struct PerfectHashTable
+    {
+        std::array<std::uint32_t, numberOfBuckets>    seeds = {};
+        std::array<std::uint32_t, numberOfSlots>      knownOrdinalIndices = {};
+    };
+
+    // Evaluated by the compiler; a duplicate key throws, which fails the
+    // build rather than hiding one of the names.
+    constexpr PerfectHashTable
+    buildPerfectHashTable()
+    {
+        auto perfectHashTable = PerfectHashTable{};
+        perfectHashTable.knownOrdinalIndices.fill( emptySlot );
+
+        auto keyHashes = std::array<std::uint64_t, numberOfKnownOrdinals>{};
+        for ( auto knownOrdinalIdx = std::size_t{ 0 }; knownOrdinalIdx < numberOfKnownOrdinals; knownOrdinalIdx++ )
+        {
+            keyHashes[knownOrdinalIdx] = hashKey( knownOrdinals[knownOrdinalIdx].dllName, knownOrdinals[knownOrdinalIdx].ordinal );
+        }
+
+        // The keys grouped by bucket. The buckets are placed largest first,
+        // while the table is emptiest, since those are the hard ones.
+        auto keyOffsets = std::array<std::size_t, numberOfBuckets + 1>{};
+        for ( auto const keyHash : keyHashes )
+        {
+            keyOffsets[getBucketIdx( keyHash ) + 1]++;
+        }
+
+        for ( auto bucketIdx = std::size_t{ 0 }; bucketIdx < numberOfBuckets; bucketIdx++ )
+        {
+            keyOffsets[bucketIdx + 1] += keyOffsets[bucketIdx];
+        }
+
+        auto keysOfBuckets = std::array<std::uint32_t, numberOfKnownOrdinals>{};
+        auto nextKeyPositions = keyOffsets;
+        for ( auto knownOrdinalIdx = std::uint32_t{ 0 }; knownOrdinalIdx < numberOfKnownOrdinals; knownOrdinalIdx++ )
+        {
+            keysOfBuckets[nextKeyPositions[getBucketIdx( keyHashes[knownOrdinalIdx] )]++] = knownOrdinalIdx;
+        }
+
+        auto maximumBucketSize = std::size_t{ 0 };
+        for ( auto bucketIdx = std::size_t{ 0 }; bucketIdx < numberOfBuckets; bucketIdx++ )
+        {
+            maximumBucketSize = std::max( maximumBucketSize, keyOffsets[bucketIdx + 1] - keyOffsets[bucketIdx] );
+        }
+
+        for ( auto bucketSize = maximumBucketSize; bucketSize > 0; bucketSize-- )
+        {
+            for ( auto bucketIdx = std::size_t{ 0 }; bucketIdx < numberOfBuckets; bucketIdx++ )
+            {
+                if ( keyOffsets[bucketIdx + 1] - keyOffsets[bucketIdx] != bucketSize )
+                {
+                    continue;
+                }
+
+                auto const firstKey = keysOfBuckets.begin() + keyOffsets[bucketIdx];
+                auto const lastKey = keysOfBuckets.begin() + keyOffsets[bucketIdx + 1];
+
+                for ( auto key = firstKey; key != lastKey; ++key )
+                {
+                    for ( auto otherKey = firstKey; otherKey != key; ++otherKey )
+                    {
+                        if (     knownOrdinals[*key].ordinal == knownOrdinals[*otherKey].ordinal
+                             and knownOrdinals[*key].dllName == knownOrdinals[*otherKey].dllName )
+                        {
+                            throw std::logic_error{ "An ordinal is listed twice." };
+                        }
+                    }
+                }
+
+                for ( auto seed = std::uint32_t{ 0 };; seed++ )
+                {
+                    auto isPlaced = true;
+                    for ( auto key = firstKey; key != lastKey and isPlaced; ++key )
+                    {
+                        auto const slotIdx = getSlotIdx( keyHashes[*key], seed );
+                        isPlaced = perfectHashTable.knownOrdinalIndices[slotIdx] == emptySlot;
+
+                        if ( isPlaced )
+                        {
+                            perfectHashTable.knownOrdinalIndices[slotIdx] = *key;
+                        }
+                        else
+                        {
+                            // Undoes the keys of the bucket placed so far, which
+                            // may include the occupant of the slot.
+                            for ( auto placedKey = firstKey; placedKey != key; ++placedKey )
+                            {
+                                perfectHashTable.knownOrdinalIndices[getSlotIdx( keyHashes[*placedKey], seed )] = emptySlot;
+                            }
+                        }
+                    }
+
+                    if ( isPlaced )
+                    {
+                        perfectHashTable.seeds[bucketIdx] = seed;
+                        break;
+                    }
+                }
+            }
+        }
+
+        return perfectHashTable;
+    }
+
+    constexpr auto perfectHashTable = buildPerfectHashTable();
+}
+
+std::string_view
+findKnownOrdinalName( std::string_view const dllName,
+                      std::uint16_t const ordinal )
+{
+    auto lowercaseDLLName = std::array<char, 64>{};
+    if ( dllName.size() > lowercaseDLLName.size() )
+    {
+        return {};
+    }
+
+    std::transform( dllName.begin(), dllName.end(), lowercaseDLLName.begin(),
+                    []( char const character )
+                    {
+                        return character >= 'A' and character <= 'Z' ? static_cast<char>( character - 'A' + 'a' ) : character;
+                    } );
+
+    auto keyDLLName = std::string_view( lowercaseDLLName.data(), dllName.size() );
+    if ( keyDLLName.ends_with( ".dll" ) )
+    {
+        keyDLLName.remove_suffix( 4 );
+    }
+
+    auto const keyHash = hashKey( keyDLLName, ordinal );
+    auto const slotIdx = getSlotIdx( keyHash, perfectHashTable.seeds[getBucketIdx( keyHash )] );
+    auto const knownOrdinalIdx = perfectHashTable.knownOrdinalIndices[slotIdx];
+
+    if (    knownOrdinalIdx == emptySlot
+         or knownOrdinals[knownOrdinalIdx].ordinal != ordinal
+         or knownOrdinals[knownOrdinalIdx].dllName != keyDLLName )
+    {
+        return {};
+    }
+
+    return knownOrdinals[knownOrdinalIdx].name;
+}
\ No newline at end of file
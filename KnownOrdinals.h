@@ -0,0 +1,16 @@
+
+#ifndef KNOWNORDINALS_H
+#define KNOWNORDINALS_H
+
+#include <cstdint>
+#include <string_view>
+
+// The names behind the ordinals of DLLs commonly imported by ordinal alone,
+// such as ws2_32 and oleaut32, taken from the .def files under ordinals/ at
+// build time. The DLL name is matched regardless of case and of a trailing
+// ".dll". Returns an empty view when the ordinal is not known.
+std::string_view
+findKnownOrdinalName( std::string_view const dllName,
+                      std::uint16_t const ordinal );
+
+#endif // KNOWNORDINALS_H
\ No newline at end of file
@@ -0,0 +1,69 @@
+
+#include "LazyTabWidget.h"
+
+#include <utility>
+
+LazyTabWidget::LazyTabWidget( QWidget* parentWidget )
+: QTabWidget( parentWidget )
+{
+    connect( this, &QTabWidget::currentChanged,
+             [this]( int const currentTabIdx )
+             {
+                buildTabIfNeeded( currentTabIdx );
+             } );
+}
+
+void
+LazyTabWidget::addLazyTab( QString const& tabTitle,
+                           TabBuilder&& tabBuilder,
+                           bool const isReady )
+{
+    // The empty root widget stands in for the tab until it is first shown;
+    // adding the first tab makes it current, which builds it right away
+    // unless it is not ready yet.
+    m_pendingTabBuilders.push_back( std::move( tabBuilder ) );
+
+    auto const tabIdx = static_cast<int>( m_pendingTabBuilders.size() ) - 1;
+    if ( not isReady )
+    {
+        m_notReadyTabIndices.insert( tabIdx );
+    }
+
+    addTab( new QWidget, tabTitle );
+
+    if ( not isReady )
+    {
+        setTabEnabled( tabIdx, false );
+    }
+}
+
+void
+LazyTabWidget::markTabReady( int const tabIdx )
+{
+    if ( m_notReadyTabIndices.erase( tabIdx ) == 0 )
+    {
+        return;
+    }
+
+    setTabEnabled( tabIdx, true );
+
+    if ( tabIdx == currentIndex() )
+    {
+        buildTabIfNeeded( tabIdx );
+    }
+}
+
+void
+LazyTabWidget::buildTabIfNeeded( int const tabIdx )
+{
+    if (    tabIdx < 0
+         or tabIdx >= static_cast<int>( m_pendingTabBuilders.size() )
+         or not m_pendingTabBuilders[tabIdx]
+         or m_notReadyTabIndices.contains( tabIdx ) )
+    {
+        return;
+    }
+
+    auto const tabBuilder = std::exchange( m_pendingTabBuilders[tabIdx], nullptr );
+    tabBuilder( widget( tabIdx ) );
+}
\ No newline at end of file
@@ -0,0 +1,40 @@
+
+#ifndef LAZYTABWIDGET_H
+#define LAZYTABWIDGET_H
+
+#include <QTabWidget>
+
+#include <functional>
+#include <set>
+#include <vector>
+
+class LazyTabWidget : public QTabWidget
+{
+    Q_OBJECT
+
+public:
+    LazyTabWidget( QWidget* parentWidget = nullptr );
+
+protected:
+    using TabBuilder = std::function<void( QWidget* tabRootWidget )>;
+
+    // A tab added as not ready stays disabled, and unbuilt, until
+    // markTabReady() is called for it.
+    void
+    addLazyTab( QString const& tabTitle,
+                TabBuilder&& tabBuilder,
+                bool const isReady = true );
+
+    void
+    markTabReady( int const tabIdx );
+
+private:
+    void
+    buildTabIfNeeded( int const tabIdx );
+
+private:
+    std::vector<TabBuilder>    m_pendingTabBuilders;
+    std::set<int>              m_notReadyTabIndices;
+};
+
+#endif // LAZYTABWIDGET_H
\ No newline at end of file
@@ -0,0 +1,681 @@
+
+#include "ManagedMetadata.h"
+
+#include "PEFieldDescriptors.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+
+namespace
+{
+    auto const clrHeaderIdx = 14;
+
+    auto const metadataRootSignature = std::uint32_t{ 0x424A5342 };
+
+    // Set in the heap sizes of the #~ stream when an index into that heap is
+    // four bytes wide instead of two.
+    auto const wideStringIndicesBit = 0x01;
+    auto const wideGUIDIndicesBit = 0x02;
+    auto const wideBlobIndicesBit = 0x04;
+
+    // Set by some compilers when four bytes of extra data follow the row
+    // counts.
+    auto const extraDataBit = 0x40;
+
+    // Marks a coded index tag that names no table.
+    auto const noTable = static_cast<MetadataTable>( 0xFF );
+
+    constexpr MetadataColumn
+    constant16( char const* name )
+    {
+        return MetadataColumn{ .name = name, .kind = MetadataColumnKind::Constant16 };
+    }
+
+    constexpr MetadataColumn
+    constant32( char const* name )
+    {
+        return MetadataColumn{ .name = name, .kind = MetadataColumnKind::Constant32 };
+    }
+
+    constexpr MetadataColumn
+    stringIndex( char const* name )
+    {
+        return MetadataColumn{ .name = name, .kind = MetadataColumnKind::StringIndex };
+    }
+
+    constexpr MetadataColumn
+    guidIndex( char const* name )
+    {
+        return MetadataColumn{ .name = name, .kind = MetadataColumnKind::GUIDIndex };
+    }
+
+    constexpr MetadataColumn
+    blobIndex( char const* name )
+    {
+        return MetadataColumn{ .name = name, .kind = MetadataColumnKind::BlobIndex };
+    }
+
+    constexpr MetadataColumn
+    tableIndex( char const* name,
+                MetadataTable const metadataTable )
+    {
+        return MetadataColumn{ .name = name, .kind = MetadataColumnKind::TableIndex, .target = static_cast<std::uint8_t>( metadataTable ) };
+    }
+
+    constexpr MetadataColumn
+    codedIndex( char const* name,
+                CodedIndexKind const codedIndexKind )
+    {
+        return MetadataColumn{ .name = name, .kind = MetadataColumnKind::CodedIndex, .target = static_cast<std::uint8_t>( codedIndexKind ) };
+    }
+
+    using enum MetadataTable;
+    using enum CodedIndexKind;
+
+    constexpr MetadataColumn moduleColumns[] = { constant16( "Generation" ), stringIndex( "Name" ), guidIndex( "Mvid" ), guidIndex( "EncId" ), guidIndex( "EncBaseId" ) };
+    constexpr MetadataColumn typeRefColumns[] = { codedIndex( "ResolutionScope", ResolutionScope ), stringIndex( "TypeName" ), stringIndex( "TypeNamespace" ) };
+    constexpr MetadataColumn typeDefColumns[] = { constant32( "Flags" ), stringIndex( "TypeName" ), stringIndex( "TypeNamespace" ), codedIndex( "Extends", TypeDefOrRef ),
+                                                  tableIndex( "FieldList", Field ), tableIndex( "MethodList", MethodDef ) };
+    constexpr MetadataColumn fieldPtrColumns[] = { tableIndex( "Field", Field ) };
+    constexpr MetadataColumn fieldColumns[] = { constant16( "Flags" ), stringIndex( "Name" ), blobIndex( "Signature" ) };
+    constexpr MetadataColumn methodPtrColumns[] = { tableIndex( "Method", MethodDef ) };
+    constexpr MetadataColumn methodDefColumns[] = { constant32( "RVA" ), constant16( "ImplFlags" ), constant16( "Flags" ), stringIndex( "Name" ), blobIndex( "Signature" ),
+                                                    tableIndex( "ParamList", Param ) };
+    constexpr MetadataColumn paramPtrColumns[] = { tableIndex( "Param", Param ) };
+    constexpr MetadataColumn paramColumns[] = { constant16( "Flags" ), constant16( "Sequence" ), stringIndex( "Name" ) };
+    constexpr MetadataColumn interfaceImplColumns[] = { tableIndex( "Class", TypeDef ), codedIndex( "Interface", TypeDefOrRef ) };
+    constexpr MetadataColumn memberRefColumns[] = { codedIndex( "Class", MemberRefParent ), stringIndex( "Name" ), blobIndex( "Signature" ) };
+    constexpr MetadataColumn constantColumns[] = { constant16( "Type" ), codedIndex( "Parent", HasConstant ), blobIndex( "Value" ) };
+    constexpr MetadataColumn customAttributeColumns[] = { codedIndex( "Parent", HasCustomAttribute ), codedIndex( "Type", CustomAttributeType ), blobIndex( "Value" ) };
+    constexpr MetadataColumn fieldMarshalColumns[] = { codedIndex( "Parent", HasFieldMarshal ), blobIndex( "NativeType" ) };
+    constexpr MetadataColumn declSecurityColumns[] = { constant16( "Action" ), codedIndex( "Parent", HasDeclSecurity ), blobIndex( "PermissionSet" ) };
+    constexpr MetadataColumn classLayoutColumns[] = { constant16( "PackingSize" ), constant32( "ClassSize" ), tableIndex( "Parent", TypeDef ) };
+    constexpr MetadataColumn fieldLayoutColumns[] = { constant32( "Offset" ), tableIndex( "Field", Field ) };
+    constexpr MetadataColumn standAloneSigColumns[] = { blobIndex( "Signature" ) };
+    constexpr MetadataColumn eventMapColumns[] = { tableIndex( "Parent", TypeDef ), tableIndex( "EventList", Event ) };
+    constexpr MetadataColumn eventPtrColumns[] = { tableIndex( "Event", Event ) };
+    constexpr MetadataColumn eventColumns[] = { constant16( "EventFlags" ), stringIndex( "Name" ), codedIndex( "EventType", TypeDefOrRef ) };
+    constexpr MetadataColumn propertyMapColumns[] = { tableIndex( "Parent", TypeDef ), tableIndex( "PropertyList", Property ) };
+    constexpr MetadataColumn propertyPtrColumns[] = { tableIndex( "Property", Property ) };
+    constexpr MetadataColumn propertyColumns[] = { constant16( "Flags" ), stringIndex( "Name" ), blobIndex( "Type" ) };
+    constexpr MetadataColumn methodSemanticsColumns[] = { constant16( "Semantics" ), tableIndex( "Method", MethodDef ), codedIndex( "Association", HasSemantics ) };
+    constexpr MetadataColumn methodImplColumns[] = { tableIndex( "Class", TypeDef ), codedIndex( "MethodBody", MethodDefOrRef ), codedIndex( "MethodDeclaration", MethodDefOrRef ) };
+    constexpr MetadataColumn moduleRefColumns[] = { stringIndex( "Name" ) };
+    constexpr MetadataColumn typeSpecColumns[] = { blobIndex( "Signature" ) };
+    constexpr MetadataColumn implMapColumns[] = { constant16( "MappingFlags" ), codedIndex( "MemberForwarded", MemberForwarded ), stringIndex( "ImportName" ),
+                                                  tableIndex( "ImportScope", ModuleRef ) };
+    constexpr MetadataColumn fieldRVAColumns[] = { constant32( "RVA" ), tableIndex( "Field", Field ) };
+    constexpr MetadataColumn encLogColumns[] = { constant32( "Token" ), constant32( "FuncCode" ) };
+    constexpr MetadataColumn encMapColumns[] = { constant32( "Token" ) };
+    constexpr MetadataColumn assemblyColumns[] = { constant32( "HashAlgId" ), constant16( "MajorVersion" ), constant16( "MinorVersion" ), constant16( "BuildNumber" ),
+                                                   constant16( "RevisionNumber" ), constant32( "Flags" ), blobIndex( "PublicKey" ), stringIndex( "Name" ),
+                                                   stringIndex( "Culture" ) };
+    constexpr MetadataColumn assemblyProcessorColumns[] = { constant32( "Processor" ) };
+    constexpr MetadataColumn assemblyOSColumns[] = { constant32( "OSPlatformID" ), constant32( "OSMajorVersion" ), constant32( "OSMinorVersion" ) };
+    constexpr MetadataColumn assemblyRefColumns[] = { constant16( "MajorVersion" ), constant16( "MinorVersion" ), constant16( "BuildNumber" ), constant16( "RevisionNumber" ),
+                                                      constant32( "Flags" ), blobIndex( "PublicKeyOrToken" ), stringIndex( "Name" ), stringIndex( "Culture" ),
+                                                      blobIndex( "HashValue" ) };
+    constexpr MetadataColumn assemblyRefProcessorColumns[] = { constant32( "Processor" ), tableIndex( "AssemblyRef", AssemblyRef ) };
+    constexpr MetadataColumn assemblyRefOSColumns[] = { constant32( "OSPlatformId" ), constant32( "OSMajorVersion" ), constant32( "OSMinorVersion" ),
+                                                        tableIndex( "AssemblyRef", AssemblyRef ) };
+    constexpr MetadataColumn fileColumns[] = { constant32( "Flags" ), stringIndex( "Name" ), blobIndex( "HashValue" ) };
+    constexpr MetadataColumn exportedTypeColumns[] = { constant32( "Flags" ), constant32( "TypeDefId" ), stringIndex( "TypeName" ), stringIndex( "TypeNamespace" ),
+                                                       codedIndex( "Implementation", Implementation ) };
+    constexpr MetadataColumn manifestResourceColumns[] = { constant32( "Offset" ), constant32( "Flags" ), stringIndex( "Name" ), codedIndex( "Implementation", Implementation ) };
+    constexpr MetadataColumn nestedClassColumns[] = { tableIndex( "NestedClass", TypeDef ), tableIndex( "EnclosingClass", TypeDef ) };
+    constexpr MetadataColumn genericParamColumns[] = { constant16( "Number" ), constant16( "Flags" ), codedIndex( "Owner", TypeOrMethodDef ), stringIndex( "Name" ) };
+    constexpr MetadataColumn methodSpecColumns[] = { codedIndex( "Method", MethodDefOrRef ), blobIndex( "Instantiation" ) };
+    constexpr MetadataColumn genericParamConstraintColumns[] = { tableIndex( "Owner", GenericParam ), codedIndex( "Constraint", TypeDefOrRef ) };
+
+    struct TableSchema
+    {
+        char const*                        name;
+        std::span<MetadataColumn const>    columns;
+    };
+
+    constexpr TableSchema tableSchemas[] =
+    {
+        { "Module", moduleColumns },
+        { "TypeRef", typeRefColumns },
+        { "TypeDef", typeDefColumns },
+        { "FieldPtr", fieldPtrColumns },
+        { "Field", fieldColumns },
+        { "MethodPtr", methodPtrColumns },
+        { "MethodDef", methodDefColumns },
+        { "ParamPtr", paramPtrColumns },
+        { "Param", paramColumns },
+        { "InterfaceImpl", interfaceImplColumns },
+        { "MemberRef", memberRefColumns },
+        { "Constant", constantColumns },
+        { "CustomAttribute", customAttributeColumns },
+        { "FieldMarshal", fieldMarshalColumns },
+        { "DeclSecurity", declSecurityColumns },
+        { "ClassLayout", classLayoutColumns },
+        { "FieldLayout", fieldLayoutColumns },
+        { "StandAloneSig", standAloneSigColumns },
+        { "EventMap", eventMapColumns },
+        { "EventPtr", eventPtrColumns },
+        { "Event", eventColumns },
+        { "PropertyMap", propertyMapColumns },
+        { "PropertyPtr", propertyPtrColumns },
+        { "Property", propertyColumns },
+        { "MethodSemantics", methodSemanticsColumns },
+        { "MethodImpl", methodImplColumns },
+        { "ModuleRef", moduleRefColumns },
+        { "TypeSpec", typeSpecColumns },
+        { "ImplMap", implMapColumns },
+        { "FieldRVA", fieldRVAColumns },
+        { "ENCLog", encLogColumns },
+        { "ENCMap", encMapColumns },
+        { "Assembly", assemblyColumns },
+        { "AssemblyProcessor", assemblyProcessorColumns },
+        { "AssemblyOS", assemblyOSColumns },
+        { "AssemblyRef", assemblyRefColumns },
+        { "AssemblyRefProcessor", assemblyRefProcessorColumns },
+        { "AssemblyRefOS", assemblyRefOSColumns },
+        { "File", fileColumns },
+        { "ExportedType", exportedTypeColumns },
+        { "ManifestResource", manifestResourceColumns },
+        { "NestedClass", nestedClassColumns },
+        { "GenericParam", genericParamColumns },
+        { "MethodSpec", methodSpecColumns },
+        { "GenericParamConstraint", genericParamConstraintColumns }
+    };
+
+    static_assert( std::size( tableSchemas ) == numberOfMetadataTables );
+
+    constexpr MetadataTable typeDefOrRefTables[] = { TypeDef, TypeRef, TypeSpec };
+    constexpr MetadataTable hasConstantTables[] = { Field, Param, Property };
+    constexpr MetadataTable hasCustomAttributeTables[] = { MethodDef, Field, TypeRef, TypeDef, Param, InterfaceImpl, MemberRef, Module, DeclSecurity,
+                                                           Property, Event, StandAloneSig, ModuleRef, TypeSpec, Assembly, AssemblyRef, File,
+                                                           ExportedType, ManifestResource, GenericParam, GenericParamConstraint, MethodSpec };
+    constexpr MetadataTable hasFieldMarshalTables[] = { Field, Param };
+    constexpr MetadataTable hasDeclSecurityTables[] = { TypeDef, MethodDef, Assembly };
+    constexpr MetadataTable memberRefParentTables[] = { TypeDef, TypeRef, ModuleRef, MethodDef, TypeSpec };
+    constexpr MetadataTable hasSemanticsTables[] = { Event, Property };
+    constexpr MetadataTable methodDefOrRefTables[] = { MethodDef, MemberRef };
+    constexpr MetadataTable memberForwardedTables[] = { Field, MethodDef };
+    constexpr MetadataTable implementationTables[] = { File, AssemblyRef, ExportedType };
+    constexpr MetadataTable customAttributeTypeTables[] = { noTable, noTable, MethodDef, MemberRef, noTable };
+    constexpr MetadataTable resolutionScopeTables[] = { Module, ModuleRef, AssemblyRef, TypeRef };
+    constexpr MetadataTable typeOrMethodDefTables[] = { TypeDef, MethodDef };
+
+    struct CodedIndexSchema
+    {
+        std::uint32_t                     numberOfTagBits;
+        std::span<MetadataTable const>    tables;
+    };
+
+    constexpr CodedIndexSchema codedIndexSchemas[] =
+    {
+        { 2, typeDefOrRefTables },
+        { 2, hasConstantTables },
+        { 5, hasCustomAttributeTables },
+        { 1, hasFieldMarshalTables },
+        { 2, hasDeclSecurityTables },
+        { 3, memberRefParentTables },
+        { 1, hasSemanticsTables },
+        { 1, methodDefOrRefTables },
+        { 1, memberForwardedTables },
+        { 2, implementationTables },
+        { 3, customAttributeTypeTables },
+        { 2, resolutionScopeTables },
+        { 1, typeOrMethodDefTables }
+    };
+
+    // The metadata of the directory lies in one section, which holds at
+    // least the directory's size in raw data.
+    PE::ByteReader
+    getSectionBytesAtRVA( EXEFile const& loadedEXEFile,
+                          std::uint32_t const rva,
+                          std::uint32_t const sizeInBytes,
+                          char const* const description )
+    {
+        for ( auto const& [sectionName, sectionHeader] : loadedEXEFile.sectionHeadersNameToInfo )
+        {
+            auto const sectionRVA = sectionHeader.sectionBaseAddressInMemory;
+            if ( rva < sectionRVA or rva - sectionRVA >= sectionHeader.sectionSizeInBytesInMemory )
+            {
+                continue;
+            }
+
+            auto const sectionRawData = loadedEXEFile.sectionNameToRawData.find( sectionName );
+            if ( sectionRawData != loadedEXEFile.sectionNameToRawData.end() )
+            {
+                auto const bytes = PE::ByteReader{ sectionRawData->second }.subReader( rva - sectionRVA, sizeInBytes );
+                if ( bytes )
+                {
+                    return *bytes;
+                }
+            }
+
+            break;
+        }
+
+        throw std::runtime_error{ std::string( description ) + " lies outside of the section data." };
+    }
+
+    // Decodes the compressed unsigned length that starts every blob and
+    // user string, ECMA-335 II.23.2; returns the bytes it describes.
+    std::span<unsigned char const>
+    getLengthPrefixedBytes( PE::ByteReader const& heap,
+                            std::uint32_t const heapIdx )
+    {
+        if ( heapIdx >= heap.size() )
+        {
+            return {};
+        }
+
+        auto const* bytes = heap.data() + heapIdx;
+        auto const numberOfAvailableBytes = heap.size() - heapIdx;
+
+        auto length = std::size_t{ 0 };
+        auto numberOfLengthBytes = std::size_t{ 0 };
+
+        if ( ( bytes[0] & 0x80 ) == 0 )
+        {
+            length = bytes[0];
+            numberOfLengthBytes = 1;
+        }
+        else if ( ( bytes[0] & 0xC0 ) == 0x80 and numberOfAvailableBytes >= 2 )
+        {
+            length = ( std::size_t{ bytes[0] & 0x3Fu } << 8 ) | bytes[1];
+            numberOfLengthBytes = 2;
+        }
+        else if ( ( bytes[0] & 0xE0 ) == 0xC0 and numberOfAvailableBytes >= 4 )
+        {
+            length = ( std::size_t{ bytes[0] & 0x1Fu } << 24 ) | ( std::size_t{ bytes[1] } << 16 ) | ( std::size_t{ bytes[2] } << 8 ) | bytes[3];
+            numberOfLengthBytes = 4;
+        }
+        else
+        {
+            return {};
+        }
+
+        if ( length > numberOfAvailableBytes - numberOfLengthBytes )
+        {
+            return {};
+        }
+
+        return std::span<unsigned char const>( bytes + numberOfLengthBytes, length );
+    }
+
+    std::string
+    formatRowReference( std::optional<MetadataRowReference> const rowReference )
+    {
+        if ( not rowReference )
+        {
+            return "?";
+        }
+
+        if ( rowReference->rowNumber == 0 )
+        {
+            return "-";
+        }
+
+        return std::string( getMetadataTableName( rowReference->table ) ) + ' ' + std::to_string( rowReference->rowNumber );
+    }
+}
+
+char const*
+getMetadataTableName( MetadataTable const metadataTable )
+{
+    return tableSchemas[static_cast<std::size_t>( metadataTable )].name;
+}
+
+std::span<MetadataColumn const>
+getMetadataColumns( MetadataTable const metadataTable )
+{
+    return tableSchemas[static_cast<std::size_t>( metadataTable )].columns;
+}
+
+std::optional<MetadataRowReference>
+decodeCodedIndex( CodedIndexKind const codedIndexKind,
+                  std::uint32_t const codedIndex )
+{
+    auto const& codedIndexSchema = codedIndexSchemas[static_cast<std::size_t>( codedIndexKind )];
+    auto const tag = codedIndex & ( ( 1u << codedIndexSchema.numberOfTagBits ) - 1 );
+
+    if ( tag >= codedIndexSchema.tables.size() or codedIndexSchema.tables[tag] == noTable )
+    {
+        return std::nullopt;
+    }
+
+    return MetadataRowReference
+    {
+        .table = codedIndexSchema.tables[tag],
+        .rowNumber = codedIndex >> codedIndexSchema.numberOfTagBits
+    };
+}
+
+bool
+hasManagedMetadata( EXEFile const& loadedEXEFile )
+{
+    auto const& dataDirectoryEntries = loadedEXEFile.dataDirectoryEntries;
+
+    return     dataDirectoryEntries.size() > clrHeaderIdx
+           and dataDirectoryEntries[clrHeaderIdx].dataDirectoryRVA != 0
+           and dataDirectoryEntries[clrHeaderIdx].sizeInBytes != 0;
+}
+
+ManagedMetadata::ManagedMetadata( EXEFile const& loadedEXEFile )
+{
+    if ( not hasManagedMetadata( loadedEXEFile ) )
+    {
+        throw std::runtime_error{ "Image has no CLR header." };
+    }
+
+    auto const& clrHeaderDirectory = loadedEXEFile.dataDirectoryEntries[clrHeaderIdx];
+    auto const clrHeader =
+        PE::decodeFields<PE::CLRHeader, PE::clrHeaderFields>(
+            getSectionBytesAtRVA( loadedEXEFile, clrHeaderDirectory.dataDirectoryRVA,
+                                  static_cast<std::uint32_t>( sizeof( PE::CLRHeader ) ), "CLR header" ) );
+    m_clrHeader = *clrHeader;
+
+    auto const metadata = getSectionBytesAtRVA( loadedEXEFile, m_clrHeader.metadataRVA, m_clrHeader.metadataSizeInBytes, "Metadata" );
+
+    // The root: signature, versions, a length prefixed version string padded
+    // to four bytes, flags and the stream headers.
+    auto const versionLength = metadata.read<std::uint32_t>( 12 );
+    if ( metadata.read<std::uint32_t>( 0 ) != metadataRootSignature or not versionLength or *versionLength > metadata.size() )
+    {
+        throw std::runtime_error{ "Metadata root is malformed." };
+    }
+
+    auto const* versionStart = reinterpret_cast<char const*>( metadata.data() + 16 );
+    m_runtimeVersion.assign( versionStart, strnlen( versionStart, std::min<std::size_t>( *versionLength, metadata.size() - 16 ) ) );
+
+    auto streamHeaderOffset = std::size_t{ 16 } + *versionLength;
+    auto const numberOfStreams = metadata.read<std::uint16_t>( streamHeaderOffset + 2 );
+    if ( not numberOfStreams )
+    {
+        throw std::runtime_error{ "Metadata root is truncated." };
+    }
+
+    streamHeaderOffset += 4;
+
+    auto tablesStream = std::optional<PE::ByteReader>{};
+
+    for ( auto streamIdx = 0; streamIdx < *numberOfStreams; streamIdx++ )
+    {
+        auto const streamOffset = metadata.read<std::uint32_t>( streamHeaderOffset );
+        auto const streamSizeInBytes = metadata.read<std::uint32_t>( streamHeaderOffset + 4 );
+        auto const streamName = metadata.readNullTerminatedString( streamHeaderOffset + 8 );
+        if ( not streamOffset or not streamSizeInBytes or not streamName )
+        {
+            throw std::runtime_error{ "Metadata stream headers are truncated." };
+        }
+
+        auto const streamBytes = metadata.subReader( *streamOffset, *streamSizeInBytes );
+        if ( not streamBytes )
+        {
+            throw std::runtime_error{ "Metadata stream '" + *streamName + "' lies outside of the metadata." };
+        }
+
+        if ( *streamName == "#~" or *streamName == "#-" )
+        {
+            tablesStream = streamBytes;
+        }
+        else if ( *streamName == "#Strings" )
+        {
+            m_stringHeap = *streamBytes;
+        }
+        else if ( *streamName == "#Blob" )
+        {
+            m_blobHeap = *streamBytes;
+        }
+        else if ( *streamName == "#US" )
+        {
+            m_userStringHeap = *streamBytes;
+        }
+        else if ( *streamName == "#GUID" )
+        {
+            m_guidHeap = *streamBytes;
+        }
+
+        m_streams.push_back( MetadataStream
+                             {
+                                 .name = *streamName,
+                                 .offset = *streamOffset,
+                                 .sizeInBytes = *streamSizeInBytes
+                             } );
+
+        // The name is null terminated and padded to four bytes.
+        streamHeaderOffset += 8 + ( streamName->size() + 4 ) / 4 * 4;
+    }
+
+    if ( not tablesStream )
+    {
+        return;
+    }
+
+    auto const heapSizes = tablesStream->read<std::uint8_t>( 6 );
+    auto const validTables = tablesStream->read<std::uint64_t>( 8 );
+    if ( not heapSizes or not validTables )
+    {
+        throw std::runtime_error{ "Metadata tables header is truncated." };
+    }
+
+    // The row counts of the tables present, in table order; tables past the
+    // known ones are counted so that the rows are found, but not decoded.
+    auto rowCountOffset = std::size_t{ 24 };
+    for ( auto tableIdx = std::size_t{ 0 }; tableIdx < 64; tableIdx++ )
+    {
+        if ( ( ( *validTables >> tableIdx ) & 1 ) == 0 )
+        {
+            continue;
+        }
+
+        auto const numberOfRows = tablesStream->read<std::uint32_t>( rowCountOffset );
+        if ( not numberOfRows )
+        {
+            throw std::runtime_error{ "Metadata table row counts are truncated." };
+        }
+
+        if ( tableIdx < numberOfMetadataTables )
+        {
+            m_tableLayouts[tableIdx].numberOfRows = *numberOfRows;
+        }
+
+        rowCountOffset += 4;
+    }
+
+    if ( ( *heapSizes & extraDataBit ) != 0 )
+    {
+        rowCountOffset += 4;
+    }
+
+    auto const getHeapIndexSize = [&]( int const wideIndicesBit )
+    {
+        return static_cast<std::uint8_t>( ( *heapSizes & wideIndicesBit ) != 0 ? 4 : 2 );
+    };
+
+    auto const getTableIndexSize = [&]( std::size_t const tableIdx )
+    {
+        return static_cast<std::uint8_t>( m_tableLayouts[tableIdx].numberOfRows > 0xFFFF ? 4 : 2 );
+    };
+
+    auto const getCodedIndexSize = [&]( std::size_t const codedIndexKindIdx )
+    {
+        auto const& codedIndexSchema = codedIndexSchemas[codedIndexKindIdx];
+        auto maximumNumberOfRows = std::uint32_t{ 0 };
+
+        for ( auto const metadataTable : codedIndexSchema.tables )
+        {
+            if ( metadataTable != noTable )
+            {
+                maximumNumberOfRows = std::max( maximumNumberOfRows, m_tableLayouts[static_cast<std::size_t>( metadataTable )].numberOfRows );
+            }
+        }
+
+        return static_cast<std::uint8_t>( maximumNumberOfRows >= ( 1u << ( 16 - codedIndexSchema.numberOfTagBits ) ) ? 4 : 2 );
+    };
+
+    auto tableOffset = std::uint64_t{ rowCountOffset };
+
+    for ( auto tableIdx = std::size_t{ 0 }; tableIdx < numberOfMetadataTables; tableIdx++ )
+    {
+        auto& tableLayout = m_tableLayouts[tableIdx];
+
+        for ( auto columnIdx = std::size_t{ 0 }; auto const& metadataColumn : tableSchemas[tableIdx].columns )
+        {
+            auto columnSize = std::uint8_t{ 0 };
+
+            switch ( metadataColumn.kind )
+            {
+                case MetadataColumnKind::Constant16:    columnSize = 2; break;
+                case MetadataColumnKind::Constant32:    columnSize = 4; break;
+                case MetadataColumnKind::StringIndex:   columnSize = getHeapIndexSize( wideStringIndicesBit ); break;
+                case MetadataColumnKind::GUIDIndex:     columnSize = getHeapIndexSize( wideGUIDIndicesBit ); break;
+                case MetadataColumnKind::BlobIndex:     columnSize = getHeapIndexSize( wideBlobIndicesBit ); break;
+                case MetadataColumnKind::TableIndex:    columnSize = getTableIndexSize( metadataColumn.target ); break;
+                case MetadataColumnKind::CodedIndex:    columnSize = getCodedIndexSize( metadataColumn.target ); break;
+            }
+
+            tableLayout.columnOffsets[columnIdx] = static_cast<std::uint8_t>( tableLayout.rowSizeInBytes );
+            tableLayout.columnSizes[columnIdx] = columnSize;
+            tableLayout.rowSizeInBytes += columnSize;
+            columnIdx++;
+        }
+
+        auto const tableSizeInBytes = std::uint64_t{ tableLayout.numberOfRows } * tableLayout.rowSizeInBytes;
+        if ( tableOffset + tableSizeInBytes > tablesStream->size() )
+        {
+            throw std::runtime_error{ std::string( "Metadata table " ) + tableSchemas[tableIdx].name + " is truncated." };
+        }
+
+        tableLayout.firstRow = tablesStream->data() + tableOffset;
+        tableOffset += tableSizeInBytes;
+    }
+}
+
+std::uint32_t
+ManagedMetadata::getCell( MetadataTable const metadataTable,
+                          std::uint32_t const rowIdx,
+                          std::size_t const columnIdx ) const
+{
+    auto const& tableLayout = m_tableLayouts[static_cast<std::size_t>( metadataTable )];
+    auto const* cell = tableLayout.firstRow + std::size_t{ rowIdx } * tableLayout.rowSizeInBytes + tableLayout.columnOffsets[columnIdx];
+
+    if ( tableLayout.columnSizes[columnIdx] == 2 )
+    {
+        auto value = std::uint16_t{ 0 };
+        std::memcpy( &value, cell, sizeof( value ) );
+        return value;
+    }
+
+    auto value = std::uint32_t{ 0 };
+    std::memcpy( &value, cell, sizeof( value ) );
+    return value;
+}
+
+std::string_view
+ManagedMetadata::getString( std::uint32_t const stringIdx ) const
+{
+    if ( stringIdx >= m_stringHeap.size() )
+    {
+        return {};
+    }
+
+    auto const* stringStart = reinterpret_cast<char const*>( m_stringHeap.data() + stringIdx );
+
+    return std::string_view( stringStart, strnlen( stringStart, m_stringHeap.size() - stringIdx ) );
+}
+
+std::span<unsigned char const>
+ManagedMetadata::getBlob( std::uint32_t const blobIdx ) const
+{
+    return getLengthPrefixedBytes( m_blobHeap, blobIdx );
+}
+
+std::span<unsigned char const>
+ManagedMetadata::getUserString( std::uint32_t const userStringIdx ) const
+{
+    auto const userStringBytes = getLengthPrefixedBytes( m_userStringHeap, userStringIdx );
+
+    return userStringBytes.first( userStringBytes.size() & ~std::size_t{ 1 } );
+}
+
+std::optional<std::array<unsigned char, 16>>
+ManagedMetadata::getGUID( std::uint32_t const guidIdx ) const
+{
+    if ( guidIdx == 0 or not m_guidHeap.contains( ( guidIdx - 1 ) * std::size_t{ 16 }, 16 ) )
+    {
+        return std::nullopt;
+    }
+
+    auto guid = std::array<unsigned char, 16>{};
+    std::memcpy( guid.data(), m_guidHeap.data() + ( guidIdx - 1 ) * std::size_t{ 16 }, guid.size() );
+
+    return guid;
+}
+
+std::string
+ManagedMetadata::formatCell( MetadataTable const metadataTable,
+                             std::uint32_t const rowIdx,
+                             std::size_t const columnIdx ) const
+{
+    auto const& metadataColumn = getMetadataColumns( metadataTable )[columnIdx];
+    auto const value = getCell( metadataTable, rowIdx, columnIdx );
+
+    char formattedValue[64];
+
+    switch ( metadataColumn.kind )
+    {
+        case MetadataColumnKind::Constant16:
+            std::snprintf( formattedValue, sizeof( formattedValue ), "0x%04X", value );
+            return formattedValue;
+        case MetadataColumnKind::Constant32:
+            std::snprintf( formattedValue, sizeof( formattedValue ), "0x%08X", value );
+            return formattedValue;
+        case MetadataColumnKind::StringIndex:
+            return std::string( getString( value ) );
+        case MetadataColumnKind::GUIDIndex:
+        {
+            auto const guid = getGUID( value );
+            if ( not guid )
+            {
+                return "-";
+            }
+
+            // The first three groups are stored little-endian.
+            auto const& g = *guid;
+            std::snprintf( formattedValue, sizeof( formattedValue ),
+                           "{%02X%02X%02X%02X-%02X%02X-%02X%02X-%02X%02X-%02X%02X%02X%02X%02X%02X}",
+                           g[3], g[2], g[1], g[0], g[5], g[4], g[7], g[6],
+                           g[8], g[9], g[10], g[11], g[12], g[13], g[14], g[15] );
+            return formattedValue;
+        }
+        case MetadataColumnKind::BlobIndex:
+        {
+            // Enough of the blob to tell signatures apart at a glance.
+            auto const blob = getBlob( value );
+            auto formattedBlob = std::string{};
+
+            for ( auto const byte : blob.first( std::min<std::size_t>( blob.size(), 16 ) ) )
+            {
+                std::snprintf( formattedValue, sizeof( formattedValue ), formattedBlob.empty() ? "%02X" : " %02X", byte );
+                formattedBlob += formattedValue;
+            }
+
+            if ( blob.size() > 16 )
+            {
+                formattedBlob += " ...";
+            }
+
+            return formattedBlob;
+        }
+        case MetadataColumnKind::TableIndex:
+            return formatRowReference( MetadataRowReference
+                                       {
+                                           .table = static_cast<MetadataTable>( metadataColumn.target ),
+                                           .rowNumber = value
+                                       } );
+        case MetadataColumnKind::CodedIndex:
+            return formatRowReference( decodeCodedIndex( static_cast<CodedIndexKind>( metadataColumn.target ), value ) );
+    }
+
+    return {};
+}
\ No newline at end of file
@@ -0,0 +1,227 @@
+
+#ifndef MANAGEDMETADATA_H
+#define MANAGEDMETADATA_H
+
+#include "PEFiles.h"
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// The metadata tables of ECMA-335 II.22, numbered as in the #~ stream.
+enum class MetadataTable : std::uint8_t
+{
+    Module,
+    TypeRef,
+    TypeDef,
+    FieldPtr,
+    Field,
+    MethodPtr,
+    MethodDef,
+    ParamPtr,
+    Param,
+    InterfaceImpl,
+    MemberRef,
+    Constant,
+    CustomAttribute,
+    FieldMarshal,
+    DeclSecurity,
+    ClassLayout,
+    FieldLayout,
+    StandAloneSig,
+    EventMap,
+    EventPtr,
+    Event,
+    PropertyMap,
+    PropertyPtr,
+    Property,
+    MethodSemantics,
+    MethodImpl,
+    ModuleRef,
+    TypeSpec,
+    ImplMap,
+    FieldRVA,
+    ENCLog,
+    ENCMap,
+    Assembly,
+    AssemblyProcessor,
+    AssemblyOS,
+    AssemblyRef,
+    AssemblyRefProcessor,
+    AssemblyRefOS,
+    File,
+    ExportedType,
+    ManifestResource,
+    NestedClass,
+    GenericParam,
+    MethodSpec,
+    GenericParamConstraint
+};
+
+auto const numberOfMetadataTables = std::size_t{ 45 };
+
+// The sets of tables a coded index may refer to, ECMA-335 II.24.2.6.
+enum class CodedIndexKind : std::uint8_t
+{
+    TypeDefOrRef,
+    HasConstant,
+    HasCustomAttribute,
+    HasFieldMarshal,
+    HasDeclSecurity,
+    MemberRefParent,
+    HasSemantics,
+    MethodDefOrRef,
+    MemberForwarded,
+    Implementation,
+    CustomAttributeType,
+    ResolutionScope,
+    TypeOrMethodDef
+};
+
+enum class MetadataColumnKind : std::uint8_t
+{
+    Constant16,
+    Constant32,
+    StringIndex,
+    GUIDIndex,
+    BlobIndex,
+    TableIndex,
+    CodedIndex
+};
+
+struct MetadataColumn
+{
+    char const*           name;
+    MetadataColumnKind    kind;
+
+    // The table of a TableIndex or the CodedIndexKind of a CodedIndex.
+    std::uint8_t          target = 0;
+};
+
+// A row of a table, numbered from 1 as in metadata tokens; row 0 is null.
+struct MetadataRowReference
+{
+    MetadataTable    table;
+    std::uint32_t    rowNumber;
+};
+
+struct MetadataStream
+{
+    std::string      name;
+    std::uint32_t    offset = 0;
+    std::uint32_t    sizeInBytes = 0;
+};
+
+char const*
+getMetadataTableName( MetadataTable const metadataTable );
+
+std::span<MetadataColumn const>
+getMetadataColumns( MetadataTable const metadataTable );
+
+// Returns std::nullopt for a tag that names no table.
+std::optional<MetadataRowReference>
+decodeCodedIndex( CodedIndexKind const codedIndexKind,
+                  std::uint32_t const codedIndex );
+
+bool
+hasManagedMetadata( EXEFile const& loadedEXEFile );
+
+// The CLR header, metadata root, streams and tables of a managed image.
+// Decoding stops at the layout: the width of every column follows from the
+// row counts and heap sizes, so the offset of every cell is known up front
+// and cells are read from the section data when asked for. Nothing is kept
+// per row, and an assembly with a million MemberRef rows opens in the time it
+// takes to read the stream headers.
+//
+// The section data is viewed rather than copied, so the EXEFile, parsed in
+// full, must outlive the metadata.
+class ManagedMetadata
+{
+public:
+    // Throws std::runtime_error when the image has no CLR header or its
+    // metadata is malformed or lies outside of the section data.
+    explicit ManagedMetadata( EXEFile const& loadedEXEFile );
+
+    PE::CLRHeader const&
+    getCLRHeader() const
+    {
+        return m_clrHeader;
+    }
+
+    // The version of the runtime the image was built against, e.g.
+    // "v4.0.30319".
+    std::string const&
+    getRuntimeVersion() const
+    {
+        return m_runtimeVersion;
+    }
+
+    std::vector<MetadataStream> const&
+    getStreams() const
+    {
+        return m_streams;
+    }
+
+    std::uint32_t
+    getNumberOfRows( MetadataTable const metadataTable ) const
+    {
+        return m_tableLayouts[static_cast<std::size_t>( metadataTable )].numberOfRows;
+    }
+
+    // The raw value of one cell; rowIdx counts from 0 and must be below
+    // getNumberOfRows().
+    std::uint32_t
+    getCell( MetadataTable const metadataTable,
+             std::uint32_t const rowIdx,
+             std::size_t const columnIdx ) const;
+
+    // Out of range indices yield an empty string, blob or user string.
+    std::string_view
+    getString( std::uint32_t const stringIdx ) const;
+
+    std::span<unsigned char const>
+    getBlob( std::uint32_t const blobIdx ) const;
+
+    // The UTF-16LE characters, without the trailing flag byte.
+    std::span<unsigned char const>
+    getUserString( std::uint32_t const userStringIdx ) const;
+
+    // GUIDs are numbered from 1; 0 and out of range indices yield nothing.
+    std::optional<std::array<unsigned char, 16>>
+    getGUID( std::uint32_t const guidIdx ) const;
+
+    // A cell as text: strings and GUIDs resolved, references as a table
+    // name and row number, blobs as their first bytes.
+    std::string
+    formatCell( MetadataTable const metadataTable,
+                std::uint32_t const rowIdx,
+                std::size_t const columnIdx ) const;
+
+private:
+    static constexpr auto maximumNumberOfColumns = std::size_t{ 9 };
+
+    struct TableLayout
+    {
+        std::uint32_t                                       numberOfRows = 0;
+        std::uint32_t                                       rowSizeInBytes = 0;
+        unsigned char const*                                firstRow = nullptr;
+        std::array<std::uint8_t, maximumNumberOfColumns>    columnOffsets = {};
+        std::array<std::uint8_t, maximumNumberOfColumns>    columnSizes = {};
+    };
+
+private:
+    PE::CLRHeader                                      m_clrHeader = {};
+    std::string                                        m_runtimeVersion;
+    std::vector<MetadataStream>                        m_streams;
+    PE::ByteReader                                     m_stringHeap;
+    PE::ByteReader                                     m_blobHeap;
+    PE::ByteReader                                     m_userStringHeap;
+    PE::ByteReader                                     m_guidHeap;
+    std::array<TableLayout, numberOfMetadataTables>    m_tableLayouts = {};
+};
+
+#endif // MANAGEDMETADATA_H
\ No newline at end of file
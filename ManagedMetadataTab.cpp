@@ -0,0 +1,182 @@
+
+#include "ManagedMetadataTab.h"
+
+#include "HeaderFieldsModel.h"
+
+#include <QComboBox>
+#include <QGroupBox>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QLabel>
+#include <QTableView>
+#include <QVBoxLayout>
+
+#include <stdexcept>
+
+namespace
+{
+    // The first column shows the metadata token of the row.
+    auto const tokenColumn = 0;
+}
+
+MetadataTableModel::MetadataTableModel( ManagedMetadata const& managedMetadata,
+                                        QObject* parentObject )
+: QAbstractTableModel( parentObject )
+, m_managedMetadata( managedMetadata )
+{
+}
+
+int
+MetadataTableModel::rowCount( QModelIndex const& parentIndex ) const
+{
+    if ( parentIndex.isValid() )
+    {
+        return 0;
+    }
+
+    return static_cast<int>( m_managedMetadata.getNumberOfRows( m_metadataTable ) );
+}
+
+int
+MetadataTableModel::columnCount( QModelIndex const& parentIndex ) const
+{
+    return parentIndex.isValid() ? 0 : 1 + static_cast<int>( getMetadataColumns( m_metadataTable ).size() );
+}
+
+QVariant
+MetadataTableModel::data( QModelIndex const& index,
+                          int const role ) const
+{
+    if ( not index.isValid() or role != Qt::DisplayRole )
+    {
+        return QVariant();
+    }
+
+    auto const rowIdx = static_cast<std::uint32_t>( index.row() );
+
+    if ( index.column() == tokenColumn )
+    {
+        auto const token = ( static_cast<std::uint32_t>( m_metadataTable ) << 24 ) | ( rowIdx + 1 );
+        return QString( "0x%1" ).arg( token, 8, 16, QChar( '0' ) );
+    }
+
+    return QString::fromStdString( m_managedMetadata.formatCell( m_metadataTable, rowIdx, index.column() - 1 ) );
+}
+
+QVariant
+MetadataTableModel::headerData( int const section,
+                                Qt::Orientation const orientation,
+                                int const role ) const
+{
+    if ( orientation != Qt::Horizontal or role != Qt::DisplayRole )
+    {
+        return QVariant();
+    }
+
+    if ( section == tokenColumn )
+    {
+        return QString( "Token" );
+    }
+
+    return QString( getMetadataColumns( m_metadataTable )[section - 1].name );
+}
+
+void
+MetadataTableModel::setTable( MetadataTable const metadataTable )
+{
+    beginResetModel();
+    m_metadataTable = metadataTable;
+    endResetModel();
+}
+
+ManagedMetadataTab::ManagedMetadataTab( EXEFile const& loadedEXEFile,
+                                        QWidget* parentWidget )
+: QWidget( parentWidget )
+{
+    auto managedMetadataTabMainLayout = new QVBoxLayout( this );
+
+    try
+    {
+        m_managedMetadata = std::make_unique<ManagedMetadata>( loadedEXEFile );
+    }
+    catch ( std::runtime_error const& metadataError )
+    {
+        managedMetadataTabMainLayout->addWidget( new QLabel( QString( "The CLR metadata could not be decoded: %1" )
+                                                                 .arg( metadataError.what() ) ) );
+        return;
+    }
+
+    auto headersLayout = new QHBoxLayout;
+    managedMetadataTabMainLayout->addLayout( headersLayout );
+
+    auto clrHeaderWidgetsContainer = new QGroupBox( "CLR header" );
+    auto clrHeaderWidgetsLayout = new QVBoxLayout( clrHeaderWidgetsContainer );
+
+    auto clrHeaderColumns = std::vector<HeaderFieldsModel::Column>{};
+    clrHeaderColumns.push_back( HeaderFieldsModel::Column
+                                {
+                                    .name = "Value",
+                                    .fieldRows = PE::getFieldRows( m_managedMetadata->getCLRHeader(), PE::clrHeaderFields )
+                                } );
+    clrHeaderWidgetsLayout->addWidget( createHeaderFieldsView( new HeaderFieldsModel( std::move( clrHeaderColumns ) ) ) );
+    headersLayout->addWidget( clrHeaderWidgetsContainer );
+
+    auto streamsWidgetsContainer = new QGroupBox( "Metadata streams" );
+    auto streamsWidgetsLayout = new QVBoxLayout( streamsWidgetsContainer );
+
+    streamsWidgetsLayout->addWidget( new QLabel( QString( "Runtime version: %1" )
+                                                     .arg( QString::fromStdString( m_managedMetadata->getRuntimeVersion() ) ) ) );
+
+    for ( auto const& metadataStream : m_managedMetadata->getStreams() )
+    {
+        streamsWidgetsLayout->addWidget( new QLabel( QString( "%1: %2 bytes @ 0x%3" )
+                                                         .arg( QString::fromStdString( metadataStream.name ) )
+                                                         .arg( metadataStream.sizeInBytes )
+                                                         .arg( metadataStream.offset, 8, 16, QChar( '0' ) ) ) );
+    }
+
+    streamsWidgetsLayout->addStretch();
+    headersLayout->addWidget( streamsWidgetsContainer );
+
+    // Only the tables holding rows are offered.
+    m_tableSelector = new QComboBox;
+    managedMetadataTabMainLayout->addWidget( m_tableSelector );
+
+    for ( auto tableIdx = std::size_t{ 0 }; tableIdx < numberOfMetadataTables; tableIdx++ )
+    {
+        auto const metadataTable = static_cast<MetadataTable>( tableIdx );
+        auto const numberOfRows = m_managedMetadata->getNumberOfRows( metadataTable );
+
+        if ( numberOfRows != 0 )
+        {
+            m_shownTables.push_back( metadataTable );
+            m_tableSelector->addItem( QString( "%1 (%2 rows)" ).arg( getMetadataTableName( metadataTable ) ).arg( numberOfRows ) );
+        }
+    }
+
+    m_metadataTableModel = new MetadataTableModel( *m_managedMetadata, this );
+
+    auto metadataTableView = new QTableView;
+    metadataTableView->setModel( m_metadataTableModel );
+    metadataTableView->setSelectionBehavior( QAbstractItemView::SelectRows );
+    metadataTableView->setWordWrap( false );
+    metadataTableView->verticalHeader()->hide();
+    metadataTableView->verticalHeader()->setSectionResizeMode( QHeaderView::Fixed );
+    metadataTableView->verticalHeader()->setDefaultSectionSize( metadataTableView->fontMetrics().height() + 4 );
+    metadataTableView->horizontalHeader()->setStretchLastSection( true );
+    managedMetadataTabMainLayout->addWidget( metadataTableView, 1 );
+
+    connect( m_tableSelector, &QComboBox::currentIndexChanged,
+             [this]( int const selectedIdx )
+             {
+                if ( selectedIdx >= 0 )
+                {
+                    m_metadataTableModel->setTable( m_shownTables[selectedIdx] );
+                }
+             } );
+
+    if ( not m_shownTables.empty() )
+    {
+        m_metadataTableModel->setTable( m_shownTables.front() );
+    }
+}
\ No newline at end of file
@@ -0,0 +1,68 @@
+
+#ifndef MANAGEDMETADATATAB_H
+#define MANAGEDMETADATATAB_H
+
+#include "ManagedMetadata.h"
+
+#include <QAbstractTableModel>
+#include <QPointer>
+#include <QWidget>
+
+#include <memory>
+#include <vector>
+
+class QComboBox;
+
+// Presents one metadata table to a QTableView. Cells are decoded from the
+// metadata as the view paints them, so showing a table of any size costs the
+// same.
+class MetadataTableModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    explicit MetadataTableModel( ManagedMetadata const& managedMetadata,
+                                 QObject* parentObject = nullptr );
+
+    int
+    rowCount( QModelIndex const& parentIndex = QModelIndex() ) const override;
+
+    int
+    columnCount( QModelIndex const& parentIndex = QModelIndex() ) const override;
+
+    QVariant
+    data( QModelIndex const& index,
+          int const role = Qt::DisplayRole ) const override;
+
+    QVariant
+    headerData( int const section,
+                Qt::Orientation const orientation,
+                int const role = Qt::DisplayRole ) const override;
+
+    void
+    setTable( MetadataTable const metadataTable );
+
+private:
+    ManagedMetadata const&    m_managedMetadata;
+    MetadataTable             m_metadataTable = MetadataTable::Module;
+};
+
+// The CLR header and metadata streams of a managed image, and its metadata
+// tables one at a time.
+class ManagedMetadataTab : public QWidget
+{
+    Q_OBJECT
+
+public:
+    // The image must have been parsed in full and outlive the tab.
+    explicit ManagedMetadataTab( EXEFile const& loadedEXEFile,
+                                 QWidget* parentWidget = nullptr );
+
+private:
+    std::unique_ptr<ManagedMetadata>    m_managedMetadata;
+    std::vector<MetadataTable>          m_shownTables;
+    QPointer<MetadataTableModel>        m_metadataTableModel;
+    QPointer<QComboBox>                 m_tableSelector;
+};
+
+#endif // MANAGEDMETADATATAB_H
\ No newline at end of file
@@ -1,9 +1,12 @@
 
 #include "OBJViewer.h"
 
+#include "HeaderFieldsModel.h"
+#include "HexViewerTab.h"
+#include "Instrumentation.h"
+#include "StringsTab.h"
+
 #include <QGroupBox>
-#include <QLabel>
-#include <QScrollArea>
 #include <QVBoxLayout>
 
 namespace
@@ -13,20 +16,42 @@ namespace
                               QGroupBox* ntFileHeaderWidgetsContainer );
 }
 
-OBJViewer::OBJViewer( OBJFile&& loadedOBJFile,
+OBJViewer::OBJViewer( QString const& pathOfOBJFile,
+                      OBJFile&& loadedOBJFile,
                       QWidget* parentWidget )
-: QTabWidget( parentWidget )
+: LazyTabWidget( parentWidget )
+, m_pathOfOBJFile( pathOfOBJFile )
 , m_loadedOBJFile( std::move( loadedOBJFile ) )
 {
-    setUpFileHeadersTab();
-    setUpSectionHeadersTab();
+    addLazyTab( "File Headers",
+                [this]( QWidget* tabRootWidget )
+                {
+                    setUpFileHeadersTab( tabRootWidget );
+                } );
+    addLazyTab( "Section Headers",
+                [this]( QWidget* tabRootWidget )
+                {
+                    setUpSectionHeadersTab( tabRootWidget );
+                } );
+    addLazyTab( "Strings",
+                [this]( QWidget* tabRootWidget )
+                {
+                    setUpStringsTab( tabRootWidget );
+                } );
+    addLazyTab( "Hex",
+                [this]( QWidget* tabRootWidget )
+                {
+                    setUpHexTab( tabRootWidget );
+                } );
+
+    Instrumentation::addToCounter( Instrumentation::Counter::WidgetsCreated,
+                                   findChildren<QWidget*>().size() );
 }
 
 void
-OBJViewer::setUpFileHeadersTab()
+OBJViewer::setUpFileHeadersTab( QWidget* headersTabRootWidget )
 {
-    auto headersTabRootWidget = new QWidget;
-    addTab( headersTabRootWidget, "File Headers" );
+    auto const tabTimer = Instrumentation::ScopedTimer{ "File Headers tab" };
 
     auto headersTabMainLayout = new QVBoxLayout( headersTabRootWidget );
 
@@ -39,91 +64,72 @@ OBJViewer::setUpFileHeadersTab()
 }
 
 void
-OBJViewer::setUpSectionHeadersTab()
+OBJViewer::setUpSectionHeadersTab( QWidget* sectionHeadersTabContainer )
 {
-    auto sectionHeadersScrollWidget = new QScrollArea;
-    addTab( sectionHeadersScrollWidget, "Section Headers" );
+    auto const tabTimer = Instrumentation::ScopedTimer{ "Section Headers tab" };
 
-    auto sectionHeadersTabRootWidget = new QWidget;
-    auto sectionHeadersTabMainLayout = new QGridLayout( sectionHeadersTabRootWidget );
+    auto sectionHeadersTabContainerLayout = new QVBoxLayout( sectionHeadersTabContainer );
 
-    auto const& sectionHeadersNameToInfo = m_loadedOBJFile.sectionHeaders;
-    auto currentRow = 0;
-    auto currentColumn = 0;
+    auto sectionColumns = std::vector<HeaderFieldsModel::Column>{};
+    for ( auto const& [sectionName, sectionHeaders] : m_loadedOBJFile.sectionHeaders )
+    {
+        for ( auto const& sectionHeader : sectionHeaders )
+        {
+            sectionColumns.push_back( HeaderFieldsModel::Column
+                                      {
+                                          .name = QString::fromStdString( sectionName ),
+                                          .fieldRows = PE::getFieldRows( sectionHeader, PE::sectionHeaderFields )
+                                      } );
+        }
+    }
+
+    sectionHeadersTabContainerLayout->addWidget(
+        createHeaderFieldsView( new HeaderFieldsModel( std::move( sectionColumns ) ) ) );
+}
+
+void
+OBJViewer::setUpStringsTab( QWidget* stringsTabRootWidget )
+{
+    auto const tabTimer = Instrumentation::ScopedTimer{ "Strings tab" };
 
-    for ( auto const& [sectionName, sectionHeaders] : sectionHeadersNameToInfo )
+    auto stringsTabMainLayout = new QVBoxLayout( stringsTabRootWidget );
+    stringsTabMainLayout->setContentsMargins( 0, 0, 0, 0 );
+
+    stringsTabMainLayout->addWidget( new StringsTab( m_pathOfOBJFile, getStringScanRegions( m_loadedOBJFile ) ) );
+}
+
+void
+OBJViewer::setUpHexTab( QWidget* hexTabRootWidget )
+{
+    auto const tabTimer = Instrumentation::ScopedTimer{ "Hex tab" };
+
+    auto jumpTargets = std::vector<HexViewerTab::JumpTarget>{};
+
+    for ( auto const& [sectionName, sectionHeaders] : m_loadedOBJFile.sectionHeaders )
     {
         for ( auto const& sectionHeader : sectionHeaders )
         {
-            auto sectionHeaderWidgetsContainer =
-                new QGroupBox( QString::fromStdString( sectionName ) );
-            sectionHeadersTabMainLayout->addWidget( sectionHeaderWidgetsContainer,
-                                                    currentRow,
-                                                    currentColumn );
-            currentColumn++;
-            if ( currentColumn >= 2 )
+            if ( sectionHeader.sizeOfRawDataInBytes != 0 )
             {
-                currentColumn = 0;
-                currentRow++;
+                jumpTargets.push_back( HexViewerTab::JumpTarget
+                                       {
+                                          .name = QString::fromStdString( sectionName ),
+                                          .fileOffset = sectionHeader.pointerToRawData
+                                       } );
             }
-
-            auto sectionHeaderWidgetsLayout = new QVBoxLayout( sectionHeaderWidgetsContainer );
-
-            auto sectionSizeLabel =
-                new QLabel( QString( "Size in memory: %1" )
-                                .arg( sectionHeader.sectionSizeInBytesInMemory ) );
-            sectionHeaderWidgetsLayout->addWidget( sectionSizeLabel );
-
-            auto const sectionBaseAddressAsHexString =
-                QString( "%1" ).arg( sectionHeader.sectionBaseAddressInMemory,
-                                     8, 16, QChar( '0' ) ).toUpper();
-            auto sectionBaseAddressLabel =
-                new QLabel( QString( "Base address in memory: 0x%1" )
-                                .arg( sectionBaseAddressAsHexString ) );
-            sectionHeaderWidgetsLayout->addWidget( sectionBaseAddressLabel );
-
-            auto sizeOfRawDataLabel =
-                new QLabel( QString( "Size of raw data: %1" )
-                                .arg( sectionHeader.sizeOfRawDataInBytes ) );
-            sectionHeaderWidgetsLayout->addWidget( sizeOfRawDataLabel );
-
-            auto const pointerToRawDataAsHexString =
-                QString( "%1" ).arg( sectionHeader.pointerToRawData,
-                                     8, 16, QChar( '0' ) ).toUpper();
-            auto pointerToRawDataLabel =
-                new QLabel( QString( "Pointer to raw data: 0x%1" )
-                                .arg( pointerToRawDataAsHexString ) );
-            sectionHeaderWidgetsLayout->addWidget( pointerToRawDataLabel );
-
-            auto const pointerToRelocationsAsHexString =
-                QString( "%1" ).arg( sectionHeader.pointerToRelocations,
-                                     8, 16, QChar( '0' ) ).toUpper();
-            auto pointerToRelocationsLabel =
-                new QLabel( QString( "Pointer to relocations: 0x%1" )
-                                .arg( pointerToRelocationsAsHexString ) );
-            sectionHeaderWidgetsLayout->addWidget( pointerToRelocationsLabel );
-
-            auto const pointerToLineNumbersAsHexString =
-                QString( "%1" ).arg( sectionHeader.pointerToLineNumbers,
-                                     8, 16, QChar( '0' ) ).toUpper();
-            auto pointerToLineNumbersLabel =
-                new QLabel( QString( "Pointer to line numbers: 0x%1" )
-                                .arg( pointerToLineNumbersAsHexString ) );
-            sectionHeaderWidgetsLayout->addWidget( pointerToLineNumbersLabel );
-
-            auto numberOfRelocationsLabel =
-                new QLabel( QString( "Number of relocations: %1" )
-                                .arg( sectionHeader.numberOfRelocations ) );
-            sectionHeaderWidgetsLayout->addWidget( numberOfRelocationsLabel );
-
-            auto numberOfLineNumberEntriesLabel =
-                new QLabel( QString( "Number of line number entries: %1" )
-                                .arg( sectionHeader.numberOfLineNumberEntries ) );
-            sectionHeaderWidgetsLayout->addWidget( numberOfLineNumberEntriesLabel );
         }
     }
 
-    sectionHeadersScrollWidget->setWidget( sectionHeadersTabRootWidget );
+    auto hexTabMainLayout = new QVBoxLayout( hexTabRootWidget );
+    hexTabMainLayout->setContentsMargins( 0, 0, 0, 0 );
+
+    hexTabMainLayout->addWidget( new HexViewerTab( m_pathOfOBJFile,
+                                                   jumpTargets,
+                                                   [this]( PE::ByteReader const& mappedBytes )
+                                                   {
+                                                       return getKnownFileRegions( mappedBytes, m_loadedOBJFile );
+                                                   },
+                                                   nullptr ) );
 }
 
 namespace
@@ -134,25 +140,14 @@ namespace
     {
         auto ntFileHeaderWidgetsLayout = new QVBoxLayout( ntFileHeaderWidgetsContainer );
 
-        auto optionalHeaderSizeLabel =
-            new QLabel( QString( "Size of optional header: %1" )
-                            .arg( ntFileHeader.sizeOfOptionalHeader ) );
-        ntFileHeaderWidgetsLayout->addWidget( optionalHeaderSizeLabel );
-
-        auto const targetMachineArchitectureHexString =
-            QString( "%1" ).arg( ntFileHeader.targetMachineArchitecture,
-                                 4, 16, QChar( '0' ) ).toUpper();
-        auto const targetMachineArchitectureName =
-            QString::fromStdString( PE::getMachineArchitectureName( ntFileHeader.targetMachineArchitecture ) );
-        auto targetMachineArchitectureLabel =
-            new QLabel( QString( "Target machine architecture: 0x%1 (%2)" )
-                            .arg( targetMachineArchitectureHexString )
-                            .arg( targetMachineArchitectureName ) );
-        ntFileHeaderWidgetsLayout->addWidget( targetMachineArchitectureLabel );
-
-        auto numberOfSectionsLabel =
-            new QLabel( QString( "Number of sections: %1" )
-                            .arg( ntFileHeader.numberOfSections ) );
-        ntFileHeaderWidgetsLayout->addWidget( numberOfSectionsLabel );
+        auto ntFileHeaderColumns = std::vector<HeaderFieldsModel::Column>{};
+        ntFileHeaderColumns.push_back( HeaderFieldsModel::Column
+                                       {
+                                           .name = "Value",
+                                           .fieldRows = PE::getFieldRows( ntFileHeader, PE::ntFileHeaderFields )
+                                       } );
+
+        ntFileHeaderWidgetsLayout->addWidget(
+            createHeaderFieldsView( new HeaderFieldsModel( std::move( ntFileHeaderColumns ) ) ) );
     }
 }
\ No newline at end of file
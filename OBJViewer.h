@@ -2,26 +2,33 @@
 #ifndef OBJVIEWER_H
 #define OBJVIEWER_H
 
+#include "LazyTabWidget.h"
 #include "PEFiles.h"
 
-#include <QTabWidget>
-
-class OBJViewer : public QTabWidget
+class OBJViewer : public LazyTabWidget
 {
     Q_OBJECT
 
 public:
-    OBJViewer( OBJFile&& loadedOBJFile,
+    OBJViewer( QString const& pathOfOBJFile,
+               OBJFile&& loadedOBJFile,
                QWidget* parentWidget = nullptr );
 
 private:
     void
-    setUpFileHeadersTab();
+    setUpFileHeadersTab( QWidget* tabRootWidget );
+
+    void
+    setUpSectionHeadersTab( QWidget* tabRootWidget );
+
+    void
+    setUpStringsTab( QWidget* tabRootWidget );
 
     void
-    setUpSectionHeadersTab();
+    setUpHexTab( QWidget* tabRootWidget );
 
 private:
+    QString    m_pathOfOBJFile;
     OBJFile    m_loadedOBJFile;
 };
 
@@ -0,0 +1,35 @@
+
+#include "PEFieldDescriptors.h"
+
+namespace PE::Detail
+{
+    std::string
+    formatFieldValue( std::uint64_t const value,
+                      std::size_t const sizeInBytes,
+                      FieldFormat const format )
+    {
+        char formattedValue[64];
+
+        switch ( format )
+        {
+            case FieldFormat::Hex:
+                std::snprintf( formattedValue, sizeof( formattedValue ), "0x%0*llX",
+                               static_cast<int>( 2 * sizeInBytes ), static_cast<unsigned long long>( value ) );
+                return formattedValue;
+            case FieldFormat::MachineArchitecture:
+                std::snprintf( formattedValue, sizeof( formattedValue ), "0x%04llX (%s)",
+                               static_cast<unsigned long long>( value ),
+                               getMachineArchitectureName( static_cast<std::uint16_t>( value ) ).c_str() );
+                return formattedValue;
+            case FieldFormat::PESignature:
+                std::snprintf( formattedValue, sizeof( formattedValue ), "0x%llX (%s)",
+                               static_cast<unsigned long long>( value ),
+                               getPESignatureName( static_cast<std::uint16_t>( value ) ).c_str() );
+                return formattedValue;
+            case FieldFormat::SectionName:
+                return getSectionName( value );
+            default:
+                return std::to_string( value );
+        }
+    }
+}
\ No newline at end of file
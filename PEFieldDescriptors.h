@@ -0,0 +1,246 @@
+
+#ifndef PEFIELDDESCRIPTORS_H
+#define PEFIELDDESCRIPTORS_H
+
+#include "ByteReader.h"
+#include "PEFormat.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace PE
+{
+    enum class FieldFormat : std::uint8_t
+    {
+        Decimal,
+        Hex,
+        MachineArchitecture,
+        PESignature,
+        SectionName
+    };
+
+    // One field of an on-disk header: where it lies relative to the start of
+    // the header and how to show it. Its width is the width of the member it
+    // is decoded into, so every member must be a fixed-width integer.
+    template <auto Member>
+    struct Field
+    {
+        static constexpr auto member = Member;
+
+        char const*    name;
+        std::size_t    fileOffset;
+        FieldFormat    format = FieldFormat::Decimal;
+    };
+
+    namespace Detail
+    {
+        template <typename Member>
+        struct MemberPointerTraits;
+
+        template <typename Header, typename Value>
+        struct MemberPointerTraits<Value Header::*>
+        {
+            using HeaderType = Header;
+            using ValueType = Value;
+        };
+
+        template <auto Member>
+        using FieldValueType = typename MemberPointerTraits<decltype( Member )>::ValueType;
+
+        template <typename T>
+        T
+        readLittleEndian( unsigned char const* bytes )
+        {
+            static_assert( std::is_integral_v<T> and std::is_unsigned_v<T> );
+
+            auto value = T{};
+            std::memcpy( &value, bytes, sizeof( T ) );
+
+            if constexpr ( std::endian::native == std::endian::big )
+            {
+                auto swappedValue = T{};
+                for ( auto i = std::size_t{ 0 }; i < sizeof( T ); i++ )
+                {
+                    swappedValue = static_cast<T>( ( swappedValue << 8 ) | ( ( value >> ( 8 * i ) ) & 0xFF ) );
+                }
+
+                value = swappedValue;
+            }
+
+            return value;
+        }
+
+        std::string
+        formatFieldValue( std::uint64_t const value,
+                          std::size_t const sizeInBytes,
+                          FieldFormat const format );
+    }
+
+    // The number of bytes the fields of a table span.
+    template <typename... Fields>
+    constexpr std::size_t
+    getSizeOnDisk( std::tuple<Fields...> const& fields )
+    {
+        return std::apply( []( auto const&... field )
+                           {
+                               auto sizeOnDisk = std::size_t{ 0 };
+                               ( ( sizeOnDisk = std::max( sizeOnDisk,
+                                                          field.fileOffset + sizeof( Detail::FieldValueType<std::decay_t<decltype( field )>::member> ) ) ), ... );
+                               return sizeOnDisk;
+                           },
+                           fields );
+    }
+
+    // One bounds check, then one little-endian load per field. The table is a
+    // template argument so that every offset and width is a constant, and
+    // this compiles to straight-line loads.
+    template <typename Header, auto const& fields>
+    std::optional<Header>
+    decodeFields( ByteReader const& rawBytesFromStartOfHeader )
+    {
+        constexpr auto sizeOnDisk = getSizeOnDisk( fields );
+
+        if ( not rawBytesFromStartOfHeader.contains( 0, sizeOnDisk ) )
+        {
+            return std::nullopt;
+        }
+
+        auto header = Header{};
+
+        [&]<std::size_t... fieldIndices>( std::index_sequence<fieldIndices...> )
+        {
+            ( ( header.*std::tuple_element_t<fieldIndices, std::decay_t<decltype( fields )>>::member =
+                    Detail::readLittleEndian<Detail::FieldValueType<std::tuple_element_t<fieldIndices, std::decay_t<decltype( fields )>>::member>>(
+                        rawBytesFromStartOfHeader.data() + std::get<fieldIndices>( fields ).fileOffset ) ), ... );
+        }( std::make_index_sequence<std::tuple_size_v<std::decay_t<decltype( fields )>>>{} );
+
+        return header;
+    }
+
+    struct FieldRow
+    {
+        std::string    name;
+        std::string    value;
+    };
+
+    template <typename Header, typename... Fields>
+    std::vector<FieldRow>
+    getFieldRows( Header const& header,
+                  std::tuple<Fields...> const& fields )
+    {
+        auto fieldRows = std::vector<FieldRow>{};
+        fieldRows.reserve( sizeof...( Fields ) );
+
+        std::apply( [&]( auto const&... field )
+                    {
+                        ( fieldRows.push_back( FieldRow
+                                               {
+                                                   .name = field.name,
+                                                   .value = Detail::formatFieldValue(
+                                                                header.*std::decay_t<decltype( field )>::member,
+                                                                sizeof( header.*std::decay_t<decltype( field )>::member ),
+                                                                field.format )
+                                               } ), ... );
+                    },
+                    fields );
+
+        return fieldRows;
+    }
+
+    inline constexpr auto ntFileHeaderFields = std::tuple
+    {
+        Field<&NTFileHeader::targetMachineArchitecture>{ "Target machine architecture", 0, FieldFormat::MachineArchitecture },
+        Field<&NTFileHeader::numberOfSections>{ "Number of sections", 2 },
+        Field<&NTFileHeader::timestamp>{ "Timestamp", 4, FieldFormat::Hex },
+        Field<&NTFileHeader::pointerToSymbolTable>{ "Pointer to symbol table", 8, FieldFormat::Hex },
+        Field<&NTFileHeader::numberOfSymbols>{ "Number of symbols", 12 },
+        Field<&NTFileHeader::sizeOfOptionalHeader>{ "Size of optional header", 16 },
+        Field<&NTFileHeader::fileCharacteristics>{ "Characteristics", 18, FieldFormat::Hex }
+    };
+
+    inline constexpr auto ntOptionalHeader64Fields = std::tuple
+    {
+        Field<&NTOptionalHeader64::peSignature>{ "PE signature", 0, FieldFormat::PESignature },
+        Field<&NTOptionalHeader64::linkerMajorVersion>{ "Linker major version", 2 },
+        Field<&NTOptionalHeader64::linkerMinorVersion>{ "Linker minor version", 3 },
+        Field<&NTOptionalHeader64::sizeOfCodeInBytes>{ "Size of code", 4 },
+        Field<&NTOptionalHeader64::sizeOfInitializedDataInBytes>{ "Size of initialized data", 8 },
+        Field<&NTOptionalHeader64::sizeOfUninitializedDataInBytes>{ "Size of uninitialized data", 12 },
+        Field<&NTOptionalHeader64::addressOfEntryPoint>{ "Address of entry point", 16, FieldFormat::Hex },
+        Field<&NTOptionalHeader64::addressOfBaseOfCode>{ "Address of base of code", 20, FieldFormat::Hex },
+        Field<&NTOptionalHeader64::preferredBaseAddressOfImage>{ "Preferred base address of image", 24, FieldFormat::Hex },
+        Field<&NTOptionalHeader64::sectionAlignmentInBytes>{ "Section alignment", 32, FieldFormat::Hex },
+        Field<&NTOptionalHeader64::fileAlignmentInBytes>{ "File alignment", 36, FieldFormat::Hex },
+        Field<&NTOptionalHeader64::osMajorVersion>{ "OS major version", 40 },
+        Field<&NTOptionalHeader64::osMinorVersion>{ "OS minor version", 42 },
+        Field<&NTOptionalHeader64::imageMajorVersion>{ "Image major version", 44 },
+        Field<&NTOptionalHeader64::imageMinorVersion>{ "Image minor version", 46 },
+        Field<&NTOptionalHeader64::subsystemMajorVersion>{ "Subsystem major version", 48 },
+        Field<&NTOptionalHeader64::subsystemMinorVersion>{ "Subsystem minor version", 50 },
+        Field<&NTOptionalHeader64::_win32VersionValue>{ "Win32 version value", 52 },
+        Field<&NTOptionalHeader64::sizeOfImageInBytes>{ "Size of image", 56 },
+        Field<&NTOptionalHeader64::sizeOfHeadersInBytes>{ "Size of headers", 60 },
+        Field<&NTOptionalHeader64::checksum>{ "Checksum", 64, FieldFormat::Hex },
+        Field<&NTOptionalHeader64::subsystem>{ "Subsystem", 68 },
+        Field<&NTOptionalHeader64::dllCharacteristics>{ "DLL characteristics", 70, FieldFormat::Hex },
+        Field<&NTOptionalHeader64::sizeOfStackReserveInBytes>{ "Size of stack reserve", 72, FieldFormat::Hex },
+        Field<&NTOptionalHeader64::sizeOfStackCommitInBytes>{ "Size of stack commit", 80, FieldFormat::Hex },
+        Field<&NTOptionalHeader64::sizeOfHeapReserveInBytes>{ "Size of heap reserve", 88, FieldFormat::Hex },
+        Field<&NTOptionalHeader64::sizeOfHeapCommitInBytes>{ "Size of heap commit", 96, FieldFormat::Hex },
+        Field<&NTOptionalHeader64::_loaderFlags>{ "Loader flags", 104, FieldFormat::Hex },
+        Field<&NTOptionalHeader64::numberOfDataDirectories>{ "Number of data directories", 108 }
+    };
+
+    inline constexpr auto sectionHeaderFields = std::tuple
+    {
+        Field<&SectionHeader::sectionNameAsNumber>{ "Name", 0, FieldFormat::SectionName },
+        Field<&SectionHeader::sectionSizeInBytesInMemory>{ "Size in memory", 8 },
+        Field<&SectionHeader::sectionBaseAddressInMemory>{ "Base address in memory", 12, FieldFormat::Hex },
+        Field<&SectionHeader::sizeOfRawDataInBytes>{ "Size of raw data", 16 },
+        Field<&SectionHeader::pointerToRawData>{ "Pointer to raw data", 20, FieldFormat::Hex },
+        Field<&SectionHeader::pointerToRelocations>{ "Pointer to relocations", 24, FieldFormat::Hex },
+        Field<&SectionHeader::pointerToLineNumbers>{ "Pointer to line numbers", 28, FieldFormat::Hex },
+        Field<&SectionHeader::numberOfRelocations>{ "Number of relocations", 32 },
+        Field<&SectionHeader::numberOfLineNumberEntries>{ "Number of line number entries", 34 },
+        Field<&SectionHeader::sectionCharacteristics>{ "Characteristics", 36, FieldFormat::Hex }
+    };
+
+    inline constexpr auto clrHeaderFields = std::tuple
+    {
+        Field<&CLRHeader::sizeInBytes>{ "Size of header", 0 },
+        Field<&CLRHeader::majorRuntimeVersion>{ "Major runtime version", 4 },
+        Field<&CLRHeader::minorRuntimeVersion>{ "Minor runtime version", 6 },
+        Field<&CLRHeader::metadataRVA>{ "Metadata RVA", 8, FieldFormat::Hex },
+        Field<&CLRHeader::metadataSizeInBytes>{ "Metadata size", 12 },
+        Field<&CLRHeader::flags>{ "Flags", 16, FieldFormat::Hex },
+        Field<&CLRHeader::entryPointTokenOrRVA>{ "Entry point token or RVA", 20, FieldFormat::Hex },
+        Field<&CLRHeader::resourcesRVA>{ "Resources RVA", 24, FieldFormat::Hex },
+        Field<&CLRHeader::resourcesSizeInBytes>{ "Resources size", 28 },
+        Field<&CLRHeader::strongNameSignatureRVA>{ "Strong name signature RVA", 32, FieldFormat::Hex },
+        Field<&CLRHeader::strongNameSignatureSizeInBytes>{ "Strong name signature size", 36 },
+        Field<&CLRHeader::codeManagerTableRVA>{ "Code manager table RVA", 40, FieldFormat::Hex },
+        Field<&CLRHeader::codeManagerTableSizeInBytes>{ "Code manager table size", 44 },
+        Field<&CLRHeader::vTableFixupsRVA>{ "VTable fixups RVA", 48, FieldFormat::Hex },
+        Field<&CLRHeader::vTableFixupsSizeInBytes>{ "VTable fixups size", 52 },
+        Field<&CLRHeader::exportAddressTableJumpsRVA>{ "Export address table jumps RVA", 56, FieldFormat::Hex },
+        Field<&CLRHeader::exportAddressTableJumpsSizeInBytes>{ "Export address table jumps size", 60 },
+        Field<&CLRHeader::managedNativeHeaderRVA>{ "Managed native header RVA", 64, FieldFormat::Hex },
+        Field<&CLRHeader::managedNativeHeaderSizeInBytes>{ "Managed native header size", 68 }
+    };
+
+    static_assert( getSizeOnDisk( ntFileHeaderFields ) == sizeof( NTFileHeader ) );
+    static_assert( getSizeOnDisk( ntOptionalHeader64Fields ) == sizeof( NTOptionalHeader64 ) );
+    static_assert( getSizeOnDisk( sectionHeaderFields ) == sizeof( SectionHeader ) );
+    static_assert( getSizeOnDisk( clrHeaderFields ) == sizeof( CLRHeader ) );
+}
+
+#endif // PEFIELDDESCRIPTORS_H
\ No newline at end of file
@@ -1,115 +1,495 @@
 
 #include "PEFiles.h"
 
+#include "FileRangeReader.h"
+#include "Instrumentation.h"
+
+#include <algorithm>
 #include <cstring>
 #include <fstream>
 #include <optional>
+#include <stdexcept>
 #include <string>
+#include <utility>
 
 namespace
 {
     auto const optionalHeaderSig_PE32Plus = 0x20B;
+    auto const ntSignature_PE00 = 0x00004550;
+    auto const exceptionTableIdx = 3;
+
+    template <typename T>
+    T
+    valueOrThrow( std::optional<T>&& extractedValue,
+                  char const* errorMessage )
+    {
+        if ( not extractedValue )
+        {
+            throw std::runtime_error{ errorMessage };
+        }
+
+        return std::move( *extractedValue );
+    }
+
+    // Rough per-node cost of a std::map entry on top of its key and value:
+    // three pointers, a colour flag and the allocator's bookkeeping.
+    auto const estimatedMapNodeOverheadInBytes = std::uint64_t{ 48 };
+
+    std::uint64_t
+    getEstimatedMemoryUsageInBytes( std::string const& value )
+    {
+        auto const isStoredInline = value.capacity() < sizeof( std::string );
+
+        return sizeof( std::string ) + ( isStoredInline ? 0 : value.capacity() + 1 );
+    }
+
+    PE::ByteReader
+    subReaderOrThrow( PE::ByteReader const& rawBytes,
+                      std::size_t const offset,
+                      char const* errorMessage )
+    {
+        return valueOrThrow( rawBytes.subReader( offset ), errorMessage );
+    }
+
+    // Enough for the headers of almost every executable: the DOS stub, the
+    // NT headers and a few dozen section headers.
+    auto const initialHeadersReadSizeInBytes = std::size_t{ 4096 };
+
+    // How many bytes from the start of the file the headers span, as far as
+    // the given bytes tell: if they end before the NT optional header, only
+    // up to the end of the optional header. Malformed headers yield the size
+    // already at hand and are reported by the parser.
+    std::size_t
+    getSizeOfEXEHeadersInBytes( PE::ByteReader const& headerBytes )
+    {
+        auto const dosHeader = PE::extractDOSHeader( headerBytes );
+        if ( not dosHeader )
+        {
+            return headerBytes.size();
+        }
+
+        auto const ntFileHeaderOffset = std::uint64_t{ dosHeader->offsetOfNTSignature } + sizeof( std::uint32_t );
+        auto const ntOptionalHeaderOffset = ntFileHeaderOffset + sizeof( PE::NTFileHeader );
+        auto const dataDirectoriesOffset = ntOptionalHeaderOffset + sizeof( PE::NTOptionalHeader64 );
 
+        auto const ntFileHeaderBytes = headerBytes.subReader( ntFileHeaderOffset );
+        auto const ntOptionalHeaderBytes = headerBytes.subReader( ntOptionalHeaderOffset );
+        auto const ntFileHeader = ntFileHeaderBytes ? PE::extractNTFileHeader( *ntFileHeaderBytes ) : std::nullopt;
+        auto const ntOptionalHeader =
+            ntOptionalHeaderBytes ? PE::extract64bitNTOptionalHeader( *ntOptionalHeaderBytes ) : std::nullopt;
+
+        if ( not ntFileHeader or not ntOptionalHeader )
+        {
+            return static_cast<std::size_t>( dataDirectoriesOffset );
+        }
+
+        return static_cast<std::size_t>( dataDirectoriesOffset
+                                         + std::uint64_t{ ntOptionalHeader->numberOfDataDirectories } * sizeof( PE::DataDirectoryEntry )
+                                         + std::uint64_t{ ntFileHeader->numberOfSections } * sizeof( PE::SectionHeader ) );
+    }
+
+    std::size_t
+    getSizeOfOBJHeadersInBytes( PE::ByteReader const& headerBytes )
+    {
+        auto const ntFileHeader = PE::extractNTFileHeader( headerBytes );
+        if ( not ntFileHeader )
+        {
+            return headerBytes.size();
+        }
+
+        return sizeof( PE::NTFileHeader ) + std::size_t{ ntFileHeader->numberOfSections } * sizeof( PE::SectionHeader );
+    }
+
+    // Reads the bytes at the start of the file up to the end of the headers.
     std::vector<unsigned char>
-    loadPEFileAsRawBytes( std::string const& pathOfPEFileToLoad )
+    readHeaderBytes( FileRangeReader& fileRangeReader,
+                     std::size_t const initialReadSizeInBytes,
+                     std::size_t ( *getSizeOfHeadersInBytes )( PE::ByteReader const& ) )
+    {
+        auto headerBytes = fileRangeReader.read( 0, initialReadSizeInBytes );
+
+        // Each read can reveal more of the headers, so this takes at most
+        // three reads; the file size bounds the loop for corrupt headers.
+        for ( auto sizeOfHeadersInBytes = getSizeOfHeadersInBytes( PE::ByteReader{ headerBytes } );
+              sizeOfHeadersInBytes > headerBytes.size() and headerBytes.size() < fileRangeReader.getFileSizeInBytes();
+              sizeOfHeadersInBytes = getSizeOfHeadersInBytes( PE::ByteReader{ headerBytes } ) )
+        {
+            auto const missingBytes = fileRangeReader.read( headerBytes.size(), sizeOfHeadersInBytes - headerBytes.size() );
+            headerBytes.insert( headerBytes.end(), missingBytes.begin(), missingBytes.end() );
+        }
+
+        return headerBytes;
+    }
+
+    void
+    parseEXEHeaders( PE::ByteReader const& rawBytes,
+                     EXEFile& loadedEXEFile )
     {
-        auto peFile = std::ifstream{ pathOfPEFileToLoad, std::ios::binary };
+        auto headersTimer = std::optional<Instrumentation::ScopedTimer>{ std::in_place, "Headers" };
+
+        loadedEXEFile.dosHeader =
+            valueOrThrow( PE::extractDOSHeader( rawBytes ),
+                          "File is too small to hold a DOS header." );
 
-        if( !peFile.is_open() )
+        loadedEXEFile.richHeader = extractRichHeader( rawBytes, loadedEXEFile.dosHeader );
+
+        loadedEXEFile.ntSignature =
+            valueOrThrow( rawBytes.read<std::uint32_t>( loadedEXEFile.dosHeader.offsetOfNTSignature ),
+                          "NT signature lies outside of the file." );
+
+        if ( loadedEXEFile.ntSignature != ntSignature_PE00 )
         {
-            throw std::runtime_error{ "Failed to open '" + pathOfPEFileToLoad + "'." };
+            throw std::runtime_error{ "Missing 'PE' signature." };
         }
 
-        auto const fileSizeInBytes =
-            static_cast<int>( peFile.seekg( 0, std::ios::end ).tellg() );
-        peFile.seekg( 0, std::ios::beg );
+        auto const ntFileHeaderOffset =
+            std::size_t{ loadedEXEFile.dosHeader.offsetOfNTSignature } +
+            sizeof( loadedEXEFile.ntSignature );
+        loadedEXEFile.ntFileHeader =
+            valueOrThrow( PE::extractNTFileHeader( subReaderOrThrow( rawBytes, ntFileHeaderOffset,
+                                                                     "NT file header lies outside of the file." ) ),
+                          "NT file header is truncated." );
+
+        auto const ntOptionalHeaderOffset = ntFileHeaderOffset + sizeof( PE::NTFileHeader );
+        loadedEXEFile.ntOptionalHeader =
+            valueOrThrow( PE::extract64bitNTOptionalHeader( subReaderOrThrow( rawBytes, ntOptionalHeaderOffset,
+                                                                              "NT optional header lies outside of the file." ) ),
+                          "NT optional header is truncated." );
+
+        if ( loadedEXEFile.ntOptionalHeader.peSignature != optionalHeaderSig_PE32Plus )
+        {
+            throw std::runtime_error{ "Only PE32+ files are supported." };
+        }
 
-        auto rawBytes = std::vector<unsigned char>( fileSizeInBytes );
+        auto const dataDirectoryEntriesOffset =
+            ntOptionalHeaderOffset + sizeof( PE::NTOptionalHeader64 );
+        loadedEXEFile.dataDirectoryEntries =
+            valueOrThrow( PE::extractDataDirectoryEntries( subReaderOrThrow( rawBytes, dataDirectoryEntriesOffset,
+                                                                             "Data directories lie outside of the file." ),
+                                                           loadedEXEFile.ntOptionalHeader ),
+                          "Data directories are truncated." );
 
-        peFile.read( reinterpret_cast<char*>( rawBytes.data() ),
-                     fileSizeInBytes );
+        headersTimer.reset();
 
-        return rawBytes;
+        auto const sectionHeaderTableOffset =
+            dataDirectoryEntriesOffset +
+            loadedEXEFile.dataDirectoryEntries.size() * sizeof( PE::DataDirectoryEntry );
+        auto const numberOfSections = loadedEXEFile.ntFileHeader.numberOfSections;
+
+        loadedEXEFile.sectionHeadersNameToInfo =
+            valueOrThrow( PE::extractSectionHeaders( subReaderOrThrow( rawBytes, sectionHeaderTableOffset,
+                                                                       "Section header table lies outside of the file." ),
+                                                     numberOfSections ),
+                          "Section header table is truncated." );
+    }
+
+    void
+    parseEXEDirectories( EXEFile& loadedEXEFile )
+    {
+        auto importedDLLToImportedFunctions =
+            PE::extractImportedFunctionsInfo( loadedEXEFile.dataDirectoryEntries,
+                                              loadedEXEFile.sectionHeadersNameToInfo,
+                                              loadedEXEFile.sectionNameToRawData );
+        if ( importedDLLToImportedFunctions )
+        {
+            loadedEXEFile.importedDLLToImportedFunctions = std::move( *importedDLLToImportedFunctions );
+        }
+
+        auto exportedFunctionsInfo =
+            PE::extractExportedFunctionsInfo( loadedEXEFile.dataDirectoryEntries,
+                                              loadedEXEFile.sectionHeadersNameToInfo,
+                                              loadedEXEFile.sectionNameToRawData );
+        if ( exportedFunctionsInfo )
+        {
+            loadedEXEFile.exportedFunctions = std::move( *exportedFunctionsInfo );
+        }
+    }
+
+    void
+    readSectionRawData( FileRangeReader& fileRangeReader,
+                        EXEFile& loadedEXEFile,
+                        std::string const& sectionName )
+    {
+        auto const& sectionHeader = loadedEXEFile.sectionHeadersNameToInfo.at( sectionName );
+        auto sectionRawData = fileRangeReader.read( sectionHeader.pointerToRawData, sectionHeader.sizeOfRawDataInBytes );
+
+        if ( sectionRawData.size() != sectionHeader.sizeOfRawDataInBytes )
+        {
+            throw std::runtime_error{ "Section contents lie outside of the file." };
+        }
+
+        loadedEXEFile.sectionNameToRawData[sectionName] = std::move( sectionRawData );
     }
 }
 
-EXEFile
-loadEXEFile( std::string const& pathOfExecutableFile )
+std::vector<unsigned char>
+loadPEFileAsRawBytes( std::string const& pathOfPEFileToLoad )
 {
-    auto loadedEXEFile = EXEFile{};
+    auto const readTimer = Instrumentation::ScopedTimer{ "Read file" };
 
-    auto const rawBytes = loadPEFileAsRawBytes( pathOfExecutableFile );
+    auto peFile = std::ifstream{ pathOfPEFileToLoad, std::ios::binary };
 
-    loadedEXEFile.dosHeader = PE::extractDOSHeader( rawBytes.data() );
+    if( !peFile.is_open() )
+    {
+        throw std::runtime_error{ "Failed to open '" + pathOfPEFileToLoad + "'." };
+    }
 
-    auto const ntFileHeaderOffset =
-        loadedEXEFile.dosHeader.offsetOfNTSignature +
-        sizeof( loadedEXEFile.dosHeader.offsetOfNTSignature );
-    loadedEXEFile.ntFileHeader =
-        PE::extractNTFileHeader( rawBytes.data() + ntFileHeaderOffset );
+    auto const fileSizeInBytes =
+        static_cast<std::size_t>( peFile.seekg( 0, std::ios::end ).tellg() );
+    peFile.seekg( 0, std::ios::beg );
 
-    auto const ntOptionalHeaderOffset = ntFileHeaderOffset + sizeof( PE::NTFileHeader );
-    loadedEXEFile.ntOptionalHeader =
-        PE::extract64bitNTOptionalHeader( rawBytes.data() +
-                                          ntOptionalHeaderOffset );
+    auto rawBytes = std::vector<unsigned char>( fileSizeInBytes );
 
-    if ( loadedEXEFile.ntOptionalHeader.peSignature != optionalHeaderSig_PE32Plus )
+    if ( not peFile.read( reinterpret_cast<char*>( rawBytes.data() ),
+                          fileSizeInBytes ) )
     {
-        throw std::runtime_error{ "Only PE32+ files are supported." };
+        throw std::runtime_error{ "Failed to read '" + pathOfPEFileToLoad + "'." };
     }
 
-    auto const dataDirectoryEntriesOffset =
-        ntOptionalHeaderOffset + sizeof( PE::NTOptionalHeader64 );
-    loadedEXEFile.dataDirectoryEntries =
-        PE::extractDataDirectoryEntries( rawBytes.data() + dataDirectoryEntriesOffset,
-                                         loadedEXEFile.ntOptionalHeader );
+    Instrumentation::addToCounter( Instrumentation::Counter::BytesRead, fileSizeInBytes );
+    Instrumentation::addToCounter( Instrumentation::Counter::Allocations );
 
-    auto const sectionHeaderTableOffset =
-        dataDirectoryEntriesOffset +
-        loadedEXEFile.dataDirectoryEntries.size() * sizeof( PE::DataDirectoryEntry );
-    auto const numberOfSections = loadedEXEFile.ntFileHeader.numberOfSections;
+    return rawBytes;
+}
 
-    loadedEXEFile.sectionHeadersNameToInfo =
-        PE::extractSectionHeaders( rawBytes.data() + sectionHeaderTableOffset,
-                                   numberOfSections );
+EXEFile
+parseEXEFile( PE::ByteReader const& rawBytes )
+{
+    auto const parseTimer = Instrumentation::ScopedTimer{ "Parse EXE file" };
+
+    auto loadedEXEFile = EXEFile{};
+    parseEXEHeaders( rawBytes, loadedEXEFile );
 
     loadedEXEFile.sectionNameToRawData =
-        PE::extractRawSectionContents( rawBytes.data(),
-                                       loadedEXEFile.sectionHeadersNameToInfo );
+        valueOrThrow( PE::extractRawSectionContents( rawBytes,
+                                                     loadedEXEFile.sectionHeadersNameToInfo ),
+                      "Section contents lie outside of the file." );
 
-    auto importedDLLToImportedFunctions =
-        PE::extractImportedFunctionsInfo( loadedEXEFile.dataDirectoryEntries,
-                                          loadedEXEFile.sectionHeadersNameToInfo,
-                                          loadedEXEFile.sectionNameToRawData );
-    if ( importedDLLToImportedFunctions )
+    parseEXEDirectories( loadedEXEFile );
+
+    return loadedEXEFile;
+}
+
+EXEFile
+loadEXEFile( std::string const& pathOfExecutableFile,
+             ParseDepth const parseDepth )
+{
+    if ( parseDepth == ParseDepth::Full )
     {
-        loadedEXEFile.importedDLLToImportedFunctions = *importedDLLToImportedFunctions;
+        auto const rawBytes = loadPEFileAsRawBytes( pathOfExecutableFile );
+
+        return parseEXEFile( PE::ByteReader{ rawBytes } );
     }
 
-    auto exportedFunctionsInfo =
-        PE::extractExportedFunctionsInfo( loadedEXEFile.dataDirectoryEntries,
-                                          loadedEXEFile.sectionHeadersNameToInfo,
-                                          loadedEXEFile.sectionNameToRawData );
-    if ( exportedFunctionsInfo )
+    auto fileRangeReader = FileRangeReader{ pathOfExecutableFile };
+
+    auto const headerBytes = [&]()
     {
-        loadedEXEFile.exportedFunctions = *exportedFunctionsInfo;
+        auto const readTimer = Instrumentation::ScopedTimer{ "Read headers" };
+
+        return readHeaderBytes( fileRangeReader, initialHeadersReadSizeInBytes, &getSizeOfEXEHeadersInBytes );
+    }();
+
+    auto const parseTimer = Instrumentation::ScopedTimer{ "Parse EXE file" };
+
+    auto loadedEXEFile = EXEFile{};
+    parseEXEHeaders( PE::ByteReader{ headerBytes }, loadedEXEFile );
+
+    if ( parseDepth == ParseDepth::Headers )
+    {
+        return loadedEXEFile;
     }
 
+    // The directories and the names they point to nearly always share a
+    // section, so only the sections holding the directories are read. Should
+    // a directory then fail to resolve, every other section is read as well.
+    auto const directoryRVAs = std::vector<std::uint32_t>
+    {
+        loadedEXEFile.dataDirectoryEntries.size() > 0 ? loadedEXEFile.dataDirectoryEntries[0].dataDirectoryRVA : 0,
+        loadedEXEFile.dataDirectoryEntries.size() > 1 ? loadedEXEFile.dataDirectoryEntries[1].dataDirectoryRVA : 0
+    };
+
+    for ( auto const& [sectionName, sectionHeader] : loadedEXEFile.sectionHeadersNameToInfo )
+    {
+        auto const holdsDirectory =
+            std::any_of( directoryRVAs.begin(), directoryRVAs.end(),
+                         [&sectionHeader]( std::uint32_t const directoryRVA )
+                         {
+                             return directoryRVA != 0
+                                    and directoryRVA >= sectionHeader.sectionBaseAddressInMemory
+                                    and directoryRVA - sectionHeader.sectionBaseAddressInMemory < sectionHeader.sectionSizeInBytesInMemory;
+                         } );
+
+        if ( holdsDirectory )
+        {
+            readSectionRawData( fileRangeReader, loadedEXEFile, sectionName );
+        }
+    }
+
+    parseEXEDirectories( loadedEXEFile );
+
+    auto const isMissingImports = directoryRVAs[1] != 0 and loadedEXEFile.importedDLLToImportedFunctions.empty();
+    auto const isMissingExports = directoryRVAs[0] != 0 and loadedEXEFile.exportedFunctions.empty();
+
+    if ( isMissingImports or isMissingExports )
+    {
+        for ( auto const& [sectionName, sectionHeader] : loadedEXEFile.sectionHeadersNameToInfo )
+        {
+            if ( not loadedEXEFile.sectionNameToRawData.contains( sectionName ) )
+            {
+                readSectionRawData( fileRangeReader, loadedEXEFile, sectionName );
+            }
+        }
+
+        parseEXEDirectories( loadedEXEFile );
+    }
+
+    loadedEXEFile.sectionNameToRawData.clear();
+
     return loadedEXEFile;
 }
 
+std::uint64_t
+getEstimatedMemoryUsageInBytes( EXEFile const& loadedEXEFile )
+{
+    auto memoryUsageInBytes =
+        sizeof( EXEFile ) +
+        loadedEXEFile.dataDirectoryEntries.capacity() * sizeof( PE::DataDirectoryEntry ) +
+        loadedEXEFile.exportedFunctions.capacity() * sizeof( PE::ExportedFunction );
+
+    if ( loadedEXEFile.richHeader )
+    {
+        memoryUsageInBytes += loadedEXEFile.richHeader->entries.capacity() * sizeof( RichHeaderEntry );
+    }
+
+    for ( auto const& [sectionName, sectionHeader] : loadedEXEFile.sectionHeadersNameToInfo )
+    {
+        memoryUsageInBytes += estimatedMapNodeOverheadInBytes +
+                              getEstimatedMemoryUsageInBytes( sectionName ) +
+                              sizeof( sectionHeader );
+    }
+
+    for ( auto const& [sectionName, sectionRawData] : loadedEXEFile.sectionNameToRawData )
+    {
+        memoryUsageInBytes += estimatedMapNodeOverheadInBytes +
+                              getEstimatedMemoryUsageInBytes( sectionName ) +
+                              sizeof( sectionRawData ) +
+                              sectionRawData.capacity();
+    }
+
+    for ( auto const& [importedDLLName, importedFunctions] : loadedEXEFile.importedDLLToImportedFunctions )
+    {
+        memoryUsageInBytes += estimatedMapNodeOverheadInBytes +
+                              getEstimatedMemoryUsageInBytes( importedDLLName ) +
+                              sizeof( importedFunctions ) +
+                              importedFunctions.capacity() * sizeof( PE::ImportedFunction );
+
+        for ( auto const& importedFunction : importedFunctions )
+        {
+            memoryUsageInBytes += getEstimatedMemoryUsageInBytes( importedFunction.name ) - sizeof( std::string );
+        }
+    }
+
+    for ( auto const& exportedFunction : loadedEXEFile.exportedFunctions )
+    {
+        memoryUsageInBytes += getEstimatedMemoryUsageInBytes( exportedFunction.name ) - sizeof( std::string );
+    }
+
+    return memoryUsageInBytes;
+}
+
+std::vector<PE::RuntimeFunction>
+getRuntimeFunctions( EXEFile const& loadedEXEFile )
+{
+    auto const& dataDirectoryEntries = loadedEXEFile.dataDirectoryEntries;
+
+    if (    dataDirectoryEntries.size() <= exceptionTableIdx
+         or dataDirectoryEntries[exceptionTableIdx].dataDirectoryRVA == 0 )
+    {
+        return {};
+    }
+
+    auto const& exceptionTable = dataDirectoryEntries[exceptionTableIdx];
+
+    // The table is read from the one section whose memory range holds its
+    // RVA, never from a section that merely starts below it.
+    for ( auto const& [sectionName, sectionHeader] : loadedEXEFile.sectionHeadersNameToInfo )
+    {
+        auto const sectionRVA = std::uint64_t{ sectionHeader.sectionBaseAddressInMemory };
+
+        if (    exceptionTable.dataDirectoryRVA < sectionRVA
+             or exceptionTable.dataDirectoryRVA - sectionRVA >= sectionHeader.sectionSizeInBytesInMemory )
+        {
+            continue;
+        }
+
+        auto const sectionRawData = loadedEXEFile.sectionNameToRawData.find( sectionName );
+
+        if ( sectionRawData != loadedEXEFile.sectionNameToRawData.end() )
+        {
+            auto runtimeFunctions =
+                PE::ByteReader{ sectionRawData->second }.readArray<PE::RuntimeFunction>(
+                    exceptionTable.dataDirectoryRVA - sectionRVA,
+                    exceptionTable.sizeInBytes / sizeof( PE::RuntimeFunction ) );
+            if ( runtimeFunctions )
+            {
+                return std::move( *runtimeFunctions );
+            }
+        }
+
+        break;
+    }
+
+    return {};
+}
+
 OBJFile
-loadOBJFile( std::string const& pathOfObjectFile )
+parseOBJFile( PE::ByteReader const& rawBytes )
 {
-    auto loadedOBJFile = OBJFile{};
+    auto const parseTimer = Instrumentation::ScopedTimer{ "Parse OBJ file" };
 
-    auto const rawBytes = loadPEFileAsRawBytes( pathOfObjectFile );
+    auto loadedOBJFile = OBJFile{};
 
-    loadedOBJFile.ntFileHeader = PE::extractNTFileHeader( rawBytes.data() );
+    loadedOBJFile.ntFileHeader =
+        valueOrThrow( PE::extractNTFileHeader( rawBytes ),
+                      "File is too small to hold an NT file header." );
 
     loadedOBJFile.sectionHeaders =
-        PE::extractSectionHeadersFromOBJFile( rawBytes.data() + sizeof( PE::NTFileHeader ),
-                                              loadedOBJFile.ntFileHeader.numberOfSections );
+        valueOrThrow( PE::extractSectionHeadersFromOBJFile( subReaderOrThrow( rawBytes, sizeof( PE::NTFileHeader ),
+                                                                              "Section header table lies outside of the file." ),
+                                                            loadedOBJFile.ntFileHeader.numberOfSections ),
+                      "Section header table is truncated." );
 
     return loadedOBJFile;
+}
+
+OBJFile
+loadOBJFile( std::string const& pathOfObjectFile )
+{
+    auto fileRangeReader = FileRangeReader{ pathOfObjectFile };
+
+    auto const headerBytes = [&]()
+    {
+        auto const readTimer = Instrumentation::ScopedTimer{ "Read headers" };
+
+        return readHeaderBytes( fileRangeReader, initialHeadersReadSizeInBytes, &getSizeOfOBJHeadersInBytes );
+    }();
+
+    return parseOBJFile( PE::ByteReader{ headerBytes } );
+}
+
+std::uint64_t
+getEstimatedMemoryUsageInBytes( OBJFile const& loadedOBJFile )
+{
+    auto memoryUsageInBytes = std::uint64_t{ sizeof( OBJFile ) };
+
+    for ( auto const& [sectionName, sectionHeaders] : loadedOBJFile.sectionHeaders )
+    {
+        memoryUsageInBytes += estimatedMapNodeOverheadInBytes +
+                              getEstimatedMemoryUsageInBytes( sectionName ) +
+                              sizeof( sectionHeaders ) +
+                              sectionHeaders.capacity() * sizeof( PE::SectionHeader );
+    }
+
+    return memoryUsageInBytes;
 }
\ No newline at end of file
@@ -3,26 +3,57 @@
 #define PEFILES_H
 
 #include "PEFormat.h"
+#include "RichHeader.h"
 
+#include <cstdint>
 #include <map>
+#include <optional>
 #include <string>
 #include <vector>
 
 struct EXEFile
 {
     PE::DOSHeader                                        dosHeader;
-    unsigned long                                        ntSignature;
+    std::optional<RichHeader>                            richHeader;
+    std::uint32_t                                        ntSignature;
     PE::NTFileHeader                                     ntFileHeader;
     PE::NTOptionalHeader64                               ntOptionalHeader;
     std::vector<PE::DataDirectoryEntry>                  dataDirectoryEntries;
     std::map<std::string, PE::SectionHeader>             sectionHeadersNameToInfo;
     std::map<std::string, std::vector<unsigned char>>    sectionNameToRawData;
-    std::map<std::string, std::vector<std::string>>      importedDLLToImportedFunctions;
+    std::map<std::string, std::vector<PE::ImportedFunction>>    importedDLLToImportedFunctions;
     std::vector<PE::ExportedFunction>                    exportedFunctions;
 };
 
+// How much of an executable to read. Headers reads the DOS, NT and section
+// headers with one or two small reads at the start of the file. Directories
+// also reads the sections holding the import and export directories to fill
+// in the imported and exported functions. Full reads the whole file and keeps
+// the raw data of every section; the other depths leave it empty.
+enum class ParseDepth : std::uint8_t
+{
+    Headers,
+    Directories,
+    Full
+};
+
+std::vector<unsigned char>
+loadPEFileAsRawBytes( std::string const& pathOfPEFileToLoad );
+
+EXEFile
+parseEXEFile( PE::ByteReader const& rawBytes );
+
 EXEFile
-loadEXEFile( std::string const& pathOfExecutableFile );
+loadEXEFile( std::string const& pathOfExecutableFile,
+             ParseDepth const parseDepth = ParseDepth::Full );
+
+std::uint64_t
+getEstimatedMemoryUsageInBytes( EXEFile const& loadedEXEFile );
+
+// The entries of the exception directory, which lies in section raw data and
+// so is only available after a Full parse. Empty when the image has none.
+std::vector<PE::RuntimeFunction>
+getRuntimeFunctions( EXEFile const& loadedEXEFile );
 
 struct OBJFile
 {
@@ -30,7 +61,14 @@ struct OBJFile
     std::map<std::string, std::vector<PE::SectionHeader>>    sectionHeaders;
 };
 
+OBJFile
+parseOBJFile( PE::ByteReader const& rawBytes );
+
+// Only reads the file header and the section header table.
 OBJFile
 loadOBJFile( std::string const& pathOfObjectFile );
 
+std::uint64_t
+getEstimatedMemoryUsageInBytes( OBJFile const& loadedOBJFile );
+
 #endif // PEFILES_H
\ No newline at end of file
@@ -1,143 +1,164 @@
 
 #include "PEFormat.h"
 
+#include "Instrumentation.h"
+#include "KnownOrdinals.h"
+#include "PEFieldDescriptors.h"
+
 #include <cstring>
+#include <utility>
 
 namespace
 {
     auto const exportTableIdx = 0;
     auto const importTableIdx = 1;
 
-    std::string
-    getSectionName( unsigned long long const sectionNameAsNumber )
+    // The caller has checked that the table holds the header.
+    PE::SectionHeader
+    decodeSectionHeader( PE::ByteReader const& sectionHeaderTable,
+                         std::size_t const sectionIdx )
+    {
+        return *PE::decodeFields<PE::SectionHeader, PE::sectionHeaderFields>(
+                    *sectionHeaderTable.subReader( sectionIdx * sizeof( PE::SectionHeader ) ) );
+    }
+
+    class SectionRVAResolver
     {
-        auto numberRepresentationHasNull = false;
-        for ( auto i = 0; i < sizeof( sectionNameAsNumber ); i++ )
+    public:
+        SectionRVAResolver( std::map<std::string, PE::SectionHeader> const& sectionNameToHeader,
+                            std::map<std::string, std::vector<unsigned char>> const& sectionRawData )
         {
-            if ( ( reinterpret_cast<char const*>( &sectionNameAsNumber )[i] ) == '\0' )
+            m_mappedSections.reserve( sectionNameToHeader.size() );
+
+            for ( auto const& [sectionName, sectionHeader] : sectionNameToHeader )
             {
-                numberRepresentationHasNull = true;
-                break;
+                auto const sectionRawDataEntry = sectionRawData.find( sectionName );
+
+                if ( sectionRawDataEntry == sectionRawData.end() )
+                {
+                    continue;
+                }
+
+                m_mappedSections.push_back( MappedSection
+                                            {
+                                                .baseAddressInMemory = sectionHeader.sectionBaseAddressInMemory,
+                                                .sizeInBytesInMemory = sectionHeader.sectionSizeInBytesInMemory,
+                                                .rawData = PE::ByteReader{ sectionRawDataEntry->second }
+                                            } );
             }
         }
 
-        if ( not numberRepresentationHasNull )
-        {
-            return std::string( reinterpret_cast<char const*>( &sectionNameAsNumber ),
-                                sizeof( sectionNameAsNumber ) );
-        }
-        else
+        std::optional<PE::ByteReader>
+        getReaderAtRVA( std::uint64_t const rvaOfInterest ) const
         {
-            return std::string( reinterpret_cast<char const*>( &sectionNameAsNumber ) );
+            if ( m_lastHitSection != nullptr and m_lastHitSection->containsRVA( rvaOfInterest ) )
+            {
+                return m_lastHitSection->rawData.subReader( rvaOfInterest - m_lastHitSection->baseAddressInMemory );
+            }
+
+            for ( auto const& mappedSection : m_mappedSections )
+            {
+                if ( mappedSection.containsRVA( rvaOfInterest ) )
+                {
+                    m_lastHitSection = &mappedSection;
+
+                    return mappedSection.rawData.subReader( rvaOfInterest - mappedSection.baseAddressInMemory );
+                }
+            }
+
+            return std::nullopt;
         }
-    }
 
-    std::optional<std::string>
-    getNameOfSectionContainingRVA( std::map<std::string, PE::SectionHeader> const& sectionNameToHeader,
-                                   unsigned long long const rvaOfInterest )
-    {
-        for ( auto const& [sectionName, sectionHeader] : sectionNameToHeader )
+    private:
+        struct MappedSection
         {
-            if (    rvaOfInterest >= sectionHeader.sectionBaseAddressInMemory
-                and rvaOfInterest < sectionHeader.sectionBaseAddressInMemory + sectionHeader.sectionSizeInBytesInMemory )
+            std::uint32_t     baseAddressInMemory;
+            std::uint32_t     sizeInBytesInMemory;
+            PE::ByteReader    rawData;
+
+            bool
+            containsRVA( std::uint64_t const rvaOfInterest ) const
             {
-                return sectionName;
+                return rvaOfInterest >= baseAddressInMemory and
+                       rvaOfInterest < std::uint64_t{ baseAddressInMemory } + sizeInBytesInMemory;
             }
-        }
+        };
 
-        return std::nullopt;
-    }
+        std::vector<MappedSection>       m_mappedSections;
+        mutable MappedSection const*    m_lastHitSection = nullptr;
+    };
 
     bool
     hasImportTable( std::vector<PE::DataDirectoryEntry> const& dataDirectoryEntries )
     {
-        return dataDirectoryEntries[importTableIdx].dataDirectoryRVA != 0 and
+        return dataDirectoryEntries.size() > importTableIdx and
+               dataDirectoryEntries[importTableIdx].dataDirectoryRVA != 0 and
                dataDirectoryEntries[importTableIdx].sizeInBytes != 0;
     }
 
-    struct ImportDirectoryTableEntry
-    {
-        unsigned long    importLookupTableRVA;
-        unsigned long    timestamp;
-        unsigned long    forwarderChainIdx;
-        unsigned long    namestringRVA;
-        unsigned long    importAddressTableRVA;
-    };
-
     struct ImportLookupTableEntry64
     {
-        unsigned long long    ordinalNumberOrNameTableRVA: 63;
-        unsigned long long    isOrdinal: 1;
+        std::uint64_t    ordinalNumberOrNameTableRVA: 63;
+        std::uint64_t    isOrdinal: 1;
     };
 
+    auto const ordinalNumberMask = 0xFFFF;
+
     bool
     hasExportTable( std::vector<PE::DataDirectoryEntry> const& dataDirectoryEntries )
     {
-        return dataDirectoryEntries[exportTableIdx].dataDirectoryRVA != 0 and
+        return dataDirectoryEntries.size() > exportTableIdx and
+               dataDirectoryEntries[exportTableIdx].dataDirectoryRVA != 0 and
                dataDirectoryEntries[exportTableIdx].sizeInBytes != 0;
     }
-
-    struct ExportDirectoryTableEntry
-    {
-        unsigned long     _reserved1;
-        unsigned long     timestamp;
-        unsigned short    dllMajorVersion;
-        unsigned short    dllMinorVersion;
-        unsigned long     namestringRVA;
-        unsigned long     baseOrdinalNumber;
-        unsigned long     numberOfExportAddressTableEntries;
-        unsigned long     numberOfNamePointerTableEntries;
-        unsigned long     exportAddressTableRVA;
-        unsigned long     namePointerTableRVA;
-        unsigned long     ordinalTableRVA;
-    };
 }
 
 namespace PE
 {
-    DOSHeader
-    extractDOSHeader( unsigned char const* rawBytesFromStartOfDOSHeader )
+    std::optional<DOSHeader>
+    extractDOSHeader( ByteReader const& rawBytesFromStartOfDOSHeader )
     {
-        return *reinterpret_cast<DOSHeader const*>( rawBytesFromStartOfDOSHeader );
+        return rawBytesFromStartOfDOSHeader.read<DOSHeader>( 0 );
     }
 
-    NTFileHeader
-    extractNTFileHeader( unsigned char const* rawBytesFromStartOfNTFileHeader )
+    std::optional<NTFileHeader>
+    extractNTFileHeader( ByteReader const& rawBytesFromStartOfNTFileHeader )
     {
-        return *reinterpret_cast<NTFileHeader const*>( rawBytesFromStartOfNTFileHeader );
+        return decodeFields<NTFileHeader, ntFileHeaderFields>( rawBytesFromStartOfNTFileHeader );
     }
 
-    NTOptionalHeader64
-    extract64bitNTOptionalHeader( unsigned char const* rawBytesFromStartOfNTOptionalHeader )
+    std::optional<NTOptionalHeader64>
+    extract64bitNTOptionalHeader( ByteReader const& rawBytesFromStartOfNTOptionalHeader )
     {
-        return *reinterpret_cast<NTOptionalHeader64 const*>( rawBytesFromStartOfNTOptionalHeader );
+        return decodeFields<NTOptionalHeader64, ntOptionalHeader64Fields>( rawBytesFromStartOfNTOptionalHeader );
     }
 
-    std::vector<DataDirectoryEntry>
-    extractDataDirectoryEntries( unsigned char const* rawBytesFromStartOfDataDirectories,
+    std::optional<std::vector<DataDirectoryEntry>>
+    extractDataDirectoryEntries( ByteReader const& rawBytesFromStartOfDataDirectories,
                                  NTOptionalHeader64 const& ntOptionalHeader )
     {
-        auto dataDirectoryEntries = std::vector<DataDirectoryEntry>{};
-        dataDirectoryEntries.resize( ntOptionalHeader.numberOfDataDirectories );
-
-        std::memcpy( dataDirectoryEntries.data(),
-                     rawBytesFromStartOfDataDirectories,
-                     ntOptionalHeader.numberOfDataDirectories * sizeof( DataDirectoryEntry ) );
-
-        return dataDirectoryEntries;
+        return rawBytesFromStartOfDataDirectories.readArray<DataDirectoryEntry>( 0, ntOptionalHeader.numberOfDataDirectories );
     }
 
-    std::map<std::string, SectionHeader>
-    extractSectionHeaders( unsigned char const* rawBytesFromStartOfSectionHeaders,
+    std::optional<std::map<std::string, SectionHeader>>
+    extractSectionHeaders( ByteReader const& rawBytesFromStartOfSectionHeaders,
                            int const numberOfSections )
     {
+        auto const sectionHeadersTimer = Instrumentation::ScopedTimer{ "Section headers" };
+
+        auto const sectionHeaderTable =
+            rawBytesFromStartOfSectionHeaders.subReader( 0, numberOfSections * sizeof( SectionHeader ) );
+
+        if ( numberOfSections < 0 or not sectionHeaderTable )
+        {
+            return std::nullopt;
+        }
+
         auto sectionNameToHeader = std::map<std::string, SectionHeader>{};
 
         for ( auto i = 0; i < numberOfSections; i++ )
         {
-            auto const& sectionHeader =
-                *reinterpret_cast<SectionHeader const*>( rawBytesFromStartOfSectionHeaders +
-                                                         i * sizeof( SectionHeader ) );
+            auto const sectionHeader = decodeSectionHeader( *sectionHeaderTable, i );
             auto const sectionName = getSectionName( sectionHeader.sectionNameAsNumber );
 
             sectionNameToHeader[sectionName] = sectionHeader;
@@ -146,17 +167,25 @@ namespace PE
         return sectionNameToHeader;
     }
 
-    std::map<std::string, std::vector<SectionHeader>>
-    extractSectionHeadersFromOBJFile( unsigned char const* rawBytesFromStartOfSectionHeaders,
+    std::optional<std::map<std::string, std::vector<SectionHeader>>>
+    extractSectionHeadersFromOBJFile( ByteReader const& rawBytesFromStartOfSectionHeaders,
                                       int const numberOfSections )
     {
+        auto const sectionHeadersTimer = Instrumentation::ScopedTimer{ "Section headers" };
+
+        auto const sectionHeaderTable =
+            rawBytesFromStartOfSectionHeaders.subReader( 0, numberOfSections * sizeof( SectionHeader ) );
+
+        if ( numberOfSections < 0 or not sectionHeaderTable )
+        {
+            return std::nullopt;
+        }
+
         auto sectionNameToHeader = std::map<std::string, std::vector<SectionHeader>>{};
 
         for ( auto i = 0; i < numberOfSections; i++ )
         {
-            auto const& sectionHeader =
-                *reinterpret_cast<SectionHeader const*>( rawBytesFromStartOfSectionHeaders +
-                                                         i * sizeof( SectionHeader ) );
+            auto const sectionHeader = decodeSectionHeader( *sectionHeaderTable, i );
             auto const sectionName = getSectionName( sectionHeader.sectionNameAsNumber );
 
             sectionNameToHeader[sectionName].push_back( sectionHeader );
@@ -165,28 +194,53 @@ namespace PE
         return sectionNameToHeader;
     }
 
-    std::map<std::string, std::vector<unsigned char>>
-    extractRawSectionContents( unsigned char const* rawBytesFromStartOfFile,
+    std::optional<std::uint64_t>
+    convertRVAToFileOffset( std::map<std::string, SectionHeader> const& sectionHeaders,
+                            std::uint64_t const rvaOfInterest )
+    {
+        for ( auto const& [sectionName, sectionHeader] : sectionHeaders )
+        {
+            auto const offsetInSection = rvaOfInterest - sectionHeader.sectionBaseAddressInMemory;
+
+            if (     rvaOfInterest >= sectionHeader.sectionBaseAddressInMemory
+                 and offsetInSection < sectionHeader.sizeOfRawDataInBytes )
+            {
+                return std::uint64_t{ sectionHeader.pointerToRawData } + offsetInSection;
+            }
+        }
+
+        return std::nullopt;
+    }
+
+    std::optional<std::map<std::string, std::vector<unsigned char>>>
+    extractRawSectionContents( ByteReader const& rawBytesFromStartOfFile,
                                std::map<std::string, SectionHeader> const& sectionHeaders )
     {
+        auto const sectionContentsTimer = Instrumentation::ScopedTimer{ "Section contents" };
+
         auto sectionNameToRawData = std::map<std::string, std::vector<unsigned char>>{};
 
         for ( auto const& [sectionName, sectionHeader] : sectionHeaders )
         {
-            auto const sectionSizeInFile = sectionHeader.sizeOfRawDataInBytes;
-            auto const sectionOffsetInFile = sectionHeader.pointerToRawData;
+            auto const sectionContents =
+                rawBytesFromStartOfFile.subReader( sectionHeader.pointerToRawData,
+                                                   sectionHeader.sizeOfRawDataInBytes );
 
-            sectionNameToRawData[sectionName].resize( sectionSizeInFile );
+            if ( not sectionContents )
+            {
+                return std::nullopt;
+            }
 
-            std::memcpy( sectionNameToRawData.at( sectionName ).data(),
-                         rawBytesFromStartOfFile + sectionOffsetInFile,
-                         sectionSizeInFile );
+            sectionNameToRawData[sectionName].assign( sectionContents->data(),
+                                                      sectionContents->data() + sectionContents->size() );
         }
 
+        Instrumentation::addToCounter( Instrumentation::Counter::Allocations, sectionNameToRawData.size() );
+
         return sectionNameToRawData;
     }
 
-    std::optional<std::map<std::string, std::vector<std::string>>>
+    std::optional<std::map<std::string, std::vector<ImportedFunction>>>
     extractImportedFunctionsInfo( std::vector<DataDirectoryEntry> const& dataDirectoryEntries,
                                   std::map<std::string, SectionHeader> const& sectionHeaders,
                                   std::map<std::string, std::vector<unsigned char>> const& sectionRawData )
@@ -196,67 +250,111 @@ namespace PE
             return std::nullopt;
         }
 
-        auto hostSectionName =
-            getNameOfSectionContainingRVA( sectionHeaders,
-                                           dataDirectoryEntries[importTableIdx].dataDirectoryRVA );
+        auto const importsTimer = Instrumentation::ScopedTimer{ "Imports" };
+
+        auto const sectionRVAResolver = SectionRVAResolver{ sectionHeaders, sectionRawData };
+
+        auto const importDirectoryTable =
+            sectionRVAResolver.getReaderAtRVA( dataDirectoryEntries[importTableIdx].dataDirectoryRVA );
 
-        if ( not hostSectionName )
+        if ( not importDirectoryTable )
         {
             return std::nullopt;
         }
 
-        auto const& hostSectionHeader = sectionHeaders.at( *hostSectionName );
-        auto const hostSectionRawBytes = sectionRawData.at( *hostSectionName ).data();
+        auto dllNameToImportedFunctions = std::map<std::string, std::vector<ImportedFunction>>{};
 
-        auto const importDirectoryTable =
-            reinterpret_cast<ImportDirectoryTableEntry const*>
-                ( hostSectionRawBytes +
-                  dataDirectoryEntries[importTableIdx].dataDirectoryRVA -
-                  hostSectionHeader.sectionBaseAddressInMemory );
+        for ( auto i = std::size_t{ 0 };; i++ )
+        {
+            auto const importDirectoryTableEntry =
+                importDirectoryTable->read<ImportDirectoryTableEntry>( i * sizeof( ImportDirectoryTableEntry ) );
 
-        auto dllNameToImportedFunctionNames = std::map<std::string, std::vector<std::string>>{};
+            if ( not importDirectoryTableEntry )
+            {
+                return std::nullopt;
+            }
 
-        for ( auto i = 0;; i++ )
-        {
-            if (     importDirectoryTable[i].importLookupTableRVA == 0
-                 and importDirectoryTable[i].timestamp == 0
-                 and importDirectoryTable[i].forwarderChainIdx == 0
-                 and importDirectoryTable[i].namestringRVA == 0
-                 and importDirectoryTable[i].importAddressTableRVA == 0 )
+            if (     importDirectoryTableEntry->importLookupTableRVA == 0
+                 and importDirectoryTableEntry->timestamp == 0
+                 and importDirectoryTableEntry->forwarderChainIdx == 0
+                 and importDirectoryTableEntry->namestringRVA == 0
+                 and importDirectoryTableEntry->importAddressTableRVA == 0 )
             {
                 break;
             }
 
+            auto const importedDLLNameBytes =
+                sectionRVAResolver.getReaderAtRVA( importDirectoryTableEntry->namestringRVA );
             auto const importedDLLName =
-                std::string( reinterpret_cast<char const*>( hostSectionRawBytes +
-                                                            importDirectoryTable[i].namestringRVA -
-                                                            hostSectionHeader.sectionBaseAddressInMemory ) );
+                importedDLLNameBytes ? importedDLLNameBytes->readNullTerminatedString( 0 ) : std::nullopt;
 
             auto const importLookupTable =
-                reinterpret_cast<ImportLookupTableEntry64 const*>
-                    ( hostSectionRawBytes +
-                      importDirectoryTable[i].importLookupTableRVA -
-                      hostSectionHeader.sectionBaseAddressInMemory );
+                sectionRVAResolver.getReaderAtRVA( importDirectoryTableEntry->importLookupTableRVA );
 
-            for ( auto j = 0;; j++ )
+            if ( not importedDLLName or not importLookupTable )
             {
-                if (     importLookupTable[j].ordinalNumberOrNameTableRVA == 0
-                     and importLookupTable[j].isOrdinal == 0 )
+                return std::nullopt;
+            }
+
+            auto& importedFunctions = dllNameToImportedFunctions[*importedDLLName];
+
+            for ( auto j = std::size_t{ 0 };; j++ )
+            {
+                auto const importLookupTableEntry =
+                    importLookupTable->read<ImportLookupTableEntry64>( j * sizeof( ImportLookupTableEntry64 ) );
+
+                if ( not importLookupTableEntry )
+                {
+                    return std::nullopt;
+                }
+
+                if (     importLookupTableEntry->ordinalNumberOrNameTableRVA == 0
+                     and importLookupTableEntry->isOrdinal == 0 )
                 {
                     break;
                 }
 
-                auto const importedFunctionName =
-                    std::string( reinterpret_cast<char const*>( hostSectionRawBytes +
-                                                                importLookupTable[j].ordinalNumberOrNameTableRVA +
-                                                                sizeof( unsigned short ) -
-                                                                hostSectionHeader.sectionBaseAddressInMemory ) );
+                auto const iatSlotRVA =
+                    static_cast<std::uint32_t>( importDirectoryTableEntry->importAddressTableRVA +
+                                                j * sizeof( ImportLookupTableEntry64 ) );
+
+                if ( importLookupTableEntry->isOrdinal )
+                {
+                    auto const ordinalNumber =
+                        static_cast<std::uint16_t>( importLookupTableEntry->ordinalNumberOrNameTableRVA & ordinalNumberMask );
+                    auto const knownName = findKnownOrdinalName( *importedDLLName, ordinalNumber );
+
+                    importedFunctions.push_back( ImportedFunction
+                                                 {
+                                                    .name = knownName.empty() ? "#" + std::to_string( ordinalNumber ) : std::string( knownName ),
+                                                    .iatSlotRVA = iatSlotRVA,
+                                                    .ordinal = ordinalNumber
+                                                 } );
+                    continue;
+                }
 
-                dllNameToImportedFunctionNames[importedDLLName].push_back( importedFunctionName );
+                auto const hintNameTableEntry =
+                    sectionRVAResolver.getReaderAtRVA( importLookupTableEntry->ordinalNumberOrNameTableRVA );
+                auto importedFunctionName =
+                    hintNameTableEntry ? hintNameTableEntry->readNullTerminatedString( sizeof( std::uint16_t ) ) : std::nullopt;
+
+                if ( not importedFunctionName )
+                {
+                    return std::nullopt;
+                }
+
+                importedFunctions.push_back( ImportedFunction
+                                             {
+                                                .name = std::move( *importedFunctionName ),
+                                                .iatSlotRVA = iatSlotRVA
+                                             } );
             }
+
+            Instrumentation::addToCounter( Instrumentation::Counter::NamesDecoded, importedFunctions.size() + 1 );
+            Instrumentation::addToCounter( Instrumentation::Counter::Allocations, importedFunctions.size() + 1 );
         }
 
-        return dllNameToImportedFunctionNames;
+        return dllNameToImportedFunctions;
     }
 
     std::optional<std::vector<ExportedFunction>>
@@ -269,49 +367,108 @@ namespace PE
             return std::nullopt;
         }
 
-        auto hostSectionName =
-            getNameOfSectionContainingRVA( sectionHeaders,
-                                           dataDirectoryEntries[exportTableIdx].dataDirectoryRVA );
+        auto const exportsTimer = Instrumentation::ScopedTimer{ "Exports" };
 
-        if ( not hostSectionName )
+        auto const sectionRVAResolver = SectionRVAResolver{ sectionHeaders, sectionRawData };
+
+        auto const exportDirectoryTable =
+            sectionRVAResolver.getReaderAtRVA( dataDirectoryEntries[exportTableIdx].dataDirectoryRVA );
+
+        auto const exportDirectoryTableSoleEntry =
+            exportDirectoryTable ? exportDirectoryTable->read<ExportDirectoryTableEntry>( 0 ) : std::nullopt;
+
+        if ( not exportDirectoryTableSoleEntry )
         {
             return std::nullopt;
         }
 
-        auto const& hostSectionHeader = sectionHeaders.at( *hostSectionName );
-        auto const hostSectionRawBytes = sectionRawData.at( *hostSectionName ).data();
+        auto const namePointerTableBytes =
+            sectionRVAResolver.getReaderAtRVA( exportDirectoryTableSoleEntry->namePointerTableRVA );
+        auto const namePointerTable =
+            namePointerTableBytes
+                ? namePointerTableBytes->readArray<std::uint32_t>( 0, exportDirectoryTableSoleEntry->numberOfNamePointerTableEntries )
+                : std::nullopt;
 
-        auto const& exportDirectoryTableSoleEntry =
-            *reinterpret_cast<ExportDirectoryTableEntry const*>
-                ( hostSectionRawBytes +
-                  dataDirectoryEntries[exportTableIdx].dataDirectoryRVA -
-                  hostSectionHeader.sectionBaseAddressInMemory );
+        if ( not namePointerTable )
+        {
+            return std::nullopt;
+        }
 
-        auto const namePointerTable =
-            reinterpret_cast<unsigned long const*>( hostSectionRawBytes +
-                                                    exportDirectoryTableSoleEntry.namePointerTableRVA -
-                                                    hostSectionHeader.sectionBaseAddressInMemory );
+        auto const ordinalTableBytes =
+            sectionRVAResolver.getReaderAtRVA( exportDirectoryTableSoleEntry->ordinalTableRVA );
+        auto const ordinalTable =
+            ordinalTableBytes
+                ? ordinalTableBytes->readArray<std::uint16_t>( 0, exportDirectoryTableSoleEntry->numberOfNamePointerTableEntries )
+                : std::nullopt;
+
+        auto const exportAddressTableBytes =
+            sectionRVAResolver.getReaderAtRVA( exportDirectoryTableSoleEntry->exportAddressTableRVA );
+        auto const exportAddressTable =
+            exportAddressTableBytes
+                ? exportAddressTableBytes->readArray<std::uint32_t>( 0, exportDirectoryTableSoleEntry->numberOfExportAddressTableEntries )
+                : std::nullopt;
 
         auto exportedFunctionsInfo = std::vector<ExportedFunction>{};
+        exportedFunctionsInfo.reserve( namePointerTable->size() );
 
-        for ( auto i = 0; i < exportDirectoryTableSoleEntry.numberOfNamePointerTableEntries; i++ )
+        for ( auto nameIdx = std::size_t{ 0 }; auto const exportedFunctionNameRVA : *namePointerTable )
         {
-            auto const exportedFunctionName =
-                std::string( reinterpret_cast<char const*>( hostSectionRawBytes +
-                                                            namePointerTable[i] -
-                                                            hostSectionHeader.sectionBaseAddressInMemory ) );
+            auto const exportedFunctionNameBytes =
+                sectionRVAResolver.getReaderAtRVA( exportedFunctionNameRVA );
+            auto exportedFunctionName =
+                exportedFunctionNameBytes ? exportedFunctionNameBytes->readNullTerminatedString( 0 ) : std::nullopt;
+
+            if ( not exportedFunctionName )
+            {
+                return std::nullopt;
+            }
+
+            auto exportedFunctionRVA = std::uint32_t{ 0 };
+            if ( ordinalTable and exportAddressTable )
+            {
+                auto const exportAddressTableIdx = ( *ordinalTable )[nameIdx];
+                if ( exportAddressTableIdx < exportAddressTable->size() )
+                {
+                    exportedFunctionRVA = ( *exportAddressTable )[exportAddressTableIdx];
+                }
+            }
 
             exportedFunctionsInfo.push_back( ExportedFunction
                                              {
-                                                .name = exportedFunctionName
+                                                .name = std::move( *exportedFunctionName ),
+                                                .rva = exportedFunctionRVA
                                              } );
+            nameIdx++;
         }
 
+        Instrumentation::addToCounter( Instrumentation::Counter::NamesDecoded, exportedFunctionsInfo.size() );
+        Instrumentation::addToCounter( Instrumentation::Counter::Allocations, exportedFunctionsInfo.size() + 1 );
+
         return exportedFunctionsInfo;
     }
 
     std::string
-    getMachineArchitectureName( unsigned short const machineArchitecture )
+    getSectionName( std::uint64_t const sectionNameAsNumber )
+    {
+        auto sectionName = std::string{};
+
+        // The first character is the lowest byte of the little-endian number.
+        for ( auto i = 0; i < 8; i++ )
+        {
+            auto const character = static_cast<char>( ( sectionNameAsNumber >> ( 8 * i ) ) & 0xFF );
+            if ( character == '\0' )
+            {
+                break;
+            }
+
+            sectionName += character;
+        }
+
+        return sectionName;
+    }
+
+    std::string
+    getMachineArchitectureName( std::uint16_t const machineArchitecture )
     {
         switch ( machineArchitecture )
         {
@@ -327,7 +484,7 @@ namespace PE
     }
 
     std::string
-    getPESignatureName( unsigned short const peSignature )
+    getPESignatureName( std::uint16_t const peSignature )
     {
         switch ( peSignature )
         {
@@ -343,7 +500,7 @@ namespace PE
     }
 
     std::string
-    getImageDataDirectoryDescription( unsigned long const dataDirectoryIndex )
+    getImageDataDirectoryDescription( std::uint32_t const dataDirectoryIndex )
     {
         switch ( dataDirectoryIndex )
         {
@@ -2,6 +2,9 @@
 #ifndef PEFORMAT_H
 #define PEFORMAT_H
 
+#include "ByteReader.h"
+
+#include <cstdint>
 #include <map>
 #include <optional>
 #include <string>
@@ -11,85 +14,191 @@ namespace PE
 {
     struct DOSHeader
     {
-        unsigned char    _unusedBytes[60];
-        unsigned long    offsetOfNTSignature;
+        std::uint8_t     _unusedBytes[60];
+        std::uint32_t    offsetOfNTSignature;
     };
 
     struct NTFileHeader
     {
-        unsigned short   targetMachineArchitecture;
-        unsigned short   numberOfSections;
-        unsigned char    _unusedBytes1[12];
-        unsigned short   sizeOfOptionalHeader;
-        unsigned char    _unusedBytes2[2];
+        std::uint16_t    targetMachineArchitecture;
+        std::uint16_t    numberOfSections;
+        std::uint32_t    timestamp;
+        std::uint32_t    pointerToSymbolTable;
+        std::uint32_t    numberOfSymbols;
+        std::uint16_t    sizeOfOptionalHeader;
+        std::uint16_t    fileCharacteristics;
     };
 
     struct NTOptionalHeader64
     {
-        unsigned short        peSignature;
-        unsigned char         linkerMajorVersion;
-        unsigned char         linkerMinorVersion;
-        unsigned long         sizeOfCodeInBytes;
-        unsigned long         sizeOfInitializedDataInBytes;
-        unsigned long         sizeOfUninitializedDataInBytes;
-        unsigned long         addressOfEntryPoint;
-        unsigned long         addressOfBaseOfCode;
-        unsigned long long    preferredBaseAddressOfImage;
-        unsigned char         _unusedBytes[76];
-        unsigned long         numberOfDataDirectories;
+        std::uint16_t    peSignature;
+        std::uint8_t     linkerMajorVersion;
+        std::uint8_t     linkerMinorVersion;
+        std::uint32_t    sizeOfCodeInBytes;
+        std::uint32_t    sizeOfInitializedDataInBytes;
+        std::uint32_t    sizeOfUninitializedDataInBytes;
+        std::uint32_t    addressOfEntryPoint;
+        std::uint32_t    addressOfBaseOfCode;
+        std::uint64_t    preferredBaseAddressOfImage;
+        std::uint32_t    sectionAlignmentInBytes;
+        std::uint32_t    fileAlignmentInBytes;
+        std::uint16_t    osMajorVersion;
+        std::uint16_t    osMinorVersion;
+        std::uint16_t    imageMajorVersion;
+        std::uint16_t    imageMinorVersion;
+        std::uint16_t    subsystemMajorVersion;
+        std::uint16_t    subsystemMinorVersion;
+        std::uint32_t    _win32VersionValue;
+        std::uint32_t    sizeOfImageInBytes;
+        std::uint32_t    sizeOfHeadersInBytes;
+        std::uint32_t    checksum;
+        std::uint16_t    subsystem;
+        std::uint16_t    dllCharacteristics;
+        std::uint64_t    sizeOfStackReserveInBytes;
+        std::uint64_t    sizeOfStackCommitInBytes;
+        std::uint64_t    sizeOfHeapReserveInBytes;
+        std::uint64_t    sizeOfHeapCommitInBytes;
+        std::uint32_t    _loaderFlags;
+        std::uint32_t    numberOfDataDirectories;
     };
 
     struct DataDirectoryEntry
     {
-        unsigned long    dataDirectoryRVA;
-        unsigned long    sizeInBytes;
+        std::uint32_t    dataDirectoryRVA;
+        std::uint32_t    sizeInBytes;
     };
 
     struct SectionHeader
     {
-        unsigned long long    sectionNameAsNumber;
-        unsigned long         sectionSizeInBytesInMemory;
-        unsigned long         sectionBaseAddressInMemory;
-        unsigned long         sizeOfRawDataInBytes;
-        unsigned long         pointerToRawData;
-        unsigned long         pointerToRelocations;
-        unsigned long         pointerToLineNumbers;
-        unsigned short        numberOfRelocations;
-        unsigned short        numberOfLineNumberEntries;
-        unsigned long         sectionCharacteristics;
+        std::uint64_t    sectionNameAsNumber;
+        std::uint32_t    sectionSizeInBytesInMemory;
+        std::uint32_t    sectionBaseAddressInMemory;
+        std::uint32_t    sizeOfRawDataInBytes;
+        std::uint32_t    pointerToRawData;
+        std::uint32_t    pointerToRelocations;
+        std::uint32_t    pointerToLineNumbers;
+        std::uint16_t    numberOfRelocations;
+        std::uint16_t    numberOfLineNumberEntries;
+        std::uint32_t    sectionCharacteristics;
+    };
+
+    struct ImportDirectoryTableEntry
+    {
+        std::uint32_t    importLookupTableRVA;
+        std::uint32_t    timestamp;
+        std::uint32_t    forwarderChainIdx;
+        std::uint32_t    namestringRVA;
+        std::uint32_t    importAddressTableRVA;
+    };
+
+    struct ExportDirectoryTableEntry
+    {
+        std::uint32_t    _reserved1;
+        std::uint32_t    timestamp;
+        std::uint16_t    dllMajorVersion;
+        std::uint16_t    dllMinorVersion;
+        std::uint32_t    namestringRVA;
+        std::uint32_t    baseOrdinalNumber;
+        std::uint32_t    numberOfExportAddressTableEntries;
+        std::uint32_t    numberOfNamePointerTableEntries;
+        std::uint32_t    exportAddressTableRVA;
+        std::uint32_t    namePointerTableRVA;
+        std::uint32_t    ordinalTableRVA;
+    };
+
+    // An entry of the exception directory (.pdata) of an x64 image: the
+    // extent of one function, or of one fragment of a function.
+    struct RuntimeFunction
+    {
+        std::uint32_t    beginRVA;
+        std::uint32_t    endRVA;
+        std::uint32_t    unwindInfoRVA;
     };
 
+    // The CLR header of a managed image (IMAGE_COR20_HEADER), which data
+    // directory 14 points at. The directories it holds are flattened into an
+    // RVA and a size each.
+    struct CLRHeader
+    {
+        std::uint32_t    sizeInBytes;
+        std::uint16_t    majorRuntimeVersion;
+        std::uint16_t    minorRuntimeVersion;
+        std::uint32_t    metadataRVA;
+        std::uint32_t    metadataSizeInBytes;
+        std::uint32_t    flags;
+        std::uint32_t    entryPointTokenOrRVA;
+        std::uint32_t    resourcesRVA;
+        std::uint32_t    resourcesSizeInBytes;
+        std::uint32_t    strongNameSignatureRVA;
+        std::uint32_t    strongNameSignatureSizeInBytes;
+        std::uint32_t    codeManagerTableRVA;
+        std::uint32_t    codeManagerTableSizeInBytes;
+        std::uint32_t    vTableFixupsRVA;
+        std::uint32_t    vTableFixupsSizeInBytes;
+        std::uint32_t    exportAddressTableJumpsRVA;
+        std::uint32_t    exportAddressTableJumpsSizeInBytes;
+        std::uint32_t    managedNativeHeaderRVA;
+        std::uint32_t    managedNativeHeaderSizeInBytes;
+    };
+
+    static_assert( sizeof( DOSHeader ) == 64 );
+    static_assert( sizeof( NTFileHeader ) == 20 );
+    static_assert( sizeof( NTOptionalHeader64 ) == 112 );
+    static_assert( sizeof( DataDirectoryEntry ) == 8 );
+    static_assert( sizeof( SectionHeader ) == 40 );
+    static_assert( sizeof( ImportDirectoryTableEntry ) == 20 );
+    static_assert( sizeof( ExportDirectoryTableEntry ) == 40 );
+    static_assert( sizeof( RuntimeFunction ) == 12 );
+    static_assert( sizeof( CLRHeader ) == 72 );
+
+    // An import by ordinal is named after the ordinal's known export, or
+    // "#<ordinal>" when the DLL's exports are not known.
+    struct ImportedFunction
+    {
+        std::string                     name;
+        std::uint32_t                   iatSlotRVA;
+        std::optional<std::uint16_t>    ordinal;
+    };
+
+    // The RVA is 0 when the ordinal or export address table is unreadable.
+    // For a forwarded export it points at the forwarder string inside the
+    // export directory rather than at code.
     struct ExportedFunction
     {
-        std::string    name;
+        std::string      name;
+        std::uint32_t    rva = 0;
     };
 
-    DOSHeader
-    extractDOSHeader( unsigned char const* rawBytesFromStartOfDOSHeader );
+    std::optional<DOSHeader>
+    extractDOSHeader( ByteReader const& rawBytesFromStartOfDOSHeader );
 
-    NTFileHeader
-    extractNTFileHeader( unsigned char const* rawBytesFromStartOfNTFileHeader );
+    std::optional<NTFileHeader>
+    extractNTFileHeader( ByteReader const& rawBytesFromStartOfNTFileHeader );
 
-    NTOptionalHeader64
-    extract64bitNTOptionalHeader( unsigned char const* rawBytesFromStartOfNTOptionalHeader );
+    std::optional<NTOptionalHeader64>
+    extract64bitNTOptionalHeader( ByteReader const& rawBytesFromStartOfNTOptionalHeader );
 
-    std::vector<DataDirectoryEntry>
-    extractDataDirectoryEntries( unsigned char const* rawBytesFromStartOfDataDirectories,
+    std::optional<std::vector<DataDirectoryEntry>>
+    extractDataDirectoryEntries( ByteReader const& rawBytesFromStartOfDataDirectories,
                                  NTOptionalHeader64 const& ntOptionalHeader );
 
-    std::map<std::string, SectionHeader>
-    extractSectionHeaders( unsigned char const* rawBytesFromStartOfSectionHeaders,
+    std::optional<std::map<std::string, SectionHeader>>
+    extractSectionHeaders( ByteReader const& rawBytesFromStartOfSectionHeaders,
                            int const numberOfSections );
 
-    std::map<std::string, std::vector<SectionHeader>>
-    extractSectionHeadersFromOBJFile( unsigned char const* rawBytesFromStartOfSectionHeaders,
+    std::optional<std::map<std::string, std::vector<SectionHeader>>>
+    extractSectionHeadersFromOBJFile( ByteReader const& rawBytesFromStartOfSectionHeaders,
                                       int const numberOfSections );
 
-    std::map<std::string, std::vector<unsigned char>>
-    extractRawSectionContents( unsigned char const* rawBytesFromStartOfFile,
+    std::optional<std::uint64_t>
+    convertRVAToFileOffset( std::map<std::string, SectionHeader> const& sectionHeaders,
+                            std::uint64_t const rvaOfInterest );
+
+    std::optional<std::map<std::string, std::vector<unsigned char>>>
+    extractRawSectionContents( ByteReader const& rawBytesFromStartOfFile,
                                std::map<std::string, SectionHeader> const& sectionHeaders );
 
-    std::optional<std::map<std::string, std::vector<std::string>>>
+    std::optional<std::map<std::string, std::vector<ImportedFunction>>>
     extractImportedFunctionsInfo( std::vector<DataDirectoryEntry> const& dataDirectoryEntries,
                                   std::map<std::string, SectionHeader> const& sectionHeaders,
                                   std::map<std::string, std::vector<unsigned char>> const& sectionRawData );
@@ -99,14 +208,18 @@ namespace PE
                                   std::map<std::string, SectionHeader> const& sectionHeaders,
                                   std::map<std::string, std::vector<unsigned char>> const& sectionRawData );
 
+    // Section names are up to eight bytes, null padded when shorter.
+    std::string
+    getSectionName( std::uint64_t const sectionNameAsNumber );
+
     std::string
-    getMachineArchitectureName( unsigned short const machineArchitecture );
+    getMachineArchitectureName( std::uint16_t const machineArchitecture );
 
     std::string
-    getPESignatureName( unsigned short const peSignature );
+    getPESignatureName( std::uint16_t const peSignature );
 
     std::string
-    getImageDataDirectoryDescription( unsigned long const dataDirectoryIndex );
+    getImageDataDirectoryDescription( std::uint32_t const dataDirectoryIndex );
 }
 
 #endif // PEFORMAT_H
\ No newline at end of file
@@ -0,0 +1,91 @@
+
+#ifndef PARALLELFOR_H
+#define PARALLELFOR_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Detail
+{
+    inline thread_local bool isInsideParallelFor = false;
+}
+
+// Runs workItem( i ) for every i in [0, numberOfWorkItems) on up to one thread
+// per hardware thread. Work items are handed out one at a time so that uneven
+// items balance themselves. The first exception thrown by any work item is
+// rethrown on the calling thread once all workers have stopped. A parallelFor
+// inside a work item runs serially, since the outer one already has every
+// hardware thread busy.
+template <typename WorkItemFunction>
+void
+parallelFor( std::size_t const numberOfWorkItems,
+             WorkItemFunction const& workItem )
+{
+    auto const numberOfWorkers =
+        std::min<std::size_t>( numberOfWorkItems, std::max( 1u, std::thread::hardware_concurrency() ) );
+
+    if ( numberOfWorkers <= 1 or Detail::isInsideParallelFor )
+    {
+        for ( auto i = std::size_t{ 0 }; i < numberOfWorkItems; i++ )
+        {
+            workItem( i );
+        }
+        return;
+    }
+
+    auto nextWorkItemIdx = std::atomic<std::size_t>{ 0 };
+    auto firstException = std::exception_ptr{};
+    auto firstExceptionMutex = std::mutex{};
+
+    auto const runWorker =
+        [&]()
+        {
+            Detail::isInsideParallelFor = true;
+
+            try
+            {
+                for ( auto i = nextWorkItemIdx++; i < numberOfWorkItems; i = nextWorkItemIdx++ )
+                {
+                    workItem( i );
+                }
+            }
+            catch ( ... )
+            {
+                auto const lock = std::scoped_lock{ firstExceptionMutex };
+                if ( not firstException )
+                {
+                    firstException = std::current_exception();
+                }
+                nextWorkItemIdx = numberOfWorkItems;
+            }
+
+            Detail::isInsideParallelFor = false;
+        };
+
+    auto workers = std::vector<std::thread>{};
+    workers.reserve( numberOfWorkers - 1 );
+
+    for ( auto i = std::size_t{ 1 }; i < numberOfWorkers; i++ )
+    {
+        workers.emplace_back( runWorker );
+    }
+
+    runWorker();
+
+    for ( auto& worker : workers )
+    {
+        worker.join();
+    }
+
+    if ( firstException )
+    {
+        std::rethrow_exception( firstException );
+    }
+}
+
+#endif // PARALLELFOR_H
\ No newline at end of file
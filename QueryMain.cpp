@@ -0,0 +1,240 @@
+
+#include "CorpusDatabase.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <iterator>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace
+{
+    struct NameFilter
+    {
+        CorpusNameKind    nameKind;
+        std::string       name;
+    };
+
+    // A name ending in '*' matches every name starting with the rest.
+    std::vector<std::uint32_t>
+    findFilesMatching( CorpusDatabase const& corpusDatabase,
+                       NameFilter const& nameFilter )
+    {
+        if ( not nameFilter.name.ends_with( '*' ) )
+        {
+            auto const nameId = corpusDatabase.findName( nameFilter.nameKind, nameFilter.name );
+            if ( not nameId )
+            {
+                return {};
+            }
+
+            auto const filesWithName = corpusDatabase.getFilesWithName( nameFilter.nameKind, *nameId );
+
+            return std::vector<std::uint32_t>( filesWithName.begin(), filesWithName.end() );
+        }
+
+        auto const [firstNameId, lastNameId] =
+            corpusDatabase.findNamesWithPrefix( nameFilter.nameKind,
+                                                std::string_view( nameFilter.name ).substr( 0, nameFilter.name.size() - 1 ) );
+
+        auto fileIndices = std::vector<std::uint32_t>{};
+        for ( auto nameId = firstNameId; nameId < lastNameId; nameId++ )
+        {
+            auto const filesWithName = corpusDatabase.getFilesWithName( nameFilter.nameKind, nameId );
+            fileIndices.insert( fileIndices.end(), filesWithName.begin(), filesWithName.end() );
+        }
+
+        std::sort( fileIndices.begin(), fileIndices.end() );
+        fileIndices.erase( std::unique( fileIndices.begin(), fileIndices.end() ), fileIndices.end() );
+
+        return fileIndices;
+    }
+
+    // Files matching every filter; the postings are ascending, so each
+    // filter narrows the result with a merge.
+    std::vector<std::uint32_t>
+    findFilesMatchingAll( CorpusDatabase const& corpusDatabase,
+                          std::vector<NameFilter> const& nameFilters )
+    {
+        auto fileIndices = findFilesMatching( corpusDatabase, nameFilters.front() );
+
+        for ( auto i = std::size_t{ 1 }; i < nameFilters.size() and not fileIndices.empty(); i++ )
+        {
+            auto const filesMatchingFilter = findFilesMatching( corpusDatabase, nameFilters[i] );
+
+            auto remainingFileIndices = std::vector<std::uint32_t>{};
+            std::set_intersection( fileIndices.begin(), fileIndices.end(),
+                                   filesMatchingFilter.begin(), filesMatchingFilter.end(),
+                                   std::back_inserter( remainingFileIndices ) );
+
+            fileIndices = std::move( remainingFileIndices );
+        }
+
+        return fileIndices;
+    }
+
+    void
+    printFile( CorpusDatabase const& corpusDatabase,
+               std::uint32_t const fileIdx )
+    {
+        std::printf( "%.*s\t%s\tbytes=%llu\tmachine=0x%04x\n",
+                     static_cast<int>( corpusDatabase.getPath( fileIdx ).size() ), corpusDatabase.getPath( fileIdx ).data(),
+                     corpusDatabase.isObjectFile( fileIdx ) ? "OBJ" : "EXE",
+                     static_cast<unsigned long long>( corpusDatabase.getFileSizeInBytes( fileIdx ) ),
+                     corpusDatabase.getTargetMachineArchitecture( fileIdx ) );
+
+        for ( auto kindIdx = std::size_t{ 0 }; kindIdx < numberOfCorpusNameKinds; kindIdx++ )
+        {
+            auto const nameKind = static_cast<CorpusNameKind>( kindIdx );
+
+            for ( auto const nameId : corpusDatabase.getNamesOfFile( nameKind, fileIdx ) )
+            {
+                auto const name = corpusDatabase.getName( nameKind, nameId );
+
+                std::printf( "    %s\t%.*s\n",
+                             getCorpusNameKindName( nameKind ).c_str(), static_cast<int>( name.size() ), name.data() );
+            }
+        }
+    }
+
+    // Lists the names of one kind starting with the prefix, with the number
+    // of files having each.
+    void
+    printNames( CorpusDatabase const& corpusDatabase,
+                CorpusNameKind const nameKind,
+                std::string const& prefix )
+    {
+        auto const [firstNameId, lastNameId] = corpusDatabase.findNamesWithPrefix( nameKind, prefix );
+
+        for ( auto nameId = firstNameId; nameId < lastNameId; nameId++ )
+        {
+            auto const name = corpusDatabase.getName( nameKind, nameId );
+
+            std::printf( "%.*s\tfiles=%zu\n",
+                         static_cast<int>( name.size() ), name.data(),
+                         corpusDatabase.getFilesWithName( nameKind, nameId ).size() );
+        }
+    }
+}
+
+int
+main( int argCount, char** args )
+{
+    auto pathOfDatabase = std::string{};
+    auto nameFilters = std::vector<NameFilter>{};
+    auto pathOfFileToShow = std::optional<std::string>{};
+    auto namesToList = std::optional<NameFilter>{};
+
+    try
+    {
+        for ( auto i = 1; i < argCount; i++ )
+        {
+            auto const argument = std::string( args[i] );
+
+            if (     ( argument == "--dll" or argument == "--import" or argument == "--export" or argument == "--section" )
+                 and i + 1 < argCount )
+            {
+                nameFilters.push_back( NameFilter
+                                       {
+                                           .nameKind = getCorpusNameKindFromName( argument.substr( 2 ) ),
+                                           .name = args[++i]
+                                       } );
+            }
+            else if ( argument == "--file" and i + 1 < argCount )
+            {
+                pathOfFileToShow = args[++i];
+            }
+            else if ( argument == "--list" and i + 1 < argCount )
+            {
+                namesToList = NameFilter{ .nameKind = getCorpusNameKindFromName( args[++i] ) };
+
+                if ( i + 1 < argCount and not std::string_view( args[i + 1] ).starts_with( "--" ) )
+                {
+                    namesToList->name = args[++i];
+                }
+            }
+            else if ( argument.starts_with( "--" ) or not pathOfDatabase.empty() )
+            {
+                throw std::invalid_argument{ "Unexpected argument '" + argument + "'." };
+            }
+            else
+            {
+                pathOfDatabase = argument;
+            }
+        }
+
+        if ( pathOfDatabase.empty() )
+        {
+            throw std::invalid_argument{ "A corpus database is required." };
+        }
+
+        auto const numberOfQueries =
+            ( nameFilters.empty() ? 0 : 1 ) + ( pathOfFileToShow ? 1 : 0 ) + ( namesToList ? 1 : 0 );
+        if ( numberOfQueries != 1 )
+        {
+            throw std::invalid_argument{ "Give name filters, --file or --list." };
+        }
+    }
+    catch ( std::exception const& argumentError )
+    {
+        std::cerr << "ewea-query: " << argumentError.what() << '\n'
+                  << "Usage: ewea-query CORPUS.db [--dll NAME] [--import NAME] [--export NAME] [--section NAME]...\n"
+                  << "       ewea-query CORPUS.db --file PATH\n"
+                  << "       ewea-query CORPUS.db --list dll|import|export|section [PREFIX]\n"
+                  << "A NAME ending in '*' matches every name with that prefix. Name filters are combined with AND.\n";
+        return 1;
+    }
+
+    try
+    {
+        auto const loadStart = std::chrono::steady_clock::now();
+        auto const corpusDatabase = CorpusDatabase::load( pathOfDatabase );
+        auto const queryStart = std::chrono::steady_clock::now();
+
+        auto numberOfResults = std::size_t{ 0 };
+
+        if ( pathOfFileToShow )
+        {
+            auto const fileIdx = corpusDatabase.findFile( *pathOfFileToShow );
+            if ( fileIdx )
+            {
+                printFile( corpusDatabase, *fileIdx );
+                numberOfResults = 1;
+            }
+        }
+        else if ( namesToList )
+        {
+            printNames( corpusDatabase, namesToList->nameKind, namesToList->name );
+        }
+        else
+        {
+            auto const fileIndices = findFilesMatchingAll( corpusDatabase, nameFilters );
+            for ( auto const fileIdx : fileIndices )
+            {
+                auto const path = corpusDatabase.getPath( fileIdx );
+                std::printf( "%.*s\n", static_cast<int>( path.size() ), path.data() );
+            }
+
+            numberOfResults = fileIndices.size();
+        }
+
+        auto const queryEnd = std::chrono::steady_clock::now();
+
+        std::fprintf( stderr, "ewea-query: %u files, loaded in %.3f ms, queried in %.3f ms\n",
+                      corpusDatabase.getNumberOfFiles(),
+                      std::chrono::duration<double, std::milli>( queryStart - loadStart ).count(),
+                      std::chrono::duration<double, std::milli>( queryEnd - queryStart ).count() );
+
+        return numberOfResults != 0 or namesToList ? 0 : 2;
+    }
+    catch ( std::runtime_error const& databaseError )
+    {
+        std::cerr << "ewea-query: " << databaseError.what() << '\n';
+        return 1;
+    }
+}
\ No newline at end of file
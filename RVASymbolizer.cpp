@@ -0,0 +1,263 @@
+
+#include "RVASymbolizer.h"
+
+#include "Instrumentation.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <limits>
+
+#if defined( __SSE2__ ) or defined( _M_X64 )
+#include <xmmintrin.h>
+#define EWEA_HAS_SSE2 1
+#endif
+
+namespace
+{
+    auto const exportTableIdx = 0;
+
+    // Enough searches in flight to cover the latency of a miss to memory.
+    auto const numberOfInterleavedSearches = std::size_t{ 8 };
+
+    // The descendants of slot k four levels down are slots 16k to 16k + 15,
+    // which is cache line k. Above the last four levels that line exists.
+    auto const numberOfLevelsPerCacheLine = std::uint32_t{ 4 };
+
+    struct SymbolCandidate
+    {
+        std::uint32_t           rva;
+        FunctionSymbolSource    source;
+        std::string_view        name;
+    };
+
+    void
+    prefetch( void const* address )
+    {
+#ifdef EWEA_HAS_SSE2
+        _mm_prefetch( static_cast<char const*>( address ), _MM_HINT_T0 );
+#else
+        static_cast<void>( address );
+#endif
+    }
+
+    // Visits the slots of the implicit tree in order, so the sorted RVAs land
+    // in Eytzinger order.
+    void
+    fillEytzingerSlots( std::uint32_t const slot,
+                        std::vector<std::uint32_t> const& sortedRVAs,
+                        std::uint32_t& nextSortedIdx,
+                        std::vector<std::uint32_t>& eytzingerRVAs,
+                        std::vector<std::uint32_t>& eytzingerSymbolIndices )
+    {
+        if ( slot >= eytzingerRVAs.size() )
+        {
+            return;
+        }
+
+        fillEytzingerSlots( 2 * slot, sortedRVAs, nextSortedIdx, eytzingerRVAs, eytzingerSymbolIndices );
+
+        auto const numberOfSymbols = static_cast<std::uint32_t>( sortedRVAs.size() );
+        auto const isPadding = nextSortedIdx >= numberOfSymbols;
+
+        eytzingerRVAs[slot] = isPadding ? std::numeric_limits<std::uint32_t>::max() : sortedRVAs[nextSortedIdx];
+        eytzingerSymbolIndices[slot] = std::min( nextSortedIdx, numberOfSymbols );
+        nextSortedIdx++;
+
+        fillEytzingerSlots( 2 * slot + 1, sortedRVAs, nextSortedIdx, eytzingerRVAs, eytzingerSymbolIndices );
+    }
+}
+
+RVASymbolizer::RVASymbolizer( EXEFile const& loadedEXEFile )
+: m_sizeOfImageInBytes( loadedEXEFile.ntOptionalHeader.sizeOfImageInBytes )
+{
+    auto const symbolizerTimer = Instrumentation::ScopedTimer{ "Build RVA symbolizer" };
+
+    auto symbolCandidates = std::vector<SymbolCandidate>{};
+
+    // A forwarded export points at its forwarder string inside the export
+    // directory, not at code of this image.
+    auto const& dataDirectoryEntries = loadedEXEFile.dataDirectoryEntries;
+    auto const exportDirectoryRVA =
+        dataDirectoryEntries.size() > exportTableIdx ? dataDirectoryEntries[exportTableIdx].dataDirectoryRVA : 0;
+    auto const exportDirectorySizeInBytes =
+        dataDirectoryEntries.size() > exportTableIdx ? dataDirectoryEntries[exportTableIdx].sizeInBytes : 0;
+
+    for ( auto const& exportedFunction : loadedEXEFile.exportedFunctions )
+    {
+        auto const isForwarded =
+            exportedFunction.rva >= exportDirectoryRVA and exportedFunction.rva - exportDirectoryRVA < exportDirectorySizeInBytes;
+
+        if ( exportedFunction.rva != 0 and not isForwarded )
+        {
+            symbolCandidates.push_back( SymbolCandidate
+                                        {
+                                            .rva = exportedFunction.rva,
+                                            .source = FunctionSymbolSource::Export,
+                                            .name = exportedFunction.name
+                                        } );
+        }
+    }
+
+    for ( auto const& runtimeFunction : getRuntimeFunctions( loadedEXEFile ) )
+    {
+        symbolCandidates.push_back( SymbolCandidate
+                                    {
+                                        .rva = runtimeFunction.beginRVA,
+                                        .source = FunctionSymbolSource::RuntimeFunction,
+                                        .name = {}
+                                    } );
+    }
+
+    // Exports sort before .pdata entries at the same RVA, and aliases of one
+    // export keep the first name.
+    std::stable_sort( symbolCandidates.begin(), symbolCandidates.end(),
+                      []( SymbolCandidate const& left, SymbolCandidate const& right )
+                      {
+                          return left.rva != right.rva ? left.rva < right.rva : left.source < right.source;
+                      } );
+
+    for ( auto const& symbolCandidate : symbolCandidates )
+    {
+        if ( not m_symbolRVAs.empty() and m_symbolRVAs.back() == symbolCandidate.rva )
+        {
+            continue;
+        }
+
+        m_symbolRVAs.push_back( symbolCandidate.rva );
+        m_symbolSources.push_back( symbolCandidate.source );
+        m_symbolNameCharacters += symbolCandidate.name;
+        m_symbolNameOffsets.push_back( static_cast<std::uint32_t>( m_symbolNameCharacters.size() ) );
+    }
+
+    m_numberOfLevels = static_cast<std::uint32_t>( std::bit_width( m_symbolRVAs.size() ) );
+
+    auto const numberOfSlots = std::size_t{ 1 } << m_numberOfLevels;
+    auto eytzingerRVAs = std::vector<std::uint32_t>( numberOfSlots );
+    m_eytzingerSymbolIndices.resize( numberOfSlots );
+
+    auto nextSortedIdx = std::uint32_t{ 0 };
+    fillEytzingerSlots( 1, m_symbolRVAs, nextSortedIdx, eytzingerRVAs, m_eytzingerSymbolIndices );
+    m_eytzingerSymbolIndices[0] = static_cast<std::uint32_t>( m_symbolRVAs.size() );
+
+    m_eytzingerRVALines.resize( ( numberOfSlots + 15 ) / 16 );
+    std::copy( eytzingerRVAs.begin(), eytzingerRVAs.end(), m_eytzingerRVALines.front().rvas );
+}
+
+std::uint32_t
+RVASymbolizer::findSymbol( std::uint32_t const rva ) const
+{
+    if ( rva >= m_sizeOfImageInBytes )
+    {
+        return unresolvedSymbolIdx;
+    }
+
+    auto const eytzingerRVAs = getEytzingerRVAs();
+
+    auto slot = std::uint32_t{ 1 };
+    auto level = std::uint32_t{ 0 };
+
+    for ( ; level + numberOfLevelsPerCacheLine < m_numberOfLevels; level++ )
+    {
+        prefetch( m_eytzingerRVALines.data() + slot );
+        slot = 2 * slot + ( eytzingerRVAs[slot] <= rva );
+    }
+
+    for ( ; level < m_numberOfLevels; level++ )
+    {
+        slot = 2 * slot + ( eytzingerRVAs[slot] <= rva );
+    }
+
+    return getSymbolIdxOfSlot( slot );
+}
+
+void
+RVASymbolizer::findSymbols( std::span<std::uint32_t const> const rvas,
+                            std::span<std::uint32_t> const symbolIndices ) const
+{
+    auto const eytzingerRVAs = getEytzingerRVAs();
+    auto const numberOfFullGroups = rvas.size() / numberOfInterleavedSearches;
+
+    for ( auto groupIdx = std::size_t{ 0 }; groupIdx < numberOfFullGroups; groupIdx++ )
+    {
+        auto const groupRVAs = rvas.subspan( groupIdx * numberOfInterleavedSearches, numberOfInterleavedSearches );
+
+        auto slots = std::array<std::uint32_t, numberOfInterleavedSearches>{};
+        slots.fill( 1 );
+
+        auto level = std::uint32_t{ 0 };
+
+        for ( ; level + numberOfLevelsPerCacheLine < m_numberOfLevels; level++ )
+        {
+            for ( auto i = std::size_t{ 0 }; i < numberOfInterleavedSearches; i++ )
+            {
+                prefetch( m_eytzingerRVALines.data() + slots[i] );
+                slots[i] = 2 * slots[i] + ( eytzingerRVAs[slots[i]] <= groupRVAs[i] );
+            }
+        }
+
+        for ( ; level < m_numberOfLevels; level++ )
+        {
+            for ( auto i = std::size_t{ 0 }; i < numberOfInterleavedSearches; i++ )
+            {
+                slots[i] = 2 * slots[i] + ( eytzingerRVAs[slots[i]] <= groupRVAs[i] );
+            }
+        }
+
+        for ( auto i = std::size_t{ 0 }; i < numberOfInterleavedSearches; i++ )
+        {
+            symbolIndices[groupIdx * numberOfInterleavedSearches + i] =
+                groupRVAs[i] < m_sizeOfImageInBytes ? getSymbolIdxOfSlot( slots[i] ) : unresolvedSymbolIdx;
+        }
+    }
+
+    for ( auto i = numberOfFullGroups * numberOfInterleavedSearches; i < rvas.size(); i++ )
+    {
+        symbolIndices[i] = findSymbol( rvas[i] );
+    }
+}
+
+std::uint32_t
+RVASymbolizer::getNumberOfSymbols() const
+{
+    return static_cast<std::uint32_t>( m_symbolRVAs.size() );
+}
+
+std::uint32_t
+RVASymbolizer::getSymbolRVA( std::uint32_t const symbolIdx ) const
+{
+    return m_symbolRVAs[symbolIdx];
+}
+
+std::string_view
+RVASymbolizer::getSymbolName( std::uint32_t const symbolIdx ) const
+{
+    return std::string_view( m_symbolNameCharacters ).substr( m_symbolNameOffsets[symbolIdx],
+                                                              m_symbolNameOffsets[symbolIdx + 1] - m_symbolNameOffsets[symbolIdx] );
+}
+
+FunctionSymbolSource
+RVASymbolizer::getSymbolSource( std::uint32_t const symbolIdx ) const
+{
+    return m_symbolSources[symbolIdx];
+}
+
+std::uint32_t const*
+RVASymbolizer::getEytzingerRVAs() const
+{
+    return reinterpret_cast<std::uint32_t const*>( m_eytzingerRVALines.data() );
+}
+
+// After the descent the slot has one bit per level below its leading one,
+// set where the search went right. Dropping the trailing right turns and the
+// left turn before them leaves the last node where it went left: the first
+// RVA above the one searched for, whose predecessor is the symbol. Slot 0
+// means the search never went left.
+std::uint32_t
+RVASymbolizer::getSymbolIdxOfSlot( std::uint32_t const eytzingerSlot ) const
+{
+    auto const upperBoundSlot = eytzingerSlot >> ( std::countr_one( eytzingerSlot ) + 1 );
+
+    // Wraps to unresolvedSymbolIdx when every symbol lies above the RVA.
+    return m_eytzingerSymbolIndices[upperBoundSlot] - 1;
+}
\ No newline at end of file
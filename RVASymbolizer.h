@@ -0,0 +1,94 @@
+
+#ifndef RVASYMBOLIZER_H
+#define RVASYMBOLIZER_H
+
+#include "PEFiles.h"
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+enum class FunctionSymbolSource : std::uint8_t
+{
+    Export,
+    RuntimeFunction
+};
+
+// Maps RVAs back to the nearest function start at or below them, taken from
+// the exports and the .pdata entries of one image; an export and a .pdata
+// entry at the same RVA are one symbol named after the export. Exports need
+// at least ParseDepth::Directories, .pdata needs ParseDepth::Full.
+//
+// The starts are searched in Eytzinger order: the sorted RVAs laid out as an
+// implicit binary tree, breadth first, padded to a full tree so that every
+// search descends the same number of levels without branching. The sixteen
+// descendants of a node four levels down share one cache line, which is
+// prefetched while those four levels are descended.
+class RVASymbolizer
+{
+public:
+    explicit RVASymbolizer( EXEFile const& loadedEXEFile );
+
+    static constexpr auto unresolvedSymbolIdx = ~std::uint32_t{ 0 };
+
+    // Returns unresolvedSymbolIdx when the RVA lies before the first symbol
+    // or outside of the image.
+    std::uint32_t
+    findSymbol( std::uint32_t const rva ) const;
+
+    // The same for many RVAs at once. Groups of searches descend the tree in
+    // lockstep, so that their cache misses overlap.
+    void
+    findSymbols( std::span<std::uint32_t const> const rvas,
+                 std::span<std::uint32_t> const symbolIndices ) const;
+
+    std::uint32_t
+    getNumberOfSymbols() const;
+
+    // Symbols are indexed in order of RVA.
+    std::uint32_t
+    getSymbolRVA( std::uint32_t const symbolIdx ) const;
+
+    // Empty for a .pdata function that is not exported.
+    std::string_view
+    getSymbolName( std::uint32_t const symbolIdx ) const;
+
+    FunctionSymbolSource
+    getSymbolSource( std::uint32_t const symbolIdx ) const;
+
+private:
+    struct alignas( 64 ) CacheLine
+    {
+        std::uint32_t    rvas[16];
+    };
+
+    static_assert( sizeof( CacheLine ) == 16 * sizeof( std::uint32_t ) );
+
+    // The lines as one array of slots.
+    std::uint32_t const*
+    getEytzingerRVAs() const;
+
+    std::uint32_t
+    getSymbolIdxOfSlot( std::uint32_t const eytzingerSlot ) const;
+
+private:
+    std::uint32_t                        m_sizeOfImageInBytes = 0;
+    std::uint32_t                        m_numberOfLevels = 0;
+
+    // Slot 0 is unused; padding slots hold the largest RVA.
+    std::vector<CacheLine>               m_eytzingerRVALines;
+
+    // The index of the symbol in each slot, or the number of symbols for
+    // padding and for slot 0, which is where a search for an RVA beyond
+    // every symbol ends.
+    std::vector<std::uint32_t>           m_eytzingerSymbolIndices;
+
+    std::vector<std::uint32_t>           m_symbolRVAs;
+    std::vector<FunctionSymbolSource>    m_symbolSources;
+    std::string                          m_symbolNameCharacters;
+    std::vector<std::uint32_t>           m_symbolNameOffsets{ 0 };
+};
+
+#endif // RVASYMBOLIZER_H
\ No newline at end of file
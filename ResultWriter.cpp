@@ -0,0 +1,487 @@
+
+#include "ResultWriter.h"
+
+#include <algorithm>
+#include <bit>
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+
+namespace
+{
+    auto const maximumDepth = 64;
+
+    auto const cborMajorTypeUnsigned = std::uint8_t{ 0 };
+    auto const cborMajorTypeNegative = std::uint8_t{ 1 };
+    auto const cborMajorTypeByteString = std::uint8_t{ 2 };
+    auto const cborMajorTypeTextString = std::uint8_t{ 3 };
+
+    auto const cborIndefiniteArray = std::uint8_t{ 0x9F };
+    auto const cborIndefiniteMap = std::uint8_t{ 0xBF };
+    auto const cborFalse = std::uint8_t{ 0xF4 };
+    auto const cborTrue = std::uint8_t{ 0xF5 };
+    auto const cborNull = std::uint8_t{ 0xF6 };
+    auto const cborDouble = std::uint8_t{ 0xFB };
+    auto const cborBreak = std::uint8_t{ 0xFF };
+
+    constexpr char base64Alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+    // Rejects overlong encodings, surrogates and code points past U+10FFFF,
+    // like any strict decoder would.
+    bool
+    isValidUTF8( std::string_view const text )
+    {
+        auto const* bytes = reinterpret_cast<unsigned char const*>( text.data() );
+        auto const size = text.size();
+        auto i = std::size_t{ 0 };
+
+        while ( i < size )
+        {
+            // Most names are plain ASCII, which is checked eight bytes at a
+            // time.
+            if ( i + 8 <= size )
+            {
+                auto word = std::uint64_t{ 0 };
+                std::memcpy( &word, bytes + i, 8 );
+                if ( ( word & 0x8080808080808080 ) == 0 )
+                {
+                    i += 8;
+                    continue;
+                }
+            }
+
+            auto const leadByte = bytes[i];
+            if ( leadByte < 0x80 )
+            {
+                i++;
+                continue;
+            }
+
+            auto numberOfContinuationBytes = 0;
+            auto lowestSecondByte = 0x80;
+            auto highestSecondByte = 0xBF;
+
+            if ( leadByte >= 0xC2 and leadByte <= 0xDF )
+            {
+                numberOfContinuationBytes = 1;
+            }
+            else if ( leadByte >= 0xE0 and leadByte <= 0xEF )
+            {
+                numberOfContinuationBytes = 2;
+                lowestSecondByte = leadByte == 0xE0 ? 0xA0 : 0x80;
+                highestSecondByte = leadByte == 0xED ? 0x9F : 0xBF;
+            }
+            else if ( leadByte >= 0xF0 and leadByte <= 0xF4 )
+            {
+                numberOfContinuationBytes = 3;
+                lowestSecondByte = leadByte == 0xF0 ? 0x90 : 0x80;
+                highestSecondByte = leadByte == 0xF4 ? 0x8F : 0xBF;
+            }
+            else
+            {
+                return false;
+            }
+
+            if ( size - i <= static_cast<std::size_t>( numberOfContinuationBytes )
+                 or bytes[i + 1] < lowestSecondByte or bytes[i + 1] > highestSecondByte )
+            {
+                return false;
+            }
+
+            for ( auto j = 2; j <= numberOfContinuationBytes; j++ )
+            {
+                if ( ( bytes[i + j] & 0xC0 ) != 0x80 )
+                {
+                    return false;
+                }
+            }
+
+            i += 1 + numberOfContinuationBytes;
+        }
+
+        return true;
+    }
+}
+
+ResultWriter::ResultWriter( std::FILE* const output,
+                            ResultFormat const resultFormat,
+                            std::size_t const bufferSizeInBytes )
+: m_output( output )
+, m_resultFormat( resultFormat )
+, m_bufferSizeInBytes( std::max<std::size_t>( bufferSizeInBytes, 64 ) )
+{
+    m_buffer.reserve( m_bufferSizeInBytes );
+}
+
+ResultWriter::~ResultWriter()
+{
+    try
+    {
+        flush();
+    }
+    catch ( std::runtime_error const& )
+    {
+    }
+}
+
+void
+ResultWriter::flush()
+{
+    if ( m_buffer.empty() )
+    {
+        return;
+    }
+
+    auto const numberOfWrittenBytes = std::fwrite( m_buffer.data(), 1, m_buffer.size(), m_output );
+    m_numberOfFlushedBytes += numberOfWrittenBytes;
+
+    auto const isWritten = numberOfWrittenBytes == m_buffer.size();
+    m_buffer.clear();
+
+    if ( not isWritten or std::fflush( m_output ) != 0 )
+    {
+        throw std::runtime_error{ "Failed to write results." };
+    }
+}
+
+void
+ResultWriter::append( std::string_view const bytes )
+{
+    if ( m_buffer.size() + bytes.size() > m_bufferSizeInBytes )
+    {
+        flush();
+
+        // Too large to ever be buffered, so written as it is.
+        if ( bytes.size() > m_bufferSizeInBytes )
+        {
+            auto const numberOfWrittenBytes = std::fwrite( bytes.data(), 1, bytes.size(), m_output );
+            m_numberOfFlushedBytes += numberOfWrittenBytes;
+
+            if ( numberOfWrittenBytes != bytes.size() )
+            {
+                throw std::runtime_error{ "Failed to write results." };
+            }
+
+            return;
+        }
+    }
+
+    m_buffer.insert( m_buffer.end(), bytes.begin(), bytes.end() );
+}
+
+void
+ResultWriter::beginValue()
+{
+    if ( m_resultFormat != ResultFormat::JSONLines )
+    {
+        return;
+    }
+
+    if ( m_isAfterKey )
+    {
+        m_isAfterKey = false;
+        return;
+    }
+
+    if ( m_depth == 0 )
+    {
+        return;
+    }
+
+    auto const containerBit = std::uint64_t{ 1 } << ( m_depth - 1 );
+    if ( ( m_containerHasValueBits & containerBit ) != 0 )
+    {
+        append( ',' );
+    }
+
+    m_containerHasValueBits |= containerBit;
+}
+
+void
+ResultWriter::beginContainer( std::uint8_t const cborInitialByte,
+                              char const jsonOpeningCharacter )
+{
+    if ( m_depth == maximumDepth )
+    {
+        throw std::logic_error{ "Results are nested too deeply." };
+    }
+
+    beginValue();
+    append( m_resultFormat == ResultFormat::CBOR ? static_cast<char>( cborInitialByte ) : jsonOpeningCharacter );
+
+    m_depth++;
+    m_containerHasValueBits &= ~( std::uint64_t{ 1 } << ( m_depth - 1 ) );
+}
+
+void
+ResultWriter::endContainer( char const jsonClosingCharacter )
+{
+    m_depth--;
+    append( m_resultFormat == ResultFormat::CBOR ? static_cast<char>( cborBreak ) : jsonClosingCharacter );
+}
+
+void
+ResultWriter::beginObject()
+{
+    beginContainer( cborIndefiniteMap, '{' );
+}
+
+void
+ResultWriter::endObject()
+{
+    endContainer( '}' );
+}
+
+void
+ResultWriter::beginArray()
+{
+    beginContainer( cborIndefiniteArray, '[' );
+}
+
+void
+ResultWriter::endArray()
+{
+    endContainer( ']' );
+}
+
+void
+ResultWriter::writeKey( std::string_view const key )
+{
+    if ( m_resultFormat == ResultFormat::CBOR )
+    {
+        writeString( key );
+        return;
+    }
+
+    beginValue();
+    writeJSONString( key );
+
+    append( ':' );
+    m_isAfterKey = true;
+}
+
+void
+ResultWriter::writeCBORHead( std::uint8_t const majorType,
+                             std::uint64_t const argument )
+{
+    auto const majorTypeBits = static_cast<std::uint8_t>( majorType << 5 );
+
+    if ( argument < 24 )
+    {
+        append( static_cast<char>( majorTypeBits | argument ) );
+        return;
+    }
+
+    auto const numberOfArgumentBytes = argument <= 0xFF ? 1 : argument <= 0xFFFF ? 2 : argument <= 0xFFFFFFFF ? 4 : 8;
+    auto const additionalInformation = numberOfArgumentBytes == 1 ? 24 : numberOfArgumentBytes == 2 ? 25 : numberOfArgumentBytes == 4 ? 26 : 27;
+
+    char head[9];
+    head[0] = static_cast<char>( majorTypeBits | additionalInformation );
+    for ( auto i = 0; i < numberOfArgumentBytes; i++ )
+    {
+        head[1 + i] = static_cast<char>( argument >> ( 8 * ( numberOfArgumentBytes - 1 - i ) ) );
+    }
+
+    append( std::string_view( head, 1 + numberOfArgumentBytes ) );
+}
+
+void
+ResultWriter::writeUnsigned( std::uint64_t const value )
+{
+    beginValue();
+
+    if ( m_resultFormat == ResultFormat::CBOR )
+    {
+        writeCBORHead( cborMajorTypeUnsigned, value );
+        return;
+    }
+
+    char digits[20];
+    auto const digitsEnd = std::to_chars( digits, digits + sizeof( digits ), value ).ptr;
+    append( std::string_view( digits, digitsEnd - digits ) );
+}
+
+void
+ResultWriter::writeSigned( std::int64_t const value )
+{
+    if ( value >= 0 )
+    {
+        writeUnsigned( static_cast<std::uint64_t>( value ) );
+        return;
+    }
+
+    beginValue();
+
+    if ( m_resultFormat == ResultFormat::CBOR )
+    {
+        // -1 - value, computed without overflowing for the smallest value.
+        writeCBORHead( cborMajorTypeNegative, ~static_cast<std::uint64_t>( value ) );
+        return;
+    }
+
+    char digits[21];
+    auto const digitsEnd = std::to_chars( digits, digits + sizeof( digits ), value ).ptr;
+    append( std::string_view( digits, digitsEnd - digits ) );
+}
+
+void
+ResultWriter::writeBoolean( bool const value )
+{
+    beginValue();
+
+    if ( m_resultFormat == ResultFormat::CBOR )
+    {
+        append( static_cast<char>( value ? cborTrue : cborFalse ) );
+        return;
+    }
+
+    append( value ? std::string_view( "true" ) : std::string_view( "false" ) );
+}
+
+void
+ResultWriter::writeDouble( double const value )
+{
+    beginValue();
+
+    if ( m_resultFormat == ResultFormat::CBOR )
+    {
+        auto const bits = std::bit_cast<std::uint64_t>( value );
+
+        char encodedValue[9];
+        encodedValue[0] = static_cast<char>( cborDouble );
+        for ( auto i = 0; i < 8; i++ )
+        {
+            encodedValue[1 + i] = static_cast<char>( bits >> ( 8 * ( 7 - i ) ) );
+        }
+
+        append( std::string_view( encodedValue, sizeof( encodedValue ) ) );
+        return;
+    }
+
+    if ( not std::isfinite( value ) )
+    {
+        append( "null" );
+        return;
+    }
+
+    char digits[32];
+    auto const digitsEnd = std::to_chars( digits, digits + sizeof( digits ), value ).ptr;
+    append( std::string_view( digits, digitsEnd - digits ) );
+}
+
+void
+ResultWriter::writeNull()
+{
+    beginValue();
+
+    if ( m_resultFormat == ResultFormat::CBOR )
+    {
+        append( static_cast<char>( cborNull ) );
+        return;
+    }
+
+    append( "null" );
+}
+
+void
+ResultWriter::writeString( std::string_view const value )
+{
+    beginValue();
+
+    auto const isText = isValidUTF8( value );
+
+    if ( m_resultFormat == ResultFormat::CBOR )
+    {
+        writeCBORHead( isText ? cborMajorTypeTextString : cborMajorTypeByteString, value.size() );
+        append( value );
+        return;
+    }
+
+    if ( isText )
+    {
+        writeJSONString( value );
+        return;
+    }
+
+    // JSON has no byte strings, so the bytes go base64 encoded into an
+    // object of their own, which no text string can be mistaken for.
+    append( "{\"base64\":\"" );
+
+    for ( auto i = std::size_t{ 0 }; i < value.size(); i += 3 )
+    {
+        auto const numberOfBytes = std::min<std::size_t>( 3, value.size() - i );
+
+        auto triple = std::uint32_t{ 0 };
+        for ( auto j = std::size_t{ 0 }; j < 3; j++ )
+        {
+            triple = ( triple << 8 ) | ( j < numberOfBytes ? static_cast<unsigned char>( value[i + j] ) : 0u );
+        }
+
+        char encodedTriple[4];
+        for ( auto j = std::size_t{ 0 }; j < 4; j++ )
+        {
+            encodedTriple[j] = j <= numberOfBytes ? base64Alphabet[( triple >> ( 18 - 6 * j ) ) & 0x3F] : '=';
+        }
+
+        append( std::string_view( encodedTriple, 4 ) );
+    }
+
+    append( "\"}" );
+}
+
+void
+ResultWriter::writeJSONString( std::string_view const value )
+{
+    // Bytes of 0x80 and up only need escaping when the string is not valid
+    // UTF-8, which only keys can be.
+    auto const firstEscapedByte = isValidUTF8( value ) ? 0x100u : 0x80u;
+
+    append( '"' );
+
+    auto runStart = std::size_t{ 0 };
+    for ( auto i = std::size_t{ 0 }; i < value.size(); i++ )
+    {
+        auto const byte = static_cast<unsigned char>( value[i] );
+        if ( byte >= 0x20 and byte != '"' and byte != '\\' and byte < firstEscapedByte )
+        {
+            continue;
+        }
+
+        append( value.substr( runStart, i - runStart ) );
+        runStart = i + 1;
+
+        switch ( byte )
+        {
+            case '"':   append( "\\\"" ); break;
+            case '\\':  append( "\\\\" ); break;
+            case '\n':  append( "\\n" ); break;
+            case '\r':  append( "\\r" ); break;
+            case '\t':  append( "\\t" ); break;
+            default:
+            {
+                char escapedByte[7];
+                std::snprintf( escapedByte, sizeof( escapedByte ), "\\u%04x", byte );
+                append( std::string_view( escapedByte, 6 ) );
+                break;
+            }
+        }
+    }
+
+    append( value.substr( runStart ) );
+    append( '"' );
+}
+
+void
+ResultWriter::endRecord()
+{
+    if ( m_resultFormat == ResultFormat::JSONLines )
+    {
+        append( '\n' );
+    }
+
+    m_containerHasValueBits = 0;
+    m_depth = 0;
+    m_isAfterKey = false;
+}
\ No newline at end of file
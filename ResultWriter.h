@@ -0,0 +1,166 @@
+
+#ifndef RESULTWRITER_H
+#define RESULTWRITER_H
+
+#include "PEFieldDescriptors.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+enum class ResultFormat : std::uint8_t
+{
+    JSONLines,
+    CBOR
+};
+
+// Written as the "schema" member of every record. Bumped when a member is
+// removed or changes meaning; adding members leaves it as it is.
+//
+// 2: strings that are not valid UTF-8 are {"base64": ...} objects in JSON.
+auto const resultSchemaVersion = std::uint32_t{ 2 };
+
+// Encodes values as they are pushed, straight into a fixed-size buffer that
+// is written out whenever it fills up, so neither a document tree nor a
+// string per value is ever built. Each record is one top-level value: a line
+// of JSON, or one item of a CBOR sequence (RFC 8742) using indefinite-length
+// maps and arrays.
+//
+// Strings that are not valid UTF-8, e.g. names read from a damaged image, are
+// still written losslessly and apart from text: in CBOR as byte strings, and
+// in JSON, which has no byte strings, as an object with the base64 encoded
+// bytes as its "base64" member. Keys are expected to be valid UTF-8; in JSON,
+// the bytes of one that is not are written as \u00XX escapes, which maps
+// them to different characters.
+class ResultWriter
+{
+public:
+    ResultWriter( std::FILE* const output,
+                  ResultFormat const resultFormat,
+                  std::size_t const bufferSizeInBytes = std::size_t{ 1 } << 16 );
+
+    // Writes out what is still buffered; call flush() first to see errors.
+    ~ResultWriter();
+
+    ResultWriter( ResultWriter const& ) = delete;
+    ResultWriter& operator=( ResultWriter const& ) = delete;
+
+    void
+    beginObject();
+
+    void
+    endObject();
+
+    void
+    beginArray();
+
+    void
+    endArray();
+
+    // Names the next value of the object being written.
+    void
+    writeKey( std::string_view const key );
+
+    void
+    writeUnsigned( std::uint64_t const value );
+
+    void
+    writeSigned( std::int64_t const value );
+
+    void
+    writeBoolean( bool const value );
+
+    // NaN and infinities are written as null in JSON.
+    void
+    writeDouble( double const value );
+
+    void
+    writeString( std::string_view const value );
+
+    void
+    writeNull();
+
+    // Ends a top-level value.
+    void
+    endRecord();
+
+    // Throws std::runtime_error when the output cannot be written.
+    void
+    flush();
+
+    std::uint64_t
+    getNumberOfBytesWritten() const
+    {
+        return m_numberOfFlushedBytes + m_buffer.size();
+    }
+
+private:
+    void
+    beginValue();
+
+    void
+    beginContainer( std::uint8_t const cborInitialByte,
+                    char const jsonOpeningCharacter );
+
+    void
+    endContainer( char const jsonClosingCharacter );
+
+    void
+    writeCBORHead( std::uint8_t const majorType,
+                   std::uint64_t const argument );
+
+    void
+    writeJSONString( std::string_view const value );
+
+    void
+    append( char const character )
+    {
+        if ( m_buffer.size() == m_bufferSizeInBytes )
+        {
+            flush();
+        }
+
+        m_buffer.push_back( character );
+    }
+
+    void
+    append( std::string_view const bytes );
+
+private:
+    std::FILE*           m_output;
+    ResultFormat         m_resultFormat;
+    std::size_t          m_bufferSizeInBytes;
+    std::vector<char>    m_buffer;
+    std::uint64_t        m_numberOfFlushedBytes = 0;
+
+    // One bit per open container, set once it holds a value, which is all
+    // JSON needs to place its commas.
+    std::uint64_t        m_containerHasValueBits = 0;
+    int                  m_depth = 0;
+    bool                 m_isAfterKey = false;
+};
+
+// Writes the fields of a header as an object of its raw values, named as in
+// the field table.
+template <typename Header, typename... Fields>
+void
+writeHeaderFields( ResultWriter& resultWriter,
+                   Header const& header,
+                   std::tuple<Fields...> const& fields )
+{
+    resultWriter.beginObject();
+
+    std::apply( [&]( auto const&... field )
+                {
+                    ( ( resultWriter.writeKey( field.name ),
+                        resultWriter.writeUnsigned( header.*std::decay_t<decltype( field )>::member ) ), ... );
+                },
+                fields );
+
+    resultWriter.endObject();
+}
+
+#endif // RESULTWRITER_H
\ No newline at end of file
@@ -0,0 +1,268 @@
+
+#include "RichHeader.h"
+
+#include <algorithm>
+#include <bit>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+
+namespace
+{
+    auto const richSignature = std::uint32_t{ 0x68636952 };    // "Rich"
+    auto const dansSignature = std::uint32_t{ 0x536E6144 };    // "DanS"
+
+    // "DanS" is followed by three masked zero words before the entries.
+    auto const numberOfPaddingWords = std::size_t{ 3 };
+
+    auto const offsetOfNTSignatureField = std::size_t{ 0x3C };
+
+    auto const indexMagic = std::uint64_t{ 0x3149435441455745 };    // "EWEATCI1"
+
+    std::uint32_t
+    getToolId( RichHeaderEntry const& richHeaderEntry )
+    {
+        return std::uint32_t{ richHeaderEntry.productId } << 16 | richHeaderEntry.buildNumber;
+    }
+
+    std::uint32_t
+    computeRichHeaderChecksum( PE::ByteReader const& rawBytesFromStartOfFile,
+                               std::uint32_t const dansOffset,
+                               std::vector<RichHeaderEntry> const& entries )
+    {
+        auto checksum = dansOffset;
+
+        // The offset of the NT headers is filled in after the Rich header and
+        // so is left out.
+        for ( auto i = std::uint32_t{ 0 }; i < dansOffset; i++ )
+        {
+            if ( i >= offsetOfNTSignatureField and i < offsetOfNTSignatureField + sizeof( std::uint32_t ) )
+            {
+                continue;
+            }
+
+            checksum += std::rotl( std::uint32_t{ rawBytesFromStartOfFile.data()[i] }, static_cast<int>( i % 32 ) );
+        }
+
+        for ( auto const& entry : entries )
+        {
+            checksum += std::rotl( getToolId( entry ), static_cast<int>( entry.count % 32 ) );
+        }
+
+        return checksum;
+    }
+
+    template <typename T>
+    void
+    writeValue( std::ostream& indexOutput,
+                T const value )
+    {
+        indexOutput.write( reinterpret_cast<char const*>( &value ), sizeof( value ) );
+    }
+
+    template <typename T>
+    T
+    readValue( std::istream& indexInput )
+    {
+        auto value = T{};
+        if ( not indexInput.read( reinterpret_cast<char*>( &value ), sizeof( value ) ) )
+        {
+            throw std::runtime_error{ "Toolchain index is truncated." };
+        }
+
+        return value;
+    }
+}
+
+std::optional<RichHeader>
+extractRichHeader( PE::ByteReader const& rawBytesFromStartOfFile,
+                   PE::DOSHeader const& dosHeader )
+{
+    auto const stubEnd = std::min<std::size_t>( dosHeader.offsetOfNTSignature, rawBytesFromStartOfFile.size() );
+
+    // The header is word aligned and ends with "Rich" and the XOR key.
+    auto richOffset = std::optional<std::size_t>{};
+    for ( auto offset = sizeof( PE::DOSHeader ); offset + 2 * sizeof( std::uint32_t ) <= stubEnd; offset += sizeof( std::uint32_t ) )
+    {
+        if ( rawBytesFromStartOfFile.read<std::uint32_t>( offset ) == richSignature )
+        {
+            richOffset = offset;
+            break;
+        }
+    }
+
+    if ( not richOffset )
+    {
+        return std::nullopt;
+    }
+
+    auto const xorKey = *rawBytesFromStartOfFile.read<std::uint32_t>( *richOffset + sizeof( std::uint32_t ) );
+
+    auto dansOffset = std::optional<std::size_t>{};
+    for ( auto offset = *richOffset; offset >= sizeof( PE::DOSHeader ) + sizeof( std::uint32_t ); )
+    {
+        offset -= sizeof( std::uint32_t );
+
+        if ( ( *rawBytesFromStartOfFile.read<std::uint32_t>( offset ) ^ xorKey ) == dansSignature )
+        {
+            dansOffset = offset;
+            break;
+        }
+    }
+
+    auto const entriesOffset = dansOffset ? *dansOffset + ( 1 + numberOfPaddingWords ) * sizeof( std::uint32_t ) : 0;
+
+    if ( not dansOffset or entriesOffset > *richOffset or ( *richOffset - entriesOffset ) % ( 2 * sizeof( std::uint32_t ) ) != 0 )
+    {
+        return std::nullopt;
+    }
+
+    auto richHeader = RichHeader
+    {
+        .fileOffset = static_cast<std::uint32_t>( *dansOffset ),
+        .sizeInBytes = static_cast<std::uint32_t>( *richOffset + 2 * sizeof( std::uint32_t ) - *dansOffset ),
+        .xorKey = xorKey,
+        .computedChecksum = 0
+    };
+
+    for ( auto offset = entriesOffset; offset < *richOffset; offset += 2 * sizeof( std::uint32_t ) )
+    {
+        auto const toolId = *rawBytesFromStartOfFile.read<std::uint32_t>( offset ) ^ xorKey;
+        auto const count = *rawBytesFromStartOfFile.read<std::uint32_t>( offset + sizeof( std::uint32_t ) ) ^ xorKey;
+
+        richHeader.entries.push_back( RichHeaderEntry
+                                      {
+                                          .productId = static_cast<std::uint16_t>( toolId >> 16 ),
+                                          .buildNumber = static_cast<std::uint16_t>( toolId ),
+                                          .count = count
+                                      } );
+    }
+
+    richHeader.computedChecksum =
+        computeRichHeaderChecksum( rawBytesFromStartOfFile, richHeader.fileOffset, richHeader.entries );
+
+    return richHeader;
+}
+
+void
+ToolchainIndex::addFile( std::string const& pathOfFile,
+                         RichHeader const& richHeader )
+{
+    auto const fileIdx = static_cast<std::uint32_t>( m_paths.size() );
+    m_paths.push_back( pathOfFile );
+
+    for ( auto const& entry : richHeader.entries )
+    {
+        auto& toolchainGroup = m_toolIdToGroup[getToolId( entry )];
+        toolchainGroup.tool = RichHeaderEntry{ .productId = entry.productId, .buildNumber = entry.buildNumber, .count = 0 };
+        toolchainGroup.numberOfObjects += entry.count;
+
+        // A tool may be listed twice in one header; the file counts once.
+        if ( toolchainGroup.fileIndices.empty() or toolchainGroup.fileIndices.back() != fileIdx )
+        {
+            toolchainGroup.fileIndices.push_back( fileIdx );
+        }
+    }
+}
+
+std::vector<std::string> const&
+ToolchainIndex::getPaths() const
+{
+    return m_paths;
+}
+
+std::vector<ToolchainGroup>
+ToolchainIndex::getGroups() const
+{
+    auto toolchainGroups = std::vector<ToolchainGroup>{};
+    toolchainGroups.reserve( m_toolIdToGroup.size() );
+
+    for ( auto const& [toolId, toolchainGroup] : m_toolIdToGroup )
+    {
+        toolchainGroups.push_back( toolchainGroup );
+    }
+
+    return toolchainGroups;
+}
+
+void
+ToolchainIndex::write( std::ostream& indexOutput ) const
+{
+    writeValue( indexOutput, indexMagic );
+
+    writeValue( indexOutput, static_cast<std::uint32_t>( m_paths.size() ) );
+    for ( auto const& path : m_paths )
+    {
+        writeValue( indexOutput, static_cast<std::uint32_t>( path.size() ) );
+        indexOutput.write( path.data(), static_cast<std::streamsize>( path.size() ) );
+    }
+
+    writeValue( indexOutput, static_cast<std::uint32_t>( m_toolIdToGroup.size() ) );
+    for ( auto const& [toolId, toolchainGroup] : m_toolIdToGroup )
+    {
+        writeValue( indexOutput, toolId );
+        writeValue( indexOutput, toolchainGroup.numberOfObjects );
+        writeValue( indexOutput, static_cast<std::uint32_t>( toolchainGroup.fileIndices.size() ) );
+        indexOutput.write( reinterpret_cast<char const*>( toolchainGroup.fileIndices.data() ),
+                           static_cast<std::streamsize>( toolchainGroup.fileIndices.size() * sizeof( std::uint32_t ) ) );
+    }
+
+    if ( not indexOutput )
+    {
+        throw std::runtime_error{ "Failed to write the toolchain index." };
+    }
+}
+
+ToolchainIndex
+ToolchainIndex::read( std::istream& indexInput )
+{
+    if ( readValue<std::uint64_t>( indexInput ) != indexMagic )
+    {
+        throw std::runtime_error{ "Not a toolchain index." };
+    }
+
+    auto toolchainIndex = ToolchainIndex{};
+
+    auto const numberOfPaths = readValue<std::uint32_t>( indexInput );
+    for ( auto i = std::uint32_t{ 0 }; i < numberOfPaths; i++ )
+    {
+        auto path = std::string( readValue<std::uint32_t>( indexInput ), '\0' );
+        if ( not indexInput.read( path.data(), static_cast<std::streamsize>( path.size() ) ) )
+        {
+            throw std::runtime_error{ "Toolchain index is truncated." };
+        }
+
+        toolchainIndex.m_paths.push_back( std::move( path ) );
+    }
+
+    auto const numberOfGroups = readValue<std::uint32_t>( indexInput );
+    for ( auto i = std::uint32_t{ 0 }; i < numberOfGroups; i++ )
+    {
+        auto const toolId = readValue<std::uint32_t>( indexInput );
+        auto& toolchainGroup = toolchainIndex.m_toolIdToGroup[toolId];
+
+        toolchainGroup.tool = RichHeaderEntry
+        {
+            .productId = static_cast<std::uint16_t>( toolId >> 16 ),
+            .buildNumber = static_cast<std::uint16_t>( toolId ),
+            .count = 0
+        };
+        toolchainGroup.numberOfObjects = readValue<std::uint64_t>( indexInput );
+
+        auto const numberOfFiles = readValue<std::uint32_t>( indexInput );
+        toolchainGroup.fileIndices.reserve( std::min( numberOfFiles, numberOfPaths ) );
+
+        for ( auto j = std::uint32_t{ 0 }; j < numberOfFiles; j++ )
+        {
+            auto const fileIdx = readValue<std::uint32_t>( indexInput );
+            if ( fileIdx >= numberOfPaths )
+            {
+                throw std::runtime_error{ "Toolchain index refers to a file it does not list." };
+            }
+
+            toolchainGroup.fileIndices.push_back( fileIdx );
+        }
+    }
+
+    return toolchainIndex;
+}
\ No newline at end of file
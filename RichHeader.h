@@ -0,0 +1,86 @@
+
+#ifndef RICHHEADER_H
+#define RICHHEADER_H
+
+#include "ByteReader.h"
+#include "PEFormat.h"
+
+#include <cstdint>
+#include <iosfwd>
+#include <map>
+#include <optional>
+#include <string>
+#include <vector>
+
+// One line of the Rich header: how many objects a tool of the given product
+// ID and build number contributed to the image.
+struct RichHeaderEntry
+{
+    std::uint16_t    productId;
+    std::uint16_t    buildNumber;
+    std::uint32_t    count;
+};
+
+// The linker hides the Rich header in the DOS stub, between the DOS header
+// and the NT headers, XOR-masked with a checksum of the DOS header and of
+// the entries themselves. A valid checksum means the header was not edited
+// since linking.
+struct RichHeader
+{
+    std::uint32_t                   fileOffset;
+    std::uint32_t                   sizeInBytes;
+    std::uint32_t                   xorKey;
+    std::uint32_t                   computedChecksum;
+    std::vector<RichHeaderEntry>    entries;
+
+    bool
+    isChecksumValid() const
+    {
+        return computedChecksum == xorKey;
+    }
+};
+
+// Returns nothing when the stub holds no Rich header, e.g. for images not
+// linked by Microsoft's linker.
+std::optional<RichHeader>
+extractRichHeader( PE::ByteReader const& rawBytesFromStartOfFile,
+                   PE::DOSHeader const& dosHeader );
+
+struct ToolchainGroup
+{
+    RichHeaderEntry                 tool;
+    std::uint64_t                   numberOfObjects = 0;
+    std::vector<std::uint32_t>      fileIndices;
+};
+
+// Groups a corpus by (product ID, build number): for each tool, the objects
+// it contributed across the corpus and the ascending indices of the files
+// it appears in. Saved to disk, it answers toolchain questions about the
+// corpus without reading the files again.
+class ToolchainIndex
+{
+public:
+    void
+    addFile( std::string const& pathOfFile,
+             RichHeader const& richHeader );
+
+    std::vector<std::string> const&
+    getPaths() const;
+
+    std::vector<ToolchainGroup>
+    getGroups() const;
+
+    // Throws std::runtime_error when the stream fails.
+    void
+    write( std::ostream& indexOutput ) const;
+
+    // Throws std::runtime_error when the stream is not an index.
+    static ToolchainIndex
+    read( std::istream& indexInput );
+
+private:
+    std::vector<std::string>                      m_paths;
+    std::map<std::uint32_t, ToolchainGroup>       m_toolIdToGroup;
+};
+
+#endif // RICHHEADER_H
\ No newline at end of file
@@ -0,0 +1,424 @@
+
+#include "ImageQueries.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <semaphore>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#ifndef _WIN32
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#endif
+
+#ifndef _WIN32
+namespace
+{
+    // A request names a few paths and RVAs; anything longer is not one, and
+    // buffering it would let a client grow the server without bound.
+    auto const maximumRequestLengthInBytes = std::size_t{ 64 } * 1024;
+
+    // Each connection has a thread of its own. Past this many, the listening
+    // socket's backlog holds new connections until one closes.
+    auto const maximumNumberOfConnections = std::ptrdiff_t{ 64 };
+
+    // Requests and responses are newline terminated lines. A response is
+    // "ok N" followed by the N lines of the result, or a single "error MSG".
+    class LineSocket
+    {
+    public:
+        explicit LineSocket( int const socketDescriptor,
+                             std::size_t const maximumLineLengthInBytes = std::numeric_limits<std::size_t>::max() )
+        : m_socketDescriptor( socketDescriptor )
+        , m_maximumLineLengthInBytes( maximumLineLengthInBytes )
+        {
+        }
+
+        ~LineSocket()
+        {
+            ::close( m_socketDescriptor );
+        }
+
+        LineSocket( LineSocket const& ) = delete;
+        LineSocket& operator=( LineSocket const& ) = delete;
+
+        int
+        getDescriptor() const
+        {
+            return m_socketDescriptor;
+        }
+
+        // Returns false once the peer has closed the connection, and throws
+        // std::length_error for a line longer than the maximum.
+        bool
+        readLine( std::string& line )
+        {
+            while ( true )
+            {
+                auto const lineEnd = m_receivedBytes.find( '\n', m_readOffset );
+                if ( lineEnd != std::string::npos and lineEnd - m_readOffset <= m_maximumLineLengthInBytes )
+                {
+                    line.assign( m_receivedBytes, m_readOffset, lineEnd - m_readOffset );
+                    m_readOffset = lineEnd + 1;
+                    return true;
+                }
+
+                if ( lineEnd != std::string::npos or m_receivedBytes.size() - m_readOffset > m_maximumLineLengthInBytes )
+                {
+                    throw std::length_error{ "The line is longer than " + std::to_string( m_maximumLineLengthInBytes ) + " bytes." };
+                }
+
+                m_receivedBytes.erase( 0, m_readOffset );
+                m_readOffset = 0;
+
+                char receiveBuffer[1 << 16];
+                auto const numberOfBytesReceived = ::recv( m_socketDescriptor, receiveBuffer, sizeof( receiveBuffer ), 0 );
+                if ( numberOfBytesReceived < 0 and errno == EINTR )
+                {
+                    continue;
+                }
+
+                if ( numberOfBytesReceived <= 0 )
+                {
+                    return false;
+                }
+
+                m_receivedBytes.append( receiveBuffer, static_cast<std::size_t>( numberOfBytesReceived ) );
+            }
+        }
+
+        bool
+        writeAll( std::string_view bytes )
+        {
+            while ( not bytes.empty() )
+            {
+                auto const numberOfBytesSent = ::send( m_socketDescriptor, bytes.data(), bytes.size(), MSG_NOSIGNAL );
+                if ( numberOfBytesSent < 0 and errno == EINTR )
+                {
+                    continue;
+                }
+
+                if ( numberOfBytesSent <= 0 )
+                {
+                    return false;
+                }
+
+                bytes.remove_prefix( static_cast<std::size_t>( numberOfBytesSent ) );
+            }
+
+            return true;
+        }
+
+    private:
+        int            m_socketDescriptor;
+        std::size_t    m_maximumLineLengthInBytes;
+        std::string    m_receivedBytes;
+        std::size_t    m_readOffset = 0;
+    };
+
+    sockaddr_un
+    makeSocketAddress( std::string const& pathOfSocket )
+    {
+        auto socketAddress = sockaddr_un{};
+        socketAddress.sun_family = AF_UNIX;
+
+        if ( pathOfSocket.size() >= sizeof( socketAddress.sun_path ) )
+        {
+            throw std::runtime_error{ "The socket path " + pathOfSocket + " is too long." };
+        }
+
+        std::memcpy( socketAddress.sun_path, pathOfSocket.c_str(), pathOfSocket.size() + 1 );
+
+        return socketAddress;
+    }
+
+    int
+    createSocket()
+    {
+        auto const socketDescriptor = ::socket( AF_UNIX, SOCK_STREAM, 0 );
+        if ( socketDescriptor < 0 )
+        {
+            throw std::runtime_error{ std::string{ "Cannot create a socket: " } + std::strerror( errno ) };
+        }
+
+        return socketDescriptor;
+    }
+
+    void
+    serveConnection( int const connectionDescriptor,
+                     ImageCache& imageCache,
+                     ImageQueryOptions const& imageQueryOptions )
+    {
+        auto connection = LineSocket{ connectionDescriptor, maximumRequestLengthInBytes };
+        auto request = std::string{};
+        auto response = std::string{};
+
+        while ( true )
+        {
+            try
+            {
+                if ( not connection.readLine( request ) )
+                {
+                    return;
+                }
+            }
+            catch ( std::length_error const& lengthError )
+            {
+                // The rest of the line is still unread, so nothing after it
+                // can be told apart from it; the connection ends here.
+                connection.writeAll( std::string{ "error Request too long: " } + lengthError.what() + '\n' );
+                return;
+            }
+
+            response.clear();
+
+            try
+            {
+                auto const resultLines = answerImageQuery( imageCache, request, imageQueryOptions );
+
+                response += "ok " + std::to_string( resultLines.size() ) + '\n';
+                for ( auto const& resultLine : resultLines )
+                {
+                    response += resultLine;
+                    response += '\n';
+                }
+            }
+            catch ( std::exception const& queryError )
+            {
+                response = std::string{ "error " } + queryError.what();
+                for ( auto& character : response )
+                {
+                    character = character == '\n' ? ' ' : character;
+                }
+
+                response += '\n';
+            }
+
+            if ( not connection.writeAll( response ) )
+            {
+                return;
+            }
+        }
+    }
+
+    [[noreturn]] void
+    serve( std::string const& pathOfSocket,
+           std::uint64_t const cacheMemoryBudgetInBytes,
+           ImageQueryOptions const& imageQueryOptions )
+    {
+        auto const socketAddress = makeSocketAddress( pathOfSocket );
+        auto const listeningDescriptor = createSocket();
+
+        // A socket file left behind by a previous run would make bind() fail,
+        // but nothing else at that path is ours to remove.
+        struct stat existingFileStatus = {};
+        if ( ::lstat( pathOfSocket.c_str(), &existingFileStatus ) == 0 )
+        {
+            if ( not S_ISSOCK( existingFileStatus.st_mode ) )
+            {
+                throw std::runtime_error{ "Cannot listen on " + pathOfSocket + ": the path exists and is not a socket." };
+            }
+
+            ::unlink( pathOfSocket.c_str() );
+        }
+
+        if ( ::bind( listeningDescriptor, reinterpret_cast<sockaddr const*>( &socketAddress ), sizeof( socketAddress ) ) != 0
+             or ::listen( listeningDescriptor, SOMAXCONN ) != 0 )
+        {
+            throw std::runtime_error{ "Cannot listen on " + pathOfSocket + ": " + std::strerror( errno ) };
+        }
+
+        std::fprintf( stderr, "ewea-server: listening on %s\n", pathOfSocket.c_str() );
+
+        // Lives as long as the process, which the connection threads never
+        // outlive.
+        static auto imageCache = ImageCache{ cacheMemoryBudgetInBytes };
+        static auto connectionSlots = std::counting_semaphore<maximumNumberOfConnections>{ maximumNumberOfConnections };
+
+        while ( true )
+        {
+            connectionSlots.acquire();
+
+            auto const connectionDescriptor = ::accept( listeningDescriptor, nullptr, nullptr );
+            if ( connectionDescriptor < 0 )
+            {
+                connectionSlots.release();
+
+                if ( errno == EINTR or errno == ECONNABORTED )
+                {
+                    continue;
+                }
+
+                throw std::runtime_error{ std::string{ "Cannot accept connections: " } + std::strerror( errno ) };
+            }
+
+            std::thread{ [connectionDescriptor, &imageQueryOptions]()
+                         {
+                             serveConnection( connectionDescriptor, imageCache, imageQueryOptions );
+                             connectionSlots.release();
+                         } }.detach();
+        }
+    }
+
+    // Sends every line of stdin as a request and prints the result lines,
+    // with errors and the round trip time of each request on stderr.
+    int
+    ask( std::string const& pathOfSocket )
+    {
+        auto const socketAddress = makeSocketAddress( pathOfSocket );
+        auto connection = LineSocket{ createSocket() };
+
+        if ( ::connect( connection.getDescriptor(), reinterpret_cast<sockaddr const*>( &socketAddress ), sizeof( socketAddress ) ) != 0 )
+        {
+            throw std::runtime_error{ "Cannot connect to " + pathOfSocket + ": " + std::strerror( errno ) };
+        }
+
+        auto exitCode = 0;
+        auto request = std::string{};
+        auto responseLine = std::string{};
+
+        while ( std::getline( std::cin, request ) )
+        {
+            if ( request.empty() )
+            {
+                continue;
+            }
+
+            auto const requestStart = std::chrono::steady_clock::now();
+
+            if ( not connection.writeAll( request + '\n' ) or not connection.readLine( responseLine ) )
+            {
+                throw std::runtime_error{ "The server closed the connection." };
+            }
+
+            if ( not responseLine.starts_with( "ok " ) )
+            {
+                std::cerr << "ewea-server: " << request << ": " << responseLine << '\n';
+                exitCode = 2;
+                continue;
+            }
+
+            auto const numberOfResultLines = std::stoull( responseLine.substr( 3 ) );
+            for ( auto i = 0ull; i < numberOfResultLines; i++ )
+            {
+                if ( not connection.readLine( responseLine ) )
+                {
+                    throw std::runtime_error{ "The server closed the connection." };
+                }
+
+                std::printf( "%s\n", responseLine.c_str() );
+            }
+
+            std::fflush( stdout );
+            std::fprintf( stderr, "ewea-server: %llu lines in %.3f ms\n", numberOfResultLines,
+                          std::chrono::duration<double, std::milli>( std::chrono::steady_clock::now() - requestStart ).count() );
+        }
+
+        return exitCode;
+    }
+}
+#endif
+
+int
+main( int argCount, char** args )
+{
+    auto pathOfSocket = std::string{};
+    auto cacheMemoryBudgetInBytes = ImageCache::defaultMemoryBudgetInBytes;
+    auto imageQueryOptions = ImageQueryOptions{};
+    auto isClient = false;
+
+    try
+    {
+        for ( auto i = 1; i < argCount; i++ )
+        {
+            auto const argument = std::string{ args[i] };
+
+            if ( argument == "--search-dir" and i + 1 < argCount )
+            {
+                imageQueryOptions.searchDirectories.emplace_back( args[++i] );
+            }
+            else if ( argument == "--cache-budget" and i + 1 < argCount )
+            {
+                auto const budgetText = std::string{ args[++i] };
+                auto parsedLength = std::size_t{ 0 };
+                auto budgetInMebibytes = 0ull;
+
+                try
+                {
+                    budgetInMebibytes = std::stoull( budgetText, &parsedLength );
+                }
+                catch ( std::logic_error const& )
+                {
+                }
+
+                if ( parsedLength == 0 or parsedLength != budgetText.size() or budgetInMebibytes > std::numeric_limits<std::uint64_t>::max() / ( 1024 * 1024 ) )
+                {
+                    throw std::invalid_argument{ "'" + budgetText + "' is not a cache budget in MiB." };
+                }
+
+                cacheMemoryBudgetInBytes = budgetInMebibytes * 1024 * 1024;
+            }
+            else if ( argument == "--ask" )
+            {
+                isClient = true;
+            }
+            else if ( argument.starts_with( "--" ) or not pathOfSocket.empty() )
+            {
+                throw std::invalid_argument{ "Unexpected argument '" + argument + "'." };
+            }
+            else
+            {
+                pathOfSocket = argument;
+            }
+        }
+
+        if ( pathOfSocket.empty() )
+        {
+            throw std::invalid_argument{ "A socket path is required." };
+        }
+    }
+    catch ( std::invalid_argument const& argumentError )
+    {
+        std::cerr << "ewea-server: " << argumentError.what() << '\n'
+                  << "Usage: ewea-server [--search-dir DIR]... [--cache-budget MIB] SOCKET\n"
+                  << "       ewea-server --ask SOCKET\n"
+                  << "Serves queries over parsed images kept resident, on a Unix socket. With --ask, sends the\n"
+                  << "requests read from stdin, one per line, and prints the results. Images beyond the cache\n"
+                  << "budget, 1024 MiB by default, are dropped least recently used first. Requests:\n"
+                  << "  headers PATH | imports PATH | exports PATH | symbolize PATH RVA... | closure PATH | stats\n";
+        return 1;
+    }
+
+#ifndef _WIN32
+    try
+    {
+        if ( isClient )
+        {
+            return ask( pathOfSocket );
+        }
+
+        serve( pathOfSocket, cacheMemoryBudgetInBytes, imageQueryOptions );
+    }
+    catch ( std::runtime_error const& socketError )
+    {
+        std::cerr << "ewea-server: " << socketError.what() << '\n';
+        return 1;
+    }
+#else
+    std::cerr << "ewea-server: Unix sockets are not supported on this platform.\n";
+    return 1;
+#endif
+}
\ No newline at end of file
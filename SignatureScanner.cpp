@@ -0,0 +1,768 @@
+
+#include "SignatureScanner.h"
+
+#include "Instrumentation.h"
+
+#include <algorithm>
+#include <bit>
+#include <fstream>
+#include <istream>
+#include <sstream>
+#include <stdexcept>
+#include <tuple>
+
+#if defined( __GNUC__ ) and ( defined( __x86_64__ ) or defined( __i386__ ) )
+#include <immintrin.h>
+#define EWEA_HAS_SSSE3 1
+#define EWEA_SSSE3_FUNCTION __attribute__( ( target( "ssse3" ) ) )
+#elif defined( _M_X64 )
+#include <intrin.h>
+#define EWEA_HAS_SSSE3 1
+#define EWEA_SSSE3_FUNCTION
+#endif
+
+namespace
+{
+    auto const sectionContainsInitializedData = std::uint32_t{ 0x00000040 };
+    auto const sectionIsExecutable = std::uint32_t{ 0x20000000 };
+
+    auto const maximumAtomLengthInBytes = std::size_t{ 4 };
+    auto const numberOfByteValues = std::size_t{ 256 };
+
+    // A candidate position is checked against its first three bytes, so the
+    // vector path needs two bytes past each 16-byte block.
+    auto const prefilterWindowSizeInBytes = std::size_t{ 18 };
+    auto const atomStartTripleHashSizeInBits = 18;
+
+    std::optional<unsigned char>
+    getHexDigitValue( char const character )
+    {
+        if ( character >= '0' and character <= '9' )
+        {
+            return static_cast<unsigned char>( character - '0' );
+        }
+        if ( character >= 'a' and character <= 'f' )
+        {
+            return static_cast<unsigned char>( character - 'a' + 10 );
+        }
+        if ( character >= 'A' and character <= 'F' )
+        {
+            return static_cast<unsigned char>( character - 'A' + 10 );
+        }
+
+        return std::nullopt;
+    }
+
+    std::optional<std::uint32_t>
+    parseRequiredSectionCharacteristics( std::string const& sectionsToken )
+    {
+        if ( sectionsToken == "any" )
+        {
+            return 0;
+        }
+        if ( sectionsToken == "code" )
+        {
+            return sectionIsExecutable;
+        }
+        if ( sectionsToken == "data" )
+        {
+            return sectionContainsInitializedData;
+        }
+
+        if ( sectionsToken.size() > 2 and sectionsToken.size() <= 10 and sectionsToken.starts_with( "0x" ) )
+        {
+            auto characteristics = std::uint32_t{ 0 };
+            for ( auto const character : sectionsToken.substr( 2 ) )
+            {
+                auto const digitValue = getHexDigitValue( character );
+                if ( not digitValue )
+                {
+                    return std::nullopt;
+                }
+                characteristics = characteristics << 4 | *digitValue;
+            }
+
+            return characteristics;
+        }
+
+        return std::nullopt;
+    }
+
+    // Common filler and padding bytes make poor atoms: they hit everywhere
+    // and each hit costs a verification.
+    int
+    getAtomByteQuality( unsigned char const byte )
+    {
+        switch ( byte )
+        {
+            case 0x00:
+            case 0xFF:
+                return 1;
+            case 0x90:
+            case 0xCC:
+            case 0x20:
+                return 2;
+            default:
+                return 4;
+        }
+    }
+
+    // Picks the run of up to four fixed bytes with the best quality, returning
+    // its offset and length within the pattern.
+    std::optional<std::pair<std::size_t, std::size_t>>
+    chooseAtom( Signature const& signature )
+    {
+        auto bestAtom = std::optional<std::pair<std::size_t, std::size_t>>{};
+        auto bestScore = 0;
+
+        for ( auto atomOffset = std::size_t{ 0 }; atomOffset < signature.bytes.size(); atomOffset++ )
+        {
+            auto score = 0;
+
+            for ( auto atomLength = std::size_t{ 1 };
+                  atomLength <= maximumAtomLengthInBytes and atomOffset + atomLength <= signature.bytes.size();
+                  atomLength++ )
+            {
+                auto const atomByteIdx = atomOffset + atomLength - 1;
+                if ( signature.mask[atomByteIdx] != 0xFF )
+                {
+                    break;
+                }
+
+                // A byte repeated within the atom adds little selectivity, but
+                // still more than a shorter atom.
+                auto const isRepeatedByte =
+                    std::find( signature.bytes.begin() + atomOffset, signature.bytes.begin() + atomByteIdx,
+                               signature.bytes[atomByteIdx] ) != signature.bytes.begin() + atomByteIdx;
+                score += isRepeatedByte ? 1 : getAtomByteQuality( signature.bytes[atomByteIdx] );
+
+                if ( score > bestScore )
+                {
+                    bestScore = score;
+                    bestAtom = std::pair{ atomOffset, atomLength };
+                }
+            }
+        }
+
+        return bestAtom;
+    }
+
+    bool
+    isMatchingSignature( Signature const& signature,
+                         unsigned char const* bytes )
+    {
+        for ( auto i = std::size_t{ 0 }; i < signature.bytes.size(); i++ )
+        {
+            if ( ( bytes[i] & signature.mask[i] ) != signature.bytes[i] )
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    bool
+    doesAnySignatureApply( CompiledSignatures const& compiledSignatures,
+                           std::uint32_t const sectionCharacteristics )
+    {
+        return std::any_of( compiledSignatures.signatures.begin(), compiledSignatures.signatures.end(),
+                            [sectionCharacteristics]( Signature const& signature )
+                            {
+                                return ( sectionCharacteristics & signature.requiredSectionCharacteristics )
+                                       == signature.requiredSectionCharacteristics;
+                            } );
+    }
+
+    std::size_t
+    getBytePairIdx( unsigned char const* bytes )
+    {
+        return bytes[0] | std::size_t{ bytes[1] } << 8;
+    }
+
+    std::size_t
+    getByteTripleHash( unsigned char const* bytes )
+    {
+        auto const byteTriple = bytes[0] | std::uint32_t{ bytes[1] } << 8 | std::uint32_t{ bytes[2] } << 16;
+        return ( byteTriple * std::uint32_t{ 0x9E3779B1 } ) >> ( 32 - atomStartTripleHashSizeInBits );
+    }
+
+    bool
+    isBitSet( std::vector<std::uint64_t> const& bits,
+              std::size_t const bitIdx )
+    {
+        return ( bits[bitIdx / 64] >> ( bitIdx % 64 ) ) & 1;
+    }
+
+    void
+    setBit( std::vector<std::uint64_t>& bits,
+            std::size_t const bitIdx )
+    {
+        bits[bitIdx / 64] |= std::uint64_t{ 1 } << ( bitIdx % 64 );
+    }
+
+    // Whether an atom can start at the offset, judging by as many of its
+    // first three bytes as the section still has.
+    bool
+    isPossibleAtomStart( CompiledSignatures const& compiledSignatures,
+                         unsigned char const* bytes,
+                         std::size_t const offset,
+                         std::size_t const numberOfBytes )
+    {
+        if ( offset + 1 == numberOfBytes )
+        {
+            return compiledSignatures.isFirstAtomByte[bytes[offset]];
+        }
+
+        auto const bytePairIdx = getBytePairIdx( bytes + offset );
+
+        return     isBitSet( compiledSignatures.isAtomStartPair, bytePairIdx )
+               and (    isBitSet( compiledSignatures.isShortAtomStartPair, bytePairIdx )
+                     or (     offset + 2 < numberOfBytes
+                          and isBitSet( compiledSignatures.isLongAtomStartTriple, getByteTripleHash( bytes + offset ) ) ) );
+    }
+
+#ifdef EWEA_HAS_SSSE3
+    bool
+    isSSSE3Supported()
+    {
+#if defined( __GNUC__ )
+        return __builtin_cpu_supports( "ssse3" );
+#else
+        int cpuInfo[4];
+        __cpuid( cpuInfo, 1 );
+        return ( cpuInfo[2] & ( 1 << 9 ) ) != 0;
+#endif
+    }
+
+    // A set of byte values split by nibble for pshufb: bit h of
+    // lowerHalfRows[l] is set when the byte 0xhl is in the set for h < 8, and
+    // bit h - 8 of upperHalfRows[l] when it is for h >= 8.
+    struct NibbleByteSet
+    {
+        alignas( 16 ) std::array<unsigned char, 16>    lowerHalfRows{};
+        alignas( 16 ) std::array<unsigned char, 16>    upperHalfRows{};
+    };
+
+    NibbleByteSet
+    makeNibbleByteSet( std::array<bool, numberOfByteValues> const& isInSet )
+    {
+        auto nibbleByteSet = NibbleByteSet{};
+
+        for ( auto byte = std::size_t{ 0 }; byte < numberOfByteValues; byte++ )
+        {
+            if ( isInSet[byte] )
+            {
+                auto& rows = byte < 0x80 ? nibbleByteSet.lowerHalfRows : nibbleByteSet.upperHalfRows;
+                rows[byte & 0x0F] |= static_cast<unsigned char>( 1 << ( ( byte >> 4 ) & 7 ) );
+            }
+        }
+
+        return nibbleByteSet;
+    }
+
+    EWEA_SSSE3_FUNCTION
+    inline std::uint32_t
+    getByteSetMembershipMask( __m128i const characters,
+                              NibbleByteSet const& nibbleByteSet )
+    {
+        auto const lowNibbleMask = _mm_set1_epi8( 0x0F );
+        auto const highNibbleBits = _mm_setr_epi8( 1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128 );
+
+        auto const lowNibbles = _mm_and_si128( characters, lowNibbleMask );
+        auto const highNibbles = _mm_and_si128( _mm_srli_epi16( characters, 4 ), lowNibbleMask );
+
+        auto const lowerHalfRows =
+            _mm_shuffle_epi8( _mm_load_si128( reinterpret_cast<__m128i const*>( nibbleByteSet.lowerHalfRows.data() ) ),
+                              lowNibbles );
+        auto const upperHalfRows =
+            _mm_shuffle_epi8( _mm_load_si128( reinterpret_cast<__m128i const*>( nibbleByteSet.upperHalfRows.data() ) ),
+                              lowNibbles );
+        auto const isUpperHalf = _mm_cmpgt_epi8( highNibbles, _mm_set1_epi8( 7 ) );
+        auto const rows = _mm_or_si128( _mm_and_si128( isUpperHalf, upperHalfRows ),
+                                        _mm_andnot_si128( isUpperHalf, lowerHalfRows ) );
+
+        auto const isInSet = _mm_and_si128( rows, _mm_shuffle_epi8( highNibbleBits, highNibbles ) );
+
+        return static_cast<std::uint32_t>( _mm_movemask_epi8( _mm_cmpeq_epi8( isInSet, _mm_setzero_si128() ) ) ) ^ 0xFFFF;
+    }
+
+    // Returns the first position at or after startOffset whose first two
+    // bytes pass the byte set tests and that passes isPossibleAtomStart, or
+    // the first position of the tail too short for a full window.
+    EWEA_SSSE3_FUNCTION
+    std::size_t
+    findNextCandidateSSSE3( CompiledSignatures const& compiledSignatures,
+                            NibbleByteSet const& firstAtomBytes,
+                            NibbleByteSet const& secondAtomBytes,
+                            unsigned char const* bytes,
+                            std::size_t startOffset,
+                            std::size_t const numberOfBytes )
+    {
+        for ( ; startOffset + prefilterWindowSizeInBytes <= numberOfBytes; startOffset += 16 )
+        {
+            auto const firstCharacters = _mm_loadu_si128( reinterpret_cast<__m128i const*>( bytes + startOffset ) );
+            auto const secondCharacters = _mm_loadu_si128( reinterpret_cast<__m128i const*>( bytes + startOffset + 1 ) );
+
+            for ( auto candidateMask = getByteSetMembershipMask( firstCharacters, firstAtomBytes )
+                                     & getByteSetMembershipMask( secondCharacters, secondAtomBytes );
+                  candidateMask != 0;
+                  candidateMask &= candidateMask - 1 )
+            {
+                auto const candidateOffset = startOffset + std::countr_zero( candidateMask );
+                if ( isPossibleAtomStart( compiledSignatures, bytes, candidateOffset, numberOfBytes ) )
+                {
+                    return candidateOffset;
+                }
+            }
+        }
+
+        return startOffset;
+    }
+#endif
+
+    class SectionScanner
+    {
+    public:
+        explicit SectionScanner( CompiledSignatures const& compiledSignatures )
+        : m_compiledSignatures( compiledSignatures )
+        {
+#ifdef EWEA_HAS_SSSE3
+            // Once most byte values can begin an atom the byte sets pass nearly
+            // every position, and the pair bitmap alone is cheaper.
+            auto const numberOfFirstAtomBytes = static_cast<std::size_t>(
+                std::count( compiledSignatures.isFirstAtomByte.begin(), compiledSignatures.isFirstAtomByte.end(), true ) );
+            auto const numberOfSecondAtomBytes = static_cast<std::size_t>(
+                std::count( compiledSignatures.isSecondAtomByte.begin(), compiledSignatures.isSecondAtomByte.end(), true ) );
+
+            m_useSSSE3 =     isSSSE3Supported()
+                         and numberOfFirstAtomBytes * numberOfSecondAtomBytes * 4 < numberOfByteValues * numberOfByteValues;
+            m_firstAtomBytes = makeNibbleByteSet( compiledSignatures.isFirstAtomByte );
+            m_secondAtomBytes = makeNibbleByteSet( compiledSignatures.isSecondAtomByte );
+#endif
+        }
+
+        template <typename MatchCallback>
+        void
+        scan( unsigned char const* bytes,
+              std::size_t const numberOfBytes,
+              std::uint32_t const sectionCharacteristics,
+              MatchCallback const& onMatch ) const
+        {
+            auto const& transitions = m_compiledSignatures.transitions;
+            auto state = std::uint32_t{ 0 };
+
+            for ( auto offset = std::size_t{ 0 }; offset < numberOfBytes; offset++ )
+            {
+                if ( state == 0 )
+                {
+                    offset = findNextCandidate( bytes, offset, numberOfBytes );
+                    if ( offset == numberOfBytes )
+                    {
+                        break;
+                    }
+                }
+
+                auto const transition = transitions[state + bytes[offset]];
+                state = transition & CompiledSignatures::stateMask;
+
+                if ( transition & CompiledSignatures::hasOutputFlag )
+                {
+                    verifyAtomHits( state / numberOfByteValues, bytes, offset, numberOfBytes, sectionCharacteristics,
+                                    onMatch );
+                }
+
+                // With most byte values starting some atom the automaton is
+                // rarely back at its root, so also return to the prefilter
+                // when the only atoms still in play start at this byte and
+                // the bytes from here on cannot begin any of them.
+                if (     ( transition & CompiledSignatures::isShallowFlag )
+                     and not isPossibleAtomStart( m_compiledSignatures, bytes, offset, numberOfBytes ) )
+                {
+                    state = 0;
+                }
+            }
+        }
+
+    private:
+        std::size_t
+        findNextCandidate( unsigned char const* bytes,
+                           std::size_t offset,
+                           std::size_t const numberOfBytes ) const
+        {
+#ifdef EWEA_HAS_SSSE3
+            if ( m_useSSSE3 )
+            {
+                offset = findNextCandidateSSSE3( m_compiledSignatures, m_firstAtomBytes, m_secondAtomBytes,
+                                                 bytes, offset, numberOfBytes );
+            }
+#endif
+            auto const& isAtomStartPair = m_compiledSignatures.isAtomStartPair;
+
+            for ( ; offset < numberOfBytes; offset++ )
+            {
+                if (     ( offset + 1 == numberOfBytes or isBitSet( isAtomStartPair, getBytePairIdx( bytes + offset ) ) )
+                     and isPossibleAtomStart( m_compiledSignatures, bytes, offset, numberOfBytes ) )
+                {
+                    break;
+                }
+            }
+
+            return offset;
+        }
+
+        template <typename MatchCallback>
+        void
+        verifyAtomHits( std::uint32_t const state,
+                        unsigned char const* bytes,
+                        std::size_t const atomEndOffset,
+                        std::size_t const numberOfBytes,
+                        std::uint32_t const sectionCharacteristics,
+                        MatchCallback const& onMatch ) const
+        {
+            auto const& outputs = m_compiledSignatures.outputs;
+            auto const& stateToFirstOutputIdx = m_compiledSignatures.stateToFirstOutputIdx;
+
+            for ( auto i = stateToFirstOutputIdx[state]; i < stateToFirstOutputIdx[state + 1]; i++ )
+            {
+                auto const& atomOccurrence = outputs[i];
+                auto const& signature = m_compiledSignatures.signatures[atomOccurrence.signatureIdx];
+
+                if (    ( sectionCharacteristics & signature.requiredSectionCharacteristics )
+                        != signature.requiredSectionCharacteristics
+                     or atomEndOffset + 1 < atomOccurrence.atomEndOffset )
+                {
+                    continue;
+                }
+
+                auto const signatureOffset = atomEndOffset + 1 - atomOccurrence.atomEndOffset;
+                if (    signature.bytes.size() <= numberOfBytes - signatureOffset
+                     and isMatchingSignature( signature, bytes + signatureOffset ) )
+                {
+                    onMatch( atomOccurrence.signatureIdx, signatureOffset );
+                }
+            }
+        }
+
+    private:
+        CompiledSignatures const&    m_compiledSignatures;
+#ifdef EWEA_HAS_SSSE3
+        bool                         m_useSSSE3 = false;
+        NibbleByteSet                m_firstAtomBytes;
+        NibbleByteSet                m_secondAtomBytes;
+#endif
+    };
+
+    void
+    sortSignatureMatches( std::vector<SignatureMatch>& signatureMatches )
+    {
+        std::sort( signatureMatches.begin(), signatureMatches.end(),
+                   []( SignatureMatch const& lhs, SignatureMatch const& rhs )
+                   {
+                       return std::tie( lhs.fileOffset, lhs.signatureIdx ) < std::tie( rhs.fileOffset, rhs.signatureIdx );
+                   } );
+    }
+}
+
+std::vector<Signature>
+parseSignatures( std::istream& signaturesInput,
+                 std::string const& nameOfInput )
+{
+    auto signatures = std::vector<Signature>{};
+    auto line = std::string{};
+
+    for ( auto lineNumber = 1; std::getline( signaturesInput, line ); lineNumber++ )
+    {
+        auto const throwParseError =
+            [&]( std::string const& message )
+            {
+                throw std::runtime_error{ nameOfInput + ":" + std::to_string( lineNumber ) + ": " + message };
+            };
+
+        auto lineTokens = std::istringstream{ line };
+        auto signature = Signature{};
+        auto sectionsToken = std::string{};
+
+        if ( not ( lineTokens >> signature.name ) or signature.name.starts_with( '#' ) )
+        {
+            continue;
+        }
+
+        if ( not ( lineTokens >> sectionsToken ) )
+        {
+            throwParseError( "Signature '" + signature.name + "' has no sections and pattern." );
+        }
+
+        auto const requiredSectionCharacteristics = parseRequiredSectionCharacteristics( sectionsToken );
+        if ( not requiredSectionCharacteristics )
+        {
+            throwParseError( "'" + sectionsToken + "' is not any, code, data or a characteristics mask." );
+        }
+        signature.requiredSectionCharacteristics = *requiredSectionCharacteristics;
+
+        auto pattern = std::string{};
+        for ( auto patternToken = std::string{}; lineTokens >> patternToken; )
+        {
+            pattern += patternToken;
+        }
+
+        if ( pattern.empty() or pattern.size() % 2 != 0 )
+        {
+            throwParseError( "The pattern of '" + signature.name + "' is not a whole number of bytes." );
+        }
+
+        for ( auto i = std::size_t{ 0 }; i < pattern.size(); i += 2 )
+        {
+            auto const highNibble = pattern[i] == '?' ? std::optional<unsigned char>{ 0 } : getHexDigitValue( pattern[i] );
+            auto const lowNibble = pattern[i + 1] == '?' ? std::optional<unsigned char>{ 0 } : getHexDigitValue( pattern[i + 1] );
+
+            if ( not highNibble or not lowNibble )
+            {
+                throwParseError( "'" + pattern.substr( i, 2 ) + "' is neither a hex byte nor a wildcard." );
+            }
+
+            signature.bytes.push_back( static_cast<unsigned char>( *highNibble << 4 | *lowNibble ) );
+            signature.mask.push_back( static_cast<unsigned char>( ( pattern[i] == '?' ? 0x00 : 0xF0 )
+                                                                | ( pattern[i + 1] == '?' ? 0x00 : 0x0F ) ) );
+        }
+
+        signatures.push_back( std::move( signature ) );
+    }
+
+    return signatures;
+}
+
+std::vector<Signature>
+loadSignatures( std::string const& pathOfSignaturesFile )
+{
+    auto signaturesFile = std::ifstream{ pathOfSignaturesFile };
+
+    if ( not signaturesFile.is_open() )
+    {
+        throw std::runtime_error{ "Failed to open '" + pathOfSignaturesFile + "'." };
+    }
+
+    return parseSignatures( signaturesFile, pathOfSignaturesFile );
+}
+
+CompiledSignatures
+compileSignatures( std::vector<Signature> signatures )
+{
+    auto compiledSignatures = CompiledSignatures{ .signatures = std::move( signatures ) };
+
+    // Build the trie of atoms. State 0 is the root; during construction a
+    // transition of 0 from any other state means there is no edge.
+    auto trieTransitions = std::vector<std::uint32_t>( numberOfByteValues, 0 );
+    auto stateOutputs = std::vector<std::vector<SignatureAtomOccurrence>>( 1 );
+    compiledSignatures.isAtomStartPair.resize( numberOfByteValues * numberOfByteValues / 64, 0 );
+    compiledSignatures.isShortAtomStartPair.resize( numberOfByteValues * numberOfByteValues / 64, 0 );
+    compiledSignatures.isLongAtomStartTriple.resize( ( std::size_t{ 1 } << atomStartTripleHashSizeInBits ) / 64, 0 );
+
+    for ( auto signatureIdx = std::uint32_t{ 0 }; signatureIdx < compiledSignatures.signatures.size(); signatureIdx++ )
+    {
+        auto const& signature = compiledSignatures.signatures[signatureIdx];
+        auto const atom = chooseAtom( signature );
+
+        if ( not atom )
+        {
+            throw std::runtime_error{ "Signature '" + signature.name + "' has no fixed byte to search for." };
+        }
+
+        auto const [atomOffset, atomLength] = *atom;
+        auto state = std::uint32_t{ 0 };
+
+        for ( auto i = atomOffset; i < atomOffset + atomLength; i++ )
+        {
+            auto const byte = signature.bytes[i];
+            auto& transition = trieTransitions[state * numberOfByteValues + byte];
+
+            if ( transition == 0 )
+            {
+                transition = static_cast<std::uint32_t>( stateOutputs.size() );
+                stateOutputs.emplace_back();
+                trieTransitions.resize( trieTransitions.size() + numberOfByteValues, 0 );
+            }
+
+            state = trieTransitions[state * numberOfByteValues + byte];
+        }
+
+        auto const firstAtomByte = signature.bytes[atomOffset];
+        compiledSignatures.isFirstAtomByte[firstAtomByte] = true;
+
+        if ( atomLength >= 3 )
+        {
+            compiledSignatures.isSecondAtomByte[signature.bytes[atomOffset + 1]] = true;
+            setBit( compiledSignatures.isAtomStartPair, getBytePairIdx( &signature.bytes[atomOffset] ) );
+            setBit( compiledSignatures.isLongAtomStartTriple, getByteTripleHash( &signature.bytes[atomOffset] ) );
+        }
+        else
+        {
+            for ( auto secondAtomByte = std::size_t{ 0 }; secondAtomByte < numberOfByteValues; secondAtomByte++ )
+            {
+                if ( atomLength == 1 or secondAtomByte == signature.bytes[atomOffset + 1] )
+                {
+                    compiledSignatures.isSecondAtomByte[secondAtomByte] = true;
+                    setBit( compiledSignatures.isAtomStartPair, firstAtomByte | secondAtomByte << 8 );
+                    setBit( compiledSignatures.isShortAtomStartPair, firstAtomByte | secondAtomByte << 8 );
+                }
+            }
+        }
+
+        stateOutputs[state].push_back( SignatureAtomOccurrence
+                                       {
+                                           .signatureIdx = signatureIdx,
+                                           .atomEndOffset = static_cast<std::uint32_t>( atomOffset + atomLength )
+                                       } );
+    }
+
+    // Turn the trie into a DFA breadth first, so that the failure state of
+    // every state, being shallower, already has all of its transitions.
+    auto const numberOfStates = stateOutputs.size();
+    auto failureStates = std::vector<std::uint32_t>( numberOfStates, 0 );
+    auto stateDepths = std::vector<std::uint32_t>( numberOfStates, 0 );
+    auto statesInBreadthFirstOrder = std::vector<std::uint32_t>{ 0 };
+
+    for ( auto i = std::size_t{ 0 }; i < statesInBreadthFirstOrder.size(); i++ )
+    {
+        auto const state = statesInBreadthFirstOrder[i];
+
+        for ( auto byte = std::size_t{ 0 }; byte < numberOfByteValues; byte++ )
+        {
+            auto& transition = trieTransitions[state * numberOfByteValues + byte];
+            auto const failureTransition =
+                state == 0 ? 0 : trieTransitions[failureStates[state] * numberOfByteValues + byte];
+
+            if ( transition == 0 )
+            {
+                transition = failureTransition;
+                continue;
+            }
+
+            failureStates[transition] = failureTransition;
+            stateDepths[transition] = stateDepths[state] + 1;
+            stateOutputs[transition].insert( stateOutputs[transition].end(),
+                                             stateOutputs[failureTransition].begin(),
+                                             stateOutputs[failureTransition].end() );
+            statesInBreadthFirstOrder.push_back( transition );
+        }
+    }
+
+    compiledSignatures.stateToFirstOutputIdx.reserve( numberOfStates + 1 );
+    for ( auto const& outputsOfState : stateOutputs )
+    {
+        compiledSignatures.stateToFirstOutputIdx.push_back( static_cast<std::uint32_t>( compiledSignatures.outputs.size() ) );
+        compiledSignatures.outputs.insert( compiledSignatures.outputs.end(), outputsOfState.begin(), outputsOfState.end() );
+    }
+    compiledSignatures.stateToFirstOutputIdx.push_back( static_cast<std::uint32_t>( compiledSignatures.outputs.size() ) );
+
+    if ( numberOfStates * numberOfByteValues > CompiledSignatures::stateMask )
+    {
+        throw std::runtime_error{ "Too many signatures to compile into one automaton." };
+    }
+
+    for ( auto& transition : trieTransitions )
+    {
+        auto const hasOutput = not stateOutputs[transition].empty();
+        auto const isShallow = stateDepths[transition] <= 1;
+        transition = static_cast<std::uint32_t>( transition * numberOfByteValues )
+                   | ( hasOutput ? CompiledSignatures::hasOutputFlag : 0 )
+                   | ( isShallow ? CompiledSignatures::isShallowFlag : 0 );
+    }
+    compiledSignatures.transitions = std::move( trieTransitions );
+
+    return compiledSignatures;
+}
+
+SignatureScanResult
+scanForSignatures( CompiledSignatures const& compiledSignatures,
+                   EXEFile const& loadedEXEFile )
+{
+    auto const signaturesTimer = Instrumentation::ScopedTimer{ "Signatures" };
+
+    auto const sectionScanner = SectionScanner{ compiledSignatures };
+    auto signatureScanResult = SignatureScanResult{};
+
+    for ( auto const& [sectionName, sectionHeader] : loadedEXEFile.sectionHeadersNameToInfo )
+    {
+        auto const sectionRawData = loadedEXEFile.sectionNameToRawData.find( sectionName );
+
+        if (    sectionRawData == loadedEXEFile.sectionNameToRawData.end()
+             or not doesAnySignatureApply( compiledSignatures, sectionHeader.sectionCharacteristics ) )
+        {
+            continue;
+        }
+
+        auto const sectionIdx = static_cast<std::uint32_t>( signatureScanResult.sectionNames.size() );
+        signatureScanResult.sectionNames.push_back( sectionName );
+        signatureScanResult.numberOfScannedBytes += sectionRawData->second.size();
+
+        sectionScanner.scan( sectionRawData->second.data(), sectionRawData->second.size(),
+                             sectionHeader.sectionCharacteristics,
+                             [&]( std::uint32_t const signatureIdx, std::size_t const offsetInSection )
+                             {
+                                 signatureScanResult.matches.push_back(
+                                     SignatureMatch
+                                     {
+                                         .fileOffset = sectionHeader.pointerToRawData + std::uint64_t{ offsetInSection },
+                                         .rva = static_cast<std::uint32_t>( sectionHeader.sectionBaseAddressInMemory
+                                                                            + offsetInSection ),
+                                         .signatureIdx = signatureIdx,
+                                         .sectionIdx = sectionIdx
+                                     } );
+                             } );
+    }
+
+    sortSignatureMatches( signatureScanResult.matches );
+
+    return signatureScanResult;
+}
+
+SignatureScanResult
+scanForSignatures( CompiledSignatures const& compiledSignatures,
+                   PE::ByteReader const& rawBytes,
+                   OBJFile const& loadedOBJFile )
+{
+    auto const signaturesTimer = Instrumentation::ScopedTimer{ "Signatures" };
+
+    auto const sectionScanner = SectionScanner{ compiledSignatures };
+    auto signatureScanResult = SignatureScanResult{};
+
+    for ( auto const& [sectionName, sectionHeaders] : loadedOBJFile.sectionHeaders )
+    {
+        for ( auto const& sectionHeader : sectionHeaders )
+        {
+            // Uninitialized data has no raw data, and a section reaching past
+            // the end of the file is scanned as far as the file goes.
+            if (    sectionHeader.pointerToRawData == 0
+                 or sectionHeader.pointerToRawData >= rawBytes.size()
+                 or not doesAnySignatureApply( compiledSignatures, sectionHeader.sectionCharacteristics ) )
+            {
+                continue;
+            }
+
+            auto const sectionSizeInBytes =
+                std::min<std::size_t>( sectionHeader.sizeOfRawDataInBytes, rawBytes.size() - sectionHeader.pointerToRawData );
+            auto const sectionIdx = static_cast<std::uint32_t>( signatureScanResult.sectionNames.size() );
+            signatureScanResult.sectionNames.push_back( sectionName );
+            signatureScanResult.numberOfScannedBytes += sectionSizeInBytes;
+
+            sectionScanner.scan( rawBytes.data() + sectionHeader.pointerToRawData, sectionSizeInBytes,
+                                 sectionHeader.sectionCharacteristics,
+                                 [&]( std::uint32_t const signatureIdx, std::size_t const offsetInSection )
+                                 {
+                                     signatureScanResult.matches.push_back(
+                                         SignatureMatch
+                                         {
+                                             .fileOffset = sectionHeader.pointerToRawData + std::uint64_t{ offsetInSection },
+                                             .rva = std::nullopt,
+                                             .signatureIdx = signatureIdx,
+                                             .sectionIdx = sectionIdx
+                                         } );
+                                 } );
+        }
+    }
+
+    sortSignatureMatches( signatureScanResult.matches );
+
+    return signatureScanResult;
+}
\ No newline at end of file
@@ -0,0 +1,107 @@
+
+#ifndef SIGNATURESCANNER_H
+#define SIGNATURESCANNER_H
+
+#include "PEFiles.h"
+
+#include <array>
+#include <cstdint>
+#include <iosfwd>
+#include <optional>
+#include <string>
+#include <vector>
+
+// A byte pattern in which every byte is compared under a mask: 0xFF for a
+// fixed byte, 0x00 for a "??" wildcard and 0xF0 or 0x0F for "4?" and "?4".
+// The signature only applies to sections having all of the required
+// characteristics, so 0 means every section.
+struct Signature
+{
+    std::string                   name;
+    std::vector<unsigned char>    bytes;
+    std::vector<unsigned char>    mask;
+    std::uint32_t                 requiredSectionCharacteristics = 0;
+};
+
+// Reads one signature per line as "NAME SECTIONS PATTERN", where SECTIONS is
+// "any", "code", "data" or a characteristics mask such as 0x60000020, and
+// PATTERN is hex bytes with optional wildcards, e.g. "E8 ?? ?? ?? ?? 4? 8B".
+// Blank lines and lines starting with '#' are skipped. Throws
+// std::runtime_error naming the offending line.
+std::vector<Signature>
+parseSignatures( std::istream& signaturesInput,
+                 std::string const& nameOfInput );
+
+std::vector<Signature>
+loadSignatures( std::string const& pathOfSignaturesFile );
+
+struct SignatureAtomOccurrence
+{
+    std::uint32_t    signatureIdx;
+    std::uint32_t    atomEndOffset;
+};
+
+// Every signature is reduced to an atom of up to four fixed bytes, and all
+// atoms are compiled into one Aho-Corasick automaton stored as a dense
+// 256-way transition table, so a section is scanned in a single pass no
+// matter how many signatures there are. Each hit on an atom is verified
+// against the full masked pattern.
+struct CompiledSignatures
+{
+    std::vector<Signature>                  signatures;
+
+    // Indexed by state * 256 + byte; the entry is the next state times 256,
+    // with hasOutputFlag set when atoms end in that state and isShallowFlag
+    // when the state is at most one byte deep.
+    std::vector<std::uint32_t>              transitions;
+    std::vector<std::uint32_t>              stateToFirstOutputIdx;
+    std::vector<SignatureAtomOccurrence>    outputs;
+
+    // While the automaton is in its root state, or one byte deep in a prefix
+    // that the next byte cannot extend, the scan skips ahead to the next
+    // position that can begin an atom. The first two bytes are tested
+    // against byte sets sixteen positions at a time with SIMD, and each
+    // surviving position against an exact bitmap of the byte pairs beginning
+    // atoms. Unless the pair begins an atom of at most two bytes, the first
+    // three bytes are then checked against a hashed bitmap.
+    std::array<bool, 256>                   isFirstAtomByte{};
+    std::array<bool, 256>                   isSecondAtomByte{};
+    std::vector<std::uint64_t>              isAtomStartPair;
+    std::vector<std::uint64_t>              isShortAtomStartPair;
+    std::vector<std::uint64_t>              isLongAtomStartTriple;
+
+    static constexpr auto hasOutputFlag = std::uint32_t{ 1 } << 31;
+    static constexpr auto isShallowFlag = std::uint32_t{ 1 } << 30;
+    static constexpr auto stateMask = isShallowFlag - 1;
+};
+
+CompiledSignatures
+compileSignatures( std::vector<Signature> signatures );
+
+struct SignatureMatch
+{
+    std::uint64_t                   fileOffset;
+    std::optional<std::uint32_t>    rva;
+    std::uint32_t                   signatureIdx;
+    std::uint32_t                   sectionIdx;
+};
+
+struct SignatureScanResult
+{
+    std::vector<std::string>       sectionNames;
+    std::vector<SignatureMatch>    matches;
+    std::uint64_t                  numberOfScannedBytes = 0;
+};
+
+// Scans the raw data of every section that at least one signature applies
+// to. Matches are ordered by file offset, then by signature.
+SignatureScanResult
+scanForSignatures( CompiledSignatures const& compiledSignatures,
+                   EXEFile const& loadedEXEFile );
+
+SignatureScanResult
+scanForSignatures( CompiledSignatures const& compiledSignatures,
+                   PE::ByteReader const& rawBytes,
+                   OBJFile const& loadedOBJFile );
+
+#endif // SIGNATURESCANNER_H
\ No newline at end of file
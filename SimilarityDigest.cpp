@@ -0,0 +1,318 @@
+
+#include "SimilarityDigest.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+namespace
+{
+    auto const windowSizeInBytes = std::size_t{ 5 };
+    auto const minimumSizeInBytes = std::uint64_t{ 50 };
+
+    auto const digestSizeInBytes = std::size_t{ 35 };
+
+    // One of the 128 buckets for a salted triplet, by Fibonacci hashing.
+    inline std::uint32_t
+    getTripletBucket( std::uint32_t const salt,
+                      std::uint32_t const firstByte,
+                      std::uint32_t const secondByte,
+                      std::uint32_t const thirdByte )
+    {
+        auto const triplet = ( salt << 24 ) | ( firstByte << 16 ) | ( secondByte << 8 ) | thirdByte;
+        return ( triplet * 0x9E3779B1u ) >> 25;
+    }
+
+    // The triplets and salts of TLSH, over the newest byte and the four
+    // before it.
+    void
+    countWindows( std::array<std::uint32_t, numberOfSimilarityBuckets>& bucketCounts,
+                  unsigned char const* const bytes,
+                  std::size_t const sizeInBytes )
+    {
+        if ( sizeInBytes < windowSizeInBytes )
+        {
+            return;
+        }
+
+        std::uint32_t byte1 = bytes[3];
+        std::uint32_t byte2 = bytes[2];
+        std::uint32_t byte3 = bytes[1];
+        std::uint32_t byte4 = bytes[0];
+
+        for ( auto i = windowSizeInBytes - 1; i < sizeInBytes; i++ )
+        {
+            std::uint32_t const byte0 = bytes[i];
+
+            bucketCounts[getTripletBucket( 2, byte0, byte1, byte2 )]++;
+            bucketCounts[getTripletBucket( 3, byte0, byte1, byte3 )]++;
+            bucketCounts[getTripletBucket( 5, byte0, byte2, byte3 )]++;
+            bucketCounts[getTripletBucket( 7, byte0, byte2, byte4 )]++;
+            bucketCounts[getTripletBucket( 11, byte0, byte1, byte4 )]++;
+            bucketCounts[getTripletBucket( 13, byte0, byte3, byte4 )]++;
+
+            byte4 = byte3;
+            byte3 = byte2;
+            byte2 = byte1;
+            byte1 = byte0;
+        }
+    }
+
+    // Logarithmic in the size, finer for larger sizes, as in TLSH.
+    std::uint8_t
+    getLengthCode( std::uint64_t const sizeInBytes )
+    {
+        auto const logOfSize = std::log( static_cast<double>( sizeInBytes ) );
+
+        auto lengthCode = 0.0;
+        if ( sizeInBytes <= 656 )
+        {
+            lengthCode = logOfSize / std::log( 1.5 );
+        }
+        else if ( sizeInBytes <= 3199 )
+        {
+            lengthCode = logOfSize / std::log( 1.3 ) - 8.72777;
+        }
+        else
+        {
+            lengthCode = logOfSize / std::log( 1.1 ) - 62.5472;
+        }
+
+        return static_cast<std::uint8_t>( static_cast<std::uint64_t>( lengthCode ) & 0xFF );
+    }
+
+    std::uint32_t
+    getCircularDifference( std::uint32_t const firstValue,
+                           std::uint32_t const secondValue,
+                           std::uint32_t const range )
+    {
+        auto const difference = firstValue > secondValue ? firstValue - secondValue : secondValue - firstValue;
+        return std::min( difference, range - difference );
+    }
+
+    // Differences of one cost what they are; larger ones weigh twelve times
+    // as much, so that digests of data of very different size or shape stay
+    // apart. Past one step, ratios are charged a step less, as in TLSH.
+    std::uint32_t
+    getHeaderDifference( std::uint32_t const difference,
+                         std::uint32_t const discountedSteps )
+    {
+        return difference <= 1 ? difference : ( difference - discountedSteps ) * 12;
+    }
+
+    int
+    getHexDigitValue( char const character )
+    {
+        if ( character >= '0' and character <= '9' )
+        {
+            return character - '0';
+        }
+        if ( character >= 'A' and character <= 'F' )
+        {
+            return character - 'A' + 10;
+        }
+        if ( character >= 'a' and character <= 'f' )
+        {
+            return character - 'a' + 10;
+        }
+        return -1;
+    }
+}
+
+SimilarityCounts
+countSimilarityWindows( std::span<unsigned char const> const bytes )
+{
+    auto similarityCounts = SimilarityCounts{ .sizeInBytes = bytes.size() };
+    countWindows( similarityCounts.bucketCounts, bytes.data(), bytes.size() );
+
+    return similarityCounts;
+}
+
+void
+appendSimilarityCounts( SimilarityCounts& similarityCounts,
+                        SimilarityCounts const& followingCounts,
+                        std::span<unsigned char const> const precedingBytes,
+                        std::span<unsigned char const> const followingBytes )
+{
+    // At most four bytes from either side, so every window of the seam
+    // straddles the two.
+    unsigned char seamBytes[2 * ( windowSizeInBytes - 1 )];
+    auto const numberOfPrecedingBytes = std::min( precedingBytes.size(), windowSizeInBytes - 1 );
+    auto const numberOfFollowingBytes = std::min( followingBytes.size(), windowSizeInBytes - 1 );
+
+    std::copy( precedingBytes.end() - numberOfPrecedingBytes, precedingBytes.end(), seamBytes );
+    std::copy( followingBytes.begin(), followingBytes.begin() + numberOfFollowingBytes, seamBytes + numberOfPrecedingBytes );
+
+    countWindows( similarityCounts.bucketCounts, seamBytes, numberOfPrecedingBytes + numberOfFollowingBytes );
+
+    for ( auto bucketIdx = std::size_t{ 0 }; bucketIdx < numberOfSimilarityBuckets; bucketIdx++ )
+    {
+        similarityCounts.bucketCounts[bucketIdx] += followingCounts.bucketCounts[bucketIdx];
+    }
+
+    similarityCounts.sizeInBytes += followingCounts.sizeInBytes;
+}
+
+std::optional<SimilarityDigest>
+makeSimilarityDigest( SimilarityCounts const& similarityCounts )
+{
+    if ( similarityCounts.sizeInBytes < minimumSizeInBytes )
+    {
+        return std::nullopt;
+    }
+
+    auto const& bucketCounts = similarityCounts.bucketCounts;
+
+    auto const numberOfNonEmptyBuckets = std::count_if( bucketCounts.begin(), bucketCounts.end(),
+                                                        []( std::uint32_t const bucketCount ) { return bucketCount != 0; } );
+    if ( static_cast<std::size_t>( numberOfNonEmptyBuckets ) <= numberOfSimilarityBuckets / 2 )
+    {
+        return std::nullopt;
+    }
+
+    auto sortedCounts = bucketCounts;
+    auto const quartileSize = numberOfSimilarityBuckets / 4;
+
+    std::nth_element( sortedCounts.begin(), sortedCounts.begin() + 3 * quartileSize - 1, sortedCounts.end() );
+    auto const thirdQuartile = sortedCounts[3 * quartileSize - 1];
+    std::nth_element( sortedCounts.begin(), sortedCounts.begin() + 2 * quartileSize - 1, sortedCounts.begin() + 3 * quartileSize - 1 );
+    auto const secondQuartile = sortedCounts[2 * quartileSize - 1];
+    std::nth_element( sortedCounts.begin(), sortedCounts.begin() + quartileSize - 1, sortedCounts.begin() + 2 * quartileSize - 1 );
+    auto const firstQuartile = sortedCounts[quartileSize - 1];
+
+    if ( thirdQuartile == 0 )
+    {
+        return std::nullopt;
+    }
+
+    auto similarityDigest = SimilarityDigest
+    {
+        .lengthCode = getLengthCode( similarityCounts.sizeInBytes ),
+        .quartileRatios = static_cast<std::uint8_t>( ( ( std::uint64_t{ firstQuartile } * 100 / thirdQuartile ) % 16 ) << 4
+                                                     | ( std::uint64_t{ secondQuartile } * 100 / thirdQuartile ) % 16 )
+    };
+
+    // The checksum is taken over the counts rather than the bytes, so it
+    // does not depend on how the data was split up either.
+    auto checksum = std::uint64_t{ 0x9E3779B97F4A7C15 };
+
+    for ( auto bucketIdx = std::size_t{ 0 }; bucketIdx < numberOfSimilarityBuckets; bucketIdx++ )
+    {
+        auto const bucketCount = bucketCounts[bucketIdx];
+        auto const bucketCode = bucketCount <= firstQuartile ? 0 : bucketCount <= secondQuartile ? 1 : bucketCount <= thirdQuartile ? 2 : 3;
+
+        similarityDigest.body[bucketIdx / 4] |= static_cast<std::uint8_t>( bucketCode << ( 2 * ( bucketIdx % 4 ) ) );
+
+        checksum = ( checksum ^ bucketCount ) * 0xFF51AFD7ED558CCD;
+        checksum ^= checksum >> 29;
+    }
+
+    similarityDigest.checksum = static_cast<std::uint8_t>( checksum );
+
+    return similarityDigest;
+}
+
+std::optional<SimilarityDigest>
+computeSimilarityDigest( std::span<unsigned char const> const bytes )
+{
+    return makeSimilarityDigest( countSimilarityWindows( bytes ) );
+}
+
+std::uint32_t
+getSimilarityDistance( SimilarityDigest const& firstDigest,
+                       SimilarityDigest const& secondDigest )
+{
+    auto distance = std::uint32_t{ firstDigest.checksum != secondDigest.checksum ? 1u : 0u };
+
+    distance += getHeaderDifference( getCircularDifference( firstDigest.lengthCode, secondDigest.lengthCode, 256 ), 0 );
+    distance += getHeaderDifference( getCircularDifference( firstDigest.quartileRatios >> 4, secondDigest.quartileRatios >> 4, 16 ), 1 );
+    distance += getHeaderDifference( getCircularDifference( firstDigest.quartileRatios & 0xF, secondDigest.quartileRatios & 0xF, 16 ), 1 );
+
+    // Per bucket, codes one or two apart cost one or two, and opposite
+    // quartiles cost six. Thirty-two buckets are compared at a time: with
+    // the low bit of each two-bit lane standing for the lane, a lane differs
+    // by one when only its low bit differs, by two when only its high bit
+    // does, and by three rather than one when both do and each code has
+    // equal bits.
+    auto const lowBits = std::uint64_t{ 0x5555555555555555 };
+
+    for ( auto wordIdx = std::size_t{ 0 }; wordIdx < 4; wordIdx++ )
+    {
+        auto firstWord = std::uint64_t{ 0 };
+        auto secondWord = std::uint64_t{ 0 };
+        for ( auto byteIdx = std::size_t{ 0 }; byteIdx < 8; byteIdx++ )
+        {
+            firstWord |= std::uint64_t{ firstDigest.body[8 * wordIdx + byteIdx] } << ( 8 * byteIdx );
+            secondWord |= std::uint64_t{ secondDigest.body[8 * wordIdx + byteIdx] } << ( 8 * byteIdx );
+        }
+
+        auto const differingBits = firstWord ^ secondWord;
+        auto const lowDiffers = differingBits & lowBits;
+        auto const highDiffers = ( differingBits >> 1 ) & lowBits;
+        auto const bothDiffer = lowDiffers & highDiffers;
+        auto const hasEqualBits = ~( firstWord ^ ( firstWord >> 1 ) ) & lowBits;
+
+        distance += std::popcount( lowDiffers & ~highDiffers )
+                    + 2 * std::popcount( highDiffers & ~lowDiffers )
+                    + 6 * std::popcount( bothDiffer & hasEqualBits )
+                    + std::popcount( bothDiffer & ~hasEqualBits );
+    }
+
+    return distance;
+}
+
+std::string
+formatSimilarityDigest( SimilarityDigest const& similarityDigest )
+{
+    auto digestText = std::string{};
+    digestText.reserve( 2 * digestSizeInBytes );
+
+    auto const appendByte =
+        [&digestText]( std::uint8_t const byte )
+        {
+            digestText += "0123456789ABCDEF"[byte >> 4];
+            digestText += "0123456789ABCDEF"[byte & 0xF];
+        };
+
+    appendByte( similarityDigest.checksum );
+    appendByte( similarityDigest.lengthCode );
+    appendByte( similarityDigest.quartileRatios );
+    for ( auto const byte : similarityDigest.body )
+    {
+        appendByte( byte );
+    }
+
+    return digestText;
+}
+
+std::optional<SimilarityDigest>
+parseSimilarityDigest( std::string_view const digestText )
+{
+    if ( digestText.size() != 2 * digestSizeInBytes )
+    {
+        return std::nullopt;
+    }
+
+    std::uint8_t digestBytes[digestSizeInBytes];
+    for ( auto byteIdx = std::size_t{ 0 }; byteIdx < digestSizeInBytes; byteIdx++ )
+    {
+        auto const highNibble = getHexDigitValue( digestText[2 * byteIdx] );
+        auto const lowNibble = getHexDigitValue( digestText[2 * byteIdx + 1] );
+        if ( highNibble < 0 or lowNibble < 0 )
+        {
+            return std::nullopt;
+        }
+
+        digestBytes[byteIdx] = static_cast<std::uint8_t>( ( highNibble << 4 ) | lowNibble );
+    }
+
+    auto similarityDigest = SimilarityDigest
+    {
+        .checksum = digestBytes[0],
+        .lengthCode = digestBytes[1],
+        .quartileRatios = digestBytes[2]
+    };
+    std::copy( digestBytes + 3, digestBytes + digestSizeInBytes, similarityDigest.body.begin() );
+
+    return similarityDigest;
+}
\ No newline at end of file
@@ -0,0 +1,93 @@
+
+#ifndef SIMILARITYDIGEST_H
+#define SIMILARITYDIGEST_H
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+
+inline constexpr auto numberOfSimilarityBuckets = std::size_t{ 128 };
+
+// A locality sensitive digest in the manner of TLSH. Every five byte window
+// of the data is split into six byte triplets, each hashed into one of 128
+// buckets, and the body keeps for every bucket which quartile of the bucket
+// counts it falls into. Recompiling or patching a binary moves a few buckets
+// by a quartile or so, where an exact hash changes completely, so the
+// distance between two digests tracks how much the data differs.
+//
+// The digest is not byte compatible with TLSH: its triplet hash and
+// checksum differ, so that the counts of separate chunks of data may be
+// combined in any order.
+struct SimilarityDigest
+{
+    std::uint8_t                    checksum = 0;
+    std::uint8_t                    lengthCode = 0;
+
+    // The ratios of the first and second quartiles to the third, in
+    // percent modulo 16, in the high and low nibble.
+    std::uint8_t                    quartileRatios = 0;
+
+    // Two bits per bucket, four buckets per byte.
+    std::array<std::uint8_t, 32>    body = {};
+
+    std::uint8_t
+    getBucketCode( std::size_t const bucketIdx ) const
+    {
+        return ( body[bucketIdx / 4] >> ( 2 * ( bucketIdx % 4 ) ) ) & 0x3;
+    }
+
+    friend bool
+    operator==( SimilarityDigest const&, SimilarityDigest const& ) = default;
+
+    friend auto
+    operator<=>( SimilarityDigest const&, SimilarityDigest const& ) = default;
+};
+
+// The bucket counts of a run of data, before they are reduced to a digest.
+struct SimilarityCounts
+{
+    std::array<std::uint32_t, numberOfSimilarityBuckets>    bucketCounts = {};
+    std::uint64_t                                           sizeInBytes = 0;
+};
+
+// Counts the windows lying wholly inside the bytes.
+SimilarityCounts
+countSimilarityWindows( std::span<unsigned char const> const bytes );
+
+// Adds the counts of the data following the data already counted, along
+// with the windows straddling the two. The last four bytes counted so far
+// and the first four bytes of the following data are enough for that; fewer
+// are only allowed where the data has fewer.
+void
+appendSimilarityCounts( SimilarityCounts& similarityCounts,
+                        SimilarityCounts const& followingCounts,
+                        std::span<unsigned char const> const precedingBytes,
+                        std::span<unsigned char const> const followingBytes );
+
+// Returns std::nullopt for data too short or too uniform to be told apart
+// from other data: under 50 bytes, or with over half of the buckets empty.
+std::optional<SimilarityDigest>
+makeSimilarityDigest( SimilarityCounts const& similarityCounts );
+
+std::optional<SimilarityDigest>
+computeSimilarityDigest( std::span<unsigned char const> const bytes );
+
+// The TLSH distance: 0 for equal digests, growing with the difference
+// between the data. Below about 50 the data is nearly the same; over 200 it
+// is unrelated.
+std::uint32_t
+getSimilarityDistance( SimilarityDigest const& firstDigest,
+                       SimilarityDigest const& secondDigest );
+
+// 70 uppercase hex digits: checksum, length code, quartile ratios and body.
+std::string
+formatSimilarityDigest( SimilarityDigest const& similarityDigest );
+
+// Returns std::nullopt for text not produced by formatSimilarityDigest.
+std::optional<SimilarityDigest>
+parseSimilarityDigest( std::string_view const digestText );
+
+#endif // SIMILARITYDIGEST_H
\ No newline at end of file
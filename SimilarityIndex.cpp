@@ -0,0 +1,287 @@
+
+#include "SimilarityIndex.h"
+
+#include "ParallelFor.h"
+
+#include <algorithm>
+#include <bit>
+#include <numeric>
+#include <utility>
+
+namespace
+{
+    using SampledBuckets = std::array<std::array<std::uint8_t, SimilarityIndex::numberOfSampledBuckets>,
+                                      SimilarityIndex::numberOfHashTables>;
+
+    // Distinct buckets per table, drawn from a fixed sequence so that the
+    // keys, and with them the results, are the same on every run.
+    constexpr SampledBuckets
+    drawSampledBuckets()
+    {
+        auto sampledBuckets = SampledBuckets{};
+        auto state = std::uint64_t{ 0x853C49E6748FEA9B };
+
+        for ( auto& bucketsOfTable : sampledBuckets )
+        {
+            for ( auto sampleIdx = std::size_t{ 0 }; sampleIdx < bucketsOfTable.size(); )
+            {
+                state = state * 6364136223846793005 + 1442695040888963407;
+                auto const bucketIdx = static_cast<std::uint8_t>( ( state >> 33 ) % numberOfSimilarityBuckets );
+
+                if ( std::find( bucketsOfTable.begin(), bucketsOfTable.begin() + sampleIdx, bucketIdx ) == bucketsOfTable.begin() + sampleIdx )
+                {
+                    bucketsOfTable[sampleIdx++] = bucketIdx;
+                }
+            }
+        }
+
+        return sampledBuckets;
+    }
+
+    constexpr auto sampledBuckets = drawSampledBuckets();
+
+    auto const keySizeInBits = std::uint32_t{ 2 * SimilarityIndex::numberOfSampledBuckets };
+
+    std::uint64_t
+    getKey( SimilarityDigest const& similarityDigest,
+            std::size_t const hashTableIdx )
+    {
+        auto key = std::uint64_t{ 0 };
+        for ( auto const bucketIdx : sampledBuckets[hashTableIdx] )
+        {
+            key = ( key << 2 ) | similarityDigest.getBucketCode( bucketIdx );
+        }
+
+        return key;
+    }
+
+    std::uint32_t
+    findRoot( std::vector<std::uint32_t>& parentIndices,
+              std::uint32_t idx )
+    {
+        while ( parentIndices[idx] != idx )
+        {
+            parentIndices[idx] = parentIndices[parentIndices[idx]];
+            idx = parentIndices[idx];
+        }
+
+        return idx;
+    }
+}
+
+SimilarityIndex::SimilarityIndex( std::vector<SimilarityDigest> const& similarityDigests )
+{
+    auto const numberOfItems = static_cast<std::uint32_t>( similarityDigests.size() );
+
+    auto itemOrder = std::vector<std::uint32_t>( numberOfItems );
+    std::iota( itemOrder.begin(), itemOrder.end(), 0 );
+    std::stable_sort( itemOrder.begin(), itemOrder.end(),
+                      [&similarityDigests]( std::uint32_t const firstItemIdx, std::uint32_t const secondItemIdx )
+                      {
+                          return similarityDigests[firstItemIdx] < similarityDigests[secondItemIdx];
+                      } );
+
+    m_distinctDigestIndicesOfItems.resize( numberOfItems );
+    m_itemIndices.reserve( numberOfItems );
+
+    for ( auto const itemIdx : itemOrder )
+    {
+        if ( m_distinctDigests.empty() or m_distinctDigests.back() != similarityDigests[itemIdx] )
+        {
+            m_distinctDigests.push_back( similarityDigests[itemIdx] );
+            m_itemOffsets.push_back( static_cast<std::uint32_t>( m_itemIndices.size() ) );
+        }
+
+        m_distinctDigestIndicesOfItems[itemIdx] = static_cast<std::uint32_t>( m_distinctDigests.size() - 1 );
+        m_itemIndices.push_back( itemIdx );
+    }
+
+    m_itemOffsets.push_back( numberOfItems );
+
+    // About four distinct digests per prefix.
+    auto const prefixSizeInBits = std::min<std::uint32_t>( std::bit_width( m_distinctDigests.size() / 4 ), keySizeInBits );
+    m_keyPrefixShift = keySizeInBits - prefixSizeInBits;
+
+    parallelFor( numberOfHashTables,
+                 [this]( std::size_t const hashTableIdx )
+                 {
+                     auto& hashTable = m_hashTables[hashTableIdx];
+                     hashTable.reserve( m_distinctDigests.size() );
+
+                     for ( auto distinctDigestIdx = std::size_t{ 0 }; distinctDigestIdx < m_distinctDigests.size(); distinctDigestIdx++ )
+                     {
+                         hashTable.push_back( getKey( m_distinctDigests[distinctDigestIdx], hashTableIdx ) << 32 | distinctDigestIdx );
+                     }
+
+                     std::sort( hashTable.begin(), hashTable.end() );
+
+                     auto& directory = m_directories[hashTableIdx];
+                     directory.assign( ( std::size_t{ 1 } << ( keySizeInBits - m_keyPrefixShift ) ) + 1, 0 );
+
+                     for ( auto const entry : hashTable )
+                     {
+                         directory[( entry >> 32 >> m_keyPrefixShift ) + 1]++;
+                     }
+
+                     std::partial_sum( directory.begin(), directory.end(), directory.begin() );
+                 } );
+}
+
+template <typename CandidateFunction>
+void
+SimilarityIndex::forEachCandidate( SimilarityDigest const& queryDigest,
+                                   std::size_t const maximumBucketScanSize,
+                                   CandidateFunction const& onCandidate ) const
+{
+    for ( auto hashTableIdx = std::size_t{ 0 }; hashTableIdx < numberOfHashTables; hashTableIdx++ )
+    {
+        auto const& hashTable = m_hashTables[hashTableIdx];
+        auto const key = getKey( queryDigest, hashTableIdx );
+
+        auto const& directory = m_directories[hashTableIdx];
+        auto const keyPrefix = key >> m_keyPrefixShift;
+
+        auto entry = std::lower_bound( hashTable.begin() + directory[keyPrefix], hashTable.begin() + directory[keyPrefix + 1], key << 32 );
+        for ( auto numberOfScannedEntries = std::size_t{ 0 };
+              entry != hashTable.end() and ( *entry >> 32 ) == key and numberOfScannedEntries < maximumBucketScanSize;
+              ++entry, numberOfScannedEntries++ )
+        {
+            onCandidate( static_cast<std::uint32_t>( *entry ) );
+        }
+    }
+}
+
+std::vector<SimilarNeighbour>
+SimilarityIndex::findNeighbours( SimilarityDigest const& queryDigest,
+                                 std::uint32_t const maximumDistance,
+                                 std::size_t const maximumBucketScanSize ) const
+{
+    auto candidateIndices = std::vector<std::uint32_t>{};
+    forEachCandidate( queryDigest, maximumBucketScanSize,
+                      [&candidateIndices]( std::uint32_t const distinctDigestIdx )
+                      {
+                          candidateIndices.push_back( distinctDigestIdx );
+                      } );
+
+    std::sort( candidateIndices.begin(), candidateIndices.end() );
+    candidateIndices.erase( std::unique( candidateIndices.begin(), candidateIndices.end() ), candidateIndices.end() );
+
+    auto similarNeighbours = std::vector<SimilarNeighbour>{};
+
+    for ( auto const distinctDigestIdx : candidateIndices )
+    {
+        auto const distance = getSimilarityDistance( queryDigest, m_distinctDigests[distinctDigestIdx] );
+        if ( distance > maximumDistance )
+        {
+            continue;
+        }
+
+        for ( auto i = m_itemOffsets[distinctDigestIdx]; i < m_itemOffsets[distinctDigestIdx + 1]; i++ )
+        {
+            similarNeighbours.push_back( SimilarNeighbour{ .itemIdx = m_itemIndices[i], .distance = distance } );
+        }
+    }
+
+    std::sort( similarNeighbours.begin(), similarNeighbours.end(),
+               []( SimilarNeighbour const& firstNeighbour, SimilarNeighbour const& secondNeighbour )
+               {
+                   return std::pair( firstNeighbour.distance, firstNeighbour.itemIdx )
+                          < std::pair( secondNeighbour.distance, secondNeighbour.itemIdx );
+               } );
+
+    return similarNeighbours;
+}
+
+SimilarityClusters
+SimilarityIndex::clusterItems( std::uint32_t const maximumDistance,
+                               std::size_t const maximumBucketScanSize ) const
+{
+    // The links are found in blocks, in parallel, and each only from the
+    // lower digest to the higher, then joined in one pass.
+    auto const numberOfDistinctDigests = m_distinctDigests.size();
+    auto const blockSize = std::size_t{ 4096 };
+    auto const numberOfBlocks = ( numberOfDistinctDigests + blockSize - 1 ) / blockSize;
+
+    struct BlockLinks
+    {
+        std::vector<std::pair<std::uint32_t, std::uint32_t>>    links;
+        std::uint64_t                                           numberOfComparisons = 0;
+    };
+
+    auto blocksLinks = std::vector<BlockLinks>( numberOfBlocks );
+
+    parallelFor( numberOfBlocks,
+                 [&]( std::size_t const blockIdx )
+                 {
+                     auto& blockLinks = blocksLinks[blockIdx];
+                     auto candidateIndices = std::vector<std::uint32_t>{};
+
+                     // Marks the candidates already seen for a digest with
+                     // its index plus one, which spares sorting them.
+                     auto candidateStamps = std::vector<std::uint32_t>( numberOfDistinctDigests, 0 );
+
+                     auto const blockEnd = std::min( ( blockIdx + 1 ) * blockSize, numberOfDistinctDigests );
+                     for ( auto distinctDigestIdx = static_cast<std::uint32_t>( blockIdx * blockSize ); distinctDigestIdx < blockEnd; distinctDigestIdx++ )
+                     {
+                         candidateIndices.clear();
+                         forEachCandidate( m_distinctDigests[distinctDigestIdx], maximumBucketScanSize,
+                                           [&candidateIndices, &candidateStamps, distinctDigestIdx]( std::uint32_t const candidateIdx )
+                                           {
+                                               if ( candidateIdx > distinctDigestIdx and candidateStamps[candidateIdx] != distinctDigestIdx + 1 )
+                                               {
+                                                   candidateStamps[candidateIdx] = distinctDigestIdx + 1;
+                                                   candidateIndices.push_back( candidateIdx );
+                                               }
+                                           } );
+
+                         for ( auto const candidateIdx : candidateIndices )
+                         {
+                             if ( getSimilarityDistance( m_distinctDigests[distinctDigestIdx], m_distinctDigests[candidateIdx] ) <= maximumDistance )
+                             {
+                                 blockLinks.links.emplace_back( distinctDigestIdx, candidateIdx );
+                             }
+                         }
+
+                         blockLinks.numberOfComparisons += candidateIndices.size();
+                     }
+                 } );
+
+    auto similarityClusters = SimilarityClusters{};
+    auto parentIndices = std::vector<std::uint32_t>( numberOfDistinctDigests );
+    std::iota( parentIndices.begin(), parentIndices.end(), 0 );
+
+    for ( auto const& blockLinks : blocksLinks )
+    {
+        for ( auto const& [firstIdx, secondIdx] : blockLinks.links )
+        {
+            auto const firstRoot = findRoot( parentIndices, firstIdx );
+            auto const secondRoot = findRoot( parentIndices, secondIdx );
+            if ( firstRoot != secondRoot )
+            {
+                parentIndices[std::max( firstRoot, secondRoot )] = std::min( firstRoot, secondRoot );
+            }
+        }
+
+        similarityClusters.numberOfComparisons += blockLinks.numberOfComparisons;
+    }
+
+    // Clusters are numbered in the order of their first items.
+    auto const noCluster = std::numeric_limits<std::uint32_t>::max();
+    auto clusterIndicesOfRoots = std::vector<std::uint32_t>( numberOfDistinctDigests, noCluster );
+
+    auto& clusterIndicesOfItems = similarityClusters.clusterIndicesOfItems;
+    clusterIndicesOfItems.resize( getNumberOfItems() );
+
+    for ( auto itemIdx = std::uint32_t{ 0 }; itemIdx < getNumberOfItems(); itemIdx++ )
+    {
+        auto& clusterIdx = clusterIndicesOfRoots[findRoot( parentIndices, m_distinctDigestIndicesOfItems[itemIdx] )];
+        if ( clusterIdx == noCluster )
+        {
+            clusterIdx = similarityClusters.numberOfClusters++;
+        }
+
+        clusterIndicesOfItems[itemIdx] = clusterIdx;
+    }
+
+    return similarityClusters;
+}
\ No newline at end of file
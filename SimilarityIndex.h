@@ -0,0 +1,100 @@
+
+#ifndef SIMILARITYINDEX_H
+#define SIMILARITYINDEX_H
+
+#include "SimilarityDigest.h"
+
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+struct SimilarNeighbour
+{
+    std::uint32_t    itemIdx = 0;
+    std::uint32_t    distance = 0;
+};
+
+struct SimilarityClusters
+{
+    // The cluster of every item; clusters are numbered in the order of
+    // their first items.
+    std::vector<std::uint32_t>    clusterIndicesOfItems;
+    std::uint32_t                 numberOfClusters = 0;
+    std::uint64_t                 numberOfComparisons = 0;
+};
+
+// Finds the items whose similarity digests lie near a query without
+// comparing against every item, by bit sampling locality sensitive hashing.
+// Each of 32 hash tables keys the digests on the codes of ten buckets picked
+// at random, so two digests share a key in a table with a probability that
+// falls off steeply with the number of buckets they differ in. A query only
+// compares the digests sharing a key with it in at least one table.
+//
+// Digests differing in 25 of the 128 buckets are found with a probability of
+// 97%, ones differing in 35 with 69%; every differing bucket adds at least
+// one to the distance. Equal digests are stored once, so a corpus holding
+// many copies of a file costs no more than one holding a single copy.
+class SimilarityIndex
+{
+public:
+    static constexpr auto numberOfHashTables = std::size_t{ 32 };
+    static constexpr auto numberOfSampledBuckets = std::size_t{ 10 };
+
+    // Items are numbered in the order of the digests.
+    explicit SimilarityIndex( std::vector<SimilarityDigest> const& similarityDigests );
+
+    std::uint32_t
+    getNumberOfItems() const
+    {
+        return static_cast<std::uint32_t>( m_distinctDigestIndicesOfItems.size() );
+    }
+
+    SimilarityDigest const&
+    getDigest( std::uint32_t const itemIdx ) const
+    {
+        return m_distinctDigests[m_distinctDigestIndicesOfItems[itemIdx]];
+    }
+
+    // The items within maximumDistance of the digest, nearest first and then
+    // by index. Only the first maximumBucketScanSize digests of every key are
+    // compared, which bounds the cost of a query in a corpus dominated by one
+    // family of files.
+    std::vector<SimilarNeighbour>
+    findNeighbours( SimilarityDigest const& queryDigest,
+                    std::uint32_t const maximumDistance,
+                    std::size_t const maximumBucketScanSize = std::numeric_limits<std::size_t>::max() ) const;
+
+    // Single linkage clusters of the items: two items share a cluster when a
+    // chain of items, each within maximumDistance of the next, joins them.
+    // Keys shared by over maximumBucketScanSize digests are sampled, so a
+    // link may be missed where it rests on one table alone.
+    SimilarityClusters
+    clusterItems( std::uint32_t const maximumDistance,
+                  std::size_t const maximumBucketScanSize = 256 ) const;
+
+private:
+    // Calls onCandidate( distinctDigestIdx ) for every distinct digest
+    // sharing a key with the query, possibly more than once.
+    template <typename CandidateFunction>
+    void
+    forEachCandidate( SimilarityDigest const& queryDigest,
+                      std::size_t const maximumBucketScanSize,
+                      CandidateFunction const& onCandidate ) const;
+
+private:
+    std::vector<SimilarityDigest>                                      m_distinctDigests;
+    std::vector<std::uint32_t>                                         m_distinctDigestIndicesOfItems;
+    std::vector<std::uint32_t>                                         m_itemOffsets;
+    std::vector<std::uint32_t>                                         m_itemIndices;
+
+    // The key in the high half and the distinct digest in the low half,
+    // sorted, so the digests of a key are a contiguous run. The directory of
+    // a table holds where the keys of every prefix start, so finding a key
+    // takes two reads and a short search rather than a search of the table.
+    std::array<std::vector<std::uint64_t>, numberOfHashTables>        m_hashTables;
+    std::array<std::vector<std::uint32_t>, numberOfHashTables>        m_directories;
+    std::uint32_t                                                      m_keyPrefixShift = 0;
+};
+
+#endif // SIMILARITYINDEX_H
\ No newline at end of file
@@ -0,0 +1,515 @@
+
+#include "StringExtraction.h"
+
+#include "Instrumentation.h"
+#include "ParallelFor.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <functional>
+
+#if defined( __SSE2__ ) or defined( _M_X64 )
+#include <emmintrin.h>
+#define EWEA_HAS_SSE2 1
+#endif
+
+namespace
+{
+    auto const blockSizeInBytes = std::size_t{ 64 };
+    auto const evenBitsMask = std::uint64_t{ 0x5555555555555555 };
+
+    struct CharacterMasks
+    {
+        std::uint64_t    printable;
+        std::uint64_t    zero;
+    };
+
+    bool
+    isPrintableCharacter( unsigned char const character )
+    {
+        return ( character >= 0x20 and character <= 0x7E ) or character == '\t';
+    }
+
+    CharacterMasks
+    computeCharacterMasksScalar( unsigned char const* bytes,
+                                 std::size_t const numberOfBytes )
+    {
+        auto characterMasks = CharacterMasks{ .printable = 0, .zero = 0 };
+
+        for ( auto i = std::size_t{ 0 }; i < numberOfBytes; i++ )
+        {
+            characterMasks.printable |= std::uint64_t{ isPrintableCharacter( bytes[i] ) } << i;
+            characterMasks.zero |= std::uint64_t{ bytes[i] == 0 } << i;
+        }
+
+        return characterMasks;
+    }
+
+    // One bit per byte of a full 64-byte block: bit i of printable is set when
+    // byte i is in 0x20..0x7E or a tab, bit i of zero when byte i is NUL.
+    CharacterMasks
+    computeCharacterMasks( unsigned char const* bytes )
+    {
+#ifdef EWEA_HAS_SSE2
+        auto const lowerBound = _mm_set1_epi8( 0x1F );
+        auto const upperBound = _mm_set1_epi8( 0x7F );
+        auto const tab = _mm_set1_epi8( '\t' );
+        auto const zero = _mm_setzero_si128();
+
+        auto characterMasks = CharacterMasks{ .printable = 0, .zero = 0 };
+
+        for ( auto i = 0; i < 4; i++ )
+        {
+            auto const characters = _mm_loadu_si128( reinterpret_cast<__m128i const*>( bytes + 16 * i ) );
+
+            // Signed compares: bytes >= 0x80 are negative and fail the lower bound.
+            auto const isPrintable =
+                _mm_or_si128( _mm_and_si128( _mm_cmpgt_epi8( characters, lowerBound ),
+                                             _mm_cmplt_epi8( characters, upperBound ) ),
+                              _mm_cmpeq_epi8( characters, tab ) );
+
+            characterMasks.printable |=
+                std::uint64_t{ static_cast<std::uint16_t>( _mm_movemask_epi8( isPrintable ) ) } << ( 16 * i );
+            characterMasks.zero |=
+                std::uint64_t{ static_cast<std::uint16_t>( _mm_movemask_epi8( _mm_cmpeq_epi8( characters, zero ) ) ) } << ( 16 * i );
+        }
+
+        return characterMasks;
+#else
+        return computeCharacterMasksScalar( bytes, blockSizeInBytes );
+#endif
+    }
+
+    class RunTracker
+    {
+    public:
+        explicit RunTracker( std::uint64_t const minimumRunLengthInBits )
+        : m_minimumRunLengthInBits( minimumRunLengthInBits )
+        {
+        }
+
+        // Feeds the mask of the block starting at blockOffset and calls
+        // onRunEnded( runStart, runEnd ) for each run of set bits that ends
+        // inside it. A run reaching the end of the block stays open. Runs
+        // shorter than the minimum may or may not be reported.
+        template <typename RunEndedCallback>
+        void
+        feed( std::uint64_t mask,
+              std::uint64_t const blockOffset,
+              RunEndedCallback const& onRunEnded )
+        {
+            if ( mask == ( m_isInRun ? ~std::uint64_t{ 0 } : 0 ) )
+            {
+                return;
+            }
+
+            mask = dropShortRunsInsideBlock( mask );
+
+            auto bit = 0;
+
+            while ( bit < 64 )
+            {
+                auto const remainingMask = mask >> bit;
+
+                if ( not m_isInRun )
+                {
+                    if ( remainingMask == 0 )
+                    {
+                        return;
+                    }
+
+                    bit += std::countr_zero( remainingMask );
+                    m_runStart = blockOffset + bit;
+                    m_isInRun = true;
+                }
+                else
+                {
+                    bit += std::countr_one( remainingMask );
+
+                    if ( bit >= 64 )
+                    {
+                        return;
+                    }
+
+                    onRunEnded( m_runStart, blockOffset + bit );
+                    m_isInRun = false;
+                }
+            }
+        }
+
+        template <typename RunEndedCallback>
+        void
+        finish( std::uint64_t const endOffset,
+                RunEndedCallback const& onRunEnded )
+        {
+            if ( m_isInRun )
+            {
+                onRunEnded( m_runStart, endOffset );
+                m_isInRun = false;
+            }
+        }
+
+    private:
+        // Most printable runs in binary data are a few bytes long. Clearing
+        // the runs that lie entirely inside the block and are too short keeps
+        // the bit-by-bit walk above for the runs that are reported.
+        std::uint64_t
+        dropShortRunsInsideBlock( std::uint64_t const mask ) const
+        {
+            if ( m_minimumRunLengthInBits <= 1 )
+            {
+                return mask;
+            }
+
+            // Bit i of windowStarts is set when bits i .. i + minimum - 1 are all
+            // set; the windows are widened by doubling, then smeared back over
+            // the bits they cover the same way.
+            auto windowStarts = m_minimumRunLengthInBits <= 64 ? mask : 0;
+            auto windowLength = std::uint64_t{ 1 };
+            for ( ; windowLength * 2 <= m_minimumRunLengthInBits; windowLength *= 2 )
+            {
+                windowStarts &= windowStarts >> windowLength;
+            }
+            windowStarts &= windowStarts >> ( m_minimumRunLengthInBits - windowLength );
+
+            auto longRuns = windowStarts;
+            for ( windowLength = 1; windowLength * 2 <= m_minimumRunLengthInBits; windowLength *= 2 )
+            {
+                longRuns |= longRuns << windowLength;
+            }
+            longRuns |= longRuns << ( m_minimumRunLengthInBits - windowLength );
+
+            // Runs touching either end of the block continue in a neighbouring
+            // block, so they are kept whatever their length here.
+            auto const lowRunLength = std::countr_one( mask );
+            auto const highRunLength = std::countl_one( mask );
+            auto const lowRun = lowRunLength == 0 ? 0 : ~std::uint64_t{ 0 } >> ( 64 - lowRunLength );
+            auto const highRun = highRunLength == 0 ? 0 : ~std::uint64_t{ 0 } << ( 64 - highRunLength );
+
+            return longRuns | ( m_isInRun ? lowRun : 0 ) | highRun;
+        }
+
+    private:
+        std::uint64_t    m_minimumRunLengthInBits;
+        std::uint64_t    m_runStart = 0;
+        bool             m_isInRun = false;
+    };
+
+    void
+    extractStringsFromRegion( PE::ByteReader const& regionBytes,
+                              std::uint32_t const regionIdx,
+                              std::uint64_t const regionFileOffset,
+                              StringExtractionOptions const& extractionOptions,
+                              ExtractedStrings& asciiStrings,
+                              ExtractedStrings& utf16LEStrings )
+    {
+        auto const bytes = regionBytes.data();
+        auto const minimumLengthInCharacters = std::uint64_t{ std::max( extractionOptions.minimumLengthInCharacters, 1u ) };
+
+        auto const addASCIIString =
+            [&]( std::uint64_t const runStart, std::uint64_t const runEnd )
+            {
+                if ( runEnd - runStart < minimumLengthInCharacters )
+                {
+                    return;
+                }
+
+                asciiStrings.strings.push_back( ExtractedString
+                                                    {
+                                                        .fileOffset = regionFileOffset + runStart,
+                                                        .textOffset = asciiStrings.textPool.size(),
+                                                        .lengthInCharacters = static_cast<std::uint32_t>( runEnd - runStart ),
+                                                        .regionIdx = regionIdx,
+                                                        .encoding = StringEncoding::ASCII
+                                                    } );
+                asciiStrings.textPool.append( reinterpret_cast<char const*>( bytes + runStart ), runEnd - runStart );
+                asciiStrings.textPool.push_back( '\0' );
+            };
+
+        auto const addUTF16LEString =
+            [&]( std::uint64_t const runStart, std::uint64_t const runEnd )
+            {
+                auto const lengthInCharacters = ( runEnd - runStart ) / 2;
+
+                if ( lengthInCharacters < minimumLengthInCharacters )
+                {
+                    return;
+                }
+
+                utf16LEStrings.strings.push_back( ExtractedString
+                                                    {
+                                                        .fileOffset = regionFileOffset + runStart,
+                                                        .textOffset = utf16LEStrings.textPool.size(),
+                                                        .lengthInCharacters = static_cast<std::uint32_t>( lengthInCharacters ),
+                                                        .regionIdx = regionIdx,
+                                                        .encoding = StringEncoding::UTF16LE
+                                                    } );
+
+                for ( auto i = runStart; i < runEnd; i += 2 )
+                {
+                    utf16LEStrings.textPool.push_back( static_cast<char>( bytes[i] ) );
+                }
+                utf16LEStrings.textPool.push_back( '\0' );
+            };
+
+        auto asciiRunTracker = RunTracker{ minimumLengthInCharacters };
+        auto utf16LERunTracker = RunTracker{ 2 * minimumLengthInCharacters };
+
+        auto const processBlock =
+            [&]( CharacterMasks const& characterMasks, std::uint64_t const blockOffset )
+            {
+                if ( extractionOptions.shouldFindASCII )
+                {
+                    asciiRunTracker.feed( characterMasks.printable, blockOffset, addASCIIString );
+                }
+
+                if ( extractionOptions.shouldFindUTF16LE )
+                {
+                    // A UTF-16LE character starts at an even offset with a printable
+                    // low byte and a zero high byte; mark both of its bytes so that
+                    // consecutive characters form one run.
+                    auto const utf16LECharacterStarts = characterMasks.printable & ( characterMasks.zero >> 1 ) & evenBitsMask;
+                    utf16LERunTracker.feed( utf16LECharacterStarts | ( utf16LECharacterStarts << 1 ), blockOffset, addUTF16LEString );
+                }
+            };
+
+        auto const numberOfBytes = regionBytes.size();
+        auto blockOffset = std::uint64_t{ 0 };
+
+        for ( ; blockOffset + blockSizeInBytes <= numberOfBytes; blockOffset += blockSizeInBytes )
+        {
+            processBlock( computeCharacterMasks( bytes + blockOffset ), blockOffset );
+        }
+
+        if ( blockOffset < numberOfBytes )
+        {
+            processBlock( computeCharacterMasksScalar( bytes + blockOffset, numberOfBytes - blockOffset ), blockOffset );
+        }
+
+        asciiRunTracker.finish( numberOfBytes, addASCIIString );
+        utf16LERunTracker.finish( numberOfBytes & ~std::uint64_t{ 1 }, addUTF16LEString );
+    }
+}
+
+std::vector<StringScanRegion>
+getStringScanRegions( EXEFile const& loadedEXEFile )
+{
+    auto stringScanRegions = std::vector<StringScanRegion>{};
+
+    for ( auto const& [sectionName, sectionHeader] : loadedEXEFile.sectionHeadersNameToInfo )
+    {
+        stringScanRegions.push_back( StringScanRegion
+                                     {
+                                         .name = sectionName,
+                                         .fileOffset = sectionHeader.pointerToRawData,
+                                         .sizeInBytes = sectionHeader.sizeOfRawDataInBytes,
+                                         .rva = sectionHeader.sectionBaseAddressInMemory
+                                     } );
+    }
+
+    std::sort( stringScanRegions.begin(), stringScanRegions.end(),
+               []( StringScanRegion const& lhs, StringScanRegion const& rhs )
+               {
+                   return lhs.fileOffset < rhs.fileOffset;
+               } );
+
+    return stringScanRegions;
+}
+
+std::vector<StringScanRegion>
+getStringScanRegions( OBJFile const& loadedOBJFile )
+{
+    auto stringScanRegions = std::vector<StringScanRegion>{};
+
+    for ( auto const& [sectionName, sectionHeaders] : loadedOBJFile.sectionHeaders )
+    {
+        for ( auto const& sectionHeader : sectionHeaders )
+        {
+            stringScanRegions.push_back( StringScanRegion
+                                         {
+                                             .name = sectionName,
+                                             .fileOffset = sectionHeader.pointerToRawData,
+                                             .sizeInBytes = sectionHeader.sizeOfRawDataInBytes,
+                                             .rva = std::nullopt
+                                         } );
+        }
+    }
+
+    std::sort( stringScanRegions.begin(), stringScanRegions.end(),
+               []( StringScanRegion const& lhs, StringScanRegion const& rhs )
+               {
+                   return lhs.fileOffset < rhs.fileOffset;
+               } );
+
+    return stringScanRegions;
+}
+
+ExtractedStrings
+extractStrings( PE::ByteReader const& rawBytes,
+                std::vector<StringScanRegion> regions,
+                StringExtractionOptions const& extractionOptions )
+{
+    auto const stringsTimer = Instrumentation::ScopedTimer{ "Strings" };
+
+    // Regions that point past the end of the file are scanned up to its end.
+    for ( auto& region : regions )
+    {
+        region.fileOffset = std::min<std::uint64_t>( region.fileOffset, rawBytes.size() );
+        region.sizeInBytes = std::min<std::uint64_t>( region.sizeInBytes, rawBytes.size() - region.fileOffset );
+    }
+
+    auto asciiStringsOfRegions = std::vector<ExtractedStrings>( regions.size() );
+    auto utf16LEStringsOfRegions = std::vector<ExtractedStrings>( regions.size() );
+
+    parallelFor( regions.size(),
+                 [&]( std::size_t const regionIdx )
+                 {
+                     auto const& region = regions[regionIdx];
+
+                     extractStringsFromRegion( *rawBytes.subReader( region.fileOffset, region.sizeInBytes ),
+                                               static_cast<std::uint32_t>( regionIdx ),
+                                               region.fileOffset,
+                                               extractionOptions,
+                                               asciiStringsOfRegions[regionIdx],
+                                               utf16LEStringsOfRegions[regionIdx] );
+                 } );
+
+    auto numberOfStrings = std::size_t{ 0 };
+    auto textPoolSizeInBytes = std::size_t{ 0 };
+    for ( auto regionIdx = std::size_t{ 0 }; regionIdx < regions.size(); regionIdx++ )
+    {
+        numberOfStrings += asciiStringsOfRegions[regionIdx].strings.size() + utf16LEStringsOfRegions[regionIdx].strings.size();
+        textPoolSizeInBytes += asciiStringsOfRegions[regionIdx].textPool.size() + utf16LEStringsOfRegions[regionIdx].textPool.size();
+    }
+
+    auto extractedStrings = ExtractedStrings{};
+    extractedStrings.strings.reserve( numberOfStrings );
+    extractedStrings.textPool.reserve( textPoolSizeInBytes );
+
+    auto const appendString =
+        [&extractedStrings]( ExtractedStrings const& partialStrings,
+                             ExtractedString extractedString )
+        {
+            auto const text = getStringText( partialStrings, extractedString );
+
+            extractedString.textOffset = extractedStrings.textPool.size();
+            extractedStrings.textPool.append( text );
+            extractedStrings.textPool.push_back( '\0' );
+            extractedStrings.strings.push_back( extractedString );
+        };
+
+    // Each encoding is found in offset order and their runs cannot overlap,
+    // so a merge restores the offset order. Copying the texts in that order
+    // keeps the pool in string order, which findStringsContaining relies on.
+    for ( auto regionIdx = std::size_t{ 0 }; regionIdx < regions.size(); regionIdx++ )
+    {
+        auto const& asciiStrings = asciiStringsOfRegions[regionIdx];
+        auto const& utf16LEStrings = utf16LEStringsOfRegions[regionIdx];
+
+        auto asciiIdx = std::size_t{ 0 };
+        auto utf16LEIdx = std::size_t{ 0 };
+
+        while ( asciiIdx < asciiStrings.strings.size() or utf16LEIdx < utf16LEStrings.strings.size() )
+        {
+            if (    utf16LEIdx == utf16LEStrings.strings.size()
+                 or (     asciiIdx < asciiStrings.strings.size()
+                      and asciiStrings.strings[asciiIdx].fileOffset < utf16LEStrings.strings[utf16LEIdx].fileOffset ) )
+            {
+                appendString( asciiStrings, asciiStrings.strings[asciiIdx++] );
+            }
+            else
+            {
+                appendString( utf16LEStrings, utf16LEStrings.strings[utf16LEIdx++] );
+            }
+        }
+    }
+
+    extractedStrings.regions = std::move( regions );
+
+    Instrumentation::addToCounter( Instrumentation::Counter::Allocations, 4 * extractedStrings.regions.size() + 2 );
+
+    return extractedStrings;
+}
+
+std::string_view
+getStringText( ExtractedStrings const& extractedStrings,
+               ExtractedString const& extractedString )
+{
+    return std::string_view{ extractedStrings.textPool }.substr( extractedString.textOffset,
+                                                                 extractedString.lengthInCharacters );
+}
+
+std::optional<std::uint32_t>
+getStringRVA( ExtractedStrings const& extractedStrings,
+              ExtractedString const& extractedString )
+{
+    auto const& region = extractedStrings.regions[extractedString.regionIdx];
+
+    if ( not region.rva )
+    {
+        return std::nullopt;
+    }
+
+    return static_cast<std::uint32_t>( *region.rva + ( extractedString.fileOffset - region.fileOffset ) );
+}
+
+std::vector<std::size_t>
+findStringsContaining( ExtractedStrings const& extractedStrings,
+                       std::string_view const needle )
+{
+    auto matchingStringIndices = std::vector<std::size_t>{};
+    auto const& strings = extractedStrings.strings;
+
+    if ( needle.empty() )
+    {
+        matchingStringIndices.resize( strings.size() );
+        for ( auto i = std::size_t{ 0 }; i < strings.size(); i++ )
+        {
+            matchingStringIndices[i] = i;
+        }
+
+        return matchingStringIndices;
+    }
+
+    auto const& textPool = extractedStrings.textPool;
+    auto const searcher = std::boyer_moore_horspool_searcher{ needle.begin(), needle.end() };
+    auto searchFrom = textPool.begin();
+
+    while ( true )
+    {
+        auto const match = std::search( searchFrom, textPool.end(), searcher );
+
+        if ( match == textPool.end() )
+        {
+            return matchingStringIndices;
+        }
+
+        // The NUL separators keep a match inside one string, and the strings
+        // are stored in pool order.
+        auto const matchOffset = static_cast<std::uint64_t>( match - textPool.begin() );
+        auto const matchingString =
+            std::partition_point( strings.begin(), strings.end(),
+                                  [matchOffset]( ExtractedString const& extractedString )
+                                  {
+                                      return extractedString.textOffset <= matchOffset;
+                                  } ) - 1;
+
+        matchingStringIndices.push_back( static_cast<std::size_t>( matchingString - strings.begin() ) );
+        searchFrom = textPool.begin() + matchingString->textOffset + matchingString->lengthInCharacters + 1;
+    }
+}
+
+std::string
+getStringEncodingName( StringEncoding const stringEncoding )
+{
+    switch ( stringEncoding )
+    {
+        case StringEncoding::ASCII:
+            return "ascii";
+        case StringEncoding::UTF16LE:
+            return "utf16le";
+        default:
+            return "<Unknown encoding>";
+    }
+}
\ No newline at end of file
@@ -0,0 +1,82 @@
+
+#ifndef STRINGEXTRACTION_H
+#define STRINGEXTRACTION_H
+
+#include "PEFiles.h"
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+enum class StringEncoding : std::uint8_t
+{
+    ASCII,
+    UTF16LE
+};
+
+struct StringScanRegion
+{
+    std::string                     name;
+    std::uint64_t                   fileOffset;
+    std::uint64_t                   sizeInBytes;
+    std::optional<std::uint32_t>    rva;
+};
+
+struct ExtractedString
+{
+    std::uint64_t     fileOffset;
+    std::uint64_t     textOffset;
+    std::uint32_t     lengthInCharacters;
+    std::uint32_t     regionIdx;
+    StringEncoding    encoding;
+};
+
+// The texts of all strings live in one pool, each followed by a NUL, so a
+// search is a single pass over the pool rather than one per string.
+struct ExtractedStrings
+{
+    std::vector<StringScanRegion>    regions;
+    std::vector<ExtractedString>     strings;
+    std::string                      textPool;
+};
+
+struct StringExtractionOptions
+{
+    std::uint32_t    minimumLengthInCharacters = 4;
+    bool             shouldFindASCII = true;
+    bool             shouldFindUTF16LE = true;
+};
+
+std::vector<StringScanRegion>
+getStringScanRegions( EXEFile const& loadedEXEFile );
+
+std::vector<StringScanRegion>
+getStringScanRegions( OBJFile const& loadedOBJFile );
+
+// Finds runs of printable ASCII characters (and tabs), stored as bytes or as
+// UTF-16LE code units, in every region. Regions are scanned in parallel and
+// the strings are returned ordered by region, then by file offset.
+ExtractedStrings
+extractStrings( PE::ByteReader const& rawBytes,
+                std::vector<StringScanRegion> regions,
+                StringExtractionOptions const& extractionOptions = {} );
+
+std::string_view
+getStringText( ExtractedStrings const& extractedStrings,
+               ExtractedString const& extractedString );
+
+std::optional<std::uint32_t>
+getStringRVA( ExtractedStrings const& extractedStrings,
+              ExtractedString const& extractedString );
+
+// Returns the indices of the strings containing the needle, in order.
+std::vector<std::size_t>
+findStringsContaining( ExtractedStrings const& extractedStrings,
+                       std::string_view const needle );
+
+std::string
+getStringEncodingName( StringEncoding const stringEncoding );
+
+#endif // STRINGEXTRACTION_H
\ No newline at end of file
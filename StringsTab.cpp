@@ -0,0 +1,211 @@
+
+#include "StringsTab.h"
+
+#include <QFile>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QLabel>
+#include <QLineEdit>
+#include <QTableView>
+#include <QTimer>
+#include <QVBoxLayout>
+
+#include <utility>
+
+namespace
+{
+    enum StringsColumn
+    {
+        FileOffsetColumn,
+        RVAColumn,
+        SectionColumn,
+        EncodingColumn,
+        TextColumn,
+        NumberOfStringsColumns
+    };
+
+    // Typing into the filter restarts this delay, so a search over a large
+    // string pool runs once per pause rather than once per key stroke.
+    auto const filterDelayInMilliseconds = 200;
+}
+
+StringsTableModel::StringsTableModel( ExtractedStrings&& extractedStrings,
+                                      QObject* parentObject )
+: QAbstractTableModel( parentObject )
+, m_extractedStrings( std::move( extractedStrings ) )
+{
+}
+
+int
+StringsTableModel::rowCount( QModelIndex const& parentIndex ) const
+{
+    if ( parentIndex.isValid() )
+    {
+        return 0;
+    }
+
+    return static_cast<int>( m_isFiltered ? m_visibleStringIndices.size() : m_extractedStrings.strings.size() );
+}
+
+int
+StringsTableModel::columnCount( QModelIndex const& parentIndex ) const
+{
+    return parentIndex.isValid() ? 0 : NumberOfStringsColumns;
+}
+
+QVariant
+StringsTableModel::data( QModelIndex const& index,
+                         int const role ) const
+{
+    if ( not index.isValid() or role != Qt::DisplayRole )
+    {
+        return QVariant();
+    }
+
+    auto const stringIdx =
+        m_isFiltered ? m_visibleStringIndices[index.row()] : static_cast<std::size_t>( index.row() );
+    auto const& extractedString = m_extractedStrings.strings[stringIdx];
+
+    switch ( index.column() )
+    {
+        case FileOffsetColumn:
+            return QString( "0x%1" ).arg( extractedString.fileOffset, 8, 16, QChar( '0' ) );
+        case RVAColumn:
+        {
+            auto const rva = getStringRVA( m_extractedStrings, extractedString );
+            return rva ? QString( "0x%1" ).arg( *rva, 8, 16, QChar( '0' ) ) : QString( "-" );
+        }
+        case SectionColumn:
+            return QString::fromStdString( m_extractedStrings.regions[extractedString.regionIdx].name );
+        case EncodingColumn:
+            return QString::fromStdString( getStringEncodingName( extractedString.encoding ) );
+        case TextColumn:
+        {
+            auto const text = getStringText( m_extractedStrings, extractedString );
+            return QString::fromLatin1( text.data(), static_cast<qsizetype>( text.size() ) );
+        }
+        default:
+            return QVariant();
+    }
+}
+
+QVariant
+StringsTableModel::headerData( int const section,
+                               Qt::Orientation const orientation,
+                               int const role ) const
+{
+    if ( orientation != Qt::Horizontal or role != Qt::DisplayRole )
+    {
+        return QVariant();
+    }
+
+    switch ( section )
+    {
+        case FileOffsetColumn:
+            return QString( "File offset" );
+        case RVAColumn:
+            return QString( "RVA" );
+        case SectionColumn:
+            return QString( "Section" );
+        case EncodingColumn:
+            return QString( "Encoding" );
+        case TextColumn:
+            return QString( "Text" );
+        default:
+            return QVariant();
+    }
+}
+
+void
+StringsTableModel::setFilter( QString const& filterText )
+{
+    beginResetModel();
+
+    m_isFiltered = not filterText.isEmpty();
+    m_visibleStringIndices =
+        m_isFiltered ? findStringsContaining( m_extractedStrings, filterText.toStdString() ) : std::vector<std::size_t>{};
+
+    endResetModel();
+}
+
+std::size_t
+StringsTableModel::getNumberOfStrings() const
+{
+    return m_extractedStrings.strings.size();
+}
+
+StringsTab::StringsTab( QString const& pathOfFile,
+                        std::vector<StringScanRegion>&& stringScanRegions,
+                        QWidget* parentWidget )
+: QWidget( parentWidget )
+{
+    auto stringsTabMainLayout = new QVBoxLayout( this );
+
+    auto filterLayout = new QHBoxLayout;
+    stringsTabMainLayout->addLayout( filterLayout );
+
+    m_filterInput = new QLineEdit;
+    m_filterInput->setPlaceholderText( "Show strings containing..." );
+    filterLayout->addWidget( m_filterInput );
+
+    m_numberOfStringsLabel = new QLabel;
+    filterLayout->addWidget( m_numberOfStringsLabel );
+
+    // The strings are copied out of the mapping, so it is only needed while
+    // they are being extracted.
+    auto mappedFile = QFile( pathOfFile );
+    auto const mappedBytes =
+        mappedFile.open( QIODevice::ReadOnly ) ? mappedFile.map( 0, mappedFile.size() ) : nullptr;
+
+    if ( mappedBytes == nullptr )
+    {
+        stringsTabMainLayout->addWidget( new QLabel( QString( "'%1' could not be mapped: %2" )
+                                                         .arg( pathOfFile )
+                                                         .arg( mappedFile.errorString() ) ) );
+        return;
+    }
+
+    m_stringsTableModel =
+        new StringsTableModel( extractStrings( PE::ByteReader{ mappedBytes, static_cast<std::size_t>( mappedFile.size() ) },
+                                               std::move( stringScanRegions ) ),
+                               this );
+    mappedFile.unmap( mappedBytes );
+
+    auto stringsTableView = new QTableView;
+    stringsTableView->setModel( m_stringsTableModel );
+    stringsTableView->setSelectionBehavior( QAbstractItemView::SelectRows );
+    stringsTableView->setWordWrap( false );
+    stringsTableView->verticalHeader()->hide();
+    stringsTableView->verticalHeader()->setSectionResizeMode( QHeaderView::Fixed );
+    stringsTableView->verticalHeader()->setDefaultSectionSize( stringsTableView->fontMetrics().height() + 4 );
+    stringsTableView->horizontalHeader()->setStretchLastSection( true );
+    stringsTabMainLayout->addWidget( stringsTableView );
+
+    m_filterDelayTimer = new QTimer( this );
+    m_filterDelayTimer->setSingleShot( true );
+    m_filterDelayTimer->setInterval( filterDelayInMilliseconds );
+
+    connect( m_filterDelayTimer, &QTimer::timeout,
+             [this]()
+             {
+                applyFilter();
+             } );
+
+    connect( m_filterInput, &QLineEdit::textChanged,
+             [this]()
+             {
+                m_filterDelayTimer->start();
+             } );
+
+    applyFilter();
+}
+
+void
+StringsTab::applyFilter()
+{
+    m_stringsTableModel->setFilter( m_filterInput->text() );
+
+    m_numberOfStringsLabel->setText( QString( "%1 of %2 strings" )
+                                         .arg( m_stringsTableModel->rowCount() )
+                                         .arg( m_stringsTableModel->getNumberOfStrings() ) );
+}
\ No newline at end of file
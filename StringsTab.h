@@ -0,0 +1,76 @@
+
+#ifndef STRINGSTAB_H
+#define STRINGSTAB_H
+
+#include "StringExtraction.h"
+
+#include <QAbstractTableModel>
+#include <QPointer>
+#include <QWidget>
+
+#include <cstddef>
+#include <vector>
+
+class QLabel;
+class QLineEdit;
+class QTimer;
+
+// Presents extracted strings to a QTableView without creating an item per
+// string; the view only asks for the rows it is painting. The model shows
+// either all strings or the subset matching the current filter.
+class StringsTableModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    explicit StringsTableModel( ExtractedStrings&& extractedStrings,
+                                QObject* parentObject = nullptr );
+
+    int
+    rowCount( QModelIndex const& parentIndex = QModelIndex() ) const override;
+
+    int
+    columnCount( QModelIndex const& parentIndex = QModelIndex() ) const override;
+
+    QVariant
+    data( QModelIndex const& index,
+          int const role = Qt::DisplayRole ) const override;
+
+    QVariant
+    headerData( int const section,
+                Qt::Orientation const orientation,
+                int const role = Qt::DisplayRole ) const override;
+
+    void
+    setFilter( QString const& filterText );
+
+    std::size_t
+    getNumberOfStrings() const;
+
+private:
+    ExtractedStrings            m_extractedStrings;
+    std::vector<std::size_t>    m_visibleStringIndices;
+    bool                        m_isFiltered = false;
+};
+
+class StringsTab : public QWidget
+{
+    Q_OBJECT
+
+public:
+    StringsTab( QString const& pathOfFile,
+                std::vector<StringScanRegion>&& stringScanRegions,
+                QWidget* parentWidget = nullptr );
+
+private:
+    void
+    applyFilter();
+
+private:
+    QPointer<StringsTableModel>    m_stringsTableModel;
+    QPointer<QLineEdit>            m_filterInput;
+    QPointer<QLabel>               m_numberOfStringsLabel;
+    QPointer<QTimer>               m_filterDelayTimer;
+};
+
+#endif // STRINGSTAB_H
\ No newline at end of file
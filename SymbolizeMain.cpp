@@ -0,0 +1,339 @@
+
+#include "RVASymbolizer.h"
+
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace
+{
+    // Addresses are resolved in batches of this many, so that the searches
+    // of a batch interleave and the output is written in large blocks.
+    auto const numberOfAddressesPerBatch = std::size_t{ 1 } << 16;
+    auto const inputBlockSizeInBytes = std::size_t{ 1 } << 20;
+
+    auto const invalidAddress = std::numeric_limits<std::uint64_t>::max();
+
+    // Accepts hex with or without a 0x prefix and surrounding blanks; returns
+    // invalidAddress for anything else.
+    std::uint64_t
+    parseAddress( std::string_view line )
+    {
+        while ( not line.empty() and ( line.front() == ' ' or line.front() == '\t' ) )
+        {
+            line.remove_prefix( 1 );
+        }
+
+        while ( not line.empty() and ( line.back() == ' ' or line.back() == '\t' or line.back() == '\r' ) )
+        {
+            line.remove_suffix( 1 );
+        }
+
+        if ( line.starts_with( "0x" ) or line.starts_with( "0X" ) )
+        {
+            line.remove_prefix( 2 );
+        }
+
+        if ( line.empty() or line.size() > 16 )
+        {
+            return invalidAddress;
+        }
+
+        auto address = std::uint64_t{ 0 };
+        for ( auto const character : line )
+        {
+            auto digit = 0;
+            if ( character >= '0' and character <= '9' )
+            {
+                digit = character - '0';
+            }
+            else if ( character >= 'a' and character <= 'f' )
+            {
+                digit = character - 'a' + 10;
+            }
+            else if ( character >= 'A' and character <= 'F' )
+            {
+                digit = character - 'A' + 10;
+            }
+            else
+            {
+                return invalidAddress;
+            }
+
+            address = ( address << 4 ) | static_cast<std::uint64_t>( digit );
+        }
+
+        return address;
+    }
+
+    void
+    appendHexDigits( std::string& output,
+                     std::uint64_t const value,
+                     int const minimumNumberOfDigits )
+    {
+        char digits[16];
+        auto firstDigitIdx = 16;
+
+        for ( auto remainingValue = value; remainingValue != 0 or 16 - firstDigitIdx < minimumNumberOfDigits; remainingValue >>= 4 )
+        {
+            digits[--firstDigitIdx] = "0123456789ABCDEF"[remainingValue & 0xF];
+        }
+
+        output.append( digits + firstDigitIdx, digits + 16 );
+    }
+
+    struct SymbolizeTotals
+    {
+        std::uint64_t    numberOfAddresses = 0;
+        std::uint64_t    numberOfUnresolvedAddresses = 0;
+    };
+
+    class AddressBatch
+    {
+    public:
+        AddressBatch( RVASymbolizer const& rvaSymbolizer,
+                      std::uint64_t const baseAddress )
+        : m_rvaSymbolizer( rvaSymbolizer )
+        , m_baseAddress( baseAddress )
+        {
+            m_addresses.reserve( numberOfAddressesPerBatch );
+            m_rvas.reserve( numberOfAddressesPerBatch );
+        }
+
+        void
+        addLine( std::string_view const line,
+                 SymbolizeTotals& symbolizeTotals )
+        {
+            auto const address = parseAddress( line );
+            auto const isInImage =
+                address != invalidAddress and address >= m_baseAddress
+                and address - m_baseAddress <= std::numeric_limits<std::uint32_t>::max();
+
+            m_addresses.push_back( address );
+            m_rvas.push_back( isInImage ? static_cast<std::uint32_t>( address - m_baseAddress )
+                                        : std::numeric_limits<std::uint32_t>::max() );
+
+            if ( m_addresses.size() == numberOfAddressesPerBatch )
+            {
+                flush( symbolizeTotals );
+            }
+        }
+
+        // Prints "ADDRESS<TAB>SYMBOL+0xOFFSET" per address, with the symbol
+        // "?" when unresolved and "sub_RVA" for a function known only from
+        // .pdata.
+        void
+        flush( SymbolizeTotals& symbolizeTotals )
+        {
+            m_symbolIndices.resize( m_rvas.size() );
+            m_rvaSymbolizer.findSymbols( m_rvas, m_symbolIndices );
+
+            m_output.clear();
+
+            for ( auto i = std::size_t{ 0 }; i < m_addresses.size(); i++ )
+            {
+                if ( m_addresses[i] == invalidAddress )
+                {
+                    m_output += "invalid";
+                }
+                else
+                {
+                    m_output += "0x";
+                    appendHexDigits( m_output, m_addresses[i], m_baseAddress == 0 ? 8 : 16 );
+                }
+
+                m_output += '\t';
+
+                auto const symbolIdx = m_symbolIndices[i];
+                if ( symbolIdx == RVASymbolizer::unresolvedSymbolIdx )
+                {
+                    m_output += "?\n";
+                    symbolizeTotals.numberOfUnresolvedAddresses++;
+                    continue;
+                }
+
+                auto const symbolRVA = m_rvaSymbolizer.getSymbolRVA( symbolIdx );
+                auto const symbolName = m_rvaSymbolizer.getSymbolName( symbolIdx );
+
+                if ( symbolName.empty() )
+                {
+                    m_output += "sub_";
+                    appendHexDigits( m_output, symbolRVA, 8 );
+                }
+                else
+                {
+                    m_output += symbolName;
+                }
+
+                m_output += "+0x";
+                appendHexDigits( m_output, m_rvas[i] - symbolRVA, 1 );
+                m_output += '\n';
+            }
+
+            std::fwrite( m_output.data(), 1, m_output.size(), stdout );
+
+            symbolizeTotals.numberOfAddresses += m_addresses.size();
+            m_addresses.clear();
+            m_rvas.clear();
+        }
+
+    private:
+        RVASymbolizer const&          m_rvaSymbolizer;
+        std::uint64_t                 m_baseAddress;
+        std::vector<std::uint64_t>    m_addresses;
+        std::vector<std::uint32_t>    m_rvas;
+        std::vector<std::uint32_t>    m_symbolIndices;
+        std::string                   m_output;
+    };
+
+    SymbolizeTotals
+    symbolizeStream( std::FILE* const addressesInput,
+                     RVASymbolizer const& rvaSymbolizer,
+                     std::uint64_t const baseAddress )
+    {
+        auto symbolizeTotals = SymbolizeTotals{};
+        auto addressBatch = AddressBatch{ rvaSymbolizer, baseAddress };
+
+        // A line cut by the end of a block is carried over to the next one.
+        auto inputBlock = std::string( inputBlockSizeInBytes, '\0' );
+        auto carriedOverLine = std::string{};
+
+        while ( true )
+        {
+            auto const numberOfBytesRead = std::fread( inputBlock.data(), 1, inputBlock.size(), addressesInput );
+            if ( numberOfBytesRead == 0 )
+            {
+                break;
+            }
+
+            auto remainingInput = std::string_view( inputBlock.data(), numberOfBytesRead );
+
+            for ( auto lineEnd = remainingInput.find( '\n' ); lineEnd != std::string_view::npos; lineEnd = remainingInput.find( '\n' ) )
+            {
+                auto const line = remainingInput.substr( 0, lineEnd );
+                remainingInput.remove_prefix( lineEnd + 1 );
+
+                if ( not carriedOverLine.empty() )
+                {
+                    carriedOverLine += line;
+                    addressBatch.addLine( carriedOverLine, symbolizeTotals );
+                    carriedOverLine.clear();
+                }
+                else if ( not line.empty() )
+                {
+                    addressBatch.addLine( line, symbolizeTotals );
+                }
+            }
+
+            carriedOverLine += remainingInput;
+        }
+
+        if ( not carriedOverLine.empty() )
+        {
+            addressBatch.addLine( carriedOverLine, symbolizeTotals );
+        }
+
+        addressBatch.flush( symbolizeTotals );
+
+        return symbolizeTotals;
+    }
+}
+
+int
+main( int argCount, char** args )
+{
+    auto pathOfEXEFile = std::string{};
+    auto pathOfAddressesFile = std::string{};
+    auto baseAddress = std::uint64_t{ 0 };
+
+    try
+    {
+        for ( auto i = 1; i < argCount; i++ )
+        {
+            auto const argument = std::string{ args[i] };
+
+            if ( argument == "--base" and i + 1 < argCount )
+            {
+                baseAddress = parseAddress( args[++i] );
+                if ( baseAddress == invalidAddress )
+                {
+                    throw std::invalid_argument{ "The base address must be hex." };
+                }
+            }
+            else if ( argument.starts_with( "--" ) )
+            {
+                throw std::invalid_argument{ "Unknown option '" + argument + "'." };
+            }
+            else if ( pathOfEXEFile.empty() )
+            {
+                pathOfEXEFile = argument;
+            }
+            else if ( pathOfAddressesFile.empty() )
+            {
+                pathOfAddressesFile = argument;
+            }
+            else
+            {
+                throw std::invalid_argument{ "Too many arguments." };
+            }
+        }
+
+        if ( pathOfEXEFile.empty() )
+        {
+            throw std::invalid_argument{ "No image given." };
+        }
+    }
+    catch ( std::invalid_argument const& argumentError )
+    {
+        std::cerr << "ewea-symbolize: " << argumentError.what() << '\n'
+                  << "Usage: ewea-symbolize [--base ADDRESS] IMAGE.exe [ADDRESSES.txt]\n"
+                  << "Reads one hex address per line, from stdin when no file is given. Addresses are RVAs,\n"
+                  << "or virtual addresses of the image loaded at the --base address.\n";
+        return 1;
+    }
+
+    try
+    {
+        auto const buildStart = std::chrono::steady_clock::now();
+        auto const rvaSymbolizer = RVASymbolizer{ loadEXEFile( pathOfEXEFile ) };
+        auto const buildDuration = std::chrono::duration<double>( std::chrono::steady_clock::now() - buildStart );
+
+        auto addressesInput = stdin;
+        if ( not pathOfAddressesFile.empty() )
+        {
+            addressesInput = std::fopen( pathOfAddressesFile.c_str(), "rb" );
+            if ( addressesInput == nullptr )
+            {
+                throw std::runtime_error{ "Cannot open " + pathOfAddressesFile };
+            }
+        }
+
+        auto const symbolizeStart = std::chrono::steady_clock::now();
+        auto const symbolizeTotals = symbolizeStream( addressesInput, rvaSymbolizer, baseAddress );
+        auto const symbolizeDuration = std::chrono::duration<double>( std::chrono::steady_clock::now() - symbolizeStart );
+
+        if ( addressesInput != stdin )
+        {
+            std::fclose( addressesInput );
+        }
+
+        std::fflush( stdout );
+        std::fprintf( stderr, "%u symbols indexed in %.3f s; %llu addresses (%llu unresolved) in %.3f s, %.1f M/s\n",
+                      rvaSymbolizer.getNumberOfSymbols(), buildDuration.count(),
+                      static_cast<unsigned long long>( symbolizeTotals.numberOfAddresses ),
+                      static_cast<unsigned long long>( symbolizeTotals.numberOfUnresolvedAddresses ),
+                      symbolizeDuration.count(),
+                      symbolizeTotals.numberOfAddresses / symbolizeDuration.count() / 1e6 );
+    }
+    catch ( std::runtime_error const& loadError )
+    {
+        std::cerr << "ewea-symbolize: " << loadError.what() << '\n';
+        return 1;
+    }
+}
\ No newline at end of file
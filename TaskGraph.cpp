@@ -0,0 +1,208 @@
+
+#include "TaskGraph.h"
+
+#include "Instrumentation.h"
+#include "ParallelFor.h"
+#include "WorkerPool.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+
+TaskGraph::TaskIdx
+TaskGraph::addTask( std::function<void()>&& task,
+                    std::vector<TaskIdx> const& prerequisiteIndices )
+{
+    auto const taskIdx = m_tasks.size();
+
+    for ( auto const prerequisiteIdx : prerequisiteIndices )
+    {
+        if ( prerequisiteIdx >= taskIdx )
+        {
+            throw std::invalid_argument{ "A prerequisite must be added before the task waiting for it." };
+        }
+
+        m_tasks[prerequisiteIdx].dependentIndices.push_back( taskIdx );
+    }
+
+    m_tasks.push_back( Task
+                       {
+                           .function = std::move( task ),
+                           .numberOfPrerequisites = prerequisiteIndices.size()
+                       } );
+
+    return taskIdx;
+}
+
+namespace
+{
+    // Lives as long as the longest of the workers sharing it. A worker the
+    // pool starts only once run() has returned finds the run over and leaves
+    // without touching the graph.
+    struct RunState
+    {
+        std::mutex                          mutex;
+        std::condition_variable             stateChanged;
+        std::vector<TaskGraph::TaskIdx>     readyTaskIndices;
+        std::vector<std::size_t>            numberOfPendingPrerequisites;
+        std::size_t                         numberOfUnfinishedTasks = 0;
+        std::size_t                         numberOfActiveHelpers = 0;
+        std::exception_ptr                  firstException;
+        bool                                isStopped = false;
+        bool                                isOver = false;
+    };
+}
+
+void
+TaskGraph::run( std::stop_token const& stopToken )
+{
+    auto const runState = std::make_shared<RunState>();
+    runState->numberOfPendingPrerequisites.resize( m_tasks.size() );
+    runState->numberOfUnfinishedTasks = m_tasks.size();
+
+    for ( auto taskIdx = TaskIdx{ 0 }; taskIdx < m_tasks.size(); taskIdx++ )
+    {
+        runState->numberOfPendingPrerequisites[taskIdx] = m_tasks[taskIdx].numberOfPrerequisites;
+        if ( runState->numberOfPendingPrerequisites[taskIdx] == 0 )
+        {
+            runState->readyTaskIndices.push_back( taskIdx );
+        }
+    }
+
+    // Ready tasks are taken from the back, so that the dependents a task has
+    // just released run next, while the data it produced is still in cache.
+    std::reverse( runState->readyTaskIndices.begin(), runState->readyTaskIndices.end() );
+
+    auto const profileContext = Instrumentation::getCurrentProfileContext();
+
+    // Called with the lock held, and returns with it held.
+    auto const runTasks =
+        [this, &stopToken]( RunState& state, std::unique_lock<std::mutex>& lock )
+        {
+            while ( true )
+            {
+                state.stateChanged.wait( lock,
+                                         [&state]()
+                                         {
+                                             return    not state.readyTaskIndices.empty() or state.numberOfUnfinishedTasks == 0
+                                                    or state.firstException or state.isStopped;
+                                         } );
+
+                if ( not state.readyTaskIndices.empty() and stopToken.stop_requested() )
+                {
+                    state.isStopped = true;
+                    state.readyTaskIndices.clear();
+                    state.stateChanged.notify_all();
+                }
+
+                if ( state.readyTaskIndices.empty() )
+                {
+                    break;
+                }
+
+                auto const taskIdx = state.readyTaskIndices.back();
+                state.readyTaskIndices.pop_back();
+
+                lock.unlock();
+
+                auto taskException = std::exception_ptr{};
+                try
+                {
+                    m_tasks[taskIdx].function();
+                }
+                catch ( ... )
+                {
+                    taskException = std::current_exception();
+                }
+
+                lock.lock();
+
+                state.numberOfUnfinishedTasks--;
+
+                if ( taskException and not state.firstException )
+                {
+                    state.firstException = taskException;
+                    state.readyTaskIndices.clear();
+                }
+
+                if ( not state.firstException and not state.isStopped )
+                {
+                    for ( auto const dependentIdx : m_tasks[taskIdx].dependentIndices )
+                    {
+                        if ( --state.numberOfPendingPrerequisites[dependentIdx] == 0 )
+                        {
+                            state.readyTaskIndices.push_back( dependentIdx );
+                        }
+                    }
+                }
+
+                state.stateChanged.notify_all();
+            }
+        };
+
+    auto const runWorker =
+        [&]( RunState& state, std::unique_lock<std::mutex>& lock )
+        {
+            lock.unlock();
+
+            auto const wasInsideParallelFor = std::exchange( Detail::isInsideParallelFor, true );
+
+            {
+                auto const workerProfile = Instrumentation::ScopedWorkerProfile{ profileContext };
+
+                lock.lock();
+                runTasks( state, lock );
+                lock.unlock();
+            }
+
+            Detail::isInsideParallelFor = wasInsideParallelFor;
+
+            lock.lock();
+        };
+
+    // A graph run from inside a parallelFor or another graph runs serially.
+    auto const numberOfWorkers =
+        Detail::isInsideParallelFor ? std::size_t{ 1 }
+                                    : std::min<std::size_t>( m_tasks.size(), WorkerPool::getShared().getNumberOfThreads() );
+    auto const numberOfHelpers = numberOfWorkers > 0 ? numberOfWorkers - 1 : 0;
+
+    for ( auto i = std::size_t{ 0 }; i < numberOfHelpers; i++ )
+    {
+        WorkerPool::getShared().submit( [runState, &runWorker]()
+                                        {
+                                            auto lock = std::unique_lock{ runState->mutex };
+                                            if ( runState->isOver )
+                                            {
+                                                return;
+                                            }
+
+                                            runState->numberOfActiveHelpers++;
+                                            runWorker( *runState, lock );
+                                            runState->numberOfActiveHelpers--;
+
+                                            runState->stateChanged.notify_all();
+                                        } );
+    }
+
+    auto lock = std::unique_lock{ runState->mutex };
+
+    runWorker( *runState, lock );
+
+    // The helpers still working finish their tasks and merge their profiles;
+    // the ones the pool has not started yet never will.
+    runState->stateChanged.wait( lock,
+                                 [&runState]()
+                                 {
+                                     return runState->numberOfActiveHelpers == 0;
+                                 } );
+    runState->isOver = true;
+
+    if ( runState->firstException )
+    {
+        std::rethrow_exception( runState->firstException );
+    }
+}
\ No newline at end of file
@@ -0,0 +1,47 @@
+
+#ifndef TASKGRAPH_H
+#define TASKGRAPH_H
+
+#include <cstddef>
+#include <functional>
+#include <stop_token>
+#include <vector>
+
+// Tasks and the tasks each of them waits for, run on the calling thread and
+// the shared WorkerPool, so graphs running at once share its threads instead
+// of each starting one thread per hardware thread. A task starts as soon as the last of its prerequisites has
+// finished, so independent chains of work overlap instead of meeting at a
+// barrier after every step.
+class TaskGraph
+{
+public:
+    using TaskIdx = std::size_t;
+
+    // The prerequisites must have been added before the task.
+    TaskIdx
+    addTask( std::function<void()>&& task,
+             std::vector<TaskIdx> const& prerequisiteIndices = {} );
+
+    // Runs every task and returns once all have finished. The first exception
+    // thrown by a task is rethrown once the running tasks have finished; the
+    // tasks not started by then are dropped. A stop requested through the
+    // token also drops the tasks not started yet, and run() then returns
+    // normally. Like parallelFor, a parallelFor inside a task runs serially.
+    // The timers and counters of the tasks are recorded into the file profile
+    // of the calling thread.
+    void
+    run( std::stop_token const& stopToken = {} );
+
+private:
+    struct Task
+    {
+        std::function<void()>    function;
+        std::vector<TaskIdx>     dependentIndices;
+        std::size_t              numberOfPrerequisites = 0;
+    };
+
+private:
+    std::vector<Task>    m_tasks;
+};
+
+#endif // TASKGRAPH_H
\ No newline at end of file
@@ -0,0 +1,84 @@
+
+#include "WorkerPool.h"
+
+#include <algorithm>
+#include <utility>
+
+WorkerPool&
+WorkerPool::getShared()
+{
+    static auto sharedWorkerPool = WorkerPool{ std::max( 1u, std::thread::hardware_concurrency() ) };
+    return sharedWorkerPool;
+}
+
+WorkerPool::WorkerPool( std::size_t const numberOfThreads )
+{
+    m_threads.reserve( numberOfThreads );
+
+    for ( auto i = std::size_t{ 0 }; i < numberOfThreads; i++ )
+    {
+        m_threads.emplace_back( [this]()
+                                {
+                                    runThread();
+                                } );
+    }
+}
+
+WorkerPool::~WorkerPool()
+{
+    {
+        auto const lock = std::lock_guard{ m_mutex };
+        m_isStopping = true;
+    }
+
+    m_jobSubmitted.notify_all();
+
+    // Jobs not started by now are dropped, which breaks their futures.
+    for ( auto& thread : m_threads )
+    {
+        thread.join();
+    }
+}
+
+std::future<void>
+WorkerPool::submit( std::function<void()>&& job )
+{
+    auto pendingJob = std::packaged_task<void()>{ std::move( job ) };
+    auto jobFuture = pendingJob.get_future();
+
+    {
+        auto const lock = std::lock_guard{ m_mutex };
+        m_pendingJobs.push_back( std::move( pendingJob ) );
+    }
+
+    m_jobSubmitted.notify_one();
+
+    return jobFuture;
+}
+
+void
+WorkerPool::runThread()
+{
+    auto lock = std::unique_lock{ m_mutex };
+
+    while ( true )
+    {
+        m_jobSubmitted.wait( lock,
+                             [this]()
+                             {
+                                 return not m_pendingJobs.empty() or m_isStopping;
+                             } );
+
+        if ( m_isStopping )
+        {
+            break;
+        }
+
+        auto job = std::move( m_pendingJobs.front() );
+        m_pendingJobs.pop_front();
+
+        lock.unlock();
+        job();
+        lock.lock();
+    }
+}
\ No newline at end of file
@@ -0,0 +1,53 @@
+
+#ifndef WORKERPOOL_H
+#define WORKERPOOL_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// A fixed set of threads, one per hardware thread, shared by everything in
+// the process that works in the background, so that any number of graphs
+// and analyses running at once never take more threads than that. Jobs start
+// in the order they were submitted.
+class WorkerPool
+{
+public:
+    static WorkerPool&
+    getShared();
+
+    ~WorkerPool();
+
+    WorkerPool( WorkerPool const& ) = delete;
+    WorkerPool& operator=( WorkerPool const& ) = delete;
+
+    // The future holds whatever the job throws.
+    std::future<void>
+    submit( std::function<void()>&& job );
+
+    std::size_t
+    getNumberOfThreads() const
+    {
+        return m_threads.size();
+    }
+
+private:
+    explicit WorkerPool( std::size_t const numberOfThreads );
+
+    void
+    runThread();
+
+private:
+    std::mutex                                   m_mutex;
+    std::condition_variable                      m_jobSubmitted;
+    std::deque<std::packaged_task<void()>>       m_pendingJobs;
+    bool                                         m_isStopping = false;
+    std::vector<std::thread>                     m_threads;
+};
+
+#endif // WORKERPOOL_H
\ No newline at end of file
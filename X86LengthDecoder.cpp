@@ -0,0 +1,408 @@
+
+#include "X86LengthDecoder.h"
+
+#include <array>
+#include <cstring>
+
+namespace
+{
+    // The low three bits of each opcode entry hold the size of the immediate
+    // operands that do not depend on prefixes.
+    enum OperandFlags : std::uint16_t
+    {
+        FixedImmediateSizeMask  = 0x07,
+        HasModRM                = 1 << 3,
+        HasImmZ                 = 1 << 4,   // 2 bytes with a 0x66 prefix, 4 otherwise
+        HasImmV                 = 1 << 5,   // 8 bytes with REX.W, else like ImmZ
+        HasMoffs                = 1 << 6,   // 8 bytes, or 4 with a 0x67 prefix
+        IsGroup3                = 1 << 7,   // F6/F7: /0 and /1 carry an immediate
+        IsInvalid               = 1 << 8,
+        IsPrefix                = 1 << 9,
+        IsREX                   = 1 << 10,
+        IsEscape                = 1 << 11,
+        IsVectorPrefix          = 1 << 12,
+        HasPrefixDependentSize  = HasImmZ | HasImmV | HasMoffs
+    };
+
+    enum ModRMFlags : std::uint8_t
+    {
+        DisplacementSizeMask    = 0x07,
+        HasSIB                  = 1 << 3,
+        IsRIPRelative           = 1 << 4
+    };
+
+    auto const imm8 = std::uint16_t{ 1 };
+    auto const imm16 = std::uint16_t{ 2 };
+    auto const rel32 = std::uint16_t{ 4 };
+
+    // Decoding never looks further than this past the last prefix, so near the
+    // end of a buffer the bytes are copied into a zero padded one first.
+    auto const maximumLookaheadInBytes = std::size_t{ X86::maximumInstructionLengthInBytes + 8 };
+
+    using OpcodeTable = std::array<std::uint16_t, 256>;
+
+    constexpr void
+    setRange( OpcodeTable& opcodeTable,
+              int const firstOpcode,
+              int const lastOpcode,
+              std::uint16_t const operandFlags )
+    {
+        for ( auto opcode = firstOpcode; opcode <= lastOpcode; opcode++ )
+        {
+            opcodeTable[opcode] = operandFlags;
+        }
+    }
+
+    constexpr OpcodeTable
+    makeOneByteOpcodeTable()
+    {
+        auto opcodeTable = OpcodeTable{};
+
+        // The eight classic ALU blocks: op r/m,r / op r,r/m / op al,ib / op eax,iz.
+        for ( auto aluBase = 0x00; aluBase <= 0x38; aluBase += 0x08 )
+        {
+            setRange( opcodeTable, aluBase, aluBase + 3, HasModRM );
+            opcodeTable[aluBase + 4] = imm8;
+            opcodeTable[aluBase + 5] = HasImmZ;
+        }
+
+        for ( auto const invalidOpcode : { 0x06, 0x07, 0x0E, 0x16, 0x17, 0x1E, 0x1F, 0x27, 0x2F, 0x37, 0x3F } )
+        {
+            opcodeTable[invalidOpcode] = IsInvalid;
+        }
+
+        for ( auto const prefixOpcode : { 0x26, 0x2E, 0x36, 0x3E, 0x64, 0x65, 0x66, 0x67, 0xF0, 0xF2, 0xF3 } )
+        {
+            opcodeTable[prefixOpcode] = IsPrefix;
+        }
+
+        opcodeTable[0x0F] = IsEscape;
+
+        setRange( opcodeTable, 0x40, 0x4F, IsREX );
+        setRange( opcodeTable, 0x60, 0x61, IsInvalid );
+        opcodeTable[0x62] = IsVectorPrefix;
+        opcodeTable[0x63] = HasModRM;
+        opcodeTable[0x68] = HasImmZ;
+        opcodeTable[0x69] = HasModRM | HasImmZ;
+        opcodeTable[0x6A] = imm8;
+        opcodeTable[0x6B] = HasModRM | imm8;
+        setRange( opcodeTable, 0x70, 0x7F, imm8 );
+        opcodeTable[0x80] = HasModRM | imm8;
+        opcodeTable[0x81] = HasModRM | HasImmZ;
+        opcodeTable[0x82] = IsInvalid;
+        opcodeTable[0x83] = HasModRM | imm8;
+        setRange( opcodeTable, 0x84, 0x8F, HasModRM );
+        opcodeTable[0x9A] = IsInvalid;
+        setRange( opcodeTable, 0xA0, 0xA3, HasMoffs );
+        opcodeTable[0xA8] = imm8;
+        opcodeTable[0xA9] = HasImmZ;
+        setRange( opcodeTable, 0xB0, 0xB7, imm8 );
+        setRange( opcodeTable, 0xB8, 0xBF, HasImmV );
+        opcodeTable[0xC0] = HasModRM | imm8;
+        opcodeTable[0xC1] = HasModRM | imm8;
+        opcodeTable[0xC2] = imm16;
+        opcodeTable[0xC4] = IsVectorPrefix;
+        opcodeTable[0xC5] = IsVectorPrefix;
+        opcodeTable[0xC6] = HasModRM | imm8;
+        opcodeTable[0xC7] = HasModRM | HasImmZ;
+        opcodeTable[0xC8] = imm16 + imm8;
+        opcodeTable[0xCA] = imm16;
+        opcodeTable[0xCD] = imm8;
+        opcodeTable[0xCE] = IsInvalid;
+        setRange( opcodeTable, 0xD0, 0xD3, HasModRM );
+        setRange( opcodeTable, 0xD4, 0xD6, IsInvalid );
+        setRange( opcodeTable, 0xD8, 0xDF, HasModRM );
+        setRange( opcodeTable, 0xE0, 0xE7, imm8 );
+        opcodeTable[0xE8] = rel32;
+        opcodeTable[0xE9] = rel32;
+        opcodeTable[0xEA] = IsInvalid;
+        opcodeTable[0xEB] = imm8;
+        opcodeTable[0xF6] = HasModRM | IsGroup3;
+        opcodeTable[0xF7] = HasModRM | IsGroup3;
+        opcodeTable[0xFE] = HasModRM;
+        opcodeTable[0xFF] = HasModRM;
+
+        return opcodeTable;
+    }
+
+    constexpr OpcodeTable
+    makeTwoByteOpcodeTable()
+    {
+        auto opcodeTable = OpcodeTable{};
+        setRange( opcodeTable, 0x00, 0xFF, HasModRM );
+
+        for ( auto const opcodeWithoutOperands : { 0x05, 0x06, 0x07, 0x08, 0x09, 0x0B, 0x0E,
+                                                   0x30, 0x31, 0x32, 0x33, 0x34, 0x35, 0x37,
+                                                   0x77, 0xA0, 0xA1, 0xA2, 0xA8, 0xA9, 0xAA } )
+        {
+            opcodeTable[opcodeWithoutOperands] = 0;
+        }
+
+        for ( auto const invalidOpcode : { 0x04, 0x0A, 0x0C, 0x24, 0x25, 0x26, 0x27, 0x36, 0x39,
+                                           0x3B, 0x3C, 0x3D, 0x3E, 0x3F, 0x7A, 0x7B, 0xA6, 0xA7 } )
+        {
+            opcodeTable[invalidOpcode] = IsInvalid;
+        }
+
+        opcodeTable[0x0F] = HasModRM | imm8;
+        opcodeTable[0x38] = IsEscape;
+        opcodeTable[0x3A] = IsEscape;
+        setRange( opcodeTable, 0x70, 0x73, HasModRM | imm8 );
+        setRange( opcodeTable, 0x80, 0x8F, rel32 );
+        opcodeTable[0xA4] = HasModRM | imm8;
+        opcodeTable[0xAC] = HasModRM | imm8;
+        opcodeTable[0xBA] = HasModRM | imm8;
+        opcodeTable[0xC2] = HasModRM | imm8;
+        setRange( opcodeTable, 0xC4, 0xC6, HasModRM | imm8 );
+        setRange( opcodeTable, 0xC8, 0xCF, 0 );
+
+        return opcodeTable;
+    }
+
+    constexpr std::array<std::uint8_t, 256>
+    makeModRMTable()
+    {
+        auto modRMTable = std::array<std::uint8_t, 256>{};
+
+        for ( auto modRM = 0; modRM < 256; modRM++ )
+        {
+            auto const mod = modRM >> 6;
+            auto const rm = modRM & 0x07;
+
+            if ( mod == 3 )
+            {
+                continue;
+            }
+
+            modRMTable[modRM] = static_cast<std::uint8_t>( ( mod == 1 ? 1 : mod == 2 ? 4 : 0 ) |
+                                                           ( rm == 4 ? HasSIB : 0 ) );
+
+            if ( mod == 0 and rm == 5 )
+            {
+                modRMTable[modRM] = 4 | IsRIPRelative;
+            }
+        }
+
+        return modRMTable;
+    }
+
+    constexpr auto oneByteOpcodeTable = makeOneByteOpcodeTable();
+    constexpr auto twoByteOpcodeTable = makeTwoByteOpcodeTable();
+    constexpr auto modRMTable = makeModRMTable();
+
+    // The 0F38 map never carries an immediate, the 0F3A map always carries one.
+    constexpr std::uint16_t threeByte38OperandFlags = HasModRM;
+    constexpr std::uint16_t threeByte3AOperandFlags = HasModRM | imm8;
+
+    constexpr X86::DecodedInstruction invalidInstruction
+    {
+        .lengthInBytes = 1,
+        .isValid = false,
+        .hasRIPRelativeOperand = false,
+        .kind = X86::InstructionKind::Other,
+        .ripDisplacement = 0
+    };
+
+    constexpr X86::DecodedInstruction truncatedInstruction
+    {
+        .lengthInBytes = 0,
+        .isValid = false,
+        .hasRIPRelativeOperand = false,
+        .kind = X86::InstructionKind::Other,
+        .ripDisplacement = 0
+    };
+
+    std::uint16_t
+    getOperandFlagsOfOpcodeMap( int const opcodeMap,
+                                unsigned char const opcode )
+    {
+        switch ( opcodeMap )
+        {
+            case 1:
+                return twoByteOpcodeTable[opcode];
+            case 2:
+                return threeByte38OperandFlags;
+            case 3:
+                return threeByte3AOperandFlags;
+            default:
+                return IsInvalid;
+        }
+    }
+
+    // Decodes from a buffer that stays readable for maximumLookaheadInBytes
+    // past the last prefix. The returned length may exceed the number of
+    // bytes that were really available.
+    X86::DecodedInstruction
+    decodeFromPaddedBytes( unsigned char const* instructionBytes )
+    {
+        auto position = std::size_t{ 0 };
+
+        auto hasOperandSizePrefix = false;
+        auto hasAddressSizePrefix = false;
+        auto hasREXW = false;
+
+        auto operandFlags = oneByteOpcodeTable[instructionBytes[0]];
+
+        // Legacy prefixes, then at most one REX that must directly precede the opcode.
+        while ( operandFlags & ( IsPrefix | IsREX ) )
+        {
+            auto const prefix = instructionBytes[position];
+
+            hasOperandSizePrefix |= prefix == 0x66;
+            hasAddressSizePrefix |= prefix == 0x67;
+            hasREXW = ( operandFlags & IsREX ) and ( prefix & 0x08 );
+
+            if ( ++position == X86::maximumInstructionLengthInBytes )
+            {
+                return invalidInstruction;
+            }
+
+            operandFlags = oneByteOpcodeTable[instructionBytes[position]];
+        }
+
+        auto opcodeMap = 0;
+        auto opcode = instructionBytes[position++];
+
+        if ( operandFlags & IsVectorPrefix )
+        {
+            // VEX (C4/C5) and EVEX (62) are always vector prefixes in 64-bit mode;
+            // they pick the opcode map and replace 66/REX.W, which no longer
+            // influence the operand sizes that matter here.
+            auto const payloadSize = opcode == 0xC5 ? 1 : opcode == 0xC4 ? 2 : 3;
+
+            opcodeMap = opcode == 0xC5 ? 1 : instructionBytes[position] & ( opcode == 0x62 ? 0x03 : 0x1F );
+            position += payloadSize;
+            opcode = instructionBytes[position++];
+            operandFlags = getOperandFlagsOfOpcodeMap( opcodeMap, opcode );
+            hasOperandSizePrefix = false;
+            hasREXW = false;
+        }
+        else if ( operandFlags & IsEscape )
+        {
+            opcode = instructionBytes[position++];
+            opcodeMap = 1;
+
+            if ( opcode == 0x38 or opcode == 0x3A )
+            {
+                opcodeMap = opcode == 0x38 ? 2 : 3;
+                opcode = instructionBytes[position++];
+            }
+
+            operandFlags = getOperandFlagsOfOpcodeMap( opcodeMap, opcode );
+        }
+
+        if ( operandFlags & IsInvalid )
+        {
+            return invalidInstruction;
+        }
+
+        auto decodedInstruction = X86::DecodedInstruction
+        {
+            .lengthInBytes = 0,
+            .isValid = true,
+            .hasRIPRelativeOperand = false,
+            .kind = X86::InstructionKind::Other,
+            .ripDisplacement = 0
+        };
+
+        auto immediateSizeInBytes = static_cast<std::size_t>( operandFlags & FixedImmediateSizeMask );
+
+        if ( operandFlags & HasModRM )
+        {
+            auto const modRM = instructionBytes[position++];
+            auto const reg = ( modRM >> 3 ) & 0x07;
+            auto const modRMFlags = modRMTable[modRM];
+            auto displacementSizeInBytes = static_cast<std::size_t>( modRMFlags & DisplacementSizeMask );
+
+            if ( modRMFlags & HasSIB )
+            {
+                auto const sib = instructionBytes[position++];
+                if ( modRM < 0x40 and ( sib & 0x07 ) == 5 )
+                {
+                    displacementSizeInBytes = 4;
+                }
+            }
+            else if ( modRMFlags & IsRIPRelative )
+            {
+                decodedInstruction.hasRIPRelativeOperand = true;
+                std::memcpy( &decodedInstruction.ripDisplacement, instructionBytes + position, sizeof( std::int32_t ) );
+            }
+
+            position += displacementSizeInBytes;
+
+            if ( opcodeMap == 0 )
+            {
+                if ( opcode == 0xFF and reg == 2 )
+                {
+                    decodedInstruction.kind = X86::InstructionKind::IndirectCall;
+                }
+                else if ( opcode == 0xFF and reg == 4 )
+                {
+                    decodedInstruction.kind = X86::InstructionKind::IndirectJump;
+                }
+                else if ( opcode == 0x8B )
+                {
+                    decodedInstruction.kind = X86::InstructionKind::Load;
+                }
+                else if ( ( operandFlags & IsGroup3 ) and reg <= 1 )
+                {
+                    immediateSizeInBytes += opcode == 0xF6 ? 1 : hasOperandSizePrefix ? 2 : 4;
+                }
+            }
+        }
+
+        if ( operandFlags & HasPrefixDependentSize )
+        {
+            if ( operandFlags & HasImmZ )
+            {
+                immediateSizeInBytes += hasOperandSizePrefix ? 2 : 4;
+            }
+            else if ( operandFlags & HasImmV )
+            {
+                immediateSizeInBytes += hasREXW ? 8 : hasOperandSizePrefix ? 2 : 4;
+            }
+            else
+            {
+                immediateSizeInBytes += hasAddressSizePrefix ? 4 : 8;
+            }
+        }
+
+        position += immediateSizeInBytes;
+
+        if ( position > X86::maximumInstructionLengthInBytes )
+        {
+            return invalidInstruction;
+        }
+
+        decodedInstruction.lengthInBytes = static_cast<std::uint8_t>( position );
+
+        return decodedInstruction;
+    }
+}
+
+namespace X86
+{
+    DecodedInstruction
+    decodeInstruction( unsigned char const* instructionBytes,
+                       std::size_t const numberOfAvailableBytes )
+    {
+        if ( numberOfAvailableBytes >= maximumInstructionLengthInBytes + maximumLookaheadInBytes )
+        {
+            return decodeFromPaddedBytes( instructionBytes );
+        }
+
+        if ( numberOfAvailableBytes == 0 )
+        {
+            return truncatedInstruction;
+        }
+
+        // Bytes past the end read as zeros; they can only influence an
+        // instruction that would not have fit anyway.
+        unsigned char paddedBytes[maximumInstructionLengthInBytes + maximumLookaheadInBytes] = {};
+        std::memcpy( paddedBytes, instructionBytes, numberOfAvailableBytes );
+
+        auto const decodedInstruction = decodeFromPaddedBytes( paddedBytes );
+
+        return decodedInstruction.lengthInBytes <= numberOfAvailableBytes ? decodedInstruction : truncatedInstruction;
+    }
+}
\ No newline at end of file
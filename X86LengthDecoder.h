@@ -0,0 +1,39 @@
+
+#ifndef X86LENGTHDECODER_H
+#define X86LENGTHDECODER_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace X86
+{
+    enum class InstructionKind : std::uint8_t
+    {
+        Other,
+        IndirectCall,
+        IndirectJump,
+        Load
+    };
+
+    struct DecodedInstruction
+    {
+        std::uint8_t       lengthInBytes;
+        bool               isValid;
+        bool               hasRIPRelativeOperand;
+        InstructionKind    kind;
+        std::int32_t       ripDisplacement;
+    };
+
+    inline constexpr auto maximumInstructionLengthInBytes = 15;
+
+    // Decodes only as much of a 64-bit mode instruction as is needed to know
+    // its length and whether it addresses memory through [rip+disp32].
+    // Bytes that do not form a valid instruction decode as a one-byte invalid
+    // instruction so that a linear sweep can resynchronise. An instruction
+    // that runs past the end of the buffer decodes with a length of zero.
+    DecodedInstruction
+    decodeInstruction( unsigned char const* instructionBytes,
+                       std::size_t const numberOfAvailableBytes );
+}
+
+#endif // X86LENGTHDECODER_H
\ No newline at end of file
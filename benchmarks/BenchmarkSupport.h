@@ -0,0 +1,82 @@
+
+#ifndef BENCHMARKSUPPORT_H
+#define BENCHMARKSUPPORT_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+namespace Benchmark
+{
+    template <typename BenchmarkedFunction>
+    double
+    measureBestSecondsPerIteration( BenchmarkedFunction&& benchmarkedFunction,
+                                    int const numberOfIterations,
+                                    int const numberOfRounds = 3 )
+    {
+        auto bestSecondsPerIteration = std::numeric_limits<double>::max();
+
+        for ( auto round = 0; round < numberOfRounds; round++ )
+        {
+            auto const startTime = std::chrono::steady_clock::now();
+
+            for ( auto i = 0; i < numberOfIterations; i++ )
+            {
+                benchmarkedFunction();
+            }
+
+            auto const elapsedTime = std::chrono::steady_clock::now() - startTime;
+
+            bestSecondsPerIteration =
+                std::min( bestSecondsPerIteration,
+                          std::chrono::duration<double>( elapsedTime ).count() / numberOfIterations );
+        }
+
+        return bestSecondsPerIteration;
+    }
+
+    inline std::uint64_t
+    parseByteCount( std::string const& byteCountAsString )
+    {
+        auto suffixPosition = std::size_t{ 0 };
+        auto const byteCount = std::stoull( byteCountAsString, &suffixPosition );
+
+        auto const suffix = byteCountAsString.substr( suffixPosition );
+
+        if ( suffix.empty() )
+        {
+            return byteCount;
+        }
+        else if ( suffix == "K" or suffix == "k" )
+        {
+            return byteCount << 10;
+        }
+        else if ( suffix == "M" or suffix == "m" )
+        {
+            return byteCount << 20;
+        }
+        else if ( suffix == "G" or suffix == "g" )
+        {
+            return byteCount << 30;
+        }
+
+        throw std::invalid_argument{ "Unknown size suffix '" + suffix + "'." };
+    }
+
+    template <typename T>
+    void
+    doNotOptimizeAway( T const& value )
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        asm volatile( "" : : "r"( &value ) : "memory" );
+#else
+        static auto volatile sink = static_cast<void const*>( nullptr );
+        sink = &value;
+#endif
+    }
+}
+
+#endif // BENCHMARKSUPPORT_H
\ No newline at end of file
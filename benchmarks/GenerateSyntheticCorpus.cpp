@@ -0,0 +1,96 @@
+
+#include "BenchmarkSupport.h"
+#include "SyntheticPEGenerator.h"
+
+#include <filesystem>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+int
+main( int argCount, char** args )
+{
+    auto outputDirectory = std::filesystem::path{};
+    auto numberOfImages = 100;
+    auto baseImageOptions = SyntheticPE::ImageOptions{};
+
+    try
+    {
+        for ( auto i = 1; i + 1 < argCount; i += 2 )
+        {
+            auto const argument = std::string( args[i] );
+            auto const value = std::string( args[i + 1] );
+
+            if ( argument == "--out" )
+            {
+                outputDirectory = value;
+            }
+            else if ( argument == "--count" )
+            {
+                numberOfImages = std::stoi( value );
+            }
+            else if ( argument == "--sections" )
+            {
+                baseImageOptions.numberOfSections = std::stoi( value );
+            }
+            else if ( argument == "--dlls" )
+            {
+                baseImageOptions.numberOfImportedDLLs = std::stoi( value );
+            }
+            else if ( argument == "--imports-per-dll" )
+            {
+                baseImageOptions.numberOfImportsPerDLL = std::stoi( value );
+            }
+            else if ( argument == "--exports" )
+            {
+                baseImageOptions.numberOfExports = std::stoi( value );
+            }
+            else if ( argument == "--size" )
+            {
+                baseImageOptions.minimumFileSizeInBytes = Benchmark::parseByteCount( value );
+            }
+            else if ( argument == "--seed" )
+            {
+                baseImageOptions.seed = static_cast<std::uint32_t>( std::stoul( value ) );
+            }
+            else
+            {
+                throw std::invalid_argument{ "Unknown option '" + argument + "'." };
+            }
+        }
+
+        if ( outputDirectory.empty() or argCount % 2 == 0 )
+        {
+            throw std::invalid_argument{ "An output directory is required." };
+        }
+
+        std::filesystem::create_directories( outputDirectory );
+
+        auto totalSizeInBytes = std::uint64_t{ 0 };
+
+        for ( auto imageIdx = 0; imageIdx < numberOfImages; imageIdx++ )
+        {
+            auto imageOptions = baseImageOptions;
+            imageOptions.seed = baseImageOptions.seed + imageIdx;
+            imageOptions.kind = static_cast<SyntheticPE::ImageKind>( imageIdx % 3 );
+
+            auto const fileName =
+                "synthetic_" + std::to_string( imageIdx ) +
+                ( imageOptions.kind == SyntheticPE::ImageKind::COFFObject ? ".obj" : ".dll" );
+
+            totalSizeInBytes += SyntheticPE::writeImage( ( outputDirectory / fileName ).string(), imageOptions );
+        }
+
+        std::cout << "Wrote " << numberOfImages << " images (" << totalSizeInBytes << " bytes) to "
+                  << outputDirectory.string() << '\n';
+    }
+    catch ( std::exception const& generationError )
+    {
+        std::cerr << "ewea-gen-corpus: " << generationError.what() << '\n'
+                  << "Usage: ewea-gen-corpus --out DIR [--count N] [--sections N] [--dlls N]\n"
+                  << "                       [--imports-per-dll N] [--exports N] [--size BYTES[K|M|G]] [--seed N]\n";
+        return 1;
+    }
+
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,229 @@
+
+#include "PEFiles.h"
+#include "SyntheticPEGenerator.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace
+{
+    struct ImportDirectoryTableEntry
+    {
+        std::uint32_t    importLookupTableRVA;
+        std::uint32_t    timestamp;
+        std::uint32_t    forwarderChainIdx;
+        std::uint32_t    namestringRVA;
+        std::uint32_t    importAddressTableRVA;
+    };
+
+    std::string
+    getSectionName( std::uint64_t const sectionNameAsNumber )
+    {
+        auto const sectionNameBytes = reinterpret_cast<char const*>( &sectionNameAsNumber );
+
+        return std::string( sectionNameBytes,
+                            strnlen( sectionNameBytes, sizeof( sectionNameAsNumber ) ) );
+    }
+
+    EXEFile
+    uncheckedParseEXEFile( unsigned char const* rawBytes )
+    {
+        auto parsedEXEFile = EXEFile{};
+
+        parsedEXEFile.dosHeader = *reinterpret_cast<PE::DOSHeader const*>( rawBytes );
+
+        auto const ntFileHeaderOffset =
+            parsedEXEFile.dosHeader.offsetOfNTSignature + sizeof( parsedEXEFile.ntSignature );
+        parsedEXEFile.ntFileHeader =
+            *reinterpret_cast<PE::NTFileHeader const*>( rawBytes + ntFileHeaderOffset );
+
+        auto const ntOptionalHeaderOffset = ntFileHeaderOffset + sizeof( PE::NTFileHeader );
+        parsedEXEFile.ntOptionalHeader =
+            *reinterpret_cast<PE::NTOptionalHeader64 const*>( rawBytes + ntOptionalHeaderOffset );
+
+        auto const dataDirectoryEntriesOffset = ntOptionalHeaderOffset + sizeof( PE::NTOptionalHeader64 );
+        parsedEXEFile.dataDirectoryEntries.resize( parsedEXEFile.ntOptionalHeader.numberOfDataDirectories );
+        std::memcpy( parsedEXEFile.dataDirectoryEntries.data(),
+                     rawBytes + dataDirectoryEntriesOffset,
+                     parsedEXEFile.dataDirectoryEntries.size() * sizeof( PE::DataDirectoryEntry ) );
+
+        auto const sectionHeaderTableOffset =
+            dataDirectoryEntriesOffset +
+            parsedEXEFile.dataDirectoryEntries.size() * sizeof( PE::DataDirectoryEntry );
+
+        for ( auto i = 0; i < parsedEXEFile.ntFileHeader.numberOfSections; i++ )
+        {
+            auto const& sectionHeader =
+                *reinterpret_cast<PE::SectionHeader const*>( rawBytes + sectionHeaderTableOffset +
+                                                             i * sizeof( PE::SectionHeader ) );
+            auto const sectionName = getSectionName( sectionHeader.sectionNameAsNumber );
+
+            parsedEXEFile.sectionHeadersNameToInfo[sectionName] = sectionHeader;
+            parsedEXEFile.sectionNameToRawData[sectionName].assign( rawBytes + sectionHeader.pointerToRawData,
+                                                                    rawBytes + sectionHeader.pointerToRawData +
+                                                                    sectionHeader.sizeOfRawDataInBytes );
+        }
+
+        auto const& importDirectory = parsedEXEFile.dataDirectoryEntries[1];
+
+        for ( auto const& [sectionName, sectionHeader] : parsedEXEFile.sectionHeadersNameToInfo )
+        {
+            if (    importDirectory.dataDirectoryRVA < sectionHeader.sectionBaseAddressInMemory
+                 or importDirectory.dataDirectoryRVA >= sectionHeader.sectionBaseAddressInMemory +
+                                                        sectionHeader.sectionSizeInBytesInMemory )
+            {
+                continue;
+            }
+
+            auto const sectionBytes = parsedEXEFile.sectionNameToRawData.at( sectionName ).data() -
+                                      sectionHeader.sectionBaseAddressInMemory;
+            auto const importDirectoryTable =
+                reinterpret_cast<ImportDirectoryTableEntry const*>( sectionBytes + importDirectory.dataDirectoryRVA );
+
+            for ( auto j = 0; importDirectoryTable[j].namestringRVA != 0; j++ )
+            {
+                auto const importedDLLName =
+                    std::string( reinterpret_cast<char const*>( sectionBytes + importDirectoryTable[j].namestringRVA ) );
+                auto const importLookupTable =
+                    reinterpret_cast<std::uint64_t const*>( sectionBytes + importDirectoryTable[j].importLookupTableRVA );
+
+                auto& importedFunctions = parsedEXEFile.importedDLLToImportedFunctions[importedDLLName];
+
+                for ( auto k = 0; importLookupTable[k] != 0; k++ )
+                {
+                    auto const iatSlotRVA =
+                        static_cast<std::uint32_t>( importDirectoryTable[j].importAddressTableRVA + k * sizeof( std::uint64_t ) );
+
+                    if ( importLookupTable[k] >> 63 )
+                    {
+                        importedFunctions.push_back( PE::ImportedFunction
+                                                         {
+                                                            .name = "#" + std::to_string( importLookupTable[k] & 0xFFFF ),
+                                                            .iatSlotRVA = iatSlotRVA
+                                                         } );
+                        continue;
+                    }
+
+                    importedFunctions.push_back( PE::ImportedFunction
+                                                     {
+                                                        .name = std::string( reinterpret_cast<char const*>( sectionBytes + importLookupTable[k] +
+                                                                                                            sizeof( std::uint16_t ) ) ),
+                                                        .iatSlotRVA = iatSlotRVA
+                                                     } );
+                }
+            }
+        }
+
+        auto const& exportDirectory = parsedEXEFile.dataDirectoryEntries[0];
+
+        for ( auto const& [sectionName, sectionHeader] : parsedEXEFile.sectionHeadersNameToInfo )
+        {
+            if (    exportDirectory.sizeInBytes == 0
+                 or exportDirectory.dataDirectoryRVA < sectionHeader.sectionBaseAddressInMemory
+                 or exportDirectory.dataDirectoryRVA >= sectionHeader.sectionBaseAddressInMemory +
+                                                        sectionHeader.sectionSizeInBytesInMemory )
+            {
+                continue;
+            }
+
+            auto const sectionBytes = parsedEXEFile.sectionNameToRawData.at( sectionName ).data() -
+                                      sectionHeader.sectionBaseAddressInMemory;
+            auto const exportDirectoryTable =
+                reinterpret_cast<std::uint32_t const*>( sectionBytes + exportDirectory.dataDirectoryRVA );
+            auto const numberOfNamePointers = exportDirectoryTable[6];
+            auto const namePointerTable =
+                reinterpret_cast<std::uint32_t const*>( sectionBytes + exportDirectoryTable[8] );
+
+            for ( auto j = std::uint32_t{ 0 }; j < numberOfNamePointers; j++ )
+            {
+                parsedEXEFile.exportedFunctions.push_back(
+                    PE::ExportedFunction{ .name = reinterpret_cast<char const*>( sectionBytes + namePointerTable[j] ) } );
+            }
+        }
+
+        return parsedEXEFile;
+    }
+
+    template <typename ParseFunction>
+    double
+    measureNanosecondsPerParse( ParseFunction&& parseFunction,
+                                int const numberOfIterations )
+    {
+        auto const startTime = std::chrono::steady_clock::now();
+
+        for ( auto i = 0; i < numberOfIterations; i++ )
+        {
+            auto const parsedEXEFile = parseFunction();
+
+            if ( parsedEXEFile.sectionHeadersNameToInfo.empty() )
+            {
+                throw std::runtime_error{ "Parsed image has no sections." };
+            }
+        }
+
+        auto const elapsedTime = std::chrono::steady_clock::now() - startTime;
+
+        return std::chrono::duration<double, std::nano>( elapsedTime ).count() / numberOfIterations;
+    }
+}
+
+int
+main( int argCount, char** args )
+{
+    auto const numberOfRounds = 7;
+    auto numberOfIterations = 2000;
+    auto firstPathIdx = 1;
+
+    if ( argCount > 2 and std::string( args[1] ) == "--iterations" )
+    {
+        numberOfIterations = std::stoi( args[2] );
+        firstPathIdx = 3;
+    }
+
+    auto imagesToParse = std::vector<std::pair<std::string, std::vector<unsigned char>>>{};
+
+    for ( auto i = firstPathIdx; i < argCount; i++ )
+    {
+        imagesToParse.emplace_back( args[i], loadPEFileAsRawBytes( args[i] ) );
+    }
+
+    if ( imagesToParse.empty() )
+    {
+        imagesToParse.emplace_back( "<synthetic PE32+ image>", SyntheticPE::buildImage( SyntheticPE::ImageOptions{} ) );
+    }
+
+    std::cout << std::fixed << std::setprecision( 1 );
+
+    for ( auto const& [imageName, rawBytes] : imagesToParse )
+    {
+        auto uncheckedNanoseconds = std::numeric_limits<double>::max();
+        auto hardenedNanoseconds = std::numeric_limits<double>::max();
+
+        for ( auto round = 0; round < numberOfRounds; round++ )
+        {
+            uncheckedNanoseconds =
+                std::min( uncheckedNanoseconds,
+                          measureNanosecondsPerParse( [&rawBytes] { return uncheckedParseEXEFile( rawBytes.data() ); },
+                                                      numberOfIterations ) );
+            hardenedNanoseconds =
+                std::min( hardenedNanoseconds,
+                          measureNanosecondsPerParse( [&rawBytes] { return parseEXEFile( PE::ByteReader{ rawBytes } ); },
+                                                      numberOfIterations ) );
+        }
+
+        std::cout << imageName << '\n'
+                  << "    unchecked: " << uncheckedNanoseconds << " ns/parse\n"
+                  << "    hardened:  " << hardenedNanoseconds << " ns/parse\n"
+                  << "    overhead:  " << ( hardenedNanoseconds / uncheckedNanoseconds - 1.0 ) * 100.0 << " %\n";
+    }
+
+    return 0;
+}
\ No newline at end of file
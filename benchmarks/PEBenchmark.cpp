@@ -0,0 +1,643 @@
+
+#include "BenchmarkSupport.h"
+#include "BinaryDiff.h"
+#include "CorpusDatabase.h"
+#include "ImageAnalysis.h"
+#include "ImageCarving.h"
+#include "ImportReferences.h"
+#include "PEFiles.h"
+#include "RVASymbolizer.h"
+#include "SignatureScanner.h"
+#include "StringExtraction.h"
+#include "SyntheticPEGenerator.h"
+
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+namespace
+{
+    struct BenchmarkOptions
+    {
+        SyntheticPE::ImageOptions    imageOptions;
+        int                          numberOfIterations = 20;
+        std::filesystem::path        workingDirectory = std::filesystem::temp_directory_path() / "ewea-bench";
+        bool                         keepGeneratedFiles = false;
+        std::uint32_t                numberOfCorpusFiles = 100'000;
+    };
+
+    BenchmarkOptions
+    parseBenchmarkOptions( int const argCount, char** args )
+    {
+        auto benchmarkOptions = BenchmarkOptions{};
+        auto& imageOptions = benchmarkOptions.imageOptions;
+
+        for ( auto i = 1; i < argCount; i++ )
+        {
+            auto const argument = std::string( args[i] );
+
+            if ( argument == "--keep" )
+            {
+                benchmarkOptions.keepGeneratedFiles = true;
+                continue;
+            }
+
+            if ( i + 1 >= argCount )
+            {
+                throw std::invalid_argument{ "Missing value for '" + argument + "'." };
+            }
+
+            auto const value = std::string( args[++i] );
+
+            if ( argument == "--sections" )
+            {
+                imageOptions.numberOfSections = std::stoi( value );
+            }
+            else if ( argument == "--dlls" )
+            {
+                imageOptions.numberOfImportedDLLs = std::stoi( value );
+            }
+            else if ( argument == "--imports-per-dll" )
+            {
+                imageOptions.numberOfImportsPerDLL = std::stoi( value );
+            }
+            else if ( argument == "--exports" )
+            {
+                imageOptions.numberOfExports = std::stoi( value );
+            }
+            else if ( argument == "--relocations" )
+            {
+                imageOptions.numberOfRelocationsPerSection = std::stoi( value );
+            }
+            else if ( argument == "--size" )
+            {
+                imageOptions.minimumFileSizeInBytes = Benchmark::parseByteCount( value );
+            }
+            else if ( argument == "--seed" )
+            {
+                imageOptions.seed = static_cast<std::uint32_t>( std::stoul( value ) );
+            }
+            else if ( argument == "--iterations" )
+            {
+                benchmarkOptions.numberOfIterations = std::max( std::stoi( value ), 1 );
+            }
+            else if ( argument == "--corpus-files" )
+            {
+                benchmarkOptions.numberOfCorpusFiles = static_cast<std::uint32_t>( std::stoul( value ) );
+            }
+            else if ( argument == "--work-dir" )
+            {
+                benchmarkOptions.workingDirectory = value;
+            }
+            else
+            {
+                throw std::invalid_argument{ "Unknown option '" + argument + "'." };
+            }
+        }
+
+        return benchmarkOptions;
+    }
+
+    void
+    reportStage( std::string const& stageName,
+                 double const secondsPerIteration,
+                 std::uint64_t const bytesPerIteration,
+                 std::uint64_t const itemsPerIteration = 0,
+                 char const* itemName = "" )
+    {
+        std::cout << "  " << std::left << std::setw( 14 ) << stageName << std::right
+                  << std::setw( 14 ) << secondsPerIteration * 1e6 << " us";
+
+        if ( bytesPerIteration != 0 )
+        {
+            std::cout << std::setw( 14 ) << bytesPerIteration / secondsPerIteration / ( 1 << 20 ) << " MB/s";
+        }
+
+        if ( itemsPerIteration != 0 )
+        {
+            std::cout << std::setw( 14 ) << itemsPerIteration / secondsPerIteration << ' ' << itemName << "/s";
+        }
+
+        std::cout << '\n';
+    }
+
+    // Half of the signatures are random and never match; the other half are
+    // cut out of the image's own sections with some bytes wildcarded, the
+    // way signatures for known code usually look.
+    std::vector<Signature>
+    makeBenchmarkSignatures( EXEFile const& referenceEXEFile,
+                             std::size_t const numberOfSignatures )
+    {
+        auto randomNumbers = std::mt19937{ 1 };
+        auto sectionsToSampleFrom = std::vector<std::vector<unsigned char> const*>{};
+
+        for ( auto const& [sectionName, sectionRawData] : referenceEXEFile.sectionNameToRawData )
+        {
+            if ( sectionRawData.size() >= 64 )
+            {
+                sectionsToSampleFrom.push_back( &sectionRawData );
+            }
+        }
+
+        auto signatures = std::vector<Signature>{};
+
+        for ( auto i = std::size_t{ 0 }; i < numberOfSignatures; i++ )
+        {
+            auto signature = Signature{ .name = "sig" + std::to_string( i ) };
+            auto const signatureLengthInBytes = 8 + randomNumbers() % 17;
+            auto const sampledSection =
+                i % 2 == 0 or sectionsToSampleFrom.empty() ? nullptr
+                                                           : sectionsToSampleFrom[randomNumbers() % sectionsToSampleFrom.size()];
+            auto const sampleOffset = sampledSection ? randomNumbers() % ( sampledSection->size() - 32 ) : 0;
+
+            for ( auto j = std::size_t{ 0 }; j < signatureLengthInBytes; j++ )
+            {
+                auto const isWildcard = j != 0 and randomNumbers() % 6 == 0;
+                auto const byte = sampledSection ? ( *sampledSection )[sampleOffset + j] : randomNumbers() & 0xFF;
+
+                signature.bytes.push_back( isWildcard ? 0 : static_cast<unsigned char>( byte ) );
+                signature.mask.push_back( isWildcard ? 0x00 : 0xFF );
+            }
+
+            signature.requiredSectionCharacteristics = i % 3 == 0 ? 0x20000000 : 0;
+            signatures.push_back( std::move( signature ) );
+        }
+
+        return signatures;
+    }
+
+    // A later build of the same image: every section has a few bytes
+    // flipped, a short run inserted and a short run deleted, so the chunks
+    // around each edit change and all the others only shift.
+    EXEFile
+    makeEditedCopy( EXEFile const& referenceEXEFile )
+    {
+        auto randomNumbers = std::mt19937{ 2 };
+        auto editedEXEFile = referenceEXEFile;
+
+        for ( auto& [sectionName, sectionRawData] : editedEXEFile.sectionNameToRawData )
+        {
+            if ( sectionRawData.size() < 64 )
+            {
+                continue;
+            }
+
+            for ( auto i = 0; i < 4; i++ )
+            {
+                sectionRawData[randomNumbers() % sectionRawData.size()] ^= 0x5A;
+            }
+
+            auto const insertionOffset = randomNumbers() % sectionRawData.size();
+            sectionRawData.insert( sectionRawData.begin() + insertionOffset, 24, 0xCC );
+
+            auto const deletionOffset = randomNumbers() % ( sectionRawData.size() - 16 );
+            sectionRawData.erase( sectionRawData.begin() + deletionOffset, sectionRawData.begin() + deletionOffset + 16 );
+        }
+
+        return editedEXEFile;
+    }
+
+    void
+    benchmarkPE32PlusStages( std::filesystem::path const& pathOfImage,
+                             int const numberOfIterations )
+    {
+        auto const fileSizeInBytes = std::filesystem::file_size( pathOfImage );
+
+        reportStage( "read",
+                     Benchmark::measureBestSecondsPerIteration(
+                         [&]
+                         {
+                             Benchmark::doNotOptimizeAway( loadPEFileAsRawBytes( pathOfImage.string() ) );
+                         },
+                         numberOfIterations ),
+                     fileSizeInBytes );
+
+        auto referenceEXEFile = EXEFile{};
+
+        {
+            auto const rawBytesStorage = loadPEFileAsRawBytes( pathOfImage.string() );
+            auto const rawBytes = PE::ByteReader{ rawBytesStorage };
+
+            auto const dosHeader = *PE::extractDOSHeader( rawBytes );
+            auto const ntFileHeaderOffset = dosHeader.offsetOfNTSignature + sizeof( std::uint32_t );
+            auto const ntOptionalHeaderOffset = ntFileHeaderOffset + sizeof( PE::NTFileHeader );
+            auto const dataDirectoriesOffset = ntOptionalHeaderOffset + sizeof( PE::NTOptionalHeader64 );
+
+            auto const headersSecondsPerIteration =
+                Benchmark::measureBestSecondsPerIteration(
+           [&]
+           {
+               auto const dosHeader = PE::extractDOSHeader( rawBytes );
+               auto const ntFileHeader = PE::extractNTFileHeader( *rawBytes.subReader( ntFileHeaderOffset ) );
+               auto const ntOptionalHeader = PE::extract64bitNTOptionalHeader( *rawBytes.subReader( ntOptionalHeaderOffset ) );
+               auto const dataDirectoryEntries =
+                   PE::extractDataDirectoryEntries( *rawBytes.subReader( dataDirectoriesOffset ), *ntOptionalHeader );
+
+               Benchmark::doNotOptimizeAway( dosHeader );
+               Benchmark::doNotOptimizeAway( ntFileHeader );
+               Benchmark::doNotOptimizeAway( dataDirectoryEntries );
+           },
+           numberOfIterations * 1000 );
+   reportStage( "headers", headersSecondsPerIteration, dataDirectoriesOffset );
+
+   auto const ntFileHeader = *PE::extractNTFileHeader( *rawBytes.subReader( ntFileHeaderOffset ) );
+   auto const ntOptionalHeader = *PE::extract64bitNTOptionalHeader( *rawBytes.subReader( ntOptionalHeaderOffset ) );
+   auto const sectionHeaderTableOffset =
+       dataDirectoriesOffset + ntOptionalHeader.numberOfDataDirectories * sizeof( PE::DataDirectoryEntry );
+
+   auto const sectionsSecondsPerIteration =
+       Benchmark::measureBestSecondsPerIteration(
+           [&]
+           {
+               auto const sectionHeaders =
+                   PE::extractSectionHeaders( *rawBytes.subReader( sectionHeaderTableOffset ),
+                                              ntFileHeader.numberOfSections );
+               auto const sectionContents = PE::extractRawSectionContents( rawBytes, *sectionHeaders );
+
+               Benchmark::doNotOptimizeAway( sectionContents );
+           },
+           numberOfIterations );
+            reportStage( "sections", sectionsSecondsPerIteration, fileSizeInBytes,
+                         ntFileHeader.numberOfSections, "sections" );
+
+            referenceEXEFile = parseEXEFile( rawBytes );
+
+            auto const stringScanRegions = getStringScanRegions( referenceEXEFile );
+            auto numberOfStrings = std::size_t{ 0 };
+            auto const stringsSecondsPerIteration =
+                Benchmark::measureBestSecondsPerIteration(
+           [&]
+           {
+               numberOfStrings = extractStrings( rawBytes, stringScanRegions ).strings.size();
+           },
+           numberOfIterations );
+            reportStage( "strings", stringsSecondsPerIteration, fileSizeInBytes, numberOfStrings, "strings" );
+
+            auto numberOfCarvedImages = std::size_t{ 0 };
+            auto const carveSecondsPerIteration =
+                Benchmark::measureBestSecondsPerIteration(
+           [&]
+           {
+               numberOfCarvedImages = carveEmbeddedImages( rawBytes ).size();
+           },
+           numberOfIterations );
+            reportStage( "carve", carveSecondsPerIteration, fileSizeInBytes, numberOfCarvedImages, "images" );
+        }
+
+        auto numberOfImportedFunctions = std::uint64_t{ 0 };
+        for ( auto const& [importedDLLName, importedFunctions] : referenceEXEFile.importedDLLToImportedFunctions )
+        {
+            numberOfImportedFunctions += importedFunctions.size();
+        }
+
+        auto const importsSecondsPerIteration =
+            Benchmark::measureBestSecondsPerIteration(
+       [&]
+       {
+           Benchmark::doNotOptimizeAway(
+               PE::extractImportedFunctionsInfo( referenceEXEFile.dataDirectoryEntries,
+                                                 referenceEXEFile.sectionHeadersNameToInfo,
+                                                 referenceEXEFile.sectionNameToRawData ) );
+       },
+       numberOfIterations );
+        reportStage( "imports", importsSecondsPerIteration, 0, numberOfImportedFunctions, "names" );
+
+        auto const exportsSecondsPerIteration =
+            Benchmark::measureBestSecondsPerIteration(
+       [&]
+       {
+           Benchmark::doNotOptimizeAway(
+               PE::extractExportedFunctionsInfo( referenceEXEFile.dataDirectoryEntries,
+                                                 referenceEXEFile.sectionHeadersNameToInfo,
+                                                 referenceEXEFile.sectionNameToRawData ) );
+       },
+       numberOfIterations );
+        reportStage( "exports", exportsSecondsPerIteration, 0, referenceEXEFile.exportedFunctions.size(), "names" );
+
+        // Crash addresses are spread over the whole image.
+        auto const rvaSymbolizer = RVASymbolizer{ referenceEXEFile };
+        auto symbolizedRVAs = std::vector<std::uint32_t>( 1 << 20 );
+        auto randomRVAs = std::mt19937{ 3 };
+        for ( auto& symbolizedRVA : symbolizedRVAs )
+        {
+            symbolizedRVA = randomRVAs() % std::max( 1u, referenceEXEFile.ntOptionalHeader.sizeOfImageInBytes );
+        }
+
+        auto symbolIndices = std::vector<std::uint32_t>( symbolizedRVAs.size() );
+        auto const symbolizeSecondsPerIteration =
+            Benchmark::measureBestSecondsPerIteration(
+       [&]
+       {
+           rvaSymbolizer.findSymbols( symbolizedRVAs, symbolIndices );
+           Benchmark::doNotOptimizeAway( symbolIndices );
+       },
+       numberOfIterations );
+        reportStage( "symbolize", symbolizeSecondsPerIteration, 0, symbolizedRVAs.size(), "lookups" );
+
+        auto codeSizeInBytes = std::uint64_t{ 0 };
+        for ( auto const& [sectionName, sectionHeader] : referenceEXEFile.sectionHeadersNameToInfo )
+        {
+            if ( sectionHeader.sectionCharacteristics & 0x20000000 )
+            {
+                codeSizeInBytes += referenceEXEFile.sectionNameToRawData[sectionName].size();
+            }
+        }
+
+        auto numberOfImportReferences = std::size_t{ 0 };
+        auto const importReferencesSecondsPerIteration =
+            Benchmark::measureBestSecondsPerIteration(
+       [&]
+       {
+           numberOfImportReferences = findImportReferences( referenceEXEFile ).size();
+       },
+       numberOfIterations );
+        reportStage( "import xrefs", importReferencesSecondsPerIteration, codeSizeInBytes,
+                     numberOfImportReferences, "xrefs" );
+
+        auto const compiledSignatures = compileSignatures( makeBenchmarkSignatures( referenceEXEFile, 1000 ) );
+        auto signatureScanResult = SignatureScanResult{};
+        auto const signaturesSecondsPerIteration =
+            Benchmark::measureBestSecondsPerIteration(
+       [&]
+       {
+           signatureScanResult = scanForSignatures( compiledSignatures, referenceEXEFile );
+       },
+       numberOfIterations );
+        reportStage( "signatures x1000", signaturesSecondsPerIteration, signatureScanResult.numberOfScannedBytes,
+                     signatureScanResult.matches.size(), "matches" );
+
+        auto const editedEXEFile = makeEditedCopy( referenceEXEFile );
+        auto numberOfChangedRegions = std::size_t{ 0 };
+        auto const diffSecondsPerIteration =
+            Benchmark::measureBestSecondsPerIteration(
+       [&]
+       {
+           numberOfChangedRegions = 0;
+           for ( auto const& sectionDiff : diffEXEFiles( referenceEXEFile, editedEXEFile ).sectionDiffs )
+           {
+               numberOfChangedRegions += sectionDiff.changedRegions.size();
+           }
+       },
+       numberOfIterations );
+        reportStage( "diff", diffSecondsPerIteration, 2 * fileSizeInBytes, numberOfChangedRegions, "regions" );
+
+        referenceEXEFile = EXEFile{};
+
+        reportStage( "loadEXEFile",
+                     Benchmark::measureBestSecondsPerIteration(
+                         [&]
+                         {
+                             Benchmark::doNotOptimizeAway( loadEXEFile( pathOfImage.string() ) );
+                         },
+                         numberOfIterations ),
+                     fileSizeInBytes );
+        reportStage( "analysis",
+                     Benchmark::measureBestSecondsPerIteration(
+                         [&]
+                         {
+                             auto imageAnalysis = ImageAnalysis{ pathOfImage.string() };
+                             imageAnalysis.runRemainingStages();
+                             Benchmark::doNotOptimizeAway( imageAnalysis.getSectionDigests() );
+                         },
+                         numberOfIterations ),
+                     fileSizeInBytes );
+
+        // Throughput is quoted against the whole file, which these depths
+        // mostly do not read.
+        reportStage( "load headers",
+                     Benchmark::measureBestSecondsPerIteration(
+                         [&]
+                         {
+                             Benchmark::doNotOptimizeAway( loadEXEFile( pathOfImage.string(), ParseDepth::Headers ) );
+                         },
+                         numberOfIterations ),
+                     fileSizeInBytes );
+        reportStage( "load dirs",
+                     Benchmark::measureBestSecondsPerIteration(
+                         [&]
+                         {
+                             Benchmark::doNotOptimizeAway( loadEXEFile( pathOfImage.string(), ParseDepth::Directories ) );
+                         },
+                         numberOfIterations ),
+                     fileSizeInBytes );
+    }
+
+    // Names are drawn with a skew towards low indices, so a few are in
+    // nearly every file and most are rare, as with real imports.
+    std::vector<unsigned char>
+    makeSyntheticCorpusDatabase( std::uint32_t const numberOfFiles )
+    {
+        auto randomNumbers = std::mt19937{ 3 };
+        auto const drawSkewed = [&]( std::uint32_t const numberOfNames )
+        {
+            auto const r = randomNumbers() % numberOfNames;
+            return r * ( randomNumbers() % numberOfNames ) / numberOfNames;
+        };
+
+        auto corpusDatabaseBuilder = CorpusDatabaseBuilder{};
+
+        for ( auto fileIdx = std::uint32_t{ 0 }; fileIdx < numberOfFiles; fileIdx++ )
+        {
+            auto fileRecord = CorpusFileRecord
+            {
+                .path = "corpus/" + std::to_string( fileIdx ) + ".dll",
+                .fileSizeInBytes = 4096 + randomNumbers() % ( 1 << 20 ),
+                .targetMachineArchitecture = 0x8664
+            };
+
+            auto& [importedDLLNames, importedFunctionNames, exportedFunctionNames, sectionNames] = fileRecord.names;
+
+            for ( auto i = 0; i < 8; i++ )
+            {
+                importedDLLNames.push_back( "dll" + std::to_string( drawSkewed( 500 ) ) + ".dll" );
+            }
+
+            for ( auto i = 0; i < 150; i++ )
+            {
+                importedFunctionNames.push_back( "Function" + std::to_string( drawSkewed( 20'000 ) ) );
+            }
+
+            if ( fileIdx % 10 == 0 )
+            {
+                for ( auto i = 0; i < 50; i++ )
+                {
+                    exportedFunctionNames.push_back( "Export" + std::to_string( randomNumbers() % 1'000'000 ) );
+                }
+            }
+
+            sectionNames = { ".text", ".rdata", ".data", ".pdata", fileIdx % 7 == 0 ? ".rsrc" : ".reloc" };
+
+            corpusDatabaseBuilder.addFile( fileRecord );
+        }
+
+        auto databaseOutput = std::ostringstream{};
+        corpusDatabaseBuilder.write( databaseOutput );
+
+        auto const databaseText = std::move( databaseOutput ).str();
+
+        return std::vector<unsigned char>( databaseText.begin(), databaseText.end() );
+    }
+
+    void
+    benchmarkCorpusDatabase( std::uint32_t const numberOfFiles,
+                             int const numberOfIterations )
+    {
+        auto const databaseBytes = makeSyntheticCorpusDatabase( numberOfFiles );
+        auto const corpusDatabase = CorpusDatabase::parse( PE::ByteReader{ databaseBytes } );
+
+        std::cout << "Corpus database (" << databaseBytes.size() << " bytes, " << numberOfFiles << " files, "
+                  << corpusDatabase.getNumberOfNames( CorpusNameKind::ImportedFunction ) << " imported names)\n";
+
+        reportStage( "parse",
+                     Benchmark::measureBestSecondsPerIteration(
+                         [&]
+                         {
+                             Benchmark::doNotOptimizeAway( CorpusDatabase::parse( PE::ByteReader{ databaseBytes } ) );
+                         },
+                         1 ),
+                     databaseBytes.size() );
+
+        // The stages are measured before they are reported, so that the
+        // number of matched files is known.
+        auto numberOfMatchedFiles = std::size_t{ 0 };
+        auto const commonImportSecondsPerIteration =
+            Benchmark::measureBestSecondsPerIteration(
+                [&]
+                {
+                    auto const nameId = corpusDatabase.findName( CorpusNameKind::ImportedFunction, "Function1" );
+                    numberOfMatchedFiles = corpusDatabase.getFilesWithName( CorpusNameKind::ImportedFunction, *nameId ).size();
+                },
+                numberOfIterations );
+        reportStage( "common import", commonImportSecondsPerIteration, 0 );
+        std::cout << "  " << numberOfMatchedFiles << " files import it\n";
+
+        reportStage( "rare import",
+                     Benchmark::measureBestSecondsPerIteration(
+                         [&]
+                         {
+                             auto const nameId = corpusDatabase.findName( CorpusNameKind::ImportedFunction, "Function19000" );
+                             Benchmark::doNotOptimizeAway( nameId );
+                         },
+                         numberOfIterations ),
+                     0 );
+
+        auto const importAndDLLSecondsPerIteration =
+            Benchmark::measureBestSecondsPerIteration(
+                [&]
+                {
+                    auto const functionFiles =
+                        corpusDatabase.getFilesWithName( CorpusNameKind::ImportedFunction,
+                                                         *corpusDatabase.findName( CorpusNameKind::ImportedFunction, "Function1" ) );
+                    auto const dllFiles =
+                        corpusDatabase.getFilesWithName( CorpusNameKind::ImportedDLL,
+                                                         *corpusDatabase.findName( CorpusNameKind::ImportedDLL, "dll1.dll" ) );
+
+                    auto matchedFiles = std::vector<std::uint32_t>{};
+                    std::set_intersection( functionFiles.begin(), functionFiles.end(),
+                                           dllFiles.begin(), dllFiles.end(),
+                                           std::back_inserter( matchedFiles ) );
+                    numberOfMatchedFiles = matchedFiles.size();
+                },
+                numberOfIterations );
+        reportStage( "import and dll", importAndDLLSecondsPerIteration, 0, numberOfMatchedFiles, "files" );
+    }
+
+    void
+    benchmarkCOFFObject( std::filesystem::path const& pathOfObject,
+                         int const numberOfIterations )
+    {
+        auto const fileSizeInBytes = std::filesystem::file_size( pathOfObject );
+
+        reportStage( "read",
+                     Benchmark::measureBestSecondsPerIteration(
+                         [&]
+                         {
+                             Benchmark::doNotOptimizeAway( loadPEFileAsRawBytes( pathOfObject.string() ) );
+                         },
+                         numberOfIterations ),
+                     fileSizeInBytes );
+
+        reportStage( "loadOBJFile",
+                     Benchmark::measureBestSecondsPerIteration(
+                         [&]
+                         {
+                             Benchmark::doNotOptimizeAway( loadOBJFile( pathOfObject.string() ) );
+                         },
+                         numberOfIterations ),
+                     fileSizeInBytes );
+    }
+}
+
+int
+main( int argCount, char** args )
+{
+    try
+    {
+        auto const benchmarkOptions = parseBenchmarkOptions( argCount, args );
+
+        std::filesystem::create_directories( benchmarkOptions.workingDirectory );
+
+        std::cout << std::fixed << std::setprecision( 3 );
+
+        for ( auto const imageKind : { SyntheticPE::ImageKind::PE32Plus,
+                                       SyntheticPE::ImageKind::PE32,
+                                       SyntheticPE::ImageKind::COFFObject } )
+        {
+            auto imageOptions = benchmarkOptions.imageOptions;
+            imageOptions.kind = imageKind;
+
+            auto const pathOfImage =
+                benchmarkOptions.workingDirectory /
+                ( imageKind == SyntheticPE::ImageKind::COFFObject
+                    ? "synthetic.obj"
+                    : imageKind == SyntheticPE::ImageKind::PE32 ? "synthetic32.dll" : "synthetic64.dll" );
+
+            auto const fileSizeInBytes = SyntheticPE::writeImage( pathOfImage.string(), imageOptions );
+
+            std::cout << SyntheticPE::getImageKindName( imageKind ) << " (" << fileSizeInBytes << " bytes, "
+                      << imageOptions.numberOfSections << " sections)\n";
+
+            if ( imageKind == SyntheticPE::ImageKind::PE32Plus )
+            {
+                benchmarkPE32PlusStages( pathOfImage, benchmarkOptions.numberOfIterations );
+            }
+            else if ( imageKind == SyntheticPE::ImageKind::COFFObject )
+            {
+                benchmarkCOFFObject( pathOfImage, benchmarkOptions.numberOfIterations );
+            }
+            else
+            {
+                try
+                {
+                    loadEXEFile( pathOfImage.string() );
+                    std::cout << "  loaded\n";
+                }
+                catch ( std::runtime_error const& loadingError )
+                {
+                    std::cout << "  skipped: " << loadingError.what() << '\n';
+                }
+            }
+
+            if ( not benchmarkOptions.keepGeneratedFiles )
+            {
+                std::filesystem::remove( pathOfImage );
+            }
+        }
+
+        benchmarkCorpusDatabase( benchmarkOptions.numberOfCorpusFiles, benchmarkOptions.numberOfIterations );
+    }
+    catch ( std::exception const& benchmarkError )
+    {
+        std::cerr << "ewea-bench: " << benchmarkError.what() << '\n'
+                  << "Usage: ewea-bench [--sections N] [--dlls N] [--imports-per-dll N] [--exports N]\n"
+                  << "                  [--relocations N] [--size BYTES[K|M|G]] [--seed N]\n"
+                  << "                  [--iterations N] [--corpus-files N] [--work-dir DIR] [--keep]\n";
+        return 1;
+    }
+
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,624 @@
+
+#include "SyntheticPEGenerator.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+namespace
+{
+    auto const fileAlignment = std::uint32_t{ 0x200 };
+    auto const sectionAlignment = std::uint32_t{ 0x1000 };
+    auto const ntSignatureOffset = std::uint32_t{ 0x80 };
+    auto const numberOfDataDirectories = 16;
+    auto const maximumBulkSectionSizeInBytes = std::uint64_t{ 0x7FFFF000 };
+    auto const fillerChunkSizeInBytes = std::size_t{ 1 } << 20;
+
+    auto const exportTableIdx = 0;
+    auto const importTableIdx = 1;
+    auto const importAddressTableIdx = 12;
+
+    auto const sectionCharacteristics_Code = std::uint32_t{ 0x60000020 };
+    auto const sectionCharacteristics_ReadOnlyData = std::uint32_t{ 0x40000040 };
+    auto const sectionCharacteristics_ReadWriteData = std::uint32_t{ 0xC0000040 };
+    auto const sectionCharacteristics_COMDAT = std::uint32_t{ 0x00001000 };
+
+    class DeterministicByteSource
+    {
+    public:
+        explicit DeterministicByteSource( std::uint64_t const seed )
+        : m_state( seed * 0x9E3779B97F4A7C15ull + 1 )
+        {
+        }
+
+        std::uint64_t
+        next()
+        {
+            auto mixedState = ( m_state += 0x9E3779B97F4A7C15ull );
+            mixedState = ( mixedState ^ ( mixedState >> 30 ) ) * 0xBF58476D1CE4E5B9ull;
+            mixedState = ( mixedState ^ ( mixedState >> 27 ) ) * 0x94D049BB133111EBull;
+
+            return mixedState ^ ( mixedState >> 31 );
+        }
+
+        void
+        fill( unsigned char* bytes,
+              std::size_t const numberOfBytes )
+        {
+            auto i = std::size_t{ 0 };
+
+            for ( ; i + sizeof( std::uint64_t ) <= numberOfBytes; i += sizeof( std::uint64_t ) )
+            {
+                auto const randomWord = next();
+                std::memcpy( bytes + i, &randomWord, sizeof( randomWord ) );
+            }
+
+            for ( auto const randomWord = next(); i < numberOfBytes; i++ )
+            {
+                bytes[i] = static_cast<unsigned char>( randomWord >> ( 8 * ( i % 8 ) ) );
+            }
+        }
+
+    private:
+        std::uint64_t    m_state;
+    };
+
+    struct PlannedImage
+    {
+        std::vector<unsigned char>    structuredBytes;
+        std::uint64_t                 fillerSizeInBytes = 0;
+    };
+
+    template <typename T>
+    void
+    putValue( std::vector<unsigned char>& bytes,
+              std::size_t const offset,
+              T const value )
+    {
+        if ( bytes.size() < offset + sizeof( T ) )
+        {
+            bytes.resize( offset + sizeof( T ) );
+        }
+
+        std::memcpy( bytes.data() + offset, &value, sizeof( T ) );
+    }
+
+    void
+    putString( std::vector<unsigned char>& bytes,
+               std::size_t const offset,
+               std::string const& value )
+    {
+        if ( bytes.size() < offset + value.size() + 1 )
+        {
+            bytes.resize( offset + value.size() + 1 );
+        }
+
+        std::memcpy( bytes.data() + offset, value.c_str(), value.size() + 1 );
+    }
+
+    template <typename T>
+    T
+    alignUp( T const value,
+             T const alignment )
+    {
+        return ( value + alignment - 1 ) / alignment * alignment;
+    }
+
+    std::string
+    getNumberedName( char const* prefix,
+                     int const number,
+                     int const width )
+    {
+        auto numberAsString = std::to_string( number );
+        if ( numberAsString.size() < static_cast<std::size_t>( width ) )
+        {
+            numberAsString.insert( 0, width - numberAsString.size(), '0' );
+        }
+
+        return prefix + numberAsString;
+    }
+
+    struct SectionPlan
+    {
+        std::string                   name;
+        std::uint32_t                 characteristics = 0;
+        std::vector<unsigned char>    contents;
+        std::uint32_t                 rva = 0;
+        std::uint32_t                 fileOffset = 0;
+        std::uint64_t                 rawSizeInBytes = 0;
+    };
+
+    std::vector<unsigned char>
+    buildImportSectionContents( SyntheticPE::ImageOptions const& imageOptions,
+                                std::uint32_t const sectionRVA,
+                                std::uint32_t& importDirectorySizeInBytes,
+                                std::uint32_t& importAddressTableRVA,
+                                std::uint32_t& importAddressTableSizeInBytes )
+    {
+        auto const is64bit = imageOptions.kind == SyntheticPE::ImageKind::PE32Plus;
+        auto const thunkSizeInBytes = std::size_t{ is64bit ? 8u : 4u };
+        auto const numberOfDLLs = std::max( imageOptions.numberOfImportedDLLs, 0 );
+        auto const numberOfImportsPerDLL = std::max( imageOptions.numberOfImportsPerDLL, 0 );
+        auto const thunkTableSizeInBytes = ( numberOfImportsPerDLL + 1 ) * thunkSizeInBytes;
+
+        auto contents = std::vector<unsigned char>{};
+
+        if ( numberOfDLLs == 0 )
+        {
+            return contents;
+        }
+
+        importDirectorySizeInBytes = ( numberOfDLLs + 1 ) * 20;
+
+        auto const lookupTablesOffset = std::size_t{ importDirectorySizeInBytes };
+        auto const addressTablesOffset = lookupTablesOffset + numberOfDLLs * thunkTableSizeInBytes;
+        auto namesOffset = addressTablesOffset + numberOfDLLs * thunkTableSizeInBytes;
+
+        importAddressTableRVA = sectionRVA + static_cast<std::uint32_t>( addressTablesOffset );
+        importAddressTableSizeInBytes = static_cast<std::uint32_t>( numberOfDLLs * thunkTableSizeInBytes );
+
+        contents.resize( namesOffset );
+
+        for ( auto dllIdx = 0; dllIdx < numberOfDLLs; dllIdx++ )
+        {
+            auto const lookupTableOffset = lookupTablesOffset + dllIdx * thunkTableSizeInBytes;
+            auto const addressTableOffset = addressTablesOffset + dllIdx * thunkTableSizeInBytes;
+
+            for ( auto functionIdx = 0; functionIdx < numberOfImportsPerDLL; functionIdx++ )
+            {
+                auto const hintNameEntryRVA = sectionRVA + static_cast<std::uint32_t>( namesOffset );
+
+                putValue<std::uint16_t>( contents, namesOffset, static_cast<std::uint16_t>( functionIdx ) );
+                putString( contents,
+                           namesOffset + sizeof( std::uint16_t ),
+                           getNumberedName( "SyntheticFunction_", dllIdx * numberOfImportsPerDLL + functionIdx, 6 ) );
+                namesOffset = alignUp( contents.size(), std::size_t{ 2 } );
+
+                if ( is64bit )
+                {
+                    putValue<std::uint64_t>( contents, lookupTableOffset + functionIdx * thunkSizeInBytes, hintNameEntryRVA );
+                    putValue<std::uint64_t>( contents, addressTableOffset + functionIdx * thunkSizeInBytes, hintNameEntryRVA );
+                }
+                else
+                {
+                    putValue<std::uint32_t>( contents, lookupTableOffset + functionIdx * thunkSizeInBytes, hintNameEntryRVA );
+                    putValue<std::uint32_t>( contents, addressTableOffset + functionIdx * thunkSizeInBytes, hintNameEntryRVA );
+                }
+            }
+
+            auto const dllNameRVA = sectionRVA + static_cast<std::uint32_t>( namesOffset );
+            putString( contents, namesOffset, getNumberedName( "synthetic", dllIdx, 4 ) + ".dll" );
+            namesOffset = alignUp( contents.size(), std::size_t{ 2 } );
+
+            auto const descriptorOffset = std::size_t( dllIdx ) * 20;
+            putValue<std::uint32_t>( contents, descriptorOffset + 0, sectionRVA + static_cast<std::uint32_t>( lookupTableOffset ) );
+            putValue<std::uint32_t>( contents, descriptorOffset + 12, dllNameRVA );
+            putValue<std::uint32_t>( contents, descriptorOffset + 16, sectionRVA + static_cast<std::uint32_t>( addressTableOffset ) );
+        }
+
+        return contents;
+    }
+
+    std::vector<unsigned char>
+    buildExportSectionContents( SyntheticPE::ImageOptions const& imageOptions,
+                                std::uint32_t const sectionRVA,
+                                std::uint32_t const codeSectionRVA )
+    {
+        auto const numberOfExports = std::max( imageOptions.numberOfExports, 0 );
+
+        auto contents = std::vector<unsigned char>{};
+
+        auto const addressTableOffset = std::size_t{ 40 };
+        auto const namePointerTableOffset = addressTableOffset + numberOfExports * 4;
+        auto const ordinalTableOffset = namePointerTableOffset + numberOfExports * 4;
+        auto namesOffset = alignUp( ordinalTableOffset + numberOfExports * 2, std::size_t{ 4 } );
+
+        contents.resize( namesOffset );
+
+        auto const dllNameRVA = sectionRVA + static_cast<std::uint32_t>( namesOffset );
+        putString( contents, namesOffset, "synthetic.dll" );
+        namesOffset = contents.size();
+
+        for ( auto exportIdx = 0; exportIdx < numberOfExports; exportIdx++ )
+        {
+            auto const exportNameRVA = sectionRVA + static_cast<std::uint32_t>( namesOffset );
+            putString( contents, namesOffset, getNumberedName( "SyntheticExport_", exportIdx, 6 ) );
+            namesOffset = contents.size();
+
+            putValue<std::uint32_t>( contents, addressTableOffset + exportIdx * 4, codeSectionRVA + exportIdx * 16 );
+            putValue<std::uint32_t>( contents, namePointerTableOffset + exportIdx * 4, exportNameRVA );
+            putValue<std::uint16_t>( contents, ordinalTableOffset + exportIdx * 2, static_cast<std::uint16_t>( exportIdx ) );
+        }
+
+        putValue<std::uint32_t>( contents, 12, dllNameRVA );
+        putValue<std::uint32_t>( contents, 16, 1 );
+        putValue<std::uint32_t>( contents, 20, numberOfExports );
+        putValue<std::uint32_t>( contents, 24, numberOfExports );
+        putValue<std::uint32_t>( contents, 28, sectionRVA + static_cast<std::uint32_t>( addressTableOffset ) );
+        putValue<std::uint32_t>( contents, 32, sectionRVA + static_cast<std::uint32_t>( namePointerTableOffset ) );
+        putValue<std::uint32_t>( contents, 36, sectionRVA + static_cast<std::uint32_t>( ordinalTableOffset ) );
+
+        return contents;
+    }
+
+    void
+    putSectionHeader( std::vector<unsigned char>& bytes,
+                      std::size_t const offset,
+                      SectionPlan const& sectionPlan,
+                      std::uint32_t const virtualSizeInBytes,
+                      std::uint32_t const pointerToRelocations,
+                      std::uint16_t const numberOfRelocations )
+    {
+        auto sectionName = sectionPlan.name;
+        sectionName.resize( 8, '\0' );
+
+        if ( bytes.size() < offset + 40 )
+        {
+            bytes.resize( offset + 40 );
+        }
+
+        std::memcpy( bytes.data() + offset, sectionName.data(), 8 );
+        putValue<std::uint32_t>( bytes, offset + 8, virtualSizeInBytes );
+        putValue<std::uint32_t>( bytes, offset + 12, sectionPlan.rva );
+        putValue<std::uint32_t>( bytes, offset + 16, static_cast<std::uint32_t>( sectionPlan.rawSizeInBytes ) );
+        putValue<std::uint32_t>( bytes, offset + 20, sectionPlan.rawSizeInBytes != 0 ? sectionPlan.fileOffset : 0 );
+        putValue<std::uint32_t>( bytes, offset + 24, pointerToRelocations );
+        putValue<std::uint16_t>( bytes, offset + 32, numberOfRelocations );
+        putValue<std::uint32_t>( bytes, offset + 36, sectionPlan.characteristics );
+    }
+
+    PlannedImage
+    planPEImage( SyntheticPE::ImageOptions const& imageOptions )
+    {
+        auto const is64bit = imageOptions.kind == SyntheticPE::ImageKind::PE32Plus;
+        auto const optionalHeaderSizeInBytes =
+            std::uint32_t( ( is64bit ? 112 : 96 ) + numberOfDataDirectories * 8 );
+
+        auto byteSource = DeterministicByteSource{ imageOptions.seed };
+
+        auto sectionPlans = std::vector<SectionPlan>{};
+        sectionPlans.push_back( SectionPlan{ .name = ".text", .characteristics = sectionCharacteristics_Code } );
+        sectionPlans.push_back( SectionPlan{ .name = ".rdata", .characteristics = sectionCharacteristics_ReadOnlyData } );
+        if ( imageOptions.numberOfExports > 0 )
+        {
+            sectionPlans.push_back( SectionPlan{ .name = ".edata", .characteristics = sectionCharacteristics_ReadOnlyData } );
+        }
+        sectionPlans.push_back( SectionPlan{ .name = ".data", .characteristics = sectionCharacteristics_ReadWriteData } );
+        for ( auto extraSectionIdx = 0;
+              static_cast<int>( sectionPlans.size() ) < imageOptions.numberOfSections;
+              extraSectionIdx++ )
+        {
+            sectionPlans.push_back( SectionPlan{ .name = getNumberedName( ".s", extraSectionIdx, 6 ),
+                                                 .characteristics = sectionCharacteristics_ReadOnlyData } );
+        }
+
+        auto& codeSectionPlan = sectionPlans.front();
+
+        auto const sectionTableOffset = ntSignatureOffset + 4 + 20 + optionalHeaderSizeInBytes;
+        auto const sizeOfHeaders =
+            alignUp<std::uint32_t>( sectionTableOffset + static_cast<std::uint32_t>( sectionPlans.size() ) * 40,
+                                    fileAlignment );
+
+        auto const buildSectionContents =
+            [&]( SectionPlan& sectionPlan,
+                 std::vector<std::uint32_t>& dataDirectories )
+            {
+                if ( sectionPlan.name == ".rdata" )
+                {
+                    auto importDirectorySizeInBytes = std::uint32_t{ 0 };
+                    auto importAddressTableRVA = std::uint32_t{ 0 };
+                    auto importAddressTableSizeInBytes = std::uint32_t{ 0 };
+
+                    sectionPlan.contents =
+                        buildImportSectionContents( imageOptions, sectionPlan.rva,
+                                                    importDirectorySizeInBytes,
+                                                    importAddressTableRVA,
+                                                    importAddressTableSizeInBytes );
+
+                    if ( importDirectorySizeInBytes != 0 )
+                    {
+                        dataDirectories[importTableIdx * 2] = sectionPlan.rva;
+                        dataDirectories[importTableIdx * 2 + 1] = importDirectorySizeInBytes;
+                        dataDirectories[importAddressTableIdx * 2] = importAddressTableRVA;
+                        dataDirectories[importAddressTableIdx * 2 + 1] = importAddressTableSizeInBytes;
+                    }
+                }
+                else if ( sectionPlan.name == ".edata" )
+                {
+                    sectionPlan.contents = buildExportSectionContents( imageOptions, sectionPlan.rva, codeSectionPlan.rva );
+
+                    dataDirectories[exportTableIdx * 2] = sectionPlan.rva;
+                    dataDirectories[exportTableIdx * 2 + 1] = static_cast<std::uint32_t>( sectionPlan.contents.size() );
+                }
+                else if ( sectionPlan.contents.empty() )
+                {
+                    sectionPlan.contents.resize( fileAlignment );
+                    byteSource.fill( sectionPlan.contents.data(), sectionPlan.contents.size() );
+                }
+            };
+
+        auto dataDirectories = std::vector<std::uint32_t>( numberOfDataDirectories * 2 );
+
+        auto nextFileOffset = std::uint64_t{ sizeOfHeaders };
+        for ( auto& sectionPlan : sectionPlans )
+        {
+            if ( &sectionPlan == &codeSectionPlan )
+            {
+                continue;
+            }
+
+            buildSectionContents( sectionPlan, dataDirectories );
+            sectionPlan.fileOffset = static_cast<std::uint32_t>( nextFileOffset );
+            sectionPlan.rawSizeInBytes = alignUp<std::uint64_t>( sectionPlan.contents.size(), fileAlignment );
+            nextFileOffset += sectionPlan.rawSizeInBytes;
+        }
+
+        auto image = PlannedImage{};
+
+        auto const remainingSizeInBytes =
+            imageOptions.minimumFileSizeInBytes > nextFileOffset ? imageOptions.minimumFileSizeInBytes - nextFileOffset : 0;
+        codeSectionPlan.fileOffset = static_cast<std::uint32_t>( nextFileOffset );
+        codeSectionPlan.rawSizeInBytes =
+            std::clamp<std::uint64_t>( alignUp<std::uint64_t>( remainingSizeInBytes, fileAlignment ),
+                                       fileAlignment,
+                                       maximumBulkSectionSizeInBytes );
+        image.fillerSizeInBytes = std::max( remainingSizeInBytes, codeSectionPlan.rawSizeInBytes );
+
+        auto nextRVA = alignUp( sizeOfHeaders, sectionAlignment );
+        for ( auto& sectionPlan : sectionPlans )
+        {
+            sectionPlan.rva = nextRVA;
+            nextRVA = alignUp<std::uint32_t>( nextRVA + static_cast<std::uint32_t>( sectionPlan.rawSizeInBytes ),
+                                              sectionAlignment );
+        }
+
+        for ( auto& sectionPlan : sectionPlans )
+        {
+            if ( &sectionPlan != &codeSectionPlan )
+            {
+                buildSectionContents( sectionPlan, dataDirectories );
+            }
+        }
+
+        auto& bytes = image.structuredBytes;
+        bytes.resize( sizeOfHeaders );
+
+        putValue<std::uint16_t>( bytes, 0, 0x5A4D );
+        putValue<std::uint32_t>( bytes, 60, ntSignatureOffset );
+        putValue<std::uint32_t>( bytes, ntSignatureOffset, 0x00004550 );
+
+        auto const fileHeaderOffset = ntSignatureOffset + 4;
+        putValue<std::uint16_t>( bytes, fileHeaderOffset + 0, is64bit ? 0x8664 : 0x014C );
+        putValue<std::uint16_t>( bytes, fileHeaderOffset + 2, static_cast<std::uint16_t>( sectionPlans.size() ) );
+        putValue<std::uint32_t>( bytes, fileHeaderOffset + 4, imageOptions.seed );
+        putValue<std::uint16_t>( bytes, fileHeaderOffset + 16, static_cast<std::uint16_t>( optionalHeaderSizeInBytes ) );
+        putValue<std::uint16_t>( bytes, fileHeaderOffset + 18, is64bit ? 0x2022 : 0x2102 );
+
+        auto const optionalHeaderOffset = fileHeaderOffset + 20;
+        putValue<std::uint16_t>( bytes, optionalHeaderOffset + 0, is64bit ? 0x020B : 0x010B );
+        putValue<std::uint8_t>( bytes, optionalHeaderOffset + 2, 14 );
+        putValue<std::uint8_t>( bytes, optionalHeaderOffset + 3, 30 );
+        putValue<std::uint32_t>( bytes, optionalHeaderOffset + 4, static_cast<std::uint32_t>( codeSectionPlan.rawSizeInBytes ) );
+        putValue<std::uint32_t>( bytes, optionalHeaderOffset + 8, static_cast<std::uint32_t>( codeSectionPlan.fileOffset - sizeOfHeaders ) );
+        putValue<std::uint32_t>( bytes, optionalHeaderOffset + 16, codeSectionPlan.rva );
+        putValue<std::uint32_t>( bytes, optionalHeaderOffset + 20, codeSectionPlan.rva );
+
+        auto const windowsFieldsOffset = optionalHeaderOffset + 24;
+        if ( is64bit )
+        {
+            putValue<std::uint64_t>( bytes, windowsFieldsOffset, 0x140000000ull );
+        }
+        else
+        {
+            putValue<std::uint32_t>( bytes, optionalHeaderOffset + 24, sectionPlans[1].rva );
+            putValue<std::uint32_t>( bytes, optionalHeaderOffset + 28, 0x00400000 );
+        }
+        putValue<std::uint32_t>( bytes, windowsFieldsOffset + 8, sectionAlignment );
+        putValue<std::uint32_t>( bytes, windowsFieldsOffset + 12, fileAlignment );
+        putValue<std::uint16_t>( bytes, windowsFieldsOffset + 16, 6 );
+        putValue<std::uint16_t>( bytes, windowsFieldsOffset + 24, 6 );
+        putValue<std::uint32_t>( bytes, windowsFieldsOffset + 32, nextRVA );
+        putValue<std::uint32_t>( bytes, windowsFieldsOffset + 36, sizeOfHeaders );
+        putValue<std::uint16_t>( bytes, windowsFieldsOffset + 44, 3 );
+        putValue<std::uint16_t>( bytes, windowsFieldsOffset + 46, 0x8160 );
+
+        auto const dataDirectoriesOffset = optionalHeaderOffset + optionalHeaderSizeInBytes - numberOfDataDirectories * 8;
+        putValue<std::uint32_t>( bytes, dataDirectoriesOffset - 4, numberOfDataDirectories );
+        for ( auto i = std::size_t{ 0 }; i < dataDirectories.size(); i++ )
+        {
+            putValue<std::uint32_t>( bytes, dataDirectoriesOffset + i * 4, dataDirectories[i] );
+        }
+
+        for ( auto i = std::size_t{ 0 }; i < sectionPlans.size(); i++ )
+        {
+            auto const& sectionPlan = sectionPlans[i];
+            auto const virtualSizeInBytes =
+                sectionPlan.contents.empty() ? static_cast<std::uint32_t>( sectionPlan.rawSizeInBytes )
+                                             : static_cast<std::uint32_t>( sectionPlan.contents.size() );
+
+            putSectionHeader( bytes, sectionTableOffset + i * 40, sectionPlan, virtualSizeInBytes, 0, 0 );
+        }
+
+        bytes.resize( codeSectionPlan.fileOffset );
+        for ( auto const& sectionPlan : sectionPlans )
+        {
+            std::copy( sectionPlan.contents.begin(), sectionPlan.contents.end(),
+                       bytes.begin() + sectionPlan.fileOffset );
+        }
+
+        return image;
+    }
+
+    PlannedImage
+    planCOFFObject( SyntheticPE::ImageOptions const& imageOptions )
+    {
+        auto const numberOfSections = std::max( imageOptions.numberOfSections, 1 );
+        auto const numberOfRelocations =
+            static_cast<std::uint16_t>( std::clamp( imageOptions.numberOfRelocationsPerSection, 0, 0xFFFF ) );
+
+        auto const sectionNamesAndCharacteristics =
+            std::vector<std::pair<char const*, std::uint32_t>>
+            {
+                { ".text$mn", sectionCharacteristics_Code | sectionCharacteristics_COMDAT },
+                { ".data", sectionCharacteristics_ReadWriteData },
+                { ".rdata", sectionCharacteristics_ReadOnlyData | sectionCharacteristics_COMDAT },
+                { ".xdata", sectionCharacteristics_ReadOnlyData | sectionCharacteristics_COMDAT },
+                { ".pdata", sectionCharacteristics_ReadOnlyData | sectionCharacteristics_COMDAT },
+                { ".debug$S", 0x42100040 },
+            };
+
+        auto byteSource = DeterministicByteSource{ imageOptions.seed };
+
+        auto sectionPlans = std::vector<SectionPlan>( numberOfSections );
+        for ( auto i = 0; i < numberOfSections; i++ )
+        {
+            auto const& [sectionName, characteristics] =
+                sectionNamesAndCharacteristics[i % sectionNamesAndCharacteristics.size()];
+
+            sectionPlans[i].name = i + 1 == numberOfSections ? ".text$mn" : sectionName;
+            sectionPlans[i].characteristics =
+                i + 1 == numberOfSections ? sectionCharacteristics_Code : characteristics;
+
+            if ( i + 1 != numberOfSections )
+            {
+                sectionPlans[i].contents.resize( 16 + byteSource.next() % 2048 );
+                byteSource.fill( sectionPlans[i].contents.data(), sectionPlans[i].contents.size() );
+            }
+        }
+
+        auto const sectionTableOffset = std::uint32_t{ 20 };
+        auto nextFileOffset = sectionTableOffset + static_cast<std::uint32_t>( numberOfSections ) * 40;
+
+        auto image = PlannedImage{};
+        auto& bytes = image.structuredBytes;
+
+        putValue<std::uint16_t>( bytes, 0, 0x8664 );
+        putValue<std::uint16_t>( bytes, 2, static_cast<std::uint16_t>( numberOfSections ) );
+        putValue<std::uint32_t>( bytes, 4, imageOptions.seed );
+        bytes.resize( nextFileOffset );
+
+        for ( auto i = 0; i < numberOfSections; i++ )
+        {
+            auto& sectionPlan = sectionPlans[i];
+
+            auto const relocationsOffset = nextFileOffset;
+            for ( auto relocationIdx = 0; relocationIdx < numberOfRelocations; relocationIdx++ )
+            {
+                auto const relocationOffset = relocationsOffset + relocationIdx * 10;
+                putValue<std::uint32_t>( bytes, relocationOffset + 0, relocationIdx * 8 );
+                putValue<std::uint32_t>( bytes, relocationOffset + 4, relocationIdx );
+                putValue<std::uint16_t>( bytes, relocationOffset + 8, 0x0004 );
+            }
+            nextFileOffset += numberOfRelocations * 10;
+
+            sectionPlan.fileOffset = nextFileOffset;
+            sectionPlan.rawSizeInBytes = sectionPlan.contents.size();
+
+            if ( i + 1 == numberOfSections )
+            {
+                auto const remainingSizeInBytes =
+                    imageOptions.minimumFileSizeInBytes > nextFileOffset
+                        ? imageOptions.minimumFileSizeInBytes - nextFileOffset
+                        : 0;
+                sectionPlan.rawSizeInBytes =
+                    std::clamp<std::uint64_t>( remainingSizeInBytes, 16, maximumBulkSectionSizeInBytes );
+                image.fillerSizeInBytes = std::max( remainingSizeInBytes, sectionPlan.rawSizeInBytes );
+            }
+            else
+            {
+                bytes.insert( bytes.end(), sectionPlan.contents.begin(), sectionPlan.contents.end() );
+                nextFileOffset += static_cast<std::uint32_t>( sectionPlan.rawSizeInBytes );
+            }
+
+            putSectionHeader( bytes, sectionTableOffset + i * 40, sectionPlan, 0,
+                              numberOfRelocations != 0 ? relocationsOffset : 0,
+                              numberOfRelocations );
+        }
+
+        return image;
+    }
+
+    PlannedImage
+    planImage( SyntheticPE::ImageOptions const& imageOptions )
+    {
+        if ( imageOptions.kind == SyntheticPE::ImageKind::COFFObject )
+        {
+            return planCOFFObject( imageOptions );
+        }
+
+        return planPEImage( imageOptions );
+    }
+}
+
+namespace SyntheticPE
+{
+    std::vector<unsigned char>
+    buildImage( ImageOptions const& imageOptions )
+    {
+        auto plannedImage = planImage( imageOptions );
+        auto& imageBytes = plannedImage.structuredBytes;
+
+        auto const structuredSizeInBytes = imageBytes.size();
+        imageBytes.resize( structuredSizeInBytes + plannedImage.fillerSizeInBytes );
+
+        auto byteSource = DeterministicByteSource{ imageOptions.seed ^ 0xF111E7u };
+        byteSource.fill( imageBytes.data() + structuredSizeInBytes, plannedImage.fillerSizeInBytes );
+
+        return imageBytes;
+    }
+
+    std::uint64_t
+    writeImage( std::string const& pathOfImageToWrite,
+                ImageOptions const& imageOptions )
+    {
+        auto const plannedImage = planImage( imageOptions );
+
+        auto imageFile = std::ofstream{ pathOfImageToWrite, std::ios::binary | std::ios::trunc };
+
+        if ( not imageFile.is_open() )
+        {
+            throw std::runtime_error{ "Failed to create '" + pathOfImageToWrite + "'." };
+        }
+
+        imageFile.write( reinterpret_cast<char const*>( plannedImage.structuredBytes.data() ),
+                         plannedImage.structuredBytes.size() );
+
+        auto byteSource = DeterministicByteSource{ imageOptions.seed ^ 0xF111E7u };
+        auto fillerChunk = std::vector<unsigned char>( fillerChunkSizeInBytes );
+
+        for ( auto remainingSizeInBytes = plannedImage.fillerSizeInBytes; remainingSizeInBytes != 0; )
+        {
+            auto const chunkSizeInBytes =
+                static_cast<std::size_t>( std::min<std::uint64_t>( remainingSizeInBytes, fillerChunk.size() ) );
+
+            byteSource.fill( fillerChunk.data(), chunkSizeInBytes );
+            imageFile.write( reinterpret_cast<char const*>( fillerChunk.data() ), chunkSizeInBytes );
+
+            remainingSizeInBytes -= chunkSizeInBytes;
+        }
+
+        if ( not imageFile )
+        {
+            throw std::runtime_error{ "Failed to write '" + pathOfImageToWrite + "'." };
+        }
+
+        return plannedImage.structuredBytes.size() + plannedImage.fillerSizeInBytes;
+    }
+
+    std::string
+    getImageKindName( ImageKind const imageKind )
+    {
+        switch ( imageKind )
+        {
+            case ImageKind::PE32:
+                return "PE32";
+            case ImageKind::PE32Plus:
+                return "PE32+";
+            case ImageKind::COFFObject:
+                return "COFF";
+            default:
+                return "<Unknown image kind>";
+        }
+    }
+}
\ No newline at end of file
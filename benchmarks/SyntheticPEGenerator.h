@@ -0,0 +1,41 @@
+
+#ifndef SYNTHETICPEGENERATOR_H
+#define SYNTHETICPEGENERATOR_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace SyntheticPE
+{
+    enum class ImageKind
+    {
+        PE32,
+        PE32Plus,
+        COFFObject
+    };
+
+    struct ImageOptions
+    {
+        ImageKind        kind = ImageKind::PE32Plus;
+        int              numberOfSections = 4;
+        int              numberOfImportedDLLs = 8;
+        int              numberOfImportsPerDLL = 32;
+        int              numberOfExports = 256;
+        int              numberOfRelocationsPerSection = 16;
+        std::uint64_t    minimumFileSizeInBytes = 0;
+        std::uint32_t    seed = 1;
+    };
+
+    std::vector<unsigned char>
+    buildImage( ImageOptions const& imageOptions );
+
+    std::uint64_t
+    writeImage( std::string const& pathOfImageToWrite,
+                ImageOptions const& imageOptions );
+
+    std::string
+    getImageKindName( ImageKind const imageKind );
+}
+
+#endif // SYNTHETICPEGENERATOR_H
\ No newline at end of file
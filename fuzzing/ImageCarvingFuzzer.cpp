@@ -0,0 +1,37 @@
+
+#include "ImageCarving.h"
+#include "PEFiles.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <stdexcept>
+
+extern "C" int
+LLVMFuzzerTestOneInput( std::uint8_t const* fuzzedBytes, std::size_t fuzzedBytesCount )
+{
+    auto const blob = PE::ByteReader{ fuzzedBytes, fuzzedBytesCount };
+
+    auto previousOffset = std::uint64_t{ 0 };
+    for ( auto const& carvedImage : carveEmbeddedImages( blob ) )
+    {
+        // Images come back ordered and inside the blob, however they claim to end.
+        if (    carvedImage.offset < previousOffset
+             or carvedImage.offset >= fuzzedBytesCount
+             or carvedImage.sizeInBytes > fuzzedBytesCount - carvedImage.offset )
+        {
+            std::abort();
+        }
+        previousOffset = carvedImage.offset;
+
+        try
+        {
+            parseEXEFile( PE::ByteReader{ fuzzedBytes + carvedImage.offset, carvedImage.sizeInBytes } );
+        }
+        catch ( std::runtime_error const& )
+        {
+        }
+    }
+
+    return 0;
+}
\ No newline at end of file
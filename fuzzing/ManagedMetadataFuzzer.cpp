@@ -0,0 +1,58 @@
+
+#include "ManagedMetadata.h"
+#include "PEFiles.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+
+extern "C" int
+LLVMFuzzerTestOneInput( std::uint8_t const* fuzzedBytes, std::size_t fuzzedBytesCount )
+{
+    auto const rawBytes = PE::ByteReader{ fuzzedBytes, fuzzedBytesCount };
+
+    try
+    {
+        auto const loadedEXEFile = parseEXEFile( rawBytes );
+        if ( not hasManagedMetadata( loadedEXEFile ) )
+        {
+            return 0;
+        }
+
+        auto const managedMetadata = ManagedMetadata{ loadedEXEFile };
+
+        // Every cell, so that each column width and heap index is read the
+        // way the metadata tab and batch output read them.
+        for ( auto tableIdx = std::size_t{ 0 }; tableIdx < numberOfMetadataTables; tableIdx++ )
+        {
+            auto const metadataTable = static_cast<MetadataTable>( tableIdx );
+            auto const numberOfColumns = getMetadataColumns( metadataTable ).size();
+
+            for ( auto rowIdx = std::uint32_t{ 0 }; rowIdx < managedMetadata.getNumberOfRows( metadataTable ); rowIdx++ )
+            {
+                for ( auto columnIdx = std::size_t{ 0 }; columnIdx < numberOfColumns; columnIdx++ )
+                {
+                    managedMetadata.formatCell( metadataTable, rowIdx, columnIdx );
+                }
+            }
+        }
+
+        // The user strings are only reached through method bodies, so a few
+        // indices into the heap stand in for them.
+        for ( auto const& metadataStream : managedMetadata.getStreams() )
+        {
+            if ( metadataStream.name == "#US" )
+            {
+                for ( auto userStringIdx = std::uint32_t{ 0 }; userStringIdx < metadataStream.sizeInBytes; userStringIdx += 7 )
+                {
+                    managedMetadata.getUserString( userStringIdx );
+                }
+            }
+        }
+    }
+    catch ( std::runtime_error const& )
+    {
+    }
+
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,30 @@
+
+#include "PEFiles.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+
+extern "C" int
+LLVMFuzzerTestOneInput( std::uint8_t const* fuzzedBytes, std::size_t fuzzedBytesCount )
+{
+    auto const rawBytes = PE::ByteReader{ fuzzedBytes, fuzzedBytesCount };
+
+    try
+    {
+        parseEXEFile( rawBytes );
+    }
+    catch ( std::runtime_error const& )
+    {
+    }
+
+    try
+    {
+        parseOBJFile( rawBytes );
+    }
+    catch ( std::runtime_error const& )
+    {
+    }
+
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,35 @@
+
+#include "PEFiles.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <iterator>
+#include <vector>
+
+extern "C" int
+LLVMFuzzerTestOneInput( std::uint8_t const* fuzzedBytes, std::size_t fuzzedBytesCount );
+
+// Stands in for libFuzzer's main() when building for AFL or replaying
+// crashes: the input comes from stdin, or from each file given.
+int
+main( int argCount, char** args )
+{
+    if ( argCount < 2 )
+    {
+        auto const rawBytes =
+            std::vector<unsigned char>( std::istreambuf_iterator<char>( std::cin ),
+                                        std::istreambuf_iterator<char>() );
+
+        return LLVMFuzzerTestOneInput( rawBytes.data(), rawBytes.size() );
+    }
+
+    for ( auto i = 1; i < argCount; i++ )
+    {
+        auto const rawBytes = loadPEFileAsRawBytes( args[i] );
+
+        LLVMFuzzerTestOneInput( rawBytes.data(), rawBytes.size() );
+    }
+
+    return 0;
+}
\ No newline at end of file
@@ -1,5 +1,6 @@
 
 #include "EWEAMainWindow.h"
+#include "EXEViewer.h"
 
 #include <QApplication>
 
@@ -7,9 +8,16 @@ int
 main( int argCount, char** args )
 {
     auto app = QApplication( argCount, args );
+    auto exitCode = 0;
 
-    auto programWindow = EWEAMainWindow();
-    programWindow.show();
+    {
+        auto programWindow = EWEAMainWindow();
+        programWindow.show();
 
-    return app.exec();
-}
+        exitCode = app.exec();
+    }
+
+    EXEViewer::waitForAnalysesInFlight();
+
+    return exitCode;
+}
\ No newline at end of file
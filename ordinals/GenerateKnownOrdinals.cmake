@@ -0,0 +1,58 @@
+# Turns module definition files into the entries of the built-in ordinal
+# database, one line per export:
+#
+#   { "ws2_32", 115, "WSAStartup" },
+#
+# Run as cmake -DOUTPUT=<file> -DDEF_FILES=<file;...> -P GenerateKnownOrdinals.cmake.
+# Only the LIBRARY name and the "name @ordinal" lines of the EXPORTS section
+# are read, so the .def files of the MFC sources, for one, can be passed as
+# they are.
+
+if(NOT OUTPUT OR NOT DEF_FILES)
+    message(FATAL_ERROR "OUTPUT and DEF_FILES are required.")
+endif()
+
+set(entries "")
+
+foreach(defFile IN LISTS DEF_FILES)
+    file(STRINGS "${defFile}" defLines)
+
+    set(dllName "")
+    set(isInExports FALSE)
+
+    foreach(defLine IN LISTS defLines)
+        string(REGEX REPLACE ";.*$" "" defLine "${defLine}")
+        string(STRIP "${defLine}" defLine)
+
+        if(defLine MATCHES "^LIBRARY[ \t]+\"?([^ \t\"]+)")
+            string(TOLOWER "${CMAKE_MATCH_1}" dllName)
+            string(REGEX REPLACE "\\.dll$" "" dllName "${dllName}")
+        elseif(defLine MATCHES "^EXPORTS")
+            set(isInExports TRUE)
+        elseif(isInExports AND defLine MATCHES "^([^ \t=]+)(=[^ \t]+)?[ \t]+@[ \t]*([0-9]+)")
+            set(exportName "${CMAKE_MATCH_1}")
+            set(ordinal "${CMAKE_MATCH_3}")
+
+            if(dllName STREQUAL "")
+                message(FATAL_ERROR "${defFile} has exports before its LIBRARY line.")
+            endif()
+
+            string(REPLACE "\\" "\\\\" exportName "${exportName}")
+            string(REPLACE "\"" "\\\"" exportName "${exportName}")
+            string(APPEND entries "{ \"${dllName}\", ${ordinal}, \"${exportName}\" },\n")
+        endif()
+    endforeach()
+endforeach()
+
+set(content "// Generated by GenerateKnownOrdinals.cmake; do not edit.\n${entries}")
+
+# Rewritten only when changed, so that the database is not recompiled on
+# every build.
+if(EXISTS "${OUTPUT}")
+    file(READ "${OUTPUT}" previousContent)
+    if(previousContent STREQUAL content)
+        return()
+    endif()
+endif()
+
+file(WRITE "${OUTPUT}" "${content}")